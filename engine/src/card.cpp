@@ -202,6 +202,9 @@ MCCard::MCCard(const MCCard &cref) : MCObject(cref)
 
 MCCard::~MCCard()
 {
+	// Messages to the card's controls pass through it.
+	MCMessageCacheInvalidate();
+
 	while (opened)
 		close();
 	while (objptrs != NULL)
@@ -1606,6 +1609,9 @@ void MCCard::relayercontrol(MCControl *p_source, MCControl *p_target)
 	t_source_ptr -> remove(objptrs);
 	layer_removed(p_source, t_previous, t_next);
 
+	// Background groups are passed messages in layer order.
+	MCMessageCacheInvalidate();
+
 	// Now, replace the layer.
 	if (t_target_ptr != nil)
 	{
@@ -1631,6 +1637,7 @@ void MCCard::relayercontrol_remove(MCControl *p_control)
 	// Remove the control from the card's objptr list.
 	t_control_ptr -> remove(objptrs);
 	delete t_control_ptr;
+	MCMessageCacheInvalidate();
 
 	// Remove the control from the stack's list.
 	getstack() -> removecontrol(p_control);
@@ -2506,6 +2513,7 @@ Boolean MCCard::removecontrol(MCControl *cptr, Boolean needredraw, Boolean cf)
 			// Remove the control from the card and close it.
 			optr->remove(objptrs);
 			delete optr;
+			MCMessageCacheInvalidate();
             
             // MW-2011-08-19: [[ Layers ]] Notify the stack that a layer has been removed.
             layer_removed(cptr, t_previous, t_next);
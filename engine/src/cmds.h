@@ -823,12 +823,22 @@ class MCReplace : public MCStatement
 	MCChunk *container;
 	Mode mode;
 	
+	// When replacing from an array of pairs, the replacer compiled for the
+	// array (and comparison options) last used, which is reused while they
+	// stay the same.
+	MCArrayRef replacer_pairs;
+	MCStringOptions replacer_options;
+	MCStringReplacerRef replacer;
+	
 public:
 	MCReplace()
 	{
 		pattern = replacement = NULL;
 		container = NULL;
 		mode = kIgnoreStyles;
+		replacer_pairs = nil;
+		replacer_options = kMCStringOptionCompareExact;
+		replacer = nil;
 	}
 	virtual ~MCReplace();
 	virtual Parse_stat parse(MCScriptPoint &);
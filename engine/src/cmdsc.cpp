@@ -1721,6 +1721,8 @@ MCReplace::~MCReplace()
 	delete container;
 	delete pattern;
 	delete replacement;
+	MCValueRelease(replacer_pairs);
+	MCStringReplacerDestroy(replacer);
 }
 
 Parse_stat MCReplace::parse(MCScriptPoint &sp)
@@ -1731,7 +1733,22 @@ Parse_stat MCReplace::parse(MCScriptPoint &sp)
 		MCperror->add(PE_REPLACE_BADEXP, sp);
 		return PS_ERROR;
 	}
-	sp.skip_token(SP_REPEAT, TT_UNDEFINED, RF_WITH);
+	
+	// Parse the replace from an array of pairs form:
+	//    replace <pairs> in <container>
+	//
+	if (sp.skip_token(SP_REPEAT, TT_UNDEFINED, RF_WITH) != PS_NORMAL &&
+		sp.skip_token(SP_FACTOR, TT_IN, PT_IN) == PS_NORMAL)
+	{
+		container = new (nothrow) MCChunk(True);
+		if (container->parse(sp, False) != PS_NORMAL)
+		{
+			MCperror->add(PE_REPLACE_BADCONTAINER, sp);
+			return PS_ERROR;
+		}
+		return PS_NORMAL;
+	}
+	
 	if (sp.parseexp(False, True, &replacement) != PS_NORMAL)
 	{
 		MCperror->add(PE_REPLACE_BADEXP, sp);
@@ -1766,6 +1783,43 @@ Parse_stat MCReplace::parse(MCScriptPoint &sp)
 
 void MCReplace::exec_ctxt(MCExecContext& ctxt)
 {
+	// Each key of the pairs is replaced by its element, in a single pass.
+	if (replacement == nil)
+	{
+		MCAutoArrayRef t_pairs;
+		if (!ctxt . EvalExprAsArrayRef(pattern, EE_REPLACE_BADPATTERN, &t_pairs))
+			return;
+		
+		MCStringOptions t_options;
+		t_options = ctxt . GetStringComparisonType();
+		if (replacer == nil ||
+			replacer_options != t_options ||
+			!MCValueIsEqualTo(replacer_pairs, *t_pairs))
+		{
+			MCStringReplacerDestroy(replacer);
+			replacer = nil;
+			MCValueRelease(replacer_pairs);
+			replacer_pairs = nil;
+			
+			if (!MCStringsCreateReplacer(ctxt, *t_pairs, replacer))
+				return;
+			replacer_pairs = MCValueRetain(*t_pairs);
+			replacer_options = t_options;
+		}
+		
+		MCAutoStringRef t_target;
+		if (!ctxt . EvalExprAsMutableStringRef(container, EE_REPLACE_BADCONTAINER, &t_target))
+			return;
+		
+		MCStringsExecReplaceMultiple(ctxt, replacer, *t_target);
+		
+		if (ctxt . HasError())
+			return;
+		
+		container -> set(ctxt, PT_INTO, *t_target);
+		return;
+	}
+	
     MCAutoStringRef t_pattern;
     if (!ctxt . EvalExprAsStringRef(pattern, EE_REPLACE_BADPATTERN, &t_pattern))
         return;
@@ -535,7 +535,7 @@ void MCControl::paste(void)
 	if (MCdefaultstackptr->getmode() != WM_TOP_LEVEL)
 		return;
 
-	parent = MCdefaultstackptr->getchild(CT_THIS, kMCEmptyString, CT_CARD);
+	setparent(MCdefaultstackptr->getchild(CT_THIS, kMCEmptyString, CT_CARD));
 	MCCard *cptr = parent.GetAs<MCCard>();
 	obj_id = 0;
 	//newcontrol->resetfontindex(oldstack);
@@ -51,6 +51,9 @@ int platform_main(int argc, char *argv[], char *envp[])
 	// format. To do this, the system locale needs to be retrieved.
 	setlocale(LC_ALL, "");
 	MCsysencoding = strclone(nl_langinfo(CODESET));
+	
+	if (getenv("LIVECODE_VALUE_STATISTICS") != nil)
+		MCValueEnableAccounting();
 		
 	if (!MCInitialize())
 	{
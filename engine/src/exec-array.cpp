@@ -76,6 +76,42 @@ static int compare_array_element(const void *a, const void *b)
 	return MCStringCompareTo(MCNameGetString(t_left -> key), MCNameGetString(t_right -> key), kMCStringOptionCompareExact);
 }
 
+// Returns the index following p_index when the indices 1..p_count are ordered
+// by their string form - this is the order compare_array_element gives.
+static index_t next_lexical_index(index_t p_index, index_t p_count)
+{
+    if ((int64_t)p_index * 10 <= p_count)
+        return p_index * 10;
+
+    while (p_index % 10 == 9 || p_index + 1 > p_count)
+        p_index /= 10;
+
+    return p_index + 1;
+}
+
+// Fills in the elements of a dense array in the order compare_array_element
+// would sort them, without needing to create the names of the keys (which
+// are left as nil).
+static bool list_dense_array_elements(MCArrayRef p_array, combine_array_t& x_context)
+{
+    uindex_t t_count;
+    t_count = MCArrayGetCount(p_array);
+
+    index_t t_index;
+    t_index = 1;
+    for (uindex_t i = 0; i < t_count; i++)
+    {
+        x_context . elements[x_context . index] . key = nil;
+        if (!MCArrayFetchValueAtIndex(p_array, t_index, x_context . elements[x_context . index] . value))
+            return false;
+        x_context . index++;
+
+        t_index = next_lexical_index(t_index, t_count);
+    }
+
+    return true;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 
 // combine by row or column expects an integer-indexed array
@@ -115,13 +151,38 @@ static bool list_int_indexed_array_elements(void *p_context, MCArrayRef p_array,
         return false;
 }
 
-static int compare_int_indexed_elements(const void *a, const void* b)
+// Sorts the elements by index if their indices are consecutive, in which case
+// each index gives the element's place directly. Returns false (leaving the
+// elements in an unspecified order) if the indices are not consecutive.
+static bool sort_consecutive_int_indexed_elements(array_int_indexed_element_t *x_elements, uindex_t p_count)
 {
-    const array_int_indexed_element_t *t_left, *t_right;
-    t_left = (const array_int_indexed_element_t *)a;
-    t_right = (const array_int_indexed_element_t *)b;
-
-    return (t_left -> key - t_right -> key < 0) ? -1 : (t_left -> key != t_right -> key ? 1 : 0);
+    if (p_count == 0)
+        return true;
+    
+    index_t t_first_index;
+    t_first_index = x_elements[0] . key;
+    for (uindex_t i = 1; i < p_count; ++i)
+        t_first_index = MCMin(t_first_index, x_elements[i] . key);
+    
+    MCAutoArray<array_int_indexed_element_t> t_sorted;
+    if (!t_sorted . New(p_count))
+        return false;
+    
+    for (uindex_t i = 0; i < p_count; ++i)
+    {
+        uindex_t t_place;
+        t_place = uindex_t(x_elements[i] . key - t_first_index);
+        
+        // Two keys can convert to the same index (e.g. "1" and "01").
+        if (t_place >= p_count || t_sorted[t_place] . value != nil)
+            return false;
+        
+        t_sorted[t_place] = x_elements[i];
+    }
+    
+    MCMemoryCopy(x_elements, t_sorted . Ptr(), p_count * sizeof(array_int_indexed_element_t));
+    
+    return true;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -143,11 +204,27 @@ void MCArraysExecCombine(MCExecContext& ctxt, MCArrayRef p_array, MCStringRef p_
 	if (t_success)
 		t_success = MCMemoryNewArray(t_count, t_lisctxt . elements);
 
+	// Dense arrays are listed without their keys, which are formatted from
+	// the index as needed.
+	bool t_is_dense;
+	t_is_dense = MCArrayIsDense(p_array);
+
 	if (t_success)
 	{
         t_lisctxt . index = 0;
-        MCArrayApply(p_array, list_array_elements, &t_lisctxt);
-		qsort(t_lisctxt . elements, t_count, sizeof(array_element_t), compare_array_element);
+		if (t_is_dense)
+			t_success = list_dense_array_elements(p_array, t_lisctxt);
+		else
+		{
+			MCArrayApply(p_array, list_array_elements, &t_lisctxt);
+			qsort(t_lisctxt . elements, t_count, sizeof(array_element_t), compare_array_element);
+		}
+	}
+
+	if (t_success)
+	{
+		index_t t_index;
+		t_index = 1;
 		for(uindex_t i = 0; i < t_count; i++)
 		{
 			MCAutoStringRef t_value_as_string;
@@ -158,7 +235,9 @@ void MCArraysExecCombine(MCExecContext& ctxt, MCArrayRef p_array, MCStringRef p_
 
 			t_success =
 				(p_key_delimiter == nil ||
-                    (MCStringAppend(*t_string, MCNameGetString(t_lisctxt . elements[i] . key)) &&
+                    ((t_is_dense ?
+                        MCStringAppendFormat(*t_string, "%d", t_index) :
+                        MCStringAppend(*t_string, MCNameGetString(t_lisctxt . elements[i] . key))) &&
 					MCStringAppend(*t_string, p_key_delimiter)))&&
 				MCStringAppend(*t_string, *t_value_as_string) &&
 				(i == t_count - 1 ||
@@ -166,6 +245,9 @@ void MCArraysExecCombine(MCExecContext& ctxt, MCArrayRef p_array, MCStringRef p_
 
 			if (!t_success)
 				break;
+
+			if (t_is_dense)
+				t_index = next_lexical_index(t_index, t_count);
 		}
 	}
 	
@@ -202,11 +284,17 @@ void MCArraysExecCombineByRow(MCExecContext& ctxt, MCArrayRef p_array, MCStringR
 	}
 	
     if (t_success)
-        t_success = MCArrayApply(p_array, list_array_elements, &t_lisctxt);
+    {
+        if (MCArrayIsDense(p_array))
+            t_success = list_dense_array_elements(p_array, t_lisctxt);
+        else if (MCArrayApply(p_array, list_array_elements, &t_lisctxt))
+            qsort(t_lisctxt . elements, t_count, sizeof(array_element_t), compare_array_element);
+        else
+            t_success = false;
+    }
 	
 	if (t_success)
 	{
-        qsort(t_lisctxt . elements, t_count, sizeof(array_element_t), compare_array_element);
 
         for (uindex_t i = 0; i < t_count && t_success; ++i)
         {
@@ -249,30 +337,30 @@ void MCArraysExecCombineByColumn(MCExecContext& ctxt, MCArrayRef p_array, MCStri
 		t_lisctxt . converter = &ctxt;
 	}
 	
-	if (t_success)
+	// The elements of a dense array are already in index order, and have
+	// no key names to convert.
+	bool t_is_dense;
+	t_is_dense = MCArrayIsDense(p_array);
+
+	if (t_success && t_is_dense)
+	{
+		for (uindex_t i = 0; i < t_count && t_success; ++i)
+		{
+			t_lisctxt . elements[i] . key = i + 1;
+			t_success = MCArrayFetchValueAtIndex(p_array, i + 1, t_lisctxt . elements[i] . value);
+		}
+	}
+	else if (t_success)
 		t_success = MCArrayApply(p_array, list_int_indexed_array_elements, &t_lisctxt);
 	
     if (t_success)
     {
-		qsort(t_lisctxt . elements, t_count, sizeof(array_element_t), compare_int_indexed_elements);
-		
 		// Combine by row/column is only valid if all the indices are consecutive numbers
 		// Otherwise, an empty string is returned - no error
-		index_t t_last_index;
-		t_last_index = 0;
-		for (uindex_t i = 0; i < t_count; ++i)
+		if (!t_is_dense && !sort_consecutive_int_indexed_elements(t_lisctxt . elements, t_count))
 		{
-			if (!t_last_index)
-			{
-				t_last_index = t_lisctxt . elements[i] . key;
-				continue;
-			}
-			
-			if (++t_last_index != t_lisctxt . elements[i] . key)
-			{
-				r_string = MCValueRetain(kMCEmptyString);
-				return;
-			}
+			r_string = MCValueRetain(kMCEmptyString);
+			return;
 		}
 
 		// SN-2014-09-01: [[ Bug 13297 ]]
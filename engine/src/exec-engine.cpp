@@ -47,6 +47,7 @@ along with LiveCode.  If not see <http://www.gnu.org/licenses/>.  */
 #include "dispatch.h"
 
 #include "uuid.h"
+#include "parsecache.h"
 
 #include "libscript/script.h"
 
@@ -839,6 +840,7 @@ void MCEngineExecInsertScriptOfObjectInto(MCExecContext& ctxt, MCObject *p_scrip
 	}
 	MCObjectList *&listptr = p_in_front ? MCfrontscripts : MCbackscripts;
 	p_script->removefrom(listptr);
+	MCMessageCacheInvalidate();
 	uint4 count = 0;
 	if (listptr != NULL)
 	{
@@ -872,11 +874,13 @@ void MCEngineExecRemoveAllScriptsFrom(MCExecContext& ctxt, bool p_in_front)
 		lptr = lptr->next();
 	}
 	while (lptr != listptr);
+	MCMessageCacheInvalidate();
 }
 
 void MCEngineExecRemoveScriptOfObjectFrom(MCExecContext& ctxt, MCObject *p_script, bool p_in_front)
 {
 	p_script->removefrom(p_in_front ? MCfrontscripts : MCbackscripts);
+	MCMessageCacheInvalidate();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -1006,6 +1010,7 @@ void MCEngineExecStartUsingStack(MCExecContext& ctxt, MCStack *p_stack)
 
 	MCU_realloc((char **)&MCusing, MCnusing, MCnusing + 1, sizeof(MCStack *));
 	MCusing[MCnusing++] = p_stack;
+	MCMessageCacheInvalidate();
 	if (p_stack->message(MCM_library_stack) != ES_ERROR)
 		return;
 
@@ -1047,6 +1052,7 @@ void MCEngineExecStopUsingStack(MCExecContext& ctxt, MCStack *p_stack)
 			}
 			break;
 		}
+	MCMessageCacheInvalidate();
 	p_stack->message(MCM_release_stack);
 }
 
@@ -1108,21 +1114,34 @@ Exec_stat _MCEngineExecDoDispatch(MCExecContext &ctxt, int p_handler_type, MCNam
 		added = True;
 	}
 
-	// Dispatch the message
-	t_stat = MCU_dofrontscripts((Handler_type)p_handler_type, p_message, p_parameters);
+	// Dispatch the message, unless nothing on the message path handled the
+	// command the last time it was dispatched to the object.
 	Boolean olddynamic = MCdynamicpath;
-	MCdynamicpath = MCdynamiccard.IsValid();
-	if (t_stat == ES_PASS || t_stat == ES_NOT_HANDLED)
-    {
-        switch(t_stat = t_object -> handle((Handler_type)p_handler_type, p_message, p_parameters, t_object.Get()))
-        {
-        case ES_ERROR:
-            ctxt . LegacyThrow(EE_DISPATCH_BADCOMMAND, p_message);
-            break;
-        default:
-            break;
-        }
-    }
+	if (p_handler_type == HT_MESSAGE && t_object -> ismessageunhandled(p_message))
+		t_stat = ES_NOT_HANDLED;
+	else
+	{
+		uint32_t t_generation, t_handler_runs;
+		t_generation = MCMessageCacheGetGeneration();
+		t_handler_runs = MCMessageCacheGetHandlerRuns();
+		
+		t_stat = MCU_dofrontscripts((Handler_type)p_handler_type, p_message, p_parameters);
+		MCdynamicpath = MCdynamiccard.IsValid();
+		if (t_stat == ES_PASS || t_stat == ES_NOT_HANDLED)
+		{
+			switch(t_stat = t_object -> handle((Handler_type)p_handler_type, p_message, p_parameters, t_object.Get()))
+			{
+			case ES_ERROR:
+				ctxt . LegacyThrow(EE_DISPATCH_BADCOMMAND, p_message);
+				break;
+			default:
+				break;
+			}
+		}
+		
+		if (p_handler_type == HT_MESSAGE && t_stat == ES_NOT_HANDLED && t_object . IsValid())
+			t_object -> setmessageunhandled(p_message, t_generation, t_handler_runs);
+	}
 	
 	// Reset the default stack pointer and target - note that we use 'send'esque
 	// semantics here. i.e. If the default stack has been changed, the change sticks.
@@ -1717,6 +1736,186 @@ void MCEngineGetStacksInUse(MCExecContext& ctxt, MCStringRef &r_value)
 	ctxt . Throw();
 }
 
+void MCEngineGetNameTableStatistics(MCExecContext& ctxt, MCArrayRef &r_value)
+{
+	MCNameTableStatistics t_statistics;
+	MCNameGetTableStatistics(t_statistics);
+
+	struct { const char *key; uinteger_t value; } t_fields[] =
+	{
+		{ "names", t_statistics . name_count },
+		{ "classes", t_statistics . class_count },
+		{ "chains", t_statistics . chain_count },
+		{ "usedChains", t_statistics . used_chain_count },
+		{ "longestChain", t_statistics . longest_chain_length },
+		{ "memory", uinteger_t(t_statistics . memory_size) },
+	};
+
+	MCAutoArrayRef t_array;
+	bool t_success;
+	t_success = MCArrayCreateMutable(&t_array);
+
+	for(uindex_t i = 0; t_success && i < sizeof(t_fields) / sizeof(t_fields[0]); i++)
+	{
+		MCAutoNumberRef t_number;
+		t_success = MCNumberCreateWithUnsignedInteger(t_fields[i] . value, &t_number) &&
+					MCArrayStoreValue(*t_array, false, MCNAME(t_fields[i] . key), *t_number);
+	}
+
+	if (t_success && MCArrayCopy(*t_array, r_value))
+		return;
+
+	ctxt . Throw();
+}
+
+// Creates an array mapping each key to the corresponding count. Counts are
+// stored as reals, as byte counts may not fit in an integer.
+static bool MCEngineCreateStatisticsArray(const char * const *p_keys, const uint64_t *p_values, uindex_t p_count, MCArrayRef& r_array)
+{
+	MCAutoArrayRef t_array;
+	if (!MCArrayCreateMutable(&t_array))
+		return false;
+
+	for(uindex_t i = 0; i < p_count; i++)
+	{
+		MCAutoNumberRef t_number;
+		if (!MCNumberCreateWithReal(real64_t(p_values[i]), &t_number) ||
+			!MCArrayStoreValue(*t_array, false, MCNAME(p_keys[i]), *t_number))
+			return false;
+	}
+
+	return MCArrayCopy(*t_array, r_array);
+}
+
+void MCEngineGetValueStatistics(MCExecContext& ctxt, MCArrayRef &r_value)
+{
+	static const char * const kTypeNames[] =
+	{
+		"null", "boolean", "number", "name", "string", "data", "array", "list",
+		"set", "properList", "custom", "record", "handler", "typeInfo", "error",
+		"foreignValue",
+	};
+	static const char * const kTypeKeys[] =
+	{
+		"created", "destroyed", "live", "peakLive", "liveBytes", "peakBytes",
+	};
+	static const char * const kMemoryKeys[] =
+	{
+		"allocations", "deallocations", "allocatedBytes", "liveBytes", "peakBytes",
+	};
+
+	MCAutoArrayRef t_array;
+	bool t_success;
+	t_success = MCArrayCreateMutable(&t_array);
+
+	// The statistics are only gathered if accounting was enabled at startup,
+	// otherwise the array is left empty.
+	MCValueTypeStatistics t_statistics;
+	for(uindex_t i = 0; t_success && i < sizeof(kTypeNames) / sizeof(kTypeNames[0]); i++)
+	{
+		if (!MCValueGetTypeStatistics(i, t_statistics))
+			break;
+
+		uint64_t t_values[] =
+		{
+			t_statistics . created, t_statistics . destroyed,
+			t_statistics . live, t_statistics . peak_live,
+			t_statistics . live_bytes, t_statistics . peak_bytes,
+		};
+
+		MCAutoArrayRef t_type_array;
+		t_success = MCEngineCreateStatisticsArray(kTypeKeys, t_values, sizeof(t_values) / sizeof(t_values[0]), &t_type_array) &&
+					MCArrayStoreValue(*t_array, false, MCNAME(kTypeNames[i]), *t_type_array);
+	}
+
+	if (t_success && MCArrayGetCount(*t_array) != 0)
+	{
+		MCMemoryStatistics t_memory;
+		MCMemoryGetStatistics(t_memory);
+
+		uint64_t t_values[] =
+		{
+			t_memory . allocations, t_memory . deallocations,
+			t_memory . allocated_bytes, t_memory . live_bytes,
+			t_memory . peak_bytes,
+		};
+
+		MCAutoArrayRef t_memory_array;
+		t_success = MCEngineCreateStatisticsArray(kMemoryKeys, t_values, sizeof(t_values) / sizeof(t_values[0]), &t_memory_array) &&
+					MCArrayStoreValue(*t_array, false, MCNAME("memory"), *t_memory_array);
+	}
+
+	if (t_success && MCArrayCopy(*t_array, r_value))
+		return;
+
+	ctxt . Throw();
+}
+
+void MCEngineGetParseCacheSize(MCExecContext& ctxt, uinteger_t& r_value)
+{
+	r_value = MCParseCacheGetSize();
+}
+
+void MCEngineSetParseCacheSize(MCExecContext& ctxt, uinteger_t p_value)
+{
+	MCParseCacheSetSize(p_value);
+}
+
+void MCEngineGetParseCacheStatistics(MCExecContext& ctxt, MCArrayRef &r_value)
+{
+	static const char * const kKeys[] =
+	{
+		"hits", "misses", "evictions", "flushes", "entries",
+	};
+
+	MCParseCacheStatistics t_statistics;
+	MCParseCacheGetStatistics(t_statistics);
+
+	uint64_t t_values[] =
+	{
+		t_statistics . hits, t_statistics . misses,
+		t_statistics . evictions, t_statistics . flushes,
+		t_statistics . entries,
+	};
+
+	if (MCEngineCreateStatisticsArray(kKeys, t_values, sizeof(t_values) / sizeof(t_values[0]), r_value))
+		return;
+
+	ctxt . Throw();
+}
+
+void MCEngineGetCacheUnhandledMessages(MCExecContext& ctxt, bool& r_value)
+{
+	r_value = MCMessageCacheGetEnabled();
+}
+
+void MCEngineSetCacheUnhandledMessages(MCExecContext& ctxt, bool p_value)
+{
+	MCMessageCacheSetEnabled(p_value);
+}
+
+void MCEngineGetMessageCacheStatistics(MCExecContext& ctxt, MCArrayRef &r_value)
+{
+	static const char * const kKeys[] =
+	{
+		"hits", "misses", "invalidations",
+	};
+
+	MCMessageCacheStatistics t_statistics;
+	MCMessageCacheGetStatistics(t_statistics);
+
+	uint64_t t_values[] =
+	{
+		t_statistics . hits, t_statistics . misses,
+		t_statistics . invalidations,
+	};
+
+	if (MCEngineCreateStatisticsArray(kKeys, t_values, sizeof(t_values) / sizeof(t_values[0]), r_value))
+		return;
+
+	ctxt . Throw();
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 
 bool MCEngineEvalValueAsObject(MCValueRef p_value, bool p_strict, MCObjectPtr& r_object, bool& r_parse_error)
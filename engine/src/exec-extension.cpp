@@ -137,6 +137,7 @@ bool MCEngineAddExtensionFromModule(MCScriptModuleRef p_module)
     MCextensions = t_ext;
     
     MCextensionschanged = true;
+    MCMessageCacheInvalidate();
     
     return true;
 }
@@ -388,6 +389,7 @@ void MCEngineExecUnloadExtension(MCExecContext& ctxt, MCStringRef p_module_name)
             
             /* Makes sure the global handler list is refreshed on next use */
             MCextensionschanged = true;
+            MCMessageCacheInvalidate();
             
             /* Free the extension struct and things it owns */
             __MCEngineFreeExtension(t_ext);
@@ -467,6 +467,9 @@ void MCGroup::SetBackgroundBehavior(MCExecContext& ctxt, bool setting)
 	changeflag(setting, F_GROUP_ONLY);
 	flags ^= F_GROUP_ONLY;
 
+	// Background groups are on the message path of the cards they are on.
+	MCMessageCacheInvalidate();
+
 	// Compute whether the parent is a group
 	bool t_parent_is_group;
 	t_parent_is_group = false;
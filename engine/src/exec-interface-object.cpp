@@ -1621,6 +1621,10 @@ void MCObject::SetScript(MCExecContext& ctxt, MCStringRef new_script)
 		
 		MCValueAssign(_script, *t_new_script);
 
+		// The script is only compiled when next needed if it is not compiled
+		// here, so messages which went unhandled must be looked for again.
+		MCMessageCacheInvalidate();
+
         // IM-2013-05-29: [[ BZ 10916 ]] flag new script as unencrypted
 		m_script_encrypted = false;
 		getstack() -> securescript(this);
@@ -1716,6 +1720,7 @@ void MCObject::SetParentScript(MCExecContext& ctxt, MCStringRef new_parent_scrip
 		if (parent_script != NULL)
 			parent_script -> Release();
 		parent_script = NULL;
+		MCMessageCacheInvalidate();
 		return;
 	}
 
@@ -1828,6 +1833,7 @@ void MCObject::SetParentScript(MCExecContext& ctxt, MCStringRef new_parent_scrip
 		parent_script -> Release();
 
 	parent_script = t_use;
+	MCMessageCacheInvalidate();
 
 	// MW-2013-05-30: [[ InheritedPscripts ]] Make sure we update all the
 	//   uses of this object if it is being used as a parentScript. This
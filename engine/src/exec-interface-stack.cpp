@@ -1070,7 +1070,7 @@ void MCStack::SetMainStack(MCExecContext& ctxt, MCStringRef p_main_stack)
 		if (stackptr == this)
 		{
 			MCdispatcher -> appendstack(this);
-			parent = MCdispatcher -> gethome();
+			setparent(MCdispatcher -> gethome());
 		}
 		else
 		{
@@ -1079,7 +1079,7 @@ void MCStack::SetMainStack(MCExecContext& ctxt, MCStringRef p_main_stack)
 			if (stackptr -> substacks == nil)
 				stackptr -> extraopen(true);
 			appendto(stackptr -> substacks);
-			parent = stackptr;
+			setparent(stackptr);
 		}
 
         // Any inherited properties have changed so force a redraw
@@ -1218,7 +1218,7 @@ void MCStack::SetSubstacks(MCExecContext& ctxt, MCStringRef p_substacks)
 					t_old_mainstack = tsub -> getparent();
 
 				tsub -> appendto(substacks);
-				tsub -> parent = this;
+				tsub -> setparent(this);
 				tsub -> message_with_valueref_args(MCM_main_stack_changed, t_old_mainstack -> getname(), getname());
 			}
 			else
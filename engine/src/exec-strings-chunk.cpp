@@ -222,37 +222,31 @@ void MCStringsMarkTextChunkInRange(MCExecContext& ctxt, MCStringRef p_string, MC
             
             MCStringRef t_delimiter = (p_chunk_type == CT_LINE) ? t_line_delimiter : t_item_delimiter;
             MCRange t_found_range;
+            uindex_t t_found_count;
             
-            // calculate the start of the (p_first)th line or item
-            while (p_first && MCStringFind(p_string, MCRangeMakeMinMax(t_offset, t_length), t_delimiter, ctxt . GetStringComparisonType(), &t_found_range))
-            {
-                p_first--;
-                t_offset = t_found_range . offset + t_found_range . length;
-            }
-            
-            // if we couldn't find enough delimiters, set r_add to the number of
-            // additional delimiters required and set the offset to the end
+            // calculate the start of the (p_first)th line or item - this is just
+            // after the (p_first)th delimiter
             if (p_first > 0)
             {
-                t_offset = t_length;
-                r_add = p_first;
+                if (MCStringFindNth(p_string, MCRangeMakeMinMax(t_offset, t_length), t_delimiter, ctxt . GetStringComparisonType(), p_first - 1, t_found_count, &t_found_range))
+                    t_offset = t_found_range . offset + t_found_range . length;
+                else
+                {
+                    // if we couldn't find enough delimiters, set r_add to the number of
+                    // additional delimiters required and set the offset to the end
+                    t_offset = t_length;
+                    r_add = p_first - t_found_count;
+                }
             }
             
             r_start = t_offset;
             
-            // calculate the length of the next p_count lines / items
-            while (p_count--)
-            {
-                if (t_offset > t_end_index || !MCStringFind(p_string, MCRangeMakeMinMax(t_offset, t_length), t_delimiter, ctxt . GetStringComparisonType(), &t_found_range))
-                {
-                    r_end = t_length;
-                    break;
-                }
-                if (p_count == 0)
-                    r_end = t_found_range . offset;
-                else
-                    t_offset = t_found_range . offset + t_found_range . length;
-            }
+            // calculate the length of the next p_count lines / items - they end
+            // at the (p_count)th delimiter or the end of the string
+            if (t_offset > t_end_index || !MCStringFindNth(p_string, MCRangeMakeMinMax(t_offset, t_length), t_delimiter, ctxt . GetStringComparisonType(), p_count - 1, t_found_count, &t_found_range))
+                r_end = t_length;
+            else
+                r_end = t_found_range . offset;
             
             if (p_whole_chunk && !p_further_chunks)
             {
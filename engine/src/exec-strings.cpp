@@ -1908,6 +1908,56 @@ void MCStringsExecReplace(MCExecContext& ctxt, MCStringRef p_pattern, MCStringRe
 	ctxt . Throw();
 }
 
+bool MCStringsCreateReplacer(MCExecContext& ctxt, MCArrayRef p_pairs, MCStringReplacerRef& r_replacer)
+{
+	uindex_t t_count;
+	t_count = MCArrayGetCount(p_pairs);
+	
+	MCAutoStringRefArray t_patterns, t_replacements;
+	if (!t_patterns . New(t_count) ||
+		!t_replacements . New(t_count))
+	{
+		ctxt . Throw();
+		return false;
+	}
+	
+	uintptr_t t_iterator;
+	t_iterator = 0;
+	MCNameRef t_key;
+	MCValueRef t_value;
+	for(uindex_t i = 0; MCArrayIterate(p_pairs, t_iterator, t_key, t_value); i++)
+	{
+		t_patterns[i] = MCValueRetain(MCNameGetString(t_key));
+		if (MCStringIsEmpty(t_patterns[i]))
+		{
+			ctxt . LegacyThrow(EE_REPLACE_BADPATTERN);
+			return false;
+		}
+		
+		if (!ctxt . ConvertToString(t_value, t_replacements[i]))
+		{
+			ctxt . LegacyThrow(EE_REPLACE_BADREPLACEMENT);
+			return false;
+		}
+	}
+	
+	if (!MCStringReplacerCreate(t_patterns . Ptr(), t_replacements . Ptr(), t_count, ctxt . GetStringComparisonType(), r_replacer))
+	{
+		ctxt . Throw();
+		return false;
+	}
+	
+	return true;
+}
+
+void MCStringsExecReplaceMultiple(MCExecContext& ctxt, MCStringReplacerRef p_replacer, MCStringRef p_target)
+{
+	if (MCStringReplacerApply(p_replacer, p_target))
+		return;
+	
+	ctxt . Throw();
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 
 void MCStringsExecFilterDelimited(MCExecContext& ctxt, MCStringRef p_source, bool p_without, MCStringRef p_delimiter, MCPatternMatcher *p_matcher, MCStringRef &r_result)
@@ -2055,6 +2105,363 @@ void MCStringsEvalIsNotAscii(MCExecContext& ctxt, MCValueRef p_value, bool& r_re
 
 ////////////////////////////////////////////////////////////////////////////////
 
+// International sorts order items by their collation keys rather than by
+// running the collator on each pair of items. The keys are generated once per
+// item into a single buffer and then radix sorted byte by byte, which gives
+// the same order as comparing the items with the collator.
+
+struct MCStringsCollationKeys
+{
+    MCUnicodeCollatorRef collator;
+    byte_t *bytes;
+    uindex_t capacity;
+    uindex_t *offsets;
+    uindex_t count;
+};
+
+struct MCStringsCollationKeyRange
+{
+    uindex_t start;
+    uindex_t count;
+    uindex_t depth;
+};
+
+// Ranges with fewer items than this are finished with an insertion sort.
+static const uindex_t kMCStringsCollationKeyInsertionSortLimit = 32;
+
+static bool MCStringsCollationKeysInitialize(MCStringsCollationKeys& x_keys, MCStringOptions p_options, uindex_t p_count)
+{
+    x_keys . collator = nil;
+    x_keys . bytes = nil;
+    x_keys . capacity = 0;
+    x_keys . offsets = nil;
+    x_keys . count = 0;
+    
+    MCUnicodeCollateOption t_options;
+    t_options = MCUnicodeCollateOptionFromCompareOption((MCUnicodeCompareOption)p_options);
+    if (!MCUnicodeCreateCollator(kMCSystemLocale, t_options, x_keys . collator))
+        return false;
+    
+    if (!MCMemoryNewArray(p_count + 1, x_keys . offsets))
+    {
+        MCUnicodeDestroyCollator(x_keys . collator);
+        return false;
+    }
+    
+    return true;
+}
+
+static void MCStringsCollationKeysFinalize(MCStringsCollationKeys& x_keys)
+{
+    MCUnicodeDestroyCollator(x_keys . collator);
+    MCMemoryDeallocate(x_keys . bytes);
+    MCMemoryDeleteArray(x_keys . offsets);
+}
+
+// Appends the key for the given string. If the key cannot be generated, an
+// empty key is appended so the item sorts first.
+static void MCStringsCollationKeysAppend(MCStringsCollationKeys& x_keys, MCStringRef p_string)
+{
+    uindex_t t_start;
+    t_start = x_keys . offsets[x_keys . count];
+    
+    uindex_t t_length;
+    t_length = 0;
+    if (p_string != nil)
+    {
+        const unichar_t *t_chars;
+        uindex_t t_char_count;
+        t_chars = MCStringGetCharPtr(p_string);
+        t_char_count = MCStringGetLength(p_string);
+        
+        t_length = MCUnicodeGetSortKeyWithCollator(x_keys . collator, t_chars, t_char_count, x_keys . bytes + t_start, x_keys . capacity - t_start);
+        if (t_length > x_keys . capacity - t_start)
+        {
+            uindex_t t_new_capacity;
+            t_new_capacity = MCMax(x_keys . capacity * 2, t_start + t_length);
+            
+            byte_t *t_new_bytes;
+            if (t_length > UINDEX_MAX - t_start ||
+                !MCMemoryReallocate(x_keys . bytes, t_new_capacity, t_new_bytes))
+                t_length = 0;
+            else
+            {
+                x_keys . bytes = t_new_bytes;
+                x_keys . capacity = t_new_capacity;
+                MCUnicodeGetSortKeyWithCollator(x_keys . collator, t_chars, t_char_count, x_keys . bytes + t_start, t_length);
+            }
+        }
+    }
+    
+    x_keys . offsets[++x_keys . count] = t_start + t_length;
+}
+
+// Returns the byte of the given key at the given depth, offset by one so that
+// the end of the key sorts before any byte.
+static inline uindex_t MCStringsCollationKeyByte(const MCStringsCollationKeys& p_keys, uindex_t p_key, uindex_t p_depth)
+{
+    uindex_t t_start;
+    t_start = p_keys . offsets[p_key];
+    if (p_depth >= p_keys . offsets[p_key + 1] - t_start)
+        return 0;
+    return p_keys . bytes[t_start + p_depth] + 1;
+}
+
+static compare_t MCStringsCompareCollationKeys(const MCStringsCollationKeys& p_keys, uindex_t p_left, uindex_t p_right, uindex_t p_depth)
+{
+    uindex_t t_left_length, t_right_length;
+    t_left_length = p_keys . offsets[p_left + 1] - p_keys . offsets[p_left] - p_depth;
+    t_right_length = p_keys . offsets[p_right + 1] - p_keys . offsets[p_right] - p_depth;
+    
+    int t_result;
+    t_result = memcmp(p_keys . bytes + p_keys . offsets[p_left] + p_depth,
+                      p_keys . bytes + p_keys . offsets[p_right] + p_depth,
+                      MCMin(t_left_length, t_right_length));
+    if (t_result != 0)
+        return t_result;
+    
+    return compare_t(t_left_length) - compare_t(t_right_length);
+}
+
+// Sorts the indices of the keys into ascending (or descending) order of key.
+// Items with equal keys keep their relative order.
+static void MCStringsSortByCollationKeys(const MCStringsCollationKeys& p_keys, uindex_t *x_indices, uindex_t p_count, bool p_reverse)
+{
+    MCAutoArray<uindex_t> t_scratch;
+    MCAutoArray<MCStringsCollationKeyRange> t_ranges;
+    if (!t_scratch . New(p_count))
+        return;
+    
+    MCStringsCollationKeyRange t_range;
+    t_range . start = 0;
+    t_range . count = p_count;
+    t_range . depth = 0;
+    /* UNCHECKED */ t_ranges . Push(t_range);
+    
+    while (t_ranges . Size() != 0)
+    {
+        t_range = t_ranges[t_ranges . Size() - 1];
+        t_ranges . Shrink(t_ranges . Size() - 1);
+        
+        uindex_t *t_items;
+        t_items = x_indices + t_range . start;
+        
+        if (t_range . count < kMCStringsCollationKeyInsertionSortLimit)
+        {
+            for(uindex_t i = 1; i < t_range . count; i++)
+            {
+                uindex_t t_item;
+                t_item = t_items[i];
+                
+                uindex_t j;
+                for(j = i; j > 0; j--)
+                {
+                    compare_t t_compare;
+                    t_compare = MCStringsCompareCollationKeys(p_keys, t_items[j - 1], t_item, t_range . depth);
+                    if (p_reverse ? t_compare >= 0 : t_compare <= 0)
+                        break;
+                    t_items[j] = t_items[j - 1];
+                }
+                t_items[j] = t_item;
+            }
+            continue;
+        }
+        
+        uindex_t t_counts[257];
+        MCMemoryClear(t_counts, sizeof(t_counts));
+        for(uindex_t i = 0; i < t_range . count; i++)
+            t_counts[MCStringsCollationKeyByte(p_keys, t_items[i], t_range . depth)]++;
+        
+        // If every key has the same byte at this depth there is nothing to
+        // move, so either the keys are all equal or the next byte decides.
+        uindex_t t_first_byte;
+        t_first_byte = MCStringsCollationKeyByte(p_keys, t_items[0], t_range . depth);
+        if (t_counts[t_first_byte] == t_range . count)
+        {
+            if (t_first_byte != 0)
+            {
+                t_range . depth++;
+                /* UNCHECKED */ t_ranges . Push(t_range);
+            }
+            continue;
+        }
+        
+        uindex_t t_starts[257];
+        uindex_t t_position;
+        t_position = 0;
+        for(uindex_t i = 0; i < 257; i++)
+        {
+            uindex_t t_byte;
+            t_byte = p_reverse ? 256 - i : i;
+            t_starts[t_byte] = t_position;
+            t_position += t_counts[t_byte];
+        }
+        
+        for(uindex_t i = 0; i < t_range . count; i++)
+            t_scratch[t_starts[MCStringsCollationKeyByte(p_keys, t_items[i], t_range . depth)]++] = t_items[i];
+        MCMemoryCopy(t_items, t_scratch . Ptr(), t_range . count * sizeof(uindex_t));
+        
+        // Keys which ended at this depth are all equal; every other bucket
+        // with more than one item is sorted on the next byte. The bucket
+        // starts have now advanced to the end of each bucket.
+        for(uindex_t t_byte = 1; t_byte < 257; t_byte++)
+        {
+            if (t_counts[t_byte] < 2)
+                continue;
+            
+            MCStringsCollationKeyRange t_bucket;
+            t_bucket . start = t_range . start + t_starts[t_byte] - t_counts[t_byte];
+            t_bucket . count = t_counts[t_byte];
+            t_bucket . depth = t_range . depth + 1;
+            /* UNCHECKED */ t_ranges . Push(t_bucket);
+        }
+    }
+}
+
+// Numeric and datetime keys are radix sorted on their bit patterns, mapped so
+// that unsigned order is numeric order. This matches the comparison sort
+// exactly unless there is a NaN among the keys, as NaNs are unordered - in
+// that case nothing is done and false is returned.
+
+struct MCStringsRealSortEntry
+{
+    uint64_t key;
+    uindex_t index;
+};
+
+// Fewer items than this are left to the comparison sort.
+static const uindex_t kMCStringsRealRadixSortMinimum = 64;
+
+static const uindex_t kMCStringsRealRadixBits = 11;
+
+static bool MCStringsSortIndirectByReal(uindex_t *x_indices, uindex_t p_count, const double *p_keys, bool p_reverse)
+{
+    MCAutoArray<MCStringsRealSortEntry> t_entries, t_scratch;
+    if (!t_entries . New(p_count) || !t_scratch . New(p_count))
+        return false;
+    
+    for(uindex_t i = 0; i < p_count; i++)
+    {
+        double t_real;
+        t_real = p_keys[x_indices[i]];
+        if (MCS_isnan(t_real))
+            return false;
+        
+        // Negative zero compares equal to zero so must map to the same key.
+        if (t_real == 0.0)
+            t_real = 0.0;
+        
+        uint64_t t_bits;
+        MCMemoryCopy(&t_bits, &t_real, sizeof(t_bits));
+        if ((t_bits >> 63) != 0)
+            t_bits = ~t_bits;
+        else
+            t_bits |= uint64_t(1) << 63;
+        
+        t_entries[i] . key = p_reverse ? ~t_bits : t_bits;
+        t_entries[i] . index = x_indices[i];
+    }
+    
+    MCStringsRealSortEntry *t_from, *t_to;
+    t_from = t_entries . Ptr();
+    t_to = t_scratch . Ptr();
+    for(uindex_t t_shift = 0; t_shift < 64; t_shift += kMCStringsRealRadixBits)
+    {
+        const uindex_t t_mask = (1 << kMCStringsRealRadixBits) - 1;
+        
+        uindex_t t_counts[1 << kMCStringsRealRadixBits];
+        MCMemoryClear(t_counts, sizeof(t_counts));
+        for(uindex_t i = 0; i < p_count; i++)
+            t_counts[(t_from[i] . key >> t_shift) & t_mask]++;
+        
+        // Most passes over real keys see the same digit throughout.
+        if (t_counts[(t_from[0] . key >> t_shift) & t_mask] == p_count)
+            continue;
+        
+        uindex_t t_position;
+        t_position = 0;
+        for(uindex_t i = 0; i <= t_mask; i++)
+        {
+            uindex_t t_count;
+            t_count = t_counts[i];
+            t_counts[i] = t_position;
+            t_position += t_count;
+        }
+        
+        for(uindex_t i = 0; i < p_count; i++)
+            t_to[t_counts[(t_from[i] . key >> t_shift) & t_mask]++] = t_from[i];
+        
+        MCStringsRealSortEntry *t_swap;
+        t_swap = t_from;
+        t_from = t_to;
+        t_to = t_swap;
+    }
+    
+    for(uindex_t i = 0; i < p_count; i++)
+        x_indices[i] = t_from[i] . index;
+    
+    return true;
+}
+
+// Reorders the sort nodes by the given vector of indices into them.
+static void MCStringsPermuteSortnodes(MCSortnode *x_items, uint4 nitems, const uindex_t *p_indices)
+{
+    MCSortnode *t_sorted;
+    t_sorted = new (nothrow) MCSortnode[nitems];
+    for(uindex_t i = 0; i < nitems; i++)
+        t_sorted[i] = x_items[p_indices[i]];
+    for(uindex_t i = 0; i < nitems; i++)
+        x_items[i] = t_sorted[i];
+    delete[] t_sorted;
+}
+
+static bool MCStringsSortInternational(MCSortnode *p_items, uint4 nitems, bool p_reverse, MCStringOptions p_options)
+{
+    MCStringsCollationKeys t_keys;
+    if (!MCStringsCollationKeysInitialize(t_keys, p_options, nitems))
+        return false;
+    
+    for(uindex_t i = 0; i < nitems; i++)
+        MCStringsCollationKeysAppend(t_keys, p_items[i] . svalue);
+    
+    uindex_t *t_indices;
+    t_indices = new (nothrow) uindex_t[nitems];
+    for(uindex_t i = 0; i < nitems; i++)
+        t_indices[i] = i;
+    
+    MCStringsSortByCollationKeys(t_keys, t_indices, nitems, p_reverse);
+    MCStringsCollationKeysFinalize(t_keys);
+    
+    MCStringsPermuteSortnodes(p_items, nitems, t_indices);
+    delete[] t_indices;
+    
+    return true;
+}
+
+static bool MCStringsSortReal(MCSortnode *p_items, uint4 nitems, bool p_reverse)
+{
+    if (nitems < kMCStringsRealRadixSortMinimum)
+        return false;
+    
+    MCAutoArray<double> t_keys;
+    MCAutoArray<uindex_t> t_indices;
+    if (!t_keys . New(nitems) || !t_indices . New(nitems))
+        return false;
+    
+    for(uindex_t i = 0; i < nitems; i++)
+    {
+        t_keys[i] = MCNumberFetchAsReal(p_items[i] . nvalue);
+        t_indices[i] = i;
+    }
+    
+    if (!MCStringsSortIndirectByReal(t_indices . Ptr(), nitems, t_keys . Ptr(), p_reverse))
+        return false;
+    
+    MCStringsPermuteSortnodes(p_items, nitems, t_indices . Ptr());
+    
+    return true;
+}
+
 void MCStringsDoSort(MCSortnode *b, uint4 n, MCSortnode *t, Sort_type form, bool reverse, MCStringOptions p_options)
 {
     if (n <= 1)
@@ -2134,7 +2541,25 @@ void MCStringsDoSort(MCSortnode *b, uint4 n, MCSortnode *t, Sort_type form, bool
 
 void MCStringsSort(MCSortnode *p_items, uint4 nitems, Sort_type p_dir, Sort_type p_form, MCStringOptions p_options)
 {
-    if (nitems > 1)
+    if (nitems <= 1)
+        return;
+    
+    bool t_sorted;
+    switch (p_form)
+    {
+        case ST_INTERNATIONAL:
+            t_sorted = MCStringsSortInternational(p_items, nitems, p_dir == ST_DESCENDING, p_options);
+            break;
+        case ST_NUMERIC:
+        case ST_DATETIME:
+            t_sorted = MCStringsSortReal(p_items, nitems, p_dir == ST_DESCENDING);
+            break;
+        default:
+            t_sorted = false;
+            break;
+    }
+    
+    if (!t_sorted)
     {
         MCSortnode *tmp = new (nothrow) MCSortnode[nitems];
         MCStringsDoSort(p_items, nitems, tmp, p_form, p_dir == ST_DESCENDING, p_options);
@@ -2247,10 +2672,26 @@ void MCStringsSortAddItem(MCExecContext &ctxt, MCSortnode *items, uint4 &nitems,
 typedef bool (*comparator_t)(void *context, uindex_t left, uindex_t right);
 typedef void (*freer_t)(void *keys, uindex_t count);
 
+// Runs of at most this many items are insertion sorted.
+static const uint4 kMCStringsSortIndirectInsertionLimit = 8;
+
 static void MCStringsDoSortIndirect(uindex_t *b, uint4 n, uindex_t *t, comparator_t is_less_or_equal, void *context)
 {
-    if (n <= 1)
-		return;
+    if (n <= kMCStringsSortIndirectInsertionLimit)
+    {
+        for (uint4 i = 1; i < n; i++)
+        {
+            uindex_t t_item = b[i];
+            uint4 j = i;
+            while (j > 0 && !is_less_or_equal(context, b[j - 1], t_item))
+            {
+                b[j] = b[j - 1];
+                j--;
+            }
+            b[j] = t_item;
+        }
+        return;
+    }
     
 	uint4 n1 = n / 2;
 	uint4 n2 = n - n1;
@@ -2260,6 +2701,11 @@ static void MCStringsDoSortIndirect(uindex_t *b, uint4 n, uindex_t *t, comparato
 	MCStringsDoSortIndirect(b1, n1, t, is_less_or_equal, context);
 	MCStringsDoSortIndirect(b2, n2, t, is_less_or_equal, context);
     
+    // If the halves are already in order there is nothing to merge - this
+    // makes sorting an already sorted list linear.
+    if (is_less_or_equal(context, b1[n1 - 1], b2[0]))
+        return;
+    
 	uindex_t *tmp = t;
 	while (n1 > 0 && n2 > 0)
 	{
@@ -2487,7 +2933,7 @@ void MCStringsExecSort(MCExecContext& ctxt, Sort_type p_dir, Sort_type p_form, M
             }
             
             t_sort_keys = t_numbers;
-            t_sort_compare = p_dir == ST_ASCENDING ? double_comparator_fwd : double_comparator_rev;;
+            t_sort_compare = p_dir == ST_ASCENDING ? double_comparator_fwd : double_comparator_rev;
             t_sort_freer = double_freer;
         }
         break;
@@ -2539,44 +2985,27 @@ void MCStringsExecSort(MCExecContext& ctxt, Sort_type p_dir, Sort_type p_form, M
             
         case ST_INTERNATIONAL:
         {
-            MCUnicodeCollateOption t_options;
-            t_options = MCUnicodeCollateOptionFromCompareOption((MCUnicodeCompareOption)ctxt . GetStringComparisonType());
+            // International sorts are done directly on the collation keys, so
+            // there is no comparator to run afterwards.
+            t_sort_keys = nil;
+            t_sort_compare = nil;
+            t_sort_freer = nil;
             
-            MCUnicodeCollatorRef t_collator;
-            /* UNCHECKED */ MCUnicodeCreateCollator(kMCSystemLocale, t_options, t_collator);
+            MCStringsCollationKeys t_keys;
+            if (!MCStringsCollationKeysInitialize(t_keys, ctxt . GetStringComparisonType(), p_count))
+                break;
             
-            MCDataRef *t_datas;
-            t_datas = new (nothrow) MCDataRef[p_count];
             for(uindex_t i = 0; i < p_count; i++)
             {
                 MCAutoStringRef t_string;
                 if (!ctxt . ConvertToString(t_items[i], &t_string))
-                {
-                    t_datas[i] = MCValueRetain(kMCEmptyData);
-                    continue;
-                }
-                
-                byte_t *t_key;
-                uindex_t t_key_length;
-                if (!MCUnicodeCreateSortKeyWithCollator(t_collator, MCStringGetCharPtr(*t_string), MCStringGetLength(*t_string), t_key, t_key_length))
-                {
-                    t_datas[i] = MCValueRetain(kMCEmptyData);
-                    continue;
-                }
-                
-                if (!MCDataCreateWithBytesAndRelease(t_key, t_key_length, t_datas[i]))
-                {
-                    free(t_key);
-                    t_datas[i] = MCValueRetain(kMCEmptyData);
-                    continue;
-                }
+                    MCStringsCollationKeysAppend(t_keys, nil);
+                else
+                    MCStringsCollationKeysAppend(t_keys, *t_string);
             }
             
-            MCUnicodeDestroyCollator(t_collator);
-            
-            t_sort_keys = t_datas;
-            t_sort_compare = p_dir == ST_ASCENDING ? data_comparator_fwd : data_comparator_rev;
-            t_sort_freer = valueref_freer;
+            MCStringsSortByCollationKeys(t_keys, t_indicies, p_count, p_dir != ST_ASCENDING);
+            MCStringsCollationKeysFinalize(t_keys);
         }
         break;
             
@@ -2585,7 +3014,17 @@ void MCStringsExecSort(MCExecContext& ctxt, Sort_type p_dir, Sort_type p_form, M
             MCUnreachableReturn();
     }
     
-    MCStringsSortIndirect(t_indicies, p_count, t_sort_compare, t_sort_keys);
+    // Real keys are radix sorted when there are enough of them, falling back
+    // to the comparison sort otherwise.
+    if (t_sort_compare == double_comparator_fwd || t_sort_compare == double_comparator_rev)
+    {
+        if (p_count >= kMCStringsRealRadixSortMinimum &&
+            MCStringsSortIndirectByReal(t_indicies, p_count, (const double *)t_sort_keys, p_dir != ST_ASCENDING))
+            t_sort_compare = nil;
+    }
+    
+    if (t_sort_compare != nil)
+        MCStringsSortIndirect(t_indicies, p_count, t_sort_compare, t_sort_keys);
     
     if (t_sort_freer != nil)
         t_sort_freer(t_sort_keys, p_count);
@@ -42,6 +42,7 @@ along with LiveCode.  If not see <http://www.gnu.org/licenses/>.  */
 #include "statemnt.h"
 #include "license.h"
 #include "scriptpt.h"
+#include "parsecache.h"
 #include "newobj.h"
 
 // SN-2014-09-05: [[ Bug 13378 ]] Include the definition of MCServerScript
@@ -1301,8 +1302,18 @@ void MCExecContext::deletestatements(MCStatement* p_statements)
     }
 }
 
-void MCExecContext::eval(MCExecContext &ctxt, MCStringRef p_expression, MCValueRef &r_value)
+// Parse the expression in the context, or fetch its parse from the cache. If
+// the expression does not parse, nil is returned.
+static MCParseCacheEntry *MCExecContextParseExpression(MCExecContext &ctxt, MCStringRef p_expression)
 {
+    MCParseCacheEntry *t_parse;
+    t_parse = MCParseCacheFetch(ctxt, kMCParseCacheKindExpression, p_expression, 0);
+    if (t_parse != nil)
+        return t_parse;
+
+    uint32_t t_generation;
+    t_generation = MCParseCacheGetGeneration();
+
     MCScriptPoint sp(ctxt, p_expression);
     // SN-2015-06-03: [[ Bug 11277 ]] When we are out of handler, then it simply
     //  sets the ScriptPoint handler to NULL (same as post-constructor state).
@@ -1310,33 +1321,53 @@ void MCExecContext::eval(MCExecContext &ctxt, MCStringRef p_expression, MCValueR
     MCExpression *exp = NULL;
     Symbol_type type;
 
-    if (sp.parseexp(False, True, &exp) == PS_NORMAL && sp.next(type) == PS_EOF)
-        ctxt . EvalExprAsValueRef(exp, EE_HANDLER_BADEXP, r_value);
+    if (sp.parseexp(False, True, &exp) != PS_NORMAL || sp.next(type) != PS_EOF)
+    {
+        delete exp;
+        return nil;
+    }
+
+    return MCParseCacheAdd(ctxt, kMCParseCacheKindExpression, p_expression, 0, t_generation, NULL, 0, exp);
+}
+
+void MCExecContext::eval(MCExecContext &ctxt, MCStringRef p_expression, MCValueRef &r_value)
+{
+    MCParseCacheEntry *t_parse;
+    t_parse = MCExecContextParseExpression(ctxt, p_expression);
+
+    if (t_parse != nil)
+        ctxt . EvalExprAsValueRef(t_parse -> expression, EE_HANDLER_BADEXP, r_value);
     else
         ctxt . Throw();
 
-    delete exp;
+    MCParseCacheRelease(t_parse);
 }
 
 void MCExecContext::eval_ctxt(MCExecContext &ctxt, MCStringRef p_expression, MCExecValue& r_value)
 {
-    MCScriptPoint sp(ctxt, p_expression);
-    // SN-2015-06-03: [[ Bug 11277 ]] When we are out of handler, then it simply
-    //  sets the ScriptPoint handler to NULL (same as post-constructor state).
-    sp.sethandler(ctxt . GetHandler());
-    MCExpression *exp = NULL;
-    Symbol_type type;
+    MCParseCacheEntry *t_parse;
+    t_parse = MCExecContextParseExpression(ctxt, p_expression);
 
-    if (sp.parseexp(False, True, &exp) == PS_NORMAL && sp.next(type) == PS_EOF)
-        ctxt . EvaluateExpression(exp, EE_HANDLER_BADEXP, r_value);
+    if (t_parse != nil)
+        ctxt . EvaluateExpression(t_parse -> expression, EE_HANDLER_BADEXP, r_value);
     else
         ctxt . Throw();
 
-    delete exp;
+    MCParseCacheRelease(t_parse);
 }
 
-void MCExecContext::doscript(MCExecContext &ctxt, MCStringRef p_script, uinteger_t p_line, uinteger_t p_pos)
+// Parse the statements of the script in the context, or fetch their parse
+// from the cache. If the script does not parse, nil is returned.
+static MCParseCacheEntry *MCExecContextParseStatements(MCExecContext &ctxt, MCStringRef p_script, uinteger_t p_line, uinteger_t p_pos)
 {
+    MCParseCacheEntry *t_parse;
+    t_parse = MCParseCacheFetch(ctxt, kMCParseCacheKindStatements, p_script, p_line);
+    if (t_parse != nil)
+        return t_parse;
+
+    uint32_t t_generation;
+    t_generation = MCParseCacheGetGeneration();
+
     MCScriptPoint sp(ctxt, p_script);
     MCStatement *curstatement = NULL;
     MCStatement *statements = NULL;
@@ -1404,45 +1435,58 @@ void MCExecContext::doscript(MCExecContext &ctxt, MCStringRef p_script, uinteger
     }
     MCexplicitvariables = oldexplicit;
 
-    if (MClicenseparameters . do_limit > 0 && count >= MClicenseparameters . do_limit)
+    if (stat == ES_ERROR)
     {
-        MCeerror -> add(EE_DO_NOTLICENSED, p_line, p_pos, p_script);
-        stat = ES_ERROR;
+        ctxt.deletestatements(statements);
+        return nil;
     }
 
-    if (stat == ES_ERROR)
+    return MCParseCacheAdd(ctxt, kMCParseCacheKindStatements, p_script, p_line, t_generation, statements, count, NULL);
+}
+
+void MCExecContext::doscript(MCExecContext &ctxt, MCStringRef p_script, uinteger_t p_line, uinteger_t p_pos)
+{
+    MCParseCacheEntry *t_parse;
+    t_parse = MCExecContextParseStatements(ctxt, p_script, p_line, p_pos);
+    if (t_parse == nil)
+    {
+        ctxt.Throw();
+        return;
+    }
+
+    if (MClicenseparameters . do_limit > 0 && t_parse -> line_count >= MClicenseparameters . do_limit)
     {
-        deletestatements(statements);
+        MCParseCacheRelease(t_parse);
+        MCeerror -> add(EE_DO_NOTLICENSED, p_line, p_pos, p_script);
         ctxt.Throw();
         return;
     }
 
+    // The statements may be shared with other uses of the same script (or
+    // be evicted while they run), so are only released once all have run.
     MCExecContext ctxt2(ctxt);
-    while (statements != NULL)
+    MCStatement *t_statement = t_parse -> statements;
+    while (t_statement != NULL)
     {
-        statements->exec_ctxt(ctxt2);
+        Exec_stat stat;
+        t_statement->exec_ctxt(ctxt2);
         stat = ctxt2 . GetExecStat();
         if (stat == ES_ERROR)
         {
-            deletestatements(statements);
+            MCParseCacheRelease(t_parse);
             MCeerror->add(EE_DO_BADEXEC, p_line, p_pos, p_script);
             ctxt.Throw();
             return;
         }
         if (MCexitall || stat != ES_NORMAL)
         {
-            deletestatements(statements);
-            if (stat == ES_ERROR)
-                ctxt.Throw();
+            MCParseCacheRelease(t_parse);
             return;
         }
-        else
-        {
-            MCStatement *tsptr = statements;
-            statements = statements->getnext();
-            delete tsptr;
-        }
+        t_statement = t_statement->getnext();
     }
+    MCParseCacheRelease(t_parse);
+
     if (MCscreen->abortkey())
     {
         MCeerror->add(EE_DO_ABORT, p_line, p_pos);
@@ -2054,6 +2054,8 @@ void MCStringsEvalByteOffset(MCExecContext& ctxt, MCDataRef p_chunk, MCDataRef p
 void MCStringsEvalOffset(MCExecContext& ctxt, MCStringRef p_chunk, MCStringRef p_string, uindex_t p_start_offset, uindex_t& r_result);
 
 void MCStringsExecReplace(MCExecContext& ctxt, MCStringRef p_pattern, MCStringRef p_replacement, MCStringRef p_target);
+bool MCStringsCreateReplacer(MCExecContext& ctxt, MCArrayRef p_pairs, MCStringReplacerRef& r_replacer);
+void MCStringsExecReplaceMultiple(MCExecContext& ctxt, MCStringReplacerRef p_replacer, MCStringRef p_target);
 
 void MCStringsExecFilterWildcard(MCExecContext& ctxt, MCStringRef p_source, MCStringRef p_pattern, bool p_without, bool p_lines, MCStringRef &r_result);
 void MCStringsExecFilterRegex(MCExecContext& ctxt, MCStringRef p_source, MCStringRef p_pattern, bool p_without, bool p_lines, MCStringRef &r_result);
@@ -3126,6 +3128,14 @@ void MCEngineSetRecursionLimit(MCExecContext& ctxt, uinteger_t p_value);
 
 void MCEngineGetAddress(MCExecContext& ctxt, MCStringRef &r_value);
 void MCEngineGetStacksInUse(MCExecContext& ctxt, MCStringRef &r_value);
+void MCEngineGetNameTableStatistics(MCExecContext& ctxt, MCArrayRef &r_value);
+void MCEngineGetValueStatistics(MCExecContext& ctxt, MCArrayRef &r_value);
+void MCEngineGetParseCacheSize(MCExecContext& ctxt, uinteger_t& r_value);
+void MCEngineSetParseCacheSize(MCExecContext& ctxt, uinteger_t p_value);
+void MCEngineGetParseCacheStatistics(MCExecContext& ctxt, MCArrayRef &r_value);
+void MCEngineGetCacheUnhandledMessages(MCExecContext& ctxt, bool& r_value);
+void MCEngineSetCacheUnhandledMessages(MCExecContext& ctxt, bool p_value);
+void MCEngineGetMessageCacheStatistics(MCExecContext& ctxt, MCArrayRef &r_value);
 
 void MCEngineMarkVariable(MCExecContext& ctxt, MCVarref *p_variable, bool p_data, MCMarkedText& r_mark);
 
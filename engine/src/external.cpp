@@ -31,6 +31,7 @@ along with LiveCode.  If not see <http://www.gnu.org/licenses/>.  */
 #include "globals.h"
 
 #include "external.h"
+#include "messagecache.h"
 
 ////////////////////////////////////////////////////////////////////////////////
 
@@ -40,6 +41,8 @@ MCExternalHandlerList::MCExternalHandlerList(void)
 
 MCExternalHandlerList::~MCExternalHandlerList(void)
 {
+	MCMessageCacheInvalidate();
+
 	for(uint32_t i = 0; i < m_externals . Count(); i++)
 		MCExternal::Unload(m_externals[i]);
 
@@ -123,6 +126,9 @@ bool MCExternalHandlerList::Load(MCStringRef p_external)
 		t_success = m_externals . Append(t_external);
 	}
 
+	// The external's handlers may handle messages which went unhandled.
+	MCMessageCacheInvalidate();
+
 	if (!t_success)
 	{
 		for(uindex_t i = 0; i < m_handlers . Count(); i++)
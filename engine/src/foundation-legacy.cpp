@@ -669,14 +669,14 @@ bool MCStringToInteger(MCStringRef p_string, integer_t& r_integer)
 
 bool MCStringToDouble(MCStringRef p_string, double& r_real)
 {
-	char *t_end;
+	const char *t_end;
 	t_end = nil;
 	
     MCAutoStringRefAsCString t_string;
     t_string . Lock(p_string);
     
 	double t_value;
-	t_value = strtod(*t_string, &t_end);
+	t_value = MCTypeConvertCStringToReal(*t_string, t_end);
 	
 	if (t_end != *t_string + strlen(*t_string))
 		return false;
@@ -1126,6 +1126,14 @@ bool MCArrayIsSequence(MCArrayRef self)
 
 bool MCArrayIsNumericSequence(MCArrayRef self, int32_t &r_start_index)
 {
+    // A dense array is always the sequence 1..count, so there is no need to
+    // look at (and create) its keys.
+    if (MCArrayIsDense(self))
+    {
+        r_start_index = 1;
+        return true;
+    }
+
     get_array_extent_context_t ctxt;
     ctxt . minimum = INDEX_MAX;
     ctxt . maximum = INDEX_MIN;
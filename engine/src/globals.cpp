@@ -96,6 +96,7 @@ along with LiveCode.  If not see <http://www.gnu.org/licenses/>.  */
 
 #include "exec.h"
 #include "chunk.h"
+#include "parsecache.h"
 
 ////////////////////////////////////////////////////////////////////////////////
 
@@ -1316,6 +1317,10 @@ int X_close(void)
 	MClockmessages = True;
 	MCS_killall();
 
+	// Parses held for 'do' and 'value' refer to objects' handlers, so are
+	// released before the objects are deleted.
+	MCParseCacheFinalize();
+
     // Flush all engine clipboards to the system clipboards
     MCclipboard->FlushData();
     MCselection->FlushData();
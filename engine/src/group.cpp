@@ -206,6 +206,9 @@ MCGroup::MCGroup(const MCGroup &gref, bool p_copy_ids) :
 
 MCGroup::~MCGroup()
 {
+	// Messages to the group's controls pass through it.
+	MCMessageCacheInvalidate();
+
 	MCValueRelease(label);
 	while (controls != NULL)
 	{
@@ -1791,7 +1794,7 @@ void MCGroup::makegroup(MCControl *newcontrols, MCObject *newparent)
 {
 	if (parent->getstack() != newparent->getstack())
 		obj_id = newparent->getstack()->newid();
-	parent = newparent;
+	setparent(newparent);
 	setcontrols(newcontrols);
 	computeminrect(False);
 	attach(OP_NONE, false);
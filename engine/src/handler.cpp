@@ -41,6 +41,7 @@ along with LiveCode.  If not see <http://www.gnu.org/licenses/>.  */
 #include "keywords.h"
 
 #include "exec.h"
+#include "parsecache.h"
 
 ////////////////////////////////////////////////////////////////////////////////
 
@@ -76,6 +77,9 @@ MCHandler::MCHandler(uint1 htype, bool p_is_private)
 
 MCHandler::~MCHandler()
 {
+	// Cached parses hold references to the handler's variables.
+	MCParseCacheInvalidate();
+
 	MCStatement *stmp;
 	while (statements != NULL)
 	{
@@ -514,6 +518,12 @@ Exec_stat MCHandler::exec(MCExecContext& ctxt, MCParameter *plist)
 		MCB_trace(ctxt, lastline, 0);
     
 	executing--;
+
+	// Variables and constants declared by 'do' in this activation are removed
+	// below, so parses which referred to them are no longer valid.
+	if (nvnames != oldnvnames || nconstants != oldnconstants)
+		MCParseCacheInvalidate();
+
 	if (params != NULL)
 	{
 		i = newnparams;
@@ -628,6 +638,8 @@ Parse_stat MCHandler::findvar(MCNameRef p_name, MCVarref **dptr)
 
 Parse_stat MCHandler::newvar(MCNameRef p_name, MCValueRef p_init, MCVarref **r_ref)
 {
+	MCParseCacheInvalidate();
+
 	MCU_realloc((char **)&vinfo, nvnames, nvnames + 1, sizeof(MCHandlerVarInfo));
     vinfo[nvnames] . name = MCValueRetain(p_name);
 	if (p_init != nil)
@@ -668,6 +680,8 @@ Parse_stat MCHandler::findconstant(MCNameRef p_name, MCExpression **dptr)
 
 Parse_stat MCHandler::newconstant(MCNameRef p_name, MCValueRef p_value)
 {
+	MCParseCacheInvalidate();
+
 	MCU_realloc((char **)&cinfo, nconstants, nconstants + 1, sizeof(MCHandlerConstantInfo));
     cinfo[nconstants].name = MCValueRetain(p_name);
 	cinfo[nconstants++].value = MCValueRetain(p_value);
@@ -702,6 +716,8 @@ void MCHandler::newglobal(MCNameRef p_name)
 		if (globals[i]->hasname(p_name))
 			return;
 
+	MCParseCacheInvalidate();
+
 	MCVariable *gptr;
 	/* UNCHECKED */ MCVariable::ensureglobal(p_name, gptr);
 
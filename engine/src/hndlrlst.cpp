@@ -35,6 +35,7 @@ along with LiveCode.  If not see <http://www.gnu.org/licenses/>.  */
 #include "variable.h"
 
 #include "globals.h"
+#include "parsecache.h"
 
 ////////////////////////////////////////////////////////////////////////////////
 
@@ -145,6 +146,12 @@ MCHandlerlist::~MCHandlerlist()
 
 void MCHandlerlist::reset(void)
 {
+	// Cached parses hold references to the handlers and variables.
+	MCParseCacheInvalidate();
+
+	// Messages which went unhandled may now be handled, or the reverse.
+	MCMessageCacheInvalidate();
+
 	// MW-2012-09-05: [[ Bug ]] Make sure we reset the lists of before and after
 	//   as well as the others.
 	for(uint32_t i = 0; i < 6; ++i)
@@ -253,6 +260,8 @@ Parse_stat MCHandlerlist::findvar(MCNameRef p_name, bool p_ignore_uql, MCVarref
 
 Parse_stat MCHandlerlist::newvar(MCNameRef p_name, MCValueRef p_init, MCVarref **newptr, Boolean initialised)
 {
+	MCParseCacheInvalidate();
+
 	MCVariable *t_new_variable;
 
 	if (!initialised && s_old_variables != NULL)
@@ -337,6 +346,8 @@ Parse_stat MCHandlerlist::findconstant(MCNameRef p_name, MCExpression **dptr)
 
 Parse_stat MCHandlerlist::newconstant(MCNameRef p_name, MCValueRef p_value)
 {
+	MCParseCacheInvalidate();
+
 	MCU_realloc((char **)&cinfo, nconstants, nconstants + 1, sizeof(MCHandlerConstantInfo));
     cinfo[nconstants].name = MCValueRetain(p_name);
 	cinfo[nconstants++].value = MCValueRetain(p_value);
@@ -407,6 +418,8 @@ void MCHandlerlist::newglobal(MCNameRef p_name)
 		if (globals[i] -> hasname(p_name))
 			return;
 	
+	MCParseCacheInvalidate();
+
 	// Ensure a global exists with the given name
 	MCVariable *gptr;
 	/* UNCHECKED */ MCVariable::ensureglobal(p_name, gptr);
@@ -420,6 +433,9 @@ Parse_stat MCHandlerlist::parse(MCObject *objptr, MCDataRef script_utf8)
 {
 	Parse_stat status = PS_NORMAL;
 
+	// The handlers parsed may handle messages which went unhandled.
+	MCMessageCacheInvalidate();
+
 	// MW-2008-01-30: [[ Bug 5781 ]] Make sure we clear the parse error stack before
 	//   parsing. Otherwise we get bogus errors...
 	if (!MCperror -> isempty())
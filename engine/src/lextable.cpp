@@ -701,6 +701,7 @@ const LT factor_table[] =
 		{"bytetonum", TT_FUNCTION, F_BYTE_TO_NUM},
         {"cachedurl", TT_FUNCTION, F_CACHED_URLS},
         {"cachedurls", TT_FUNCTION, F_CACHED_URLS},
+        {"cacheunhandledmessages", TT_PROPERTY, P_CACHE_UNHANDLED_MESSAGES},
         {"callbacks", TT_PROPERTY, P_CALLBACKS},
         {"cantabort", TT_PROPERTY, P_CANT_ABORT},
         {"cantdelete", TT_PROPERTY, P_CANT_DELETE},
@@ -1245,6 +1246,7 @@ const LT factor_table[] =
         {"menuobject", TT_FUNCTION, F_MENU_OBJECT},
         {"menus", TT_FUNCTION, F_MENUS},
         {"merge", TT_FUNCTION, F_MERGE},
+        {"messagecachestatistics", TT_PROPERTY, P_MESSAGE_CACHE_STATISTICS},
         {"messagedigest", TT_FUNCTION, F_MESSAGE_DIGEST},
 		{"messagemessages", TT_PROPERTY, P_MESSAGE_MESSAGES},
 		{"metadata", TT_PROPERTY, P_METADATA},
@@ -1291,6 +1293,7 @@ const LT factor_table[] =
         {"multiplelines", TT_PROPERTY, P_MULTIPLE_HILITES},
         {"multispace", TT_PROPERTY, P_MULTI_SPACE},
         {"name", TT_PROPERTY, P_NAME},
+        {"nametablestatistics", TT_PROPERTY, P_NAME_TABLE_STATISTICS},
         {"nativechartonum", TT_FUNCTION, F_NATIVE_CHAR_TO_NUM},
         {"navigationarrows", TT_PROPERTY, P_NAVIGATION_ARROWS},
 		{"networkinterfaces", TT_PROPERTY, P_NETWORK_INTERFACES},
@@ -1346,6 +1349,8 @@ const LT factor_table[] =
         {"paramcount", TT_FUNCTION, F_PARAM_COUNT},
         {"params", TT_FUNCTION, F_PARAMS},
 		{"parentscript", TT_PROPERTY, P_PARENT_SCRIPT},
+        {"parsecachesize", TT_PROPERTY, P_PARSE_CACHE_SIZE},
+        {"parsecachestatistics", TT_PROPERTY, P_PARSE_CACHE_STATISTICS},
         {"part", TT_CHUNK, CT_LAYER},
         {"partnumber", TT_PROPERTY, P_LAYER},
         {"parts", TT_CLASS, CT_LAYER},
@@ -1823,6 +1828,7 @@ const LT factor_table[] =
 		// MW-2013-05-08: [[ Uuid ]] The uuid function token.
 		{"uuid", TT_FUNCTION, F_UUID},
         {"value", TT_FUNCTION, F_VALUE},
+        {"valuestatistics", TT_PROPERTY, P_VALUE_STATISTICS},
         {"variablenames", TT_FUNCTION, F_VARIABLES},
 		// JS-2013-06-19: [[ StatsFunctions ]] Token for 'sampleVariance' (aka variance)
         {"variance", TT_FUNCTION, F_SMP_VARIANCE},
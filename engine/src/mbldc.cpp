@@ -161,6 +161,11 @@ void MCScreenDC::common_open(void)
 
 void MCScreenDC::compact_memory(void)
 {
+	// Cached line / item offsets and chunk ranges can always be rebuilt on
+	// demand.
+	MCStringFlushDelimiterIndexCache();
+	MCStringFlushBreakIndexCache();
+	
 	if (m_current_window == nil)
 		return;
 	
@@ -0,0 +1,154 @@
+/* Copyright (C) 2017 LiveCode Ltd.
+
+This file is part of LiveCode.
+
+LiveCode is free software; you can redistribute it and/or modify it under
+the terms of the GNU General Public License v3 as published by the Free
+Software Foundation.
+
+LiveCode is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or
+FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+for more details.
+
+You should have received a copy of the GNU General Public License
+along with LiveCode.  If not see <http://www.gnu.org/licenses/>.  */
+
+#include "prefix.h"
+
+#include "globdefs.h"
+#include "filedefs.h"
+#include "objdefs.h"
+#include "parsedef.h"
+
+#include "object.h"
+#include "card.h"
+#include "messagecache.h"
+
+#include "globals.h"
+#include "debug.h"
+
+////////////////////////////////////////////////////////////////////////////////
+
+static bool s_message_cache_enabled = true;
+
+// The current generation. Invalidation only changes it, so that it is cheap
+// enough to be done wherever a message path changes; each object's messages
+// are discarded when it next records one.
+static uint32_t s_message_cache_generation = 0;
+
+static uint32_t s_message_cache_handler_runs = 0;
+
+static MCMessageCacheStatistics s_message_cache_statistics;
+
+////////////////////////////////////////////////////////////////////////////////
+
+static bool MCMessageCacheIsEnabled(void)
+{
+	// Watching messages reports each object the message passes through, the
+	// message box's trace window stops messages reaching the objects in it,
+	// and a dynamic path changes the path frontscripts see.
+	return s_message_cache_enabled &&
+			!MCmessagemessages &&
+			MCtracewindow == NULL &&
+			!MCdynamiccard . IsValid();
+}
+
+static void MCMessageCacheClear(MCMessageCache *p_cache)
+{
+	for(uindex_t i = 0; i < MESSAGE_CACHE_SLOTS; i++)
+	{
+		MCValueRelease(p_cache -> messages[i]);
+		p_cache -> messages[i] = nil;
+	}
+	p_cache -> next = 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void MCMessageCacheInvalidate(void)
+{
+	s_message_cache_generation += 1;
+	s_message_cache_statistics . invalidations += 1;
+}
+
+uint32_t MCMessageCacheGetGeneration(void)
+{
+	return s_message_cache_generation;
+}
+
+void MCMessageCacheNoteHandlerRun(void)
+{
+	s_message_cache_handler_runs += 1;
+}
+
+uint32_t MCMessageCacheGetHandlerRuns(void)
+{
+	return s_message_cache_handler_runs;
+}
+
+bool MCMessageCacheIsUnhandled(MCMessageCache *p_cache, MCNameRef p_message)
+{
+	if (!MCMessageCacheIsEnabled())
+		return false;
+
+	if (p_cache != nil && p_cache -> generation == s_message_cache_generation)
+		for(uindex_t i = 0; i < MESSAGE_CACHE_SLOTS; i++)
+			if (p_cache -> messages[i] != nil &&
+				MCNameIsEqualToCaseless(p_cache -> messages[i], p_message))
+			{
+				s_message_cache_statistics . hits += 1;
+				return true;
+			}
+
+	s_message_cache_statistics . misses += 1;
+	return false;
+}
+
+void MCMessageCacheAddUnhandled(MCMessageCache*& x_cache, MCNameRef p_message, uint32_t p_generation, uint32_t p_handler_runs)
+{
+	if (!MCMessageCacheIsEnabled() ||
+		p_generation != s_message_cache_generation ||
+		p_handler_runs != s_message_cache_handler_runs)
+		return;
+
+	// The cache is created by the first message recorded.
+	if (x_cache == nil && !MCMemoryNew(x_cache))
+		return;
+
+	if (x_cache -> generation != s_message_cache_generation)
+	{
+		MCMessageCacheClear(x_cache);
+		x_cache -> generation = s_message_cache_generation;
+	}
+
+	// Replace the messages in the order they were recorded.
+	MCValueRelease(x_cache -> messages[x_cache -> next]);
+	x_cache -> messages[x_cache -> next] = MCValueRetain(p_message);
+	x_cache -> next = (x_cache -> next + 1) % MESSAGE_CACHE_SLOTS;
+}
+
+void MCMessageCacheDelete(MCMessageCache *p_cache)
+{
+	if (p_cache == nil)
+		return;
+
+	MCMessageCacheClear(p_cache);
+	MCMemoryDelete(p_cache);
+}
+
+void MCMessageCacheSetEnabled(bool p_enabled)
+{
+	s_message_cache_enabled = p_enabled;
+	MCMessageCacheInvalidate();
+}
+
+bool MCMessageCacheGetEnabled(void)
+{
+	return s_message_cache_enabled;
+}
+
+void MCMessageCacheGetStatistics(MCMessageCacheStatistics& r_statistics)
+{
+	r_statistics = s_message_cache_statistics;
+}
@@ -0,0 +1,84 @@
+/* Copyright (C) 2017 LiveCode Ltd.
+
+This file is part of LiveCode.
+
+LiveCode is free software; you can redistribute it and/or modify it under
+the terms of the GNU General Public License v3 as published by the Free
+Software Foundation.
+
+LiveCode is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or
+FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+for more details.
+
+You should have received a copy of the GNU General Public License
+along with LiveCode.  If not see <http://www.gnu.org/licenses/>.  */
+
+//
+// Cache of the messages which nothing on an object's message path handles
+//
+#ifndef	MESSAGECACHE_H
+#define	MESSAGECACHE_H
+
+// The number of unhandled messages remembered for each object.
+#define MESSAGE_CACHE_SLOTS 8
+
+// The messages last found to pass through the whole message path of an
+// object without being handled. Engine messages such as 'mouseMove' and
+// 'idle' are sent far more often than they are handled, and the walk through
+// the frontscripts, the object and its owners, their behaviors, the library
+// stacks and the backscripts is the same every time until one of them
+// changes. The messages an object holds are only valid in the generation they
+// were recorded in.
+struct MCMessageCache
+{
+	uint32_t generation;
+	uindex_t next;
+	MCNameRef messages[MESSAGE_CACHE_SLOTS];
+};
+
+struct MCMessageCacheStatistics
+{
+	uint64_t hits;
+	uint64_t misses;
+	uint64_t invalidations;
+};
+
+// Forget every unhandled message held by every object. This must be called
+// whenever the handlers a message could reach may change: when a script is
+// set, or a handler list parsed, reset or deleted, when an object is given a
+// new owner or behavior, or is deleted, when the order of the groups on a
+// card or their background behavior changes, when a script is inserted or
+// removed, when a stack is started or stopped being used, when externals or
+// extension libraries are loaded or unloaded, and when a stack's window is
+// destroyed (as the first message through a stack without a window creates
+// one).
+void MCMessageCacheInvalidate(void);
+
+// The generation is changed by each invalidation. A message is only recorded
+// as unhandled if the generation is the same as before it was sent.
+uint32_t MCMessageCacheGetGeneration(void);
+
+// The count of script handlers run. A message is only recorded as unhandled
+// if no handler ran while it was sent (a handler may have been run and
+// returned without handling it).
+void MCMessageCacheNoteHandlerRun(void);
+uint32_t MCMessageCacheGetHandlerRuns(void);
+
+// Whether the message was recorded as unhandled by the object's message path
+// in the current generation.
+bool MCMessageCacheIsUnhandled(MCMessageCache *p_cache, MCNameRef p_message);
+
+// Record the message as unhandled by the object's message path, if it was
+// sent in the given generation and handler run count and both are current.
+void MCMessageCacheAddUnhandled(MCMessageCache*& x_cache, MCNameRef p_message, uint32_t p_generation, uint32_t p_handler_runs);
+
+void MCMessageCacheDelete(MCMessageCache *p_cache);
+
+// The cache is on by default; turning it off forgets every message held.
+void MCMessageCacheSetEnabled(bool p_enabled);
+bool MCMessageCacheGetEnabled(void);
+
+void MCMessageCacheGetStatistics(MCMessageCacheStatistics& r_statistics);
+
+#endif
@@ -139,6 +139,8 @@ MCObject::MCObject()
 	// MW-2008-10-25: Initialize the parent script link to NULL
 	parent_script = NULL;
 
+	m_unhandled_messages = nil;
+
 	// Generate a weak proxy object
 	m_weak_proxy = new MCObjectProxyBase(this);
 
@@ -245,6 +247,9 @@ MCObject::MCObject(const MCObject &oref)
 	else
 		parent_script = NULL;
 
+	// The clone's message path is not yet known.
+	m_unhandled_messages = nil;
+
 	// Generate a weak proxy object
 	m_weak_proxy = new MCObjectProxyBase(this);
 
@@ -290,6 +295,13 @@ MCObject::~MCObject()
 	// MW-2012-02-16: [[ LogFonts ]] Delete the font attrs (if any).
 	clearfontattrs();
 
+	// The object's handlers may have been on the message path of others. (The
+	// type is not known here, so cards, groups and stacks invalidate the
+	// cache themselves as the owners of others.)
+	MCMessageCacheDelete(m_unhandled_messages);
+	if (hasmessagehandlers())
+		MCMessageCacheInvalidate();
+
 	// MW-2008-10-25: Release the parent script use
 	if (parent_script != NULL)
 		parent_script -> Release();
@@ -860,6 +872,14 @@ void MCObject::removereferences()
     removefrom(MCfrontscripts);
     removefrom(MCbackscripts);
     
+    // Only an object with handlers or which owns others can be on the message
+    // path of another object.
+    Chunk_term t_type;
+    t_type = gettype();
+    if (hasmessagehandlers() ||
+        t_type == CT_CARD || t_type == CT_GROUP || t_type == CT_STACK)
+        MCMessageCacheInvalidate();
+    
     // MW-2009-11-03: Clear all current breakpoints for this object
     MCB_clearbreaks(this);
     
@@ -928,6 +948,8 @@ Exec_stat MCObject::exechandler(MCHandler *hptr, MCParameter *params)
 
 	if (MCmessagemessages)
 		sendmessage(hptr -> gettype(), hptr -> getname(), True);
+
+	MCMessageCacheNoteHandlerRun();
 	
 	lockforexecution();
     MCExecContext ctxt(this, hlist, hptr);
@@ -982,6 +1004,8 @@ Exec_stat MCObject::execparenthandler(MCHandler *hptr, MCParameter *params, MCPa
 	if (MCmessagemessages)
 		sendmessage(hptr -> gettype(), hptr -> getname(), True);
 
+	MCMessageCacheNoteHandlerRun();
+
 	MCObject *t_parentscript_object = parentscript->GetParent()->GetObject();
 	t_parentscript_object->lockforexecution();
 
@@ -2161,32 +2185,48 @@ Exec_stat MCObject::message(MCNameRef mess, MCParameter *paramptr, Boolean chang
 
 		MCS_alarm(CHECK_INTERVAL);
 		MCdebugcontext = MAXUINT2;
-		stat = MCU_dofrontscripts(HT_MESSAGE, mess, paramptr);
-		
-		if (t_stack.IsValid())
+
+		// If nothing on the message path handled the message the last time
+		// it was sent to this object, and the path has not changed since,
+		// then nothing will handle it now.
+		if (MCMessageCacheIsUnhandled(m_unhandled_messages, mess))
+			stat = ES_NOT_HANDLED;
+		else
 		{
-			Window mywindow = t_stack->getw();
-			if ((stat == ES_NOT_HANDLED || stat == ES_PASS)
-					&& (MCtracewindow == NULL
-						|| memcmp(&mywindow, &MCtracewindow, sizeof(Window))))
+			uint32_t t_generation, t_handler_runs;
+			t_generation = MCMessageCacheGetGeneration();
+			t_handler_runs = MCMessageCacheGetHandlerRuns();
+
+			stat = MCU_dofrontscripts(HT_MESSAGE, mess, paramptr);
+			
+			if (t_stack.IsValid())
 			{
-                /* If the object was deleted in the frontscript,
-                 * prevent normal message dispatch as if the
-                 * frontscript did not pass the message. */
-                if (t_self_handle)
-                {
-                    // MAY-DELETE: Handle the message - this might be unbound after
-                    // this call if it is deleted.
-                    Exec_stat oldstat = stat;
-                    stat = handle(HT_MESSAGE, mess, paramptr, this);
-                    if (oldstat == ES_PASS && stat == ES_NOT_HANDLED)
-                        stat = ES_PASS;
-                }
-                else
-                {
-                    stat = ES_NORMAL;
-                }
+				Window mywindow = t_stack->getw();
+				if ((stat == ES_NOT_HANDLED || stat == ES_PASS)
+						&& (MCtracewindow == NULL
+							|| memcmp(&mywindow, &MCtracewindow, sizeof(Window))))
+				{
+                    /* If the object was deleted in the frontscript,
+                     * prevent normal message dispatch as if the
+                     * frontscript did not pass the message. */
+                    if (t_self_handle)
+                    {
+                        // MAY-DELETE: Handle the message - this might be unbound after
+                        // this call if it is deleted.
+                        Exec_stat oldstat = stat;
+                        stat = handle(HT_MESSAGE, mess, paramptr, this);
+                        if (oldstat == ES_PASS && stat == ES_NOT_HANDLED)
+                            stat = ES_PASS;
+                    }
+                    else
+                    {
+                        stat = ES_NORMAL;
+                    }
+				}
 			}
+
+			if (stat == ES_NOT_HANDLED && t_self_handle)
+				MCMessageCacheAddUnhandled(m_unhandled_messages, mess, t_generation, t_handler_runs);
 		}
 	}
 	if ((!send || !changedefault || MCdefaultstackptr == t_stack)
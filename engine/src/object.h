@@ -26,6 +26,7 @@ along with LiveCode.  If not see <http://www.gnu.org/licenses/>.  */
 #include "parsedef.h"
 #include "platform.h"
 #include "context.h"
+#include "messagecache.h"
 
 #include "native-layer.h"
 
@@ -588,6 +589,9 @@ protected:
 	// MW-2008-10-20: Pointer to the parent script's weak object reference.
 	MCParentScriptUse *parent_script;
 
+	// The messages last found to go unhandled by this object's message path.
+	MCMessageCache *m_unhandled_messages;
+
 	// Pointer to the object's weak reference (if any).
 	// [[ C++11 ]] The various compilers we support disagree about what this friend declaration should look like
 #if defined(__clang__) || defined(_MSC_VER)
@@ -864,6 +868,23 @@ public:
 	{
 		return hlist;
 	}
+	// Whether messages could be handled by the object's script or behavior.
+	bool hasmessagehandlers(void) const
+	{
+		return hlist != nil || !MCStringIsEmpty(_script) || parent_script != nil;
+	}
+	// Whether nothing on the object's message path handled the message the
+	// last time it was sent, and the path has not changed since.
+	bool ismessageunhandled(MCNameRef p_message)
+	{
+		return MCMessageCacheIsUnhandled(m_unhandled_messages, p_message);
+	}
+	// Remember that nothing on the message path handled the message, if it
+	// did not change while the message was sent.
+	void setmessageunhandled(MCNameRef p_message, uint32_t p_generation, uint32_t p_handler_runs)
+	{
+		MCMessageCacheAddUnhandled(m_unhandled_messages, p_message, p_generation, p_handler_runs);
+	}
 
 	uint32_t getopacity(void) { return blendlevel * 255 / 100; }
 	uint32_t getink(void) { return ink; }
@@ -923,7 +944,11 @@ public:
 	
 	void setparent(MCObject *newparent)
 	{
+		// The message path only changes if the owner does.
+		if (parent.UnsafeGet() == newparent)
+			return;
 		parent = newparent;
+		MCMessageCacheInvalidate();
 	}
 	MCCard *getcard(uint4 cid = 0);
 	Window getw();
@@ -364,6 +364,9 @@ void MCParentScript::Resolve(MCObject *p_object)
 	// Assign the reference to the object
 	m_object = p_object;
 
+	// The object's handlers are now on the message path of its users.
+	MCMessageCacheInvalidate();
+
 	// Unblock this
 	m_blocked = false;
 
@@ -392,6 +395,7 @@ void MCParentScript::Flush(void)
 {
 	// Clear the reference
 	m_object = NULL;
+	MCMessageCacheInvalidate();
 
 	// Iterate through all the uses, clearing out variables
 	for(MCParentScriptUse *t_use = m_first_use; t_use != NULL; t_use = t_use -> m_next_use)
@@ -427,6 +431,9 @@ bool MCParentScript::CopyUses(MCArrayRef& r_use)
 //   and ensure the super-use chains are correct.
 bool MCParentScript::Reinherit(void)
 {
+	// The behaviors the uses pass messages through are changing.
+	MCMessageCacheInvalidate();
+
 	// Iterate through all the uses, calling inherit on each one to make sure that
 	// the super-use chain is updated appropriately.
 	for(MCParentScriptUse *t_use = m_first_use; t_use != NULL; t_use = t_use -> m_next_use)
@@ -0,0 +1,323 @@
+/* Copyright (C) 2017 LiveCode Ltd.
+
+This file is part of LiveCode.
+
+LiveCode is free software; you can redistribute it and/or modify it under
+the terms of the GNU General Public License v3 as published by the Free
+Software Foundation.
+
+LiveCode is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or
+FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+for more details.
+
+You should have received a copy of the GNU General Public License
+along with LiveCode.  If not see <http://www.gnu.org/licenses/>.  */
+
+#include "prefix.h"
+
+#include "globdefs.h"
+#include "filedefs.h"
+#include "objdefs.h"
+#include "parsedef.h"
+
+#include "statemnt.h"
+#include "express.h"
+#include "exec.h"
+#include "parsecache.h"
+
+#include "globals.h"
+#include "debug.h"
+
+////////////////////////////////////////////////////////////////////////////////
+
+// The settings a parse depends upon, which form part of its key.
+enum
+{
+	kMCParseCacheOptionExplicitVariables = 1 << 0,
+};
+
+// The most buckets the table is given, however large the cache is.
+#define PARSE_CACHE_MAX_BUCKETS 65536
+
+static uindex_t s_parse_cache_size = PARSE_CACHE_DEFAULT_SIZE;
+
+// The table of entries, chained through 'chain', and the number it holds.
+static MCParseCacheEntry **s_parse_cache_buckets = nil;
+static uindex_t s_parse_cache_bucket_count = 0;
+static uindex_t s_parse_cache_count = 0;
+
+// The list of entries in order of use, linked through 'newer' and 'older'.
+static MCParseCacheEntry *s_parse_cache_newest = nil;
+static MCParseCacheEntry *s_parse_cache_oldest = nil;
+
+// The current generation, and the generation the entries held were parsed
+// in. Invalidation only changes the former so that it is cheap enough to be
+// done wherever a scope changes; the entries are flushed when the cache is
+// next used.
+static uint32_t s_parse_cache_generation = 0;
+static uint32_t s_parse_cache_held_generation = 0;
+
+static MCParseCacheStatistics s_parse_cache_statistics;
+
+////////////////////////////////////////////////////////////////////////////////
+
+static bool MCParseCacheIsEnabled(void)
+{
+	// While debugging, names may be resolved in the context being debugged
+	// rather than the one the parse is made in.
+	return s_parse_cache_size != 0 && MCdebugcontext == MAXUINT2;
+}
+
+static uint32_t MCParseCacheComputeOptions(MCParseCacheKind p_kind)
+{
+	uint32_t t_options;
+	t_options = 0;
+
+	// 'do' always parses with explicitVariables turned off.
+	if (p_kind == kMCParseCacheKindExpression && MCexplicitvariables)
+		t_options |= kMCParseCacheOptionExplicitVariables;
+
+	return t_options;
+}
+
+static void MCParseCacheDeleteParse(MCStatement *p_statements, MCExpression *p_expression)
+{
+	while (p_statements != NULL)
+	{
+		MCStatement *t_statement;
+		t_statement = p_statements;
+		p_statements = p_statements -> getnext();
+		delete t_statement;
+	}
+
+	delete p_expression;
+}
+
+static void MCParseCacheLinkNewest(MCParseCacheEntry *p_entry)
+{
+	p_entry -> newer = nil;
+	p_entry -> older = s_parse_cache_newest;
+	if (s_parse_cache_newest != nil)
+		s_parse_cache_newest -> newer = p_entry;
+	else
+		s_parse_cache_oldest = p_entry;
+	s_parse_cache_newest = p_entry;
+}
+
+static void MCParseCacheUnlink(MCParseCacheEntry *p_entry)
+{
+	if (p_entry -> newer != nil)
+		p_entry -> newer -> older = p_entry -> older;
+	else
+		s_parse_cache_newest = p_entry -> older;
+
+	if (p_entry -> older != nil)
+		p_entry -> older -> newer = p_entry -> newer;
+	else
+		s_parse_cache_oldest = p_entry -> newer;
+}
+
+// Remove the entry from the table and the list, releasing the reference the
+// cache holds.
+static void MCParseCacheRemove(MCParseCacheEntry *p_entry)
+{
+	MCParseCacheEntry **t_link;
+	t_link = &s_parse_cache_buckets[p_entry -> hash & (s_parse_cache_bucket_count - 1)];
+	while (*t_link != p_entry)
+		t_link = &(*t_link) -> chain;
+	*t_link = p_entry -> chain;
+
+	MCParseCacheUnlink(p_entry);
+	s_parse_cache_count -= 1;
+
+	MCParseCacheRelease(p_entry);
+}
+
+static void MCParseCacheFlush(void)
+{
+	if (s_parse_cache_count != 0)
+		s_parse_cache_statistics . flushes += 1;
+
+	while (s_parse_cache_oldest != nil)
+		MCParseCacheRemove(s_parse_cache_oldest);
+}
+
+static void MCParseCacheValidate(void)
+{
+	if (s_parse_cache_held_generation == s_parse_cache_generation)
+		return;
+
+	MCParseCacheFlush();
+	s_parse_cache_held_generation = s_parse_cache_generation;
+}
+
+static bool MCParseCacheCreateBuckets(void)
+{
+	uindex_t t_bucket_count;
+	t_bucket_count = 16;
+	while (t_bucket_count < s_parse_cache_size && t_bucket_count < PARSE_CACHE_MAX_BUCKETS)
+		t_bucket_count *= 2;
+
+	if (!MCMemoryNewArray(t_bucket_count, s_parse_cache_buckets))
+		return false;
+
+	s_parse_cache_bucket_count = t_bucket_count;
+	return true;
+}
+
+static void MCParseCacheDeleteBuckets(void)
+{
+	MCParseCacheFlush();
+	MCMemoryDeleteArray(s_parse_cache_buckets);
+	s_parse_cache_buckets = nil;
+	s_parse_cache_bucket_count = 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void MCParseCacheInvalidate(void)
+{
+	s_parse_cache_generation += 1;
+}
+
+uint32_t MCParseCacheGetGeneration(void)
+{
+	return s_parse_cache_generation;
+}
+
+MCParseCacheEntry *MCParseCacheFetch(MCExecContext& ctxt, MCParseCacheKind p_kind, MCStringRef p_source, uint32_t p_line)
+{
+	if (!MCParseCacheIsEnabled())
+		return nil;
+
+	MCParseCacheValidate();
+
+	hash_t t_hash;
+	t_hash = MCStringHash(p_source, kMCStringOptionCompareExact);
+
+	uint32_t t_options;
+	t_options = MCParseCacheComputeOptions(p_kind);
+
+	// The table is created by the first parse added.
+	MCParseCacheEntry *t_entry;
+	t_entry = nil;
+	if (s_parse_cache_buckets != nil)
+		t_entry = s_parse_cache_buckets[t_hash & (s_parse_cache_bucket_count - 1)];
+
+	for(; t_entry != nil; t_entry = t_entry -> chain)
+		if (t_entry -> hash == t_hash &&
+			t_entry -> kind == p_kind &&
+			t_entry -> object == ctxt . GetObject() &&
+			t_entry -> handler_list == ctxt . GetHandlerList() &&
+			t_entry -> handler == ctxt . GetHandler() &&
+			t_entry -> line == p_line &&
+			t_entry -> options == t_options &&
+			MCStringIsEqualTo(t_entry -> source, p_source, kMCStringOptionCompareExact))
+			break;
+
+	if (t_entry == nil)
+	{
+		s_parse_cache_statistics . misses += 1;
+		return nil;
+	}
+
+	s_parse_cache_statistics . hits += 1;
+
+	MCParseCacheUnlink(t_entry);
+	MCParseCacheLinkNewest(t_entry);
+
+	t_entry -> references += 1;
+	return t_entry;
+}
+
+MCParseCacheEntry *MCParseCacheAdd(MCExecContext& ctxt, MCParseCacheKind p_kind, MCStringRef p_source, uint32_t p_line, uint32_t p_generation, MCStatement *p_statements, uint4 p_line_count, MCExpression *p_expression)
+{
+	MCParseCacheEntry *t_entry;
+	t_entry = new (nothrow) MCParseCacheEntry;
+	if (t_entry == nil)
+	{
+		MCParseCacheDeleteParse(p_statements, p_expression);
+		return nil;
+	}
+
+	t_entry -> kind = p_kind;
+	t_entry -> source = MCValueRetain(p_source);
+	t_entry -> hash = MCStringHash(p_source, kMCStringOptionCompareExact);
+	t_entry -> object = ctxt . GetObject();
+	t_entry -> handler_list = ctxt . GetHandlerList();
+	t_entry -> handler = ctxt . GetHandler();
+	t_entry -> line = p_line;
+	t_entry -> options = MCParseCacheComputeOptions(p_kind);
+	t_entry -> statements = p_statements;
+	t_entry -> line_count = p_line_count;
+	t_entry -> expression = p_expression;
+	t_entry -> references = 1;
+	t_entry -> chain = nil;
+	t_entry -> newer = nil;
+	t_entry -> older = nil;
+
+	// A parse which changed a scope (by declaring a variable, say) must be
+	// repeated each time, so is not held.
+	if (!MCParseCacheIsEnabled() || p_generation != s_parse_cache_generation)
+		return t_entry;
+
+	MCParseCacheValidate();
+
+	if (s_parse_cache_buckets == nil && !MCParseCacheCreateBuckets())
+		return t_entry;
+
+	while (s_parse_cache_count >= s_parse_cache_size)
+	{
+		s_parse_cache_statistics . evictions += 1;
+		MCParseCacheRemove(s_parse_cache_oldest);
+	}
+
+	MCParseCacheEntry **t_bucket;
+	t_bucket = &s_parse_cache_buckets[t_entry -> hash & (s_parse_cache_bucket_count - 1)];
+	t_entry -> chain = *t_bucket;
+	*t_bucket = t_entry;
+
+	MCParseCacheLinkNewest(t_entry);
+	s_parse_cache_count += 1;
+
+	t_entry -> references += 1;
+	return t_entry;
+}
+
+void MCParseCacheRelease(MCParseCacheEntry *p_entry)
+{
+	if (p_entry == nil)
+		return;
+
+	p_entry -> references -= 1;
+	if (p_entry -> references != 0)
+		return;
+
+	MCParseCacheDeleteParse(p_entry -> statements, p_entry -> expression);
+	MCValueRelease(p_entry -> source);
+	delete p_entry;
+}
+
+void MCParseCacheSetSize(uindex_t p_size)
+{
+	// The table is sized for the cache, so is created afresh when next used.
+	MCParseCacheDeleteBuckets();
+	s_parse_cache_size = p_size;
+}
+
+uindex_t MCParseCacheGetSize(void)
+{
+	return s_parse_cache_size;
+}
+
+void MCParseCacheGetStatistics(MCParseCacheStatistics& r_statistics)
+{
+	r_statistics = s_parse_cache_statistics;
+	r_statistics . entries = s_parse_cache_count;
+}
+
+void MCParseCacheFinalize(void)
+{
+	MCParseCacheDeleteBuckets();
+}
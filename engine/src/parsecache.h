@@ -0,0 +1,104 @@
+/* Copyright (C) 2017 LiveCode Ltd.
+
+This file is part of LiveCode.
+
+LiveCode is free software; you can redistribute it and/or modify it under
+the terms of the GNU General Public License v3 as published by the Free
+Software Foundation.
+
+LiveCode is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or
+FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+for more details.
+
+You should have received a copy of the GNU General Public License
+along with LiveCode.  If not see <http://www.gnu.org/licenses/>.  */
+
+//
+// Cache of the parses of 'do' scripts and 'value' expressions
+//
+#ifndef	PARSECACHE_H
+#define	PARSECACHE_H
+
+// The number of parses the cache holds by default.
+#define PARSE_CACHE_DEFAULT_SIZE 512
+
+enum MCParseCacheKind
+{
+	// A list of statements, as parsed by 'do'.
+	kMCParseCacheKindStatements,
+	// A single expression, as parsed by 'value'.
+	kMCParseCacheKindExpression,
+};
+
+// A parse held by the cache. The same source text parsed in the same context
+// (the object, handler list and handler the parse resolves names in, and the
+// settings which change how it parses) gives the same tree, so the tree is
+// shared by all its uses. Entries are reference counted: an entry which is
+// evicted or invalidated while it is being executed is deleted when the
+// last use releases it.
+struct MCParseCacheEntry
+{
+	MCParseCacheKind kind;
+	MCStringRef source;
+	hash_t hash;
+	MCObject *object;
+	MCHandlerlist *handler_list;
+	MCHandler *handler;
+	uint32_t line;
+	uint32_t options;
+
+	MCStatement *statements;
+	uint4 line_count;
+	MCExpression *expression;
+
+	uindex_t references;
+	MCParseCacheEntry *chain;
+	MCParseCacheEntry *newer;
+	MCParseCacheEntry *older;
+};
+
+struct MCParseCacheStatistics
+{
+	uint64_t hits;
+	uint64_t misses;
+	uint64_t evictions;
+	uint64_t flushes;
+	uindex_t entries;
+};
+
+// Discard every parse held by the cache, once it is next used. This must be
+// called whenever the names a parse could have resolved may change meaning:
+// when a variable, constant or global is declared in a handler or handler
+// list, when a handler's temporary variables are removed, and when a handler
+// or handler list is deleted (so a new one at the same address is not
+// mistaken for it).
+void MCParseCacheInvalidate(void);
+
+// The generation is changed by each invalidation. A parse is only added to
+// the cache if the generation is the same as before it was parsed, so parses
+// which declare variables are always repeated.
+uint32_t MCParseCacheGetGeneration(void);
+
+// Look up the parse of the source in the context, returning it retained, or
+// nil if it is not held.
+MCParseCacheEntry *MCParseCacheFetch(MCExecContext& ctxt, MCParseCacheKind p_kind, MCStringRef p_source, uint32_t p_line);
+
+// Take ownership of a parse of the source in the context, which was begun at
+// the given generation, returning it retained. The parse is only held by the
+// cache if it is enabled and the generation is current. If memory runs out,
+// the parse is deleted and nil is returned.
+MCParseCacheEntry *MCParseCacheAdd(MCExecContext& ctxt, MCParseCacheKind p_kind, MCStringRef p_source, uint32_t p_line, uint32_t p_generation, MCStatement *p_statements, uint4 p_line_count, MCExpression *p_expression);
+
+void MCParseCacheRelease(MCParseCacheEntry *p_entry);
+
+// The cache holds at most the given number of parses, discarding the least
+// recently used; a size of zero disables it.
+void MCParseCacheSetSize(uindex_t p_size);
+uindex_t MCParseCacheGetSize(void);
+
+void MCParseCacheGetStatistics(MCParseCacheStatistics& r_statistics);
+
+void MCParseCacheFinalize(void);
+
+#endif
@@ -1141,6 +1141,13 @@ enum Properties {
   	// TD-2013-06-20: [[ DynamicFonts ]] global property for list of font files
     P_FONTFILES_IN_USE,
 	
+    P_NAME_TABLE_STATISTICS,
+    P_VALUE_STATISTICS,
+    P_PARSE_CACHE_SIZE,
+    P_PARSE_CACHE_STATISTICS,
+    P_CACHE_UNHANDLED_MESSAGES,
+    P_MESSAGE_CACHE_STATISTICS,
+	
     // window properties
     P_NAME,
     P_SHORT_NAME,
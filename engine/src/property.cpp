@@ -322,6 +322,12 @@ static MCPropertyInfo kMCPropertyInfoTable[] =
 	DEFINE_RO_PROPERTY(P_STACKS_IN_USE, String, Engine, StacksInUse)
     // TD-2013-06-20: [[ DynamicFonts ]] global property for list of font files
     DEFINE_RO_PROPERTY(P_FONTFILES_IN_USE, LinesOfString, Text, FontfilesInUse)
+	DEFINE_RO_PROPERTY(P_NAME_TABLE_STATISTICS, Array, Engine, NameTableStatistics)
+	DEFINE_RO_PROPERTY(P_VALUE_STATISTICS, Array, Engine, ValueStatistics)
+	DEFINE_RW_PROPERTY(P_PARSE_CACHE_SIZE, UInt32, Engine, ParseCacheSize)
+	DEFINE_RO_PROPERTY(P_PARSE_CACHE_STATISTICS, Array, Engine, ParseCacheStatistics)
+	DEFINE_RW_PROPERTY(P_CACHE_UNHANDLED_MESSAGES, Bool, Engine, CacheUnhandledMessages)
+	DEFINE_RO_PROPERTY(P_MESSAGE_CACHE_STATISTICS, Array, Engine, MessageCacheStatistics)
 
 	DEFINE_RW_PROPERTY(P_SHELL_COMMAND, String, Files, ShellCommand)
 	DEFINE_RW_PROPERTY(P_DIRECTORY, String, Files, CurrentFolder)
@@ -845,6 +851,12 @@ Parse_stat MCProperty::parse(MCScriptPoint &sp, Boolean the)
 	case P_STACKS_IN_USE:
     // TD-2013-06-20: [[ DynamicFonts ]] global property for list of font files
     case P_FONTFILES_IN_USE:
+	case P_NAME_TABLE_STATISTICS:
+	case P_VALUE_STATISTICS:
+	case P_PARSE_CACHE_SIZE:
+	case P_PARSE_CACHE_STATISTICS:
+	case P_CACHE_UNHANDLED_MESSAGES:
+	case P_MESSAGE_CACHE_STATISTICS:
 	case P_RELAYER_GROUPED_CONTROLS:
 	case P_SELECTION_MODE:
 	case P_SELECTION_HANDLE_COLOR:
@@ -645,6 +645,11 @@ void X_main_loop(void)
 
 int platform_main(int argc, char *argv[], char *envp[])
 {
+	// Accounting must be enabled before initialization, so is requested
+	// through the environment rather than on the command line.
+	if (getenv("LIVECODE_VALUE_STATISTICS") != nil)
+		MCValueEnableAccounting();
+
 	if (!MCInitialize() ||
         !MCSInitialize() ||
 	    !MCScriptInitialize())
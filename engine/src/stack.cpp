@@ -545,6 +545,9 @@ MCStack::MCStack(const MCStack &sref)
 
 MCStack::~MCStack()
 {
+	// Messages to the objects of the stack and its substacks pass through it.
+	MCMessageCacheInvalidate();
+
 	flags &= ~F_DESTROY_STACK;
 	state |= CS_DELETE_STACK;
 	while (opened)
@@ -1579,7 +1582,7 @@ void MCStack::paste(void)
 
 	// MW-2007-12-11: [[ Bug 5441 ]] When we paste a stack, it should be parented to the home
 	//   stack, just like when we create a whole new stack.
-	parent = MCdispatcher -> gethome();
+	setparent(MCdispatcher -> gethome());
 	MCdispatcher -> appendstack(this);
 
 	positionrel(MCdefaultstackptr->rect, OP_CENTER, OP_MIDDLE);
@@ -623,6 +623,9 @@ void MCStack::destroywindow()
 	if (window == nil)
 		return;
 	
+	// The next message passed through the stack creates its window again.
+	MCMessageCacheInvalidate();
+
 	OnDetach();
 	
 	MCscreen->destroywindow(window);
@@ -1448,6 +1448,20 @@ bool MCS_loadbinaryfile(MCStringRef p_filename, MCDataRef& r_data)
 	if (!(MCS_resolvepath(p_filename, &t_resolved_path) && MCS_pathtonative(*t_resolved_path, &t_native_path)))
         return false;
 	
+    // Large files are mapped rather than read, so that binary parsing can
+    // work on byte ranges of the file without it all being loaded. Files the
+    // system layer can't open directly (e.g. those within an app bundle) are
+    // read as before.
+    if (MCmmap)
+    {
+        if (MCSFileGetContentsMapped(*t_resolved_path, r_data))
+        {
+            MCresult -> clear();
+            return true;
+        }
+        MCErrorReset();
+    }
+    
 	IO_handle t_file;
     t_file = MCsystem -> OpenFile(*t_native_path, (intenum_t)kMCOpenFileModeRead, false);
 	
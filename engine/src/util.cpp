@@ -627,7 +627,7 @@ uint4 MCU_r8tos(char *&d, uint4 &s, real8 n,
     
     if (MCS_isfinite(n))
     {
-        sprintf(d, "%0*.*f", fw, trailing, n);
+        MCTypeConvertRealToFixedCString(n, fw, trailing, d, s);
         MCU_strip(d, trailing, force);
     }
     else
@@ -689,7 +689,7 @@ Boolean MCU_stor8(const MCString &s, real8 &d, Boolean convertoctals)
 	memcpy(buff, sptr, l);
 	buff[l] = '\0';
 	const char *newptr;
-	d = strtod((char *)buff, (char **)&newptr);
+	d = MCTypeConvertCStringToReal(buff, newptr);
 	if (newptr == buff)
 		return False;
 	l = buff + l - newptr;
@@ -728,7 +728,7 @@ real8 MCU_strtor8(const char *&r_str, uint4 &r_len, int1 p_delim, Boolean &r_don
 	memcpy(buff, r_str, buff_len);
 	buff[buff_len] = '\0';
 	const char *newptr;
-	d = strtod((char *)buff, (char **)&newptr);
+	d = MCTypeConvertCStringToReal(buff, newptr);
 	if (newptr == buff)
 	{
 		r_done = False;
@@ -97,7 +97,7 @@ public:
     
     bool CopyString(MCStringRef& r_string) const
     {
-        return MCStringCopySubstring(m_text, m_range, r_string);
+        return MCStringCopySubstringShared(m_text, m_range, r_string);
     }
     
     void SetOptions(MCStringOptions p_options)
@@ -233,6 +233,7 @@ public:
         MCValueAssign(m_delimiter, p_delimiter);
     }
     
+    virtual uindex_t CountChunks();
     virtual bool Next();
     virtual bool IsAmong(MCStringRef p_needle);
     virtual uindex_t ChunkOffset(MCStringRef p_needle, uindex_t p_start_offset, uindex_t *p_end_offset, bool p_whole_matches);
@@ -397,6 +397,14 @@ uindex_t MCLocaleBreakIteratorAfter(MCBreakIteratorRef, uindex_t);
 // Custom advance method for word break iterator.
 bool MCLocaleWordBreakIteratorAdvance(MCStringRef self, MCBreakIteratorRef p_iter, MCRange& x_range);
 
+// Large immutable strings whose graphemes (character), true words (word) or
+// sentences are repeatedly looked up cache the code unit ranges of all of them.
+// If the string has such ranges for the type and locale (which is ignored for
+// graphemes), they are returned - valid until the next call which may change
+// the cache - and the result is true. Otherwise the caller must find the
+// chunks itself.
+bool MCStringFetchBreakRanges(MCStringRef self, MCBreakIteratorType p_type, MCLocaleRef p_locale, const MCRange*& r_ranges, uindex_t& r_count);
+
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 
@@ -507,6 +507,14 @@ bool MCUnicodeCreateSortKeyWithCollator(MCUnicodeCollatorRef collator,
                                         const unichar_t* p_in, uindex_t p_in_length,
                                         byte_t* &r_out, uindex_t &r_out_length);
 
+// Write the sort key for a string into a caller-supplied buffer, returning the
+// length of the complete key. If this exceeds the capacity of the buffer, the
+// contents of the buffer are incomplete and the call should be repeated with a
+// buffer of at least the returned length.
+uindex_t MCUnicodeGetSortKeyWithCollator(MCUnicodeCollatorRef collator,
+                                         const unichar_t* p_in, uindex_t p_in_length,
+                                         byte_t* p_out, uindex_t p_out_capacity);
+
 ////////////////////////////////////////////////////////////////////////////////
 
 // SN-2014-04-16
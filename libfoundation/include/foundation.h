@@ -1194,6 +1194,26 @@ MC_DLLEXPORT bool MCMemoryNew(size_t size, void*& r_record);
 // This method deletes a fixed size record that was allocated with MCMemoryNew.
 MC_DLLEXPORT void MCMemoryDelete(void *p_record);
 
+// Statistics describing the blocks allocated by the MCMemory functions, which
+// are only gathered once MCValueEnableAccounting has been called. Byte counts
+// are those reserved by the system allocator, and are zero on platforms where
+// it can't report them.
+struct MCMemoryStatistics
+{
+    // The number of allocations and deallocations made, counting a
+    // reallocation as one of each.
+    uint64_t allocations;
+    uint64_t deallocations;
+    // The total number of bytes allocated.
+    uint64_t allocated_bytes;
+    // The number of bytes currently allocated, and the most that have been.
+    uint64_t live_bytes;
+    uint64_t peak_bytes;
+};
+
+// Returns statistics describing the blocks allocated by the MCMemory functions.
+MC_DLLEXPORT void MCMemoryGetStatistics(MCMemoryStatistics& r_statistics);
+
 //////////
 
 // SN-2014-06-19 [[ Bug 12651 ]] back key can not work, and it crush
@@ -1532,6 +1552,48 @@ MC_DLLEXPORT bool MCValueInter(MCValueRef value, MCValueRef& r_unique_value);
 //
 MC_DLLEXPORT bool MCValueInterAndRelease(MCValueRef value, MCValueRef& r_unique_value);
 
+// Enables the use of values by more than one thread, and must be called before
+// MCInitialize. Once enabled, names, interred values and the constant values
+// created by MCInitialize are shared, and may be used by any thread. Any other
+// value must be shared (see MCValueShare) before it is passed to another
+// thread.
+MC_DLLEXPORT void MCValueEnableThreading(void);
+
+// Marks the given (immutable) value as shared between threads, along with any
+// strings, data, array elements or proper list elements it contains. The
+// reference count of a shared value is updated atomically.
+MC_DLLEXPORT void MCValueShare(MCValueRef value);
+
+// Enables the accounting of the values of each type, and of the blocks
+// allocated by the MCMemory functions. It must be called before MCInitialize.
+// Accounting adds a few counter updates to each allocation, which are atomic
+// if threading is enabled, so is off by default.
+MC_DLLEXPORT void MCValueEnableAccounting(void);
+
+// Statistics describing the values of one type, gathered while accounting is
+// enabled.
+struct MCValueTypeStatistics
+{
+    // The number of values created and destroyed. The difference between
+    // readings taken at different times gives the rate of allocation.
+    uint64_t created;
+    uint64_t destroyed;
+    // The number of values which currently exist, and the most which have
+    // existed at once.
+    uint64_t live;
+    uint64_t peak_live;
+    // The number of bytes used by the records of the values which currently
+    // exist, and the most used at once. This does not include anything the
+    // records reference, such as the chars of a string, which is counted in
+    // the memory statistics instead.
+    uint64_t live_bytes;
+    uint64_t peak_bytes;
+};
+
+// Returns statistics describing the values of the given type. Returns false
+// if accounting is not enabled.
+MC_DLLEXPORT bool MCValueGetTypeStatistics(MCValueTypeCode type_code, MCValueTypeStatistics& r_statistics);
+
 // Fetch the 'extra bytes' field for the given custom value.
 inline void *MCValueGetExtraBytesPtr(MCValueRef value) { return ((uint8_t *)value) + kMCValueCustomHeaderSize; }
 
@@ -2267,9 +2329,17 @@ MC_DLLEXPORT bool MCStringMutableCopyAndRelease(MCStringRef string, MCStringRef&
 
 /////////
 
-// Copy a substring of the given string as immutable.
+// Copy a substring of the given string as immutable. The substring may share
+// the chars of an immutable string, unless doing so would keep a lot more of
+// them alive than the substring contains.
 MC_DLLEXPORT bool MCStringCopySubstring(MCStringRef string, MCRange range, MCStringRef& r_substring);
 
+// Copy a substring of the given string as immutable, sharing the chars of an
+// immutable string however small the substring. This is intended for
+// substrings which don't outlive the string, such as the chunks produced when
+// iterating over it.
+MC_DLLEXPORT bool MCStringCopySubstringShared(MCStringRef string, MCRange range, MCStringRef& r_substring);
+
 // Copy a substring of the given string as immutable, releasing the original.
 MC_DLLEXPORT bool MCStringCopySubstringAndRelease(MCStringRef string, MCRange range, MCStringRef& r_substring);
 
@@ -2553,6 +2623,26 @@ MC_DLLEXPORT bool MCStringFind(MCStringRef string, MCRange range, MCStringRef ne
 // and returning the number of occurrences found.
 MC_DLLEXPORT uindex_t MCStringCount(MCStringRef string, MCRange range, MCStringRef needle, MCStringOptions options);
 MC_DLLEXPORT uindex_t MCStringCountChar(MCStringRef string, MCRange range, codepoint_t needle, MCStringOptions options);
+
+// Search 'range' of 'string' for the (n + 1)th non-overlapping occurrence of
+// 'needle' processing as appropriate to options. If found, the result is true
+// and its range is returned in 'result'. Otherwise the result is false, the
+// number of occurrences there were is returned in 'found_count' and the range
+// of the last one (if any) in 'result'.
+MC_DLLEXPORT bool MCStringFindNth(MCStringRef string, MCRange range, MCStringRef needle, MCStringOptions options, uindex_t n, uindex_t& r_found_count, MCRange* r_result);
+
+// Large immutable strings which are repeatedly searched for the same single
+// char delimiter cache the offsets of each occurrence so that MCStringFindNth
+// and MCStringCount do not have to rescan them (unless MCValueEnableThreading
+// has been called). This discards all such indices and should be called when
+// memory is low.
+MC_DLLEXPORT void MCStringFlushDelimiterIndexCache(void);
+
+// Similarly, large immutable strings which are repeatedly asked for the Nth
+// char, trueWord or sentence cache the ranges of all of them (unless
+// MCValueEnableThreading has been called). This discards all such ranges and
+// should be called when memory is low.
+MC_DLLEXPORT void MCStringFlushBreakIndexCache(void);
     
 //////////
 
@@ -2682,6 +2772,25 @@ MC_DLLEXPORT bool MCStringResolvesLeftToRight(MCStringRef p_string);
 MC_DLLEXPORT bool MCStringFindAndReplace(MCStringRef string, MCStringRef pattern, MCStringRef replacement, MCStringOptions options);
 MC_DLLEXPORT bool MCStringFindAndReplaceChar(MCStringRef string, codepoint_t pattern, codepoint_t replacement, MCStringOptions options);
 
+// A set of patterns and their replacements, compiled so that all of the
+// patterns can be found and replaced in a single pass through a string. Where
+// several patterns match, the one which starts first is replaced, or the
+// longest of those which start at the same place. Replacements are not
+// searched again, so the result may differ from replacing each pattern in
+// turn. Empty patterns are ignored, and if a pattern is given more than once
+// the first replacement is used.
+typedef struct __MCStringReplacer *MCStringReplacerRef;
+
+MC_DLLEXPORT bool MCStringReplacerCreate(const MCStringRef *patterns, const MCStringRef *replacements, uindex_t count, MCStringOptions options, MCStringReplacerRef& r_replacer);
+MC_DLLEXPORT void MCStringReplacerDestroy(MCStringReplacerRef replacer);
+
+// Replaces all instances of the replacer's patterns in the (mutable) string.
+MC_DLLEXPORT bool MCStringReplacerApply(MCStringReplacerRef replacer, MCStringRef string);
+
+// Replaces all instances of the patterns in the (mutable) string, as a
+// replacer created for them would.
+MC_DLLEXPORT bool MCStringFindAndReplaceMultiple(MCStringRef string, const MCStringRef *patterns, const MCStringRef *replacements, uindex_t count, MCStringOptions options);
+
 MC_DLLEXPORT bool MCStringWildcardMatch(MCStringRef source, MCRange source_range, MCStringRef pattern, MCStringOptions p_options);
 
 /////////
@@ -2809,6 +2918,25 @@ MC_DLLEXPORT bool MCNameIsEqualTo(MCNameRef left, MCNameRef right, MCStringOptio
 // Returns true if the names are equal caselessly.
 MC_DLLEXPORT bool MCNameIsEqualToCaseless(MCNameRef left, MCNameRef right);
 
+// Statistics describing the table of names.
+struct MCNameTableStatistics
+{
+    // The number of names.
+    uindex_t name_count;
+    // The number of caseless equivalence classes of names.
+    uindex_t class_count;
+    // The number of chains in the table, and how many are not empty.
+    uindex_t chain_count;
+    uindex_t used_chain_count;
+    // The number of names in the longest chain.
+    uindex_t longest_chain_length;
+    // The memory used by the table and its names (but not their strings).
+    size_t memory_size;
+};
+
+// Returns statistics describing the table of names.
+MC_DLLEXPORT void MCNameGetTableStatistics(MCNameTableStatistics& r_statistics);
+
 // The empty name object;
 MC_DLLEXPORT extern MCNameRef kMCEmptyName;
 
@@ -2826,6 +2954,13 @@ MC_DLLEXPORT extern MCDataRef kMCEmptyData;
 MC_DLLEXPORT bool MCDataCreateWithBytes(const byte_t *p_bytes, uindex_t p_byte_count, MCDataRef& r_data);
 MC_DLLEXPORT bool MCDataCreateWithBytesAndRelease(byte_t *p_bytes, uindex_t p_byte_count, MCDataRef& r_data);
 
+// Creates immutable data which uses bytes owned elsewhere, such as a memory
+// mapping of a file, without copying them. The bytes must not change while
+// the data exists, and p_release is called with them when it is destroyed.
+// Any mutation of the data copies the bytes first.
+typedef void (*MCDataReleaseBytesCallback)(byte_t *p_bytes, uindex_t p_byte_count);
+MC_DLLEXPORT bool MCDataCreateWithExternalBytes(byte_t *p_bytes, uindex_t p_byte_count, MCDataReleaseBytesCallback p_release, MCDataRef& r_data);
+
 // Creates data from existing data. The first variant exists to provide an
 // optimised implementation in the (very common) case of only two DataRefs.
 MC_DLLEXPORT bool MCDataCreateWithData(MCDataRef& r_string, MCDataRef p_one, MCDataRef p_two);
@@ -2926,6 +3061,11 @@ MC_DLLEXPORT bool MCArrayIsMutable(MCArrayRef array);
 // Returns the number of elements in the array.
 MC_DLLEXPORT uindex_t MCArrayGetCount(MCArrayRef array);
 
+// Returns 'true' if the array is stored densely - i.e. its keys are known to
+// be exactly 1 to MCArrayGetCount() without needing to examine them. Empty
+// arrays are never dense.
+MC_DLLEXPORT bool MCArrayIsDense(MCArrayRef array);
+
 // Fetch the value from the array with the given key. The returned value is
 // not retained. If being stored elsewhere ValueCopy should be used to make an
 // immutable copy first. If 'false' is returned it means the key was not found
@@ -3270,6 +3410,10 @@ struct MCStreamCallbacks
 	// Set the stream position - position must be within the extent of the stream,
 	// attempts to seek past the end of the stream is an error.
 	bool (*seek)(MCStreamRef stream, filepos_t position);
+	// Advance past the given number of bytes, returning a pointer to them in
+	// the stream's own storage rather than copying them out - this is only
+	// implemented by streams whose contents are held in memory.
+	bool (*read_bytes)(MCStreamRef stream, size_t amount, const void*& r_bytes);
 };
 
 enum
@@ -3293,6 +3437,10 @@ MC_DLLEXPORT inline void *MCStreamGetExtraBytesPtr(MCStreamRef stream) { return
 // Create a read-only stream targetting a memory block. The lifetime of the
 // memory block must exceed that of the stream.
 MC_DLLEXPORT bool MCMemoryInputStreamCreate(const void *block, size_t size, MCStreamRef& r_stream);
+// Create a read-only stream targetting the bytes of a data value. The data is
+// retained by the stream, so (unlike the above) there are no lifetime
+// constraints.
+MC_DLLEXPORT bool MCMemoryInputStreamCreateWithData(MCDataRef data, MCStreamRef& r_stream);
 
 // Memory-based output stream
 
@@ -3302,6 +3450,18 @@ MC_DLLEXPORT bool MCMemoryOutputStreamCreate(MCStreamRef& r_stream);
 // to work, but will be reset to empty and a new buffer accumulated.
 MC_DLLEXPORT bool MCMemoryOutputStreamFinish(MCStreamRef stream, void*& r_buffer, size_t& r_size);
 
+// Buffered stream
+
+// Create a stream which reads and writes 'source' in blocks of (up to)
+// 'buffer_size' bytes, so that many small reads or writes turn into a few
+// large ones. Reads fill the buffer with as much as the source says is
+// available, or just what is asked for if it can't say. The source is
+// retained by the stream.
+MC_DLLEXPORT bool MCBufferedStreamCreate(MCStreamRef source, size_t buffer_size, MCStreamRef& r_stream);
+// Write any pending output of a buffered stream to its source. This also
+// happens when the stream is destroyed, but any error is then lost.
+MC_DLLEXPORT bool MCBufferedStreamFlush(MCStreamRef stream);
+
 // Capabilities
 
 // If a stream is readable it means that the 'Read' method work.
@@ -3314,6 +3474,9 @@ MC_DLLEXPORT bool MCStreamIsMarkable(MCStreamRef stream);
 // If a stream is seekable it means that the stream supports the 'Tell' and
 // 'Seek' methods.
 MC_DLLEXPORT bool MCStreamIsSeekable(MCStreamRef stream);
+// If a stream is mapped it means that its contents are held in memory, and
+// the stream supports the 'ReadBytes' method.
+MC_DLLEXPORT bool MCStreamIsMapped(MCStreamRef stream);
 
 // Readable streams
 
@@ -3355,6 +3518,13 @@ MC_DLLEXPORT bool MCStreamTell(MCStreamRef stream, filepos_t& r_position);
 // Set the current stream position.
 MC_DLLEXPORT bool MCStreamSeek(MCStreamRef stream, filepos_t position);
 
+// Mapped streams only
+
+// Attempt to read 'amount' bytes without copying them, returning a pointer to
+// them within the stream's storage. The bytes remain valid for as long as the
+// stream does.
+MC_DLLEXPORT bool MCStreamReadBytes(MCStreamRef stream, size_t amount, const void*& r_bytes);
+
 // Simple byte-based serialization / unserialization functions. These are all
 // wrappers around read/write, and assume no higher-level structure.
 
@@ -3742,6 +3912,18 @@ MC_DLLEXPORT bool MCTypeConvertStringToReal(MCStringRef p_string, real64_t& r_co
 MC_DLLEXPORT bool MCTypeConvertStringToBool(MCStringRef p_string, bool& r_converted);
 MC_DLLEXPORT bool MCTypeConvertDataToReal(MCDataRef p_data, real64_t& r_converted, bool p_convert_octals = false);
 
+// Format a real in the same way as snprintf with a '%0*.*f' format, writing
+// at most p_buffer_size chars (including the terminating NUL) to r_buffer and
+// returning the length the formatted real would have. The common cases are
+// formatted exactly using integer arithmetic rather than the C library.
+MC_DLLEXPORT size_t MCTypeConvertRealToFixedCString(real64_t p_real, uindex_t p_width, uindex_t p_precision, char *r_buffer, size_t p_buffer_size);
+
+// Parse a real from a NUL-terminated C string in the same way as strtod,
+// returning the position of the first char not consumed in r_end. Decimals
+// of at most 19 significant digits and a small exponent are converted
+// directly rather than with the C library.
+MC_DLLEXPORT real64_t MCTypeConvertCStringToReal(const char *p_cstring, const char*& r_end);
+
 }
     
 #endif
@@ -64,6 +64,13 @@ bool __MCSFilePathFromNative (MCStringRef p_native_path, MCStringRef & r_path);
 /* Read an entire file into allocated memory, with good error checking. */
 MC_DLLEXPORT bool MCSFileGetContents(MCStringRef p_filename, MCDataRef & r_data);
 
+/* Read an entire file in the same way as MCSFileGetContents(), except
+ * that a large regular file is memory-mapped rather than read.  The
+ * returned data then shares the file's pages, so ranges of it can be
+ * used without the whole file being loaded.  The file must not be
+ * truncated or modified while the data exists. */
+MC_DLLEXPORT bool MCSFileGetContentsMapped(MCStringRef p_filename, MCDataRef & r_data);
+
 /* Write all of p_data to a file called p_filename, with good error
  * checking.  If a file called p_filename already exists it will be
  * overwritten.
@@ -91,6 +98,7 @@ MC_DLLEXPORT bool MCSFileSetContents(MCStringRef p_filename, MCDataRef p_data);
 #ifdef __MCS_INTERNAL_API__
 
 bool __MCSFileGetContents (MCStringRef p_native_path, MCDataRef & r_data);
+bool __MCSFileGetContentsMapped (MCStringRef p_native_path, MCDataRef & r_data);
 bool __MCSFileSetContents (MCStringRef p_native_path, MCDataRef p_data);
 
 #endif
@@ -111,6 +119,11 @@ enum MCSFileOpenMode
 
 MC_DLLEXPORT bool MCSFileCreateStream(MCStringRef p_filename, intenum_t p_mode, MCStreamRef& r_stream);
 
+/* Create a read-only stream over the contents of a file, as obtained
+ * by MCSFileGetContentsMapped().  The stream is mapped, so its bytes
+ * can be fetched with MCStreamReadBytes() rather than copied out. */
+MC_DLLEXPORT bool MCSFileCreateMappedStream(MCStringRef p_filename, MCStreamRef& r_stream);
+
 #ifdef __MCS_INTERNAL_API__
 
 bool __MCSFileCreateStream (MCStringRef p_native_path, intenum_t p_mode, MCStreamRef & r_stream);
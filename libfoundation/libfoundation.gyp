@@ -14,13 +14,18 @@
 		'module_test_sources':
 		[
 			'test/environment.cpp',
+            'test/test_array.cpp',
+            'test/test_data.cpp',
             'test/test_foreign.cpp',
 			'test/test_hash.cpp',
             'test/test_memory.cpp',
             'test/test_name.cpp',
+            'test/test_number.cpp',
 			'test/test_proper-list.cpp',
+			'test/test_stream.cpp',
 			'test/test_string.cpp',
 			'test/test_typeconvert.cpp',
+			'test/test_value.cpp',
             'test/test_system-library.cpp',
 		],
 	},
@@ -113,6 +118,7 @@
 				'src/foundation-stream.cpp',
 				'src/foundation-string.cpp',
                 'src/foundation-string-native.cpp.h',
+                'src/foundation-string-native-simd.cpp.h',
 				'src/foundation-text.cpp',
 				'src/foundation-typeconvert.cpp',
 				'src/foundation-typeinfo.cpp',
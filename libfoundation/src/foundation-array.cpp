@@ -20,6 +20,13 @@ along with LiveCode.  If not see <http://www.gnu.org/licenses/>.  */
 
 #include "foundation-private.h"
 
+#if defined(__X86_64__) || defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
 ////////////////////////////////////////////////////////////////////////////////
 
 // Creates an indirect mutable array with contents.
@@ -43,18 +50,82 @@ static bool __MCArrayResolveIndirect(__MCArray *self);
 // Rehash the table adjusting capacity by delta.
 static bool __MCArrayRehash(__MCArray *self, index_t by);
 
+// Makes room for the key (which is not in the array) given the unused slot
+// found for it, rehashing if the table is too full and finding the key's slot
+// in the new table.
+static bool __MCArrayEnsureRoomForKey(__MCArray *self, bool case_sensitive, MCNameRef key, uindex_t& x_slot);
+
 // Returns the number of entries in the key-value table for the array.
 static uindex_t __MCArrayGetTableSize(__MCArray *self);
 
 // Returns the maximum number of entries for a given array size that minimises rehashing.
 static uindex_t __MCArrayGetTableCapacity(__MCArray *self);
 
+// Returns the number of entries in the key-value table with the given size index.
+static uindex_t __MCArrayGetTableSizeForIndex(uindex_t index);
+
+// Returns the maximum number of entries in the key-value table with the given
+// size index.
+static uindex_t __MCArrayGetTableCapacityForIndex(uindex_t index);
+
+// Allocates an empty key-value table, followed by its control bytes.
+static bool __MCArrayNewTable(uindex_t size, __MCArrayKeyValue*& r_key_values);
+
+// Returns the control bytes of the array's key-value table.
+static uint8_t *__MCArrayGetControlBytes(__MCArray *self);
+
+// Returns the hash of the key used to probe the key-value table. This is the
+// same regardless of case, so it can be used for either kind of lookup.
+static hash_t __MCArrayHashKey(MCNameRef key);
+
+// Puts the key into the (unused) slot, updating its control byte.
+static void __MCArraySetSlotKey(__MCArray *self, uindex_t slot, MCNameRef key);
+
+// Marks the (used) slot as unused, updating its control byte.
+static void __MCArrayClearSlot(__MCArray *self, uindex_t slot);
+
 // Looks for a key-value slot in the array with the given key. If the key was
 // found 'true' is returned; otherwise 'false'. On return 'slot' will be the
 // slot in which the key is found, could be placed, or UINDEX_MAX if there is
 // no more room (and the key isn't there).
 static bool __MCArrayFindKeyValueSlot(__MCArray *self, bool case_sensitive, MCNameRef key, uindex_t& r_slot);
 
+// Returns true if the array is dense (its keys are exactly 1..n).
+static bool __MCArrayIsDense(__MCArray *self);
+
+// Returns true if the key is the canonical form of an index which can be
+// stored in a dense array (i.e. it is in the range 1..INDEX_MAX).
+static bool __MCArrayKeyIsDenseIndex(MCNameRef key, index_t& r_index);
+
+// Returns true if the given index can be stored in the (direct) array without
+// changing it from dense to hashed.
+static bool __MCArrayCanStoreDenseIndex(__MCArray *self, index_t index);
+
+// Changes the (direct, empty) array to dense form.
+static void __MCArrayMakeDense(__MCArray *self);
+
+// Changes the (direct) dense array to hashed form.
+static bool __MCArrayMakeHashed(__MCArray *self);
+
+// Ensures there is room for at least 'count' values in the dense array.
+static bool __MCArrayEnsureDenseCapacity(__MCArray *self, uindex_t count);
+
+// Ensures the names of all the keys in the dense array have been created.
+static bool __MCArrayEnsureDenseKeys(__MCArray *self);
+
+// Returns the names of the keys of the dense array which have been created.
+static MCNameRef *__MCArrayGetDenseKeys(__MCArray *self);
+
+// Releases the names of the keys of the dense array which have been created.
+static void __MCArrayReleaseDenseKeys(__MCArray *self);
+
+// Looks up the value for the given key in the (direct) array.
+static bool __MCArrayFetchValueInContents(__MCArray *self, bool case_sensitive, MCNameRef key, MCValueRef& r_value);
+
+// Stores a value on a path whose first element is an index which does not
+// require the dense array to become hashed.
+static bool __MCArrayStoreDenseValueOnPath(__MCArray *self, bool case_sensitive, index_t index, const MCNameRef *path, uindex_t path_length, MCValueRef value);
+
 ////////////////////////////////////////////////////////////////////////////////
 
 MC_DLLEXPORT_DEF
@@ -176,11 +247,11 @@ bool MCArrayCopyAndRelease(MCArrayRef self, MCArrayRef& r_new_array)
 	if (!__MCArrayMakeIndirect(self))
 		return false;
 
-	// Reduce our reference count.
-	self -> references -= 1;
-
 	// Return a copy of the contents.
 	r_new_array = MCValueRetain(self -> contents);
+
+	// Reduce our reference count.
+	MCValueRelease(self);
 	return true;
 }
 
@@ -230,7 +301,7 @@ bool MCArrayMutableCopyAndRelease(MCArrayRef self, MCArrayRef& r_new_array)
 	if (!MCArrayMutableCopy(self, r_new_array))
 		return false;
 
-	self -> references -= 1;
+	MCValueRelease(self);
 	return true;
 }
 
@@ -247,6 +318,20 @@ bool MCArrayApply(MCArrayRef self, MCArrayApplyCallback p_callback, void *p_cont
 	else
 		t_contents = self -> contents;
 
+	if (__MCArrayIsDense(t_contents))
+	{
+		if (!__MCArrayEnsureDenseKeys(t_contents))
+			return false;
+
+		MCNameRef *t_keys;
+		t_keys = __MCArrayGetDenseKeys(t_contents);
+		for(uindex_t i = 0; i < t_contents -> key_value_count; i++)
+			if (!p_callback(p_context, self, t_keys[i], t_contents -> dense_values[i]))
+				return false;
+
+		return true;
+	}
+
 	uindex_t t_used;
 	t_used = t_contents -> key_value_count;
 
@@ -278,6 +363,18 @@ bool MCArrayIterate(MCArrayRef self, uintptr_t& x_iterator, MCNameRef& r_key, MC
 	else
 		t_contents = self -> contents;
 
+	if (__MCArrayIsDense(t_contents))
+	{
+		if (x_iterator >= t_contents -> key_value_count ||
+			!__MCArrayEnsureDenseKeys(t_contents))
+			return false;
+
+		r_key = __MCArrayGetDenseKeys(t_contents)[x_iterator];
+		r_value = t_contents -> dense_values[x_iterator];
+		x_iterator += 1;
+		return true;
+	}
+
 	uindex_t t_count;
 	t_count = __MCArrayGetTableSize(t_contents);
 	if (x_iterator == t_count)
@@ -317,6 +414,16 @@ uindex_t MCArrayGetCount(MCArrayRef self)
 	return self -> contents -> key_value_count;
 }
 
+MC_DLLEXPORT_DEF
+bool MCArrayIsDense(MCArrayRef self)
+{
+	__MCAssertIsArray(self);
+
+	if (!__MCArrayIsIndirect(self))
+		return __MCArrayIsDense(self);
+	return __MCArrayIsDense(self -> contents);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 
 MC_DLLEXPORT_DEF
@@ -340,14 +447,10 @@ bool MCArrayFetchValueOnPath(MCArrayRef self, bool p_case_sensitive, const MCNam
 	else
 		t_contents = self -> contents;
 
-	// Lookup the slot for the first part of the path.
-	uindex_t t_slot;
-	if (!__MCArrayFindKeyValueSlot(t_contents, p_case_sensitive, p_path[0], t_slot))
-		return false;
-
-	// We found a slot successfully matching the key so get the value.
+	// Lookup the value for the first part of the path.
 	MCValueRef t_value;
-	t_value = (MCValueRef)t_contents -> key_values[t_slot] . value;
+	if (!__MCArrayFetchValueInContents(t_contents, p_case_sensitive, p_path[0], t_value))
+		return false;
 
 	// If the path length is one, then we are done.
 	if (p_path_length == 1)
@@ -396,6 +499,19 @@ bool MCArrayStoreValueOnPath(MCArrayRef self, bool p_case_sensitive, const MCNam
 		if (!__MCArrayResolveIndirect(self))
 			return false;
 
+	// A dense array stays dense as long as the key replaces or appends to
+	// the sequence of values; otherwise it has to become hashed.
+	if (__MCArrayIsDense(self) || self -> key_value_count == 0)
+	{
+		index_t t_index;
+		if (__MCArrayKeyIsDenseIndex(p_path[0], t_index) &&
+			__MCArrayCanStoreDenseIndex(self, t_index))
+			return __MCArrayStoreDenseValueOnPath(self, p_case_sensitive, t_index, p_path, p_path_length, p_new_value);
+
+		if (__MCArrayIsDense(self) && !__MCArrayMakeHashed(self))
+			return false;
+	}
+
 	// Lookup the slot for the first element in the path.
 	bool t_found;
 	uindex_t t_slot;
@@ -434,18 +550,12 @@ bool MCArrayStoreValueOnPath(MCArrayRef self, bool p_case_sensitive, const MCNam
 	}
 	else
 	{
-        // AL-2014-07-15: [[ Bug 12532 ]] Rehash according to hash table capacities rather than sizes
-		if (t_slot == UINDEX_MAX || self -> key_value_count >= __MCArrayGetTableCapacity(self))
-		{
-			if (!__MCArrayRehash(self, 1))
-				return false;
-
-			__MCArrayFindKeyValueSlot(self, p_case_sensitive, p_path[0], t_slot);
-		}
+		if (!__MCArrayEnsureRoomForKey(self, p_case_sensitive, p_path[0], t_slot))
+			return false;
 
 		if (p_path_length == 1)
 		{
-			self -> key_values[t_slot] . key = MCValueRetain(p_path[0]);
+			__MCArraySetSlotKey(self, t_slot, MCValueRetain(p_path[0]));
 			self -> key_values[t_slot] . value = (uintptr_t)MCValueRetain(p_new_value);
 			self -> key_value_count += 1;
 			return true;
@@ -469,7 +579,7 @@ bool MCArrayStoreValueOnPath(MCArrayRef self, bool p_case_sensitive, const MCNam
 		MCValueRelease((MCValueRef)self -> key_values[t_slot] . value);
 	else
 	{
-		self -> key_values[t_slot] . key = MCValueRetain(p_path[0]);
+		__MCArraySetSlotKey(self, t_slot, MCValueRetain(p_path[0]));
 		self -> key_value_count += 1;
 	}
 	
@@ -509,6 +619,56 @@ bool MCArrayRemoveValueOnPath(MCArrayRef self, bool p_case_sensitive, const MCNa
 		if (!__MCArrayResolveIndirect(self))
 			return false;
 
+	if (__MCArrayIsDense(self))
+	{
+		// If the key isn't in the sequence, there is nothing to do.
+		index_t t_index;
+		if (!__MCArrayKeyIsDenseIndex(p_path[0], t_index) ||
+			uindex_t(t_index) > self -> key_value_count)
+			return true;
+
+		uindex_t t_slot;
+		t_slot = t_index - 1;
+
+		MCValueRef t_value;
+		t_value = self -> dense_values[t_slot];
+
+		if (p_path_length > 1)
+		{
+			if (MCValueGetTypeCode(t_value) != kMCValueTypeCodeArray)
+				return true;
+
+			MCArrayRef t_mutable_array;
+			if (!MCArrayIsMutable((MCArrayRef)t_value))
+			{
+				if (!MCArrayMutableCopyAndRelease((MCArrayRef)t_value, t_mutable_array))
+					return false;
+				self -> dense_values[t_slot] = t_mutable_array;
+			}
+			else
+				t_mutable_array = (MCArrayRef)t_value;
+
+			return MCArrayRemoveValueOnPath(t_mutable_array, p_case_sensitive, p_path + 1, p_path_length - 1);
+		}
+
+		// Removing the last value keeps the array dense; removing any other
+		// leaves a gap so the array has to become hashed.
+		if (uindex_t(t_index) == self -> key_value_count)
+		{
+			MCValueRelease(t_value);
+			self -> key_value_count -= 1;
+
+			// Empty arrays are never dense.
+			if (self -> key_value_count == 0)
+				return __MCArrayMakeHashed(self);
+
+			return true;
+		}
+
+		if (!__MCArrayMakeHashed(self))
+			return false;
+	}
+
 	// Look up the first slot in the path.
 	uindex_t t_slot;
 	if (__MCArrayFindKeyValueSlot(self, p_case_sensitive, p_path[0], t_slot))
@@ -522,12 +682,11 @@ bool MCArrayRemoveValueOnPath(MCArrayRef self, bool p_case_sensitive, const MCNa
 			MCValueRelease(self -> key_values[t_slot] . key);
 			MCValueRelease(t_value);
 
-			self -> key_values[t_slot] . key = nil;
-			self -> key_values[t_slot] . value = UINTPTR_MAX;
+			__MCArrayClearSlot(self, t_slot);
 			self -> key_value_count -= 1;
 
 			if (__MCArrayGetTableSizeIndex(self) > 2 &&
-				self -> key_value_count < __kMCValueHashTableCapacities[__MCArrayGetTableSizeIndex(self) - 2])
+				self -> key_value_count < __MCArrayGetTableCapacityForIndex(__MCArrayGetTableSizeIndex(self) - 2))
 				__MCArrayRehash(self, -1);
 
 			return true;
@@ -571,6 +730,22 @@ bool MCArrayFetchValueAtIndex(MCArrayRef self, index_t p_index, MCValueRef& r_va
 {
     __MCAssertIsArray(self);
     
+    MCArrayRef t_contents;
+    if (!__MCArrayIsIndirect(self))
+        t_contents = self;
+    else
+        t_contents = self -> contents;
+    
+    // Dense arrays hold exactly the keys 1..n, so there is no need for a name.
+    if (__MCArrayIsDense(t_contents))
+    {
+        if (p_index < 1 || uindex_t(p_index) > t_contents -> key_value_count)
+            return false;
+        
+        r_value = t_contents -> dense_values[p_index - 1];
+        return true;
+    }
+    
     MCNameRef t_key =
             MCNameLookupIndex(p_index);
     
@@ -586,6 +761,16 @@ MC_DLLEXPORT_DEF
 bool MCArrayStoreValueAtIndex(MCArrayRef self, index_t p_index, MCValueRef p_value)
 {
     __MCAssertIsArray(self);
+    MCAssert(MCArrayIsMutable(self));
+    
+    if (__MCArrayIsIndirect(self))
+        if (!__MCArrayResolveIndirect(self))
+            return false;
+    
+    // If the index keeps (or makes) the array dense, then there is no need
+    // to create a name for the key.
+    if (__MCArrayCanStoreDenseIndex(self, p_index))
+        return __MCArrayStoreDenseValueOnPath(self, true, p_index, nil, 1, p_value);
     
     MCNewAutoNameRef t_key;
     if (!MCNameCreateWithIndex(p_index,
@@ -602,6 +787,29 @@ MCArrayRemoveValueAtIndex(MCArrayRef self, index_t p_index)
 {
     __MCAssertIsArray(self);
     
+    MCArrayRef t_contents;
+    if (!__MCArrayIsIndirect(self))
+        t_contents = self;
+    else
+        t_contents = self -> contents;
+    
+    // Dense arrays have no key outside of 1..n, and the names of the keys
+    // inside it might not exist yet.
+    if (__MCArrayIsDense(t_contents))
+    {
+        if (p_index < 1 || uindex_t(p_index) > t_contents -> key_value_count)
+            return true;
+        
+        MCNewAutoNameRef t_index_key;
+        if (!MCNameCreateWithIndex(p_index,
+                                   &t_index_key))
+        {
+            return false;
+        }
+        
+        return MCArrayRemoveValue(self, true, *t_index_key);
+    }
+    
     MCNameRef t_key =
             MCNameLookupIndex(p_index);
     
@@ -663,6 +871,14 @@ void __MCArrayDestroy(__MCArray *self)
 {
 	if (__MCArrayIsIndirect(self))
 		MCValueRelease(self -> contents);
+	else if (__MCArrayIsDense(self))
+	{
+		for(uindex_t i = 0; i < self -> key_value_count; i++)
+			MCValueRelease(self -> dense_values[i]);
+		__MCArrayReleaseDenseKeys(self);
+
+		MCMemoryDeleteArray(self -> dense_values);
+	}
 	else
 	{
 		uindex_t t_used;
@@ -709,6 +925,26 @@ bool __MCArrayIsEqualTo(__MCArray *self, __MCArray *other_self)
 	if (t_contents -> key_value_count != t_other_contents -> key_value_count)
 		return false;
 
+	// Two dense arrays are equal if their values are equal in order.
+	if (__MCArrayIsDense(t_contents) && __MCArrayIsDense(t_other_contents))
+	{
+		for(uindex_t i = 0; i < t_contents -> key_value_count; i++)
+			if (!MCValueIsEqualTo(t_contents -> dense_values[i], t_other_contents -> dense_values[i]))
+				return false;
+
+		return true;
+	}
+
+	// Otherwise, iterate over the keys of whichever is hashed and look them up
+	// in the other - the counts are the same so this is sufficient.
+	if (__MCArrayIsDense(t_contents))
+	{
+		MCArrayRef t_dense_contents;
+		t_dense_contents = t_contents;
+		t_contents = t_other_contents;
+		t_other_contents = t_dense_contents;
+	}
+
 	uindex_t t_used;
 	t_used = t_contents -> key_value_count;
 
@@ -723,13 +959,13 @@ bool __MCArrayIsEqualTo(__MCArray *self, __MCArray *other_self)
 
 		// If we don't find a key in the other array matching one in this then
 		// the arrays aren't equal.
-		uindex_t t_slot;
-		if (!__MCArrayFindKeyValueSlot(t_other_contents, true, t_contents -> key_values[i] . key, t_slot))
+		MCValueRef t_other_value;
+		if (!__MCArrayFetchValueInContents(t_other_contents, true, t_contents -> key_values[i] . key, t_other_value))
 			return false;
 
 		// Otherwise, they are only equal if the values are the same.
 		if (!MCValueIsEqualTo((MCValueRef)t_contents -> key_values[i] . value,
-                              (MCValueRef)t_other_contents -> key_values[t_slot] . value))
+                              t_other_value))
 			return false;
 
 		// We've compared one more key, so used count goes down.
@@ -805,12 +1041,65 @@ static void __MCArraySetTableSizeIndex(__MCArray *self, uindex_t p_new_index)
 
 static uindex_t __MCArrayGetTableSize(__MCArray *self)
 {
-	return __kMCValueHashTableSizes[self -> flags & kMCArrayFlagCapacityIndexMask];
+	return __MCArrayGetTableSizeForIndex(self -> flags & kMCArrayFlagCapacityIndexMask);
 }
 
 static uindex_t __MCArrayGetTableCapacity(__MCArray *self)
 {
-	return __kMCValueHashTableCapacities[self -> flags & kMCArrayFlagCapacityIndexMask];
+	return __MCArrayGetTableCapacityForIndex(self -> flags & kMCArrayFlagCapacityIndexMask);
+}
+
+static uindex_t __MCArrayGetTableSizeForIndex(uindex_t p_index)
+{
+	// The tables are powers of two so that the probe position can be found
+	// with a mask, starting at 4 entries.
+	if (p_index == 0)
+		return 0;
+	return uindex_t(1) << (p_index + 1);
+}
+
+static uindex_t __MCArrayGetTableCapacityForIndex(uindex_t p_index)
+{
+	// Tables are allowed to become 7/8 full, but always have at least one
+	// free slot.
+	uindex_t t_size;
+	t_size = __MCArrayGetTableSizeForIndex(p_index);
+	if (t_size < 8)
+		return t_size != 0 ? t_size - 1 : 0;
+	return t_size - t_size / 8;
+}
+
+static bool __MCArrayNewTable(uindex_t p_size, __MCArrayKeyValue*& r_key_values)
+{
+	// The control bytes follow the slots - there is always at least a group's
+	// worth so they can be probed a group at a time. The block is cleared, so
+	// all slots start empty.
+	void *t_block;
+	if (!MCMemoryNew(p_size * sizeof(__MCArrayKeyValue) + MCMax(p_size, uindex_t(kMCArrayControlGroupWidth)), t_block))
+		return false;
+
+	r_key_values = static_cast<__MCArrayKeyValue *>(t_block);
+	return true;
+}
+
+static uint8_t *__MCArrayGetControlBytes(__MCArray *self)
+{
+	return reinterpret_cast<uint8_t *>(self -> key_values + __MCArrayGetTableSize(self));
+}
+
+static hash_t __MCArrayHashKey(MCNameRef p_key)
+{
+	// Names are hashed caselessly. The hash is mixed so that both the bits
+	// used for the control byte and the bits used to choose the group are
+	// well distributed.
+	uint32_t t_hash;
+	t_hash = uint32_t(MCValueHash(p_key));
+	t_hash ^= t_hash >> 16;
+	t_hash *= 0x85ebca6bU;
+	t_hash ^= t_hash >> 13;
+	t_hash *= 0xc2b2ae35U;
+	t_hash ^= t_hash >> 16;
+	return t_hash;
 }
 
 static bool __MCArrayIsIndirect(__MCArray *self)
@@ -820,6 +1109,20 @@ static bool __MCArrayIsIndirect(__MCArray *self)
 
 static bool __MCArrayMakeContentsImmutable(__MCArray *self)
 {
+	if (__MCArrayIsDense(self))
+	{
+		for(uindex_t i = 0; i < self -> key_value_count; i++)
+		{
+			__MCValue *t_new_value;
+			if (!__MCValueImmutableCopy((__MCValue *)self -> dense_values[i], true, t_new_value))
+				return false;
+
+			self -> dense_values[i] = t_new_value;
+		}
+
+		return true;
+	}
+
 	uindex_t t_used, t_count;
 	t_used = self -> key_value_count;
 	t_count = __MCArrayGetTableSize(self);
@@ -851,12 +1154,14 @@ static bool __MCArrayMakeIndirect(__MCArray *self)
 		return false;
 
 	// Fill in our new array.
-	t_array -> flags |= self -> flags & kMCArrayFlagCapacityIndexMask;
+	t_array -> flags |= self -> flags & (kMCArrayFlagCapacityIndexMask | kMCArrayFlagIsDense | kMCArrayFlagHasDenseKeys);
 	t_array -> key_value_count = self -> key_value_count;
+	t_array -> deleted_count = self -> deleted_count;
 	t_array -> key_values = self -> key_values;
 
 	// 'self' now becomes indirect with a reference to the new array.
 	self -> flags |= kMCArrayFlagIsIndirect;
+	self -> flags &= ~(kMCArrayFlagIsDense | kMCArrayFlagHasDenseKeys);
 	self -> contents = t_array;
 	return true;
 }
@@ -876,19 +1181,42 @@ static bool __MCArrayResolveIndirect(__MCArray *self)
 	{
 		self -> key_values = t_contents -> key_values;
 		self -> key_value_count = t_contents -> key_value_count;
+		self -> deleted_count = t_contents -> deleted_count;
+		self -> flags |= t_contents -> flags & kMCArrayFlagHasDenseKeys;
 
 		t_contents -> key_values = nil;
 		t_contents -> key_value_count = 0;
+		t_contents -> deleted_count = 0;
+		t_contents -> flags &= ~kMCArrayFlagHasDenseKeys;
+	}
+	else if (__MCArrayIsDense(t_contents))
+	{
+		// The values of a dense array are copied, but the keys (if any) are
+		// left to be created again on demand.
+		if (!MCMemoryNewArray(__MCArrayGetTableSize(t_contents), self -> dense_values))
+			return false;
+
+		self -> key_value_count = t_contents -> key_value_count;
+		self -> deleted_count = 0;
+
+		for(uindex_t i = 0; i < t_contents -> key_value_count; i++)
+			self -> dense_values[i] = MCValueRetain(t_contents -> dense_values[i]);
 	}
 	else
 	{
 		uindex_t t_size;
 		t_size = __MCArrayGetTableSize(t_contents);
 
-		if (!MCMemoryNewArray(t_size, self -> key_values))
+		// An empty table is not allocated, but 'key_values' shares its
+		// storage with 'contents' so must not be left pointing at it.
+		if (t_size == 0)
+			self -> key_values = nil;
+		else if (!__MCArrayNewTable(t_size, self -> key_values))
 			return false;
 
+		// The deleted slots are copied too, so as not to break any chains.
 		self -> key_value_count = t_contents -> key_value_count;
+		self -> deleted_count = t_contents -> deleted_count;
 
 		for(uindex_t i = 0; i < t_size; i++)
 		{
@@ -903,10 +1231,15 @@ static bool __MCArrayResolveIndirect(__MCArray *self)
                 self -> key_values[i] = t_contents -> key_values[i];
             }
 		}
+
+		// The control bytes are the same as the slots are in the same place.
+		if (t_size != 0)
+			MCMemoryCopy(self -> key_values + t_size, t_contents -> key_values + t_size, MCMax(t_size, uindex_t(kMCArrayControlGroupWidth)));
 	}
 
-	// Make sure we take the index from the flags.
+	// Make sure we take the index and representation from the flags.
 	__MCArraySetTableSizeIndex(self, __MCArrayGetTableSizeIndex(t_contents));
+	self -> flags |= t_contents -> flags & kMCArrayFlagIsDense;
 
 	// Make sure the array is no longer marked as indirect.
 	self -> flags &= ~kMCArrayFlagIsIndirect;
@@ -917,6 +1250,53 @@ static bool __MCArrayResolveIndirect(__MCArray *self)
 	return true;
 }
 
+// Returns a mask with a bit set for each control byte in the group which is
+// equal to the given byte.
+static inline uint32_t __MCArrayMatchControlGroup(const uint8_t *p_group, uint8_t p_byte)
+{
+#if defined(__X86_64__) || defined(__SSE2__)
+	__m128i t_group;
+	t_group = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p_group));
+	return uint32_t(_mm_movemask_epi8(_mm_cmpeq_epi8(t_group, _mm_set1_epi8(char(p_byte)))));
+#else
+	uint32_t t_mask;
+	t_mask = 0;
+	for(uindex_t i = 0; i < kMCArrayControlGroupWidth; i++)
+		if (p_group[i] == p_byte)
+			t_mask |= 1U << i;
+	return t_mask;
+#endif
+}
+
+// Returns the index of the lowest set bit in the (non-zero) mask.
+static inline uindex_t __MCArrayGetFirstMatch(uint32_t p_mask)
+{
+#if defined(_MSC_VER)
+	unsigned long t_index;
+	_BitScanForward(&t_index, p_mask);
+	return t_index;
+#else
+	return __builtin_ctz(p_mask);
+#endif
+}
+
+// Computes the mask of groups, and the mask of the control bytes within a
+// group which belong to slots. Tables smaller than a group are probed as a
+// single group, ignoring the padding at the end.
+static inline void __MCArrayGetGroupMasks(uindex_t p_size, uindex_t& r_group_mask, uint32_t& r_valid_mask)
+{
+	if (p_size < kMCArrayControlGroupWidth)
+	{
+		r_group_mask = 0;
+		r_valid_mask = (1U << p_size) - 1;
+	}
+	else
+	{
+		r_group_mask = p_size / kMCArrayControlGroupWidth - 1;
+		r_valid_mask = (1U << kMCArrayControlGroupWidth) - 1;
+	}
+}
+
 static bool __MCArrayFindKeyValueSlot(__MCArray *self, bool p_case_sensitive, MCNameRef p_key, uindex_t& r_slot)
 {
 	// Get the table size.
@@ -928,59 +1308,73 @@ static bool __MCArrayFindKeyValueSlot(__MCArray *self, bool p_case_sensitive, MC
 		return false;
 	}
 
-	// Get the hash.
-	uindex_t t_hash;
-	t_hash = MCValueHash(p_key);
+	// Get the hash, the low bits of which must match the control byte of the
+	// key's slot.
+	hash_t t_hash;
+	t_hash = __MCArrayHashKey(p_key);
 
-	// Fold the hash code appropriately.
-	uindex_t t_h1;
-#if defined(__ARM__) && 0 // TODO	
-	t_h1 = __MCHashFold(t_hash, __MCArrayGetTableSizeIndex(self));
-#else
-	t_h1 = t_hash % t_size;
-#endif
+	uint8_t t_control;
+	t_control = kMCArrayControlFull | (t_hash & kMCArrayControlHashMask);
+
+	uindex_t t_group_mask;
+	uint32_t t_valid_mask;
+	__MCArrayGetGroupMasks(t_size, t_group_mask, t_valid_mask);
+
+	const uint8_t *t_controls;
+	t_controls = __MCArrayGetControlBytes(self);
 
-	// The initial index to probe.
-	uindex_t t_probe;
-	t_probe = t_h1;
+	MCStringOptions t_options;
+	t_options = p_case_sensitive ? kMCStringOptionCompareExact : kMCStringOptionCompareCaseless;
+
+	// The initial group to probe.
+	uindex_t t_group;
+	t_group = (t_hash >> 7) & t_group_mask;
 
 	// The target for a new entry - if it ends up being UINDEX_MAX it means the
 	// table is full.
 	uindex_t t_target_slot;
 	t_target_slot = UINDEX_MAX;
 
-	// Loop over all key value pairs - starting at probe.
-	for(uindex_t i = 0; i < t_size; i++)
+	// Loop over all the groups, starting at the initial one. The step grows
+	// by one each time, which visits every group as the count is a power of
+	// two.
+	for(uindex_t i = 0; i <= t_group_mask; i++)
 	{
-		__MCArrayKeyValue *t_entry;
-		t_entry = &self -> key_values[t_probe];
+		const uint8_t *t_group_controls;
+		t_group_controls = t_controls + t_group * kMCArrayControlGroupWidth;
 
-		if (t_entry -> value == UINTPTR_MIN)
+		// Only the keys whose control bytes match need to be compared.
+		uint32_t t_matches;
+		t_matches = __MCArrayMatchControlGroup(t_group_controls, t_control);
+		while(t_matches != 0)
 		{
-			// The end of the chain - we are done.
-			if (t_target_slot == UINDEX_MAX)
-				t_target_slot = t_probe;
-			r_slot = t_probe;
-			return false;
-		}
-
-		if (t_entry -> value == UINTPTR_MAX)
-		{
-			if (t_target_slot == UINDEX_MAX)
-				t_target_slot = t_probe;
-		}
-		else
-		{
-            if (MCNameIsEqualTo(t_entry -> key, p_key, !p_case_sensitive ? kMCStringOptionCompareCaseless : kMCStringOptionCompareExact))
+			uindex_t t_slot;
+			t_slot = t_group * kMCArrayControlGroupWidth + __MCArrayGetFirstMatch(t_matches);
+			if (MCNameIsEqualTo(self -> key_values[t_slot] . key, p_key, t_options))
 			{
-				r_slot = t_probe;
+				r_slot = t_slot;
 				return true;
 			}
+
+			t_matches &= t_matches - 1;
+		}
+
+		uint32_t t_empty;
+		t_empty = __MCArrayMatchControlGroup(t_group_controls, kMCArrayControlEmpty) & t_valid_mask;
+
+		if (t_target_slot == UINDEX_MAX)
+		{
+			uint32_t t_unused;
+			t_unused = t_empty | __MCArrayMatchControlGroup(t_group_controls, kMCArrayControlDeleted);
+			if (t_unused != 0)
+				t_target_slot = t_group * kMCArrayControlGroupWidth + __MCArrayGetFirstMatch(t_unused);
 		}
 
-		t_probe += 1;
-		if (t_size <= t_probe)
-			t_probe -= t_size;
+		// An empty slot is the end of the chain - we are done.
+		if (t_empty != 0)
+			break;
+
+		t_group = (t_group + i + 1) & t_group_mask;
 	}
 
 	// If we get here the name wasn't found.
@@ -988,6 +1382,105 @@ static bool __MCArrayFindKeyValueSlot(__MCArray *self, bool p_case_sensitive, MC
 	return false;
 }
 
+// Returns the first unused slot on the probe sequence for the hash.
+static uindex_t __MCArrayFindUnusedSlot(__MCArray *self, hash_t p_hash)
+{
+	uindex_t t_group_mask;
+	uint32_t t_valid_mask;
+	__MCArrayGetGroupMasks(__MCArrayGetTableSize(self), t_group_mask, t_valid_mask);
+
+	const uint8_t *t_controls;
+	t_controls = __MCArrayGetControlBytes(self);
+
+	uindex_t t_group;
+	t_group = (p_hash >> 7) & t_group_mask;
+	for(uindex_t i = 0; i <= t_group_mask; i++)
+	{
+		const uint8_t *t_group_controls;
+		t_group_controls = t_controls + t_group * kMCArrayControlGroupWidth;
+
+		uint32_t t_unused;
+		t_unused = (__MCArrayMatchControlGroup(t_group_controls, kMCArrayControlEmpty) |
+					__MCArrayMatchControlGroup(t_group_controls, kMCArrayControlDeleted)) & t_valid_mask;
+		if (t_unused != 0)
+			return t_group * kMCArrayControlGroupWidth + __MCArrayGetFirstMatch(t_unused);
+
+		t_group = (t_group + i + 1) & t_group_mask;
+	}
+
+	return UINDEX_MAX;
+}
+
+static void __MCArraySetSlotKey(__MCArray *self, uindex_t p_slot, MCNameRef p_key)
+{
+	uint8_t *t_controls;
+	t_controls = __MCArrayGetControlBytes(self);
+	if (t_controls[p_slot] == kMCArrayControlDeleted)
+		self -> deleted_count -= 1;
+
+	self -> key_values[p_slot] . key = p_key;
+	t_controls[p_slot] = kMCArrayControlFull | (__MCArrayHashKey(p_key) & kMCArrayControlHashMask);
+}
+
+static void __MCArrayClearSlot(__MCArray *self, uindex_t p_slot)
+{
+	uindex_t t_group_mask;
+	uint32_t t_valid_mask;
+	__MCArrayGetGroupMasks(__MCArrayGetTableSize(self), t_group_mask, t_valid_mask);
+
+	uint8_t *t_controls;
+	t_controls = __MCArrayGetControlBytes(self);
+
+	// If the slot's group still has an empty slot then no probe has ever
+	// continued past it, so the slot can become empty rather than deleted.
+	uindex_t t_group_start;
+	t_group_start = p_slot & ~uindex_t(kMCArrayControlGroupWidth - 1);
+
+	self -> key_values[p_slot] . key = nil;
+	if ((__MCArrayMatchControlGroup(t_controls + t_group_start, kMCArrayControlEmpty) & t_valid_mask) != 0)
+	{
+		t_controls[p_slot] = kMCArrayControlEmpty;
+		self -> key_values[p_slot] . value = UINTPTR_MIN;
+	}
+	else
+	{
+		t_controls[p_slot] = kMCArrayControlDeleted;
+		self -> key_values[p_slot] . value = UINTPTR_MAX;
+		self -> deleted_count += 1;
+	}
+}
+
+static bool __MCArrayEnsureRoomForKey(__MCArray *self, bool p_case_sensitive, MCNameRef p_key, uindex_t& x_slot)
+{
+	// Reusing a deleted slot doesn't change the load of the table, but
+	// filling an empty one does - and deleted slots count towards it, as
+	// every probe which misses has to pass over them.
+	// AL-2014-07-15: [[ Bug 12532 ]] Rehash according to hash table capacities rather than sizes
+	uindex_t t_capacity;
+	t_capacity = __MCArrayGetTableCapacity(self);
+	if (x_slot != UINDEX_MAX &&
+		self -> key_value_count < t_capacity &&
+		(__MCArrayGetControlBytes(self)[x_slot] == kMCArrayControlDeleted ||
+		 self -> key_value_count + self -> deleted_count < t_capacity))
+		return true;
+
+	// If at least a quarter of the capacity is left once the deleted slots
+	// are cleared, rehash at the same size; otherwise grow to the next size
+	// up. Either way there is then room for a good number of new keys, so
+	// churning keys which are removed and added doesn't rehash each time.
+	index_t t_by;
+	if (self -> key_value_count < t_capacity - t_capacity / 4)
+		t_by = 0;
+	else
+		t_by = index_t(t_capacity - self -> key_value_count + 1);
+
+	if (!__MCArrayRehash(self, t_by))
+		return false;
+
+	__MCArrayFindKeyValueSlot(self, p_case_sensitive, p_key, x_slot);
+	return true;
+}
+
 static bool __MCArrayRehash(__MCArray *self, index_t p_by)
 {
 	uindex_t t_new_capacity_idx;
@@ -1000,7 +1493,7 @@ static bool __MCArrayRehash(__MCArray *self, index_t p_by)
 		uindex_t t_new_capacity_req;
 		t_new_capacity_req = self -> key_value_count + p_by;
 		for(t_new_capacity_idx = 0;
-		    t_new_capacity_req > __kMCValueHashTableCapacities[t_new_capacity_idx];
+		    t_new_capacity_req > __MCArrayGetTableCapacityForIndex(t_new_capacity_idx);
 		    ++t_new_capacity_idx);
 	}
 
@@ -1011,23 +1504,32 @@ static bool __MCArrayRehash(__MCArray *self, index_t p_by)
 
 	uindex_t t_new_capacity;
 	__MCArrayKeyValue *t_new_key_values;
-	t_new_capacity = __kMCValueHashTableSizes[t_new_capacity_idx];
-	if (!MCMemoryNewArray(t_new_capacity, t_new_key_values))
+	t_new_capacity = __MCArrayGetTableSizeForIndex(t_new_capacity_idx);
+	if (!__MCArrayNewTable(t_new_capacity, t_new_key_values))
 		return false;
 
 	__MCArraySetTableSizeIndex(self, t_new_capacity_idx);
 	self -> key_values = t_new_key_values;
+	self -> deleted_count = 0;
 
+	// The keys are all different, so they only need a free slot (with the
+	// right control byte) in the new table.
+	uint8_t *t_new_controls;
+	t_new_controls = __MCArrayGetControlBytes(self);
 	for(uindex_t i = 0; i < t_old_capacity; i++)
 	{
 		if (t_old_key_values[i] . value != UINTPTR_MIN && t_old_key_values[i] . value != UINTPTR_MAX)
 		{
+			hash_t t_hash;
+			t_hash = __MCArrayHashKey(t_old_key_values[i] . key);
+
 			uindex_t t_target_slot;
-			__MCArrayFindKeyValueSlot(self, true, t_old_key_values[i] . key, t_target_slot);
+			t_target_slot = __MCArrayFindUnusedSlot(self, t_hash);
 
 			MCAssert(t_target_slot != UINDEX_MAX);
 
 			t_new_key_values[t_target_slot] = t_old_key_values[i];
+			t_new_controls[t_target_slot] = kMCArrayControlFull | (t_hash & kMCArrayControlHashMask);
 		}
 	}
 
@@ -1036,6 +1538,325 @@ static bool __MCArrayRehash(__MCArray *self, index_t p_by)
 	return true;
 }
 
+static bool __MCArrayIsDense(__MCArray *self)
+{
+	return (self -> flags & kMCArrayFlagIsDense) != 0;
+}
+
+static bool __MCArrayKeyIsDenseIndex(MCNameRef p_key, index_t& r_index)
+{
+	MCStringRef t_string;
+	t_string = MCNameGetString(p_key);
+
+	// An index has at most 10 digits, and must not have a leading zero (or
+	// it would be a different key).
+	uindex_t t_length;
+	t_length = MCStringGetLength(t_string);
+	if (t_length == 0 || t_length > 10)
+		return false;
+
+	const char_t *t_native_chars;
+	t_native_chars = MCStringGetNativeCharPtr(t_string);
+
+	uint64_t t_index;
+	t_index = 0;
+	for(uindex_t i = 0; i < t_length; i++)
+	{
+		unichar_t t_char;
+		if (t_native_chars != nil)
+			t_char = t_native_chars[i];
+		else
+			t_char = MCStringGetCharAtIndex(t_string, i);
+		if (t_char < (i == 0 ? '1' : '0') || t_char > '9')
+			return false;
+
+		t_index = t_index * 10 + (t_char - '0');
+	}
+
+	if (t_index > INDEX_MAX)
+		return false;
+
+	r_index = index_t(t_index);
+	return true;
+}
+
+static bool __MCArrayCanStoreDenseIndex(__MCArray *self, index_t p_index)
+{
+	if (!__MCArrayIsDense(self) && self -> key_value_count != 0)
+		return false;
+
+	return p_index >= 1 && uindex_t(p_index) <= self -> key_value_count + 1;
+}
+
+static void __MCArrayMakeDense(__MCArray *self)
+{
+	if (__MCArrayIsDense(self))
+		return;
+
+	MCAssert(self -> key_value_count == 0);
+
+	// An empty hashed table has no keys or values left in it, so can just be
+	// thrown away.
+	MCMemoryDeleteArray(self -> key_values);
+	self -> key_values = nil;
+	self -> deleted_count = 0;
+
+	__MCArraySetTableSizeIndex(self, 0);
+	self -> flags |= kMCArrayFlagIsDense;
+}
+
+static bool __MCArrayMakeHashed(__MCArray *self)
+{
+	MCAssert(__MCArrayIsDense(self));
+
+	MCValueRef *t_values;
+	uindex_t t_count, t_capacity_idx, t_flags;
+	t_values = self -> dense_values;
+	t_count = self -> key_value_count;
+	t_capacity_idx = __MCArrayGetTableSizeIndex(self);
+	t_flags = self -> flags & (kMCArrayFlagIsDense | kMCArrayFlagHasDenseKeys);
+
+	// Any keys which were created for iteration can be reused.
+	MCNameRef *t_keys;
+	if ((t_flags & kMCArrayFlagHasDenseKeys) != 0)
+		t_keys = __MCArrayGetDenseKeys(self);
+	else
+		t_keys = nil;
+
+	// Switch to an empty hashed table, large enough for all the values.
+	self -> flags &= ~(kMCArrayFlagIsDense | kMCArrayFlagHasDenseKeys);
+	self -> key_values = nil;
+	self -> key_value_count = 0;
+	__MCArraySetTableSizeIndex(self, 0);
+
+	bool t_success;
+	t_success = t_count == 0 || __MCArrayRehash(self, t_count);
+
+	// Now insert each value with its key.
+	for(uindex_t i = 0; t_success && i < t_count; i++)
+	{
+		MCNameRef t_key;
+		if (t_keys != nil && t_keys[i] != nil)
+			t_key = MCValueRetain(t_keys[i]);
+		else
+			t_success = MCNameCreateWithIndex(i + 1, t_key);
+
+		if (t_success)
+		{
+			uindex_t t_slot;
+			__MCArrayFindKeyValueSlot(self, true, t_key, t_slot);
+			__MCArraySetSlotKey(self, t_slot, t_key);
+			self -> key_values[t_slot] . value = (uintptr_t)t_values[i];
+			self -> key_value_count += 1;
+		}
+	}
+
+	if (!t_success)
+	{
+		// Put things back the way they were - the values are still in the
+		// dense vector so only the new keys need to be released.
+		for(uindex_t i = 0; i < __MCArrayGetTableSize(self); i++)
+			if (self -> key_values[i] . value != UINTPTR_MIN && self -> key_values[i] . value != UINTPTR_MAX)
+				MCValueRelease(self -> key_values[i] . key);
+		MCMemoryDeleteArray(self -> key_values);
+
+		self -> flags |= t_flags;
+		self -> dense_values = t_values;
+		self -> key_value_count = t_count;
+		self -> deleted_count = 0;
+		__MCArraySetTableSizeIndex(self, t_capacity_idx);
+		return false;
+	}
+
+	// The keys live in the same block as the values, so both go together.
+	if (t_keys != nil)
+		for(uindex_t i = 0; i < __MCArrayGetTableSizeForIndex(t_capacity_idx) && t_keys[i] != nil; i++)
+			MCValueRelease(t_keys[i]);
+	MCMemoryDeleteArray(t_values);
+
+	return true;
+}
+
+static bool __MCArrayEnsureDenseCapacity(__MCArray *self, uindex_t p_count)
+{
+	uindex_t t_size;
+	t_size = __MCArrayGetTableSize(self);
+	if (p_count <= t_size)
+		return true;
+
+	// The vector grows through the same sequence of sizes as the hash table.
+	uindex_t t_new_capacity_idx;
+	for(t_new_capacity_idx = __MCArrayGetTableSizeIndex(self);
+		p_count > __MCArrayGetTableSizeForIndex(t_new_capacity_idx);
+		++t_new_capacity_idx);
+
+	uindex_t t_new_size;
+	t_new_size = __MCArrayGetTableSizeForIndex(t_new_capacity_idx);
+
+	// If the keys have been created they follow the values, and so must be
+	// moved up to follow the larger vector. The new end of the block is
+	// cleared by the resize, so the unused keys remain nil.
+	if ((self -> flags & kMCArrayFlagHasDenseKeys) != 0)
+	{
+		uindex_t t_block_size;
+		t_block_size = t_size * 2;
+		if (!MCMemoryResizeArray(t_new_size * 2, self -> dense_values, t_block_size))
+			return false;
+
+		MCMemoryMove(self -> dense_values + t_new_size, self -> dense_values + t_size, t_size * sizeof(MCNameRef));
+	}
+	else if (!MCMemoryResizeArray(t_new_size, self -> dense_values, t_size))
+		return false;
+
+	__MCArraySetTableSizeIndex(self, t_new_capacity_idx);
+	return true;
+}
+
+static bool __MCArrayEnsureDenseKeys(__MCArray *self)
+{
+	uindex_t t_size;
+	t_size = __MCArrayGetTableSize(self);
+
+	// Make room for the keys after the values, they start off as nil.
+	if ((self -> flags & kMCArrayFlagHasDenseKeys) == 0)
+	{
+		uindex_t t_block_size;
+		t_block_size = t_size;
+		if (!MCMemoryResizeArray(t_size * 2, self -> dense_values, t_block_size))
+			return false;
+
+		self -> flags |= kMCArrayFlagHasDenseKeys;
+	}
+
+	// The keys are always created in order, so search back for the first
+	// which hasn't been created yet.
+	MCNameRef *t_keys;
+	t_keys = __MCArrayGetDenseKeys(self);
+
+	uindex_t t_first;
+	t_first = self -> key_value_count;
+	while(t_first > 0 && t_keys[t_first - 1] == nil)
+		t_first -= 1;
+
+	for(uindex_t i = t_first; i < self -> key_value_count; i++)
+		if (!MCNameCreateWithIndex(i + 1, t_keys[i]))
+			return false;
+
+	return true;
+}
+
+static MCNameRef *__MCArrayGetDenseKeys(__MCArray *self)
+{
+	return reinterpret_cast<MCNameRef *>(self -> dense_values + __MCArrayGetTableSize(self));
+}
+
+static void __MCArrayReleaseDenseKeys(__MCArray *self)
+{
+	if ((self -> flags & kMCArrayFlagHasDenseKeys) == 0)
+		return;
+
+	MCNameRef *t_keys;
+	t_keys = __MCArrayGetDenseKeys(self);
+	for(uindex_t i = 0; i < __MCArrayGetTableSize(self) && t_keys[i] != nil; i++)
+		MCValueRelease(t_keys[i]);
+}
+
+static bool __MCArrayFetchValueInContents(__MCArray *self, bool p_case_sensitive, MCNameRef p_key, MCValueRef& r_value)
+{
+	if (__MCArrayIsDense(self))
+	{
+		index_t t_index;
+		if (!__MCArrayKeyIsDenseIndex(p_key, t_index) ||
+			uindex_t(t_index) > self -> key_value_count)
+			return false;
+
+		r_value = self -> dense_values[t_index - 1];
+		return true;
+	}
+
+	uindex_t t_slot;
+	if (!__MCArrayFindKeyValueSlot(self, p_case_sensitive, p_key, t_slot))
+		return false;
+
+	r_value = (MCValueRef)self -> key_values[t_slot] . value;
+	return true;
+}
+
+static bool __MCArrayStoreDenseValueOnPath(__MCArray *self, bool p_case_sensitive, index_t p_index, const MCNameRef *p_path, uindex_t p_path_length, MCValueRef p_new_value)
+{
+	__MCArrayMakeDense(self);
+
+	uindex_t t_slot;
+	t_slot = p_index - 1;
+
+	bool t_found;
+	t_found = t_slot < self -> key_value_count;
+	if (t_found)
+	{
+		// Get the value.
+		MCValueRef t_value;
+		t_value = self -> dense_values[t_slot];
+
+		// If the path length is 1, then just set the value and return.
+		if (p_path_length == 1)
+		{
+			MCValueRelease(t_value);
+			self -> dense_values[t_slot] = MCValueRetain(p_new_value);
+			return true;
+		}
+
+		// If the value is an array then recurse.
+		if (MCValueGetTypeCode(t_value) == kMCValueTypeCodeArray)
+		{
+			MCArrayRef t_mutable_array;
+			if (!MCArrayIsMutable((MCArrayRef)t_value))
+			{
+				if (!MCArrayMutableCopyAndRelease((MCArrayRef)t_value, t_mutable_array))
+					return false;
+				self -> dense_values[t_slot] = t_mutable_array;
+			}
+			else
+				t_mutable_array = (MCArrayRef)t_value;
+
+			return MCArrayStoreValueOnPath(t_mutable_array, p_case_sensitive, p_path + 1, p_path_length - 1, p_new_value);
+		}
+	}
+	else
+	{
+		// The index is one past the end, so the value is appended.
+		if (!__MCArrayEnsureDenseCapacity(self, t_slot + 1))
+			return false;
+
+		if (p_path_length == 1)
+		{
+			self -> dense_values[t_slot] = MCValueRetain(p_new_value);
+			self -> key_value_count += 1;
+			return true;
+		}
+	}
+
+	// If the value isn't an array, then create one.
+	MCArrayRef t_array;
+	if (!MCArrayCreateMutable(t_array))
+		return false;
+
+	// Build up the new array's value.
+	if (!MCArrayStoreValueOnPath(t_array, p_case_sensitive, p_path + 1, p_path_length - 1, p_new_value))
+	{
+		MCValueRelease(t_array);
+		return false;
+	}
+
+	if (t_found)
+		MCValueRelease(self -> dense_values[t_slot]);
+	else
+		self -> key_value_count += 1;
+
+	self -> dense_values[t_slot] = t_array;
+
+	return true;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 
 MC_DLLEXPORT_DEF MCArrayRef kMCEmptyArray;
@@ -1064,6 +1885,18 @@ void __MCArrayDump(MCArrayRef array)
 	else
 		t_contents = array -> contents;
 
+	// Dense arrays only have values to dump.
+	if (__MCArrayIsDense(t_contents))
+	{
+		for(uindex_t i = 0; i < t_contents -> key_value_count; i++)
+		{
+			MCAutoStringRef t_desc;
+			MCValueCopyDescription(t_contents -> dense_values[i], &t_desc);
+			MCLog("[%u] = %@", i + 1, *t_desc);
+		}
+		return;
+	}
+
 	uindex_t t_size;
 	t_size = __MCArrayGetTableSize(t_contents);
 
@@ -560,6 +560,29 @@ bool MCTextChunkIterator_Delimited::Next()
     return true;
 }
 
+uindex_t MCTextChunkIterator_Delimited::CountChunks()
+{
+    // Counting only makes sense from the start, and an empty delimiter never
+    // matches so there is nothing to gain.
+    if (!m_first_chunk || MCStringIsEmpty(m_delimiter))
+        return MCTextChunkIterator::CountChunks();
+    
+    if (m_range . offset >= m_length)
+        return 0;
+    
+    // There is one more chunk than there are delimiters, unless the last
+    // delimiter is trailing.
+    uindex_t t_delimiter_count;
+    MCRange t_last_delimiter;
+    MCStringFindNth(m_text, MCRangeMakeMinMax(m_range . offset, m_length), m_delimiter, m_options, UINDEX_MAX, t_delimiter_count, &t_last_delimiter);
+    
+    if (t_delimiter_count != 0 &&
+        t_last_delimiter . offset + t_last_delimiter . length == m_length)
+        return t_delimiter_count;
+    
+    return t_delimiter_count + 1;
+}
+
 bool MCTextChunkIterator_Delimited::IsAmong(MCStringRef p_needle)
 {
     // if the pattern is empty, we use the default behavior -
@@ -656,9 +679,29 @@ uindex_t MCTextChunkIterator_Delimited::ChunkOffset(MCStringRef p_needle, uindex
 
 ////////////////////////////////////////////////////////////////////////////////
 
+// Fills the breaks from the cached ranges of the sentences or true words of
+// the text, if it has them.
+static bool MCTextChunkIteratorFetchCachedBreaks(MCStringRef p_text, MCChunkType p_chunk_type, MCAutoArray<MCRange>& x_breaks)
+{
+    const MCRange *t_ranges;
+    uindex_t t_count;
+    if (!MCStringFetchBreakRanges(p_text, p_chunk_type == kMCChunkTypeSentence ? kMCBreakIteratorTypeSentence : kMCBreakIteratorTypeWord, kMCLocaleBasic, t_ranges, t_count))
+        return false;
+    
+    if (!x_breaks . Extend(t_count))
+        return false;
+    
+    MCMemoryCopy(x_breaks . Ptr(), t_ranges, t_count * sizeof(MCRange));
+    return true;
+}
+
 MCTextChunkIterator_ICU::MCTextChunkIterator_ICU(MCStringRef p_text, MCChunkType p_chunk_type) : MCTextChunkIterator(p_text, p_chunk_type)
 {
     m_break_position = 0;
+    
+    if (MCTextChunkIteratorFetchCachedBreaks(m_text, p_chunk_type, m_breaks))
+        return;
+    
     MCBreakIteratorRef break_iterator;
     break_iterator = nil;
     
@@ -706,6 +749,13 @@ MCTextChunkIterator_ICU::MCTextChunkIterator_ICU(MCStringRef p_text, MCChunkType
 MCTextChunkIterator_ICU::MCTextChunkIterator_ICU(MCStringRef p_text, MCChunkType p_chunk_type, MCRange p_restriction) : MCTextChunkIterator(p_text, p_chunk_type, p_restriction)
 {
     m_break_position = 0;
+    
+    // A restriction to the whole text is common (e.g. when counting chunks),
+    // and can use the text's cached breaks.
+    if (p_restriction . offset == 0 && p_restriction . length >= MCStringGetLength(m_text) &&
+        MCTextChunkIteratorFetchCachedBreaks(m_text, p_chunk_type, m_breaks))
+        return;
+    
     MCBreakIteratorRef break_iterator;
     break_iterator = nil;
     
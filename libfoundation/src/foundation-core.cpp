@@ -24,6 +24,11 @@ along with LiveCode.  If not see <http://www.gnu.org/licenses/>.  */
 
 #if defined(__WINDOWS__)
 #   include <Windows.h>
+#   include <malloc.h>
+#elif defined(__MAC__) || defined(__IOS__)
+#   include <malloc/malloc.h>
+#elif defined(__LINUX__) || defined(__ANDROID__) || defined(__EMSCRIPTEN__)
+#   include <malloc.h>
 #endif
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -39,6 +44,9 @@ bool MCInitialize(void)
     if (!__MCUnicodeInitialize())
         return false;
     
+    // The constant values created by the modules are used by all threads.
+    __MCValueSetCreateShared(true);
+    
     if (!__MCValueInitialize())
 		return false;
     
@@ -89,6 +97,8 @@ bool MCInitialize(void)
     
     if (!__MCObjcInitialize())
         return false;
+    
+    __MCValueSetCreateShared(false);
 
 	return true;
 }
@@ -119,6 +129,31 @@ void MCFinalize(void)
 
 ////////////////////////////////////////////////////////////////////////////////
 
+// If true, the blocks allocated by the functions below are counted.
+static bool s_memory_accounting = false;
+
+static std::atomic<uint64_t> s_memory_allocations;
+static std::atomic<uint64_t> s_memory_deallocations;
+static std::atomic<uint64_t> s_memory_allocated_bytes;
+static __MCAccountingCounter s_memory_live_bytes;
+
+static void __MCMemoryCountAllocation(size_t p_size)
+{
+    bool t_atomic;
+    t_atomic = __MCValueIsThreadingEnabled();
+    __MCAccountingAdd<uint64_t>(s_memory_allocations, 1, t_atomic);
+    __MCAccountingAdd<uint64_t>(s_memory_allocated_bytes, p_size, t_atomic);
+    s_memory_live_bytes . Add(int64_t(p_size), t_atomic);
+}
+
+static void __MCMemoryCountDeallocation(size_t p_size)
+{
+    bool t_atomic;
+    t_atomic = __MCValueIsThreadingEnabled();
+    __MCAccountingAdd<uint64_t>(s_memory_deallocations, 1, t_atomic);
+    s_memory_live_bytes . Add(-int64_t(p_size), t_atomic);
+}
+
 MC_DLLEXPORT_DEF
 bool MCMemoryAllocate(size_t p_size, void*& r_block)
 {
@@ -126,6 +161,8 @@ bool MCMemoryAllocate(size_t p_size, void*& r_block)
 	t_block = malloc(p_size != 0 ? p_size : 4);
 	if (t_block != nil)
 	{
+        if (s_memory_accounting)
+            __MCMemoryCountAllocation(__MCMemoryGetBlockSize(t_block));
 		r_block = t_block;
 		return true;
 	}
@@ -146,10 +183,23 @@ bool MCMemoryAllocateCopy(const void *p_block, size_t p_block_size, void*& r_blo
 MC_DLLEXPORT_DEF
 bool MCMemoryReallocate(void *p_block, size_t p_new_size, void*& r_new_block)
 {
+    // The old block is gone once realloc succeeds, so its size must be taken
+    // first.
+    size_t t_old_size;
+    t_old_size = 0;
+    if (s_memory_accounting && p_block != nil)
+        t_old_size = __MCMemoryGetBlockSize(p_block);
+    
 	void *t_new_block;
 	t_new_block = realloc(p_block, p_new_size != 0 ? p_new_size : 4);
 	if (t_new_block != nil)
 	{
+        if (s_memory_accounting)
+        {
+            if (p_block != nil)
+                __MCMemoryCountDeallocation(t_old_size);
+            __MCMemoryCountAllocation(__MCMemoryGetBlockSize(t_new_block));
+        }
 		r_new_block = t_new_block;
 		return true;
 	}
@@ -159,9 +209,39 @@ bool MCMemoryReallocate(void *p_block, size_t p_new_size, void*& r_new_block)
 MC_DLLEXPORT_DEF
 void MCMemoryDeallocate(void *p_block)
 {
+    if (s_memory_accounting && p_block != nil)
+        __MCMemoryCountDeallocation(__MCMemoryGetBlockSize(p_block));
 	free(p_block);
 }
 
+void __MCMemoryEnableAccounting(void)
+{
+    s_memory_accounting = true;
+}
+
+size_t __MCMemoryGetBlockSize(void *p_block)
+{
+#if defined(__WINDOWS__)
+    return _msize(p_block);
+#elif defined(__MAC__) || defined(__IOS__)
+    return malloc_size(p_block);
+#elif defined(__LINUX__) || defined(__ANDROID__) || defined(__EMSCRIPTEN__)
+    return malloc_usable_size(p_block);
+#else
+    return 0;
+#endif
+}
+
+MC_DLLEXPORT_DEF
+void MCMemoryGetStatistics(MCMemoryStatistics& r_statistics)
+{
+    r_statistics . allocations = s_memory_allocations . load(std::memory_order_relaxed);
+    r_statistics . deallocations = s_memory_deallocations . load(std::memory_order_relaxed);
+    r_statistics . allocated_bytes = s_memory_allocated_bytes . load(std::memory_order_relaxed);
+    r_statistics . live_bytes = s_memory_live_bytes . GetCurrent();
+    r_statistics . peak_bytes = s_memory_live_bytes . GetPeak();
+}
+
 //////////
 
 MC_DLLEXPORT_DEF
@@ -331,7 +411,7 @@ template <typename CodeUnit>
 static hash_t hash_chars(CodeUnit *p_chars, size_t char_count)
 {
     MCHashCharsContext t_context;
-    while (char_count-- > 0) t_context.consume(*p_chars++);
+    t_context.consume(p_chars, char_count);
     return t_context;
 }
 
@@ -54,6 +54,24 @@ static bool __MCDataResolveIndirect(__MCData *self);
 // Makes direct mutable data ref indirect, referencing r_new_data.
 static bool __MCDataCopyMutable(__MCData *self, __MCData*& r_new_data);
 
+// Returns true if the bytes of the immutable data ref are within those of
+// another (its owner).
+static bool __MCDataIsSlice(__MCData *self);
+
+// Returns true if a slice should be used for the given range of self, rather
+// than a copy.
+static bool __MCDataShouldSlice(__MCData *self, MCRange range);
+
+// Creates an immutable data ref referencing the given range of self's bytes.
+static bool __MCDataCreateSlice(__MCData *self, MCRange range, __MCData*& r_slice);
+
+// Returns true if the data's bytes are owned elsewhere and freed by its
+// release callback.
+static bool __MCDataIsExternal(__MCData *self);
+
+// Gives the slice or external data its own copy of its bytes.
+static bool __MCDataDetachBytes(__MCData *self);
+
 ////////////////////////////////////////////////////////////////////////////////
 
 MC_DLLEXPORT_DEF
@@ -127,6 +145,25 @@ bool MCDataCreateWithBytesAndRelease(byte_t *p_bytes, uindex_t p_byte_count, MCD
     return t_success;
 }
 
+MC_DLLEXPORT_DEF
+bool MCDataCreateWithExternalBytes(byte_t *p_bytes, uindex_t p_byte_count, MCDataReleaseBytesCallback p_release, MCDataRef& r_data)
+{
+	MCAssert(nil != p_bytes);
+	MCAssert(nil != p_release);
+
+    __MCData *self;
+    if (!__MCValueCreate(kMCValueTypeCodeData, self))
+        return false;
+    
+    self -> bytes = p_bytes;
+    self -> byte_count = p_byte_count;
+    self -> release = p_release;
+    self -> flags |= kMCDataFlagIsExternal;
+    
+    r_data = self;
+    return true;
+}
+
 MC_DLLEXPORT_DEF
 bool
 MCDataCreateWithData(MCDataRef& r_data, MCDataRef p_one, MCDataRef p_two)
@@ -402,6 +439,11 @@ bool MCDataMutableCopyAndRelease(MCDataRef p_data, MCDataRef& r_mutable_data)
 
     if (p_data -> references == 1)
     {
+        // A slice's or external data's bytes are not its own to change.
+        if ((__MCDataIsSlice(p_data) || __MCDataIsExternal(p_data)) &&
+            !__MCDataDetachBytes(p_data))
+            return false;
+        
         if (!MCDataIsMutable(p_data))
             p_data -> flags |= kMCDataFlagIsMutable;
         
@@ -412,7 +454,7 @@ bool MCDataMutableCopyAndRelease(MCDataRef p_data, MCDataRef& r_mutable_data)
     if (!MCDataMutableCopy(p_data, r_mutable_data))
         return false;
     
-    p_data -> references -= 1;
+    MCValueRelease(p_data);
     return true;
 }
 
@@ -434,6 +476,9 @@ bool MCDataCopyRange(MCDataRef self, MCRange p_range, MCDataRef& r_new_data)
         return true;
     }
     
+    if (__MCDataShouldSlice(self, p_range))
+        return __MCDataCreateSlice(self, p_range, r_new_data);
+    
     return MCDataCreateWithBytes(self -> bytes + p_range . offset, p_range . length, r_new_data);
 }
 
@@ -990,6 +1035,14 @@ void __MCDataDestroy(__MCData *self)
     {
         MCValueRelease(self -> contents);
     }
+    else if (__MCDataIsSlice(self))
+    {
+        MCValueRelease(self -> owner);
+    }
+    else if (__MCDataIsExternal(self))
+    {
+        self -> release(self -> bytes, self -> byte_count);
+    }
     else
     {
         if (self -> bytes != nil)
@@ -1077,7 +1130,9 @@ static bool __MCDataResolveIndirect(__MCData *self)
     
     // If the data ref only has a single reference, then re-absorb; otherwise
     // copy.
-    if (self -> contents -> references == 1)
+    if (self -> contents -> references == 1 &&
+        !__MCDataIsSlice(t_data) &&
+        !__MCDataIsExternal(t_data))
     {
         self -> byte_count = t_data -> byte_count;
         self -> capacity = t_data -> capacity;
@@ -1139,3 +1194,86 @@ static bool __MCDataCopyMutable(__MCData *self, __MCData*& r_new_data)
     return true;
 }
 
+
+////////////////////////////////////////////////////////////////////////////////
+
+// Ranges of immutable data refs can be slices, referencing the bytes of the
+// data they were taken from rather than copying them. A slice of a slice
+// references the bytes of the original owner.
+
+// Slices of owners no larger than this are always used.
+static const uindex_t kMCDataSliceMaxPinnedLength = 64 * 1024;
+
+// Otherwise, slices are only used if they contain at least this fraction of
+// the owner's bytes. Slices of external data are always used, as its bytes
+// (typically a file mapping) take no memory until they are touched.
+static const uindex_t kMCDataSliceMaxPinnedRatio = 16;
+
+static bool __MCDataIsSlice(__MCData *self)
+{
+    return (self -> flags & kMCDataFlagIsSlice) != 0;
+}
+
+static bool __MCDataShouldSlice(__MCData *self, MCRange p_range)
+{
+    // Only immutable bytes can be shared.
+    if (MCDataIsMutable(self) || p_range . length == 0)
+        return false;
+    
+    __MCData *t_owner;
+    t_owner = __MCDataIsSlice(self) ? self -> owner : self;
+    
+    uindex_t t_owner_length;
+    t_owner_length = t_owner -> byte_count;
+    
+    return __MCDataIsExternal(t_owner) ||
+            t_owner_length <= kMCDataSliceMaxPinnedLength ||
+            p_range . length >= t_owner_length / kMCDataSliceMaxPinnedRatio;
+}
+
+static bool __MCDataCreateSlice(__MCData *self, MCRange p_range, __MCData*& r_slice)
+{
+    MCDataRef t_slice;
+    if (!__MCValueCreate(kMCValueTypeCodeData, t_slice))
+        return false;
+    
+    t_slice -> byte_count = p_range . length;
+    t_slice -> bytes = self -> bytes + p_range . offset;
+    t_slice -> owner = MCValueRetain(__MCDataIsSlice(self) ? self -> owner : self);
+    t_slice -> flags |= kMCDataFlagIsSlice;
+    
+    r_slice = t_slice;
+    return true;
+}
+
+static bool __MCDataIsExternal(__MCData *self)
+{
+    return (self -> flags & kMCDataFlagIsExternal) != 0;
+}
+
+static bool __MCDataDetachBytes(__MCData *self)
+{
+    MCAssert(__MCDataIsSlice(self) || __MCDataIsExternal(self));
+    
+    byte_t *t_bytes;
+    if (!MCMemoryNewArray(self -> byte_count, t_bytes))
+        return false;
+    
+    MCMemoryCopy(t_bytes, self -> bytes, self -> byte_count);
+    
+    if (__MCDataIsSlice(self))
+    {
+        MCValueRelease(self -> owner);
+        self -> owner = nil;
+    }
+    else
+    {
+        self -> release(self -> bytes, self -> byte_count);
+        self -> release = nil;
+    }
+    
+    self -> bytes = t_bytes;
+    self -> flags &= ~(kMCDataFlagIsSlice | kMCDataFlagIsExternal);
+    
+    return true;
+}
@@ -16,6 +16,9 @@ along with LiveCode.  If not see <http://www.gnu.org/licenses/>.  */
 
 #include <foundation.h>
 
+#include <atomic>
+#include <mutex>
+
 #include "foundation-private.h"
 
 #include "foundation-string-hash.h"
@@ -28,17 +31,91 @@ MC_DLLEXPORT_DEF MCNameRef kMCFalseName;
 
 ////////////////////////////////////////////////////////////////////////////////
 
+/* NAME TABLE LOCKING
+ *
+ * If threading is enabled, each chain of the name table is guarded by one of
+ * a fixed set of locks, chosen by the low bits of the hash of the names in
+ * it. The capacity of the table is a power of two which is never less than
+ * the number of locks, so the lock guarding a name does not change as the
+ * table is resized - names are only moved between chains guarded by the same
+ * lock.
+ *
+ * Resizing the table (and reading its statistics) takes all the locks, in
+ * order. It is never done while holding one of the locks.
+ *
+ * The table does not hold references to the names in it, so one thread can
+ * release the last reference to a name while another finds it. Names are
+ * therefore only returned from the table if they can be retained with
+ * __MCValueTryRetain, and a name whose last reference has gone is ignored
+ * until it has been removed.
+ */
+
+static const uindex_t kMCNameTableLockCount = 64;
+static const uindex_t kMCNameTableMinCapacity = 1024;
+
 static MCNameRef *s_name_table;
-static uindex_t s_name_table_occupancy;
-static uindex_t s_name_table_capacity;
+static std::atomic<uindex_t> s_name_table_occupancy;
+static std::atomic<uindex_t> s_name_table_capacity;
+static std::atomic<uindex_t> s_name_table_name_count;
+static std::mutex s_name_table_locks[kMCNameTableLockCount];
 
 ////////////////////////////////////////////////////////////////////////////////
 
+static void __MCNameCheckTableCapacity(void);
 static void __MCNameGrowTable(void);
 static void __MCNameShrinkTable(void);
 
 ////////////////////////////////////////////////////////////////////////////////
 
+// Locks the chain of the name table which holds names with the given hash.
+class __MCNameTableChainLocker
+{
+public:
+    __MCNameTableChainLocker(hash_t p_hash)
+        : m_lock(nil)
+    {
+        if (__MCValueIsThreadingEnabled())
+        {
+            m_lock = &s_name_table_locks[p_hash & (kMCNameTableLockCount - 1)];
+            m_lock -> lock();
+        }
+    }
+    
+    ~__MCNameTableChainLocker(void)
+    {
+        if (m_lock != nil)
+            m_lock -> unlock();
+    }
+    
+private:
+    std::mutex *m_lock;
+};
+
+// Locks all the chains of the name table, so it can be resized or inspected.
+class __MCNameTableLocker
+{
+public:
+    __MCNameTableLocker(void)
+    {
+        if (!__MCValueIsThreadingEnabled())
+            return;
+        
+        for(uindex_t i = 0; i < kMCNameTableLockCount; i++)
+            s_name_table_locks[i] . lock();
+    }
+    
+    ~__MCNameTableLocker(void)
+    {
+        if (!__MCValueIsThreadingEnabled())
+            return;
+        
+        for(uindex_t i = kMCNameTableLockCount; i > 0; i--)
+            s_name_table_locks[i - 1] . unlock();
+    }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
 /* HASH VALUE STORAGE
  *
  * On 32-bit systems, the hash value is stored in a separate field in the
@@ -114,6 +191,25 @@ static inline void __MCNameSetNext(__MCName* p_name, __MCName* p_next)
 #endif
 }
 
+// Returns the bits of the name's hash which choose the lock guarding it. On
+// 64-bit systems these are the bits stored in the flags word, which (unlike
+// those in the next field) can be read before the name's chain is locked.
+static inline hash_t __MCNameGetLockHash(__MCName* p_name)
+{
+#ifdef __32_BIT__
+    return p_name->hash;
+#else
+    return p_name->flags & kMCValueFlagsNameHashMask;
+#endif
+}
+
+// Returns false if the last reference to the name has been released, and it is
+// waiting to be removed from the table.
+static inline bool __MCNameIsAlive(__MCName* p_name)
+{
+    return (__MCValueGetReferencesWord(p_name) & kMCValueReferencesCountMask) != 0;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 
 static void __MCNameIndexToNativeChars(index_t p_value, char_t r_chars[16], uindex_t& r_char_count)
@@ -182,33 +278,10 @@ static void __MCNameIndexToNativeChars(index_t p_value, char_t r_chars[16], uind
 
 static hash_t __MCNameIndexHash(const char_t *p_chars, uindex_t p_char_count)
 {
+    // Index chars are digits and a sign, so need no folding or mapping to
+    // unicode.
     MCHashCharsContext t_hash;
-    switch(p_char_count)
-    {
-    case 11:
-        t_hash.consume(*p_chars++);
-    case 10:
-        t_hash.consume(*p_chars++);
-    case 9:
-        t_hash.consume(*p_chars++);
-    case 8:
-        t_hash.consume(*p_chars++);
-    case 7:
-        t_hash.consume(*p_chars++);
-    case 6:
-        t_hash.consume(*p_chars++);
-    case 5:
-        t_hash.consume(*p_chars++);
-    case 4:
-        t_hash.consume(*p_chars++);
-    case 3:
-        t_hash.consume(*p_chars++);
-    case 2:
-        t_hash.consume(*p_chars++);
-    case 1:
-        t_hash.consume(*p_chars++);
-        break;
-    }
+    t_hash.consume(p_chars, p_char_count);
     return t_hash;
 }
 
@@ -247,100 +320,128 @@ bool MCNameCreate(MCStringRef p_string, MCNameRef& r_name)
     // Reduce the hash to the size we store
     t_hash = __MCNameReduceHash(t_hash);
 
-	// Calculate the index of the chain in the name table where this might be
-	// found. The capacity is always a power-of-two, so its just a mask op.
-	uindex_t t_index;
-	t_index = t_hash & (s_name_table_capacity - 1);
+	bool t_success;
+	t_success = true;
 
-	// Search for the first representation of the would-be name's equivalence
-	// class.
+	// The representative of the name's equivalence class, if one is found, is
+	// retained while it is in use. If no name is created its reference is
+	// released once the table is unlocked.
 	__MCName *t_key_name;
-	t_key_name = s_name_table[t_index];
-	while(t_key_name != nil)
-	{
-		// If the string matches, then we are done - notice we compare the
-		// full hash first.
-		if (t_hash == __MCNameGetHash(t_key_name) &&
-			MCStringIsEqualTo(p_string, t_key_name -> string, kMCStringOptionCompareCaseless))
-			break;
+	t_key_name = nil;
 
-		// Otherwise skip all other members of the same equivalence class.
-		while(__MCNameGetNext(t_key_name) != nil &&
-				__MCNameGetKey(t_key_name) == __MCNameGetKey(__MCNameGetNext(t_key_name)))
-            t_key_name = __MCNameGetNext(t_key_name);
+	{
+		__MCNameTableChainLocker t_locker(t_hash);
 
-        // Next name must be the next one.
-        t_key_name = __MCNameGetNext(t_key_name);
-	}
+		// Calculate the index of the chain in the name table where this might be
+		// found. The capacity is always a power-of-two, so its just a mask op.
+		uindex_t t_index;
+		t_index = t_hash & (s_name_table_capacity - 1);
 
-	// Now search within the equivalence class for one with the same string and
-	// return immediately if we find a match.
-	__MCName *t_name;
-	for(t_name = t_key_name; t_name != nil && __MCNameGetKey(t_name) == t_key_name; t_name = __MCNameGetNext(t_name))
-		if (MCStringIsEqualTo(p_string, t_name -> string, kMCStringOptionCompareExact))
+		// Search for the first representation of the would-be name's equivalence
+		// class.
+		t_key_name = s_name_table[t_index];
+		while(t_key_name != nil)
 		{
-			t_name -> references += 1;
-			r_name = t_name;
-			return true;
+			// If the string matches, then we are done - notice we compare the
+			// full hash first. A representative which is being destroyed has no
+			// other members, and is skipped.
+			if (t_hash == __MCNameGetHash(t_key_name) &&
+				MCStringIsEqualTo(p_string, t_key_name -> string, kMCStringOptionCompareCaseless) &&
+				__MCValueTryRetain(t_key_name))
+				break;
+
+			// Otherwise skip all other members of the same equivalence class.
+			while(__MCNameGetNext(t_key_name) != nil &&
+					__MCNameGetKey(t_key_name) == __MCNameGetKey(__MCNameGetNext(t_key_name)))
+				t_key_name = __MCNameGetNext(t_key_name);
+
+			// Next name must be the next one.
+			t_key_name = __MCNameGetNext(t_key_name);
 		}
 
-	// We haven't found an exact match, so we create a new name...
-	bool t_success;
-	t_success = true;
+		// Now search within the equivalence class for one with the same string and
+		// return immediately if we find a match. Other members hold a reference to
+		// the representative, so releasing ours cannot destroy it.
+		__MCName *t_name;
+		for(t_name = t_key_name; t_name != nil && __MCNameGetKey(t_name) == t_key_name; t_name = __MCNameGetNext(t_name))
+			if (MCStringIsEqualTo(p_string, t_name -> string, kMCStringOptionCompareExact))
+			{
+				if (t_name == t_key_name)
+				{
+					r_name = t_name;
+					return true;
+				}
+
+				if (__MCValueTryRetain(t_name))
+				{
+					MCValueRelease(t_key_name);
+					r_name = t_name;
+					return true;
+				}
+			}
 
-	// Allocate a name record.
-	if (t_success)
-		t_success = __MCValueCreate(kMCValueTypeCodeName, t_name);
+		// We haven't found an exact match, so we create a new name...
+		t_name = nil;
 
-	// Copy the string (as immutable).
-	if (t_success)
-		t_success = MCStringCopy(p_string, t_name -> string);
+		// Allocate a name record.
+		if (t_success)
+			t_success = __MCValueCreate(kMCValueTypeCodeName, t_name);
 
-	// Now add the name to the table and fill in the rest of the fields.
-	if (t_success)
-	{
-		// If there is no existing equivalence class, we chain at the start,
-		// otherwise we insert the name after the representative.
-		if (t_key_name == nil)
+		// Copy the string (as immutable).
+		if (t_success)
+			t_success = MCStringCopy(p_string, t_name -> string);
+
+		// Now add the name to the table and fill in the rest of the fields.
+		if (t_success)
 		{
-			// To keep hashin efficient, we (try to) double the size of the
-			// table each time occupancy reaches capacity.
-			if (s_name_table_occupancy == s_name_table_capacity)
+			// If there is no existing equivalence class, we chain at the start,
+			// otherwise we insert the name after the representative.
+			if (t_key_name == nil)
 			{
-				__MCNameGrowTable();
-				t_index = t_hash & (s_name_table_capacity - 1);
+				// Increase occupancy.
+				s_name_table_occupancy += 1;
+
+				__MCNameSetNext(t_name, s_name_table[t_index]);
+				__MCNameSetKey(t_name, t_name);
+				s_name_table[t_index] = t_name;
+			}
+			else
+			{
+				__MCNameSetNext(t_name, __MCNameGetNext(t_key_name));
+				__MCNameSetKey(t_name, t_key_name);
+				__MCNameSetNext(t_key_name, t_name);
+
+				// The reference to the representative is kept as we need it to
+				// 'hang around' for the entire lifetime of all others in the
+				// equivalence class to give a search handle.
+				t_key_name = nil;
 			}
 
-			// Increase occupancy.
-			s_name_table_occupancy += 1;
+			s_name_table_name_count += 1;
 
-            __MCNameSetNext(t_name, s_name_table[t_index]);
-            __MCNameSetKey(t_name, t_name);
-			s_name_table[t_index] = t_name;
+			// Record the hash (speeds up searching and such).
+			__MCNameSetHash(t_name, t_hash);
+
+			// Any thread can find the name, so it must be shared.
+			if (__MCValueIsThreadingEnabled())
+				__MCValueShare(t_name);
+
+			// Return the new name.
+			r_name = t_name;
 		}
-		else
+		else if (t_name != nil)
 		{
-            __MCNameSetNext(t_name, __MCNameGetNext(t_key_name));
-            __MCNameSetKey(t_name, t_key_name);
-            __MCNameSetNext(t_key_name, t_name);
-
-			// Increment the reference count of the representative as we need
-			// it to 'hang around' for the entire lifetime of all others in the
-			// equivalence class to give a search handle.
-			t_key_name -> references += 1;
+			MCValueRelease(t_name -> string);
+			MCMemoryDelete(t_name);
 		}
+	}
 
-		// Record the hash (speeds up searching and such).
-        __MCNameSetHash(t_name, t_hash);
+	if (t_key_name != nil)
+		MCValueRelease(t_key_name);
 
-		// Return the new name.
-		r_name = t_name;
-	}
-	else
-	{
-		MCValueRelease(t_name -> string);
-		MCMemoryDelete(t_name);
-	}
+	// To keep hashing efficient, the table doubles in size when occupancy
+	// exceeds capacity.
+	__MCNameCheckTableCapacity();
 
 	return t_success;
 }
@@ -359,75 +460,82 @@ bool MCNameCreateWithIndex(index_t p_index, MCNameRef& r_name)
     // Reduce the hash to the size we store
     t_hash = __MCNameReduceHash(t_hash);
     
-    // Calculate the index of the chain in the name table where this might be
-    // found. The capacity is always a power-of-two, so its just a mask op.
-    uindex_t t_index;
-    t_index = t_hash & (s_name_table_capacity - 1);
-    
-    // Search for the first representation of the would-be name's equivalence
-    // class.
-    __MCName *t_key_name;
-    t_key_name = s_name_table[t_index];
-    while(t_key_name != nil)
-    {
-        // If the string matches, then we are done - notice we compare the
-        // full hash first.
-        if (t_hash == __MCNameGetHash(t_key_name) &&
-            __MCNameGetKey(t_key_name) == t_key_name &&
-            MCStringIsEqualToNativeChars(t_key_name -> string, t_chars, t_char_count, kMCStringOptionCompareExact))
-        {
-            t_key_name -> references += 1;
-            r_name = t_key_name;
-            return true;
-        }
-        
-        // Next name must be the next one.
-        t_key_name = __MCNameGetNext(t_key_name);
-    }
-    
-    // We haven't found an exact match, so we create a new name...
     bool t_success;
     t_success = true;
     
-    // Allocate a name record.
-    __MCName *t_name;
-    if (t_success)
-        t_success = __MCValueCreate(kMCValueTypeCodeName, t_name);
-    
-    // Copy the string (as immutable).
-    if (t_success)
-        t_success = MCStringCreateWithNativeChars(t_chars, t_char_count, t_name -> string);
-    
-    // Now add the name to the table and fill in the rest of the fields.
-    if (t_success)
     {
-        // To keep hashin efficient, we (try to) double the size of the
-        // table each time occupancy reaches capacity.
-        if (s_name_table_occupancy == s_name_table_capacity)
+        __MCNameTableChainLocker t_locker(t_hash);
+        
+        // Calculate the index of the chain in the name table where this might be
+        // found. The capacity is always a power-of-two, so its just a mask op.
+        uindex_t t_index;
+        t_index = t_hash & (s_name_table_capacity - 1);
+        
+        // Search for the first representation of the would-be name's equivalence
+        // class.
+        __MCName *t_key_name;
+        t_key_name = s_name_table[t_index];
+        while(t_key_name != nil)
         {
-            __MCNameGrowTable();
-            t_index = t_hash & (s_name_table_capacity - 1);
+            // If the string matches, then we are done - notice we compare the
+            // full hash first.
+            if (t_hash == __MCNameGetHash(t_key_name) &&
+                __MCNameGetKey(t_key_name) == t_key_name &&
+                MCStringIsEqualToNativeChars(t_key_name -> string, t_chars, t_char_count, kMCStringOptionCompareExact) &&
+                __MCValueTryRetain(t_key_name))
+            {
+                r_name = t_key_name;
+                return true;
+            }
+            
+            // Next name must be the next one.
+            t_key_name = __MCNameGetNext(t_key_name);
         }
         
-        // Increase occupancy.
-        s_name_table_occupancy += 1;
+        // We haven't found an exact match, so we create a new name...
+        __MCName *t_name;
+        t_name = nil;
         
-        __MCNameSetNext(t_name, s_name_table[t_index]);
-        __MCNameSetKey(t_name, t_name);
-        s_name_table[t_index] = t_name;
-
-        // Record the hash (speeds up searching and such).
-        __MCNameSetHash(t_name, t_hash);
+        // Allocate a name record.
+        if (t_success)
+            t_success = __MCValueCreate(kMCValueTypeCodeName, t_name);
         
-        // Return the new name.
-        r_name = t_name;
-    }
-    else
-    {
-        MCValueRelease(t_name -> string);
-        MCMemoryDelete(t_name);
+        // Copy the string (as immutable).
+        if (t_success)
+            t_success = MCStringCreateWithNativeChars(t_chars, t_char_count, t_name -> string);
+        
+        // Now add the name to the table and fill in the rest of the fields.
+        if (t_success)
+        {
+            // Increase occupancy.
+            s_name_table_occupancy += 1;
+            s_name_table_name_count += 1;
+            
+            __MCNameSetNext(t_name, s_name_table[t_index]);
+            __MCNameSetKey(t_name, t_name);
+            s_name_table[t_index] = t_name;
+
+            // Record the hash (speeds up searching and such).
+            __MCNameSetHash(t_name, t_hash);
+            
+            // Any thread can find the name, so it must be shared.
+            if (__MCValueIsThreadingEnabled())
+                __MCValueShare(t_name);
+            
+            // Return the new name.
+            r_name = t_name;
+        }
+        else if (t_name != nil)
+        {
+            MCValueRelease(t_name -> string);
+            MCMemoryDelete(t_name);
+        }
     }
     
+    // To keep hashing efficient, the table doubles in size when occupancy
+    // exceeds capacity.
+    __MCNameCheckTableCapacity();
+    
     return t_success;
 }
 
@@ -476,6 +584,8 @@ MCNameRef MCNameLookupCaseless(MCStringRef p_string)
     // Reduce the hash to the size we store
     t_hash = __MCNameReduceHash(t_hash);
     
+    __MCNameTableChainLocker t_locker(t_hash);
+    
 	// Calculate the index of the chain in the name table where this name might
 	// be found. The capacity is always a power-of-two, so its just a mask op.
 	uindex_t t_index;
@@ -489,7 +599,8 @@ MCNameRef MCNameLookupCaseless(MCStringRef p_string)
 		// If the string matches, then we are done - notice we compare the full
 		// hash first.
 		if (t_hash == __MCNameGetHash(t_key_name) &&
-			MCStringIsEqualTo(p_string, t_key_name -> string, kMCStringOptionCompareCaseless))
+			MCStringIsEqualTo(p_string, t_key_name -> string, kMCStringOptionCompareCaseless) &&
+			__MCNameIsAlive(t_key_name))
 			break;
 
         // Otherwise skip all other members of the same equivalence class.
@@ -517,6 +628,8 @@ MCNameRef MCNameLookupIndex(index_t p_index)
     // Reduce the hash to the size we store
     t_hash = __MCNameReduceHash(t_hash);
     
+    __MCNameTableChainLocker t_locker(t_hash);
+    
     // Calculate the index of the chain in the name table where this name might
     // be found. The capacity is always a power-of-two, so its just a mask op.
     uindex_t t_index;
@@ -532,7 +645,8 @@ MCNameRef MCNameLookupIndex(index_t p_index)
         // use exact comparison.
         if (t_hash == __MCNameGetHash(t_key_name) &&
             __MCNameGetKey(t_key_name) == t_key_name &&
-            MCStringIsEqualToNativeChars(t_key_name -> string, t_chars, t_char_count, kMCStringOptionCompareExact))
+            MCStringIsEqualToNativeChars(t_key_name -> string, t_chars, t_char_count, kMCStringOptionCompareExact) &&
+            __MCNameIsAlive(t_key_name))
             break;
         
         // Next name must be the next one
@@ -594,39 +708,44 @@ bool MCNameIsEqualTo(MCNameRef self, MCNameRef p_other_name, MCStringOptions p_o
 
 void __MCNameDestroy(__MCName *self)
 {
-	// Compute the index in the table
-	uindex_t t_index;
-	t_index = __MCNameGetHash(self) & (s_name_table_capacity - 1);
-
-	// Find the previous link in the chain
-	__MCName *t_previous;
-	t_previous = nil;
-	for(__MCName *t_name = s_name_table[t_index]; t_name != self; t_name = __MCNameGetNext(t_name))
-		t_previous = t_name;
-
-	// Update the previous name's next field
-	if (t_previous == nil)
-		s_name_table[t_index] = __MCNameGetNext(self);
-	else
-        __MCNameSetNext(t_previous, __MCNameGetNext(self));
-
-	// If this name is not the key then remove our reference to it. Otherwise
-	// adjust occupancy appropriately.
-	if (__MCNameGetKey(self) != self)
-		MCValueRelease(__MCNameGetKey(self));
-	else
+	__MCName *t_key;
 	{
-		// Reduce occupancy of the table
-		s_name_table_occupancy -= 1;
+		__MCNameTableChainLocker t_locker(__MCNameGetLockHash(self));
 
-		// If the table is too sparse, reduce its size (current heuristic has the
-		// threshold at 33%).
-		if (s_name_table_capacity > 1024 && s_name_table_occupancy * 16 / s_name_table_capacity < 5)
-			__MCNameShrinkTable();
+		// Compute the index in the table
+		uindex_t t_index;
+		t_index = __MCNameGetHash(self) & (s_name_table_capacity - 1);
+
+		// Find the previous link in the chain
+		__MCName *t_previous;
+		t_previous = nil;
+		for(__MCName *t_name = s_name_table[t_index]; t_name != self; t_name = __MCNameGetNext(t_name))
+			t_previous = t_name;
+
+		// Update the previous name's next field
+		if (t_previous == nil)
+			s_name_table[t_index] = __MCNameGetNext(self);
+		else
+			__MCNameSetNext(t_previous, __MCNameGetNext(self));
+
+		// If this name is the key then adjust occupancy appropriately.
+		t_key = __MCNameGetKey(self);
+		if (t_key == self)
+			s_name_table_occupancy -= 1;
+
+		s_name_table_name_count -= 1;
 	}
 
+	// If this name is not the key then remove our reference to it (once the
+	// table is unlocked, as it might be destroyed).
+	if (t_key != self)
+		MCValueRelease(t_key);
+
 	// Delete the resources
 	MCValueRelease(self -> string);
+
+	// If the table is too sparse, reduce its size.
+	__MCNameCheckTableCapacity();
 }
 
 bool __MCNameCopyDescription(__MCName *self, MCStringRef& r_string)
@@ -705,31 +824,105 @@ static void __MCNameRelocateTableEntries(uindex_t p_start, uindex_t p_finish, ui
 static void __MCNameGrowTable(void)
 {
 	// First attempt to double the table size.
-	if (!MCMemoryResizeArray(s_name_table_capacity * 2, s_name_table, s_name_table_capacity))
+	uindex_t t_capacity;
+	t_capacity = s_name_table_capacity;
+	if (!MCMemoryResizeArray(t_capacity * 2, s_name_table, t_capacity))
 		return;
 
 	// Now relocate any entries from the used half that need to be moved to the
 	// upper half (another bit has become available to determine spread).
-	__MCNameRelocateTableEntries(0, s_name_table_capacity / 2, s_name_table_capacity);
+	__MCNameRelocateTableEntries(0, t_capacity / 2, t_capacity);
+	s_name_table_capacity = t_capacity;
 }
 
 static void __MCNameShrinkTable(void)
 {
 	// First relocate any entries from the upper half of the table to the lower
 	// half (a bit has been removed from that which determines spread).
-	__MCNameRelocateTableEntries(s_name_table_capacity / 2, s_name_table_capacity, s_name_table_capacity / 2);
+	uindex_t t_capacity;
+	t_capacity = s_name_table_capacity;
+	__MCNameRelocateTableEntries(t_capacity / 2, t_capacity, t_capacity / 2);
+
+	// Now resize the array - if this fails, the upper half is just left
+	// unused.
+	uindex_t t_new_capacity;
+	t_new_capacity = t_capacity / 2;
+	MCMemoryResizeArray(t_new_capacity, s_name_table, t_capacity);
+	s_name_table_capacity = t_new_capacity;
+}
+
+// The table is grown when there are more equivalence classes than chains,
+// and shrunk (to no less than its initial capacity) when there are fewer than
+// a third as many.
+static bool __MCNameTableIsTooFull(void)
+{
+	return s_name_table_occupancy > s_name_table_capacity;
+}
+
+static bool __MCNameTableIsTooSparse(void)
+{
+	return s_name_table_capacity > kMCNameTableMinCapacity &&
+			s_name_table_occupancy * 16 / s_name_table_capacity < 5;
+}
+
+static void __MCNameCheckTableCapacity(void)
+{
+	if (!__MCNameTableIsTooFull() && !__MCNameTableIsTooSparse())
+		return;
+
+	// The checks are repeated with the table locked, as another thread might
+	// have resized it first.
+	__MCNameTableLocker t_locker;
 
-	// Now resize the array.
-	MCMemoryResizeArray(s_name_table_capacity / 2, s_name_table, s_name_table_capacity);
+	if (__MCNameTableIsTooFull())
+		__MCNameGrowTable();
+
+	while(__MCNameTableIsTooSparse())
+		__MCNameShrinkTable();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+MC_DLLEXPORT_DEF
+void MCNameGetTableStatistics(MCNameTableStatistics& r_statistics)
+{
+	__MCNameTableLocker t_locker;
+
+	MCMemoryClear(r_statistics);
+	r_statistics . name_count = s_name_table_name_count;
+	r_statistics . class_count = s_name_table_occupancy;
+	r_statistics . chain_count = s_name_table_capacity;
+
+	for(uindex_t i = 0; i < s_name_table_capacity; i++)
+	{
+		uindex_t t_length;
+		t_length = 0;
+		for(__MCName *t_name = s_name_table[i]; t_name != nil; t_name = __MCNameGetNext(t_name))
+			t_length += 1;
+
+		if (t_length != 0)
+			r_statistics . used_chain_count += 1;
+
+		if (t_length > r_statistics . longest_chain_length)
+			r_statistics . longest_chain_length = t_length;
+	}
+
+	r_statistics . memory_size = s_name_table_capacity * sizeof(MCNameRef) +
+			s_name_table_name_count * sizeof(__MCName);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
 bool __MCNameInitialize(void)
 {
-	if (!MCMemoryNewArray(1024, s_name_table, s_name_table_capacity))
+	uindex_t t_capacity;
+	if (!MCMemoryNewArray(kMCNameTableMinCapacity, s_name_table, t_capacity))
 		return false;
 
+	s_name_table_capacity = t_capacity;
+	s_name_table_occupancy = 0;
+	s_name_table_name_count = 0;
+
 	if (!MCNameCreate(kMCEmptyString, kMCEmptyName))
 		return false;
 
@@ -739,8 +932,6 @@ bool __MCNameInitialize(void)
 	if (!MCNameCreate(kMCFalseString, kMCFalseName))
 		return false;
 
-	s_name_table_occupancy = 0;
-
 	return true;
 }
 
@@ -759,6 +950,7 @@ void __MCNameFinalize(void)
 	s_name_table = nil;
 	s_name_table_capacity = 0;
 	s_name_table_occupancy = 0;
+	s_name_table_name_count = 0;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -31,8 +31,21 @@ static bool __MCNumberParseUnicodeChars(const unichar_t *p_chars, uindex_t p_cha
 
 ////////////////////////////////////////////////////////////////////////////////
 
-MC_DLLEXPORT_DEF
-bool MCNumberCreateWithInteger(integer_t p_value, MCNumberRef& r_number)
+// Integers in this range are created once and then shared, so the (mostly
+// short-lived) numbers produced by counting and arithmetic don't need to be
+// allocated and destroyed each time. The cache holds a reference to each
+// number it contains, so they live until the number module is finalized.
+static const integer_t kMCNumberCacheMin = -1024;
+static const integer_t kMCNumberCacheMax = 65535;
+
+static MCNumberRef *s_number_cache;
+
+// Script arithmetic is done in doubles, so integral reals in the same range
+// have a cache of their own. They can't come from the integer cache as they
+// must still be reals (they are formatted differently, for one).
+static MCNumberRef *s_real_number_cache;
+
+static bool __MCNumberCreateWithInteger(integer_t p_value, MCNumberRef& r_number)
 {
 	__MCNumber *self;
 	if (!__MCValueCreate(kMCValueTypeCodeNumber, self))
@@ -46,7 +59,22 @@ bool MCNumberCreateWithInteger(integer_t p_value, MCNumberRef& r_number)
 }
 
 MC_DLLEXPORT_DEF
-bool MCNumberCreateWithReal(real64_t p_value, MCNumberRef& r_number)
+bool MCNumberCreateWithInteger(integer_t p_value, MCNumberRef& r_number)
+{
+    if (p_value < kMCNumberCacheMin || p_value > kMCNumberCacheMax ||
+        s_number_cache == nil)
+        return __MCNumberCreateWithInteger(p_value, r_number);
+    
+    MCNumberRef& t_cached = s_number_cache[p_value - kMCNumberCacheMin];
+    if (t_cached == nil &&
+        !__MCNumberCreateWithInteger(p_value, t_cached))
+        return false;
+    
+    r_number = MCValueRetain(t_cached);
+    return true;
+}
+
+static bool __MCNumberCreateWithReal(real64_t p_value, MCNumberRef& r_number)
 {
 	__MCNumber *self;
 	if (!__MCValueCreate(kMCValueTypeCodeNumber, self))
@@ -60,6 +88,30 @@ bool MCNumberCreateWithReal(real64_t p_value, MCNumberRef& r_number)
 	return true;
 }
 
+MC_DLLEXPORT_DEF
+bool MCNumberCreateWithReal(real64_t p_value, MCNumberRef& r_number)
+{
+    // NaN fails both range checks; -0.0 is excluded as it is distinct from
+    // 0.0 but compares equal to it.
+    if (s_real_number_cache == nil ||
+        !(p_value >= kMCNumberCacheMin && p_value <= kMCNumberCacheMax) ||
+        (p_value == 0.0 && signbit(p_value)))
+        return __MCNumberCreateWithReal(p_value, r_number);
+    
+    integer_t t_integer;
+    t_integer = (integer_t)p_value;
+    if ((real64_t)t_integer != p_value)
+        return __MCNumberCreateWithReal(p_value, r_number);
+    
+    MCNumberRef& t_cached = s_real_number_cache[t_integer - kMCNumberCacheMin];
+    if (t_cached == nil &&
+        !__MCNumberCreateWithReal(p_value, t_cached))
+        return false;
+    
+    r_number = MCValueRetain(t_cached);
+    return true;
+}
+
 MC_DLLEXPORT_DEF
 bool MCNumberCreateWithUnsignedInteger(uinteger_t p_value, MCNumberRef& r_number)
 {
@@ -278,8 +330,10 @@ static bool __MCNumberParseNativeString(const char *p_string, uindex_t p_length,
     {
         errno = 0;
         
+        const char *t_real_end;
         real64_t t_real;
-        t_real = strtod(p_string, &t_end);
+        t_real = MCTypeConvertCStringToReal(p_string, t_real_end);
+        t_end = const_cast<char *>(t_real_end);
         
         // SN-2014-10-06: [[ Bug 13594 ]] check that no error was encountered
         t_success = (errno != ERANGE) && (p_full_string ? (t_end - p_string == (ptrdiff_t)p_length) : (t_end != t_string));
@@ -370,6 +424,22 @@ MC_DLLEXPORT_DEF MCNumberRef kMCMinusOne;
 
 bool __MCNumberInitialize(void)
 {
+    if (!MCMemoryNewArray(kMCNumberCacheMax - kMCNumberCacheMin + 1, s_number_cache))
+        return false;
+    
+    // If threading is enabled, any thread can fetch numbers from the cache so
+    // it is filled (with shared numbers) up front.
+    if (__MCValueIsThreadingEnabled())
+    {
+        for(integer_t i = 0; i <= kMCNumberCacheMax - kMCNumberCacheMin; i++)
+            if (!__MCNumberCreateWithInteger(kMCNumberCacheMin + i, s_number_cache[i]))
+                return false;
+    }
+    // The real cache is only used single-threaded, rather than doubling the
+    // numbers created up front.
+    else if (!MCMemoryNewArray(kMCNumberCacheMax - kMCNumberCacheMin + 1, s_real_number_cache))
+        return false;
+    
     if (!MCNumberCreateWithInteger(0, kMCZero))
         return false;
     
@@ -387,6 +457,19 @@ void __MCNumberFinalize(void)
     MCValueRelease(kMCZero);
     MCValueRelease(kMCOne);
     MCValueRelease(kMCMinusOne);
+    
+    for(integer_t i = 0; i <= kMCNumberCacheMax - kMCNumberCacheMin; i++)
+        MCValueRelease(s_number_cache[i]);
+    MCMemoryDeleteArray(s_number_cache);
+    s_number_cache = nil;
+    
+    if (s_real_number_cache != nil)
+    {
+        for(integer_t i = 0; i <= kMCNumberCacheMax - kMCNumberCacheMin; i++)
+            MCValueRelease(s_real_number_cache[i]);
+        MCMemoryDeleteArray(s_real_number_cache);
+        s_real_number_cache = nil;
+    }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
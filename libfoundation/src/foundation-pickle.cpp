@@ -100,6 +100,18 @@ static bool MCPickleReadStringRef(MCStreamRef stream, MCStringRef& r_value)
     if (!MCPickleReadCompactUInt(stream, t_length))
         return failed();
     
+    // If the stream's contents are in memory, the string can be decoded
+    // directly from them rather than from a copy.
+    if (MCStreamIsMapped(stream))
+    {
+        const void *t_view;
+        if (!MCStreamReadBytes(stream, t_length, t_view) ||
+            !MCStringCreateWithBytes((const byte_t *)t_view, t_length, kMCStringEncodingUTF8, false, r_value))
+            return failed();
+        
+        return true;
+    }
+    
     uint8_t *t_bytes;
     if (!MCMemoryNewArray(t_length, t_bytes))
         return failed();
@@ -19,6 +19,7 @@ along with LiveCode.  If not see <http://www.gnu.org/licenses/>.  */
 
 
 #include <stdio.h>
+#include <atomic>
 #include <utility>
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -50,6 +51,14 @@ enum
     kMCValueFlagsNameHashMask = (1 << kMCValueFlagsNameHashBits) - 1,
 };
 
+// References word:
+//   31 : is_shared
+//   30...0 : count
+//
+// Values shared between threads have their reference count updated atomically.
+static const uint32_t kMCValueReferencesIsShared = 1U << 31;
+static const uint32_t kMCValueReferencesCountMask = ~kMCValueReferencesIsShared;
+
 struct __MCValue
 {
 	uint32_t references;
@@ -176,7 +185,15 @@ enum
     // If set, the string has been converted to a number
     kMCStringFlagHasNumber = 1 << 6,
     // If set, indicates that the string can be losslessly nativized
-    kMCStringFlagCanBeNative = 1 << 7
+    kMCStringFlagCanBeNative = 1 << 7,
+    // If set, the string may have entries in the delimiter index cache
+    kMCStringFlagHasDelimiterIndex = 1 << 8,
+    // If set, the (indirect) string is a rope
+    kMCStringFlagIsRope = 1 << 9,
+    // If set, the (immutable) string's chars are within those of its owner
+    kMCStringFlagIsSlice = 1 << 10,
+    // If set, the string may have entries in the break index cache
+    kMCStringFlagHasBreakIndex = 1 << 11
 };
 
 enum
@@ -250,11 +267,14 @@ typedef unichar_t strchar_t;
 #define MCStrCharsHashNonliteral(x, y) MCUnicodeHash(x, y, kMCUnicodeCompareOptionNormalised)
 #define MCStrCharsHashFolded(x, y) MCUnicodeHash(x, y, kMCUnicodeCompareOptionFolded)
 
+struct __MCStringRope;
+
 struct __MCString: public __MCValue
 {
     union
     {
         MCStringRef string;
+        __MCStringRope *rope;
         struct
         {
 #ifdef __32_BIT__
@@ -264,7 +284,12 @@ struct __MCString: public __MCValue
                 unichar_t *chars;
                 char_t *native_chars;
             };
-            double numeric_value;
+            union
+            {
+                double numeric_value;
+                // The string owning the chars of a slice.
+                MCStringRef owner;
+            };
             uindex_t capacity;
             /* The padding is here to ensure the size of the struct is 32-bytes
              * on all platforms. This ensures consistency between Win and UNIX
@@ -279,12 +304,22 @@ struct __MCString: public __MCValue
                 unichar_t *chars;
                 char_t *native_chars;
             };
-            double numeric_value;
+            union
+            {
+                double numeric_value;
+                // The string owning the chars of a slice.
+                MCStringRef owner;
+            };
 #endif
         };
     };
 };
 
+// String values are allocated with this many bytes following the __MCString
+// struct. Short immutable native strings keep their chars (and implicit NUL)
+// there, rather than in a separate allocation.
+static const uindex_t kMCStringInlineCapacity = 16;
+
 //////////
 
 enum
@@ -293,6 +328,11 @@ enum
     kMCDataFlagIsMutable = 1 << 0,
     // The data are indirect (i.e. contents is within another immutable data ref).
     kMCDataFlagIsIndirect = 1 << 1,
+    // The (immutable) data's bytes are within those of its owner.
+    kMCDataFlagIsSlice = 1 << 2,
+    // The (immutable) data's bytes are owned elsewhere and freed by its
+    // release callback.
+    kMCDataFlagIsExternal = 1 << 3,
 };
 
 // AL-2014-11-12: [[ Bug 13987 ]] Implement copy on write for MCDataRef
@@ -306,6 +346,13 @@ struct __MCData: public __MCValue
             uindex_t byte_count;
             uindex_t capacity;
             byte_t *bytes;
+            union
+            {
+                // The data owning the bytes of a slice.
+                MCDataRef owner;
+                // The function freeing the bytes of external data.
+                MCDataReleaseBytesCallback release;
+            };
         };
     };
 };
@@ -337,6 +384,28 @@ enum
 	// If set then the array is indirect (i.e. contents is within another
 	// immutable array).
 	kMCArrayFlagIsIndirect = 1 << 7,
+	// If set then the array is dense - its keys are exactly 1..n and the
+	// values are stored in key order in a vector rather than a hash table.
+	kMCArrayFlagIsDense = 1 << 8,
+	// If set then the dense array's vector is followed by the names of its
+	// keys (created on demand for key iteration).
+	kMCArrayFlagHasDenseKeys = 1 << 9,
+};
+
+// The hash table of a (non-dense) array is a single block holding a power of
+// two number of key-value slots, followed by a control byte for each slot
+// (padded to at least one group). A control byte is either empty, deleted or
+// holds the top bit together with 7 bits of the key's hash - so most probes
+// can be rejected without looking at the key at all.
+enum
+{
+	kMCArrayControlEmpty = 0x00,
+	kMCArrayControlDeleted = 0x01,
+	kMCArrayControlFull = 0x80,
+	kMCArrayControlHashMask = 0x7f,
+
+	// The number of control bytes which are probed together.
+	kMCArrayControlGroupWidth = 16,
 };
 
 struct __MCArrayKeyValue
@@ -352,8 +421,16 @@ struct __MCArray: public __MCValue
 		MCArrayRef contents;
 		struct
 		{
-			__MCArrayKeyValue *key_values;
+			union
+			{
+				__MCArrayKeyValue *key_values;
+				MCValueRef *dense_values;
+			};
 			uindex_t key_value_count;
+			// The number of deleted slots in the key-value table (always 0
+			// for a dense array). Probes pass over them, so they count
+			// towards the load of the table.
+			uindex_t deleted_count;
 		};
 	};
 };
@@ -393,8 +470,13 @@ enum
     // If set then the list is indirect (i.e. contents is within another
 	// immutable list).
 	kMCProperListFlagIsIndirect = 1 << 1,
+    // If set then the (direct) list's elements are held in a tree of nodes
+    // which may be shared with other lists, rather than in a flat array.
+    kMCProperListFlagIsTree = 1 << 2,
 };
 
+struct __MCProperListNode;
+
 struct __MCProperList: public __MCValue
 {
 	union
@@ -402,8 +484,15 @@ struct __MCProperList: public __MCValue
 		MCProperListRef contents;
         struct
         {
-            MCValueRef *list;
+            union
+            {
+                MCValueRef *list;
+                // The root node of a tree list.
+                __MCProperListNode *root;
+            };
             uindex_t length;
+            // The position of a tree list's first element within the tree.
+            uindex_t offset;
         };
 	};
 };
@@ -485,6 +574,108 @@ inline MCValueTypeCode __MCValueGetTypeCode(__MCValue *self)
 	return (self -> flags >> 28);
 }
 
+// Returns the references word of the value, which other threads may be
+// updating if it is shared.
+inline uint32_t __MCValueGetReferencesWord(__MCValue *self)
+{
+#if defined(_MSC_VER)
+    return *static_cast<volatile uint32_t *>(&self -> references);
+#else
+    return __atomic_load_n(&self -> references, __ATOMIC_RELAXED);
+#endif
+}
+
+inline bool __MCValueIsShared(__MCValue *self)
+{
+    return (__MCValueGetReferencesWord(self) & kMCValueReferencesIsShared) != 0;
+}
+
+// Returns true if values may be used by more than one thread.
+bool __MCValueIsThreadingEnabled(void);
+
+// If threading is enabled, values created until this is called again with
+// false are shared. This is used while the constant values are created.
+void __MCValueSetCreateShared(bool p_shared);
+
+// Adds to an accounting count, returning the new count. Unless values may be
+// used by more than one thread the update needn't be atomic, which is
+// considerably cheaper.
+template<typename T>
+inline T __MCAccountingAdd(std::atomic<T>& x_count, T p_delta, bool p_atomic)
+{
+    if (p_atomic)
+        return x_count . fetch_add(p_delta, std::memory_order_relaxed) + p_delta;
+    
+    T t_count = x_count . load(std::memory_order_relaxed) + p_delta;
+    x_count . store(t_count, std::memory_order_relaxed);
+    return t_count;
+}
+
+// A count of live objects or bytes which also records the most it has
+// reached.
+struct __MCAccountingCounter
+{
+    std::atomic<int64_t> current;
+    std::atomic<int64_t> peak;
+    
+    void Add(int64_t p_delta, bool p_atomic)
+    {
+        int64_t t_current = __MCAccountingAdd(current, p_delta, p_atomic);
+        int64_t t_peak = peak . load(std::memory_order_relaxed);
+        while(t_current > t_peak &&
+              !peak . compare_exchange_weak(t_peak, t_current, std::memory_order_relaxed))
+            ;
+    }
+    
+    // Objects which existed before accounting was enabled can take the count
+    // below zero, so it is clamped when read.
+    uint64_t GetCurrent(void) const
+    {
+        int64_t t_current = current . load(std::memory_order_relaxed);
+        return t_current > 0 ? uint64_t(t_current) : 0;
+    }
+    
+    uint64_t GetPeak(void) const
+    {
+        return uint64_t(peak . load(std::memory_order_relaxed));
+    }
+};
+
+// Enables the accounting of blocks allocated by the MCMemory functions.
+void __MCMemoryEnableAccounting(void);
+
+// Returns the number of bytes the allocator reserved for the block, or 0 if
+// this can't be determined on the current platform.
+size_t __MCMemoryGetBlockSize(void *block);
+
+// Marks the value, and any it contains, as shared between threads.
+void __MCValueShare(__MCValue *value);
+
+// Retains the value unless its last reference has already been released,
+// returning false if it has. This is used when finding values through tables
+// which do not hold references to them, as a value can be released by one
+// thread while another finds it.
+bool __MCValueTryRetain(__MCValue *value);
+
+// Locks (recursively) the table through which any thread can find interred
+// values, if threading is enabled.
+void __MCValueLockTables(void);
+void __MCValueUnlockTables(void);
+
+class __MCValueTablesLocker
+{
+public:
+    __MCValueTablesLocker(void)
+    {
+        __MCValueLockTables();
+    }
+    
+    ~__MCValueTablesLocker(void)
+    {
+        __MCValueUnlockTables();
+    }
+};
+
 template<class T> inline bool __MCValueCreate(MCValueTypeCode p_type_code, T*& r_value)
 {
 	__MCValue *t_value;
@@ -658,6 +849,18 @@ void MCUnicodeCharsMapFromNative(const char_t *chars, uindex_t char_count, unich
 
 uindex_t MCUnicodeCharsMapToUTF8(const unichar_t *wchars, uindex_t wchar_count, byte_t *utf8bytes, uindex_t utf8byte_count);
 uindex_t MCUnicodeCharsMapFromUTF8(const byte_t *utf8bytes, uindex_t utf8byte_count, unichar_t *wchars, uindex_t wchar_count);
+bool MCUnicodeCharsMapFromUTF8ToNative(const byte_t *utf8bytes, uindex_t utf8byte_count, char_t *nchars, uindex_t& r_nchar_count);
+uindex_t MCNativeCharsMapToUTF8(const char_t *nchars, uindex_t nchar_count, byte_t *utf8bytes, uindex_t utf8byte_count);
+
+// Returns the length of the run of ASCII chars at the start of the given bytes
+// (or UTF-16 code units).
+size_t __MCUnicodeAsciiLength(const byte_t *bytes, size_t count);
+size_t __MCUnicodeAsciiLengthOfChars(const unichar_t *chars, size_t count);
+
+// Zero-extends bytes to UTF-16 code units, and narrows code units (which must
+// be less than 256) to bytes.
+void __MCUnicodeWidenBytes(const byte_t *bytes, size_t count, unichar_t *r_chars);
+void __MCUnicodeNarrowChars(const unichar_t *chars, size_t count, byte_t *r_bytes);
 
 bool MCUnicodeCharMapToNative(unichar_t uchar, char_t& r_nchar);
 char_t MCUnicodeCharMapToNativeLossy(unichar_t nchar);
@@ -677,7 +880,7 @@ __MCAssertResolvedTypeInfo(MCTypeInfoRef x, bool (*p)(MCTypeInfoRef))
 #define __MCAssertValueType(x,T) MCAssert(MCValueGetTypeCode(x) == kMCValueTypeCode##T)
 
 // A valid ValueRef must have references > 0 and flags != -1
-#define __MCAssertIsValue(x)    MCAssert(((__MCValue *)x) -> flags != UINT32_MAX && ((__MCValue *)x) -> references > 0);
+#define __MCAssertIsValue(x)    MCAssert(((__MCValue *)x) -> flags != UINT32_MAX && __MCValueGetReferencesWord((__MCValue *)x) > 0);
 
 #define __MCAssertIsNumber(x)   __MCAssertValueType(x,Number)
 #define __MCAssertIsName(x)     __MCAssertValueType(x,Name)
@@ -20,8 +20,71 @@ along with LiveCode.  If not see <http://www.gnu.org/licenses/>.  */
 
 #include "foundation-private.h"
 
+#include <atomic>
+
 ////////////////////////////////////////////////////////////////////////////////
 
+// Large lists which are shared (e.g. by being pushed onto after being copied)
+// are held as a persistent vector: a tree of fixed size nodes, in which each
+// node may be shared by many lists. Changing an element of a tree list copies
+// only the nodes on the path to it, so pushing onto the back of a shared list
+// takes O(log n) rather than O(n). Removing elements from either end, and
+// taking a sublist, only change the window of the tree a list uses.
+//
+// Tree lists only contain immutable values. Any other change to a tree list
+// turns it back into a flat array first.
+
+// Each node has 1 << kMCProperListNodeBits children or elements.
+static const uindex_t kMCProperListNodeBits = 5;
+static const uindex_t kMCProperListNodeSize = 1 << kMCProperListNodeBits;
+static const uindex_t kMCProperListNodeMask = kMCProperListNodeSize - 1;
+
+// Lists shorter than this are always kept as flat arrays.
+static const uindex_t kMCProperListMinTreeLength = 256;
+
+struct __MCProperListNode
+{
+    // Nodes are shared between lists, and so potentially between threads.
+    std::atomic<uint32_t> references;
+    // The number of bits of an element's position below this node - 0 for a
+    // leaf node (which holds elements, rather than child nodes).
+    uint32_t shift;
+    union
+    {
+        MCValueRef values[kMCProperListNodeSize];
+        __MCProperListNode *children[kMCProperListNodeSize];
+    };
+};
+
+// Returns true if the (direct) list is held as a tree.
+static bool __MCProperListIsTree(__MCProperList *self);
+
+// Returns the element at the given index of the direct list.
+static MCValueRef __MCProperListFetch(__MCProperList *self, uindex_t p_index);
+
+// Makes self a direct list. If its elements are shared with its contents, or
+// the contents are large, the result may be a tree.
+static bool __MCProperListEnsureDirect(__MCProperList *self);
+
+// Makes self a direct list held as a flat array.
+static bool __MCProperListEnsureFlat(__MCProperList *self);
+
+// Makes the (empty, direct) list a tree containing the given values.
+static bool __MCProperListTreeCreate(__MCProperList *self, const MCValueRef *p_values, uindex_t p_length);
+
+// Changes the tree list to a flat array.
+static bool __MCProperListTreeFlatten(__MCProperList *self);
+
+// Pushes the (immutable) value onto the end of the tree list, taking its
+// reference.
+static bool __MCProperListTreePushBack(__MCProperList *self, MCValueRef p_value);
+
+// Removes elements from the start or end of the tree list.
+static bool __MCProperListTreeRemove(__MCProperList *self, uindex_t p_start, uindex_t p_count);
+
+// Releases a reference to a tree node.
+static void __MCProperListNodeRelease(__MCProperListNode *self);
+
 // Returns true if the list is indirect.
 bool MCProperListIsIndirect(MCProperListRef self);
 
@@ -37,8 +100,9 @@ static bool __MCProperListMakeContentsImmutable(__MCProperList *self);
 // Creates an immutable list from this one, changing 'self' to indirect.
 static bool __MCProperListMakeIndirect(__MCProperList *self);
 
-// Ensures the given mutable but indirect list is direct.
-static bool __MCProperListResolveIndirect(__MCProperList *self);
+// Ensures the given mutable but indirect list is direct. If p_allow_tree is
+// true, the result may be a tree list.
+static bool __MCProperListResolveIndirect(__MCProperList *self, bool p_allow_tree);
 
 static bool __MCProperListExpandAt(MCProperListRef self, uindex_t p_at, uindex_t p_count);
 
@@ -267,11 +331,11 @@ bool MCProperListCopyAndRelease(MCProperListRef self, MCProperListRef& r_new_lis
 	if (!__MCProperListMakeIndirect(self))
 		return false;
 
-	// Reduce our reference count.
-	self -> references -= 1;
-
 	// Return a copy of the contents.
 	r_new_list = MCValueRetain(self -> contents);
+
+	// Reduce our reference count.
+	MCValueRelease(self);
 	return true;
 }
 
@@ -317,7 +381,7 @@ bool MCProperListMutableCopyAndRelease(MCProperListRef self, MCProperListRef& r_
 	if (!MCProperListMutableCopy(self, r_new_list))
 		return false;
 
-	self -> references -= 1;
+	MCValueRelease(self);
 	return true;
 }
 
@@ -380,17 +444,7 @@ bool MCProperListPushElementOntoFront(MCProperListRef self, const MCValueRef p_v
 MC_DLLEXPORT_DEF
 bool MCProperListAppendList(MCProperListRef self, MCProperListRef p_value)
 {
-    if (MCProperListIsIndirect(p_value))
-        p_value = p_value -> contents;
-    
-    if (p_value != self)
-        return MCProperListPushElementsOntoBack(self, p_value -> list, p_value -> length);
-    
-    MCAutoProperListRef t_list;
-	if (!MCProperListCopy(p_value, &t_list))
-		return false;
-
-    return MCProperListAppendList(self, *t_list);
+    return MCProperListInsertList(self, p_value, MCProperListGetLength(self));
 }
 
 MC_DLLEXPORT_DEF
@@ -398,9 +452,33 @@ bool MCProperListInsertElements(MCProperListRef self, const MCValueRef *p_values
 {
     MCAssert(MCProperListIsMutable(self));
     
-    if (__MCProperListIsIndirect(self))
-        if (!__MCProperListResolveIndirect(self))
+    if (!__MCProperListEnsureDirect(self))
+        return false;
+    
+    if (__MCProperListIsTree(self))
+    {
+        // Only pushing onto the back keeps the tree.
+        if (uindex_t(p_index) == self -> length)
+        {
+            for (uindex_t i = 0; i < p_length; i++)
+            {
+                __MCValue *t_value;
+                if (!__MCValueImmutableCopy((__MCValue *)p_values[i], false, t_value))
+                    return false;
+                
+                if (!__MCProperListTreePushBack(self, t_value))
+                {
+                    MCValueRelease(t_value);
+                    return false;
+                }
+            }
+            
+            return true;
+        }
+        
+        if (!__MCProperListTreeFlatten(self))
             return false;
+    }
     
     if (!__MCProperListExpandAt(self, p_index, p_length))
         return false;
@@ -423,14 +501,26 @@ bool MCProperListInsertList(MCProperListRef self, MCProperListRef p_value, index
     if (MCProperListIsIndirect(p_value))
         p_value = p_value -> contents;
     
-    if (p_value != self)
+    if (p_value == self)
+    {
+        MCAutoProperListRef t_list;
+        if (!MCProperListCopy(p_value, &t_list))
+            return false;
+        
+        return MCProperListInsertList(self, *t_list, p_index);
+    }
+    
+    if (!__MCProperListIsTree(p_value))
         return MCProperListInsertElements(self, p_value -> list, p_value -> length, p_index);
     
-    MCAutoProperListRef t_list;
-	if (!MCProperListCopy(p_value, &t_list))
-		return false;
-
-    return MCProperListInsertList(self, *t_list, p_index);
+    MCAutoArray<MCValueRef> t_values;
+    if (!t_values . New(p_value -> length))
+        return false;
+    
+    for (uindex_t i = 0; i < p_value -> length; i++)
+        t_values[i] = __MCProperListFetch(p_value, i);
+    
+    return MCProperListInsertElements(self, t_values . Ptr(), t_values . Size(), p_index);
 }
 
 MC_DLLEXPORT_DEF
@@ -438,9 +528,17 @@ bool MCProperListRemoveElements(MCProperListRef self, uindex_t p_start, uindex_t
 {
     MCAssert(MCProperListIsMutable(self));
     
-    if (__MCProperListIsIndirect(self))
-        if (!__MCProperListResolveIndirect(self))
+    if (!__MCProperListEnsureDirect(self))
+        return false;
+    
+    if (__MCProperListIsTree(self))
+    {
+        if (p_start == 0 || p_start + p_count == self -> length)
+            return __MCProperListTreeRemove(self, p_start, p_count);
+        
+        if (!__MCProperListTreeFlatten(self))
             return false;
+    }
     
     MCAutoArray<MCValueRef> t_values;
     for (uindex_t i = p_start; i < p_start + p_count; i++)
@@ -474,7 +572,7 @@ MCValueRef MCProperListFetchHead(MCProperListRef self)
 
 	MCAssert (self->length > 0);
 
-    return self -> list[0];
+    return __MCProperListFetch(self, 0);
 }
 
 MC_DLLEXPORT_DEF
@@ -485,7 +583,7 @@ MCValueRef MCProperListFetchTail(MCProperListRef self)
 
 	MCAssert (self->length > 0);
 
-    return self -> list[self -> length - 1];
+    return __MCProperListFetch(self, self -> length - 1);
 }
 
 MC_DLLEXPORT_DEF
@@ -497,7 +595,7 @@ MCValueRef MCProperListFetchElementAtIndex(MCProperListRef self, uindex_t p_inde
     if (p_index >= self -> length)
         return kMCNull;
     
-    return self -> list[p_index];
+    return __MCProperListFetch(self, p_index);
 }
 
 MC_DLLEXPORT_DEF
@@ -505,12 +603,27 @@ bool MCProperListPopBack(MCProperListRef self, MCValueRef& r_value)
 {
     MCAssert(MCProperListIsMutable(self));
     
-    if (__MCProperListIsIndirect(self))
-        if (!__MCProperListResolveIndirect(self))
-            return false;
+    if (!__MCProperListEnsureDirect(self))
+        return false;
 
 	MCAssert (self -> length > 0);
 
+    if (__MCProperListIsTree(self))
+    {
+        // The tree keeps its reference to the element.
+        MCValueRef t_value;
+        t_value = MCValueRetain(__MCProperListFetch(self, self -> length - 1));
+        
+        if (!__MCProperListTreeRemove(self, self -> length - 1, 1))
+        {
+            MCValueRelease(t_value);
+            return false;
+        }
+        
+        r_value = t_value;
+        return true;
+    }
+
     MCValueRef t_value;
     t_value = self -> list[self -> length - 1];
     
@@ -526,12 +639,27 @@ bool MCProperListPopFront(MCProperListRef self, MCValueRef& r_value)
 {
     MCAssert(MCProperListIsMutable(self));
     
-    if (__MCProperListIsIndirect(self))
-        if (!__MCProperListResolveIndirect(self))
-            return false;
+    if (!__MCProperListEnsureDirect(self))
+        return false;
 
 	MCAssert (self -> length > 0);
 
+    if (__MCProperListIsTree(self))
+    {
+        // The tree keeps its reference to the element.
+        MCValueRef t_value;
+        t_value = MCValueRetain(__MCProperListFetch(self, 0));
+        
+        if (!__MCProperListTreeRemove(self, 0, 1))
+        {
+            MCValueRelease(t_value);
+            return false;
+        }
+        
+        r_value = t_value;
+        return true;
+    }
+
     MCValueRef t_value;
     t_value = self -> list[0];
     
@@ -549,7 +677,35 @@ bool MCProperListCopySublist(MCProperListRef self, MCRange p_range, MCProperList
         self = self -> contents;
     
     __MCProperListClampRange(self, p_range);
-    return MCProperListCreate(self -> list + p_range . offset, p_range . length, r_elements);
+    
+    if (!__MCProperListIsTree(self))
+        return MCProperListCreate(self -> list + p_range . offset, p_range . length, r_elements);
+    
+    // Large sublists of a tree list share its tree.
+    if (p_range . length >= kMCProperListMinTreeLength)
+    {
+        __MCProperList *t_sublist;
+        if (!__MCValueCreate(kMCValueTypeCodeProperList, t_sublist))
+            return false;
+        
+        self -> root -> references.fetch_add(1, std::memory_order_relaxed);
+        t_sublist -> root = self -> root;
+        t_sublist -> offset = self -> offset + p_range . offset;
+        t_sublist -> length = p_range . length;
+        t_sublist -> flags |= kMCProperListFlagIsTree;
+        
+        r_elements = t_sublist;
+        return true;
+    }
+    
+    MCAutoArray<MCValueRef> t_values;
+    if (!t_values . New(p_range . length))
+        return false;
+    
+    for (uindex_t i = 0; i < p_range . length; i++)
+        t_values[i] = __MCProperListFetch(self, p_range . offset + i);
+    
+    return MCProperListCreate(t_values . Ptr(), t_values . Size(), r_elements);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -577,7 +733,7 @@ MCProperListFirstIndexOfElementInRange (MCProperListRef self,
 	     ++t_offset)
 	{
 		uindex_t t_index = p_range.offset + t_offset;
-		if (MCValueIsEqualTo(p_needle, self->list[t_index]))
+		if (MCValueIsEqualTo(p_needle, __MCProperListFetch(self, t_index)))
 		{
 			r_offset = t_offset;
 			return true;
@@ -602,7 +758,7 @@ MCProperListLastIndexOfElementInRange (MCProperListRef self,
 	while (0 < t_offset--)
 	{
 		uindex_t t_index = p_range.offset + t_offset;
-		if (MCValueIsEqualTo (p_needle, self->list[t_index]))
+		if (MCValueIsEqualTo (p_needle, __MCProperListFetch(self, t_index)))
 		{
 			r_offset = t_offset;
 			return true;
@@ -659,8 +815,8 @@ MCProperListFirstOffsetOfListInRange (MCProperListRef self,
 			uindex_t t_needle_index = p_needle->length - t_needle_rindex - 1;
 			uindex_t t_self_index = p_range.offset + t_offset + t_needle_index;
 
-			t_match = MCValueIsEqualTo (p_needle->list[t_needle_index],
-			                            self->list[t_self_index]);
+			t_match = MCValueIsEqualTo (__MCProperListFetch(p_needle, t_needle_index),
+			                            __MCProperListFetch(self, t_self_index));
 		}
 
 		if (t_match)
@@ -719,8 +875,8 @@ MCProperListLastOffsetOfListInRange (MCProperListRef self,
 		{
 			uindex_t t_self_index = p_range.offset + t_offset + t_needle_index;
 
-			t_match = MCValueIsEqualTo (p_needle->list[t_needle_index],
-			                            self->list[t_self_index]);
+			t_match = MCValueIsEqualTo (__MCProperListFetch(p_needle, t_needle_index),
+			                            __MCProperListFetch(self, t_self_index));
 		}
 
 		if (t_match)
@@ -743,7 +899,7 @@ bool MCProperListIterate(MCProperListRef self, uintptr_t& x_iterator, MCValueRef
     if (x_iterator == self -> length)
         return false;
     
-    r_element = self -> list[x_iterator];
+    r_element = __MCProperListFetch(self, x_iterator);
     
     x_iterator += 1;
     
@@ -757,7 +913,7 @@ bool MCProperListApply(MCProperListRef self, MCProperListApplyCallback p_callbac
         self = self -> contents;
     
     for (uindex_t i = 0; i < self -> length; i++)
-        if (!p_callback(context, self -> list[i]))
+        if (!p_callback(context, __MCProperListFetch(self, i)))
             return false;
     
     return true;
@@ -781,7 +937,7 @@ bool MCProperListMap(MCProperListRef self, MCProperListMapCallback p_callback, M
         MCValueRef t_value;
 		t_value = NULL;
 
-        if (!p_callback(context, self -> list[i], t_value))
+        if (!p_callback(context, __MCProperListFetch(self, i), t_value))
             t_success = false;
         
 
@@ -811,9 +967,8 @@ bool MCProperListSort(MCProperListRef self, bool p_reverse, MCProperListQuickSor
     if (t_item_count < 2)
         return true;
     
-    if (MCProperListIsIndirect(self))
-        if (!__MCProperListResolveIndirect(self))
-            return false;
+    if (!__MCProperListEnsureFlat(self))
+        return false;
 
     qsort(self -> list, self -> length, sizeof(MCValueRef), (int (*)(const void *, const void *))p_callback);
 
@@ -872,9 +1027,8 @@ bool MCProperListStableSort(MCProperListRef self, bool p_reverse, MCProperListCo
     if (t_item_count < 2)
         return true;
         
-    if (__MCProperListIsIndirect(self))
-        if (!__MCProperListResolveIndirect(self))
-            return false;
+    if (!__MCProperListEnsureFlat(self))
+        return false;
     
     MCValueRef *t_temp_array = new (nothrow) MCValueRef[t_item_count];
     
@@ -913,7 +1067,7 @@ bool MCProperListBeginsWithList(MCProperListRef self, MCProperListRef p_prefix)
     
     for(uindex_t i = 0; i < t_other_contents -> length; i++)
     {
-        if (!MCValueIsEqualTo(t_contents -> list[i], t_other_contents -> list[i]))
+        if (!MCValueIsEqualTo(__MCProperListFetch(t_contents, i), __MCProperListFetch(t_other_contents, i)))
             return false;
     }
     
@@ -943,7 +1097,7 @@ bool MCProperListEndsWithList(MCProperListRef self, MCProperListRef p_suffix)
     
     for(uindex_t i = 1; i <= t_other_contents -> length; i++)
     {
-        if (!MCValueIsEqualTo(t_contents -> list[t_contents -> length - i], t_other_contents -> list[t_other_contents -> length - i]))
+        if (!MCValueIsEqualTo(__MCProperListFetch(t_contents, t_contents -> length - i), __MCProperListFetch(t_other_contents, t_other_contents -> length - i)))
             return false;
     }
     
@@ -965,7 +1119,7 @@ bool MCProperListIsListOfType(MCProperListRef self, MCValueTypeCode p_type)
     
     for(uindex_t i = 0; i < t_contents -> length; i++)
     {
-        if (MCValueGetTypeCode(t_contents -> list[i]) != p_type)
+        if (MCValueGetTypeCode(__MCProperListFetch(t_contents, i)) != p_type)
             return false;
     }
     
@@ -989,7 +1143,7 @@ bool MCProperListIsHomogeneous(MCProperListRef self, MCValueTypeCode& r_type)
         t_contents = self -> contents;
     
     MCValueTypeCode t_type;
-    t_type = MCValueGetTypeCode(t_contents -> list[0]);
+    t_type = MCValueGetTypeCode(__MCProperListFetch(t_contents, 0));
     
     if (MCProperListIsListOfType(t_contents, t_type))
     {
@@ -1005,10 +1159,9 @@ bool MCProperListReverse(MCProperListRef self)
 {
     MCAssert(MCProperListIsMutable(self));
 
-    // Ensure the list ref is not indirect
-    if (__MCProperListIsIndirect(self))
-        if (!__MCProperListResolveIndirect(self))
-            return false;
+    // Ensure the list ref is a flat array
+    if (!__MCProperListEnsureFlat(self))
+        return false;
 
     MCInplaceReverse(self->list, self->length);
     return true;
@@ -1049,6 +1202,8 @@ void __MCProperListDestroy(__MCProperList *self)
 {
 	if (__MCProperListIsIndirect(self))
 		MCValueRelease(self -> contents);
+	else if (__MCProperListIsTree(self))
+		__MCProperListNodeRelease(self -> root);
 	else
 	{
 		for(uindex_t i = 0; i < self -> length; i++)
@@ -1084,7 +1239,7 @@ bool __MCProperListIsEqualTo(__MCProperList *self, __MCProperList *other_self)
 
 	for(uindex_t i = 0; i < t_contents -> length; i++)
 	{
-		if (!MCValueIsEqualTo(t_contents -> list[i], t_other_contents -> list[i]))
+		if (!MCValueIsEqualTo(__MCProperListFetch(t_contents, i), __MCProperListFetch(t_other_contents, i)))
             return false;
 	}
 
@@ -1190,6 +1345,10 @@ static bool __MCProperListIsIndirect(__MCProperList *self)
 
 static bool __MCProperListMakeContentsImmutable(__MCProperList *self)
 {
+	// The elements of a tree are always immutable.
+	if (__MCProperListIsTree(self))
+		return true;
+
 	for(uindex_t i = 0; i < self -> length; i++)
 	{
         __MCValue *t_new_value;
@@ -1217,6 +1376,8 @@ static bool __MCProperListMakeIndirect(__MCProperList *self)
 	// Fill in our new list.
 	t_list -> length = self -> length;
 	t_list -> list = self -> list;
+	t_list -> offset = self -> offset;
+	t_list -> flags |= self -> flags & kMCProperListFlagIsTree;
 
 	// 'self' now becomes indirect with a reference to the new list.
 	self -> flags |= kMCProperListFlagIsIndirect;
@@ -1224,7 +1385,7 @@ static bool __MCProperListMakeIndirect(__MCProperList *self)
 	return true;
 }
 
-static bool __MCProperListResolveIndirect(__MCProperList *self)
+static bool __MCProperListResolveIndirect(__MCProperList *self, bool p_allow_tree)
 {
 	// Make sure we are indirect.
 	MCAssert(__MCProperListIsIndirect(self));
@@ -1234,14 +1395,35 @@ static bool __MCProperListResolveIndirect(__MCProperList *self)
 	t_contents = self -> contents;
 
 	// If the contents only has a single reference, then re-absorb; otherwise
-	// copy.
+	// share its tree, or copy.
 	if (self -> contents -> references == 1)
 	{
 		self -> length = t_contents -> length;
 		self -> list = t_contents -> list;
+		self -> offset = t_contents -> offset;
+		self -> flags |= t_contents -> flags & kMCProperListFlagIsTree;
 
 		t_contents -> list = nil;
 		t_contents -> length = 0;
+		t_contents -> flags &= ~kMCProperListFlagIsTree;
+	}
+	else if (__MCProperListIsTree(t_contents))
+	{
+		t_contents -> root -> references.fetch_add(1, std::memory_order_relaxed);
+		self -> root = t_contents -> root;
+		self -> length = t_contents -> length;
+		self -> offset = t_contents -> offset;
+		self -> flags |= kMCProperListFlagIsTree;
+	}
+	else if (p_allow_tree && t_contents -> length >= kMCProperListMinTreeLength)
+	{
+		self -> list = nil;
+		self -> length = 0;
+		if (!__MCProperListTreeCreate(self, t_contents -> list, t_contents -> length))
+		{
+			self -> contents = t_contents;
+			return false;
+		}
 	}
 	else
 	{
@@ -1266,6 +1448,262 @@ static bool __MCProperListResolveIndirect(__MCProperList *self)
 	return true;
 }
 
+static bool __MCProperListEnsureDirect(__MCProperList *self)
+{
+	if (!__MCProperListIsIndirect(self))
+		return true;
+
+	return __MCProperListResolveIndirect(self, true);
+}
+
+static bool __MCProperListEnsureFlat(__MCProperList *self)
+{
+	if (__MCProperListIsIndirect(self) &&
+		!__MCProperListResolveIndirect(self, false))
+		return false;
+
+	if (__MCProperListIsTree(self))
+		return __MCProperListTreeFlatten(self);
+
+	return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+static bool __MCProperListNodeCreate(uint32_t p_shift, __MCProperListNode*& r_node)
+{
+	__MCProperListNode *t_node;
+	if (!MCMemoryNew(t_node))
+		return false;
+
+	t_node -> references.store(1, std::memory_order_relaxed);
+	t_node -> shift = p_shift;
+
+	r_node = t_node;
+	return true;
+}
+
+static void __MCProperListNodeRelease(__MCProperListNode *self)
+{
+	if (self -> references.fetch_sub(1, std::memory_order_acq_rel) != 1)
+		return;
+
+	for(uindex_t i = 0; i < kMCProperListNodeSize; i++)
+	{
+		if (self -> shift == 0)
+		{
+			if (self -> values[i] != nil)
+				MCValueRelease(self -> values[i]);
+		}
+		else if (self -> children[i] != nil)
+			__MCProperListNodeRelease(self -> children[i]);
+	}
+
+	MCMemoryDelete(self);
+}
+
+// Ensures the node in x_node is only referenced by the caller, copying it if
+// it is shared (or creating it if there is none).
+static bool __MCProperListNodeMakeUnique(__MCProperListNode*& x_node, uint32_t p_shift)
+{
+	if (x_node == nil)
+		return __MCProperListNodeCreate(p_shift, x_node);
+
+	if (x_node -> references.load(std::memory_order_acquire) == 1)
+		return true;
+
+	__MCProperListNode *t_copy;
+	if (!__MCProperListNodeCreate(p_shift, t_copy))
+		return false;
+
+	for(uindex_t i = 0; i < kMCProperListNodeSize; i++)
+	{
+		if (p_shift == 0)
+		{
+			if (x_node -> values[i] != nil)
+				t_copy -> values[i] = MCValueRetain(x_node -> values[i]);
+		}
+		else if (x_node -> children[i] != nil)
+		{
+			x_node -> children[i] -> references.fetch_add(1, std::memory_order_relaxed);
+			t_copy -> children[i] = x_node -> children[i];
+		}
+	}
+
+	__MCProperListNodeRelease(x_node);
+	x_node = t_copy;
+	return true;
+}
+
+static bool __MCProperListIsTree(__MCProperList *self)
+{
+	return (self -> flags & kMCProperListFlagIsTree) != 0;
+}
+
+// Returns the element at the given position of the tree.
+static MCValueRef __MCProperListNodeFetch(__MCProperListNode *p_root, uindex_t p_position)
+{
+	__MCProperListNode *t_node;
+	t_node = p_root;
+	while(t_node -> shift != 0)
+		t_node = t_node -> children[(p_position >> t_node -> shift) & kMCProperListNodeMask];
+
+	return t_node -> values[p_position & kMCProperListNodeMask];
+}
+
+static MCValueRef __MCProperListFetch(__MCProperList *self, uindex_t p_index)
+{
+	if (!__MCProperListIsTree(self))
+		return self -> list[p_index];
+
+	return __MCProperListNodeFetch(self -> root, self -> offset + p_index);
+}
+
+static bool __MCProperListTreeCreate(__MCProperList *self, const MCValueRef *p_values, uindex_t p_length)
+{
+	MCAssert(self -> list == nil && self -> length == 0);
+
+	if (!__MCProperListNodeCreate(0, self -> root))
+		return false;
+
+	self -> offset = 0;
+	self -> flags |= kMCProperListFlagIsTree;
+
+	for(uindex_t i = 0; i < p_length; i++)
+	{
+		__MCValue *t_value;
+		if (!__MCValueImmutableCopy((__MCValue *)p_values[i], false, t_value))
+			break;
+
+		if (!__MCProperListTreePushBack(self, t_value))
+		{
+			MCValueRelease(t_value);
+			break;
+		}
+	}
+
+	if (self -> length == p_length)
+		return true;
+
+	__MCProperListNodeRelease(self -> root);
+	self -> root = nil;
+	self -> length = 0;
+	self -> flags &= ~kMCProperListFlagIsTree;
+	return false;
+}
+
+static bool __MCProperListTreeFlatten(__MCProperList *self)
+{
+	MCAssert(__MCProperListIsTree(self));
+
+	MCValueRef *t_list;
+	if (!MCMemoryNewArray(self -> length, t_list))
+		return false;
+
+	for(uindex_t i = 0; i < self -> length; i++)
+		t_list[i] = MCValueRetain(__MCProperListFetch(self, i));
+
+	__MCProperListNodeRelease(self -> root);
+	self -> list = t_list;
+	self -> offset = 0;
+	self -> flags &= ~kMCProperListFlagIsTree;
+
+	return true;
+}
+
+static bool __MCProperListTreePushBack(__MCProperList *self, MCValueRef p_value)
+{
+	uindex_t t_position;
+	t_position = self -> offset + self -> length;
+
+	// Add a level to the tree if the position is beyond its capacity.
+	uint32_t t_shift;
+	t_shift = self -> root -> shift;
+	if (t_shift + kMCProperListNodeBits < sizeof(uindex_t) * 8 &&
+		(t_position >> (t_shift + kMCProperListNodeBits)) != 0)
+	{
+		__MCProperListNode *t_root;
+		if (!__MCProperListNodeCreate(t_shift + kMCProperListNodeBits, t_root))
+			return false;
+
+		t_root -> children[0] = self -> root;
+		self -> root = t_root;
+	}
+
+	// Copy any shared nodes on the path to the element, and store it in its
+	// leaf.
+	__MCProperListNode **t_node;
+	t_node = &self -> root;
+	t_shift = self -> root -> shift;
+	for(;;)
+	{
+		if (!__MCProperListNodeMakeUnique(*t_node, t_shift))
+			return false;
+
+		if (t_shift == 0)
+			break;
+
+		t_node = &(*t_node) -> children[(t_position >> t_shift) & kMCProperListNodeMask];
+		t_shift -= kMCProperListNodeBits;
+	}
+
+	MCValueRef& t_slot = (*t_node) -> values[t_position & kMCProperListNodeMask];
+	if (t_slot != nil)
+		MCValueRelease(t_slot);
+	t_slot = p_value;
+
+	self -> length += 1;
+	return true;
+}
+
+static bool __MCProperListTreeRemove(__MCProperList *self, uindex_t p_start, uindex_t p_count)
+{
+	MCAssert(p_start == 0 || p_start + p_count == self -> length);
+
+	// The removed elements stay in the tree until it is changed or released.
+	if (p_start == 0)
+		self -> offset += p_count;
+	self -> length -= p_count;
+
+	// Small lists are better as flat arrays.
+	if (self -> length < kMCProperListMinTreeLength / 2)
+		return __MCProperListTreeFlatten(self);
+
+	// Once more of the tree is before the list's elements than is used by
+	// them, rebuild it so the unused elements can be released.
+	if (self -> offset > self -> length)
+	{
+		MCAutoArray<MCValueRef> t_values;
+		if (!t_values . New(self -> length))
+			return false;
+
+		for(uindex_t i = 0; i < self -> length; i++)
+			t_values[i] = __MCProperListFetch(self, i);
+
+		__MCProperListNode *t_old_root;
+		t_old_root = self -> root;
+		uindex_t t_old_offset;
+		t_old_offset = self -> offset;
+
+		self -> root = nil;
+		self -> length = 0;
+		self -> flags &= ~kMCProperListFlagIsTree;
+
+		if (!__MCProperListTreeCreate(self, t_values . Ptr(), t_values . Size()))
+		{
+			self -> root = t_old_root;
+			self -> offset = t_old_offset;
+			self -> length = t_values . Size();
+			self -> flags |= kMCProperListFlagIsTree;
+			return false;
+		}
+
+		__MCProperListNodeRelease(t_old_root);
+	}
+
+	return true;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 
 MC_DLLEXPORT_DEF MCProperListRef kMCEmptyProperList;
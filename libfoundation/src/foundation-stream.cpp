@@ -48,11 +48,16 @@ struct __MCMemoryInputStream
 	size_t length;
 	size_t pointer;
 	size_t mark;
+	MCDataRef data;
 };
 
 static void __MCMemoryInputStreamDestroy(MCStreamRef p_stream)
 {
-	/* Do nothing because the memory input stream doesn't own its buffer */
+	/* The memory input stream doesn't own its buffer, but might be keeping
+	 * the data value it came from alive */
+	__MCMemoryInputStream *self;
+	self = (__MCMemoryInputStream *)MCStreamGetExtraBytesPtr(p_stream);
+	MCValueRelease(self -> data);
 }
 
 static bool __MCMemoryInputStreamIsFinished(MCStreamRef p_stream, bool& r_finished)
@@ -82,6 +87,17 @@ static bool __MCMemoryInputStreamRead(MCStreamRef p_stream, void *p_buffer, size
 	return true;
 }
 
+static bool __MCMemoryInputStreamReadBytes(MCStreamRef p_stream, size_t p_amount, const void*& r_bytes)
+{
+	__MCMemoryInputStream *self;
+	self = (__MCMemoryInputStream *)MCStreamGetExtraBytesPtr(p_stream);
+	if (p_amount > self -> length - self -> pointer)
+		return false;
+	r_bytes = (const byte_t *)self -> buffer + self -> pointer;
+	self -> pointer += p_amount;
+	return true;
+}
+
 static bool __MCMemoryInputStreamSkip(MCStreamRef p_stream, size_t p_amount)
 {
 	__MCMemoryInputStream *self;
@@ -135,6 +151,7 @@ static MCStreamCallbacks kMCMemoryInputStreamCallbacks =
 	__MCMemoryInputStreamReset,
 	__MCMemoryInputStreamTell,
 	__MCMemoryInputStreamSeek,
+	__MCMemoryInputStreamReadBytes,
 };
 
 MC_DLLEXPORT_DEF
@@ -152,6 +169,31 @@ bool MCMemoryInputStreamCreate(const void *p_block, size_t p_size, MCStreamRef&
 	self -> length = p_size;
 	self -> mark = 0;
 	self -> pointer = 0;
+	self -> data = nil;
+
+	r_stream = t_stream;
+
+	return true;
+}
+
+MC_DLLEXPORT_DEF
+bool MCMemoryInputStreamCreateWithData(MCDataRef p_data, MCStreamRef& r_stream)
+{
+	/* Take an immutable copy so that the bytes can't move under the stream */
+	MCDataRef t_data;
+	if (!MCDataCopy(p_data, t_data))
+		return false;
+
+	MCStreamRef t_stream;
+	if (!MCMemoryInputStreamCreate(MCDataGetBytePtr(t_data), MCDataGetLength(t_data), t_stream))
+	{
+		MCValueRelease(t_data);
+		return false;
+	}
+
+	__MCMemoryInputStream *self;
+	self = (__MCMemoryInputStream *)MCStreamGetExtraBytesPtr(t_stream);
+	self -> data = t_data;
 
 	r_stream = t_stream;
 
@@ -222,6 +264,7 @@ static MCStreamCallbacks kMCMemoryOutputStreamCallbacks =
 	nil,
 	nil,
 	nil,
+	nil,
 };
 
 MC_DLLEXPORT_DEF
@@ -260,6 +303,293 @@ bool MCMemoryOutputStreamFinish(MCStreamRef p_stream, void*& r_buffer, size_t& r
 
 ////////////////////////////////////////////////////////////////////////////////
 
+/* The buffer of a buffered stream holds either unread input or unwritten
+ * output, never both. Switching from reading to writing puts the source back
+ * to the logical position (so requires it to be seekable), and switching from
+ * writing to reading flushes the output. */
+
+struct __MCBufferedStream
+{
+	MCStreamRef source;
+	byte_t *buffer;
+	size_t capacity;
+	/* Unread input is buffer[pointer, frontier); unwritten output is
+	 * buffer[0, frontier). */
+	size_t pointer;
+	size_t frontier;
+	bool writing;
+};
+
+static inline __MCBufferedStream *__MCBufferedStreamGet(MCStreamRef p_stream)
+{
+	return (__MCBufferedStream *)MCStreamGetExtraBytesPtr(p_stream);
+}
+
+static bool __MCBufferedStreamFlushOutput(__MCBufferedStream *self)
+{
+	if (self -> frontier != 0 &&
+		!MCStreamWrite(self -> source, self -> buffer, self -> frontier))
+		return false;
+	self -> frontier = 0;
+	return true;
+}
+
+static bool __MCBufferedStreamBeginReading(__MCBufferedStream *self)
+{
+	if (!self -> writing)
+		return true;
+	if (!__MCBufferedStreamFlushOutput(self))
+		return false;
+	self -> writing = false;
+	return true;
+}
+
+static bool __MCBufferedStreamBeginWriting(__MCBufferedStream *self)
+{
+	if (self -> writing)
+		return true;
+	if (self -> pointer != self -> frontier)
+	{
+		filepos_t t_position;
+		if (!MCStreamTell(self -> source, t_position) ||
+			!MCStreamSeek(self -> source, t_position - filepos_t(self -> frontier - self -> pointer)))
+			return false;
+	}
+	self -> pointer = 0;
+	self -> frontier = 0;
+	self -> writing = true;
+	return true;
+}
+
+static void __MCBufferedStreamDestroy(MCStreamRef p_stream)
+{
+	__MCBufferedStream *self;
+	self = __MCBufferedStreamGet(p_stream);
+	if (self -> writing)
+		/* UNCHECKED */ __MCBufferedStreamFlushOutput(self);
+	MCMemoryDeleteArray(self -> buffer);
+	MCValueRelease(self -> source);
+}
+
+static bool __MCBufferedStreamIsFinished(MCStreamRef p_stream, bool& r_finished)
+{
+	__MCBufferedStream *self;
+	self = __MCBufferedStreamGet(p_stream);
+	if (!self -> writing && self -> pointer != self -> frontier)
+	{
+		r_finished = false;
+		return true;
+	}
+	return MCStreamIsFinished(self -> source, r_finished);
+}
+
+static bool __MCBufferedStreamGetAvailableForRead(MCStreamRef p_stream, size_t& r_amount)
+{
+	__MCBufferedStream *self;
+	self = __MCBufferedStreamGet(p_stream);
+
+	size_t t_buffered;
+	t_buffered = self -> writing ? 0 : self -> frontier - self -> pointer;
+
+	size_t t_available;
+	if (!MCStreamGetAvailableForRead(self -> source, t_available))
+	{
+		if (t_buffered == 0)
+			return false;
+		t_available = 0;
+	}
+
+	r_amount = t_buffered + t_available;
+	return true;
+}
+
+static bool __MCBufferedStreamRead(MCStreamRef p_stream, void *p_buffer, size_t p_amount)
+{
+	__MCBufferedStream *self;
+	self = __MCBufferedStreamGet(p_stream);
+	if (!__MCBufferedStreamBeginReading(self))
+		return false;
+
+	size_t t_buffered;
+	t_buffered = self -> frontier - self -> pointer;
+	if (p_amount <= t_buffered)
+	{
+		MCMemoryCopy(p_buffer, self -> buffer + self -> pointer, p_amount);
+		self -> pointer += p_amount;
+		return true;
+	}
+
+	/* If the request fits in the buffer and the source has enough ready, top
+	 * the buffer up with as much as possible and serve the request from it. */
+	size_t t_remaining, t_available;
+	t_remaining = p_amount - t_buffered;
+	if (p_amount <= self -> capacity &&
+		MCStreamGetAvailableForRead(self -> source, t_available) &&
+		t_available >= t_remaining)
+	{
+		MCMemoryMove(self -> buffer, self -> buffer + self -> pointer, t_buffered);
+		self -> pointer = 0;
+		self -> frontier = t_buffered;
+
+		size_t t_fill;
+		t_fill = MCMin(self -> capacity - t_buffered, t_available);
+		if (!MCStreamRead(self -> source, self -> buffer + t_buffered, t_fill))
+			return false;
+		self -> frontier += t_fill;
+
+		MCMemoryCopy(p_buffer, self -> buffer, p_amount);
+		self -> pointer = p_amount;
+		return true;
+	}
+
+	/* Otherwise read the rest straight into place - the buffered input is
+	 * only consumed if that succeeds. */
+	if (!MCStreamRead(self -> source, (byte_t *)p_buffer + t_buffered, t_remaining))
+		return false;
+	MCMemoryCopy(p_buffer, self -> buffer + self -> pointer, t_buffered);
+	self -> pointer = 0;
+	self -> frontier = 0;
+	return true;
+}
+
+static bool __MCBufferedStreamGetAvailableForWrite(MCStreamRef p_stream, size_t& r_amount)
+{
+	return MCStreamGetAvailableForWrite(__MCBufferedStreamGet(p_stream) -> source, r_amount);
+}
+
+static bool __MCBufferedStreamWrite(MCStreamRef p_stream, const void *p_buffer, size_t p_amount)
+{
+	__MCBufferedStream *self;
+	self = __MCBufferedStreamGet(p_stream);
+	if (!__MCBufferedStreamBeginWriting(self))
+		return false;
+
+	if (p_amount > self -> capacity - self -> frontier)
+	{
+		if (!__MCBufferedStreamFlushOutput(self))
+			return false;
+		if (p_amount >= self -> capacity)
+			return MCStreamWrite(self -> source, p_buffer, p_amount);
+	}
+
+	MCMemoryCopy(self -> buffer + self -> frontier, p_buffer, p_amount);
+	self -> frontier += p_amount;
+	return true;
+}
+
+static bool __MCBufferedStreamSkip(MCStreamRef p_stream, size_t p_amount)
+{
+	__MCBufferedStream *self;
+	self = __MCBufferedStreamGet(p_stream);
+	if (!__MCBufferedStreamBeginReading(self))
+		return false;
+
+	size_t t_buffered;
+	t_buffered = self -> frontier - self -> pointer;
+	if (p_amount <= t_buffered)
+	{
+		self -> pointer += p_amount;
+		return true;
+	}
+
+	if (!MCStreamSkip(self -> source, p_amount - t_buffered))
+		return false;
+	self -> pointer = 0;
+	self -> frontier = 0;
+	return true;
+}
+
+static bool __MCBufferedStreamTell(MCStreamRef p_stream, filepos_t& r_position)
+{
+	__MCBufferedStream *self;
+	self = __MCBufferedStreamGet(p_stream);
+
+	filepos_t t_position;
+	if (!MCStreamTell(self -> source, t_position))
+		return false;
+
+	if (self -> writing)
+		r_position = t_position + filepos_t(self -> frontier);
+	else
+		r_position = t_position - filepos_t(self -> frontier - self -> pointer);
+	return true;
+}
+
+static bool __MCBufferedStreamSeek(MCStreamRef p_stream, filepos_t p_position)
+{
+	__MCBufferedStream *self;
+	self = __MCBufferedStreamGet(p_stream);
+	if (self -> writing && !__MCBufferedStreamFlushOutput(self))
+		return false;
+
+	if (!MCStreamSeek(self -> source, p_position))
+		return false;
+	self -> pointer = 0;
+	self -> frontier = 0;
+	return true;
+}
+
+static MCStreamCallbacks kMCBufferedStreamCallbacks =
+{
+	__MCBufferedStreamDestroy,
+	__MCBufferedStreamIsFinished,
+	__MCBufferedStreamGetAvailableForRead,
+	__MCBufferedStreamRead,
+	__MCBufferedStreamGetAvailableForWrite,
+	__MCBufferedStreamWrite,
+	__MCBufferedStreamSkip,
+	nil,
+	nil,
+	__MCBufferedStreamTell,
+	__MCBufferedStreamSeek,
+	nil,
+};
+
+MC_DLLEXPORT_DEF
+bool MCBufferedStreamCreate(MCStreamRef p_source, size_t p_buffer_size, MCStreamRef& r_stream)
+{
+	MCAssert(nil != p_source);
+	MCAssert(p_buffer_size > 0);
+
+	byte_t *t_buffer;
+	if (!MCMemoryNewArray(p_buffer_size, t_buffer))
+		return false;
+
+	MCStreamRef t_stream;
+	if (!MCStreamCreate(&kMCBufferedStreamCallbacks, sizeof(__MCBufferedStream), t_stream))
+	{
+		MCMemoryDeleteArray(t_buffer);
+		return false;
+	}
+
+	__MCBufferedStream *self;
+	self = __MCBufferedStreamGet(t_stream);
+	self -> source = MCValueRetain(p_source);
+	self -> buffer = t_buffer;
+	self -> capacity = p_buffer_size;
+	self -> pointer = 0;
+	self -> frontier = 0;
+	self -> writing = false;
+
+	r_stream = t_stream;
+
+	return true;
+}
+
+MC_DLLEXPORT_DEF
+bool MCBufferedStreamFlush(MCStreamRef p_stream)
+{
+	MCAssert(MCStreamGetCallbacks(p_stream) == &kMCBufferedStreamCallbacks);
+
+	__MCBufferedStream *self;
+	self = __MCBufferedStreamGet(p_stream);
+	if (!self -> writing)
+		return true;
+	return __MCBufferedStreamFlushOutput(self);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 static void __MCStreamDestroy(MCValueRef p_value)
 {
 	__MCStreamCallbacks((MCStreamRef)p_value)->destroy((MCStreamRef)p_value);
@@ -362,6 +692,14 @@ bool MCStreamIsSeekable(MCStreamRef self)
 	return __MCStreamCallbacks(self) -> seek != nil;
 }
 
+MC_DLLEXPORT_DEF
+bool MCStreamIsMapped(MCStreamRef self)
+{
+	__MCAssertIsStream(self);
+
+	return __MCStreamCallbacks(self) -> read_bytes != nil;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 
 MC_DLLEXPORT_DEF
@@ -406,6 +744,16 @@ bool MCStreamWrite(MCStreamRef self, const void *p_buffer, size_t p_amount)
 	return __MCStreamCallbacks(self) -> write(self, p_buffer, p_amount);
 }
 
+MC_DLLEXPORT_DEF
+bool MCStreamIsFinished(MCStreamRef self, bool& r_finished)
+{
+	__MCAssertIsStream(self);
+
+	if (__MCStreamCallbacks(self) -> is_finished == nil)
+		return false;
+	return __MCStreamCallbacks(self) -> is_finished(self, r_finished);
+}
+
 MC_DLLEXPORT_DEF
 bool MCStreamSkip(MCStreamRef self, size_t p_amount)
 {
@@ -469,6 +817,18 @@ bool MCStreamSeek(MCStreamRef self, filepos_t p_position)
 
 ////////////////////////////////////////////////////////////////////////////////
 
+MC_DLLEXPORT_DEF
+bool MCStreamReadBytes(MCStreamRef self, size_t p_amount, const void*& r_bytes)
+{
+	__MCAssertIsStream(self);
+
+	if (__MCStreamCallbacks(self) -> read_bytes == nil)
+		return false;
+	return __MCStreamCallbacks(self) -> read_bytes(self, p_amount, r_bytes);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 MC_DLLEXPORT_DEF
 bool MCStreamReadUInt8(MCStreamRef self, uint8_t& r_value)
 {
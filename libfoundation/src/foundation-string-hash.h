@@ -29,46 +29,111 @@ namespace {
  * Character sequence hashing
  * ---------------------------------------------------------------- */
 
-/* Uses the Fowler-Noll-Vo FNV-1a hash */
+/* Hashes a sequence of UTF-16 code units a word (four code units) at a
+ * time, mixing each word with a multiply-rotate round in the style of
+ * xxHash64.
+ *
+ * The hash depends only on the code units consumed, and not on how they
+ * were fed in, so a native string hashes the same as its UTF-16 form as long
+ * as its chars are mapped to unicode first. Bulk consumption of chars which
+ * are known to need no mapping (such as ASCII) can be done a word at a time
+ * with consume_word(), which must only be used on a word boundary. */
 
 class MCHashCharsContext
 {
-    static const hash_t kPrime = (sizeof(hash_t) == sizeof(uint64_t) ?
-                                  1099511628211ULL : 16777619UL);
-    static const hash_t kOffset = (sizeof(hash_t) == sizeof(uint64_t) ?
-                                   14695981039346656037ULL : 2166136261UL);
+    static const uint64_t kPrime1 = 0x9E3779B185EBCA87ULL;
+    static const uint64_t kPrime2 = 0xC2B2AE3D27D4EB4FULL;
+    static const uint64_t kPrime3 = 0x165667B19E3779F9ULL;
+    static const uint64_t kPrime4 = 0x85EBCA77C2B2AE63ULL;
+    static const uint64_t kPrime5 = 0x27D4EB2F165667C5ULL;
 
-    hash_t m_hash = kOffset;
+    // The hash of the full words consumed so far.
+    uint64_t m_hash = kPrime5;
 
-    // Perform a single step for a unicode code unit representable as a single
-    // byte.
-    void step(char_t p_char)
+    // The code units consumed since the last full word, packed with the
+    // first in the least significant bits.
+    uint64_t m_word = 0;
+
+    // The number of code units consumed.
+    uint64_t m_count = 0;
+
+    static uint64_t rotate(uint64_t p_value, int p_bits)
+    {
+        return (p_value << p_bits) | (p_value >> (64 - p_bits));
+    }
+
+    static uint64_t mix(uint64_t p_hash, uint64_t p_word)
     {
-        m_hash ^= p_char;
-        m_hash *= kPrime;
-        m_hash *= kPrime;
+        p_hash ^= rotate(p_word * kPrime2, 31) * kPrime1;
+        return rotate(p_hash, 27) * kPrime1 + kPrime4;
     }
 
     // Peform a single step for a two-byte code unit
     void step(unichar_t p_char)
     {
-        // Hash the lower byte
-        m_hash ^= p_char & 0xFF;
-        m_hash *= kPrime;
+        m_word |= uint64_t(p_char) << ((m_count & 3) * 16);
+        m_count += 1;
 
-        // Hash the upper byte
-        m_hash ^= p_char >> 8;
-        m_hash *= kPrime;
+        if ((m_count & 3) == 0)
+        {
+            m_hash = mix(m_hash, m_word);
+            m_word = 0;
+        }
     }
 
 public:
     constexpr MCHashCharsContext() = default;
 
     constexpr MCHashCharsContext(hash_t p_initial_hash)
-    : m_hash(p_initial_hash)
+    : m_hash(kPrime5 + p_initial_hash)
     {}
 
-    operator hash_t() const { return m_hash; }
+    operator hash_t() const
+    {
+        uint64_t t_hash = m_hash;
+        if ((m_count & 3) != 0)
+            t_hash = mix(t_hash, m_word);
+
+        t_hash += m_count;
+        t_hash ^= t_hash >> 33;
+        t_hash *= kPrime2;
+        t_hash ^= t_hash >> 29;
+        t_hash *= kPrime3;
+        t_hash ^= t_hash >> 32;
+
+        return hash_t(t_hash);
+    }
+
+    /* Load 8 bytes (four code units or eight single-byte chars) as a
+     * little-endian word. */
+    static uint64_t load(const void *p_bytes)
+    {
+        uint64_t t_word;
+        MCMemoryCopy(&t_word, p_bytes, sizeof(t_word));
+        return MCSwapInt64LittleToHost(t_word);
+    }
+
+    /* Widen four single-byte chars, packed in the low 32 bits of 'chars',
+     * to a word of four code units. */
+    static uint64_t widen(uint64_t p_chars)
+    {
+        p_chars &= 0xFFFFFFFFULL;
+        p_chars = (p_chars | (p_chars << 16)) & 0x0000FFFF0000FFFFULL;
+        p_chars = (p_chars | (p_chars << 8)) & 0x00FF00FF00FF00FFULL;
+        return p_chars;
+    }
+
+    /* Hash a word of up to four code units, packed with the first in the
+     * least significant bits (and any unused bits zero). */
+    void consume_word(uint64_t p_units, size_t p_unit_count = 4)
+    {
+        MCAssert((m_count & 3) == 0);
+        if (p_unit_count == 4)
+            m_hash = mix(m_hash, p_units);
+        else
+            m_word = p_units;
+        m_count += p_unit_count;
+    }
 
     /* Hash single code units */
     void consume(char_t c) { step(c); }
@@ -90,6 +155,49 @@ public:
             step(t_trailing);
         }
     }
+
+    /* Hash a sequence of single-byte chars, each as a code unit. */
+    void consume(const char_t *p_chars, size_t p_char_count)
+    {
+        for(; p_char_count > 0 && (m_count & 3) != 0; p_char_count--)
+            step(*p_chars++);
+
+        for(; p_char_count >= 8; p_char_count -= 8, p_chars += 8)
+        {
+            uint64_t t_chars = load(p_chars);
+            consume_word(widen(t_chars));
+            consume_word(widen(t_chars >> 32));
+        }
+
+        uint64_t t_tail = 0;
+        for(size_t i = 0; i < p_char_count; i++)
+            t_tail |= uint64_t(p_chars[i]) << (i * 8);
+
+        if (p_char_count > 4)
+        {
+            consume_word(widen(t_tail));
+            consume_word(widen(t_tail >> 32), p_char_count - 4);
+        }
+        else if (p_char_count > 0)
+            consume_word(widen(t_tail), p_char_count);
+    }
+
+    /* Hash a sequence of code units. */
+    void consume(const unichar_t *p_units, size_t p_unit_count)
+    {
+        for(; p_unit_count > 0 && (m_count & 3) != 0; p_unit_count--)
+            step(*p_units++);
+
+        for(; p_unit_count >= 4; p_unit_count -= 4, p_units += 4)
+            consume_word(load(p_units));
+
+        uint64_t t_tail = 0;
+        for(size_t i = 0; i < p_unit_count; i++)
+            t_tail |= uint64_t(p_units[i]) << (i * 16);
+
+        if (p_unit_count > 0)
+            consume_word(t_tail, p_unit_count);
+    }
 };
 
 } /* anonymous namespace */
@@ -0,0 +1,244 @@
+/* Copyright (C) 2003-2015 LiveCode Ltd.
+
+ This file is part of LiveCode.
+
+ LiveCode is free software; you can redistribute it and/or modify it under
+ the terms of the GNU General Public License v3 as published by the Free
+ Software Foundation.
+
+ LiveCode is distributed in the hope that it will be useful, but WITHOUT ANY
+ WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with LiveCode.  If not see <http://www.gnu.org/licenses/>.  */
+
+////////////////////////////////////////////////////////////////////////////////
+
+// This file contains the vectorized native string kernels and is designed to
+// be included in foundation-string-native.cpp.h once for each instruction set.
+//
+// Before inclusion __NATIVESIMD_NAME(name) must be defined to decorate the
+// name of each kernel, and __NATIVESIMD_VECTOR must be defined as the class
+// providing the vector primitives:
+//
+//   Vector - the vector type
+//   kWidth - the number of chars in a vector
+//   kMask - the mask with a bit set for each char in a vector
+//   Broadcast(char) - a vector with every char set to 'char'
+//   Load(chars) - an (unaligned) load of the vector at 'chars'
+//   Equal(left, right) - a vector with 0xff in each char which is equal
+//   FoldAscii(vector) - 'vector' with any ASCII upper-case letters lowered
+//   Mask(vector) - a mask with a bit set for each char with its top bit set
+//   Match(chars, a, b) - a mask with a bit set for each char which is a or b
+
+////////////////////////////////////////////////////////////////////////////////
+
+// Check the two (equal length) strings for equality, using the given char
+// comparison method.
+template<bool (*CharEqual)(char_t left, char_t right)>
+static bool __NATIVESIMD_NAME(Equal)(const char_t *p_left_chars,
+                                     const char_t *p_right_chars,
+                                     size_t p_length)
+{
+    typedef __NATIVESIMD_VECTOR V;
+
+    size_t t_char_offset;
+    t_char_offset = 0;
+    for(; t_char_offset + V::kWidth <= p_length; t_char_offset += V::kWidth)
+    {
+        typename V::Vector t_left, t_right;
+        t_left = V::Load(p_left_chars + t_char_offset);
+        t_right = V::Load(p_right_chars + t_char_offset);
+
+        uint32_t t_mismatches;
+        t_mismatches = ~V::Mask(V::Equal(t_left, t_right)) & V::kMask;
+        if (t_mismatches == 0)
+            continue;
+
+        // Folding preserves ASCII chars other than letters, which are lowered.
+        // So if the chars only differ in the case of ASCII letters they are
+        // equal, anything else must be compared individually.
+        if (CharEqual != __MCNativeChar_Equal_Unfolded)
+            t_mismatches = ~V::Mask(V::Equal(V::FoldAscii(t_left), V::FoldAscii(t_right))) & V::kMask;
+
+        for(; t_mismatches != 0; t_mismatches &= t_mismatches - 1)
+        {
+            size_t t_index;
+            t_index = t_char_offset + __MCNativeSimd_LowestBit(t_mismatches);
+            if (!CharEqual(p_left_chars[t_index], p_right_chars[t_index]))
+                return false;
+        }
+    }
+
+    for(; t_char_offset < p_length; t_char_offset++)
+        if (!CharEqual(p_left_chars[t_char_offset], p_right_chars[t_char_offset]))
+            return false;
+
+    return true;
+}
+
+// Scan forward for chars which are 'a' or 'b' - see __MCNativeStr_Forward
+// for the meaning of the other parameters and result.
+static size_t __NATIVESIMD_NAME(CharScan)(const char_t *p_haystack_chars,
+                                          size_t p_haystack_length,
+                                          char_t p_a,
+                                          char_t p_b,
+                                          size_t p_max_count,
+                                          size_t *r_offset)
+{
+    typedef __NATIVESIMD_VECTOR V;
+
+    V::Vector t_a, t_b;
+    t_a = V::Broadcast(p_a);
+    t_b = V::Broadcast(p_b);
+
+    size_t t_count;
+    t_count = 0;
+
+    size_t t_char_offset;
+    t_char_offset = 0;
+
+    size_t t_offset = 0;
+    for(; t_char_offset + V::kWidth <= p_haystack_length; t_char_offset += V::kWidth)
+    {
+        uint32_t t_matches;
+        t_matches = V::Match(p_haystack_chars + t_char_offset, t_a, t_b);
+        if (t_matches == 0)
+            continue;
+
+        // If counting all occurrences, only the last one's offset is needed.
+        if (p_max_count == 0)
+        {
+            t_count += __MCNativeSimd_CountBits(t_matches);
+            t_offset = t_char_offset + __MCNativeSimd_HighestBit(t_matches);
+            continue;
+        }
+
+        for(; t_matches != 0; t_matches &= t_matches - 1)
+        {
+            t_offset = t_char_offset + __MCNativeSimd_LowestBit(t_matches);
+            t_count += 1;
+
+            if (t_count == p_max_count)
+                goto done;
+        }
+    }
+
+    for(; t_char_offset < p_haystack_length; t_char_offset++)
+    {
+        if (p_haystack_chars[t_char_offset] != p_a &&
+            p_haystack_chars[t_char_offset] != p_b)
+            continue;
+
+        t_offset = t_char_offset;
+        t_count += 1;
+
+        if (t_count == p_max_count)
+            break;
+    }
+
+done:
+    if (t_count > 0 &&
+        r_offset != nil)
+        *r_offset = t_offset;
+
+    return t_count;
+}
+
+// Scan forward for non-overlapping occurrences of needle, whose first char
+// is one of 'first' and last char is one of 'last'. Candidates are found by
+// matching the first and last chars of each position a vector at a time,
+// and then compared in full - see __MCNativeStr_Forward for the meaning of the
+// other parameters and result.
+template<bool (*CharEqual)(char_t left, char_t right)>
+static size_t __NATIVESIMD_NAME(Scan)(const char_t *p_haystack_chars,
+                                      size_t p_haystack_length,
+                                      const char_t *p_needle_chars,
+                                      size_t p_needle_length,
+                                      const char_t p_first[2],
+                                      const char_t p_last[2],
+                                      size_t p_max_count,
+                                      size_t *r_offset)
+{
+    typedef __NATIVESIMD_VECTOR V;
+
+    typename V::Vector t_first_a, t_first_b, t_last_a, t_last_b;
+    t_first_a = V::Broadcast(p_first[0]);
+    t_first_b = V::Broadcast(p_first[1]);
+    t_last_a = V::Broadcast(p_last[0]);
+    t_last_b = V::Broadcast(p_last[1]);
+
+    // The number of offsets at which the needle could start.
+    size_t t_limit;
+    t_limit = p_haystack_length - p_needle_length + 1;
+
+    // Occurrences cannot overlap, so none can start before this offset.
+    size_t t_next;
+    t_next = 0;
+
+    size_t t_count;
+    t_count = 0;
+
+    size_t t_char_offset;
+    t_char_offset = 0;
+
+    size_t t_offset = 0;
+    for(; t_char_offset + V::kWidth <= t_limit; t_char_offset += V::kWidth)
+    {
+        uint32_t t_candidates;
+        t_candidates = V::Match(p_haystack_chars + t_char_offset, t_first_a, t_first_b) &
+                        V::Match(p_haystack_chars + t_char_offset + p_needle_length - 1, t_last_a, t_last_b);
+
+        for(; t_candidates != 0; t_candidates &= t_candidates - 1)
+        {
+            size_t t_candidate;
+            t_candidate = t_char_offset + __MCNativeSimd_LowestBit(t_candidates);
+
+            if (t_candidate < t_next ||
+                !__NATIVESIMD_NAME(Equal)<CharEqual>(p_haystack_chars + t_candidate,
+                                                     p_needle_chars,
+                                                     p_needle_length))
+                continue;
+
+            t_offset = t_candidate;
+            t_count += 1;
+
+            if (t_count == p_max_count)
+                goto done;
+
+            t_next = t_candidate + p_needle_length;
+        }
+    }
+
+    if (t_char_offset < t_next)
+        t_char_offset = t_next;
+
+    while(t_char_offset < t_limit)
+    {
+        if (__NATIVESIMD_NAME(Equal)<CharEqual>(p_haystack_chars + t_char_offset,
+                                                p_needle_chars,
+                                                p_needle_length))
+        {
+            t_offset = t_char_offset;
+            t_count += 1;
+
+            if (t_count == p_max_count)
+                break;
+
+            t_char_offset += p_needle_length;
+        }
+        else
+            t_char_offset += 1;
+    }
+
+done:
+    if (t_count > 0 &&
+        r_offset != nil)
+        *r_offset = t_offset;
+
+    return t_count;
+}
+
+////////////////////////////////////////////////////////////////////////////////
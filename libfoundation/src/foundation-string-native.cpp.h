@@ -331,6 +331,374 @@ __MCNativeChar_Compare_Folded(char_t p_left,
 
 ////////////////////////////////////////////////////////////////////////////////
 
+// On x86-64 the forward scanning, counting and caseless comparison operations
+// are vectorized. SSE2 is always available there, and AVX2 is used instead if
+// the processor supports it. The kernels are defined (once for each) in
+// foundation-string-native-simd.cpp.h, and the __MCNativeSimd_* functions below
+// dispatch to them - returning false if the operation should be done with the
+// scalar loops instead.
+
+#if defined(__X86_64__) && (defined(__GNUC__) || defined(_MSC_VER))
+#define __NATIVEOP_SIMD 1
+#endif
+
+#if defined(__NATIVEOP_SIMD)
+
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+
+// True if the AVX2 kernels should be used.
+static bool s_native_simd_has_avx2 = false;
+
+static inline uindex_t __MCNativeSimd_LowestBit(uint32_t p_mask)
+{
+#if defined(_MSC_VER)
+    unsigned long t_index;
+    _BitScanForward(&t_index, p_mask);
+    return t_index;
+#else
+    return __builtin_ctz(p_mask);
+#endif
+}
+
+static inline uindex_t __MCNativeSimd_HighestBit(uint32_t p_mask)
+{
+#if defined(_MSC_VER)
+    unsigned long t_index;
+    _BitScanReverse(&t_index, p_mask);
+    return t_index;
+#else
+    return 31 - __builtin_clz(p_mask);
+#endif
+}
+
+static inline uindex_t __MCNativeSimd_CountBits(uint32_t p_mask)
+{
+#if defined(_MSC_VER)
+    p_mask = p_mask - ((p_mask >> 1) & 0x55555555);
+    p_mask = (p_mask & 0x33333333) + ((p_mask >> 2) & 0x33333333);
+    return (((p_mask + (p_mask >> 4)) & 0x0f0f0f0f) * 0x01010101) >> 24;
+#else
+    return __builtin_popcount(p_mask);
+#endif
+}
+
+// Returns true if the processor and OS support AVX2 (and POPCNT, which all
+// processors with AVX2 have).
+static bool __MCNativeSimd_DetectAVX2(void)
+{
+    // CPUID leaf 1 ECX bits.
+    const uint32_t kPOPCNT = 1 << 23;
+    const uint32_t kOSXSAVE = 1 << 27;
+    // XCR0 bits indicating the OS saves the XMM and YMM registers.
+    const uint64_t kXMMAndYMMState = 6;
+    // CPUID leaf 7 EBX bits.
+    const uint32_t kAVX2 = 1 << 5;
+    
+#if defined(_MSC_VER)
+    int t_info[4];
+    __cpuid(t_info, 0);
+    if (t_info[0] < 7)
+        return false;
+    
+    __cpuid(t_info, 1);
+    if ((t_info[2] & kPOPCNT) == 0 || (t_info[2] & kOSXSAVE) == 0)
+        return false;
+    
+    if ((_xgetbv(0) & kXMMAndYMMState) != kXMMAndYMMState)
+        return false;
+    
+    __cpuidex(t_info, 7, 0);
+    return (t_info[1] & kAVX2) != 0;
+#else
+    if (__get_cpuid_max(0, nil) < 7)
+        return false;
+    
+    unsigned int t_eax, t_ebx, t_ecx, t_edx;
+    __cpuid(1, t_eax, t_ebx, t_ecx, t_edx);
+    if ((t_ecx & kPOPCNT) == 0 || (t_ecx & kOSXSAVE) == 0)
+        return false;
+    
+    uint32_t t_xcr0_low, t_xcr0_high;
+    __asm__("xgetbv" : "=a" (t_xcr0_low), "=d" (t_xcr0_high) : "c" (0));
+    if ((t_xcr0_low & kXMMAndYMMState) != kXMMAndYMMState)
+        return false;
+    
+    __cpuid_count(7, 0, t_eax, t_ebx, t_ecx, t_edx);
+    return (t_ebx & kAVX2) != 0;
+#endif
+}
+
+struct __MCNativeVector_SSE2
+{
+    typedef __m128i Vector;
+    
+    static const size_t kWidth = 16;
+    static const uint32_t kMask = 0xffff;
+    
+    static inline Vector Broadcast(char_t p_char)
+    {
+        return _mm_set1_epi8(char(p_char));
+    }
+    
+    static inline Vector Load(const char_t *p_chars)
+    {
+        return _mm_loadu_si128(reinterpret_cast<const __m128i *>(p_chars));
+    }
+    
+    static inline Vector Equal(Vector p_left, Vector p_right)
+    {
+        return _mm_cmpeq_epi8(p_left, p_right);
+    }
+    
+    static inline Vector FoldAscii(Vector p_vector)
+    {
+        // The comparisons are signed, so non-ASCII chars are never in range.
+        Vector t_is_upper;
+        t_is_upper = _mm_and_si128(_mm_cmpgt_epi8(p_vector, _mm_set1_epi8('A' - 1)),
+                                   _mm_cmpgt_epi8(_mm_set1_epi8('Z' + 1), p_vector));
+        return _mm_or_si128(p_vector, _mm_and_si128(t_is_upper, _mm_set1_epi8(0x20)));
+    }
+    
+    static inline uint32_t Mask(Vector p_vector)
+    {
+        return uint32_t(_mm_movemask_epi8(p_vector));
+    }
+    
+    static inline uint32_t Match(const char_t *p_chars, Vector p_a, Vector p_b)
+    {
+        Vector t_chars;
+        t_chars = Load(p_chars);
+        return Mask(_mm_or_si128(_mm_cmpeq_epi8(t_chars, p_a), _mm_cmpeq_epi8(t_chars, p_b)));
+    }
+};
+
+#define __NATIVESIMD_NAME(x) __MCNativeSimd_##x##_SSE2
+#define __NATIVESIMD_VECTOR __MCNativeVector_SSE2
+#include "foundation-string-native-simd.cpp.h"
+#undef __NATIVESIMD_VECTOR
+#undef __NATIVESIMD_NAME
+
+// Everything defined in this region is compiled for AVX2, it must only be
+// called if s_native_simd_has_avx2 is true.
+#if defined(__clang__)
+#pragma clang attribute push (__attribute__((target("avx2,popcnt"))), apply_to = function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("avx2,popcnt")
+#endif
+
+struct __MCNativeVector_AVX2
+{
+    typedef __m256i Vector;
+    
+    static const size_t kWidth = 32;
+    static const uint32_t kMask = 0xffffffff;
+    
+    static inline Vector Broadcast(char_t p_char)
+    {
+        return _mm256_set1_epi8(char(p_char));
+    }
+    
+    static inline Vector Load(const char_t *p_chars)
+    {
+        return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p_chars));
+    }
+    
+    static inline Vector Equal(Vector p_left, Vector p_right)
+    {
+        return _mm256_cmpeq_epi8(p_left, p_right);
+    }
+    
+    static inline Vector FoldAscii(Vector p_vector)
+    {
+        // The comparisons are signed, so non-ASCII chars are never in range.
+        Vector t_is_upper;
+        t_is_upper = _mm256_and_si256(_mm256_cmpgt_epi8(p_vector, _mm256_set1_epi8('A' - 1)),
+                                      _mm256_cmpgt_epi8(_mm256_set1_epi8('Z' + 1), p_vector));
+        return _mm256_or_si256(p_vector, _mm256_and_si256(t_is_upper, _mm256_set1_epi8(0x20)));
+    }
+    
+    static inline uint32_t Mask(Vector p_vector)
+    {
+        return uint32_t(_mm256_movemask_epi8(p_vector));
+    }
+    
+    static inline uint32_t Match(const char_t *p_chars, Vector p_a, Vector p_b)
+    {
+        Vector t_chars;
+        t_chars = Load(p_chars);
+        return Mask(_mm256_or_si256(_mm256_cmpeq_epi8(t_chars, p_a), _mm256_cmpeq_epi8(t_chars, p_b)));
+    }
+};
+
+#define __NATIVESIMD_NAME(x) __MCNativeSimd_##x##_AVX2
+#define __NATIVESIMD_VECTOR __MCNativeVector_AVX2
+#include "foundation-string-native-simd.cpp.h"
+#undef __NATIVESIMD_VECTOR
+#undef __NATIVESIMD_NAME
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
+
+#endif /* __NATIVEOP_SIMD */
+
+// Strings shorter than this are compared and scanned with the scalar loops.
+#define __NATIVEOP_SIMD_MIN_LENGTH 16
+
+// The chars which fold to each char (including itself). Each entry holds up to
+// two chars, with the count being 0 before __MCNativeOp_Initialize and 3 if
+// more than two chars fold to it.
+static char_t s_native_unfold_chars[256][2];
+static uint8_t s_native_unfold_count[256];
+
+// Initialize the tables used by the native ops.
+static void __MCNativeOp_Initialize(void)
+{
+    for(uindex_t i = 0; i < 256; i++)
+    {
+        s_native_unfold_chars[i][0] = char_t(i);
+        s_native_unfold_count[i] = 1;
+    }
+    
+    for(uindex_t i = 0; i < 256; i++)
+    {
+        char_t t_folded;
+        t_folded = __MCNativeChar_Fold(char_t(i));
+        if (t_folded == i || s_native_unfold_count[t_folded] > 2)
+            continue;
+        
+        if (s_native_unfold_count[t_folded] == 1)
+            s_native_unfold_chars[t_folded][1] = char_t(i);
+        s_native_unfold_count[t_folded] += 1;
+    }
+    
+    for(uindex_t i = 0; i < 256; i++)
+        if (s_native_unfold_count[i] == 1)
+            s_native_unfold_chars[i][1] = char_t(i);
+    
+#if defined(__NATIVEOP_SIMD)
+    s_native_simd_has_avx2 = __MCNativeSimd_DetectAVX2();
+#endif
+}
+
+// Computes the (at most two) chars for which CharEqual(char, 'char') is true,
+// returning false if this isn't possible.
+template<bool (*CharEqual)(char_t left, char_t right)>
+static inline bool __MCNativeStr_GetCharSet(char_t p_char, char_t r_chars[2])
+{
+    return false;
+}
+
+template<>
+inline bool __MCNativeStr_GetCharSet<__MCNativeChar_Equal_Unfolded>(char_t p_char, char_t r_chars[2])
+{
+    r_chars[0] = p_char;
+    r_chars[1] = p_char;
+    return true;
+}
+
+template<>
+inline bool __MCNativeStr_GetCharSet<__MCNativeChar_Equal_Prefolded>(char_t p_folded_char, char_t r_chars[2])
+{
+    if (s_native_unfold_count[p_folded_char] == 0 ||
+        s_native_unfold_count[p_folded_char] > 2)
+        return false;
+    
+    r_chars[0] = s_native_unfold_chars[p_folded_char][0];
+    r_chars[1] = s_native_unfold_chars[p_folded_char][1];
+    return true;
+}
+
+// Check the two (equal length) strings for equality with the vectorized
+// kernels, if possible.
+template<bool (*CharEqual)(char_t left, char_t right)>
+static inline bool __MCNativeSimd_Equal(const char_t *p_left_chars,
+                                        const char_t *p_right_chars,
+                                        size_t p_length,
+                                        bool& r_equal)
+{
+#if defined(__NATIVEOP_SIMD)
+    if (p_length < __NATIVEOP_SIMD_MIN_LENGTH)
+        return false;
+    
+    if (s_native_simd_has_avx2)
+        r_equal = __MCNativeSimd_Equal_AVX2<CharEqual>(p_left_chars, p_right_chars, p_length);
+    else
+        r_equal = __MCNativeSimd_Equal_SSE2<CharEqual>(p_left_chars, p_right_chars, p_length);
+    
+    return true;
+#else
+    return false;
+#endif
+}
+
+// Scan forward for a single char with the vectorized kernels, if possible.
+template<bool (*CharEqual)(char_t left, char_t right)>
+static inline bool __MCNativeSimd_CharScan(const char_t *p_haystack_chars,
+                                           size_t p_haystack_length,
+                                           char_t p_needle_char,
+                                           size_t p_max_count,
+                                           size_t& r_count,
+                                           size_t *r_offset)
+{
+#if defined(__NATIVEOP_SIMD)
+    char_t t_chars[2];
+    if (p_haystack_length < __NATIVEOP_SIMD_MIN_LENGTH ||
+        !__MCNativeStr_GetCharSet<CharEqual>(p_needle_char, t_chars))
+        return false;
+    
+    if (s_native_simd_has_avx2)
+        r_count = __MCNativeSimd_CharScan_AVX2(p_haystack_chars, p_haystack_length, t_chars[0], t_chars[1], p_max_count, r_offset);
+    else
+        r_count = __MCNativeSimd_CharScan_SSE2(p_haystack_chars, p_haystack_length, t_chars[0], t_chars[1], p_max_count, r_offset);
+    
+    return true;
+#else
+    return false;
+#endif
+}
+
+// Scan forward for a (multi-char) needle with the vectorized kernels, if
+// possible.
+template<bool (*CharEqual)(char_t left, char_t right)>
+static inline bool __MCNativeSimd_Scan(const char_t *p_haystack_chars,
+                                       size_t p_haystack_length,
+                                       const char_t *p_needle_chars,
+                                       size_t p_needle_length,
+                                       size_t p_max_count,
+                                       size_t& r_count,
+                                       size_t *r_offset)
+{
+#if defined(__NATIVEOP_SIMD)
+    char_t t_first[2], t_last[2];
+    if (p_haystack_length < __NATIVEOP_SIMD_MIN_LENGTH ||
+        p_needle_length < 2 ||
+        p_needle_length > p_haystack_length ||
+        !__MCNativeStr_GetCharSet<CharEqual>(p_needle_chars[0], t_first) ||
+        !__MCNativeStr_GetCharSet<CharEqual>(p_needle_chars[p_needle_length - 1], t_last))
+        return false;
+    
+    if (s_native_simd_has_avx2)
+        r_count = __MCNativeSimd_Scan_AVX2<CharEqual>(p_haystack_chars, p_haystack_length, p_needle_chars, p_needle_length, t_first, t_last, p_max_count, r_offset);
+    else
+        r_count = __MCNativeSimd_Scan_SSE2<CharEqual>(p_haystack_chars, p_haystack_length, p_needle_chars, p_needle_length, t_first, t_last, p_max_count, r_offset);
+    
+    return true;
+#else
+    return false;
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 // Check the two strings for equality, using the given char comparison method.
 template<bool (*CharEqual)(char_t left, char_t right)>
 static inline bool
@@ -345,6 +713,10 @@ __MCNativeStr_Equal(const char_t *p_left_chars,
     if (p_left_chars == p_right_chars)
         return true;
     
+    bool t_equal;
+    if (__MCNativeSimd_Equal<CharEqual>(p_left_chars, p_right_chars, p_left_length, t_equal))
+        return t_equal;
+    
     while(p_left_length > 0)
     {
         if (!CharEqual(*p_left_chars++, *p_right_chars++))
@@ -444,15 +816,68 @@ __MCNativeStr_Suffix(const char_t *p_left_chars,
     return t_suffix;
 }
 
+// Hash a block of up to eight chars, packed with the first in the least
+// significant bits, if they are all ASCII. ASCII chars map to themselves in
+// unicode, so they can be (folded and) hashed together.
+template<char_t (*CharFold)(char_t chr)>
+static inline bool
+__MCNativeStr_HashAsciiBlock(MCHashCharsContext& x_context,
+                             uint64_t p_chars,
+                             size_t p_char_count)
+{
+    if ((p_chars & 0x8080808080808080ULL) != 0)
+        return false;
+
+    // Adding 0x80 - 'A' to each char sets its top bit if it is at least 'A',
+    // and adding 0x80 - 'Z' - 1 sets it if it is above 'Z' - the chars are
+    // ASCII so neither addition carries between chars. The upper-case letters
+    // are then lowered by setting 0x20.
+    if (CharFold != __MCNativeChar_NoFold)
+        p_chars |= (((p_chars + 0x3F3F3F3F3F3F3F3FULL) ^
+                     (p_chars + 0x2525252525252525ULL)) & 0x8080808080808080ULL) >> 2;
+
+    x_context.consume_word(MCHashCharsContext::widen(p_chars),
+                           MCMin(p_char_count, size_t(4)));
+    if (p_char_count > 4)
+        x_context.consume_word(MCHashCharsContext::widen(p_chars >> 32),
+                               p_char_count - 4);
+
+    return true;
+}
+
 // Return the hash of the given string, using the given char folding method.
+// The hash is of the chars mapped to unicode, so that it matches the hash of
+// the same string in UTF-16 form. Blocks of eight chars which are all ASCII
+// are hashed together, and only other blocks are mapped char by char.
 template<char_t (*CharFold)(char_t chr)>
 static inline hash_t
 __MCNativeStr_Hash(const char_t *p_chars,
                    size_t p_char_count)
 {
     MCHashCharsContext t_context;
-    while (p_char_count--)
-        t_context.consume(MCUnicodeCharMapFromNative(CharFold(*p_chars++)));
+    for(; p_char_count >= 8; p_char_count -= 8, p_chars += 8)
+    {
+        if (__MCNativeStr_HashAsciiBlock<CharFold>(t_context,
+                                                   MCHashCharsContext::load(p_chars),
+                                                   8))
+            continue;
+
+        for(size_t i = 0; i < 8; i++)
+            t_context.consume(MCUnicodeCharMapFromNative(CharFold(p_chars[i])));
+    }
+
+    if (p_char_count == 0)
+        return t_context;
+
+    uint64_t t_tail;
+    t_tail = 0;
+    for(size_t i = 0; i < p_char_count; i++)
+        t_tail |= uint64_t(p_chars[i]) << (i * 8);
+
+    if (!__MCNativeStr_HashAsciiBlock<CharFold>(t_context, t_tail, p_char_count))
+        while (p_char_count--)
+            t_context.consume(MCUnicodeCharMapFromNative(CharFold(*p_chars++)));
+
     return t_context;
 }
 
@@ -482,6 +907,14 @@ struct __MCNativeStr_Forward
                                   size_t *r_offset)
     {
         size_t t_count;
+        if (__MCNativeSimd_CharScan<CharEqual>(p_haystack_chars,
+                                               p_haystack_length,
+                                               p_needle_char,
+                                               p_max_count,
+                                               t_count,
+                                               r_offset))
+            return t_count;
+        
         t_count = 0;
         
         size_t t_char_offset;
@@ -519,9 +952,18 @@ struct __MCNativeStr_Forward
         if (p_needle_length == 0)
             return 0;
         
+        size_t t_count;
+        if (__MCNativeSimd_Scan<CharEqual>(p_haystack_chars,
+                                           p_haystack_length,
+                                           p_needle_chars,
+                                           p_needle_length,
+                                           p_max_count,
+                                           t_count,
+                                           r_offset))
+            return t_count;
+        
         p_haystack_length -= p_needle_length;
         
-        size_t t_count;
         t_count = 0;
         
         size_t t_char_offset;
@@ -986,14 +1428,18 @@ static bool __MCNativeOp_ForwardCharDelimitedOffset_Core(const char_t *p_haystac
     
     size_t t_end_before;
     t_end_before = 0;
-    for(; p_skip > 0 && t_offset < p_haystack_length; t_offset++)
+    if (p_skip > 0)
     {
-        if (DelimiterCharEqual(p_haystack_chars[t_offset], p_delimiter_char))
-        {
-            p_skip -= 1;
-            t_index += 1;
-            t_end_before = t_offset;
-        }
+        t_index = __MCNativeStr_Forward<DelimiterCharEqual>::CharScan(p_haystack_chars,
+                                                                      p_haystack_length,
+                                                                      p_delimiter_char,
+                                                                      p_skip,
+                                                                      &t_end_before);
+        
+        if (t_index == p_skip)
+            t_offset = t_end_before + 1;
+        else
+            t_offset = p_haystack_length;
     }
     
     size_t t_start_found;
@@ -1007,13 +1453,17 @@ static bool __MCNativeOp_ForwardCharDelimitedOffset_Core(const char_t *p_haystac
     
     t_start_found += t_offset;
     
-    for(; t_offset < t_start_found; t_offset++)
+    size_t t_last_before;
+    size_t t_count_before;
+    t_count_before = __MCNativeStr_Forward<DelimiterCharEqual>::CharScan(p_haystack_chars + t_offset,
+                                                                         t_start_found - t_offset,
+                                                                         p_delimiter_char,
+                                                                         0,
+                                                                         &t_last_before);
+    if (t_count_before > 0)
     {
-        if (DelimiterCharEqual(p_haystack_chars[t_offset], p_delimiter_char))
-        {
-            t_index += 1;
-            t_end_before = t_offset;
-        }
+        t_index += t_count_before;
+        t_end_before = t_offset + t_last_before;
     }
     
     r_index = t_index;
@@ -1026,9 +1476,17 @@ static bool __MCNativeOp_ForwardCharDelimitedOffset_Core(const char_t *p_haystac
     
     if (r_after_offset != nil)
     {
-        for(t_offset = t_start_found + p_needle_length; t_offset < p_haystack_length; t_offset++)
-            if (DelimiterCharEqual(p_haystack_chars[t_offset], p_delimiter_char))
-                break;
+        t_offset = t_start_found + p_needle_length;
+        
+        size_t t_after;
+        if (__MCNativeStr_Forward<DelimiterCharEqual>::CharScan(p_haystack_chars + t_offset,
+                                                                p_haystack_length - t_offset,
+                                                                p_delimiter_char,
+                                                                1,
+                                                                &t_after) == 1)
+            t_offset += t_after;
+        else
+            t_offset = p_haystack_length;
         
         *r_after_offset = t_offset;
     }
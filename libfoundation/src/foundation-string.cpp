@@ -22,6 +22,8 @@ along with LiveCode.  If not see <http://www.gnu.org/licenses/>.  */
 #include "foundation-bidi.h"
 #include "foundation-chunk.h"
 
+#include <algorithm>
+
 #ifdef __LINUX__
 #include <errno.h>
 #include <iconv.h>
@@ -72,6 +74,67 @@ static bool __MCStringResolveIndirect(__MCString *self);
 // Makes direct mutable string indirect, referencing r_new_string.
 static bool __MCStringCopyMutable(__MCString *self, __MCString*& r_new_string);
 
+// Returns true if the chars of the given immutable string are within those of
+// another (its owner).
+static bool __MCStringIsSlice(__MCString *self);
+
+// Returns true if a slice should be used for the given range of self, rather
+// than a copy. If 'always' is false, slices are not used where they would
+// keep a lot more chars alive than they contain.
+static bool __MCStringShouldSlice(__MCString *self, MCRange range, bool always);
+
+// Creates an immutable string referencing the given range of self's chars.
+static bool __MCStringCreateSlice(__MCString *self, MCRange range, __MCString*& r_slice);
+
+// Ensures the chars of a slice are followed by a NUL, copying them if not.
+static bool __MCStringTerminateSlice(__MCString *self);
+
+// Gives the slice or inline string its own (allocated) copy of its chars.
+static bool __MCStringDetachChars(__MCString *self);
+
+// Frees the chars of the direct string, or releases its owner if it is a slice.
+static void __MCStringDeleteChars(__MCString *self);
+
+// Returns true if the chars of the direct string are stored within it.
+static bool __MCStringIsInline(__MCString *self);
+
+// Sets the chars of the new native string to a buffer large enough for the
+// given number of chars and an implicit NUL, within the string if possible.
+static bool __MCStringNewNativeChars(__MCString *self, uindex_t char_count);
+
+// Returns true if the given string is currently held as a rope.
+static bool __MCStringIsRope(__MCString *self);
+
+// Replaces the given indirect string by the direct string holding its chars,
+// first flattening it if it is a rope (which can fail).
+static bool __MCStringDereference(__MCString*& x_self);
+
+// Flattens the rope held by self, making a mutable string an ordinary indirect
+// string and an immutable one direct.
+static bool __MCStringFlattenRope(__MCString *self);
+
+// Creates a string sharing the rope held by self.
+static bool __MCStringShareRope(__MCString *self, bool is_mutable, __MCString*& r_string);
+
+// Gives self its own copy of the rope it holds, if the rope is shared.
+static bool __MCStringUnshareRope(__MCString *self);
+
+// Releases the reference self holds to its rope, freeing it if it was the
+// last.
+static void __MCStringDestroyRope(__MCString *self);
+
+// Returns the length and encoding of the string held as a rope by self.
+static uindex_t __MCStringRopeGetLength(__MCString *self);
+static bool __MCStringRopeIsNative(__MCString *self);
+
+// Copies chars of the rope held by self without flattening it.
+static uindex_t __MCStringRopeGetChars(__MCStringRope *rope, MCRange range, void *chars, bool native);
+
+// Replaces 'range' of self by the given chars as a rope edit, if the string
+// is (or should become) a rope. On success, 'edited' is false if the caller
+// must perform the edit itself.
+static bool __MCStringEditAsRope(__MCString *self, MCRange range, const void *chars, uindex_t char_count, bool native, bool& r_edited);
+
 // Copy the given unicode chars into the target unicode buffer and return true
 // if all the chars being copied in could be native.
 static bool __MCStringCopyChars(unichar_t *target, const unichar_t *source, uindex_t count, bool target_can_be_native);
@@ -81,6 +144,15 @@ static bool MCStringSplitByDelimiterNative(MCStringRef self, MCStringRef p_elem_
 // Check the string and set CanBeNative, Basic and Trivial flags accordingly
 static void __MCStringCheck(MCStringRef self);
 
+// Removes any cached delimiter indices for the string.
+static void __MCStringDiscardDelimiterIndices(MCStringRef self);
+
+// Removes any cached chunk ranges for the string.
+static void __MCStringDiscardBreakIndices(MCStringRef self);
+
+// Maps a range of graphemes or sentences to code units using cached ranges.
+static MCRange __MCStringMapBreakRanges(MCStringRef self, const MCRange *ranges, uindex_t count, MCRange chunk_range);
+
 ////////////////////////////////////////////////////////////////////////////////
 
 // AL-2015-02-06: [[ Bug 14504 ]] Add wrappers for string flag and length checking,
@@ -337,6 +409,17 @@ bool MCStringCreateWithBytes(const byte_t *p_bytes, uindex_t p_byte_count, MCStr
             
         case kMCStringEncodingUTF8:
         {
+            // Most UTF-8 text only has chars which are in the native charset
+            // (often only ASCII ones), so try to decode it straight to native
+            // chars first.
+            char_t *t_native_chars;
+            uindex_t t_native_char_count;
+            if (!MCMemoryAllocate(p_byte_count + 1, t_native_chars))
+                return false;
+            if (MCUnicodeCharsMapFromUTF8ToNative(p_bytes, p_byte_count, t_native_chars, t_native_char_count))
+                return MCStringCreateWithNativeCharBufferAndRelease(t_native_chars, t_native_char_count, p_byte_count + 1, r_string);
+            MCMemoryDeallocate(t_native_chars);
+            
             unichar_t *t_chars;
             uindex_t t_char_count;
             t_char_count = MCUnicodeCharsMapFromUTF8(p_bytes, p_byte_count, nil, 0);
@@ -439,7 +522,11 @@ bool MCStringCreateWithBytesAndRelease(byte_t *p_bytes, uindex_t p_byte_count, M
     {
         case kMCStringEncodingASCII:
         case kMCStringEncodingNative:
-            break;
+            // Short strings hold their chars inline, so have no use for the
+            // buffer.
+            if (p_byte_count >= kMCStringInlineCapacity)
+                break;
+            // fall through
         default:
             if (!MCStringCreateWithBytes(p_bytes, p_byte_count, p_encoding, p_is_external_rep, t_string))
                 return false;
@@ -453,7 +540,7 @@ bool MCStringCreateWithBytesAndRelease(byte_t *p_bytes, uindex_t p_byte_count, M
     t_success = true;
     
     if (t_success)
-        t_success = __MCValueCreate(kMCValueTypeCodeString, t_string);
+        t_success = __MCValueCreateExtended(kMCValueTypeCodeString, kMCStringInlineCapacity, t_string);
     
     if (t_success)
         t_success = MCMemoryReallocate(p_bytes, p_byte_count + 1, p_bytes);
@@ -495,27 +582,35 @@ bool MCStringCreateWithChars(const unichar_t *p_chars, uindex_t p_char_count, MC
 	__MCString *self;
 	self = nil;
 	if (t_success)
-		t_success = __MCValueCreate(kMCValueTypeCodeString, self);
+		t_success = __MCValueCreateExtended(kMCValueTypeCodeString, kMCStringInlineCapacity, self);
 
     bool t_not_native;
     t_not_native = false;
     
     if (t_success)
-        t_success = MCMemoryNewArray(p_char_count + 1, self -> native_chars);
+        t_success = __MCStringNewNativeChars(self, p_char_count);
     
     if (t_success)
     {
-        uindex_t i;
-        for(i = 0; i < p_char_count; i++)
+        for(uindex_t i = 0; i < p_char_count; i++)
+        {
+            size_t t_ascii_length;
+            t_ascii_length = __MCUnicodeAsciiLengthOfChars(p_chars + i, p_char_count - i);
+            __MCUnicodeNarrowChars(p_chars + i, t_ascii_length, self -> native_chars + i);
+            i += t_ascii_length;
+            if (i == p_char_count)
+                break;
+            
             if (!MCUnicodeCharMapToNative(p_chars[i], self -> native_chars[i]))
             {
                 t_not_native = true;
                 break;
             }
+        }
         
         if (t_not_native)
         {
-            MCMemoryDeleteArray(self -> native_chars);
+            __MCStringDeleteChars(self);
             t_success = MCMemoryNewArray(p_char_count + 1, self -> chars);
         }
     }
@@ -579,7 +674,7 @@ bool MCStringCreateUnicodeWithChars(const unichar_t *p_chars, uindex_t p_char_co
     __MCString *self;
     self = nil;
     if (t_success)
-        t_success = __MCValueCreate(kMCValueTypeCodeString, self);
+        t_success = __MCValueCreateExtended(kMCValueTypeCodeString, kMCStringInlineCapacity, self);
     
     if (t_success)
         t_success = MCMemoryNewArray(p_char_count + 1, self -> chars);
@@ -644,10 +739,10 @@ bool MCStringCreateWithNativeChars(const char_t *p_chars, uindex_t p_char_count,
 	__MCString *self;
 	self = nil;
 	if (t_success)
-		t_success = __MCValueCreate(kMCValueTypeCodeString, self);
+		t_success = __MCValueCreateExtended(kMCValueTypeCodeString, kMCStringInlineCapacity, self);
 
 	if (t_success)
-		t_success = MCMemoryNewArray(p_char_count + 1, self -> native_chars);
+		t_success = __MCStringNewNativeChars(self, p_char_count);
 
 	if (t_success)
         MCMemoryCopy(self -> native_chars, p_chars, p_char_count);
@@ -688,10 +783,20 @@ bool MCStringCreateWithNativeCharBufferAndRelease(char_t* p_chars, uindex_t p_ch
         return true;
     }
     
+    // Short strings hold their chars inline, so have no use for the buffer.
+    if (p_char_count < kMCStringInlineCapacity)
+    {
+        if (!MCStringCreateWithNativeChars(p_chars, p_char_count, r_string))
+            return false;
+        
+        MCMemoryDeallocate(p_chars);
+        return true;
+    }
+    
     __MCString *self;
     self = nil;
     if (t_success)
-        t_success = __MCValueCreate(kMCValueTypeCodeString, self);
+        t_success = __MCValueCreateExtended(kMCValueTypeCodeString, kMCStringInlineCapacity, self);
     
     uindex_t t_capacity = p_buffer_length;
     if (t_success && t_capacity < p_char_count + 1)
@@ -722,7 +827,7 @@ static bool MCStringCreateMutableUnicode(uindex_t p_initial_capacity, MCStringRe
 	__MCString *self;
 	self = nil;
 	if (t_success)
-		t_success = __MCValueCreate(kMCValueTypeCodeString, self);
+		t_success = __MCValueCreateExtended(kMCValueTypeCodeString, kMCStringInlineCapacity, self);
     
 	if (t_success)
     {
@@ -753,7 +858,7 @@ bool MCStringCreateMutable(uindex_t p_initial_capacity, MCStringRef& r_string)
 	__MCString *self;
 	self = nil;
 	if (t_success)
-		t_success = __MCValueCreate(kMCValueTypeCodeString, self);
+		t_success = __MCValueCreateExtended(kMCValueTypeCodeString, kMCStringInlineCapacity, self);
 
 	if (t_success)
 		t_success = __MCStringExpandAt(self, 0, p_initial_capacity);
@@ -852,7 +957,7 @@ bool MCStringCreateUnicodeStringFromData(MCDataRef p_data, bool p_is_external_re
     __MCString *self;
     self = nil;
     if (t_success)
-        t_success = __MCValueCreate(kMCValueTypeCodeString, self);
+        t_success = __MCValueCreateExtended(kMCValueTypeCodeString, kMCStringInlineCapacity, self);
     
     uint32_t t_byte_count;
     t_byte_count = MCDataGetLength(p_data);
@@ -1329,10 +1434,20 @@ bool MCStringCopy(MCStringRef self, MCStringRef& r_new_string)
 		return true;
 	}
     
+    // A rope is shared by the copy (which is an immutable rope) rather than
+    // being flattened.
+    if (__MCStringIsRope(self) &&
+        !__MCValueIsThreadingEnabled())
+        return __MCStringShareRope(self, false, r_new_string);
+    
     // If it is mutable and indirect then retain the referenced string
     if (__MCStringIsIndirect(self))
     {
-        r_new_string = MCValueRetain(self -> string);
+        MCStringRef t_string;
+        t_string = self;
+        if (!__MCStringDereference(t_string))
+            return false;
+        r_new_string = MCValueRetain(t_string);
         return true;
     }
 
@@ -1354,10 +1469,21 @@ bool MCStringCopyAndRelease(MCStringRef self, MCStringRef& r_new_string)
 		return true;
 	}
 
+    // A rope with no other references can just become immutable.
+    if (__MCStringIsRope(self) &&
+        self -> references == 1 &&
+        !__MCValueIsThreadingEnabled())
+    {
+        self -> flags &= ~kMCStringFlagIsMutable;
+        r_new_string = self;
+        return true;
+    }
+    
     // If the string is indirect then retain its reference, and release
     if (__MCStringIsIndirect(self))
     {
-        r_new_string = MCValueRetain(self -> string);
+        if (!MCStringCopy(self, r_new_string))
+            return false;
         MCValueRelease(self);
         return true;
     }
@@ -1376,11 +1502,11 @@ bool MCStringCopyAndRelease(MCStringRef self, MCStringRef& r_new_string)
     if (!__MCStringMakeIndirect(self))
         return false;
     
-    // Reduce reference count
-    self -> references -= 1;
-    
-    // And return a copy of the string
+    // Return a copy of the string
     r_new_string = MCValueRetain(self -> string);
+    
+    // And reduce reference count
+    MCValueRelease(self);
     return true;
 }
 
@@ -1389,14 +1515,28 @@ bool MCStringMutableCopy(MCStringRef self, MCStringRef& r_new_string)
 {
 	__MCAssertIsString(self);
 
+    // A rope (which may be immutable) is shared by the copy.
+    if (__MCStringIsRope(self) &&
+        !__MCValueIsThreadingEnabled())
+        return __MCStringShareRope(self, true, r_new_string);
+    
 	// If self is immutable, then the new mutable string will be indirect
 	// referencing it.
     if (!MCStringIsMutable(self))
+    {
+        if (__MCStringIsIndirect(self) &&
+            !__MCStringDereference(self))
+            return false;
         return __MCStringCreateIndirect(self, r_new_string);
+    }
 
     // If the string is already indirect, we just create a new reference to its string
 	if (__MCStringIsIndirect(self))
-		return __MCStringCreateIndirect(self -> string, r_new_string);
+    {
+        if (!__MCStringDereference(self))
+            return false;
+		return __MCStringCreateIndirect(self, r_new_string);
+    }
     
     // If the string is mutable, we make it indirect and share
 	// the indirect copy.
@@ -1415,6 +1555,19 @@ bool MCStringMutableCopyAndRelease(MCStringRef self, MCStringRef& r_new_string)
 	{
 		if (!MCStringIsMutable(self))
         {
+            // Any cached delimiter offsets or chunk ranges will be invalid
+            // once the string is changed.
+            if ((self -> flags & kMCStringFlagHasDelimiterIndex) != 0)
+                __MCStringDiscardDelimiterIndices(self);
+            if ((self -> flags & kMCStringFlagHasBreakIndex) != 0)
+                __MCStringDiscardBreakIndices(self);
+            
+            // The chars of a slice are shared and those of an inline string
+            // cannot grow, so either needs its own buffer to be changed.
+            if ((__MCStringIsSlice(self) || __MCStringIsInline(self)) &&
+                !__MCStringDetachChars(self))
+                return false;
+            
 			self -> flags |= kMCStringFlagIsMutable;
             //self -> capacity = self -> char_count;
         }
@@ -1426,7 +1579,7 @@ bool MCStringMutableCopyAndRelease(MCStringRef self, MCStringRef& r_new_string)
 	if (!MCStringMutableCopy(self, r_new_string))
 		return false;
     
-	self -> references -= 1;
+	MCValueRelease(self);
 	return true;
 }
 
@@ -1437,8 +1590,9 @@ bool MCStringCopySubstring(MCStringRef self, MCRange p_range, MCStringRef& r_sub
 {
 	__MCAssertIsString(self);
 
-    if (__MCStringIsIndirect(self))
-        self = self -> string;
+    if (__MCStringIsIndirect(self) &&
+        !__MCStringDereference(self))
+        return false;
     
     // Avoid copying in case the substring is actually the whole string
     if (p_range . offset == 0 && self -> char_count < p_range . length)
@@ -1446,12 +1600,32 @@ bool MCStringCopySubstring(MCStringRef self, MCRange p_range, MCStringRef& r_sub
 
 	__MCStringClampRange(self, p_range);
 	
+    if (__MCStringShouldSlice(self, p_range, false))
+        return __MCStringCreateSlice(self, p_range, r_substring);
+    
     if (__MCStringIsNative(self))
         return MCStringCreateWithNativeChars(self -> native_chars + p_range . offset, p_range . length, r_substring);
     
 	return MCStringCreateWithChars(self -> chars + p_range . offset, p_range . length, r_substring);
 }
 
+MC_DLLEXPORT_DEF
+bool MCStringCopySubstringShared(MCStringRef self, MCRange p_range, MCStringRef& r_substring)
+{
+	__MCAssertIsString(self);
+    
+    if (__MCStringIsIndirect(self) &&
+        !__MCStringDereference(self))
+        return false;
+    
+    __MCStringClampRange(self, p_range);
+    
+    if (__MCStringShouldSlice(self, p_range, true))
+        return __MCStringCreateSlice(self, p_range, r_substring);
+    
+    return MCStringCopySubstring(self, p_range, r_substring);
+}
+
 MC_DLLEXPORT_DEF
 bool MCStringCopySubstringAndRelease(MCStringRef self, MCRange p_range, MCStringRef& r_substring)
 {
@@ -1469,8 +1643,9 @@ bool MCStringMutableCopySubstring(MCStringRef self, MCRange p_range, MCStringRef
 {
 	__MCAssertIsString(self);
 
-    if (__MCStringIsIndirect(self))
-        self = self -> string;
+    if (__MCStringIsIndirect(self) &&
+        !__MCStringDereference(self))
+        return false;
     
     __MCStringClampRange(self, p_range);
     
@@ -1560,10 +1735,9 @@ bool MCStringCopyReversed(MCStringRef self, MCStringRef& r_new_string)
          * reverse by iterating over the contents of the original
          * string, copying the graphemes into the new string. */
         MCStringRef t_original = self;
-        if (__MCStringIsIndirect(t_original))
-        {
-            t_original = t_original->string;    
-        }
+        if (__MCStringIsIndirect(t_original) &&
+            !__MCStringDereference(t_original))
+            return false;
 
         /* Start of the next grapheme to copy, in the input string */
         uindex_t t_from = 0;
@@ -1609,6 +1783,10 @@ uindex_t MCStringGetLength(MCStringRef self)
 {
 	__MCAssertIsString(self);
 
+    // A rope knows its length and encoding without being flattened.
+    if (__MCStringIsRope(self))
+        return __MCStringRopeGetLength(self);
+    
     if (__MCStringIsIndirect(self))
         self = self -> string;
     
@@ -1629,6 +1807,10 @@ const unichar_t *MCStringGetCharPtr(MCStringRef self)
 		return nil;
 	}
 
+    // Callers may rely on the chars being followed by a NUL.
+    if (!__MCStringTerminateSlice(self))
+        return nil;
+    
 	return self -> chars;
 }
 
@@ -1644,6 +1826,10 @@ const char_t *MCStringGetNativeCharPtr(MCStringRef self)
 			if (!__MCStringResolveIndirect(self))
 				return nil;
         
+        // Callers may rely on the chars being followed by a NUL.
+        if (!__MCStringTerminateSlice(self))
+            return nil;
+        
         return self -> native_chars;
     }
     
@@ -1657,6 +1843,10 @@ const char_t *MCStringGetNativeCharPtrAndLength(MCStringRef self, uindex_t& r_ch
 
 	if (__MCStringNativize(self, r_char_count))
 	{
+        // Callers may rely on the chars being followed by a NUL.
+        if (!__MCStringTerminateSlice(self))
+            return nil;
+        
 		return self->native_chars;
 	}
 	else
@@ -1670,8 +1860,14 @@ unichar_t MCStringGetCharAtIndex(MCStringRef self, uindex_t p_index)
 {
 	__MCAssertIsString(self);
 
-    if (__MCStringIsIndirect(self))
-        self = self -> string;
+    if (__MCStringIsIndirect(self) &&
+        !__MCStringDereference(self))
+    {
+        unichar_t t_char;
+        t_char = 0;
+        __MCStringRopeGetChars(self -> rope, MCRangeMake(p_index, 1), &t_char, false);
+        return t_char;
+    }
 
     /* Allow trailing null character */
     MCAssert(p_index <= MCStringGetLength(self));
@@ -1687,8 +1883,14 @@ char_t MCStringGetNativeCharAtIndex(MCStringRef self, uindex_t p_index)
 {
 	__MCAssertIsString(self);
 
-    if (__MCStringIsIndirect(self))
-        self = self -> string;
+    if (__MCStringIsIndirect(self) &&
+        !__MCStringDereference(self))
+    {
+        char_t t_char;
+        t_char = 0;
+        __MCStringRopeGetChars(self -> rope, MCRangeMake(p_index, 1), &t_char, true);
+        return t_char;
+    }
 
     /* Allow trailing null character */
     MCAssert(p_index <= __MCStringGetLength(self));
@@ -1707,8 +1909,16 @@ codepoint_t MCStringGetCodepointAtIndex(MCStringRef self, uindex_t p_index)
 {
 	__MCAssertIsString(self);
  
-    if (__MCStringIsIndirect(self))
-        self = self -> string;
+    if (__MCStringIsIndirect(self) &&
+        !__MCStringDereference(self))
+    {
+        unichar_t t_chars[2] = {0, 0};
+        __MCStringRopeGetChars(self -> rope, MCRangeMake(p_index, 2), t_chars, false);
+        if (MCUnicodeCodepointIsLeadingSurrogate(t_chars[0]) &&
+            MCUnicodeCodepointIsTrailingSurrogate(t_chars[1]))
+            return MCUnicodeSurrogatesToCodepoint(t_chars[0], t_chars[1]);
+        return t_chars[0];
+    }
     
     /* Allow trailing null character */
     MCAssert(p_index <= MCStringGetLength(self));
@@ -1738,23 +1948,19 @@ uindex_t MCStringGetChars(MCStringRef self, MCRange p_range, unichar_t *p_chars)
 {
 	__MCAssertIsString(self);
 
-    if (__MCStringIsIndirect(self))
-        self = self -> string;
+    if (__MCStringIsIndirect(self) &&
+        !__MCStringDereference(self))
+        return __MCStringRopeGetChars(self -> rope, p_range, p_chars, false);
     
 	uindex_t t_count;
 	t_count = 0;
+    if (p_range . offset < self -> char_count)
+        t_count = MCMin(p_range . length, self -> char_count - p_range . offset);
 
-	for(uindex_t i = p_range . offset; i < p_range . offset + p_range . length; i++)
-	{
-		if (i >= self -> char_count)
-			break;
-        if (__MCStringIsNative(self))
-            p_chars[i - p_range . offset] = MCUnicodeCharMapFromNative(self -> native_chars[i]);
-        else
-            p_chars[i - p_range . offset] = MCStrCharMapToUnicode(self -> chars[i]);
-
-		t_count += 1;
-	}
+    if (__MCStringIsNative(self))
+        MCUnicodeCharsMapFromNative(self -> native_chars + p_range . offset, t_count, p_chars);
+    else
+        MCStrCharsMapFromUnicode(self -> chars + p_range . offset, t_count, p_chars, t_count);
 
 	return t_count;
 }
@@ -1764,24 +1970,19 @@ uindex_t MCStringGetNativeChars(MCStringRef self, MCRange p_range, char_t *p_cha
 {
 	__MCAssertIsString(self);
 
-    if (__MCStringIsIndirect(self))
-        self = self -> string;
+    if (__MCStringIsIndirect(self) &&
+        !__MCStringDereference(self))
+        return __MCStringRopeGetChars(self -> rope, p_range, p_chars, true);
     
 	uindex_t t_count;
 	t_count = 0;
+    if (p_range . offset < self -> char_count)
+        t_count = MCMin(p_range . length, self -> char_count - p_range . offset);
 
-	for(uindex_t i = p_range . offset; i < p_range . offset + p_range . length; i++)
-	{
-		if (i >= self -> char_count)
-			break;
-        
-        if (__MCStringIsNative(self))
-            p_chars[i - p_range . offset] = self -> native_chars[i];
-        else
-            p_chars[i - p_range . offset] = MCStrCharMapToNative(self -> chars[i]);
-
-		t_count += 1;
-	}
+    if (__MCStringIsNative(self))
+        MCMemoryCopy(p_chars, self -> native_chars + p_range . offset, t_count);
+    else
+        MCUnicodeCharsMapToNative(self -> chars + p_range . offset, t_count, p_chars, t_count, '?');
 
 	return t_count;
 }
@@ -1840,8 +2041,13 @@ bool MCStringIsNative(MCStringRef self)
 {
 	__MCAssertIsString(self);
 
-    if (__MCStringIsIndirect(self))
-        self = self -> string;
+    // A rope knows its length and encoding without being flattened.
+    if (__MCStringIsRope(self))
+        return __MCStringRopeIsNative(self);
+    
+    if (__MCStringIsIndirect(self) &&
+        !__MCStringDereference(self))
+        return false;
     
     return __MCStringIsNative(self);
 }
@@ -1851,8 +2057,9 @@ bool MCStringCantBeEqualToNative(MCStringRef self, MCStringOptions p_options)
 {
 	__MCAssertIsString(self);
 
-    if (__MCStringIsIndirect(self))
-        self = self -> string;
+    if (__MCStringIsIndirect(self) &&
+        !__MCStringDereference(self))
+        return false;
     
     return __MCStringCantBeEqualToNative(self, p_options);
 }
@@ -1862,8 +2069,9 @@ bool MCStringCanBeNative(MCStringRef self)
 {
 	__MCAssertIsString(self);
 
-    if (__MCStringIsIndirect(self))
-        self = self -> string;
+    if (__MCStringIsIndirect(self) &&
+        !__MCStringDereference(self))
+        return false;
     
     return __MCStringCanBeNative(self);
 }
@@ -1874,8 +2082,9 @@ bool MCStringIsBasic(MCStringRef self)
 {
 	__MCAssertIsString(self);
 
-    if (__MCStringIsIndirect(self))
-        self = self -> string;
+    if (__MCStringIsIndirect(self) &&
+        !__MCStringDereference(self))
+        return false;
     
     return __MCStringIsBasic(self);
 }
@@ -1886,8 +2095,9 @@ bool MCStringIsTrivial(MCStringRef self)
 {
 	__MCAssertIsString(self);
 
-    if (__MCStringIsIndirect(self))
-        self = self -> string;
+    if (__MCStringIsIndirect(self) &&
+        !__MCStringDereference(self))
+        return false;
     
     return __MCStringIsTrivial(self);
 }
@@ -1897,8 +2107,9 @@ bool MCStringMapCodepointIndices(MCStringRef self, MCRange p_in_range, MCRange &
 {
 	__MCAssertIsString(self);
 
-    if (__MCStringIsIndirect(self))
-        self = self -> string;
+    if (__MCStringIsIndirect(self) &&
+        !__MCStringDereference(self))
+        return false;
     
     MCAssert(self != nil);
     
@@ -1959,8 +2170,9 @@ bool MCStringUnmapCodepointIndices(MCStringRef self, MCRange p_in_range, MCRange
 	__MCAssertIsString(self);
     
     // AL-2015-02-06: [[ Bug 14504 ]] Use direct string for checks here, as the flags are not set on the indirect string.
-    if (__MCStringIsIndirect(self))
-        self = self -> string;
+    if (__MCStringIsIndirect(self) &&
+        !__MCStringDereference(self))
+        return false;
     
     // Shortcut for strings containing only BMP characters
     if (__MCStringCanBeNative(self) || (__MCStringIsBasic(self)))
@@ -2006,8 +2218,9 @@ bool MCStringMapIndices(MCStringRef self, MCBreakIteratorType p_type, MCLocaleRe
 	__MCAssertIsString(self);
 	__MCAssertIsLocale(p_locale);
     
-    if (__MCStringIsIndirect(self))
-        self = self -> string;
+    if (__MCStringIsIndirect(self) &&
+        !__MCStringDereference(self))
+        return false;
     
     // Create the appropriate break iterator
     MCAutoCustomPointer<__MCBreakIterator,MCLocaleBreakIteratorRelease> t_iter;
@@ -2049,8 +2262,9 @@ bool MCStringMapGraphemeIndices(MCStringRef self, MCRange p_grapheme_range, MCRa
 {
 	__MCAssertIsString(self);
 
-    if (__MCStringIsIndirect(self))
-        self = self -> string;
+    if (__MCStringIsIndirect(self) &&
+        !__MCStringDereference(self))
+        return false;
     
     // Quick-n-dirty workaround
     if (__MCStringIsNative(self) || __MCStringIsTrivial(self))
@@ -2060,6 +2274,14 @@ bool MCStringMapGraphemeIndices(MCStringRef self, MCRange p_grapheme_range, MCRa
         return true;
     }
 
+    const MCRange *t_ranges;
+    uindex_t t_range_count;
+    if (MCStringFetchBreakRanges(self, kMCBreakIteratorTypeCharacter, nil, t_ranges, t_range_count))
+    {
+        r_cu_range = __MCStringMapBreakRanges(self, t_ranges, t_range_count, p_grapheme_range);
+        return true;
+    }
+
     // Find the beginning of the range
     uindex_t t_start;
     t_start = 0;
@@ -2100,6 +2322,28 @@ bool MCStringMapTrueWordIndices(MCStringRef self, MCLocaleRef p_locale, MCRange
 	__MCAssertIsString(self);
 	__MCAssertIsLocale(p_locale);
     
+    const MCRange *t_ranges;
+    uindex_t t_range_count;
+    if (MCStringFetchBreakRanges(self, kMCBreakIteratorTypeWord, p_locale, t_ranges, t_range_count))
+    {
+        if (p_in_range . offset >= t_range_count)
+        {
+            r_out_range = MCRangeMake(MCStringGetLength(self), 0);
+            return true;
+        }
+        
+        // As below, an empty range runs to the end of the last word.
+        uindex_t t_last;
+        if (p_in_range . length == 0 || p_in_range . length > t_range_count - p_in_range . offset)
+            t_last = t_range_count - 1;
+        else
+            t_last = p_in_range . offset + p_in_range . length - 1;
+        
+        r_out_range = MCRangeMakeMinMax(t_ranges[p_in_range . offset] . offset,
+                                        t_ranges[t_last] . offset + t_ranges[t_last] . length);
+        return true;
+    }
+    
     // Create the appropriate break iterator
     MCBreakIteratorRef t_iter;
     if (!MCLocaleBreakIteratorCreate(p_locale, kMCBreakIteratorTypeWord, t_iter))
@@ -2147,6 +2391,18 @@ bool MCStringMapTrueWordIndices(MCStringRef self, MCLocaleRef p_locale, MCRange
 MC_DLLEXPORT_DEF
 bool MCStringMapSentenceIndices(MCStringRef self, MCLocaleRef p_locale, MCRange p_in_range, MCRange &r_out_range)
 {
+    const MCRange *t_ranges;
+    uindex_t t_range_count;
+    if (MCStringFetchBreakRanges(self, kMCBreakIteratorTypeSentence, p_locale, t_ranges, t_range_count))
+    {
+        if (__MCStringIsIndirect(self) &&
+            !__MCStringDereference(self))
+            return false;
+        
+        r_out_range = __MCStringMapBreakRanges(self, t_ranges, t_range_count, p_in_range);
+        return true;
+    }
+    
     return MCStringMapIndices(self, kMCBreakIteratorTypeSentence, p_locale, p_in_range, r_out_range);
 }
 
@@ -2210,8 +2466,9 @@ static bool __MCStringFetchCodepointBefore(MCStringRef self, uindex_t& x_index,
 {
     __MCAssertIsString(self);
     
-    if (__MCStringIsIndirect(self))
-        self = self -> string;
+    if (__MCStringIsIndirect(self) &&
+        !__MCStringDereference(self))
+        return false;
     
     if (x_index > self -> char_count)
         return false;
@@ -2241,8 +2498,9 @@ static bool __MCStringFetchCodepointAfter(MCStringRef self, uindex_t& x_index, c
 {
     __MCAssertIsString(self);
     
-    if (__MCStringIsIndirect(self))
-        self = self -> string;
+    if (__MCStringIsIndirect(self) &&
+        !__MCStringDereference(self))
+        return false;
         
     if (x_index >= self -> char_count)
         return false;
@@ -2269,8 +2527,9 @@ uindex_t MCStringGraphemeBreakIteratorAdvance(MCStringRef self, uindex_t p_from)
 {
     __MCAssertIsString(self);
     
-    if (__MCStringIsIndirect(self))
-        self = self -> string;
+    if (__MCStringIsIndirect(self) &&
+        !__MCStringDereference(self))
+        return kMCLocaleBreakIteratorDone;
     
     if (__MCStringIsTrivial(self))
     {
@@ -2285,19 +2544,23 @@ uindex_t MCStringGraphemeBreakIteratorAdvance(MCStringRef self, uindex_t p_from)
     uindex_t t_next;
     t_next = p_from;
     
-    uindex_t t_dummy;
+    if (!__MCStringFetchCodepointAfter(self, t_next, t_left_codepoint))
+        return kMCLocaleBreakIteratorDone;
+    
+    // Step through the codepoints until there is a boundary between the pair
+    // either side of t_next, carrying each over as the next left codepoint.
+    uindex_t t_after;
     for (;;)
     {
-        // Resolve the next two codepoints
-        if (!__MCStringFetchCodepointAfter(self, t_next, t_left_codepoint))
-            return kMCLocaleBreakIteratorDone;
-        
-        t_dummy = t_next;
-        if (!__MCStringFetchCodepointAfter(self, t_dummy, t_right_codepoint))
+        t_after = t_next;
+        if (!__MCStringFetchCodepointAfter(self, t_after, t_right_codepoint))
             return kMCLocaleBreakIteratorDone;
         
         if (MCUnicodeIsGraphemeClusterBoundary(t_left_codepoint, t_right_codepoint))
             break;
+        
+        t_left_codepoint = t_right_codepoint;
+        t_next = t_after;
     }
     
     if (t_next >= self -> char_count)
@@ -2312,8 +2575,9 @@ uindex_t MCStringGraphemeBreakIteratorRetreat(MCStringRef self, uindex_t p_from)
 {
     __MCAssertIsString(self);
     
-    if (__MCStringIsIndirect(self))
-        self = self -> string;
+    if (__MCStringIsIndirect(self) &&
+        !__MCStringDereference(self))
+        return kMCLocaleBreakIteratorDone;
 
     if (__MCStringIsTrivial(self))
     {
@@ -2378,8 +2642,9 @@ bool MCStringUnmapGraphemeIndices(MCStringRef self, MCRange p_cu_range, MCRange
 {    
 	__MCAssertIsString(self);
 
-    if (__MCStringIsIndirect(self))
-        self = self -> string;
+    if (__MCStringIsIndirect(self) &&
+        !__MCStringDereference(self))
+        return false;
     
     __MCStringClampRange(self, p_cu_range);
     
@@ -2405,8 +2670,9 @@ bool MCStringUnmapTrueWordIndices(MCStringRef self, MCLocaleRef p_locale, MCRang
 	__MCAssertIsString(self);
 	__MCAssertIsLocale(p_locale);
 
-	if (__MCStringIsIndirect(self))
-		self = self->string;
+	if (__MCStringIsIndirect(self) &&
+	    !__MCStringDereference(self))
+	    return false;
     
     // Check that the input range is valid
 	if (p_in_range.offset + p_in_range.length > __MCStringGetLength(self))
@@ -2785,32 +3051,31 @@ bool MCStringConvertToUTF8(MCStringRef p_string, char*& r_utf8string, uindex_t&
 {
 	__MCAssertIsString(p_string);
 
-	// Allocate an array of chars one byte bigger than needed. As the allocated array
-	// is filled with zeros, this will naturally NUL terminate the string.
-    uindex_t t_length;
-    uindex_t t_byte_count;
-    unichar_t* t_unichars;
-	t_length = MCStringGetLength(p_string);
-    
-    if (!MCMemoryNewArray(t_length + 1, t_unichars))
+    __MCString *self;
+    self = p_string;
+    if (__MCStringIsIndirect(self) &&
+        !__MCStringDereference(self))
         return false;
     
-    uindex_t t_char_count = MCStringGetChars(p_string, MCRangeMake(0, t_length), t_unichars);
-    
-    t_byte_count = MCUnicodeCharsMapToUTF8(t_unichars, t_char_count, nil, 0);
+    // Native and unicode chars are both converted in place, without making a
+    // unicode copy of native chars first.
+    uindex_t t_byte_count;
+    if (__MCStringIsNative(self))
+        t_byte_count = MCNativeCharsMapToUTF8(self -> native_chars, self -> char_count, nil, 0);
+    else
+        t_byte_count = MCUnicodeCharsMapToUTF8(self -> chars, self -> char_count, nil, 0);
     
+	// Allocate an array of chars one byte bigger than needed. As the allocated array
+	// is filled with zeros, this will naturally NUL terminate the string.
     if (!MCMemoryNewArray(t_byte_count + 1, r_utf8string))
-	{
-		MCMemoryDeleteArray (t_unichars);
         return false;
-	}
     
-    MCUnicodeCharsMapToUTF8(t_unichars, t_char_count, (byte_t*)r_utf8string, t_byte_count);
+    if (__MCStringIsNative(self))
+        MCNativeCharsMapToUTF8(self -> native_chars, self -> char_count, (byte_t*)r_utf8string, t_byte_count);
+    else
+        MCUnicodeCharsMapToUTF8(self -> chars, self -> char_count, (byte_t*)r_utf8string, t_byte_count);
 	r_utf8_chars = t_byte_count;
     
-    // Delete temporary unichar_t array
-    MCMemoryDeleteArray(t_unichars);
-    
     return true;
 }
 
@@ -2937,8 +3202,11 @@ hash_t MCStringHash(MCStringRef self, MCStringOptions p_options)
 {
 	__MCAssertIsString(self);
 
-    if (__MCStringIsIndirect(self))
-        self = self -> string;
+    // If the string can't be flattened, there is no way to report it, so it
+    // hashes as empty.
+    if (__MCStringIsIndirect(self) &&
+        !__MCStringDereference(self))
+        self = kMCEmptyString;
     
     if (__MCStringIsNative(self))
         return __MCNativeOp_Hash(self -> native_chars,
@@ -2954,11 +3222,13 @@ bool MCStringIsEqualTo(MCStringRef self, MCStringRef p_other, MCStringOptions p_
 	__MCAssertIsString(self);
 	__MCAssertIsString(p_other);
 
-    if (__MCStringIsIndirect(self))
-        self = self -> string;
+    if (__MCStringIsIndirect(self) &&
+        !__MCStringDereference(self))
+        return false;
     
-    if (__MCStringIsIndirect(p_other))
-        p_other = p_other -> string;
+    if (__MCStringIsIndirect(p_other) &&
+        !__MCStringDereference(p_other))
+        return false;
     
 	if (self == p_other)
         return true;
@@ -3023,8 +3293,9 @@ bool MCStringIsInteger(MCStringRef self)
 {
     __MCAssertIsString(self);
     
-    if (__MCStringIsIndirect(self))
-        self = self -> string;
+    if (__MCStringIsIndirect(self) &&
+        !__MCStringDereference(self))
+        return false;
     
     if (__MCStringIsNative(self))
         return __MCStringIsInteger(self->native_chars, self->char_count);
@@ -3038,11 +3309,13 @@ bool MCStringSubstringIsEqualTo(MCStringRef self, MCRange p_sub, MCStringRef p_o
 	__MCAssertIsString(self);
 	__MCAssertIsString(p_other);
 
-    if (__MCStringIsIndirect(self))
-        self = self -> string;
+    if (__MCStringIsIndirect(self) &&
+        !__MCStringDereference(self))
+        return false;
     
-    if (__MCStringIsIndirect(p_other))
-        p_other = p_other -> string;
+    if (__MCStringIsIndirect(p_other) &&
+        !__MCStringDereference(p_other))
+        return false;
     
 	__MCStringClampRange(self, p_sub);
     
@@ -3073,11 +3346,13 @@ bool MCStringSubstringIsEqualToSubstring(MCStringRef self, MCRange p_sub, MCStri
 	__MCAssertIsString(self);
 	__MCAssertIsString(p_other);
 
-    if (__MCStringIsIndirect(self))
-        self = self -> string;
+    if (__MCStringIsIndirect(self) &&
+        !__MCStringDereference(self))
+        return false;
     
-    if (__MCStringIsIndirect(p_other))
-        p_other = p_other -> string;
+    if (__MCStringIsIndirect(p_other) &&
+        !__MCStringDereference(p_other))
+        return false;
     
 	__MCStringClampRange(self, p_sub);
     __MCStringClampRange(p_other, p_other_sub);
@@ -3125,8 +3400,9 @@ bool MCStringSubstringIsEqualToNativeChars(MCStringRef self, MCRange p_range, co
     
     if (MCStringIsNative(self))
     {
-        if (__MCStringIsIndirect(self))
-            self = self -> string;
+        if (__MCStringIsIndirect(self) &&
+            !__MCStringDereference(self))
+            return false;
         
         __MCStringClampRange(self, p_range);
         
@@ -3151,11 +3427,15 @@ compare_t MCStringCompareTo(MCStringRef self, MCStringRef p_other, MCStringOptio
 	__MCAssertIsString(self);
 	__MCAssertIsString(p_other);
 
-    if (__MCStringIsIndirect(self))
-        self = self -> string;
+    // If either string can't be flattened, there is no way to report it, so
+    // it compares as empty.
+    if (__MCStringIsIndirect(self) &&
+        !__MCStringDereference(self))
+        self = kMCEmptyString;
     
-    if (__MCStringIsIndirect(p_other))
-        p_other = p_other -> string;
+    if (__MCStringIsIndirect(p_other) &&
+        !__MCStringDereference(p_other))
+        p_other = kMCEmptyString;
     
     if (__MCStringIsNative(self) &&
         __MCStringIsNative(p_other))
@@ -3176,11 +3456,13 @@ bool MCStringBeginsWith(MCStringRef self, MCStringRef p_prefix, MCStringOptions
 	__MCAssertIsString(self);
 	__MCAssertIsString(p_prefix);
 
-    if (__MCStringIsIndirect(self))
-        self = self -> string;
+    if (__MCStringIsIndirect(self) &&
+        !__MCStringDereference(self))
+        return false;
     
-    if (__MCStringIsIndirect(p_prefix))
-        p_prefix = p_prefix -> string;
+    if (__MCStringIsIndirect(p_prefix) &&
+        !__MCStringDereference(p_prefix))
+        return false;
     
     if (__MCStringIsNative(self))
     {
@@ -3211,11 +3493,13 @@ bool MCStringSharedPrefix(MCStringRef self, MCRange p_range, MCStringRef p_prefi
 	__MCAssertIsString(self);
 	__MCAssertIsString(p_prefix);
 
-    if (__MCStringIsIndirect(self))
-        self = self -> string;
+    if (__MCStringIsIndirect(self) &&
+        !__MCStringDereference(self))
+        return false;
     
-    if (__MCStringIsIndirect(p_prefix))
-        p_prefix = p_prefix -> string;
+    if (__MCStringIsIndirect(p_prefix) &&
+        !__MCStringDereference(p_prefix))
+        return false;
     
     __MCStringClampRange(self, p_range);
     
@@ -3255,8 +3539,9 @@ bool MCStringBeginsWithCString(MCStringRef self, const char_t *p_prefix_cstring,
 	__MCAssertIsString(self);
 	MCAssert(nil != p_prefix_cstring);
 
-    if (__MCStringIsIndirect(self))
-        self = self -> string;
+    if (__MCStringIsIndirect(self) &&
+        !__MCStringDereference(self))
+        return false;
     
     if (__MCStringIsNative(self))
     {
@@ -3278,11 +3563,13 @@ bool MCStringEndsWith(MCStringRef self, MCStringRef p_suffix, MCStringOptions p_
 	__MCAssertIsString(self);
 	__MCAssertIsString(p_suffix);
 
-    if (__MCStringIsIndirect(self))
-        self = self -> string;
+    if (__MCStringIsIndirect(self) &&
+        !__MCStringDereference(self))
+        return false;
     
-    if (__MCStringIsIndirect(p_suffix))
-        p_suffix = p_suffix -> string;
+    if (__MCStringIsIndirect(p_suffix) &&
+        !__MCStringDereference(p_suffix))
+        return false;
     
     if (__MCStringIsNative(self))
     {
@@ -3314,11 +3601,13 @@ bool MCStringSharedSuffix(MCStringRef self, MCRange p_range, MCStringRef p_suffi
 	__MCAssertIsString(self);
 	__MCAssertIsString(p_suffix);
 
-    if (__MCStringIsIndirect(self))
-        self = self -> string;
+    if (__MCStringIsIndirect(self) &&
+        !__MCStringDereference(self))
+        return false;
     
-    if (__MCStringIsIndirect(p_suffix))
-        p_suffix = p_suffix -> string;
+    if (__MCStringIsIndirect(p_suffix) &&
+        !__MCStringDereference(p_suffix))
+        return false;
     
     __MCStringClampRange(self, p_range);
     
@@ -3358,8 +3647,9 @@ bool MCStringEndsWithCString(MCStringRef self, const char_t *p_suffix_cstring, M
 	__MCAssertIsString(self);
 	MCAssert(nil != p_suffix_cstring);
 
-    if (__MCStringIsIndirect(self))
-        self = self -> string;
+    if (__MCStringIsIndirect(self) &&
+        !__MCStringDereference(self))
+        return false;
     
     if (__MCStringIsNative(self))
     {
@@ -3384,11 +3674,13 @@ bool MCStringContains(MCStringRef self, MCStringRef p_needle, MCStringOptions p_
     if (MCStringIsEmpty(p_needle))
         return false;
     
-    if (__MCStringIsIndirect(self))
-        self = self -> string;
+    if (__MCStringIsIndirect(self) &&
+        !__MCStringDereference(self))
+        return false;
     
-    if (__MCStringIsIndirect(p_needle))
-        p_needle = p_needle -> string;
+    if (__MCStringIsIndirect(p_needle) &&
+        !__MCStringDereference(p_needle))
+        return false;
 
     if (__MCStringIsNative(self))
     {
@@ -3414,16 +3706,18 @@ bool MCStringSubstringContains(MCStringRef self, MCRange p_range, MCStringRef p_
 	__MCAssertIsString(self);
 	__MCAssertIsString(p_needle);
 
-    if (__MCStringIsIndirect(p_needle))
-        p_needle = p_needle -> string;
+    if (__MCStringIsIndirect(p_needle) &&
+        !__MCStringDereference(p_needle))
+        return false;
     
     // SN-2014-09-05: [[ Bug 13346 ]] Empty is *never* contained in a string. In the loop, a commong string of length 0
     // will be found, which unfortunaly matches the length of the empty needle.
     if (__MCStringIsEmpty(p_needle))
         return false;
     
-    if (__MCStringIsIndirect(self))
-        self = self -> string;
+    if (__MCStringIsIndirect(self) &&
+        !__MCStringDereference(self))
+        return false;
     
 	__MCStringClampRange(self, p_range);
 
@@ -3465,11 +3759,13 @@ bool MCStringFirstIndexOfStringInRange(MCStringRef self, MCStringRef p_needle, M
 	__MCAssertIsString(self);
 	__MCAssertIsString(p_needle);
 
-    if (__MCStringIsIndirect(self))
-        self = self -> string;
+    if (__MCStringIsIndirect(self) &&
+        !__MCStringDereference(self))
+        return false;
     
-    if (__MCStringIsIndirect(p_needle))
-        p_needle = p_needle -> string;
+    if (__MCStringIsIndirect(p_needle) &&
+        !__MCStringDereference(p_needle))
+        return false;
     
     __MCStringClampRange(self, p_range);
     
@@ -3523,8 +3819,9 @@ bool MCStringFirstIndexOfCharInRange(MCStringRef self, codepoint_t p_needle, MCR
 {
 	__MCAssertIsString(self);
 
-    if (__MCStringIsIndirect(self))
-        self = self -> string;
+    if (__MCStringIsIndirect(self) &&
+        !__MCStringDereference(self))
+        return false;
     
     __MCStringClampRange(self, p_range);
     
@@ -3570,11 +3867,13 @@ bool MCStringLastIndexOfStringInRange(MCStringRef self, MCStringRef p_needle, MC
 	__MCAssertIsString(self);
 	__MCAssertIsString(p_needle);
 
-    if (__MCStringIsIndirect(self))
-        self = self -> string;
+    if (__MCStringIsIndirect(self) &&
+        !__MCStringDereference(self))
+        return false;
     
-    if (__MCStringIsIndirect(p_needle))
-        p_needle = p_needle -> string;
+    if (__MCStringIsIndirect(p_needle) &&
+        !__MCStringDereference(p_needle))
+        return false;
     
     __MCStringClampRange(self, p_range);
     
@@ -3607,8 +3906,9 @@ bool MCStringLastIndexOfChar(MCStringRef self, codepoint_t p_needle, uindex_t p_
 {
 	__MCAssertIsString(self);
 
-    if (__MCStringIsIndirect(self))
-        self = self -> string;
+    if (__MCStringIsIndirect(self) &&
+        !__MCStringDereference(self))
+        return false;
     
 	// Make sure the after index is in range.
 	p_before = MCMin(p_before, self -> char_count);
@@ -3696,952 +3996,1491 @@ static bool __MCStringFind(MCStringRef self, MCRange p_range, MCStringRef p_need
     return true;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+
+// Fetching line or item N of a large string means scanning it from the start
+// for N delimiters, so a script which loops over the lines of a string by index
+// is quadratic. To avoid this, when a large immutable string is searched for
+// the same single code unit delimiter more than once, the offsets of every
+// occurrence of it are cached so that the Nth one can be found by binary
+// search. The cache is bounded in both entries and bytes, the least recently
+// used index is evicted first, and MCStringFlushDelimiterIndexCache drops all
+// of them.
+//
+// The cache is global and is changed by searches, which only read the string,
+// so it is not used at all when values may be used by more than one thread
+// (see MCValueEnableThreading). Locking it instead would not be enough, as the
+// offsets are read after the fetch which may have moved or evicted them, and
+// threading must be enabled before any string exists so no index can be left
+// over from before.
+
+struct __MCStringDelimiterIndex
+{
+    __MCStringDelimiterIndex *next;
+    // The string the index is for - this is not retained, the entry is
+    // removed when the string is destroyed or becomes mutable.
+    MCStringRef string;
+    // The code unit (native char, if the string is native) which is indexed.
+    unichar_t delimiter;
+    // The sorted offsets of each occurrence of the delimiter, this is nil
+    // until the string has been searched for the delimiter a second time.
+    uindex_t *offsets;
+    uindex_t offset_count;
+};
+
+// Strings shorter than this are cheap enough to scan each time.
+static const uindex_t kMCStringDelimiterIndexMinLength = 4096;
+// The maximum number of strings / delimiters which are tracked at once.
+static const uindex_t kMCStringDelimiterIndexMaxEntries = 8;
+// The maximum number of bytes the offsets of all indices may occupy.
+static const size_t kMCStringDelimiterIndexMaxBytes = 64 * 1024 * 1024;
+
+static __MCStringDelimiterIndex *s_delimiter_indices = nil;
+static size_t s_delimiter_index_bytes = 0;
+
+static void __MCStringDeleteDelimiterIndex(__MCStringDelimiterIndex *p_index)
+{
+    if (p_index -> offsets != nil)
+    {
+        s_delimiter_index_bytes -= p_index -> offset_count * sizeof(uindex_t);
+        MCMemoryDeleteArray(p_index -> offsets);
+    }
+    MCMemoryDelete(p_index);
+}
+
+static void __MCStringDiscardDelimiterIndices(MCStringRef self)
+{
+    __MCStringDelimiterIndex **t_link;
+    t_link = &s_delimiter_indices;
+    while (*t_link != nil)
+    {
+        __MCStringDelimiterIndex *t_index;
+        t_index = *t_link;
+        if (t_index -> string == self)
+        {
+            *t_link = t_index -> next;
+            __MCStringDeleteDelimiterIndex(t_index);
+        }
+        else
+            t_link = &t_index -> next;
+    }
+    
+    self -> flags &= ~kMCStringFlagHasDelimiterIndex;
+}
+
 MC_DLLEXPORT_DEF
-bool MCStringFind(MCStringRef self, MCRange p_range, MCStringRef p_needle, MCStringOptions p_options, MCRange *r_result)
+void MCStringFlushDelimiterIndexCache(void)
 {
-	__MCAssertIsString(self);
-	__MCAssertIsString(p_needle);
+    while (s_delimiter_indices != nil)
+    {
+        __MCStringDelimiterIndex *t_index;
+        t_index = s_delimiter_indices;
+        s_delimiter_indices = t_index -> next;
+        
+        t_index -> string -> flags &= ~kMCStringFlagHasDelimiterIndex;
+        __MCStringDeleteDelimiterIndex(t_index);
+    }
+}
 
-    if (__MCStringIsIndirect(self))
-        self = self -> string;
+// Returns true if searches of self for needle can be answered from an index of
+// a single code unit, returning the unit. This is the case when the needle is a
+// single code unit which will only ever match itself - i.e. it is compared
+// exactly, or (as in __MCStringFind) it is below 'A' and so never folds.
+static bool __MCStringGetIndexableDelimiter(MCStringRef self, MCStringRef p_needle, MCStringOptions p_options, unichar_t& r_delimiter)
+{
+    if (MCStringIsMutable(self) ||
+        self -> char_count < kMCStringDelimiterIndexMinLength ||
+        p_needle -> char_count != 1 ||
+        __MCValueIsThreadingEnabled())
+        return false;
     
-    if (__MCStringIsIndirect(p_needle))
-        p_needle = p_needle -> string;
+    unichar_t t_char;
+    if (__MCStringIsNative(p_needle))
+        t_char = MCUnicodeCharMapFromNative(p_needle -> native_chars[0]);
+    else
+        t_char = p_needle -> chars[0];
     
-    __MCStringClampRange(self, p_range);
+    if (t_char >= 0x41 && p_options != kMCStringOptionCompareExact)
+        return false;
     
-    return __MCStringFind(self, p_range, p_needle, p_options, r_result);
+    if (MCUnicodeCodepointIsHighSurrogate(t_char) ||
+        MCUnicodeCodepointIsLowSurrogate(t_char))
+        return false;
+    
+    if (__MCStringIsNative(self))
+    {
+        char_t t_native_char;
+        if (!MCUnicodeCharMapToNative(t_char, t_native_char))
+            return false;
+        t_char = t_native_char;
+    }
+    
+    r_delimiter = t_char;
+    return true;
 }
 
-static uindex_t MCStringCountStrChars(MCStringRef self, MCRange p_range, const void *p_needle_chars, uindex_t p_needle_char_count, bool p_needle_native, MCStringOptions p_options)
+static uindex_t __MCStringScanForDelimiter(MCStringRef self, unichar_t p_delimiter, uindex_t *r_offsets)
 {
-    if (__MCStringIsIndirect(self))
-        self = self -> string;
-    
-	// Keep track of how many occurrences have been found.
-	uindex_t t_count;
-	t_count = 0;
-
-    __MCStringClampRange(self, p_range);
-	
-    bool self_native = __MCStringIsNative(self);
-    const void *self_chars;
-    if (self_native)
-        self_chars = self -> native_chars + p_range . offset;
+    uindex_t t_count;
+    t_count = 0;
+    if (__MCStringIsNative(self))
+    {
+        const char_t *t_chars, *t_limit;
+        t_chars = self -> native_chars;
+        t_limit = t_chars + self -> char_count;
+        while (t_chars < t_limit)
+        {
+            t_chars = (const char_t *)memchr(t_chars, p_delimiter, t_limit - t_chars);
+            if (t_chars == nil)
+                break;
+            
+            if (r_offsets != nil)
+                r_offsets[t_count] = uindex_t(t_chars - self -> native_chars);
+            t_count += 1;
+            t_chars += 1;
+        }
+    }
     else
-        self_chars = self -> chars + p_range . offset;
+    {
+        for (uindex_t i = 0; i < self -> char_count; i++)
+        {
+            if (self -> chars[i] != p_delimiter)
+                continue;
+            
+            if (r_offsets != nil)
+                r_offsets[t_count] = i;
+            t_count += 1;
+        }
+    }
     
-	// Loop through the char range checking for occurrences of needle.
-	uindex_t t_offset;
-	t_offset = p_range . offset;
-	while(t_offset < p_range . offset + p_range . length)
-	{
-		// Compute the length of the shared prefix at the current offset.
-		uindex_t t_prefix_length;
-        uindex_t t_ignored;
-        MCUnicodeSharedPrefix((const char *)self_chars + (self_native ? t_offset : (t_offset * 2)), p_range . offset + p_range . length - t_offset, self_native, p_needle_chars, p_needle_char_count, p_needle_native, (MCUnicodeCompareOption)p_options, t_ignored, t_prefix_length);
-        
-		// If we find a match, increase the count and move past it, otherwise
-		// just bump.
-		if (t_prefix_length == p_needle_char_count)
-		{
-			t_offset += t_prefix_length;
-			t_count += 1;
-		}
-		else
-			t_offset += 1;
-	}
-
-	// Return the number of occurrences.
-	return t_count;
+    return t_count;
 }
 
-MC_DLLEXPORT_DEF
-uindex_t MCStringCount(MCStringRef self, MCRange p_range, MCStringRef p_needle, MCStringOptions p_options)
+static bool __MCStringBuildDelimiterIndex(__MCStringDelimiterIndex *p_index)
 {
-	__MCAssertIsString(self);
-	__MCAssertIsString(p_needle);
-
-    if (__MCStringIsIndirect(p_needle))
-        p_needle = p_needle -> string;
+    uindex_t t_count;
+    t_count = __MCStringScanForDelimiter(p_index -> string, p_index -> delimiter, nil);
     
-    if (MCStringIsNative(self))
+    size_t t_bytes;
+    t_bytes = t_count * sizeof(uindex_t);
+    if (t_bytes > kMCStringDelimiterIndexMaxBytes)
+        return false;
+    
+    // Evict the least recently used indices until there is room.
+    while (s_delimiter_index_bytes + t_bytes > kMCStringDelimiterIndexMaxBytes)
     {
-        if (__MCStringIsNative(p_needle))
-            return __MCNativeOp_Count(self -> native_chars + p_range . offset,
-                                      p_range . length,
-                                      p_needle -> native_chars,
-                                      p_needle -> char_count,
-                                      p_options,
-                                      nil);
+        __MCStringDelimiterIndex *t_lru;
+        t_lru = nil;
+        for (__MCStringDelimiterIndex *t_index = s_delimiter_indices; t_index != nil; t_index = t_index -> next)
+            if (t_index -> offsets != nil)
+                t_lru = t_index;
         
-        if (__MCStringCantBeEqualToNative(p_needle, p_options))
-            return 0;
+        s_delimiter_index_bytes -= t_lru -> offset_count * sizeof(uindex_t);
+        MCMemoryDeleteArray(t_lru -> offsets);
+        t_lru -> offsets = nil;
+        t_lru -> offset_count = 0;
     }
     
-	uindex_t t_count = MCStringCountStrChars(self, p_range, p_needle -> chars, p_needle -> char_count, __MCStringIsNative(p_needle), p_options);
+    // Even if there are no occurrences, the (empty) offsets array is needed to
+    // mark the index as built.
+    if (!MCMemoryNewArray(t_count, p_index -> offsets))
+        return false;
     
-    return t_count;
+    __MCStringScanForDelimiter(p_index -> string, p_index -> delimiter, p_index -> offsets);
+    p_index -> offset_count = t_count;
+    s_delimiter_index_bytes += t_bytes;
+    
+    return true;
 }
 
-MC_DLLEXPORT_DEF
-uindex_t MCStringCountChar(MCStringRef self, MCRange p_range, codepoint_t p_needle, MCStringOptions p_options)
+// Returns the index for the given search, if there is one. The index is only
+// built the second time the string is searched for the delimiter, so that
+// strings which are only ever searched once do not pay for it.
+static __MCStringDelimiterIndex *__MCStringFetchDelimiterIndex(MCStringRef self, MCStringRef p_needle, MCStringOptions p_options)
 {
-	__MCAssertIsString(self);
-
-	strchar_t t_native_needle;
-	t_native_needle = (strchar_t)p_needle;
-	
-    if (MCStringIsNative(self))
+    unichar_t t_delimiter;
+    if (!__MCStringGetIndexableDelimiter(self, p_needle, p_options, t_delimiter))
+        return nil;
+    
+    __MCStringDelimiterIndex **t_link;
+    uindex_t t_entries;
+    t_link = &s_delimiter_indices;
+    t_entries = 0;
+    while (*t_link != nil)
     {
-        char_t t_mapped_needle;
-        if (p_needle > UNICHAR_MAX ||
-            !MCUnicodeCharMapToNative((unichar_t)p_needle, t_mapped_needle))
-            return 0;
+        __MCStringDelimiterIndex *t_index;
+        t_index = *t_link;
+        if (t_index -> string == self && t_index -> delimiter == t_delimiter)
+        {
+            // Move the entry to the front of the list.
+            *t_link = t_index -> next;
+            t_index -> next = s_delimiter_indices;
+            s_delimiter_indices = t_index;
+            
+            if (t_index -> offsets == nil && !__MCStringBuildDelimiterIndex(t_index))
+                return nil;
+            
+            return t_index;
+        }
         
-        return __MCNativeOp_Count(self -> native_chars + p_range . offset,
-                                  p_range . length,
-                                  &t_mapped_needle,
-                                  1,
-                                  p_options,
-                                  nil);
+        // Drop the least recently used entry if the list is full.
+        if (++t_entries == kMCStringDelimiterIndexMaxEntries)
+        {
+            *t_link = nil;
+            while (t_index != nil)
+            {
+                __MCStringDelimiterIndex *t_next;
+                t_next = t_index -> next;
+                __MCStringDeleteDelimiterIndex(t_index);
+                t_index = t_next;
+            }
+            break;
+        }
+        
+        t_link = &t_index -> next;
     }
     
-	return MCStringCountStrChars(self, p_range, &t_native_needle, 1, false, p_options);
+    // This is the first search, so just note it.
+    __MCStringDelimiterIndex *t_index;
+    if (!MCMemoryNew(t_index))
+        return nil;
+    
+    t_index -> next = s_delimiter_indices;
+    t_index -> string = self;
+    t_index -> delimiter = t_delimiter;
+    s_delimiter_indices = t_index;
+    
+    self -> flags |= kMCStringFlagHasDelimiterIndex;
+    
+    return nil;
 }
 
-////////////////////////////////////////////////////////////////////////////////
-
-MC_DLLEXPORT_DEF
-bool MCStringDivideAtChar(MCStringRef self, codepoint_t p_separator, MCStringOptions p_options, MCStringRef& r_head, MCStringRef& r_tail)
+// Returns the range of indices into the index's offsets which lie in range.
+static MCRange __MCStringDelimiterIndexGetRange(__MCStringDelimiterIndex *p_index, MCRange p_range)
 {
-	__MCAssertIsString(self);
+    uindex_t *t_begin, *t_end;
+    t_begin = std::lower_bound(p_index -> offsets, p_index -> offsets + p_index -> offset_count, p_range . offset);
+    t_end = std::lower_bound(t_begin, p_index -> offsets + p_index -> offset_count, p_range . offset + p_range . length);
+    return MCRangeMake(uindex_t(t_begin - p_index -> offsets), uindex_t(t_end - t_begin));
+}
 
-	uindex_t t_offset;
-	if (!MCStringFirstIndexOfChar(self, p_separator, 0, p_options, t_offset))
-	{
-		if (!MCStringCopy(self, r_head))
-			return false;
-		
-		r_tail = MCValueRetain(kMCEmptyString);
-		
-		return true;
-	}
-	
-	return MCStringDivideAtIndex(self, t_offset, r_head, r_tail);
+////////////////////////////////////////////////////////////////////////////////
+
+// Fetching char, trueWord or sentence N of a string means running a break
+// iterator over it from the start, and for words and sentences first copying
+// the whole string into ICU, so a script which loops over them by index is
+// quadratic. As with delimiters, when a large immutable string is asked for
+// the same kind of chunk more than once, the code unit range of every such
+// chunk is cached so the Nth can be looked up directly. The cache is bounded
+// in the same way as the delimiter index cache, and
+// MCStringFlushBreakIndexCache drops all of it. Like that cache, it is not used
+// when threading is enabled, as the ranges it returns are only valid until it
+// is next changed.
+
+struct __MCStringBreakIndex
+{
+    __MCStringBreakIndex *next;
+    // The string the index is for - this is not retained, the entry is
+    // removed when the string is destroyed or becomes mutable.
+    MCStringRef string;
+    // The kind of chunk - graphemes (character), true words (word) or
+    // sentences - and the (retained) locale used to find words and sentences.
+    MCBreakIteratorType type;
+    MCLocaleRef locale;
+    // The range of each chunk, this is nil until the string has been asked
+    // for them a second time.
+    MCRange *ranges;
+    uindex_t range_count;
+};
+
+// Strings shorter than this are cheap enough to break each time.
+static const uindex_t kMCStringBreakIndexMinLength = 1024;
+// The maximum number of strings / chunk types which are tracked at once.
+static const uindex_t kMCStringBreakIndexMaxEntries = 8;
+// The maximum number of bytes the ranges of all indices may occupy.
+static const size_t kMCStringBreakIndexMaxBytes = 64 * 1024 * 1024;
+
+static __MCStringBreakIndex *s_break_indices = nil;
+static size_t s_break_index_bytes = 0;
+
+static void __MCStringDeleteBreakIndex(__MCStringBreakIndex *p_index)
+{
+    if (p_index -> ranges != nil)
+    {
+        s_break_index_bytes -= p_index -> range_count * sizeof(MCRange);
+        MCMemoryDeleteArray(p_index -> ranges);
+    }
+    if (p_index -> locale != nil)
+        MCLocaleRelease(p_index -> locale);
+    MCMemoryDelete(p_index);
+}
+
+static void __MCStringDiscardBreakIndices(MCStringRef self)
+{
+    __MCStringBreakIndex **t_link;
+    t_link = &s_break_indices;
+    while (*t_link != nil)
+    {
+        __MCStringBreakIndex *t_index;
+        t_index = *t_link;
+        if (t_index -> string == self)
+        {
+            *t_link = t_index -> next;
+            __MCStringDeleteBreakIndex(t_index);
+        }
+        else
+            t_link = &t_index -> next;
+    }
+    
+    self -> flags &= ~kMCStringFlagHasBreakIndex;
 }
 
 MC_DLLEXPORT_DEF
-bool MCStringDivideAtIndex(MCStringRef self, uindex_t p_offset, MCStringRef& r_head, MCStringRef& r_tail)
+void MCStringFlushBreakIndexCache(void)
 {
-	__MCAssertIsString(self);
+    while (s_break_indices != nil)
+    {
+        __MCStringBreakIndex *t_index;
+        t_index = s_break_indices;
+        s_break_indices = t_index -> next;
+        
+        t_index -> string -> flags &= ~kMCStringFlagHasBreakIndex;
+        __MCStringDeleteBreakIndex(t_index);
+    }
+}
 
-	MCStringRef t_head;
-	if (!MCStringCopySubstring(self, MCRangeMake(0, p_offset), t_head))
-		return false;
-	
-	MCStringRef t_tail;
-	if (!MCStringCopySubstring(self, MCRangeMakeMinMax(p_offset + 1, MCStringGetLength(self)), t_tail))
-	{
-		MCValueRelease(t_head);
-		return false;
-	}
-	
-	r_head = t_head;
-	r_tail = t_tail;
-	
-	return true;
+static bool __MCStringPushBreakRange(MCRange*& x_ranges, uindex_t& x_capacity, uindex_t& x_count, MCRange p_range)
+{
+    if (x_count == x_capacity &&
+        !MCMemoryResizeArray(MCMax(x_capacity * 2, 256U), x_ranges, x_capacity))
+        return false;
+    
+    x_ranges[x_count++] = p_range;
+    return true;
 }
 
-////////////////////////////////////////////////////////////////////////////////
+// Finds the ranges of all the chunks of the index's type in its string, in the
+// same way as the corresponding chunk iterators do.
+static bool __MCStringComputeBreakRanges(__MCStringBreakIndex *p_index, MCRange*& r_ranges, uindex_t& r_count)
+{
+    MCStringRef self;
+    self = p_index -> string;
+    
+    MCRange *t_ranges;
+    uindex_t t_capacity, t_count;
+    t_ranges = nil;
+    t_capacity = 0;
+    t_count = 0;
+    
+    bool t_success;
+    t_success = true;
+    if (p_index -> type == kMCBreakIteratorTypeCharacter)
+    {
+        uindex_t t_start;
+        t_start = 0;
+        while (t_success && t_start < self -> char_count)
+        {
+            uindex_t t_end;
+            t_end = MCStringGraphemeBreakIteratorAdvance(self, t_start);
+            if (t_end == kMCLocaleBreakIteratorDone)
+                t_end = self -> char_count;
+            
+            t_success = __MCStringPushBreakRange(t_ranges, t_capacity, t_count, MCRangeMakeMinMax(t_start, t_end));
+            t_start = t_end;
+        }
+    }
+    else
+    {
+        MCAutoCustomPointer<__MCBreakIterator, MCLocaleBreakIteratorRelease> t_iter;
+        t_success = MCLocaleBreakIteratorCreate(p_index -> locale, p_index -> type, &t_iter) &&
+                    MCLocaleBreakIteratorSetText(*t_iter, self);
+        
+        if (t_success && p_index -> type == kMCBreakIteratorTypeWord)
+        {
+            MCRange t_range;
+            t_range = MCRangeMake(0, 0);
+            while (t_success && MCLocaleWordBreakIteratorAdvance(self, *t_iter, t_range))
+                t_success = __MCStringPushBreakRange(t_ranges, t_capacity, t_count, t_range);
+        }
+        else if (t_success)
+        {
+            uindex_t t_start, t_end;
+            t_start = 0;
+            while (t_success && (t_end = MCLocaleBreakIteratorAdvance(*t_iter)) != kMCLocaleBreakIteratorDone)
+            {
+                t_success = __MCStringPushBreakRange(t_ranges, t_capacity, t_count, MCRangeMakeMinMax(t_start, t_end));
+                t_start = t_end;
+            }
+        }
+    }
+    
+    // Even if there are no chunks, the (empty) ranges array is needed to mark
+    // the index as built.
+    if (t_success)
+        t_success = MCMemoryResizeArray(t_count, t_ranges, t_capacity);
+    
+    if (!t_success)
+    {
+        MCMemoryDeleteArray(t_ranges);
+        return false;
+    }
+    
+    r_ranges = t_ranges;
+    r_count = t_count;
+    return true;
+}
 
-MC_DLLEXPORT_DEF
-bool MCStringBreakIntoChunks(MCStringRef self, codepoint_t p_separator, MCStringOptions p_options, MCRange*& r_ranges, uindex_t& r_range_count)
+static bool __MCStringBuildBreakIndex(__MCStringBreakIndex *p_index)
 {
-	__MCAssertIsString(self);
-	MCAssert(p_separator < 128);
-	
-	uindex_t t_length;
-	t_length = MCStringGetLength(self);
-	
-	// Count the number of chunks, adjusting for an empty trailing chunk.
-	uindex_t t_range_count;
-	// SN-2014-11-13: [[ Bug 13993 ]] No delimiter found means 1 range, 1 delimiter means 2 ranges, etc.
-	t_range_count = MCStringCountChar(self, MCRangeMake(0, MCStringGetLength(self)), p_separator, p_options) + 1;
-	if (t_length > 0 && MCStringGetNativeCharAtIndex(self, t_length - 1) == p_separator)
-		t_range_count -= 1;
-	
-	// Allocate the range array.
-	MCRange *t_ranges;
-	if (!MCMemoryNewArray(t_range_count, t_ranges))
-		return false;
-	
-	// Now compute the ranges.
-	uindex_t t_prev_offset, t_offset, t_index;
-	t_prev_offset = 0;
-	t_offset = 0;
-	t_index = 0;
-	for(;;)
-	{
-		// SN-2014-11-13: [[ Bug 13993 ]] The offset might be after the last char, if the previous delimiter
-		// was the last char of the string. We are done in that case.
-		if (t_prev_offset == MCStringGetLength(self))
-			break;
-
-		if (!MCStringFirstIndexOfChar(self, p_separator, t_prev_offset, p_options, t_offset))
-		{
-			t_ranges[t_index] . offset = t_prev_offset;
-			t_ranges[t_index] . length = t_length - t_prev_offset;
-			break;
-		}
-		
-		t_ranges[t_index] . offset = t_prev_offset;
-		t_ranges[t_index] . length = t_offset - t_prev_offset;
-		
-		t_prev_offset = t_offset + 1;
-	}
-	
-	r_ranges = t_ranges;
-	r_range_count = t_range_count;
-	
-	return true;
-}
-
-////////////////////////////////////////////////////////////////////////////////
-
-// Skip 'count' occurrences of 'needle' in 'range' of 'self' according to 'options'.
-// If 'needle' is not found, false is returned and r_last is untouched.
-static bool __MCStringSkip(MCStringRef self,
-                           MCRange p_range,
-                           MCStringRef p_needle,
-                           uindex_t p_count,
-                           MCStringOptions p_options,
-                           MCRange& r_last)
-{
-    MCAssert(p_count > 0);
+    MCRange *t_ranges;
+    uindex_t t_count;
+    if (!__MCStringComputeBreakRanges(p_index, t_ranges, t_count))
+        return false;
     
-    // Optimize the case of both needle and self native.
-    if (__MCStringIsNative(self) &&
-        __MCStringIsNative(p_needle))
+    size_t t_bytes;
+    t_bytes = t_count * sizeof(MCRange);
+    if (t_bytes > kMCStringBreakIndexMaxBytes)
     {
-        size_t t_last_offset;
-        if (!__MCNativeOp_Skip(self -> native_chars + p_range . offset,
-                               p_range . length,
-                               p_needle -> native_chars,
-                               p_needle -> char_count,
-                               p_count,
-                               p_options,
-                               &t_last_offset))
-            return false;
-        
-        r_last . offset = p_range . offset + t_last_offset;
-        r_last . length = p_needle -> char_count;
-        return true;
+        MCMemoryDeleteArray(t_ranges);
+        return false;
     }
     
-    uindex_t t_start, t_finish;
-    t_start = p_range . offset;
-    t_finish = p_range . offset + p_range . length;
-    
-    MCRange t_last;
-    while(p_count > 0)
+    // Evict the least recently used indices until there is room.
+    while (s_break_index_bytes + t_bytes > kMCStringBreakIndexMaxBytes)
     {
-        if (!__MCStringFind(self,
-                            MCRangeMakeMinMax(t_start, t_finish),
-                            p_needle,
-                            p_options,
-                            &t_last))
-            return false;
-        
-        // Decrement the number of needles to skip.
-        p_count -= 1;
+        __MCStringBreakIndex *t_lru;
+        t_lru = nil;
+        for (__MCStringBreakIndex *t_index = s_break_indices; t_index != nil; t_index = t_index -> next)
+            if (t_index -> ranges != nil)
+                t_lru = t_index;
         
-        // Move the considered range to start at the end of the previous
-        // needle.
-        t_start = t_last . offset + t_last . length;
+        s_break_index_bytes -= t_lru -> range_count * sizeof(MCRange);
+        MCMemoryDeleteArray(t_lru -> ranges);
+        t_lru -> ranges = nil;
+        t_lru -> range_count = 0;
     }
     
-    r_last = t_last;
+    p_index -> ranges = t_ranges;
+    p_index -> range_count = t_count;
+    s_break_index_bytes += t_bytes;
     
     return true;
 }
 
-// Count occurrences of 'needle' in 'range' of 'self' according to 'options'.
-// If no occurrences are found 0 is returned and r_last is untouched.
-static uindex_t __MCStringCount(MCStringRef self,
-                                MCRange p_range,
-                                MCStringRef p_needle,
-                                MCStringOptions p_options,
-                                MCRange *r_last)
+bool MCStringFetchBreakRanges(MCStringRef self, MCBreakIteratorType p_type, MCLocaleRef p_locale, const MCRange*& r_ranges, uindex_t& r_count)
 {
-    // Optimize the case of both needle and self native.
-    if (__MCStringIsNative(self) &&
-        __MCStringIsNative(p_needle))
+    __MCAssertIsString(self);
+    
+    if (__MCStringIsIndirect(self) &&
+        !__MCStringDereference(self))
+        return false;
+    
+    if (MCStringIsMutable(self) ||
+        self -> char_count < kMCStringBreakIndexMinLength ||
+        __MCValueIsThreadingEnabled())
+        return false;
+    
+    switch (p_type)
     {
-        size_t t_last_offset;
-        size_t t_count;
-        t_count = __MCNativeOp_Count(self -> native_chars + p_range . offset,
-                                     p_range . length,
-                                     p_needle -> native_chars,
-                                     p_needle -> char_count,
-                                     p_options,
-                                     &t_last_offset);
-        if (t_count > 0 &&
-            r_last != nil)
+        case kMCBreakIteratorTypeCharacter:
+            // Graphemes do not depend on the locale.
+            p_locale = nil;
+            break;
+        case kMCBreakIteratorTypeWord:
+        case kMCBreakIteratorTypeSentence:
+            __MCAssertIsLocale(p_locale);
+            break;
+        default:
+            return false;
+    }
+    
+    __MCStringBreakIndex **t_link;
+    uindex_t t_entries;
+    t_link = &s_break_indices;
+    t_entries = 0;
+    while (*t_link != nil)
+    {
+        __MCStringBreakIndex *t_index;
+        t_index = *t_link;
+        if (t_index -> string == self &&
+            t_index -> type == p_type &&
+            t_index -> locale == p_locale)
         {
-            r_last -> offset = p_range . offset + t_last_offset;
-            r_last -> length = p_needle -> char_count;
+            // Move the entry to the front of the list.
+            *t_link = t_index -> next;
+            t_index -> next = s_break_indices;
+            s_break_indices = t_index;
+            
+            if (t_index -> ranges == nil && !__MCStringBuildBreakIndex(t_index))
+                return false;
+            
+            r_ranges = t_index -> ranges;
+            r_count = t_index -> range_count;
+            return true;
         }
         
-        return t_count;
+        // Drop the least recently used entry if the list is full.
+        if (++t_entries == kMCStringBreakIndexMaxEntries)
+        {
+            *t_link = nil;
+            while (t_index != nil)
+            {
+                __MCStringBreakIndex *t_next;
+                t_next = t_index -> next;
+                __MCStringDeleteBreakIndex(t_index);
+                t_index = t_next;
+            }
+            break;
+        }
+        
+        t_link = &t_index -> next;
     }
     
-    uindex_t t_count;
-    t_count = 0;
+    // This is the first request, so just note it.
+    __MCStringBreakIndex *t_index;
+    if (!MCMemoryNew(t_index))
+        return false;
     
-    uindex_t t_start, t_finish;
-    t_start = p_range . offset;
-    t_finish = p_range . offset + p_range . length;
+    t_index -> next = s_break_indices;
+    t_index -> string = self;
+    t_index -> type = p_type;
+    if (p_locale != nil)
+        t_index -> locale = MCLocaleRetain(p_locale);
+    s_break_indices = t_index;
     
-    MCRange t_last;
-    t_last = MCRangeMake(t_start, 0);
-    while(__MCStringFind(self,
-                         MCRangeMakeMinMax(t_start, t_finish),
-                         p_needle,
-                         p_options,
-                         &t_last))
-    {
-        // Increment the number of needles found.
-        t_count += 1;
-        
-        // Move the considered range to start at the end of the previous
-        // needle.
-        t_start = t_last . offset + t_last . length;
-    }
+    self -> flags |= kMCStringFlagHasBreakIndex;
+    
+    return false;
+}
 
-    if (t_count > 0 && r_last != nil)
-        *r_last = t_last;
+// Returns the index-th boundary between chunks given the ranges of each, the
+// first being the start of the text and the last the end of the last chunk.
+static uindex_t __MCStringGetBreakBoundary(const MCRange *p_ranges, uindex_t p_count, uindex_t p_index)
+{
+    if (p_index < p_count)
+        return p_ranges[p_index] . offset;
     
-    return t_count;
+    if (p_count == 0)
+        return 0;
+    
+    return p_ranges[p_count - 1] . offset + p_ranges[p_count - 1] . length;
+}
+
+// Maps a range of graphemes or sentences to code units using the ranges of
+// every chunk, in the same way as advancing a break iterator over the string:
+// a range starting after the last boundary is empty at the end of the string,
+// and one running past it ends at the end of the string.
+static MCRange __MCStringMapBreakRanges(MCStringRef self, const MCRange *p_ranges, uindex_t p_count, MCRange p_chunk_range)
+{
+    if (p_chunk_range . offset > p_count)
+        return MCRangeMake(self -> char_count, 0);
+    
+    uindex_t t_start, t_end;
+    t_start = __MCStringGetBreakBoundary(p_ranges, p_count, p_chunk_range . offset);
+    if (p_chunk_range . length <= p_count - p_chunk_range . offset)
+        t_end = __MCStringGetBreakBoundary(p_ranges, p_count, p_chunk_range . offset + p_chunk_range . length);
+    else
+        t_end = self -> char_count;
+    
+    return MCRangeMakeMinMax(t_start, t_end);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
-static bool __MCStringDelimitedOffset(MCStringRef self,
-                                      MCRange p_range,
-                                      MCStringRef p_needle,
-                                      MCStringRef p_delimiter,
-                                      uindex_t p_skip,
-                                      MCStringOptions p_options,
-                                      uindex_t& r_index,
-                                      MCRange *r_found,
-                                      MCRange *r_before,
-                                      MCRange *r_after)
+MC_DLLEXPORT_DEF
+bool MCStringFind(MCStringRef self, MCRange p_range, MCStringRef p_needle, MCStringOptions p_options, MCRange *r_result)
 {
-    // Compute the absolute start and finish points of the considered range.
-    // This is much easier to work with than offset / length.
-    // We gradually move 'start' forward past delimiters (and finally the
-    // found string) as the algorithm progresses.
-    uindex_t t_start, t_finish;
-    t_start = p_range . offset;
-    t_finish = p_range . offset + p_range . length;
+	__MCAssertIsString(self);
+	__MCAssertIsString(p_needle);
+
+    if (__MCStringIsIndirect(self) &&
+        !__MCStringDereference(self))
+        return false;
     
-    // Skip 'skip' delimiters, if this is not possible then we are done. This
-    // computes the initial 'previous delimiter'.
-    MCRange t_prev_delimiter;
-    t_prev_delimiter = MCRangeMake(t_start, 0);
-    if (p_skip > 0 &&
-        !__MCStringSkip(self,
-                        p_range,
-                        p_delimiter,
-                        p_skip,
-                        p_options,
-                        t_prev_delimiter))
+    if (__MCStringIsIndirect(p_needle) &&
+        !__MCStringDereference(p_needle))
         return false;
     
-    // The initial number of delimiters is the number we skip.
-    uindex_t t_delimiter_count;
-    t_delimiter_count = p_skip;
+    __MCStringClampRange(self, p_range);
     
-    // Make sure we start from the end of the last delimiter skipped.
-    t_start = t_prev_delimiter . offset + t_prev_delimiter . length;
+    return __MCStringFind(self, p_range, p_needle, p_options, r_result);
+}
+
+MC_DLLEXPORT_DEF
+bool MCStringFindNth(MCStringRef self, MCRange p_range, MCStringRef p_needle, MCStringOptions p_options, uindex_t p_n, uindex_t& r_found_count, MCRange *r_result)
+{
+	__MCAssertIsString(self);
+	__MCAssertIsString(p_needle);
     
-    // Now search for 'needle' in the remaining range. If nothing is found, then
-    // we are done.
-    MCRange t_found_range;
-    if (!__MCStringFind(self,
-                        MCRangeMakeMinMax(t_start, t_finish),
-                        p_needle,
-                        p_options,
-                        &t_found_range))
+    if (__MCStringIsIndirect(self) &&
+        !__MCStringDereference(self))
         return false;
     
-    // We must now search for delimiters in the substring between the end of the
-    // previous delimiter and the start of the found range.
-    t_delimiter_count += __MCStringCount(self,
-                                         MCRangeMakeMinMax(t_start, t_found_range . offset),
-                                         p_delimiter,
-                                         p_options,
-                                         &t_prev_delimiter);
+    if (__MCStringIsIndirect(p_needle) &&
+        !__MCStringDereference(p_needle))
+        return false;
     
-    // Return the (absolute) number of delimiters encountered.
-    r_index = t_delimiter_count;
+    __MCStringClampRange(self, p_range);
     
-    // Return the range of the found string (if required).
-    if (r_found != nil)
-        *r_found = t_found_range;
+    __MCStringDelimiterIndex *t_index;
+    t_index = __MCStringFetchDelimiterIndex(self, p_needle, p_options);
+    if (t_index != nil)
+    {
+        MCRange t_found;
+        t_found = __MCStringDelimiterIndexGetRange(t_index, p_range);
+        if (p_n < t_found . length)
+        {
+            r_found_count = p_n + 1;
+            if (r_result != nil)
+                *r_result = MCRangeMake(t_index -> offsets[t_found . offset + p_n], 1);
+            return true;
+        }
+        
+        r_found_count = t_found . length;
+        if (r_result != nil && t_found . length != 0)
+            *r_result = MCRangeMake(t_index -> offsets[t_found . offset + t_found . length - 1], 1);
+        return false;
+    }
     
-    // Return the range of the delimiter before the found string (if required).
-    if (r_before != nil)
-        *r_before = t_prev_delimiter;
+    uindex_t t_count, t_offset, t_limit;
+    t_count = 0;
+    t_offset = p_range . offset;
+    t_limit = p_range . offset + p_range . length;
     
-    // Finally, if 'r_after' is required, we must find the first delimiter
-    // after the found string.
-    if (r_after != nil)
+    MCRange t_found;
+    while (__MCStringFind(self, MCRangeMakeMinMax(t_offset, t_limit), p_needle, p_options, &t_found))
     {
-        // Update start to be after the found range.
-        t_start = t_found_range . offset + t_found_range . length;
+        if (r_result != nil)
+            *r_result = t_found;
         
-        MCRange t_next_delimiter;
-        if (!__MCStringFind(self,
-                            MCRangeMake(t_start,
-                                        t_finish - t_start),
-                            p_delimiter,
-                            p_options,
-                            &t_next_delimiter))
-            t_next_delimiter = MCRangeMake(t_finish, 0);
+        t_count += 1;
+        if (t_count == p_n + 1)
+        {
+            r_found_count = t_count;
+            return true;
+        }
         
-        *r_after = t_next_delimiter;
+        // Guard against needles which match nothing.
+        if (t_found . length == 0)
+            break;
+        
+        t_offset = t_found . offset + t_found . length;
     }
     
-    return true;
+    r_found_count = t_count;
+    return false;
 }
 
-MC_DLLEXPORT_DEF
-bool MCStringDelimitedOffset(MCStringRef self,
-                             MCRange p_range,
-                             MCStringRef p_needle,
-                             MCStringRef p_delimiter,
-                             uindex_t p_skip,
-                             MCStringOptions p_options,
-                             uindex_t& r_index,
-                             MCRange *r_found,
-                             MCRange *r_before,
-                             MCRange *r_after)
+static uindex_t MCStringCountStrChars(MCStringRef self, MCRange p_range, const void *p_needle_chars, uindex_t p_needle_char_count, bool p_needle_native, MCStringOptions p_options)
 {
-	__MCAssertIsString(self);
-	__MCAssertIsString(p_needle);
-	__MCAssertIsString(p_delimiter);
-    
-    if (__MCStringIsIndirect(self))
-        self = self -> string;
-    
-    if (__MCStringIsIndirect(p_needle))
-        p_needle = p_needle -> string;
-    
-    if (__MCStringIsIndirect(p_delimiter))
-        p_delimiter = p_delimiter -> string;
+    if (__MCStringIsIndirect(self) &&
+        !__MCStringDereference(self))
+        return 0;
     
+	// Keep track of how many occurrences have been found.
+	uindex_t t_count;
+	t_count = 0;
+
     __MCStringClampRange(self, p_range);
+	
+    bool self_native = __MCStringIsNative(self);
+    const void *self_chars;
+    if (self_native)
+        self_chars = self -> native_chars + p_range . offset;
+    else
+        self_chars = self -> chars + p_range . offset;
     
-    if (__MCStringIsEmpty(p_needle))
-        return false;
-    
-    if (__MCStringIsNative(self) &&
-        __MCStringIsNative(p_needle) &&
-        __MCStringIsNative(p_delimiter) &&
-        __MCStringGetLength(p_delimiter) == 1)
-    {
-        size_t t_index, t_found, t_before, t_after;
-        if (!__MCNativeOp_ForwardCharDelimitedOffset(self -> native_chars + p_range . offset,
-                                                     p_range . length,
-                                                     p_needle -> native_chars,
-                                                     p_needle -> char_count,
-                                                     p_delimiter -> native_chars[0],
-                                                     p_skip,
-                                                     p_options,
-                                                     t_index,
-                                                     r_found != nil ? &t_found : nil,
-                                                     r_before != nil ? &t_before : nil,
-                                                     r_after != nil ? &t_after : nil))
-            return false;
-        
-        r_index = t_index;
-        if (r_found != nil)
-        {
-            r_found -> offset = p_range . offset + t_found;
-            r_found -> length = p_needle -> char_count;
-        }
-        
-        if (r_before != nil)
-        {
-            if (t_index > p_skip)
-            {
-                r_before -> offset = p_range . offset + t_before;
-                r_before -> length = 1;
-            }
-            else
-            {
-                r_before -> offset = p_range . offset;
-                r_before -> length = 0;
-            }
-        }
-        
-        if (r_after != nil)
-        {
-            if (t_after < p_range . length)
-            {
-                r_after -> offset = p_range . offset + t_after;
-                r_after -> length = 1;
-            }
-            else
-            {
-                r_after -> offset = p_range . offset + p_range . length;
-                r_after -> length = 0;
-            }
-        }
+	// Loop through the char range checking for occurrences of needle.
+	uindex_t t_offset;
+	t_offset = p_range . offset;
+	while(t_offset < p_range . offset + p_range . length)
+	{
+		// Compute the length of the shared prefix at the current offset.
+		uindex_t t_prefix_length;
+        uindex_t t_ignored;
+        MCUnicodeSharedPrefix((const char *)self_chars + (self_native ? t_offset : (t_offset * 2)), p_range . offset + p_range . length - t_offset, self_native, p_needle_chars, p_needle_char_count, p_needle_native, (MCUnicodeCompareOption)p_options, t_ignored, t_prefix_length);
         
-        return true;
-    }
-    
-    return __MCStringDelimitedOffset(self,
-                                     p_range,
-                                     p_needle,
-                                     p_delimiter,
-                                     p_skip,
-                                     p_options,
-                                     r_index,
-                                     r_found,
-                                     r_before,
-                                     r_after);
-}
+		// If we find a match, increase the count and move past it, otherwise
+		// just bump.
+		if (t_prefix_length == p_needle_char_count)
+		{
+			t_offset += t_prefix_length;
+			t_count += 1;
+		}
+		else
+			t_offset += 1;
+	}
 
-////////////////////////////////////////////////////////////////////////////////
+	// Return the number of occurrences.
+	return t_count;
+}
 
 MC_DLLEXPORT_DEF
-bool MCStringForwardDelimitedRegion(MCStringRef self,
-                                    MCRange p_range,
-                                    MCStringRef p_delimiter,
-                                    MCRange p_region,
-                                    MCStringOptions p_options,
-                                    MCRange& r_range)
+uindex_t MCStringCount(MCStringRef self, MCRange p_range, MCStringRef p_needle, MCStringOptions p_options)
 {
 	__MCAssertIsString(self);
-	__MCAssertIsString(p_delimiter);
-    
-    if (__MCStringIsIndirect(self))
-        self = self -> string;
-    
-    if (__MCStringIsIndirect(p_delimiter))
-        p_delimiter = p_delimiter -> string;
-    
-    __MCStringClampRange(self, p_range);
-    
-    uindex_t t_start, t_finish;
-    t_start = p_range . offset;
-    t_finish = p_range . offset + p_range . length;
+	__MCAssertIsString(p_needle);
+
+    // If the needle can't be flattened, there is no way to report it, so
+    // nothing is counted.
+    if (__MCStringIsIndirect(p_needle) &&
+        !__MCStringDereference(p_needle))
+        return 0;
     
-    MCRange t_first_del;
-    t_first_del = MCRangeMake(t_start, 0);
-    if (p_region . offset > 0 &&
-        !__MCStringSkip(self,
-                        MCRangeMakeMinMax(t_start, t_finish),
-                        p_delimiter,
-                        p_region . offset,
-                        p_options,
-                        t_first_del))
+    if (!__MCStringIsIndirect(self))
     {
-        r_range = MCRangeMake(t_finish,
-                              0);
-        return true;
+        __MCStringDelimiterIndex *t_index;
+        t_index = __MCStringFetchDelimiterIndex(self, p_needle, p_options);
+        if (t_index != nil)
+        {
+            __MCStringClampRange(self, p_range);
+            return __MCStringDelimiterIndexGetRange(t_index, p_range) . length;
+        }
     }
     
-    t_start = t_first_del . offset + t_first_del . length;
-    
-    if (p_region . length == 0)
+    if (MCStringIsNative(self))
     {
-        r_range = MCRangeMakeMinMax(t_start, 0);
-        return true;
+        if (__MCStringIsNative(p_needle))
+            return __MCNativeOp_Count(self -> native_chars + p_range . offset,
+                                      p_range . length,
+                                      p_needle -> native_chars,
+                                      p_needle -> char_count,
+                                      p_options,
+                                      nil);
+        
+        if (__MCStringCantBeEqualToNative(p_needle, p_options))
+            return 0;
     }
     
-    MCRange t_last_del;
-    if (!__MCStringSkip(self,
-                        MCRangeMakeMinMax(t_start, t_finish),
-                        p_delimiter,
-                        p_region . length,
-                        p_options,
-                        t_last_del))
+	uindex_t t_count = MCStringCountStrChars(self, p_range, p_needle -> chars, p_needle -> char_count, __MCStringIsNative(p_needle), p_options);
+    
+    return t_count;
+}
+
+MC_DLLEXPORT_DEF
+uindex_t MCStringCountChar(MCStringRef self, MCRange p_range, codepoint_t p_needle, MCStringOptions p_options)
+{
+	__MCAssertIsString(self);
+
+	strchar_t t_native_needle;
+	t_native_needle = (strchar_t)p_needle;
+	
+    if (MCStringIsNative(self))
     {
-        r_range = MCRangeMakeMinMax(t_start, t_finish);
-        return true;
+        char_t t_mapped_needle;
+        if (p_needle > UNICHAR_MAX ||
+            !MCUnicodeCharMapToNative((unichar_t)p_needle, t_mapped_needle))
+            return 0;
+        
+        return __MCNativeOp_Count(self -> native_chars + p_range . offset,
+                                  p_range . length,
+                                  &t_mapped_needle,
+                                  1,
+                                  p_options,
+                                  nil);
     }
     
-    r_range = MCRangeMakeMinMax(t_start, t_last_del . offset);
-    
-    return true;
+	return MCStringCountStrChars(self, p_range, &t_native_needle, 1, false, p_options);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
 MC_DLLEXPORT_DEF
-bool MCStringFold(MCStringRef self, MCStringOptions p_options)
+bool MCStringDivideAtChar(MCStringRef self, codepoint_t p_separator, MCStringOptions p_options, MCStringRef& r_head, MCStringRef& r_tail)
 {
-	MCAssert(MCStringIsMutable(self));
+	__MCAssertIsString(self);
 
-	// If we are looking for exact comparison then folding has no effect.
-	if (p_options == kMCStringOptionCompareExact || p_options == kMCStringOptionCompareNonliteral)
+	uindex_t t_offset;
+	if (!MCStringFirstIndexOfChar(self, p_separator, 0, p_options, t_offset))
+	{
+		if (!MCStringCopy(self, r_head))
+			return false;
+		
+		r_tail = MCValueRetain(kMCEmptyString);
+		
 		return true;
+	}
+	
+	return MCStringDivideAtIndex(self, t_offset, r_head, r_tail);
+}
 
-    // Ensure the string is not indirect.
-    if (__MCStringIsIndirect(self))
-        if (!__MCStringResolveIndirect(self))
-            return false;
-    
-    if (__MCStringIsNative(self))
-    {
-        MCNativeCharsLowercase(self -> native_chars, self -> char_count);
-        __MCStringChanged(self, true, true, true);
-        return true;
-    }
-    
-    // Case-fold the string
-    unichar_t *t_folded;
-    uindex_t t_folded_length;
-    if (!MCUnicodeCaseFold(self -> chars, self -> char_count, t_folded, t_folded_length))
-        return false;
-    
-    // Update the string
-    MCMemoryDeleteArray(self -> chars);
-    self -> chars = t_folded;
-    self -> char_count = t_folded_length;
+MC_DLLEXPORT_DEF
+bool MCStringDivideAtIndex(MCStringRef self, uindex_t p_offset, MCStringRef& r_head, MCStringRef& r_tail)
+{
+	__MCAssertIsString(self);
 
-	__MCStringChanged(self);
+	MCStringRef t_head;
+	if (!MCStringCopySubstring(self, MCRangeMake(0, p_offset), t_head))
+		return false;
+	
+	MCStringRef t_tail;
+	if (!MCStringCopySubstring(self, MCRangeMakeMinMax(p_offset + 1, MCStringGetLength(self)), t_tail))
+	{
+		MCValueRelease(t_head);
+		return false;
+	}
+	
+	r_head = t_head;
+	r_tail = t_tail;
 	
-	// We always succeed (at the moment)
 	return true;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+
 MC_DLLEXPORT_DEF
-bool MCStringLowercase(MCStringRef self, MCLocaleRef p_locale)
+bool MCStringBreakIntoChunks(MCStringRef self, codepoint_t p_separator, MCStringOptions p_options, MCRange*& r_ranges, uindex_t& r_range_count)
 {
-	MCAssert(MCStringIsMutable(self));
+	__MCAssertIsString(self);
+	MCAssert(p_separator < 128);
+	
+	uindex_t t_length;
+	t_length = MCStringGetLength(self);
+	
+	// Count the number of chunks, adjusting for an empty trailing chunk.
+	uindex_t t_range_count;
+	// SN-2014-11-13: [[ Bug 13993 ]] No delimiter found means 1 range, 1 delimiter means 2 ranges, etc.
+	t_range_count = MCStringCountChar(self, MCRangeMake(0, MCStringGetLength(self)), p_separator, p_options) + 1;
+	if (t_length > 0 && MCStringGetNativeCharAtIndex(self, t_length - 1) == p_separator)
+		t_range_count -= 1;
+	
+	// Allocate the range array.
+	MCRange *t_ranges;
+	if (!MCMemoryNewArray(t_range_count, t_ranges))
+		return false;
+	
+	// Now compute the ranges.
+	uindex_t t_prev_offset, t_offset, t_index;
+	t_prev_offset = 0;
+	t_offset = 0;
+	t_index = 0;
+	for(;;)
+	{
+		// SN-2014-11-13: [[ Bug 13993 ]] The offset might be after the last char, if the previous delimiter
+		// was the last char of the string. We are done in that case.
+		if (t_prev_offset == MCStringGetLength(self))
+			break;
 
-    // Ensure the string is not indirect.
-    if (__MCStringIsIndirect(self))
-        if (!__MCStringResolveIndirect(self))
-            return false;
-    
-    if (__MCStringIsNative(self))
-    {
-        MCNativeCharsLowercase(self -> native_chars, self -> char_count);
-        __MCStringChanged(self, true, true, true);
-        return true;
-    }
-    
-	// Case transformations can change string lengths
-    unichar_t *t_lowered;
-    uindex_t t_lowered_length;
-    if (!MCUnicodeLowercase(p_locale, self -> chars, self -> char_count, t_lowered, t_lowered_length))
-        return false;
-    
-    MCMemoryDeleteArray(self -> chars);
-    self -> chars = t_lowered;
-    self -> char_count = t_lowered_length;
+		if (!MCStringFirstIndexOfChar(self, p_separator, t_prev_offset, p_options, t_offset))
+		{
+			t_ranges[t_index] . offset = t_prev_offset;
+			t_ranges[t_index] . length = t_length - t_prev_offset;
+			break;
+		}
+		
+		t_ranges[t_index] . offset = t_prev_offset;
+		t_ranges[t_index] . length = t_offset - t_prev_offset;
+		
+		t_prev_offset = t_offset + 1;
+	}
 	
-	__MCStringChanged(self);
+	r_ranges = t_ranges;
+	r_range_count = t_range_count;
 	
-	// We always succeed (at the moment)
 	return true;
 }
 
-MC_DLLEXPORT_DEF
-bool MCStringUppercase(MCStringRef self, MCLocaleRef p_locale)
+////////////////////////////////////////////////////////////////////////////////
+
+// Skip 'count' occurrences of 'needle' in 'range' of 'self' according to 'options'.
+// If 'needle' is not found, false is returned and r_last is untouched.
+static bool __MCStringSkip(MCStringRef self,
+                           MCRange p_range,
+                           MCStringRef p_needle,
+                           uindex_t p_count,
+                           MCStringOptions p_options,
+                           MCRange& r_last)
 {
-	MCAssert(MCStringIsMutable(self));
+    MCAssert(p_count > 0);
     
-    // Ensure the string is not indirect.
-    if (__MCStringIsIndirect(self))
-        if (!__MCStringResolveIndirect(self))
+    // Optimize the case of both needle and self native.
+    if (__MCStringIsNative(self) &&
+        __MCStringIsNative(p_needle))
+    {
+        size_t t_last_offset;
+        if (!__MCNativeOp_Skip(self -> native_chars + p_range . offset,
+                               p_range . length,
+                               p_needle -> native_chars,
+                               p_needle -> char_count,
+                               p_count,
+                               p_options,
+                               &t_last_offset))
             return false;
+        
+        r_last . offset = p_range . offset + t_last_offset;
+        r_last . length = p_needle -> char_count;
+        return true;
+    }
     
-    if (__MCStringIsNative(self))
+    uindex_t t_start, t_finish;
+    t_start = p_range . offset;
+    t_finish = p_range . offset + p_range . length;
+    
+    MCRange t_last;
+    while(p_count > 0)
     {
-        MCNativeCharsUppercase(self -> native_chars, self -> char_count);
-        __MCStringChanged(self, true, true, true);
-        return true;
+        if (!__MCStringFind(self,
+                            MCRangeMakeMinMax(t_start, t_finish),
+                            p_needle,
+                            p_options,
+                            &t_last))
+            return false;
+        
+        // Decrement the number of needles to skip.
+        p_count -= 1;
+        
+        // Move the considered range to start at the end of the previous
+        // needle.
+        t_start = t_last . offset + t_last . length;
     }
     
-	// Case transformations can change string lengths
-    unichar_t *t_lowered;
-    uindex_t t_lowered_length;
-    if (!MCUnicodeUppercase(p_locale, self -> chars, self -> char_count, t_lowered, t_lowered_length))
-        return false;
+    r_last = t_last;
     
-    MCMemoryDeleteArray(self -> chars);
-    self -> chars = t_lowered;
-    self -> char_count = t_lowered_length;
-	
-	__MCStringChanged(self);
-	
-	// We always succeed (at the moment)
-	return true;
+    return true;
 }
 
-////////////////////////////////////////////////////////////////////////////////
-
-MC_DLLEXPORT_DEF
-bool MCStringAppend(MCStringRef self, MCStringRef p_suffix)
+// Count occurrences of 'needle' in 'range' of 'self' according to 'options'.
+// If no occurrences are found 0 is returned and r_last is untouched.
+static uindex_t __MCStringCount(MCStringRef self,
+                                MCRange p_range,
+                                MCStringRef p_needle,
+                                MCStringOptions p_options,
+                                MCRange *r_last)
 {
-	MCAssert(MCStringIsMutable(self));
-
-    if (__MCStringIsIndirect(p_suffix))
-        p_suffix = p_suffix -> string;
+    // Optimize the case of both needle and self native.
+    if (__MCStringIsNative(self) &&
+        __MCStringIsNative(p_needle))
+    {
+        size_t t_last_offset;
+        size_t t_count;
+        t_count = __MCNativeOp_Count(self -> native_chars + p_range . offset,
+                                     p_range . length,
+                                     p_needle -> native_chars,
+                                     p_needle -> char_count,
+                                     p_options,
+                                     &t_last_offset);
+        if (t_count > 0 &&
+            r_last != nil)
+        {
+            r_last -> offset = p_range . offset + t_last_offset;
+            r_last -> length = p_needle -> char_count;
+        }
+        
+        return t_count;
+    }
     
-    // Only do the append now if self != suffix.
-	if (self != p_suffix)
-	{
-        if (__MCStringIsNative(p_suffix))
-            return MCStringAppendNativeChars(self, p_suffix -> native_chars, p_suffix -> char_count);
+    uindex_t t_count;
+    t_count = 0;
     
-        return MCStringAppendChars(self, p_suffix -> chars, p_suffix -> char_count);
+    uindex_t t_start, t_finish;
+    t_start = p_range . offset;
+    t_finish = p_range . offset + p_range . length;
+    
+    MCRange t_last;
+    t_last = MCRangeMake(t_start, 0);
+    while(__MCStringFind(self,
+                         MCRangeMakeMinMax(t_start, t_finish),
+                         p_needle,
+                         p_options,
+                         &t_last))
+    {
+        // Increment the number of needles found.
+        t_count += 1;
+        
+        // Move the considered range to start at the end of the previous
+        // needle.
+        t_start = t_last . offset + t_last . length;
     }
+
+    if (t_count > 0 && r_last != nil)
+        *r_last = t_last;
     
-    // Otherwise copy and recurse.
-	MCAutoStringRef t_suffix_copy;
-	MCStringCopy(p_suffix, &t_suffix_copy);
-	return MCStringAppend(self, *t_suffix_copy);
+    return t_count;
 }
 
-MC_DLLEXPORT_DEF
-bool MCStringAppendSubstring(MCStringRef self, MCStringRef p_suffix, MCRange p_range)
-{
-	MCAssert(MCStringIsMutable(self));
-  
-    if (__MCStringIsIndirect(p_suffix))
-        p_suffix = p_suffix -> string;
+////////////////////////////////////////////////////////////////////////////////
 
-	// Only do the append now if self != suffix.
-	if (self != p_suffix)
-	{
-        __MCStringClampRange(p_suffix, p_range);
-        
-        if (__MCStringIsNative(p_suffix))
-            return MCStringAppendNativeChars(self, p_suffix -> native_chars + p_range . offset, p_range . length);
+static bool __MCStringDelimitedOffset(MCStringRef self,
+                                      MCRange p_range,
+                                      MCStringRef p_needle,
+                                      MCStringRef p_delimiter,
+                                      uindex_t p_skip,
+                                      MCStringOptions p_options,
+                                      uindex_t& r_index,
+                                      MCRange *r_found,
+                                      MCRange *r_before,
+                                      MCRange *r_after)
+{
+    // Compute the absolute start and finish points of the considered range.
+    // This is much easier to work with than offset / length.
+    // We gradually move 'start' forward past delimiters (and finally the
+    // found string) as the algorithm progresses.
+    uindex_t t_start, t_finish;
+    t_start = p_range . offset;
+    t_finish = p_range . offset + p_range . length;
+    
+    // Skip 'skip' delimiters, if this is not possible then we are done. This
+    // computes the initial 'previous delimiter'.
+    MCRange t_prev_delimiter;
+    t_prev_delimiter = MCRangeMake(t_start, 0);
+    if (p_skip > 0 &&
+        !__MCStringSkip(self,
+                        p_range,
+                        p_delimiter,
+                        p_skip,
+                        p_options,
+                        t_prev_delimiter))
+        return false;
+    
+    // The initial number of delimiters is the number we skip.
+    uindex_t t_delimiter_count;
+    t_delimiter_count = p_skip;
+    
+    // Make sure we start from the end of the last delimiter skipped.
+    t_start = t_prev_delimiter . offset + t_prev_delimiter . length;
+    
+    // Now search for 'needle' in the remaining range. If nothing is found, then
+    // we are done.
+    MCRange t_found_range;
+    if (!__MCStringFind(self,
+                        MCRangeMakeMinMax(t_start, t_finish),
+                        p_needle,
+                        p_options,
+                        &t_found_range))
+        return false;
+    
+    // We must now search for delimiters in the substring between the end of the
+    // previous delimiter and the start of the found range.
+    t_delimiter_count += __MCStringCount(self,
+                                         MCRangeMakeMinMax(t_start, t_found_range . offset),
+                                         p_delimiter,
+                                         p_options,
+                                         &t_prev_delimiter);
+    
+    // Return the (absolute) number of delimiters encountered.
+    r_index = t_delimiter_count;
+    
+    // Return the range of the found string (if required).
+    if (r_found != nil)
+        *r_found = t_found_range;
+    
+    // Return the range of the delimiter before the found string (if required).
+    if (r_before != nil)
+        *r_before = t_prev_delimiter;
+    
+    // Finally, if 'r_after' is required, we must find the first delimiter
+    // after the found string.
+    if (r_after != nil)
+    {
+        // Update start to be after the found range.
+        t_start = t_found_range . offset + t_found_range . length;
         
-        return MCStringAppendChars(self, p_suffix -> chars + p_range . offset, p_range . length);
+        MCRange t_next_delimiter;
+        if (!__MCStringFind(self,
+                            MCRangeMake(t_start,
+                                        t_finish - t_start),
+                            p_delimiter,
+                            p_options,
+                            &t_next_delimiter))
+            t_next_delimiter = MCRangeMake(t_finish, 0);
+        
+        *r_after = t_next_delimiter;
     }
     
-    // Otherwise copy substring and append.
-	MCAutoStringRef t_suffix_substring;
-	return MCStringCopySubstring(p_suffix, p_range, &t_suffix_substring) &&
-    MCStringAppend(self, *t_suffix_substring);
+    return true;
 }
 
 MC_DLLEXPORT_DEF
-bool MCStringAppendNativeChars(MCStringRef self, const char_t *p_chars, uindex_t p_char_count)
+bool MCStringDelimitedOffset(MCStringRef self,
+                             MCRange p_range,
+                             MCStringRef p_needle,
+                             MCStringRef p_delimiter,
+                             uindex_t p_skip,
+                             MCStringOptions p_options,
+                             uindex_t& r_index,
+                             MCRange *r_found,
+                             MCRange *r_before,
+                             MCRange *r_after)
 {
-	MCAssert(MCStringIsMutable(self));
-	
-    // Ensure the string is not indirect.
-    if (__MCStringIsIndirect(self))
-        if (!__MCStringResolveIndirect(self))
-            return false;
+	__MCAssertIsString(self);
+	__MCAssertIsString(p_needle);
+	__MCAssertIsString(p_delimiter);
     
-	// Ensure we have enough room in self - with the gap at the end.
-	if (!__MCStringExpandAt(self, self -> char_count, p_char_count))
-		return false;
-
-	if (__MCStringIsNative(self))
-    {
-        MCMemoryCopy(self -> native_chars + self -> char_count - p_char_count, p_chars, p_char_count);
-        self -> native_chars[self -> char_count] = '\0';
-        __MCStringChanged(self, true, true, true);
-        return true;
-    }
+    if (__MCStringIsIndirect(self) &&
+        !__MCStringDereference(self))
+        return false;
     
-	// Now copy the chars across.
-	for(uindex_t i = 0; i < p_char_count; i++)
-        self -> chars[i + self -> char_count - p_char_count] = MCUnicodeCharMapFromNative(p_chars[i]);
-
-	// Set the NULL
-    self -> chars[self -> char_count] = '\0';
-	
-    // Appending native chars cannot change the simple status
-	__MCStringChanged(self);
+    if (__MCStringIsIndirect(p_needle) &&
+        !__MCStringDereference(p_needle))
+        return false;
     
-	// We succeeded.
-	return true;
-}
-
-MC_DLLEXPORT_DEF
-bool MCStringAppendChars(MCStringRef self, const unichar_t *p_chars, uindex_t p_char_count)
-{
-	MCAssert(MCStringIsMutable(self));
+    if (__MCStringIsIndirect(p_delimiter) &&
+        !__MCStringDereference(p_delimiter))
+        return false;
     
-    // Ensure the string is not indirect.
-    if (__MCStringIsIndirect(self))
-        if (!__MCStringResolveIndirect(self))
-            return false;
-	
-    // Ensure we have enough room in self - with the gap at the end.
-    if (!__MCStringExpandAt(self, self -> char_count, p_char_count))
+    __MCStringClampRange(self, p_range);
+    
+    if (__MCStringIsEmpty(p_needle))
         return false;
     
-    // If we are native, attempt a native copy of the input chars.
-    if (__MCStringIsNative(self))
+    if (__MCStringIsNative(self) &&
+        __MCStringIsNative(p_needle) &&
+        __MCStringIsNative(p_delimiter) &&
+        __MCStringGetLength(p_delimiter) == 1)
     {
-        bool t_not_native;
-        t_not_native = false;
-        for(uindex_t i = 0; i < p_char_count; i++)
-            if (!MCUnicodeCharMapToNative(p_chars[i], self -> native_chars[i + self -> char_count - p_char_count]))
+        size_t t_index, t_found, t_before, t_after;
+        if (!__MCNativeOp_ForwardCharDelimitedOffset(self -> native_chars + p_range . offset,
+                                                     p_range . length,
+                                                     p_needle -> native_chars,
+                                                     p_needle -> char_count,
+                                                     p_delimiter -> native_chars[0],
+                                                     p_skip,
+                                                     p_options,
+                                                     t_index,
+                                                     r_found != nil ? &t_found : nil,
+                                                     r_before != nil ? &t_before : nil,
+                                                     r_after != nil ? &t_after : nil))
+            return false;
+        
+        r_index = t_index;
+        if (r_found != nil)
+        {
+            r_found -> offset = p_range . offset + t_found;
+            r_found -> length = p_needle -> char_count;
+        }
+        
+        if (r_before != nil)
+        {
+            if (t_index > p_skip)
             {
-                t_not_native = true;
-                break;
+                r_before -> offset = p_range . offset + t_before;
+                r_before -> length = 1;
+            }
+            else
+            {
+                r_before -> offset = p_range . offset;
+                r_before -> length = 0;
             }
+        }
         
-        if (!t_not_native)
+        if (r_after != nil)
         {
-            self -> native_chars[self -> char_count] = '\0';
-            __MCStringChanged(self, true, true, true);
-            return true;
+            if (t_after < p_range . length)
+            {
+                r_after -> offset = p_range . offset + t_after;
+                r_after -> length = 1;
+            }
+            else
+            {
+                r_after -> offset = p_range . offset + p_range . length;
+                r_after -> length = 0;
+            }
         }
         
-        // At least one of the additional chars was not native.
-        __MCStringShrinkAt(self, self -> char_count - p_char_count, p_char_count);
-		if (!__MCStringUnnativize(self))
-		{
-			return false;
-		}
-        return MCStringAppendChars(self, p_chars, p_char_count);
+        return true;
     }
     
-    // Copy the chars across recomputing whether the string can be native at
-    // the same time.
-    bool t_can_be_native;
-    t_can_be_native = __MCStringCopyChars(self -> chars + self -> char_count - p_char_count, p_chars, p_char_count, __MCStringCanBeNative(self));
-	
-	// Set the NULL
-	self -> chars[self -> char_count] = '\0';
-	
-	__MCStringChanged(self, false, false, t_can_be_native);
-	
-	// We succeeded.
-	return true;
+    return __MCStringDelimitedOffset(self,
+                                     p_range,
+                                     p_needle,
+                                     p_delimiter,
+                                     p_skip,
+                                     p_options,
+                                     r_index,
+                                     r_found,
+                                     r_before,
+                                     r_after);
 }
 
-MC_DLLEXPORT_DEF
-bool MCStringAppendNativeChar(MCStringRef self, char_t p_char)
-{
-	return MCStringAppendNativeChars(self, &p_char, 1);
-}
+////////////////////////////////////////////////////////////////////////////////
 
 MC_DLLEXPORT_DEF
-bool MCStringAppendChar(MCStringRef self, unichar_t p_char)
+bool MCStringForwardDelimitedRegion(MCStringRef self,
+                                    MCRange p_range,
+                                    MCStringRef p_delimiter,
+                                    MCRange p_region,
+                                    MCStringOptions p_options,
+                                    MCRange& r_range)
 {
-	return MCStringAppendChars(self, &p_char, 1);
-}
+	__MCAssertIsString(self);
+	__MCAssertIsString(p_delimiter);
+    
+    if (__MCStringIsIndirect(self) &&
+        !__MCStringDereference(self))
+        return false;
+    
+    if (__MCStringIsIndirect(p_delimiter) &&
+        !__MCStringDereference(p_delimiter))
+        return false;
+    
+    __MCStringClampRange(self, p_range);
+    
+    uindex_t t_start, t_finish;
+    t_start = p_range . offset;
+    t_finish = p_range . offset + p_range . length;
+    
+    MCRange t_first_del;
+    t_first_del = MCRangeMake(t_start, 0);
+    if (p_region . offset > 0 &&
+        !__MCStringSkip(self,
+                        MCRangeMakeMinMax(t_start, t_finish),
+                        p_delimiter,
+                        p_region . offset,
+                        p_options,
+                        t_first_del))
+    {
+        r_range = MCRangeMake(t_finish,
+                              0);
+        return true;
+    }
+    
+    t_start = t_first_del . offset + t_first_del . length;
+    
+    if (p_region . length == 0)
+    {
+        r_range = MCRangeMakeMinMax(t_start, 0);
+        return true;
+    }
+    
+    MCRange t_last_del;
+    if (!__MCStringSkip(self,
+                        MCRangeMakeMinMax(t_start, t_finish),
+                        p_delimiter,
+                        p_region . length,
+                        p_options,
+                        t_last_del))
+    {
+        r_range = MCRangeMakeMinMax(t_start, t_finish);
+        return true;
+    }
+    
+    r_range = MCRangeMakeMinMax(t_start, t_last_del . offset);
+    
+    return true;
+}
 
-MC_DLLEXPORT_DEF bool
-MCStringAppendCodepoint (MCStringRef self, codepoint_t p_codepoint)
+////////////////////////////////////////////////////////////////////////////////
+
+MC_DLLEXPORT_DEF
+bool MCStringFold(MCStringRef self, MCStringOptions p_options)
 {
-	uindex_t t_num_units;
-	unichar_t t_units[2];
-	t_num_units = MCStringCodepointToSurrogates (p_codepoint, t_units);
-	return MCStringAppendChars (self, t_units, t_num_units);
+	MCAssert(MCStringIsMutable(self));
+
+	// If we are looking for exact comparison then folding has no effect.
+	if (p_options == kMCStringOptionCompareExact || p_options == kMCStringOptionCompareNonliteral)
+		return true;
+
+    // Ensure the string is not indirect.
+    if (__MCStringIsIndirect(self))
+        if (!__MCStringResolveIndirect(self))
+            return false;
+    
+    if (__MCStringIsNative(self))
+    {
+        MCNativeCharsLowercase(self -> native_chars, self -> char_count);
+        __MCStringChanged(self, true, true, true);
+        return true;
+    }
+    
+    // Case-fold the string
+    unichar_t *t_folded;
+    uindex_t t_folded_length;
+    if (!MCUnicodeCaseFold(self -> chars, self -> char_count, t_folded, t_folded_length))
+        return false;
+    
+    // Update the string
+    MCMemoryDeleteArray(self -> chars);
+    self -> chars = t_folded;
+    self -> char_count = t_folded_length;
+
+	__MCStringChanged(self);
+	
+	// We always succeed (at the moment)
+	return true;
 }
 
 MC_DLLEXPORT_DEF
-bool MCStringPrepend(MCStringRef self, MCStringRef p_prefix)
+bool MCStringLowercase(MCStringRef self, MCLocaleRef p_locale)
 {
 	MCAssert(MCStringIsMutable(self));
+
+    // Ensure the string is not indirect.
+    if (__MCStringIsIndirect(self))
+        if (!__MCStringResolveIndirect(self))
+            return false;
     
-    if (__MCStringIsIndirect(p_prefix))
-        p_prefix = p_prefix -> string;
+    if (__MCStringIsNative(self))
+    {
+        MCNativeCharsLowercase(self -> native_chars, self -> char_count);
+        __MCStringChanged(self, true, true, true);
+        return true;
+    }
     
- 	// Only do the prepend now if self != prefix.
-	if (self != p_prefix)
+	// Case transformations can change string lengths
+    unichar_t *t_lowered;
+    uindex_t t_lowered_length;
+    if (!MCUnicodeLowercase(p_locale, self -> chars, self -> char_count, t_lowered, t_lowered_length))
+        return false;
+    
+    MCMemoryDeleteArray(self -> chars);
+    self -> chars = t_lowered;
+    self -> char_count = t_lowered_length;
+	
+	__MCStringChanged(self);
+	
+	// We always succeed (at the moment)
+	return true;
+}
+
+MC_DLLEXPORT_DEF
+bool MCStringUppercase(MCStringRef self, MCLocaleRef p_locale)
+{
+	MCAssert(MCStringIsMutable(self));
+    
+    // Ensure the string is not indirect.
+    if (__MCStringIsIndirect(self))
+        if (!__MCStringResolveIndirect(self))
+            return false;
+    
+    if (__MCStringIsNative(self))
+    {
+        MCNativeCharsUppercase(self -> native_chars, self -> char_count);
+        __MCStringChanged(self, true, true, true);
+        return true;
+    }
+    
+	// Case transformations can change string lengths
+    unichar_t *t_lowered;
+    uindex_t t_lowered_length;
+    if (!MCUnicodeUppercase(p_locale, self -> chars, self -> char_count, t_lowered, t_lowered_length))
+        return false;
+    
+    MCMemoryDeleteArray(self -> chars);
+    self -> chars = t_lowered;
+    self -> char_count = t_lowered_length;
+	
+	__MCStringChanged(self);
+	
+	// We always succeed (at the moment)
+	return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+MC_DLLEXPORT_DEF
+bool MCStringAppend(MCStringRef self, MCStringRef p_suffix)
+{
+	MCAssert(MCStringIsMutable(self));
+
+    // Only do the append now if self != suffix.
+	if (self != p_suffix)
 	{
-        if (__MCStringIsNative(p_prefix))
-            return MCStringPrependNativeChars(self, p_prefix -> native_chars, p_prefix -> char_count);
+        if (__MCStringIsIndirect(p_suffix) &&
+            !__MCStringDereference(p_suffix))
+            return false;
         
-        return MCStringPrependChars(self, p_prefix -> chars, p_prefix -> char_count);
+        if (__MCStringIsNative(p_suffix))
+            return MCStringAppendNativeChars(self, p_suffix -> native_chars, p_suffix -> char_count);
+    
+        return MCStringAppendChars(self, p_suffix -> chars, p_suffix -> char_count);
     }
     
     // Otherwise copy and recurse.
-	MCAutoStringRef t_prefix_copy;
-	MCStringCopy(p_prefix, &t_prefix_copy);
-	return MCStringPrepend(self, *t_prefix_copy);
+	MCAutoStringRef t_suffix_copy;
+	MCStringCopy(p_suffix, &t_suffix_copy);
+	return MCStringAppend(self, *t_suffix_copy);
 }
 
 MC_DLLEXPORT_DEF
-bool MCStringPrependSubstring(MCStringRef self, MCStringRef p_prefix, MCRange p_range)
+bool MCStringAppendSubstring(MCStringRef self, MCStringRef p_suffix, MCRange p_range)
 {
 	MCAssert(MCStringIsMutable(self));
-
-    if (__MCStringIsIndirect(p_prefix))
-        p_prefix = p_prefix -> string;
-    
-    // Only do the prepend now if self != prefix.
-	if (self != p_prefix)
+  
+	// Only do the append now if self != suffix.
+	if (self != p_suffix)
 	{
-        __MCStringClampRange(p_prefix, p_range);
+        if (__MCStringIsIndirect(p_suffix) &&
+            !__MCStringDereference(p_suffix))
+            return false;
         
-        if (__MCStringIsNative(p_prefix))
-            return MCStringAppendNativeChars(self, p_prefix -> native_chars + p_range . offset, p_range . length);
+        __MCStringClampRange(p_suffix, p_range);
         
-        return MCStringAppendChars(self, p_prefix -> chars + p_range . offset, p_range . length);
+        if (__MCStringIsNative(p_suffix))
+            return MCStringAppendNativeChars(self, p_suffix -> native_chars + p_range . offset, p_range . length);
+        
+        return MCStringAppendChars(self, p_suffix -> chars + p_range . offset, p_range . length);
     }
     
-    // Otherwise copy substring and prepend.
-	MCAutoStringRef t_prefix_substring;
-	return MCStringCopySubstring(p_prefix, p_range, &t_prefix_substring) &&
-    MCStringPrepend(self, *t_prefix_substring);
+    // Otherwise copy substring and append.
+	MCAutoStringRef t_suffix_substring;
+	return MCStringCopySubstring(p_suffix, p_range, &t_suffix_substring) &&
+    MCStringAppend(self, *t_suffix_substring);
 }
 
 MC_DLLEXPORT_DEF
-bool MCStringPrependNativeChars(MCStringRef self, const char_t *p_chars, uindex_t p_char_count)
+bool MCStringAppendNativeChars(MCStringRef self, const char_t *p_chars, uindex_t p_char_count)
 {
 	MCAssert(MCStringIsMutable(self));
 	
+    // Large strings are edited as ropes where that avoids moving or copying
+    // their chars.
+    bool t_edited;
+    if (!__MCStringEditAsRope(self, MCRangeMake(UINDEX_MAX, 0), p_chars, p_char_count, true, t_edited))
+        return false;
+    if (t_edited)
+        return true;
+    
     // Ensure the string is not indirect.
     if (__MCStringIsIndirect(self))
         if (!__MCStringResolveIndirect(self))
             return false;
     
-	// Ensure we have enough room in self - with the gap at the beginning.
-	if (!__MCStringExpandAt(self, 0, p_char_count))
+	// Ensure we have enough room in self - with the gap at the end.
+	if (!__MCStringExpandAt(self, self -> char_count, p_char_count))
 		return false;
-	
-    if (__MCStringIsNative(self))
+
+	if (__MCStringIsNative(self))
     {
-        MCMemoryCopy(self -> native_chars, p_chars, p_char_count);
+        MCMemoryCopy(self -> native_chars + self -> char_count - p_char_count, p_chars, p_char_count);
+        self -> native_chars[self -> char_count] = '\0';
         __MCStringChanged(self, true, true, true);
         return true;
     }
     
 	// Now copy the chars across.
 	for(uindex_t i = 0; i < p_char_count; i++)
-		self -> chars[i] = MCUnicodeCharMapFromNative(p_chars[i]);
+        self -> chars[i + self -> char_count - p_char_count] = MCUnicodeCharMapFromNative(p_chars[i]);
+
+	// Set the NULL
+    self -> chars[self -> char_count] = '\0';
 	
-    // Prepending native chars cannot change the simple status
+    // Appending native chars cannot change the simple status
 	__MCStringChanged(self);
-	
+    
 	// We succeeded.
 	return true;
 }
 
 MC_DLLEXPORT_DEF
-bool MCStringPrependChars(MCStringRef self, const unichar_t *p_chars, uindex_t p_char_count)
+bool MCStringAppendChars(MCStringRef self, const unichar_t *p_chars, uindex_t p_char_count)
 {
 	MCAssert(MCStringIsMutable(self));
-	
+    
+    // Large strings are edited as ropes where that avoids moving or copying
+    // their chars.
+    bool t_edited;
+    if (!__MCStringEditAsRope(self, MCRangeMake(UINDEX_MAX, 0), p_chars, p_char_count, false, t_edited))
+        return false;
+    if (t_edited)
+        return true;
+    
     // Ensure the string is not indirect.
     if (__MCStringIsIndirect(self))
         if (!__MCStringResolveIndirect(self))
             return false;
 	
     // Ensure we have enough room in self - with the gap at the end.
-    if (!__MCStringExpandAt(self, 0, p_char_count))
+    if (!__MCStringExpandAt(self, self -> char_count, p_char_count))
         return false;
     
     // If we are native, attempt a native copy of the input chars.
@@ -4650,9 +5489,7 @@ bool MCStringPrependChars(MCStringRef self, const unichar_t *p_chars, uindex_t p
         bool t_not_native;
         t_not_native = false;
         for(uindex_t i = 0; i < p_char_count; i++)
-            // SN-2014-05-20 [[ Bug 12344 ]] [[ Bug 12345 ]]
-            // Prepending chars was appending them
-            if (!MCUnicodeCharMapToNative(p_chars[i], self -> native_chars[i]))
+            if (!MCUnicodeCharMapToNative(p_chars[i], self -> native_chars[i + self -> char_count - p_char_count]))
             {
                 t_not_native = true;
                 break;
@@ -4666,18 +5503,195 @@ bool MCStringPrependChars(MCStringRef self, const unichar_t *p_chars, uindex_t p
         }
         
         // At least one of the additional chars was not native.
-        __MCStringShrinkAt(self, 0, p_char_count);
+        __MCStringShrinkAt(self, self -> char_count - p_char_count, p_char_count);
 		if (!__MCStringUnnativize(self))
 		{
 			return false;
 		}
-        return MCStringPrependChars(self, p_chars, p_char_count);
+        return MCStringAppendChars(self, p_chars, p_char_count);
     }
     
     // Copy the chars across recomputing whether the string can be native at
     // the same time.
     bool t_can_be_native;
-    t_can_be_native = __MCStringCopyChars(self -> chars, p_chars, p_char_count, __MCStringCanBeNative(self));
+    t_can_be_native = __MCStringCopyChars(self -> chars + self -> char_count - p_char_count, p_chars, p_char_count, __MCStringCanBeNative(self));
+	
+	// Set the NULL
+	self -> chars[self -> char_count] = '\0';
+	
+	__MCStringChanged(self, false, false, t_can_be_native);
+	
+	// We succeeded.
+	return true;
+}
+
+MC_DLLEXPORT_DEF
+bool MCStringAppendNativeChar(MCStringRef self, char_t p_char)
+{
+	return MCStringAppendNativeChars(self, &p_char, 1);
+}
+
+MC_DLLEXPORT_DEF
+bool MCStringAppendChar(MCStringRef self, unichar_t p_char)
+{
+	return MCStringAppendChars(self, &p_char, 1);
+}
+
+MC_DLLEXPORT_DEF bool
+MCStringAppendCodepoint (MCStringRef self, codepoint_t p_codepoint)
+{
+	uindex_t t_num_units;
+	unichar_t t_units[2];
+	t_num_units = MCStringCodepointToSurrogates (p_codepoint, t_units);
+	return MCStringAppendChars (self, t_units, t_num_units);
+}
+
+MC_DLLEXPORT_DEF
+bool MCStringPrepend(MCStringRef self, MCStringRef p_prefix)
+{
+	MCAssert(MCStringIsMutable(self));
+    
+ 	// Only do the prepend now if self != prefix.
+	if (self != p_prefix)
+	{
+        if (__MCStringIsIndirect(p_prefix) &&
+            !__MCStringDereference(p_prefix))
+            return false;
+        
+        if (__MCStringIsNative(p_prefix))
+            return MCStringPrependNativeChars(self, p_prefix -> native_chars, p_prefix -> char_count);
+        
+        return MCStringPrependChars(self, p_prefix -> chars, p_prefix -> char_count);
+    }
+    
+    // Otherwise copy and recurse.
+	MCAutoStringRef t_prefix_copy;
+	MCStringCopy(p_prefix, &t_prefix_copy);
+	return MCStringPrepend(self, *t_prefix_copy);
+}
+
+MC_DLLEXPORT_DEF
+bool MCStringPrependSubstring(MCStringRef self, MCStringRef p_prefix, MCRange p_range)
+{
+	MCAssert(MCStringIsMutable(self));
+
+    // Only do the prepend now if self != prefix.
+	if (self != p_prefix)
+	{
+        if (__MCStringIsIndirect(p_prefix) &&
+            !__MCStringDereference(p_prefix))
+            return false;
+        
+        __MCStringClampRange(p_prefix, p_range);
+        
+        if (__MCStringIsNative(p_prefix))
+            return MCStringAppendNativeChars(self, p_prefix -> native_chars + p_range . offset, p_range . length);
+        
+        return MCStringAppendChars(self, p_prefix -> chars + p_range . offset, p_range . length);
+    }
+    
+    // Otherwise copy substring and prepend.
+	MCAutoStringRef t_prefix_substring;
+	return MCStringCopySubstring(p_prefix, p_range, &t_prefix_substring) &&
+    MCStringPrepend(self, *t_prefix_substring);
+}
+
+MC_DLLEXPORT_DEF
+bool MCStringPrependNativeChars(MCStringRef self, const char_t *p_chars, uindex_t p_char_count)
+{
+	MCAssert(MCStringIsMutable(self));
+	
+    // Large strings are edited as ropes where that avoids moving or copying
+    // their chars.
+    bool t_edited;
+    if (!__MCStringEditAsRope(self, MCRangeMake(0, 0), p_chars, p_char_count, true, t_edited))
+        return false;
+    if (t_edited)
+        return true;
+    
+    // Ensure the string is not indirect.
+    if (__MCStringIsIndirect(self))
+        if (!__MCStringResolveIndirect(self))
+            return false;
+    
+	// Ensure we have enough room in self - with the gap at the beginning.
+	if (!__MCStringExpandAt(self, 0, p_char_count))
+		return false;
+	
+    if (__MCStringIsNative(self))
+    {
+        MCMemoryCopy(self -> native_chars, p_chars, p_char_count);
+        __MCStringChanged(self, true, true, true);
+        return true;
+    }
+    
+	// Now copy the chars across.
+	for(uindex_t i = 0; i < p_char_count; i++)
+		self -> chars[i] = MCUnicodeCharMapFromNative(p_chars[i]);
+	
+    // Prepending native chars cannot change the simple status
+	__MCStringChanged(self);
+	
+	// We succeeded.
+	return true;
+}
+
+MC_DLLEXPORT_DEF
+bool MCStringPrependChars(MCStringRef self, const unichar_t *p_chars, uindex_t p_char_count)
+{
+	MCAssert(MCStringIsMutable(self));
+	
+    // Large strings are edited as ropes where that avoids moving or copying
+    // their chars.
+    bool t_edited;
+    if (!__MCStringEditAsRope(self, MCRangeMake(0, 0), p_chars, p_char_count, false, t_edited))
+        return false;
+    if (t_edited)
+        return true;
+    
+    // Ensure the string is not indirect.
+    if (__MCStringIsIndirect(self))
+        if (!__MCStringResolveIndirect(self))
+            return false;
+	
+    // Ensure we have enough room in self - with the gap at the end.
+    if (!__MCStringExpandAt(self, 0, p_char_count))
+        return false;
+    
+    // If we are native, attempt a native copy of the input chars.
+    if (__MCStringIsNative(self))
+    {
+        bool t_not_native;
+        t_not_native = false;
+        for(uindex_t i = 0; i < p_char_count; i++)
+            // SN-2014-05-20 [[ Bug 12344 ]] [[ Bug 12345 ]]
+            // Prepending chars was appending them
+            if (!MCUnicodeCharMapToNative(p_chars[i], self -> native_chars[i]))
+            {
+                t_not_native = true;
+                break;
+            }
+        
+        if (!t_not_native)
+        {
+            self -> native_chars[self -> char_count] = '\0';
+            __MCStringChanged(self, true, true, true);
+            return true;
+        }
+        
+        // At least one of the additional chars was not native.
+        __MCStringShrinkAt(self, 0, p_char_count);
+		if (!__MCStringUnnativize(self))
+		{
+			return false;
+		}
+        return MCStringPrependChars(self, p_chars, p_char_count);
+    }
+    
+    // Copy the chars across recomputing whether the string can be native at
+    // the same time.
+    bool t_can_be_native;
+    t_can_be_native = __MCStringCopyChars(self -> chars, p_chars, p_char_count, __MCStringCanBeNative(self));
 	
 	__MCStringChanged(self, false, false, t_can_be_native);
 	
@@ -4711,12 +5725,13 @@ bool MCStringInsert(MCStringRef self, uindex_t p_at, MCStringRef p_substring)
 {
 	MCAssert(MCStringIsMutable(self));
 
-    if (__MCStringIsIndirect(p_substring))
-        p_substring = p_substring -> string;
-    
 	// Only do the insert now if self != substring.
 	if (self != p_substring)
 	{
+        if (__MCStringIsIndirect(p_substring) &&
+            !__MCStringDereference(p_substring))
+            return false;
+        
         if (__MCStringIsNative(p_substring))
             return MCStringInsertNativeChars(self, p_at, p_substring -> native_chars, p_substring -> char_count);
         
@@ -4734,12 +5749,13 @@ bool MCStringInsertSubstring(MCStringRef self, uindex_t p_at, MCStringRef p_subs
 {
 	MCAssert(MCStringIsMutable(self));
 
-    if (__MCStringIsIndirect(p_substring))
-        p_substring = p_substring -> string;
-    
 	// Only do the insert now if self != substring.
 	if (self != p_substring)
 	{
+        if (__MCStringIsIndirect(p_substring) &&
+            !__MCStringDereference(p_substring))
+            return false;
+        
         if (__MCStringIsNative(p_substring))
             return MCStringInsertNativeChars(self, p_at, p_substring -> native_chars + p_range . offset, p_range . length);
         
@@ -4757,6 +5773,14 @@ bool MCStringInsertNativeChars(MCStringRef self, uindex_t p_at, const char_t *p_
 {
 	MCAssert(MCStringIsMutable(self));
 	
+    // Large strings are edited as ropes where that avoids moving or copying
+    // their chars.
+    bool t_edited;
+    if (!__MCStringEditAsRope(self, MCRangeMake(p_at, 0), p_chars, p_char_count, true, t_edited))
+        return false;
+    if (t_edited)
+        return true;
+    
     // Ensure the string is not indirect.
     if (__MCStringIsIndirect(self))
         if (!__MCStringResolveIndirect(self))
@@ -4791,6 +5815,14 @@ bool MCStringInsertChars(MCStringRef self, uindex_t p_at, const unichar_t *p_cha
 {
 	MCAssert(MCStringIsMutable(self));
 
+    // Large strings are edited as ropes where that avoids moving or copying
+    // their chars.
+    bool t_edited;
+    if (!__MCStringEditAsRope(self, MCRangeMake(p_at, 0), p_chars, p_char_count, false, t_edited))
+        return false;
+    if (t_edited)
+        return true;
+    
     // Ensure the string is not indirect.
     if (__MCStringIsIndirect(self))
         if (!__MCStringResolveIndirect(self))
@@ -4868,6 +5900,14 @@ bool MCStringRemove(MCStringRef self, MCRange p_range)
 {
 	MCAssert(MCStringIsMutable(self));
 
+    // Large strings are edited as ropes where that avoids moving or copying
+    // their chars.
+    bool t_edited;
+    if (!__MCStringEditAsRope(self, p_range, nil, 0, true, t_edited))
+        return false;
+    if (t_edited)
+        return true;
+    
     // Ensure the string is not indirect.
     if (__MCStringIsIndirect(self))
         if (!__MCStringResolveIndirect(self))
@@ -4920,6 +5960,14 @@ bool MCStringReplaceNativeChars(MCStringRef self, MCRange p_range, const char_t
 {
     MCAssert(MCStringIsMutable(self));
     
+    // Large strings are edited as ropes where that avoids moving or copying
+    // their chars.
+    bool t_edited;
+    if (!__MCStringEditAsRope(self, p_range, p_chars, p_char_count, true, t_edited))
+        return false;
+    if (t_edited)
+        return true;
+    
     // Ensure the string is not indirect.
     if (__MCStringIsIndirect(self))
         if (!__MCStringResolveIndirect(self))
@@ -4966,6 +6014,14 @@ bool MCStringReplaceChars(MCStringRef self, MCRange p_range, const unichar_t *p_
 {
     MCAssert(MCStringIsMutable(self));
     
+    // Large strings are edited as ropes where that avoids moving or copying
+    // their chars.
+    bool t_edited;
+    if (!__MCStringEditAsRope(self, p_range, p_chars, p_char_count, false, t_edited))
+        return false;
+    if (t_edited)
+        return true;
+    
     // Ensure the string is not indirect.
     if (__MCStringIsIndirect(self))
         if (!__MCStringResolveIndirect(self))
@@ -5044,12 +6100,13 @@ bool MCStringReplace(MCStringRef self, MCRange p_range, MCStringRef p_replacemen
 {
 	__MCAssertIsMutableString(self);
 
-    if (__MCStringIsIndirect(p_replacement))
-        p_replacement = p_replacement -> string;
-    
 	// Only do the replace now if self != substring.
 	if (self != p_replacement)
 	{
+        if (__MCStringIsIndirect(p_replacement) &&
+            !__MCStringDereference(p_replacement))
+            return false;
+        
         if (__MCStringIsNative(p_replacement))
             return MCStringReplaceNativeChars(self, p_range, p_replacement -> native_chars, p_replacement -> char_count);
         
@@ -5072,8 +6129,9 @@ bool MCStringPad(MCStringRef self, uindex_t p_at, uindex_t p_count, MCStringRef
         if (!__MCStringResolveIndirect(self))
             return false;
     
-    if (__MCStringIsIndirect(p_value))
-        p_value = p_value -> string;
+    if (__MCStringIsIndirect(p_value) &&
+        !__MCStringDereference(p_value))
+        return false;
     
 	if (!__MCStringExpandAt(self, p_at, p_count * (p_value != nil ? p_value -> char_count : 1)))
 		return false;
@@ -5210,11 +6268,13 @@ bool MCStringSplitNative(MCStringRef self, MCStringRef p_elem_del, MCStringRef p
 	if (!MCArrayCreateMutable(&t_array))
 		return false;
 
-    if (__MCStringIsIndirect(self))
-        self = self -> string;
+    if (__MCStringIsIndirect(self) &&
+        !__MCStringDereference(self))
+        return false;
     
-    if (__MCStringIsIndirect(p_elem_del))
-        p_elem_del = p_elem_del -> string;
+    if (__MCStringIsIndirect(p_elem_del) &&
+        !__MCStringDereference(p_elem_del))
+        return false;
     
     
     const char_t *t_sptr;
@@ -5249,8 +6309,9 @@ bool MCStringSplitNative(MCStringRef self, MCStringRef p_elem_del, MCStringRef p
 	}
 	else
 	{
-        if (__MCStringIsIndirect(p_key_del))
-            p_elem_del = p_key_del -> string;
+        if (__MCStringIsIndirect(p_key_del) &&
+            !__MCStringDereference(p_key_del))
+            return false;
         
 		for(;;)
 		{
@@ -5325,11 +6386,13 @@ bool MCStringFindAndReplaceNative(MCStringRef self, MCStringRef p_pattern, MCStr
         if (!__MCStringResolveIndirect(self))
             return false;
     
-    if (__MCStringIsIndirect(p_replacement))
-        p_replacement = p_replacement -> string;
+    if (__MCStringIsIndirect(p_replacement) &&
+        !__MCStringDereference(p_replacement))
+        return false;
     
-    if (__MCStringIsIndirect(p_pattern))
-        p_pattern = p_pattern -> string;
+    if (__MCStringIsIndirect(p_pattern) &&
+        !__MCStringDereference(p_pattern))
+        return false;
     
 	if (p_pattern -> char_count == 1 && p_replacement -> char_count == 1)
 		return MCStringFindAndReplaceChar(self, p_pattern -> native_chars[0], p_replacement -> native_chars[0], p_options);
@@ -5474,8 +6537,9 @@ bool MCStringSplit(MCStringRef self, MCStringRef p_elem_del, MCStringRef p_key_d
 		__MCAssertIsString(p_key_del);
 
 
-    if (__MCStringIsIndirect(self))
-        self = self -> string;
+    if (__MCStringIsIndirect(self) &&
+        !__MCStringDereference(self))
+        return false;
     
     // SN-2014-03-24: [[ SplitWithStrings ]] No longer checks whether the delimiter is actually 1-char long.
 	if (self -> char_count == 0)
@@ -5494,8 +6558,9 @@ bool MCStringSplit(MCStringRef self, MCStringRef p_elem_del, MCStringRef p_key_d
 	if (!MCArrayCreateMutable(&t_array))
 		return false;
     
-    if (__MCStringIsIndirect(p_elem_del))
-        p_elem_del = p_elem_del -> string;
+    if (__MCStringIsIndirect(p_elem_del) &&
+        !__MCStringDereference(p_elem_del))
+        return false;
     
 	const void *t_echar, *t_kchar;
     bool del_native, key_native;
@@ -5504,8 +6569,9 @@ bool MCStringSplit(MCStringRef self, MCStringRef p_elem_del, MCStringRef p_key_d
 
 	if (p_key_del != nil)
     {
-        if (__MCStringIsIndirect(p_key_del))
-            p_key_del = p_key_del -> string;
+        if (__MCStringIsIndirect(p_key_del) &&
+            !__MCStringDereference(p_key_del))
+            return false;
         
         key_native = __MCStringIsNative(p_key_del);
 		t_kchar = p_key_del -> chars;
@@ -5599,8 +6665,9 @@ bool MCStringSplitByDelimiter(MCStringRef self, MCStringRef p_elem_del, MCString
 	__MCAssertIsString(self);
 	__MCAssertIsString(p_elem_del);
 
-    if (__MCStringIsIndirect(self))
-        self = self -> string;
+    if (__MCStringIsIndirect(self) &&
+        !__MCStringDereference(self))
+        return false;
     
     // SN-2014-03-24: [[ SplitWithStrings ]] No longer checks whether the delimiter is actually 1-char long.
 	if (self -> char_count == 0)
@@ -5615,8 +6682,9 @@ bool MCStringSplitByDelimiter(MCStringRef self, MCStringRef p_elem_del, MCString
             return MCStringSplitByDelimiterNative(self, p_elem_del, p_options, r_list);
     }
     
-    if (__MCStringIsIndirect(p_elem_del))
-        p_elem_del = p_elem_del -> string;
+    if (__MCStringIsIndirect(p_elem_del) &&
+        !__MCStringDereference(p_elem_del))
+        return false;
     
 	const void *t_echar;
     bool del_native;
@@ -5673,11 +6741,13 @@ bool MCStringSplitByDelimiter(MCStringRef self, MCStringRef p_elem_del, MCString
 static bool
 MCStringSplitByDelimiterNative(MCStringRef self, MCStringRef p_elem_del, MCStringOptions p_options, MCProperListRef& r_list)
 {
-    if (__MCStringIsIndirect(self))
-        self = self -> string;
+    if (__MCStringIsIndirect(self) &&
+        !__MCStringDereference(self))
+        return false;
     
-    if (__MCStringIsIndirect(p_elem_del))
-        p_elem_del = p_elem_del -> string;
+    if (__MCStringIsIndirect(p_elem_del) &&
+        !__MCStringDereference(p_elem_del))
+        return false;
     
     const char_t *t_sptr;
     const char_t *t_eptr;
@@ -5883,1474 +6953,3045 @@ bool MCStringFindAndReplace(MCStringRef self, MCStringRef p_pattern, MCStringRef
 	return true;
 }
 
-MC_DLLEXPORT_DEF
-bool MCStringWildcardMatch(MCStringRef source, MCRange source_range, MCStringRef pattern, MCStringOptions p_options)
-{
-	__MCAssertIsString(source);
-	__MCAssertIsString(pattern);
+////////////////////////////////////////////////////////////////////////////////
 
-    bool source_native = MCStringIsNative(source);
+// The automaton of a replacer is a trie of the units of its patterns, with a
+// failure link from each state to the state for the longest proper suffix of
+// its units which is also in the trie (Aho-Corasick). The units are either
+// native chars (folded if the options fold), or UTF-16 code units.
+struct __MCStringReplacerAutomaton
+{
+    uindex_t state_count;
     
-    const void *source_chars;
-    if (source_native)
-        source_chars = source -> native_chars + source_range . offset;
-    else
-        source_chars = source -> chars + source_range . offset;
-
-    return MCUnicodeWildcardMatch(source_chars, source_range . length, source_native, pattern -> chars, pattern -> char_count, MCStringIsNative(pattern), (MCUnicodeCompareOption)p_options);
+    // The children of state s are child_units/child_states[child_start[s] ..
+    // child_start[s + 1]), sorted by unit.
+    uindex_t *child_start;
+    uint16_t *child_units;
+    uindex_t *child_states;
+    
+    uindex_t *failure;
+    uindex_t *depth;
+    
+    // The longest pattern which ends at each state, either the state itself or
+    // one of its suffixes, or UINDEX_MAX if there is none.
+    uindex_t *match;
+    
+    // The transitions from each state on units below 256, if there are few
+    // enough states for the table to be small.
+    uindex_t *transitions;
+};
 
-}
+// Automata with more states than this step through the trie for every unit,
+// rather than using a transition table.
+static const uindex_t kMCStringReplacerMaxTableStates = 4096;
 
-////////////////////////////////////////////////////////////////////////////////
+struct __MCStringReplacer
+{
+    MCStringOptions options;
+    
+    uindex_t count;
+    MCStringRef *patterns;
+    MCStringRef *replacements;
+    
+    // True if every replacement is native, or could be.
+    bool native_replacements;
+    bool replacements_can_be_native;
+    
+    // The automaton used for native strings. It is not built if a non-native
+    // pattern could match native chars after normalization.
+    bool has_native;
+    __MCStringReplacerAutomaton native;
+    
+    // The automaton used for unicode strings, which is only built for exact
+    // comparison. Otherwise, unicode strings are searched pattern by pattern.
+    bool has_unicode;
+    __MCStringReplacerAutomaton unicode;
+};
 
-void __MCStringDestroy(__MCString *self)
+static void __MCStringReplacerAutomatonDestroy(__MCStringReplacerAutomaton& x_automaton)
 {
-    if (__MCStringIsIndirect(self))
-    {
-        MCValueRelease(self -> string);
-    }
-    else
-    {
-        if (__MCStringIsNative(self))
-            MCMemoryDeleteArray(self -> native_chars);
-        else
-            MCMemoryDeleteArray(self -> chars);
-    }
+    MCMemoryDeleteArray(x_automaton . child_start);
+    MCMemoryDeleteArray(x_automaton . child_units);
+    MCMemoryDeleteArray(x_automaton . child_states);
+    MCMemoryDeleteArray(x_automaton . failure);
+    MCMemoryDeleteArray(x_automaton . depth);
+    MCMemoryDeleteArray(x_automaton . match);
+    MCMemoryDeleteArray(x_automaton . transitions);
 }
 
-bool __MCStringCopyDescription(__MCString *self, MCStringRef& r_desc)
+// Returns the state reached from the given state on the given unit.
+static inline uindex_t __MCStringReplacerAutomatonStep(const __MCStringReplacerAutomaton& p_automaton, uindex_t p_state, uint16_t p_unit)
 {
-	return MCStringFormat(r_desc, "\"%@\"", self);
+    if (p_automaton . transitions != nil && p_unit < 256)
+        return p_automaton . transitions[p_state * 256 + p_unit];
+    
+    for(;;)
+    {
+        uindex_t t_low, t_high;
+        t_low = p_automaton . child_start[p_state];
+        t_high = p_automaton . child_start[p_state + 1];
+        while(t_low < t_high)
+        {
+            uindex_t t_mid;
+            t_mid = t_low + (t_high - t_low) / 2;
+            if (p_automaton . child_units[t_mid] < p_unit)
+                t_low = t_mid + 1;
+            else
+                t_high = t_mid;
+        }
+        
+        if (t_low < p_automaton . child_start[p_state + 1] &&
+            p_automaton . child_units[t_low] == p_unit)
+            return p_automaton . child_states[t_low];
+        
+        if (p_state == 0)
+            return 0;
+        
+        p_state = p_automaton . failure[p_state];
+    }
 }
 
-hash_t __MCStringHash(__MCString *self)
+// Builds the automaton for the given unit sequences. Sequences which are
+// empty (or nil) are not included, and where two are the same the first is
+// used.
+static bool __MCStringReplacerAutomatonCreate(uint16_t **p_units, const uindex_t *p_lengths, uindex_t p_count, __MCStringReplacerAutomaton& r_automaton)
 {
-	return MCStringHash(self, kMCStringOptionCompareExact);
+    uindex_t t_max_states;
+    t_max_states = 1;
+    for(uindex_t i = 0; i < p_count; i++)
+        t_max_states += p_lengths[i];
+    
+    // First build the trie with each state's children in a linked list.
+    MCAutoArray<uindex_t> t_first_child, t_next_sibling, t_terminal, t_order;
+    MCAutoArray<uint16_t> t_unit;
+    if (!t_first_child . New(t_max_states) ||
+        !t_next_sibling . New(t_max_states) ||
+        !t_terminal . New(t_max_states) ||
+        !t_order . New(t_max_states) ||
+        !t_unit . New(t_max_states))
+        return false;
+    
+    uindex_t t_state_count;
+    t_state_count = 1;
+    t_first_child[0] = UINDEX_MAX;
+    t_terminal[0] = UINDEX_MAX;
+    for(uindex_t i = 0; i < p_count; i++)
+    {
+        if (p_lengths[i] == 0)
+            continue;
+        
+        uindex_t t_state;
+        t_state = 0;
+        for(uindex_t j = 0; j < p_lengths[i]; j++)
+        {
+            uindex_t t_child;
+            for(t_child = t_first_child[t_state]; t_child != UINDEX_MAX; t_child = t_next_sibling[t_child])
+                if (t_unit[t_child] == p_units[i][j])
+                    break;
+            
+            if (t_child == UINDEX_MAX)
+            {
+                t_child = t_state_count++;
+                t_unit[t_child] = p_units[i][j];
+                t_first_child[t_child] = UINDEX_MAX;
+                t_terminal[t_child] = UINDEX_MAX;
+                t_next_sibling[t_child] = t_first_child[t_state];
+                t_first_child[t_state] = t_child;
+            }
+            
+            t_state = t_child;
+        }
+        
+        if (t_terminal[t_state] == UINDEX_MAX)
+            t_terminal[t_state] = i;
+    }
+    
+    __MCStringReplacerAutomaton t_automaton;
+    MCMemoryClear(t_automaton);
+    t_automaton . state_count = t_state_count;
+    if (!MCMemoryNewArray(t_state_count + 1, t_automaton . child_start) ||
+        !MCMemoryNewArray(t_state_count, t_automaton . child_units) ||
+        !MCMemoryNewArray(t_state_count, t_automaton . child_states) ||
+        !MCMemoryNewArray(t_state_count, t_automaton . failure) ||
+        !MCMemoryNewArray(t_state_count, t_automaton . depth) ||
+        !MCMemoryNewArray(t_state_count, t_automaton . match) ||
+        (t_state_count <= kMCStringReplacerMaxTableStates &&
+         !MCMemoryNewArray(t_state_count * 256, t_automaton . transitions)))
+    {
+        __MCStringReplacerAutomatonDestroy(t_automaton);
+        return false;
+    }
+    
+    // Now number the states in breadth first order, with the children of each
+    // state sorted by unit (there are usually very few). The children of the
+    // states then form a single sequence, in which state s (never the root)
+    // is at index s - 1.
+    uindex_t t_order_count;
+    t_order_count = 1;
+    t_order[0] = 0;
+    for(uindex_t i = 0; i < t_state_count; i++)
+    {
+        uindex_t t_first;
+        t_first = t_order_count;
+        for(uindex_t t_child = t_first_child[t_order[i]]; t_child != UINDEX_MAX; t_child = t_next_sibling[t_child])
+            t_order[t_order_count++] = t_child;
+        
+        for(uindex_t j = t_first + 1; j < t_order_count; j++)
+            for(uindex_t k = j; k > t_first && t_unit[t_order[k - 1]] > t_unit[t_order[k]]; k--)
+                std::swap(t_order[k - 1], t_order[k]);
+        
+        t_automaton . child_start[i] = t_first - 1;
+    }
+    t_automaton . child_start[t_state_count] = t_state_count - 1;
+    
+    for(uindex_t i = 1; i < t_state_count; i++)
+    {
+        t_automaton . child_units[i - 1] = t_unit[t_order[i]];
+        t_automaton . child_states[i - 1] = i;
+        t_automaton . match[i] = t_terminal[t_order[i]];
+    }
+    
+    // Compute the failure link, depth and match of each state's children, and
+    // its transitions. In breadth first order, the failure state of a state
+    // has always been completed before it.
+    t_automaton . failure[0] = 0;
+    t_automaton . depth[0] = 0;
+    t_automaton . match[0] = UINDEX_MAX;
+    for(uindex_t i = 0; i < t_state_count; i++)
+    {
+        if (t_automaton . transitions != nil)
+        {
+            uindex_t *t_row;
+            t_row = t_automaton . transitions + i * 256;
+            if (i != 0)
+                MCMemoryCopy(t_row, t_automaton . transitions + t_automaton . failure[i] * 256, 256 * sizeof(uindex_t));
+            for(uindex_t j = t_automaton . child_start[i]; j < t_automaton . child_start[i + 1]; j++)
+                if (t_automaton . child_units[j] < 256)
+                    t_row[t_automaton . child_units[j]] = t_automaton . child_states[j];
+        }
+        
+        for(uindex_t j = t_automaton . child_start[i]; j < t_automaton . child_start[i + 1]; j++)
+        {
+            uindex_t t_child;
+            t_child = t_automaton . child_states[j];
+            
+            uindex_t t_failure;
+            if (i == 0)
+                t_failure = 0;
+            else
+                t_failure = __MCStringReplacerAutomatonStep(t_automaton, t_automaton . failure[i], t_automaton . child_units[j]);
+            
+            t_automaton . failure[t_child] = t_failure;
+            t_automaton . depth[t_child] = t_automaton . depth[i] + 1;
+            if (t_automaton . match[t_child] == UINDEX_MAX)
+                t_automaton . match[t_child] = t_automaton . match[t_failure];
+        }
+    }
+    
+    r_automaton = t_automaton;
+    return true;
 }
 
-bool __MCStringIsEqualTo(__MCString *self, __MCString *p_other_self)
+// The output of a replacement, built up in a buffer which is then given to the
+// string.
+template<typename CharType>
+struct __MCStringReplacerOutput
 {
-	return MCStringIsEqualTo(self, p_other_self, kMCStringOptionCompareExact);
-}
+    CharType *chars = nil;
+    uindex_t length = 0;
+    uindex_t capacity = 0;
+    
+    ~__MCStringReplacerOutput(void)
+    {
+        MCMemoryDeallocate(chars);
+    }
+    
+    // Ensures there is room for the given number of chars, and a NUL.
+    bool Reserve(uindex_t p_count)
+    {
+        if (length + p_count + 1 <= capacity)
+            return true;
+        
+        uindex_t t_capacity;
+        t_capacity = capacity != 0 ? capacity : 4096;
+        while(length + p_count + 1 > t_capacity)
+            t_capacity *= 2;
+        
+        if (!MCMemoryReallocate(chars, t_capacity * sizeof(CharType), chars))
+            return false;
+        capacity = t_capacity;
+        return true;
+    }
+    
+    bool Append(const CharType *p_chars, uindex_t p_count)
+    {
+        if (!Reserve(p_count))
+            return false;
+        MCMemoryCopy(chars + length, p_chars, p_count * sizeof(CharType));
+        length += p_count;
+        return true;
+    }
+    
+    bool AppendString(MCStringRef p_string);
+};
 
-bool __MCStringImmutableCopy(__MCString* self, bool p_release, __MCString*& r_immutable_value)
+template<>
+bool __MCStringReplacerOutput<char_t>::AppendString(MCStringRef p_string)
 {
-	if (!p_release)
-		return MCStringCopy(self, r_immutable_value);
-
-	return MCStringCopyAndRelease(self, r_immutable_value);
+    return Append(MCStringGetNativeCharPtr(p_string), MCStringGetLength(p_string));
 }
 
-////////////////////////////////////////////////////////////////////////////////
-
-static void __MCStringClampRange(MCStringRef self, MCRange& x_range)
+template<>
+bool __MCStringReplacerOutput<unichar_t>::AppendString(MCStringRef p_string)
 {
-	uindex_t t_left, t_right;
-	t_left = MCMin(x_range . offset, self -> char_count);
-	t_right = MCMin(x_range . offset + MCMin(x_range . length, UINDEX_MAX - x_range . offset), self -> char_count);
-	x_range . offset = t_left;
-	x_range . length = t_right - t_left;
+    if (!MCStringIsNative(p_string))
+        return Append(MCStringGetCharPtr(p_string), MCStringGetLength(p_string));
+    
+    if (!Reserve(MCStringGetLength(p_string)))
+        return false;
+    MCUnicodeCharsMapFromNative(MCStringGetNativeCharPtr(p_string), MCStringGetLength(p_string), chars + length);
+    length += MCStringGetLength(p_string);
+    return true;
 }
 
-/*static uindex_t *__MCStringGetCapacityPtr(MCStringRef self)
-{
-	// In mutable strings, the capacity is stored after the chars at the
-	// first aligned location.
-	uindex_t *t_capacity_ptr;
-	t_capacity_ptr = (uindex_t *)(self -> chars + ((self -> char_count + sizeof(uindex_t) - 1) & ~(sizeof(uindex_t) - 1)));
-	return t_capacity_ptr;
-}*/
-
-static uindex_t __MCStringGetCapacity(MCStringRef self)
+// Finds the leftmost matches of the automaton's patterns in the units, taking
+// the longest of those which start at the same place, and passes each to
+// 'emit' in order.
+template<typename UnitFunc, typename EmitFunc>
+static bool __MCStringReplacerScan(MCStringReplacerRef self, const __MCStringReplacerAutomaton& p_automaton, uindex_t p_unit_count, UnitFunc p_unit, EmitFunc p_emit)
 {
-	return self -> capacity;
-
-	/*if (self -> chars != nil)
-		return *(__MCStringGetCapacityPtr(self));
-
-	// An uninitialized string (or one that has had its buffer deleted) will
-	// have no chars ptr, so just return 0.
-	return 0;*/
+    uindex_t t_state;
+    t_state = 0;
+    
+    bool t_has_match;
+    uindex_t t_match_start, t_match_length, t_match_pattern;
+    t_has_match = false;
+    t_match_start = t_match_length = t_match_pattern = 0;
+    
+    uindex_t t_index;
+    t_index = 0;
+    for(;;)
+    {
+        // At the end of the units, any match is taken and the search
+        // continues after it.
+        if (t_index == p_unit_count)
+        {
+            if (!t_has_match)
+                break;
+            
+            if (!p_emit(t_match_start, t_match_length, t_match_pattern))
+                return false;
+            t_has_match = false;
+            t_index = t_match_start + t_match_length;
+            t_state = 0;
+            continue;
+        }
+        
+        t_state = __MCStringReplacerAutomatonStep(p_automaton, t_state, p_unit(t_index));
+        t_index++;
+        
+        // The longest pattern ending here is the one which starts first.
+        uindex_t t_pattern;
+        t_pattern = p_automaton . match[t_state];
+        if (t_pattern != UINDEX_MAX)
+        {
+            uindex_t t_length, t_start;
+            t_length = MCStringGetLength(self -> patterns[t_pattern]);
+            t_start = t_index - t_length;
+            if (!t_has_match ||
+                t_start < t_match_start ||
+                (t_start == t_match_start && t_length > t_match_length))
+            {
+                t_has_match = true;
+                t_match_start = t_start;
+                t_match_length = t_length;
+                t_match_pattern = t_pattern;
+            }
+        }
+        
+        // Once the units the state represents start after the match, no
+        // match starting earlier (or longer) can be found, so it is taken and
+        // the search continues after it.
+        if (t_has_match && t_index - p_automaton . depth[t_state] > t_match_start)
+        {
+            if (!p_emit(t_match_start, t_match_length, t_match_pattern))
+                return false;
+            t_has_match = false;
+            t_index = t_match_start + t_match_length;
+            t_state = 0;
+        }
+    }
+    
+    return true;
 }
 
-static bool __MCStringExpandAt(MCStringRef self, uindex_t p_at, uindex_t p_count)
+// Finds the leftmost-longest matches of the patterns in the (unicode) string
+// by searching for each pattern in turn, for comparisons the automata can't
+// do.
+template<typename EmitFunc>
+static bool __MCStringReplacerSearch(MCStringReplacerRef self, MCStringRef p_string, EmitFunc p_emit)
 {
-    MCAssert(!__MCStringIsIndirect(self));
+    // The next occurrence of each pattern at or after the offset it was
+    // searched from, which has length 0 if there isn't one.
+    MCAutoArray<MCRange> t_next;
+    if (!t_next . New(self -> count))
+        return false;
+    for(uindex_t i = 0; i < self -> count; i++)
+        t_next[i] = MCRangeMake(0, UINDEX_MAX);
     
-	// Fetch the capacity.
-	uindex_t t_capacity;
-	t_capacity = __MCStringGetCapacity(self);
-
-	/* Overflow check.  A string's length needs to fit into an
-	 * index_t, because sometimes negative indices are used.  Ensure that the
-	 * length of the expanded string (including a null byte) fits. */
-	if (INDEX_MAX == p_count || INDEX_MAX - p_count - 1 < self->char_count)
-	{
-		return MCErrorThrowOutOfMemory();
-	}
-
-	/* Overflow check.  A string's total storage size must fit into a
-	 * size_t.  The maximum capacity (i.e. number of chars) depends on whether it's a
-	 * Unicode (multibyte) or native (unibyte) string representation. */
-	size_t t_capacity_limit =
-		SIZE_MAX / (__MCStringIsNative(self) ? sizeof(char_t) : sizeof(unichar_t));
-	if (t_capacity_limit == p_count || t_capacity_limit - p_count - 1 < self->char_count)
-	{
-		return MCErrorThrowOutOfMemory();
-	}
-
-	// The capacity field stores the total number of chars that could fit not
-	// including the implicit NUL, so if we fit, we can fast-track.
-	if (t_capacity != 0 && self -> char_count + p_count <= t_capacity)
-	{
-		// Shift up the chars above - including the implicit NUL.
-        if (__MCStringIsNative(self))
-            MCMemoryMove(self -> native_chars + p_at + p_count, self -> native_chars + p_at, ((self -> char_count + 1) - p_at));
-        else
-            MCMemoryMove(self -> chars + p_at + p_count, self -> chars + p_at, ((self -> char_count + 1) - p_at) * sizeof(unichar_t));
-
-		// Increase the char_count.
-		self -> char_count += p_count;
-		
-		// Rewrite the capacity.
-		//*(__MCStringGetCapacityPtr(self)) = t_capacity;
-
-		// We succeeded.
-		return true;
-	}
-
-	// If we get here then we need to reallocate first.
-
-	// Base capacity - current length + inserted length + implicit NUL.
-	uindex_t t_new_capacity;
-	t_new_capacity = self -> char_count + p_count + 1;
-
-	// Capacity rounded up to nearest aligned boundary and then space for
-	// the capacity field.
-	//t_new_capacity = ((t_new_capacity + sizeof(uindex_t) - 1) & (~(sizeof(uindex_t) - 1))) + sizeof(uindex_t);
-
-	// Capacity rounded up to a suitable boundary (at some point this should
-	// be a function of the string's size).
-	t_new_capacity = (t_new_capacity + 63) & ~63;
-
-	// Reallocate and shift up the chars above - including the implicit NUL.
-    if (__MCStringIsNative(self))
+    uindex_t t_offset;
+    t_offset = 0;
+    while(t_offset < p_string -> char_count)
     {
-        if (!MCMemoryReallocate(self -> native_chars, t_new_capacity, self -> native_chars))
-            return false;
+        uindex_t t_best;
+        t_best = UINDEX_MAX;
+        for(uindex_t i = 0; i < self -> count; i++)
+        {
+            if (t_next[i] . length == 0)
+                continue;
+            
+            // UINDEX_MAX marks an occurrence which hasn't been searched for.
+            if (t_next[i] . length == UINDEX_MAX || t_next[i] . offset < t_offset)
+            {
+                if (MCStringIsEmpty(self -> patterns[i]) ||
+                    !MCStringFind(p_string, MCRangeMake(t_offset, p_string -> char_count - t_offset), self -> patterns[i], self -> options, &t_next[i]) ||
+                    t_next[i] . length == 0)
+                {
+                    t_next[i] = MCRangeMake(0, 0);
+                    continue;
+                }
+            }
+            
+            if (t_best == UINDEX_MAX ||
+                t_next[i] . offset < t_next[t_best] . offset ||
+                (t_next[i] . offset == t_next[t_best] . offset && t_next[i] . length > t_next[t_best] . length))
+                t_best = i;
+        }
         
-    	MCMemoryMove(self -> native_chars + p_at + p_count, self -> native_chars + p_at, ((self -> char_count + 1) - p_at));
-    }
-    else
-    {
-        if (!MCMemoryReallocate(self -> chars, t_new_capacity * sizeof(unichar_t), self -> chars))
+        if (t_best == UINDEX_MAX)
+            break;
+        
+        if (!p_emit(t_next[t_best] . offset, t_next[t_best] . length, t_best))
             return false;
         
-        MCMemoryMove(self -> chars + p_at + p_count, self -> chars + p_at, ((self -> char_count + 1) - p_at) * sizeof(unichar_t));
+        t_offset = t_next[t_best] . offset + t_next[t_best] . length;
     }
-
-	// Increase the char_count.
-	self -> char_count += p_count;
-
-	// Update the capacity - notice that we shave off the capacity field itself
-	// since it represents the char capacity rather than the size of the alloc'd
-	// block. We also shave off room for the implicit NUL.
-	self -> capacity = t_new_capacity - 1;
-	//*(__MCStringGetCapacityPtr(self)) = t_new_capacity - 1 - sizeof(uindex_t);
-
-	// We succeeded.
-	return true;
-}
-
-static void __MCStringShrinkAt(MCStringRef self, uindex_t p_at, uindex_t p_count)
-{
-    MCAssert(!__MCStringIsIndirect(self));
     
-	// Shift the chars above 'at' down to remove 'count', remembering to include
-	// the implicit NUL.
-    if (__MCStringIsNative(self))
-        MCMemoryMove(self -> native_chars + p_at, self -> native_chars + (p_at + p_count), (self -> char_count - (p_at + p_count) + 1));
-    else
-        MCMemoryMove(self -> chars + p_at, self -> chars + (p_at + p_count), (self -> char_count - (p_at + p_count) + 1) * sizeof(strchar_t));
-
-	// Now adjust the length of the string.
-	self -> char_count -= p_count;
-
-	// TODO: Shrink the buffer if its too big.
-}
-
-static bool
-__MCStringNativize(MCStringRef self)
-{
-	uindex_t t_char_count;
-	return __MCStringNativize(self, t_char_count);
+    return true;
 }
 
-static bool __MCStringNativize(MCStringRef self, uindex_t & r_char_count)
+MC_DLLEXPORT_DEF
+bool MCStringReplacerCreate(const MCStringRef *p_patterns, const MCStringRef *p_replacements, uindex_t p_count, MCStringOptions p_options, MCStringReplacerRef& r_replacer)
 {
-    if (MCStringIsNative(self))
-	{
-		r_char_count = self -> char_count;
-		return true;
-	}
+    MCStringReplacerRef self;
+    if (!MCMemoryNew(self))
+        return false;
     
-	if (__MCStringIsIndirect(self) &&
-	    !__MCStringResolveIndirect(self))
-	{
-		return false;
-	}
+    self -> options = p_options;
+    self -> native_replacements = true;
+    self -> replacements_can_be_native = true;
+    self -> has_native = true;
+    self -> has_unicode = p_options == kMCStringOptionCompareExact;
     
-    bool t_not_native;
-    t_not_native = false;
+    // The units of each pattern for the automata being built, which are nil
+    // if the pattern can't match.
+    MCAutoArray<uint16_t *> t_native_units, t_unicode_units;
+    MCAutoArray<uindex_t> t_native_lengths, t_unicode_lengths;
     
-	MCAutoArray<char_t> chars;
-	if (!chars.New(self -> char_count + 1))
-	{
-		return false;
-	}
+    bool t_success;
+    t_success = MCMemoryNewArray(p_count, self -> patterns) &&
+                MCMemoryNewArray(p_count, self -> replacements) &&
+                t_native_units . New(p_count) &&
+                t_unicode_units . New(p_count) &&
+                t_native_lengths . New(p_count) &&
+                t_unicode_lengths . New(p_count);
     
-    for(uindex_t i = 0; i < self -> char_count; i++)
-        if (!MCUnicodeCharMapToNative(self -> chars[i], chars[i]))
-        {
-            t_not_native = true;
-            break;
-        }
-    
-    if (!t_not_native)
-    {
-		uindex_t t_ignored;
-        MCMemoryDeleteArray(self -> chars);
-		chars.Take(self -> native_chars, t_ignored);
-        __MCStringChanged(self, true, true, true);
-        self -> flags &= ~kMCStringFlagIsNotNative;
-        self -> native_chars[self -> char_count] = '\0';
-		r_char_count = self -> char_count;
-		return true;
-    }
-    
-    // The string needs to be normalised before conversion to native characters.
-    // All the native character sets we support use pre-composed characters.
-    MCAutoStringRef t_norm;
-	if (!MCStringNormalizedCopyNFC(self, &t_norm))
-	{
-		return false;
-	}
-    
-    // Nativisation is done on a char (grapheme) basis so we need to know the
-    // number of graphemes in the string
-    MCRange t_cu_range, t_char_range;
-    t_cu_range = MCRangeMake(0, (*t_norm) -> char_count);
-	if (!MCStringUnmapIndices(*t_norm, kMCCharChunkTypeGrapheme,
-	                          t_cu_range, t_char_range))
-	{
-		return false;
-	}
+    if (t_success)
+        self -> count = p_count;
     
-    t_cu_range = MCRangeMake(0, (*t_norm) -> char_count);
-    // Go through the graphemes of the string
-    uindex_t t_current = 0, t_next;
-    for (uindex_t i = 0; i < t_char_range . length; i++)
+    for(uindex_t i = 0; t_success && i < p_count; i++)
     {
-        // If we've reached the end, set the next boundary manually
-        t_next = MCStringGraphemeBreakIteratorAdvance(self, t_current);
-        if (t_next == kMCLocaleBreakIteratorDone)
-            t_next = self -> char_count;
+        t_success = MCStringCopy(p_patterns[i], self -> patterns[i]) &&
+                    MCStringCopy(p_replacements[i], self -> replacements[i]);
+        if (!t_success)
+            break;
         
-        // All nativisable characters are 1 codeunit in length.
-        if (t_next != t_current + 1
-            || !MCUnicodeCharMapToNative((*t_norm) -> chars[t_current], chars[i]))
+        MCStringRef t_pattern, t_replacement;
+        t_pattern = self -> patterns[i];
+        t_replacement = self -> replacements[i];
+        if (!MCStringIsNative(t_replacement))
+            self -> native_replacements = false;
+        if (!MCStringCanBeNative(t_replacement))
+            self -> replacements_can_be_native = false;
+        
+        uindex_t t_length;
+        t_length = MCStringGetLength(t_pattern);
+        
+        // A non-native pattern is only included in the native automaton if
+        // it has the same chars as a native string; if it could match native
+        // chars only after normalization, the native automaton can't be used.
+        if (self -> has_native &&
+            (MCStringIsNative(t_pattern) || !MCStringCantBeEqualToNative(t_pattern, p_options)))
         {
-            chars[i] = '?';
+            if (MCStringIsNative(t_pattern) || MCStringCanBeNative(t_pattern))
+            {
+                char_t *t_chars;
+                t_success = MCMemoryNewArray(t_length, t_chars);
+                if (t_success)
+                {
+                    MCStringGetNativeChars(t_pattern, MCRangeMake(0, t_length), t_chars);
+                    t_success = MCMemoryNewArray(t_length, t_native_units[i]);
+                }
+                if (t_success)
+                {
+                    for(uindex_t j = 0; j < t_length; j++)
+                        t_native_units[i][j] = (p_options & kMCStringOptionFoldBit) != 0 ? __MCNativeChar_Fold(t_chars[j]) : t_chars[j];
+                    t_native_lengths[i] = t_length;
+                }
+                MCMemoryDeleteArray(t_chars);
+            }
+            else
+                self -> has_native = false;
         }
         
-        // Advance
-        t_current = t_next;
+        if (t_success && self -> has_unicode)
+        {
+            t_success = MCMemoryNewArray(t_length, t_unicode_units[i]);
+            if (t_success)
+            {
+                MCStringGetChars(t_pattern, MCRangeMake(0, t_length), reinterpret_cast<unichar_t *>(t_unicode_units[i]));
+                t_unicode_lengths[i] = t_length;
+            }
+        }
     }
     
-    uindex_t t_ignored;
-    MCMemoryDeleteArray(self -> chars);
-	chars.Take(self -> native_chars, t_ignored);
-	self -> native_chars[t_char_range.length] = '\0';
-    
-    __MCStringChanged(self, true, true, true);
-    self -> flags &= ~kMCStringFlagIsNotNative;
-    self -> char_count = t_char_range . length;
-
-	r_char_count = t_char_range . length;
-	return true;
-}
-
-static bool __MCStringUnnativize(MCStringRef self)
-{    
-    if (!MCStringIsNative(self))
-		return true;
-
-	if (__MCStringIsIndirect(self) &&
-	    !__MCStringResolveIndirect(self))
-	{
-		return false;
-	}
-    
-    uindex_t t_capacity = self -> capacity != 0 ? self -> capacity : self -> char_count;
-    uindex_t t_char_count = self -> char_count;
-
-    unichar_t *chars;
-    
-	if (!MCMemoryNewArray(t_capacity + 1, chars))
-	{
-		return false;
-	}
+    if (t_success && self -> has_native)
+        t_success = __MCStringReplacerAutomatonCreate(t_native_units . Ptr(), t_native_lengths . Ptr(), p_count, self -> native);
+    else
+        self -> has_native = false;
     
-	MCStrCharsMapFromNative(chars, self -> native_chars, t_char_count);
-	MCMemoryDeleteArray(self -> native_chars);
-	self -> chars = chars;
-	self -> char_count = t_char_count;
-	// Set the NUL char.
-	self -> chars[t_char_count] = '\0';
-
-    __MCStringChanged(self, true, true, true);
-    self -> flags |= kMCStringFlagIsNotNative;
-
-	return true;
-}
-
-static void __MCStringSetFlags(MCStringRef self, uindex_t basic, uindex_t trivial, uindex_t native)
-{
-    MCAssert(!__MCStringIsIndirect(self));
+    if (t_success && self -> has_unicode)
+        t_success = __MCStringReplacerAutomatonCreate(t_unicode_units . Ptr(), t_unicode_lengths . Ptr(), p_count, self -> unicode);
+    else
+        self -> has_unicode = false;
     
-    if (native == kMCStringFlagSetTrue)
-    {
-        self -> flags |= kMCStringFlagCanBeNative;
-        self -> flags |= kMCStringFlagIsTrivial;
-        self -> flags |= kMCStringFlagIsBasic;
-        return;
-    }
-    else if (native == kMCStringFlagSetFalse)
+    for(uindex_t i = 0; i < t_native_units . Size(); i++)
     {
-        self -> flags &= ~kMCStringFlagCanBeNative;
+        MCMemoryDeleteArray(t_native_units[i]);
+        MCMemoryDeleteArray(t_unicode_units[i]);
     }
     
-    if (trivial == kMCStringFlagSetTrue)
-    {
-        self -> flags |= kMCStringFlagIsTrivial;
-        self -> flags |= kMCStringFlagIsBasic;
-        return;
-    }
-    else if (trivial == kMCStringFlagSetFalse)
-    {
-        self -> flags &= ~kMCStringFlagIsTrivial;
-        self -> flags &= ~kMCStringFlagCanBeNative;
-    }
-
-    if (basic == kMCStringFlagSetTrue)
-    {
-        self -> flags |=  kMCStringFlagIsBasic;
-    }
-    else if (basic == kMCStringFlagSetFalse)
+    if (!t_success)
     {
-        self -> flags &= ~kMCStringFlagIsBasic;
-        self -> flags &= ~kMCStringFlagIsTrivial;
-        self -> flags &= ~kMCStringFlagCanBeNative;
+        MCStringReplacerDestroy(self);
+        return false;
     }
-}
-
-static void __MCStringChanged(MCStringRef self, uindex_t basic, uindex_t trivial, uindex_t native)
-{
-    MCAssert(!__MCStringIsIndirect(self));
-
-    self -> flags &= ~kMCStringFlagIsChecked;
-    self -> flags &= ~kMCStringFlagHasNumber;
     
-    __MCStringSetFlags(self, basic, trivial, native);
-}
-
-MC_DLLEXPORT_DEF
-codepoint_t MCStringSurrogatesToCodepoint(unichar_t p_lead, unichar_t p_trail)
-{
-    return 0x10000 + ((p_lead & 0x3FF) << 10) + (p_trail & 0x3FF);
+    r_replacer = self;
+    return true;
 }
 
 MC_DLLEXPORT_DEF
-unsigned int MCStringCodepointToSurrogates(codepoint_t p_codepoint, unichar_t (&r_units)[2])
+void MCStringReplacerDestroy(MCStringReplacerRef self)
 {
-    if (p_codepoint > UNICHAR_MAX)
-    {
-        p_codepoint -= 0x10000;
-        r_units[0] = 0xD800 + (p_codepoint >> 10);
-        r_units[1] = 0xDC00 + (p_codepoint & 0x3FF);
-        return 2;
-    }
-    else
+    if (self == nil)
+        return;
+    
+    for(uindex_t i = 0; i < self -> count; i++)
     {
-        r_units[0] = p_codepoint;
-        return 1;
+        MCValueRelease(self -> patterns[i]);
+        MCValueRelease(self -> replacements[i]);
     }
+    MCMemoryDeleteArray(self -> patterns);
+    MCMemoryDeleteArray(self -> replacements);
+    
+    if (self -> has_native)
+        __MCStringReplacerAutomatonDestroy(self -> native);
+    if (self -> has_unicode)
+        __MCStringReplacerAutomatonDestroy(self -> unicode);
+    
+    MCMemoryDelete(self);
 }
 
 MC_DLLEXPORT_DEF
-bool MCStringIsValidSurrogatePair(MCStringRef self, uindex_t p_index)
+bool MCStringReplacerApply(MCStringReplacerRef self, MCStringRef x_string)
 {
-	__MCAssertIsString(self);
-
-    if (__MCStringIsIndirect(self))
-        self = self -> string;
+	__MCAssertIsMutableString(x_string);
     
-    if (__MCStringIsNative(self))
-        return false;
+    // Ensure the string is not indirect.
+    if (__MCStringIsIndirect(x_string))
+        if (!__MCStringResolveIndirect(x_string))
+            return false;
     
-    // Check that the string is long enough
-    // (Double-checking here is due to possible unsigned wrapping)
-    if (p_index >= self -> char_count || (p_index + 1) >= self -> char_count)
-        return false;
+    if (x_string -> char_count == 0 || self -> count == 0)
+        return true;
     
-    // Check for a valid leading surrogate
-    unichar_t t_char;
-    t_char = self -> chars[p_index];
-    if (t_char < 0xD800 || t_char > 0xDBFF)
-        return false;
+    if (__MCStringIsNative(x_string) && self -> has_native && self -> native_replacements)
+    {
+        const char_t *t_chars;
+        t_chars = x_string -> native_chars;
+        
+        __MCStringReplacerOutput<char_t> t_output;
+        uindex_t t_copied;
+        t_copied = 0;
+        auto t_emit = [&](uindex_t p_start, uindex_t p_length, uindex_t p_pattern) {
+            if (!t_output . Append(t_chars + t_copied, p_start - t_copied) ||
+                !t_output . AppendString(self -> replacements[p_pattern]))
+                return false;
+            t_copied = p_start + p_length;
+            return true;
+        };
+        
+        bool t_success;
+        if ((self -> options & kMCStringOptionFoldBit) != 0)
+            t_success = __MCStringReplacerScan(self, self -> native, x_string -> char_count, [&](uindex_t i) { return uint16_t(__MCNativeChar_Fold(t_chars[i])); }, t_emit);
+        else
+            t_success = __MCStringReplacerScan(self, self -> native, x_string -> char_count, [&](uindex_t i) { return uint16_t(t_chars[i]); }, t_emit);
+        
+        if (!t_success ||
+            !t_output . Append(t_chars + t_copied, x_string -> char_count - t_copied))
+            return false;
+        
+        // Add the implicit NUL
+        t_output . chars[t_output . length] = '\0';
+        
+        MCMemoryDeleteArray(x_string -> native_chars);
+        x_string -> native_chars = t_output . chars;
+        x_string -> char_count = t_output . length;
+        x_string -> capacity = t_output . capacity;
+        t_output . chars = nil;
+        
+        __MCStringChanged(x_string, kMCStringFlagSetTrue, kMCStringFlagSetTrue, kMCStringFlagSetTrue);
+        return true;
+    }
     
-    // Check for a valid trailFing surrogate
-    t_char = self -> chars[p_index + 1];
-    if (t_char < 0xDC00 || t_char > 0xDFFF)
+    if (!__MCStringUnnativize(x_string))
         return false;
     
-    // All the checks passed
-    return true;
-}
-
-MC_DLLEXPORT_DEF
-bool MCStringIsGraphemeClusterBoundary(MCStringRef self, uindex_t p_index)
-{
-    __MCAssertIsString(self);
-    
-    if (__MCStringIsIndirect(self))
-        self = self -> string;
+    const unichar_t *t_chars;
+    t_chars = x_string -> chars;
     
-    if (__MCStringIsTrivial(self))
+    __MCStringReplacerOutput<unichar_t> t_output;
+    uindex_t t_copied;
+    t_copied = 0;
+    auto t_emit = [&](uindex_t p_start, uindex_t p_length, uindex_t p_pattern) {
+        if (!t_output . Append(t_chars + t_copied, p_start - t_copied) ||
+            !t_output . AppendString(self -> replacements[p_pattern]))
+            return false;
+        t_copied = p_start + p_length;
         return true;
+    };
     
-    if (p_index == 0 || p_index >= self -> char_count)
-        return true;
+    bool t_success;
+    if (self -> has_unicode)
+        t_success = __MCStringReplacerScan(self, self -> unicode, x_string -> char_count, [&](uindex_t i) { return uint16_t(t_chars[i]); }, t_emit);
+    else
+        t_success = __MCStringReplacerSearch(self, x_string, t_emit);
     
-    // There is not a cluster boundary between the lead and trail of a surrogate
-    if (MCStringIsValidSurrogatePair(self, p_index - 1))
+    if (!t_success ||
+        !t_output . Append(t_chars + t_copied, x_string -> char_count - t_copied))
         return false;
-        
     
-    // Resolve the codepoints either side of the index
-    codepoint_t t_left_codepoint, t_right_codepoint;
+    // Add the implicit NUL
+    t_output . chars[t_output . length] = '\0';
     
-    uindex_t t_dummy;
-    t_dummy = p_index;
-    if (!__MCStringFetchCodepointBefore(self, t_dummy, t_left_codepoint))
-        return true;
+    bool t_can_be_native;
+    t_can_be_native = __MCStringCanBeNative(x_string) && self -> replacements_can_be_native;
     
-    t_dummy = p_index;
-    if (!__MCStringFetchCodepointAfter(self, t_dummy, t_right_codepoint))
-        return true;
+    MCMemoryDeleteArray(x_string -> chars);
+    x_string -> chars = t_output . chars;
+    x_string -> char_count = t_output . length;
+    x_string -> capacity = t_output . capacity;
+    t_output . chars = nil;
     
-    return MCUnicodeIsGraphemeClusterBoundary(t_left_codepoint, t_right_codepoint);
+    __MCStringChanged(x_string, false, false, t_can_be_native);
+    return true;
 }
 
-////////////////////////////////////////////////////////////////////////////////
-
-#if defined(__LINUX__)
-static const iconv_t k_invalid_iconv_fd = reinterpret_cast<iconv_t>(-1);
-
-static bool is_valid_iconv_fd(iconv_t p_fd)
+MC_DLLEXPORT_DEF
+bool MCStringFindAndReplaceMultiple(MCStringRef self, const MCStringRef *p_patterns, const MCStringRef *p_replacements, uindex_t p_count, MCStringOptions p_options)
 {
-    return p_fd != k_invalid_iconv_fd;
+    MCStringReplacerRef t_replacer;
+    if (!MCStringReplacerCreate(p_patterns, p_replacements, p_count, p_options, t_replacer))
+        return false;
+    
+    bool t_success;
+    t_success = MCStringReplacerApply(t_replacer, self);
+    MCStringReplacerDestroy(t_replacer);
+    return t_success;
 }
 
-static iconv_t s_iconv_unicode_from_sys_fd = k_invalid_iconv_fd;
-static iconv_t s_iconv_unicode_to_sys_fd   = k_invalid_iconv_fd;
-static iconv_t s_iconv_native_to_sys_fd    = k_invalid_iconv_fd;
+////////////////////////////////////////////////////////////////////////////////
 
-static bool
-__MCStringInitializeIconv()
+MC_DLLEXPORT_DEF
+bool MCStringWildcardMatch(MCStringRef source, MCRange source_range, MCStringRef pattern, MCStringOptions p_options)
 {
-    const char *k_internal_iconv_charset =
-        (kMCByteOrderHost == kMCByteOrderLittleEndian ? "UTF-16LE" : "UTF-16BE");
+	__MCAssertIsString(source);
+	__MCAssertIsString(pattern);
 
-    // What is the system character encoding?
-    //
-    // Doing this here is unpleasant but the MCString*SysString functions are
-    // needed before the libfoundation initialise call completes
-    if (__MCSysCharset == nil)
+    bool source_native = MCStringIsNative(source);
+    
+    const void *source_chars;
+    if (source_native)
+        source_chars = source -> native_chars + source_range . offset;
+    else
+        source_chars = source -> chars + source_range . offset;
+
+    return MCUnicodeWildcardMatch(source_chars, source_range . length, source_native, pattern -> chars, pattern -> char_count, MCStringIsNative(pattern), (MCUnicodeCompareOption)p_options);
+
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void __MCStringDestroy(__MCString *self)
+{
+    if ((self -> flags & kMCStringFlagHasDelimiterIndex) != 0)
+        __MCStringDiscardDelimiterIndices(self);
+    if ((self -> flags & kMCStringFlagHasBreakIndex) != 0)
+        __MCStringDiscardBreakIndices(self);
+    
+    if (__MCStringIsRope(self))
     {
-        setlocale(LC_CTYPE, "");
-        __MCSysCharset = nl_langinfo(CODESET);
+        __MCStringDestroyRope(self);
+    }
+    else if (__MCStringIsIndirect(self))
+    {
+        MCValueRelease(self -> string);
+    }
+    else
+    {
+        __MCStringDeleteChars(self);
     }
+}
 
-    s_iconv_unicode_from_sys_fd = iconv_open(k_internal_iconv_charset, __MCSysCharset);
-    if (!is_valid_iconv_fd(s_iconv_unicode_from_sys_fd))
-        return false;
-    s_iconv_unicode_to_sys_fd = iconv_open(__MCSysCharset, k_internal_iconv_charset);
-    if (!is_valid_iconv_fd(s_iconv_unicode_to_sys_fd))
-        return false;
-    s_iconv_native_to_sys_fd = iconv_open(__MCSysCharset, "ISO-8859-1");
-    if (!is_valid_iconv_fd(s_iconv_native_to_sys_fd))
-        return false;
+bool __MCStringCopyDescription(__MCString *self, MCStringRef& r_desc)
+{
+	return MCStringFormat(r_desc, "\"%@\"", self);
+}
 
-    return true;
+hash_t __MCStringHash(__MCString *self)
+{
+	return MCStringHash(self, kMCStringOptionCompareExact);
 }
 
-static void
-__MCStringFinalizeIconv()
+bool __MCStringIsEqualTo(__MCString *self, __MCString *p_other_self)
 {
-    auto t_iconv_cleanup = [](iconv_t& p_fd) {
-        if (is_valid_iconv_fd(p_fd))
-        {
-            iconv_close(p_fd);
-            p_fd = k_invalid_iconv_fd;
-        }
-    };
+	return MCStringIsEqualTo(self, p_other_self, kMCStringOptionCompareExact);
+}
 
-    t_iconv_cleanup(s_iconv_unicode_from_sys_fd);
-    t_iconv_cleanup(s_iconv_unicode_to_sys_fd);
-    t_iconv_cleanup(s_iconv_native_to_sys_fd);
+bool __MCStringImmutableCopy(__MCString* self, bool p_release, __MCString*& r_immutable_value)
+{
+	if (!p_release)
+		return MCStringCopy(self, r_immutable_value);
+
+	return MCStringCopyAndRelease(self, r_immutable_value);
 }
 
-#endif /* __LINUX__ */
+////////////////////////////////////////////////////////////////////////////////
 
-MC_DLLEXPORT_DEF MCStringRef kMCEmptyString;
-MC_DLLEXPORT_DEF MCStringRef kMCTrueString;
-MC_DLLEXPORT_DEF MCStringRef kMCFalseString;
-MC_DLLEXPORT_DEF MCStringRef kMCMixedString;
-MC_DLLEXPORT_DEF MCStringRef kMCCommaString;
-MC_DLLEXPORT_DEF MCStringRef kMCLineEndString;
-MC_DLLEXPORT_DEF MCStringRef kMCTabString;
-MC_DLLEXPORT_DEF MCStringRef kMCNulString;
+static void __MCStringClampRange(MCStringRef self, MCRange& x_range)
+{
+	uindex_t t_left, t_right;
+	t_left = MCMin(x_range . offset, self -> char_count);
+	t_right = MCMin(x_range . offset + MCMin(x_range . length, UINDEX_MAX - x_range . offset), self -> char_count);
+	x_range . offset = t_left;
+	x_range . length = t_right - t_left;
+}
 
-bool __MCStringInitialize(void)
+/*static uindex_t *__MCStringGetCapacityPtr(MCStringRef self)
 {
-#if defined(__LINUX__)
-    if (!__MCStringInitializeIconv())
-        return false;
-#endif
+	// In mutable strings, the capacity is stored after the chars at the
+	// first aligned location.
+	uindex_t *t_capacity_ptr;
+	t_capacity_ptr = (uindex_t *)(self -> chars + ((self -> char_count + sizeof(uindex_t) - 1) & ~(sizeof(uindex_t) - 1)));
+	return t_capacity_ptr;
+}*/
 
-	if (!MCStringCreateWithNativeChars((const char_t *)"", 0, kMCEmptyString))
-		return false;
-    
-	if (!MCStringCreateWithNativeChars((const char_t *)"true", 4, kMCTrueString))
-		return false;
+static uindex_t __MCStringGetCapacity(MCStringRef self)
+{
+	return self -> capacity;
 
-	if (!MCStringCreateWithNativeChars((const char_t *)"false", 5, kMCFalseString))
-		return false;
-    
-    if (!MCStringCreateWithNativeChars((const char_t *)"mixed", 5, kMCMixedString))
-		return false;
-    
-    if (!MCStringCreateWithNativeChars((const char_t *)",", 1, kMCCommaString))
-		return false;
-    
-	if (!MCStringCreateWithNativeChars((const char_t *)"\n", 1, kMCLineEndString))
-		return false;
-    
-    if (!MCStringCreateWithNativeChars((const char_t *)"\t", 1, kMCTabString))
-		return false;
-        
-    if (!MCStringCreateWithNativeChars((const char_t *)"\0", 1, kMCNulString))
-		return false;
+	/*if (self -> chars != nil)
+		return *(__MCStringGetCapacityPtr(self));
 
-	return true;
+	// An uninitialized string (or one that has had its buffer deleted) will
+	// have no chars ptr, so just return 0.
+	return 0;*/
 }
 
-void __MCStringFinalize(void)
+static bool __MCStringExpandAt(MCStringRef self, uindex_t p_at, uindex_t p_count)
 {
-	MCValueRelease(kMCFalseString);
-	kMCFalseString = nil;
-	MCValueRelease(kMCTrueString);
-	kMCTrueString = nil;
-	MCValueRelease(kMCEmptyString);
-	kMCEmptyString = nil;
-    MCValueRelease(kMCMixedString);
-    kMCMixedString = nil;
+    MCAssert(!__MCStringIsIndirect(self));
     
-    MCValueRelease(kMCCommaString);
-    kMCCommaString = nil;
-    MCValueRelease(kMCLineEndString);
-    kMCLineEndString = nil;
-    MCValueRelease(kMCTabString);
-    kMCTabString = nil;
-    MCValueRelease(kMCNulString);
-    kMCNulString = nil;
-
-#if defined(__LINUX__)
-    __MCStringFinalizeIconv();
-#endif
-}
+	// Fetch the capacity.
+	uindex_t t_capacity;
+	t_capacity = __MCStringGetCapacity(self);
 
-////////////////////////////////////////////////////////////////////////////////
+	/* Overflow check.  A string's length needs to fit into an
+	 * index_t, because sometimes negative indices are used.  Ensure that the
+	 * length of the expanded string (including a null byte) fits. */
+	if (INDEX_MAX == p_count || INDEX_MAX - p_count - 1 < self->char_count)
+	{
+		return MCErrorThrowOutOfMemory();
+	}
 
-////////////////////////////////////////////////////////////////////////////////
+	/* Overflow check.  A string's total storage size must fit into a
+	 * size_t.  The maximum capacity (i.e. number of chars) depends on whether it's a
+	 * Unicode (multibyte) or native (unibyte) string representation. */
+	size_t t_capacity_limit =
+		SIZE_MAX / (__MCStringIsNative(self) ? sizeof(char_t) : sizeof(unichar_t));
+	if (t_capacity_limit == p_count || t_capacity_limit - p_count - 1 < self->char_count)
+	{
+		return MCErrorThrowOutOfMemory();
+	}
 
-#ifdef __LINUX__
+	// The capacity field stores the total number of chars that could fit not
+	// including the implicit NUL, so if we fit, we can fast-track.
+	if (t_capacity != 0 && self -> char_count + p_count <= t_capacity)
+	{
+		// Shift up the chars above - including the implicit NUL.
+        if (__MCStringIsNative(self))
+            MCMemoryMove(self -> native_chars + p_at + p_count, self -> native_chars + p_at, ((self -> char_count + 1) - p_at));
+        else
+            MCMemoryMove(self -> chars + p_at + p_count, self -> chars + p_at, ((self -> char_count + 1) - p_at) * sizeof(unichar_t));
 
-#define ALLOC_PAD 64
-static bool do_iconv(iconv_t fd, const char *in, size_t in_len, char * &out, size_t &out_len)
-{
-	// Begin conversion. As a start, assume both encodings take the same
-	// space. This is probably wrong but the array is grown as needed.
-	size_t t_status = 0;
-	size_t t_alloc_remain = 0;
-    char * t_out;
-	char * t_out_cursor;
+		// Increase the char_count.
+		self -> char_count += p_count;
+		
+		// Rewrite the capacity.
+		//*(__MCStringGetCapacityPtr(self)) = t_capacity;
 
-    /* Reset the iconv file descriptor */
-    iconv(fd, nullptr, nullptr, nullptr, nullptr);
+		// We succeeded.
+		return true;
+	}
 
-    t_out = (char*)malloc(in_len);
-    if (t_out == nil)
-        return false;
+	// If we get here then we need to reallocate first.
 
-    t_alloc_remain = in_len;
-    t_out_cursor = t_out;
+	// Base capacity - current length + inserted length + implicit NUL.
+	uindex_t t_new_capacity;
+	t_new_capacity = self -> char_count + p_count + 1;
 
-	while (in_len > 0)
-	{
-		// Resize the destination array if it has been exhausted
-		t_status = iconv(fd, (char**)&in, &in_len, &t_out_cursor, &t_alloc_remain);
-		
-		// Did the conversion fail?
-		if (t_status == (size_t)-1)
-		{
-			// Insufficient output space errors can be fixed and retried
-			if (errno == E2BIG)
-			{
-				// Increase the size of the output array
-				uindex_t t_offset;
-                t_offset = t_out_cursor - t_out;
+	// Capacity rounded up to nearest aligned boundary and then space for
+	// the capacity field.
+	//t_new_capacity = ((t_new_capacity + sizeof(uindex_t) - 1) & (~(sizeof(uindex_t) - 1))) + sizeof(uindex_t);
 
-                char *t_new_out = (char*)realloc(t_out, t_offset + t_alloc_remain + ALLOC_PAD);
-                if (t_new_out == nil)
-                {
-                    free(t_out);
-                    return false;
-                }
+	// Capacity rounded up to a suitable boundary (at some point this should
+	// be a function of the string's size).
+	t_new_capacity = (t_new_capacity + 63) & ~63;
 
-                t_out = t_new_out;
-				
-				// Adjust the pointers because the output buffer may have moved
-                t_out_cursor = t_out + t_offset;
-                t_alloc_remain += ALLOC_PAD;		// Remaining size, not total size
-				
-				// Try the conversion again
-				continue;
-			}
-			else
-			{
-				// The error is one of the following:
-				//	EILSEQ	-	input byte invalid for input encoding
-				//	EINVAL	-	incomplete multibyte character at end of input
-				//	EBADF	-	invalid conversion file descriptor
-				// None of these are recoverable so abort
-                free(t_out);
-				return false;
-			}
-		}
-		else
-		{
-			// No error, conversion should be complete.
-			MCAssert(in_len == 0);
-		}
+	// Reallocate and shift up the chars above - including the implicit NUL.
+    if (__MCStringIsNative(self))
+    {
+        if (!MCMemoryReallocate(self -> native_chars, t_new_capacity, self -> native_chars))
+            return false;
+        
+    	MCMemoryMove(self -> native_chars + p_at + p_count, self -> native_chars + p_at, ((self -> char_count + 1) - p_at));
+    }
+    else
+    {
+        if (!MCMemoryReallocate(self -> chars, t_new_capacity * sizeof(unichar_t), self -> chars))
+            return false;
+        
+        MCMemoryMove(self -> chars + p_at + p_count, self -> chars + p_at, ((self -> char_count + 1) - p_at) * sizeof(unichar_t));
+    }
+
+	// Increase the char_count.
+	self -> char_count += p_count;
+
+	// Update the capacity - notice that we shave off the capacity field itself
+	// since it represents the char capacity rather than the size of the alloc'd
+	// block. We also shave off room for the implicit NUL.
+	self -> capacity = t_new_capacity - 1;
+	//*(__MCStringGetCapacityPtr(self)) = t_new_capacity - 1 - sizeof(uindex_t);
+
+	// We succeeded.
+	return true;
+}
+
+static void __MCStringShrinkAt(MCStringRef self, uindex_t p_at, uindex_t p_count)
+{
+    MCAssert(!__MCStringIsIndirect(self));
+    
+	// Shift the chars above 'at' down to remove 'count', remembering to include
+	// the implicit NUL.
+    if (__MCStringIsNative(self))
+        MCMemoryMove(self -> native_chars + p_at, self -> native_chars + (p_at + p_count), (self -> char_count - (p_at + p_count) + 1));
+    else
+        MCMemoryMove(self -> chars + p_at, self -> chars + (p_at + p_count), (self -> char_count - (p_at + p_count) + 1) * sizeof(strchar_t));
+
+	// Now adjust the length of the string.
+	self -> char_count -= p_count;
+
+	// TODO: Shrink the buffer if its too big.
+}
+
+static bool
+__MCStringNativize(MCStringRef self)
+{
+	uindex_t t_char_count;
+	return __MCStringNativize(self, t_char_count);
+}
+
+static bool __MCStringNativize(MCStringRef self, uindex_t & r_char_count)
+{
+    if (MCStringIsNative(self))
+	{
+		r_char_count = self -> char_count;
+		return true;
+	}
+    
+	if (__MCStringIsIndirect(self) &&
+	    !__MCStringResolveIndirect(self))
+	{
+		return false;
+	}
+    
+    bool t_not_native;
+    t_not_native = false;
+    
+	MCAutoArray<char_t> chars;
+	if (!chars.New(self -> char_count + 1))
+	{
+		return false;
+	}
+    
+    for(uindex_t i = 0; i < self -> char_count; i++)
+        if (!MCUnicodeCharMapToNative(self -> chars[i], chars[i]))
+        {
+            t_not_native = true;
+            break;
+        }
+    
+    if (!t_not_native)
+    {
+		uindex_t t_ignored;
+        __MCStringDeleteChars(self);
+		chars.Take(self -> native_chars, t_ignored);
+        __MCStringChanged(self, true, true, true);
+        self -> flags &= ~kMCStringFlagIsNotNative;
+        self -> native_chars[self -> char_count] = '\0';
+		r_char_count = self -> char_count;
+		return true;
+    }
+    
+    // The string needs to be normalised before conversion to native characters.
+    // All the native character sets we support use pre-composed characters.
+    MCAutoStringRef t_norm;
+	if (!MCStringNormalizedCopyNFC(self, &t_norm))
+	{
+		return false;
+	}
+    
+    // Nativisation is done on a char (grapheme) basis so we need to know the
+    // number of graphemes in the string
+    MCRange t_cu_range, t_char_range;
+    t_cu_range = MCRangeMake(0, (*t_norm) -> char_count);
+	if (!MCStringUnmapIndices(*t_norm, kMCCharChunkTypeGrapheme,
+	                          t_cu_range, t_char_range))
+	{
+		return false;
+	}
+    
+    t_cu_range = MCRangeMake(0, (*t_norm) -> char_count);
+    // Go through the graphemes of the string
+    uindex_t t_current = 0, t_next;
+    for (uindex_t i = 0; i < t_char_range . length; i++)
+    {
+        // If we've reached the end, set the next boundary manually
+        t_next = MCStringGraphemeBreakIteratorAdvance(self, t_current);
+        if (t_next == kMCLocaleBreakIteratorDone)
+            t_next = self -> char_count;
+        
+        // All nativisable characters are 1 codeunit in length.
+        if (t_next != t_current + 1
+            || !MCUnicodeCharMapToNative((*t_norm) -> chars[t_current], chars[i]))
+        {
+            chars[i] = '?';
+        }
+        
+        // Advance
+        t_current = t_next;
+    }
+    
+    uindex_t t_ignored;
+    __MCStringDeleteChars(self);
+	chars.Take(self -> native_chars, t_ignored);
+	self -> native_chars[t_char_range.length] = '\0';
+    
+    __MCStringChanged(self, true, true, true);
+    self -> flags &= ~kMCStringFlagIsNotNative;
+    self -> char_count = t_char_range . length;
+
+	r_char_count = t_char_range . length;
+	return true;
+}
+
+static bool __MCStringUnnativize(MCStringRef self)
+{    
+    if (!MCStringIsNative(self))
+		return true;
+
+	if (__MCStringIsIndirect(self) &&
+	    !__MCStringResolveIndirect(self))
+	{
+		return false;
+	}
+    
+    uindex_t t_capacity = self -> capacity != 0 ? self -> capacity : self -> char_count;
+    uindex_t t_char_count = self -> char_count;
+
+    unichar_t *chars;
+    
+	if (!MCMemoryNewArray(t_capacity + 1, chars))
+	{
+		return false;
 	}
     
-	// Conversion has been completed
-    out_len = t_out_cursor - t_out;
-    out = t_out;
-	return true;
-}
-
-MC_DLLEXPORT_DEF
-bool MCStringCreateWithSysString(const char *p_system_string, MCStringRef &r_string)
-{
-    // Is the string empty?
-    if (p_system_string == nil || *p_system_string == 0)
+	MCStrCharsMapFromNative(chars, self -> native_chars, t_char_count);
+	__MCStringDeleteChars(self);
+	self -> chars = chars;
+	self -> char_count = t_char_count;
+	// Set the NUL char.
+	self -> chars[t_char_count] = '\0';
+
+    __MCStringChanged(self, true, true, true);
+    self -> flags |= kMCStringFlagIsNotNative;
+
+	return true;
+}
+
+static void __MCStringSetFlags(MCStringRef self, uindex_t basic, uindex_t trivial, uindex_t native)
+{
+    MCAssert(!__MCStringIsIndirect(self));
+    
+    if (native == kMCStringFlagSetTrue)
+    {
+        self -> flags |= kMCStringFlagCanBeNative;
+        self -> flags |= kMCStringFlagIsTrivial;
+        self -> flags |= kMCStringFlagIsBasic;
+        return;
+    }
+    else if (native == kMCStringFlagSetFalse)
+    {
+        self -> flags &= ~kMCStringFlagCanBeNative;
+    }
+    
+    if (trivial == kMCStringFlagSetTrue)
+    {
+        self -> flags |= kMCStringFlagIsTrivial;
+        self -> flags |= kMCStringFlagIsBasic;
+        return;
+    }
+    else if (trivial == kMCStringFlagSetFalse)
+    {
+        self -> flags &= ~kMCStringFlagIsTrivial;
+        self -> flags &= ~kMCStringFlagCanBeNative;
+    }
+
+    if (basic == kMCStringFlagSetTrue)
+    {
+        self -> flags |=  kMCStringFlagIsBasic;
+    }
+    else if (basic == kMCStringFlagSetFalse)
+    {
+        self -> flags &= ~kMCStringFlagIsBasic;
+        self -> flags &= ~kMCStringFlagIsTrivial;
+        self -> flags &= ~kMCStringFlagCanBeNative;
+    }
+}
+
+static void __MCStringChanged(MCStringRef self, uindex_t basic, uindex_t trivial, uindex_t native)
+{
+    MCAssert(!__MCStringIsIndirect(self));
+
+    self -> flags &= ~kMCStringFlagIsChecked;
+    self -> flags &= ~kMCStringFlagHasNumber;
+    
+    __MCStringSetFlags(self, basic, trivial, native);
+}
+
+MC_DLLEXPORT_DEF
+codepoint_t MCStringSurrogatesToCodepoint(unichar_t p_lead, unichar_t p_trail)
+{
+    return 0x10000 + ((p_lead & 0x3FF) << 10) + (p_trail & 0x3FF);
+}
+
+MC_DLLEXPORT_DEF
+unsigned int MCStringCodepointToSurrogates(codepoint_t p_codepoint, unichar_t (&r_units)[2])
+{
+    if (p_codepoint > UNICHAR_MAX)
+    {
+        p_codepoint -= 0x10000;
+        r_units[0] = 0xD800 + (p_codepoint >> 10);
+        r_units[1] = 0xDC00 + (p_codepoint & 0x3FF);
+        return 2;
+    }
+    else
+    {
+        r_units[0] = p_codepoint;
+        return 1;
+    }
+}
+
+MC_DLLEXPORT_DEF
+bool MCStringIsValidSurrogatePair(MCStringRef self, uindex_t p_index)
+{
+	__MCAssertIsString(self);
+
+    if (__MCStringIsIndirect(self) &&
+        !__MCStringDereference(self))
+        return false;
+    
+    if (__MCStringIsNative(self))
+        return false;
+    
+    // Check that the string is long enough
+    // (Double-checking here is due to possible unsigned wrapping)
+    if (p_index >= self -> char_count || (p_index + 1) >= self -> char_count)
+        return false;
+    
+    // Check for a valid leading surrogate
+    unichar_t t_char;
+    t_char = self -> chars[p_index];
+    if (t_char < 0xD800 || t_char > 0xDBFF)
+        return false;
+    
+    // Check for a valid trailFing surrogate
+    t_char = self -> chars[p_index + 1];
+    if (t_char < 0xDC00 || t_char > 0xDFFF)
+        return false;
+    
+    // All the checks passed
+    return true;
+}
+
+MC_DLLEXPORT_DEF
+bool MCStringIsGraphemeClusterBoundary(MCStringRef self, uindex_t p_index)
+{
+    __MCAssertIsString(self);
+    
+    if (__MCStringIsIndirect(self) &&
+        !__MCStringDereference(self))
+        return false;
+    
+    if (__MCStringIsTrivial(self))
+        return true;
+    
+    if (p_index == 0 || p_index >= self -> char_count)
+        return true;
+    
+    // There is not a cluster boundary between the lead and trail of a surrogate
+    if (MCStringIsValidSurrogatePair(self, p_index - 1))
+        return false;
+        
+    
+    // Resolve the codepoints either side of the index
+    codepoint_t t_left_codepoint, t_right_codepoint;
+    
+    uindex_t t_dummy;
+    t_dummy = p_index;
+    if (!__MCStringFetchCodepointBefore(self, t_dummy, t_left_codepoint))
+        return true;
+    
+    t_dummy = p_index;
+    if (!__MCStringFetchCodepointAfter(self, t_dummy, t_right_codepoint))
+        return true;
+    
+    return MCUnicodeIsGraphemeClusterBoundary(t_left_codepoint, t_right_codepoint);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+#if defined(__LINUX__)
+static const iconv_t k_invalid_iconv_fd = reinterpret_cast<iconv_t>(-1);
+
+static bool is_valid_iconv_fd(iconv_t p_fd)
+{
+    return p_fd != k_invalid_iconv_fd;
+}
+
+static iconv_t s_iconv_unicode_from_sys_fd = k_invalid_iconv_fd;
+static iconv_t s_iconv_unicode_to_sys_fd   = k_invalid_iconv_fd;
+static iconv_t s_iconv_native_to_sys_fd    = k_invalid_iconv_fd;
+
+static bool
+__MCStringInitializeIconv()
+{
+    const char *k_internal_iconv_charset =
+        (kMCByteOrderHost == kMCByteOrderLittleEndian ? "UTF-16LE" : "UTF-16BE");
+
+    // What is the system character encoding?
+    //
+    // Doing this here is unpleasant but the MCString*SysString functions are
+    // needed before the libfoundation initialise call completes
+    if (__MCSysCharset == nil)
+    {
+        setlocale(LC_CTYPE, "");
+        __MCSysCharset = nl_langinfo(CODESET);
+    }
+
+    s_iconv_unicode_from_sys_fd = iconv_open(k_internal_iconv_charset, __MCSysCharset);
+    if (!is_valid_iconv_fd(s_iconv_unicode_from_sys_fd))
+        return false;
+    s_iconv_unicode_to_sys_fd = iconv_open(__MCSysCharset, k_internal_iconv_charset);
+    if (!is_valid_iconv_fd(s_iconv_unicode_to_sys_fd))
+        return false;
+    s_iconv_native_to_sys_fd = iconv_open(__MCSysCharset, "ISO-8859-1");
+    if (!is_valid_iconv_fd(s_iconv_native_to_sys_fd))
+        return false;
+
+    return true;
+}
+
+static void
+__MCStringFinalizeIconv()
+{
+    auto t_iconv_cleanup = [](iconv_t& p_fd) {
+        if (is_valid_iconv_fd(p_fd))
+        {
+            iconv_close(p_fd);
+            p_fd = k_invalid_iconv_fd;
+        }
+    };
+
+    t_iconv_cleanup(s_iconv_unicode_from_sys_fd);
+    t_iconv_cleanup(s_iconv_unicode_to_sys_fd);
+    t_iconv_cleanup(s_iconv_native_to_sys_fd);
+}
+
+#endif /* __LINUX__ */
+
+MC_DLLEXPORT_DEF MCStringRef kMCEmptyString;
+MC_DLLEXPORT_DEF MCStringRef kMCTrueString;
+MC_DLLEXPORT_DEF MCStringRef kMCFalseString;
+MC_DLLEXPORT_DEF MCStringRef kMCMixedString;
+MC_DLLEXPORT_DEF MCStringRef kMCCommaString;
+MC_DLLEXPORT_DEF MCStringRef kMCLineEndString;
+MC_DLLEXPORT_DEF MCStringRef kMCTabString;
+MC_DLLEXPORT_DEF MCStringRef kMCNulString;
+
+bool __MCStringInitialize(void)
+{
+    __MCNativeOp_Initialize();
+    
+#if defined(__LINUX__)
+    if (!__MCStringInitializeIconv())
+        return false;
+#endif
+
+	if (!MCStringCreateWithNativeChars((const char_t *)"", 0, kMCEmptyString))
+		return false;
+    
+	if (!MCStringCreateWithNativeChars((const char_t *)"true", 4, kMCTrueString))
+		return false;
+
+	if (!MCStringCreateWithNativeChars((const char_t *)"false", 5, kMCFalseString))
+		return false;
+    
+    if (!MCStringCreateWithNativeChars((const char_t *)"mixed", 5, kMCMixedString))
+		return false;
+    
+    if (!MCStringCreateWithNativeChars((const char_t *)",", 1, kMCCommaString))
+		return false;
+    
+	if (!MCStringCreateWithNativeChars((const char_t *)"\n", 1, kMCLineEndString))
+		return false;
+    
+    if (!MCStringCreateWithNativeChars((const char_t *)"\t", 1, kMCTabString))
+		return false;
+        
+    if (!MCStringCreateWithNativeChars((const char_t *)"\0", 1, kMCNulString))
+		return false;
+
+	return true;
+}
+
+void __MCStringFinalize(void)
+{
+	MCValueRelease(kMCFalseString);
+	kMCFalseString = nil;
+	MCValueRelease(kMCTrueString);
+	kMCTrueString = nil;
+	MCValueRelease(kMCEmptyString);
+	kMCEmptyString = nil;
+    MCValueRelease(kMCMixedString);
+    kMCMixedString = nil;
+    
+    MCValueRelease(kMCCommaString);
+    kMCCommaString = nil;
+    MCValueRelease(kMCLineEndString);
+    kMCLineEndString = nil;
+    MCValueRelease(kMCTabString);
+    kMCTabString = nil;
+    MCValueRelease(kMCNulString);
+    kMCNulString = nil;
+
+#if defined(__LINUX__)
+    __MCStringFinalizeIconv();
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////
+
+#ifdef __LINUX__
+
+#define ALLOC_PAD 64
+static bool do_iconv(iconv_t fd, const char *in, size_t in_len, char * &out, size_t &out_len)
+{
+	// Begin conversion. As a start, assume both encodings take the same
+	// space. This is probably wrong but the array is grown as needed.
+	size_t t_status = 0;
+	size_t t_alloc_remain = 0;
+    char * t_out;
+	char * t_out_cursor;
+
+    /* Reset the iconv file descriptor */
+    iconv(fd, nullptr, nullptr, nullptr, nullptr);
+
+    t_out = (char*)malloc(in_len);
+    if (t_out == nil)
+        return false;
+
+    t_alloc_remain = in_len;
+    t_out_cursor = t_out;
+
+	while (in_len > 0)
+	{
+		// Resize the destination array if it has been exhausted
+		t_status = iconv(fd, (char**)&in, &in_len, &t_out_cursor, &t_alloc_remain);
+		
+		// Did the conversion fail?
+		if (t_status == (size_t)-1)
+		{
+			// Insufficient output space errors can be fixed and retried
+			if (errno == E2BIG)
+			{
+				// Increase the size of the output array
+				uindex_t t_offset;
+                t_offset = t_out_cursor - t_out;
+
+                char *t_new_out = (char*)realloc(t_out, t_offset + t_alloc_remain + ALLOC_PAD);
+                if (t_new_out == nil)
+                {
+                    free(t_out);
+                    return false;
+                }
+
+                t_out = t_new_out;
+				
+				// Adjust the pointers because the output buffer may have moved
+                t_out_cursor = t_out + t_offset;
+                t_alloc_remain += ALLOC_PAD;		// Remaining size, not total size
+				
+				// Try the conversion again
+				continue;
+			}
+			else
+			{
+				// The error is one of the following:
+				//	EILSEQ	-	input byte invalid for input encoding
+				//	EINVAL	-	incomplete multibyte character at end of input
+				//	EBADF	-	invalid conversion file descriptor
+				// None of these are recoverable so abort
+                free(t_out);
+				return false;
+			}
+		}
+		else
+		{
+			// No error, conversion should be complete.
+			MCAssert(in_len == 0);
+		}
+	}
+    
+	// Conversion has been completed
+    out_len = t_out_cursor - t_out;
+    out = t_out;
+	return true;
+}
+
+MC_DLLEXPORT_DEF
+bool MCStringCreateWithSysString(const char *p_system_string, MCStringRef &r_string)
+{
+    // Is the string empty?
+    if (p_system_string == nil || *p_system_string == 0)
+    {
+        r_string = MCValueRetain(kMCEmptyString);
+        return true;
+    }
+
+    // Was creation of the iconv FD successful?
+    if (!is_valid_iconv_fd(s_iconv_unicode_from_sys_fd))
+        return false;
+
+    // Measure the string
+    size_t t_len;
+    t_len = strlen(p_system_string);
+
+	// Convert the string
+	char *t_utf16_bytes;
+	size_t t_utf16_byte_len;
+	bool t_success;
+    t_success = do_iconv(s_iconv_unicode_from_sys_fd, p_system_string, t_len,
+                         t_utf16_bytes, t_utf16_byte_len);
+	
+	if (!t_success)
+		return false;
+	
+	// Create the StringRef
+	MCStringRef t_string;
+	t_success = MCStringCreateWithBytes((const byte_t*)t_utf16_bytes, t_utf16_byte_len, kMCStringEncodingUTF16, false, t_string);
+	MCMemoryDeleteArray(t_utf16_bytes);
+	
+	if (!t_success)
+		return false;
+	
+	r_string = t_string;
+	return true;
+}
+
+MC_DLLEXPORT_DEF
+bool MCStringConvertToSysString(MCStringRef p_string, char *& r_system_string, size_t& r_byte_count)
+{
+    // Create the pseudo-FD that iconv uses for character conversion. For
+    // efficiency, convert straight from the internal format.
+	iconv_t t_fd;
+	const char *t_mc_string;
+	size_t t_mc_len;
+
+    // What is the system character encoding?
+    //
+    // Doing this here is unpleasant but the MCString*SysString functions are
+    // needed before the libfoundation initialise call is made
+    if (__MCSysCharset == nil)
+    {
+        setlocale(LC_CTYPE, "");
+        __MCSysCharset = nl_langinfo(CODESET);
+    }
+
+	if (MCStringIsNative(p_string) && MCStringGetNativeCharPtr(p_string) != nil)
+    {
+        t_fd = s_iconv_native_to_sys_fd;
+		t_mc_string = (const char *)MCStringGetNativeCharPtr(p_string);
+		t_mc_len = MCStringGetLength(p_string);
+	}
+	else
+	{
+        t_fd = s_iconv_unicode_to_sys_fd;
+		t_mc_string = (const char *)MCStringGetCharPtr(p_string);
+		t_mc_len = MCStringGetLength(p_string) * sizeof(unichar_t);
+	}
+
+    // Was creation of the iconv FD successful?
+    if (!is_valid_iconv_fd(t_fd))
+        return false;
+	
+	// Perform the conversion
+	bool t_success;
+	char *t_sys_string;
+	size_t t_sys_len;
+	t_success = do_iconv(t_fd, t_mc_string, t_mc_len, t_sys_string, t_sys_len);
+	
+	if (!t_success)
+		return false;
+	
+    // iconv doesn't append a null character
+    char *t_term = (char*)realloc(t_sys_string, t_sys_len + 1);
+    if (t_term == nil)
+    {
+        free(t_sys_string);
+        return false;
+    }
+    t_sys_string = t_term;
+    t_sys_string[t_sys_len] = '\0';
+
+	r_system_string = t_sys_string;
+    r_byte_count = t_sys_len;
+    
+	return true;
+}
+#elif defined(__WINDOWS__)
+bool MCStringConvertToSysString(MCStringRef p_string, char *& r_system_string, size_t& r_byte_count)
+{
+	__MCAssertIsString(p_string);
+
+    UINT t_codepage;
+    t_codepage = GetConsoleOutputCP();
+    
+    int t_needed;
+    t_needed = WideCharToMultiByte(t_codepage,
+                                   WC_COMPOSITECHECK | WC_NO_BEST_FIT_CHARS,
+                                   MCStringGetCharPtr(p_string),
+                                   -1,
+                                   NULL,
+                                   0,
+                                   NULL,
+                                   NULL);
+    
+    MCAutoArray<char> t_bytes;
+    if (!t_bytes . New(t_needed))
+        return false;
+    
+    if (WideCharToMultiByte(t_codepage,
+                            WC_COMPOSITECHECK | WC_NO_BEST_FIT_CHARS,
+                            MCStringGetCharPtr(p_string),
+                            -1,
+                            t_bytes . Ptr(),
+                            t_needed,
+                            NULL,
+                            NULL) == 0)
+        return false;
+    
+    uindex_t t_size;
+    char *t_ptr;
+    t_bytes . Take(t_ptr, t_size);
+    
+    r_system_string = t_ptr;
+    
+    // Account for the fact that array size includes the NUL byte.
+    r_byte_count = t_size - 1;
+    
+    return true;
+}
+#else
+bool MCStringConvertToSysString(MCStringRef p_string, char *& r_system_string, size_t& r_byte_count)
+{
+	__MCAssertIsString(p_string);
+
+    uindex_t t_byte_count;
+    if (!MCStringConvertToUTF8(p_string, r_system_string, t_byte_count))
+        return false;
+    r_byte_count = t_byte_count;
+    return true;
+}
+
+bool
+MCStringCreateWithSysString(const char *p_sys_string,
+                            MCStringRef & r_string)
+{
+	/* Fast path for empty string */
+	if (nil == p_sys_string || 0 == *p_sys_string)
+	{
+		r_string = MCValueRetain(kMCEmptyString);
+		return true;
+	}
+
+	/* Count the number of chars */
+	size_t t_byte_count;
+	for (t_byte_count = 0; p_sys_string[t_byte_count] != '\0'; ++t_byte_count);
+
+	return MCStringCreateWithBytes((const byte_t *) p_sys_string,
+	                               t_byte_count,
+	                               kMCStringEncodingUTF8,
+	                               false, /* is_external_rep */
+	                               r_string);
+}
+#endif
+
+bool
+MCStringCreateWithPascalString(const unsigned char* p_pascal_string, MCStringRef& r_string)
+{
+    // The first byte of the string gives the length
+    return MCStringCreateWithBytes(p_pascal_string+1, *p_pascal_string, kMCStringEncodingMacRoman, false, r_string);
+}
+
+static bool
+__MCStringCreateWithStrings(MCStringRef& r_string, bool p_has_separator, unichar_t p_separator, MCStringRef p_one, MCStringRef p_two)
+{
+    // Resolve indirection
+    if (__MCStringIsIndirect(p_one) &&
+        !__MCStringDereference(p_one))
+        return false;
+    if (__MCStringIsIndirect(p_two) &&
+        !__MCStringDereference(p_two))
+        return false;
+    
+    bool t_success;
+    t_success = true;
+    
+    // Create a new StringRef object
+    __MCString *self;
+    self = nil;
+    if (t_success)
+        t_success = __MCValueCreateExtended(kMCValueTypeCodeString, kMCStringInlineCapacity, self);
+    
+    // Calculate the required length and is-native status of the result string
+    uindex_t t_one_length, t_two_length;
+    t_one_length = __MCStringGetLength(p_one);
+    t_two_length = __MCStringGetLength(p_two);
+    bool t_native, t_can_be_native;
+    t_native = __MCStringIsNative(p_one) && __MCStringIsNative(p_two);
+    t_can_be_native = __MCStringCanBeNative(p_one) && __MCStringCanBeNative(p_two);
+    uindex_t t_length = t_one_length + t_two_length;
+    
+    // Take the separator into account
+    char_t t_native_separator;
+    if (p_has_separator)
+    {
+        bool t_separator_native;
+        t_separator_native = MCUnicodeCharMapToNative(p_separator, t_native_separator);
+        t_native = t_native && t_separator_native;
+        t_can_be_native = t_can_be_native && t_separator_native;
+        t_length++;
+    }
+    
+    // Increase the length so we always have a NUL terminator
+    t_length++;
+    
+    // Are we doing a native or a Unicode concatenation?
+    if (t_native)
+    {
+        // Allocate the output buffer
+        if (t_success)
+            t_success = __MCStringNewNativeChars(self, t_length - 1);
+        
+        if (t_success)
+        {
+            // Both sides are already native so the copy is simple
+            MCMemoryCopy(self->native_chars, p_one->native_chars, t_one_length);
+            if (p_has_separator)
+            {
+                // Add the separator character
+                self->native_chars[t_one_length] = t_native_separator;
+                t_one_length++;
+            }
+            MCMemoryCopy(self->native_chars + t_one_length, p_two->native_chars, t_two_length);
+            
+            // Terminate the string
+            self->char_count = t_length-1;
+            self->native_chars[self->char_count] = '\0';
+        }
+    }
+    else
+    {
+        // Allocate the output buffer
+        if (t_success)
+            t_success = MCMemoryAllocate(t_length * sizeof(unichar_t), self->chars);
+        
+        if (t_success)
+        {
+            // Copy the first string
+            if (!__MCStringIsNative(p_one))
+                MCMemoryCopy(self->chars, p_one->chars, t_one_length*sizeof(unichar_t));
+            else
+            {
+                // Copy and map each character
+                const char_t* t_one_ptr = p_one->native_chars;
+                for (uindex_t i = 0; i < t_one_length; i++)
+                    self->chars[i] = MCUnicodeCharMapFromNative(t_one_ptr[i]);
+            }
+            
+            if (p_has_separator)
+            {
+                // Add the separator character
+                self->chars[t_one_length] = p_separator;
+                t_one_length++;
+            }
+            
+            // Copy the second string
+            if (!__MCStringIsNative(p_two))
+                MCMemoryCopy(self->chars + t_one_length, p_two->chars, t_two_length*sizeof(unichar_t));
+            else
+            {
+                // Copy and map each character
+                const char_t* t_two_ptr = p_two->native_chars;
+                for (uindex_t i = 0; i < t_two_length; i++)
+                    self->chars[t_one_length + i] = MCUnicodeCharMapFromNative(t_two_ptr[i]);
+            }
+            
+            // Terminate the string
+            self->char_count = t_length-1;
+            self->chars[self->char_count] = '\0';
+            
+            // Set the flags
+            self->flags |= kMCStringFlagIsNotNative;
+        }
+    }
+    
+    // If both sides and the separator can be native, set the flag
+    if (t_can_be_native)
+        self->flags |= kMCStringFlagCanBeNative;
+    
+    // Set the output value
+    if (t_success)
+        r_string = self;
+    
+    return t_success;
+}
+
+////////////////////////////////////////////////////////////////////////
+
+#if defined(__WINDOWS__)
+
+MC_DLLEXPORT_DEF bool
+MCStringCreateWithBSTR(const BSTR p_bstr,
+                       MCStringRef& r_string)
+{
+    return MCStringCreateWithChars(p_bstr,
+                                   SysStringLen(p_bstr),
+                                   r_string);
+}
+
+#endif /*__WINDOWS__*/
+
+////////////////////////////////////////////////////////////////////////
+
+MC_DLLEXPORT_DEF
+bool
+MCStringCreateWithStrings(MCStringRef& r_string, MCStringRef p_one, MCStringRef p_two)
+{
+	__MCAssertIsString(p_one);
+	__MCAssertIsString(p_two);
+
+    return __MCStringCreateWithStrings(r_string, false, 0, p_one, p_two);
+}
+
+MC_DLLEXPORT_DEF
+bool
+MCStringCreateWithStringsAndSeparator(MCStringRef& r_string, unichar_t p_separator, MCStringRef p_one, MCStringRef p_two)
+{
+	__MCAssertIsString(p_one);
+	__MCAssertIsString(p_two);
+
+    return __MCStringCreateWithStrings(r_string, true, p_separator, p_one, p_two);
+}
+
+MC_DLLEXPORT_DEF
+bool MCStringNormalizedCopyNFC(MCStringRef self, MCStringRef &r_string)
+{
+	__MCAssertIsString(self);
+
+    if (MCStringIsNative(self))
+        return MCStringCopy(self, r_string);
+    
+    // Normalise
+    unichar_t *t_norm = nil;
+    uindex_t t_norm_length;
+    if (MCUnicodeNormaliseNFC(self -> chars, self -> char_count, t_norm, t_norm_length)
+        && MCStringCreateWithCharsAndRelease(t_norm, t_norm_length, r_string))
+        return true;
+    MCMemoryDelete(t_norm);
+    return false;
+}
+
+MC_DLLEXPORT_DEF
+bool MCStringNormalizedCopyNFD(MCStringRef self, MCStringRef &r_string)
+{
+	__MCAssertIsString(self);
+
+    // AL-2014-06-24: [[ Bug 12656 ]] Native strings can be decomposed into non-native ones.
+    unichar_t *t_norm = nil;
+    uindex_t t_norm_length;
+    if (MCUnicodeNormaliseNFD(MCStringGetCharPtr(self), self -> char_count, t_norm, t_norm_length)
+        && MCStringCreateWithCharsAndRelease(t_norm, t_norm_length, r_string))
+        return true;
+    MCMemoryDelete(t_norm);
+    return false;
+}
+
+MC_DLLEXPORT_DEF
+bool MCStringNormalizedCopyNFKC(MCStringRef self, MCStringRef &r_string)
+{
+	__MCAssertIsString(self);
+
+    // Native strings are already normalized
+    if (MCStringIsNative(self))
+        return MCStringCopy(self, r_string);
+    
+    // Normalise
+    unichar_t *t_norm = nil;
+    uindex_t t_norm_length;
+    if (MCUnicodeNormaliseNFKC(self -> chars, self -> char_count, t_norm, t_norm_length)
+        && MCStringCreateWithCharsAndRelease(t_norm, t_norm_length, r_string))
+        return true;
+    MCMemoryDelete(t_norm);
+    return false;
+}
+
+MC_DLLEXPORT_DEF
+bool MCStringNormalizedCopyNFKD(MCStringRef self, MCStringRef &r_string)
+{
+	__MCAssertIsString(self);
+
+    // AL-2014-06-24: [[ Bug 12656 ]] Native strings can be decomposed into non-native ones.
+    // Normalise
+    unichar_t *t_norm = nil;
+    uindex_t t_norm_length;
+    if (MCUnicodeNormaliseNFKD(MCStringGetCharPtr(self), self -> char_count, t_norm, t_norm_length)
+        && MCStringCreateWithCharsAndRelease(t_norm, t_norm_length, r_string))
+        return true;
+    MCMemoryDelete(t_norm);
+    return false;
+}
+
+/////////
+
+MC_DLLEXPORT_DEF
+bool MCStringSetNumericValue(MCStringRef self, double p_value)
+{
+	__MCAssertIsString(self);
+
+    if (__MCStringIsIndirect(self) &&
+        !__MCStringDereference(self))
+        return false;
+    
+    // Slices use the space for the value to reference their owner.
+    if (MCStringIsMutable(self) || __MCStringIsSlice(self))
+        return false;
+    
+    self -> numeric_value = p_value;
+    self -> flags |= kMCStringFlagHasNumber;
+    
+    return true;
+}
+
+MC_DLLEXPORT_DEF
+bool MCStringGetNumericValue(MCStringRef self, double &r_value)
+{
+	__MCAssertIsString(self);
+
+    if (__MCStringIsIndirect(self) &&
+        !__MCStringDereference(self))
+        return false;
+    
+    if ((self -> flags & kMCStringFlagHasNumber) != 0)
+    {
+        r_value = self -> numeric_value;
+        return true;
+    }
+    else
+        return false;
+}
+
+MC_DLLEXPORT bool
+MCStringNormalizeLineEndings(MCStringRef p_input, 
+                             MCStringLineEndingStyle p_to_style, 
+                             MCStringLineEndingOptions p_options,
+                             MCStringRef& r_output, 
+                             MCStringLineEndingStyle* r_original_style)
+{
+    MCStringLineEndingStyle t_original_style = kMCStringLineEndingStyleLF;
+    uindex_t t_first_lf = 0;
+    uindex_t t_first_cr = 0;
+    
+    if (MCStringFirstIndexOfChar(p_input, '\r', 0, kMCStringOptionCompareExact, t_first_cr))
+    {
+        if (MCStringFirstIndexOfChar(p_input, '\n', 0, kMCStringOptionCompareExact, t_first_lf))
+        {
+            if (t_first_cr + 1 == t_first_lf)
+            {
+                t_original_style = kMCStringLineEndingStyleCRLF;
+            }
+            else if (t_first_cr < t_first_lf)
+            {
+                t_original_style = kMCStringLineEndingStyleCR;
+            }
+        }
+        else
+        {
+            t_original_style = kMCStringLineEndingStyleCR;
+        }
+    }
+    
+    // normalize input to LF line endings first
+    MCAutoStringRef t_mutable_input;
+    if (!MCStringMutableCopy(p_input, &t_mutable_input))
+    {
+        return false;
+    }
+    if (!MCStringFindAndReplace(*t_mutable_input, 
+                                MCSTR("\r\n"), 
+                                MCSTR("\n"), 
+                                kMCStringOptionCompareExact))
+    {
+        return false;
+    }
+    if (!MCStringFindAndReplace(*t_mutable_input, 
+                                MCSTR("\r"), 
+                                MCSTR("\n"), 
+                                kMCStringOptionCompareExact))
+    {
+        return false;
+    }
+    
+    // AL-2014-07-21: [[ Bug 12162 ]] Convert PS to LF, and LS to VT on text import.
+    if (((p_options & kMCStringLineEndingOptionNormalizeLSToVT) != 0) &&
+        !MCStringFindAndReplaceChar(*t_mutable_input, 
+                                   (const codepoint_t)0x2028, 
+                                   (const codepoint_t)0x0B, 
+                                    kMCStringOptionCompareExact))
+    {
+        return false;
+    }
+    if (((p_options & kMCStringLineEndingOptionNormalizePSToLineEnding) != 0) &&
+        !MCStringFindAndReplaceChar(*t_mutable_input, 
+                                   (const codepoint_t)0x2029, 
+                                   (const codepoint_t)0x0A, 
+                                    kMCStringOptionCompareExact))
+    {
+        return false;
+    }
+    
+    // now convert the line endings to the proper version
+    if ((p_to_style == kMCStringLineEndingStyleCR) &&
+        !MCStringFindAndReplace(*t_mutable_input, 
+                                MCSTR("\n"), 
+                                MCSTR("\r"), 
+                                kMCStringOptionCompareExact))
+    {
+        return false;
+    }
+    else if ((p_to_style == kMCStringLineEndingStyleCRLF) &&
+             !MCStringFindAndReplace(*t_mutable_input, 
+                                     MCSTR("\n"), 
+                                     MCSTR("\r\n"), 
+                                     kMCStringOptionCompareExact))
+    {
+        return false;
+    }
+    
+    if (!t_mutable_input.MakeImmutable())
+    {
+        return false;
+    }
+    
+    r_output = t_mutable_input.Take();
+
+    if (r_original_style != nullptr)
+    {
+        *r_original_style = t_original_style;
+    }
+    
+    return true;
+}
+
+static void __MCStringCheck(MCStringRef self)
+{
+    __MCAssertIsString(self);
+    
+    // The check only sets flags which speed things up, so it can be skipped.
+    if (__MCStringIsIndirect(self) &&
+        !__MCStringDereference(self))
+        return;
+    
+    if (__MCStringIsChecked(self))
+        return;
+    
+    if (__MCStringCanBeNative(self))
+        return;
+    
+    bool t_can_be_native;
+    t_can_be_native = true;
+    
+    for (uindex_t i = 0; i < self -> char_count; i++)
+    {
+        if (MCStringIsValidSurrogatePair(self, i))
+        {
+            __MCStringSetFlags(self, false, false, false);
+            t_can_be_native = false;
+            break;
+        }
+        
+        if (!MCUnicodeIsGraphemeClusterBoundary(self -> chars[i], self -> chars[i + 1]))
+        {
+            __MCStringSetFlags(self, kMCStringFlagNoChange, false, false);
+            t_can_be_native = false;
+            break;
+        }
+        
+        char_t t_native;
+        if (!MCUnicodeCharMapToNative(self -> chars[i], t_native))
+        {
+            t_can_be_native = false;
+            break;
+        }
+    }
+    
+    if (t_can_be_native)
     {
-        r_string = MCValueRetain(kMCEmptyString);
-        return true;
+        __MCStringSetFlags(self, true, true, true);
     }
+    
+    self -> flags |= kMCStringFlagIsChecked;
+}
 
-    // Was creation of the iconv FD successful?
-    if (!is_valid_iconv_fd(s_iconv_unicode_from_sys_fd))
-        return false;
-
-    // Measure the string
-    size_t t_len;
-    t_len = strlen(p_system_string);
+////////////////////////////////////////////////////////////////////////////////
 
-	// Convert the string
-	char *t_utf16_bytes;
-	size_t t_utf16_byte_len;
-	bool t_success;
-    t_success = do_iconv(s_iconv_unicode_from_sys_fd, p_system_string, t_len,
-                         t_utf16_bytes, t_utf16_byte_len);
-	
-	if (!t_success)
-		return false;
-	
-	// Create the StringRef
-	MCStringRef t_string;
-	t_success = MCStringCreateWithBytes((const byte_t*)t_utf16_bytes, t_utf16_byte_len, kMCStringEncodingUTF16, false, t_string);
-	MCMemoryDeleteArray(t_utf16_bytes);
-	
-	if (!t_success)
-		return false;
-	
-	r_string = t_string;
-	return true;
+static bool __MCStringCreateIndirect(__MCString *string, __MCString*& r_string)
+{
+    MCStringRef self;
+    if (!__MCValueCreateExtended(kMCValueTypeCodeString, kMCStringInlineCapacity, self))
+        return false;
+    
+    self -> string = MCValueRetain(string);
+    self -> flags |= kMCStringFlagIsIndirect | kMCStringFlagIsMutable;
+    
+    r_string = self;
+    return true;
 }
 
-MC_DLLEXPORT_DEF
-bool MCStringConvertToSysString(MCStringRef p_string, char *& r_system_string, size_t& r_byte_count)
+// Returns true if the string is indirect.
+static bool __MCStringIsIndirect(__MCString *self)
 {
-    // Create the pseudo-FD that iconv uses for character conversion. For
-    // efficiency, convert straight from the internal format.
-	iconv_t t_fd;
-	const char *t_mc_string;
-	size_t t_mc_len;
+    return (self -> flags & kMCStringFlagIsIndirect) != 0;
+}
 
-    // What is the system character encoding?
-    //
-    // Doing this here is unpleasant but the MCString*SysString functions are
-    // needed before the libfoundation initialise call is made
-    if (__MCSysCharset == nil)
+static bool __MCStringMakeImmutable(__MCString *self)
+{
+    // Shrink the char buffer to be just long enough for the characters plus
+    // an implicit NUL.
+    if (MCStringIsNative(self))
     {
-        setlocale(LC_CTYPE, "");
-        __MCSysCharset = nl_langinfo(CODESET);
+        if (!MCMemoryResizeArray(self -> char_count + 1, self -> native_chars, self -> char_count))
+            return false;
     }
-
-	if (MCStringIsNative(p_string) && MCStringGetNativeCharPtr(p_string) != nil)
+    else
     {
-        t_fd = s_iconv_native_to_sys_fd;
-		t_mc_string = (const char *)MCStringGetNativeCharPtr(p_string);
-		t_mc_len = MCStringGetLength(p_string);
-	}
-	else
-	{
-        t_fd = s_iconv_unicode_to_sys_fd;
-		t_mc_string = (const char *)MCStringGetCharPtr(p_string);
-		t_mc_len = MCStringGetLength(p_string) * sizeof(unichar_t);
-	}
+        if (!MCMemoryResizeArray(self -> char_count + 1, self -> chars, self -> char_count))
+            return false;
+    }
+    
+    self -> char_count -= 1;
+    return true;
+}
 
-    // Was creation of the iconv FD successful?
-    if (!is_valid_iconv_fd(t_fd))
+// Creates an immutable string from this one, changing 'self' to indirect.
+static bool __MCStringMakeIndirect(__MCString *self)
+{
+    // If we are already indirect, there's nothing to do.
+	if (__MCStringIsIndirect(self))
+		return true;
+    
+    if (!__MCStringMakeImmutable(self))
         return false;
-	
-	// Perform the conversion
-	bool t_success;
-	char *t_sys_string;
-	size_t t_sys_len;
-	t_success = do_iconv(t_fd, t_mc_string, t_mc_len, t_sys_string, t_sys_len);
-	
-	if (!t_success)
+    
+	// Create a new direct string for self to reference
+	MCStringRef t_string;
+	if (!__MCValueCreateExtended(kMCValueTypeCodeString, kMCStringInlineCapacity, t_string))
 		return false;
-	
-    // iconv doesn't append a null character
-    char *t_term = (char*)realloc(t_sys_string, t_sys_len + 1);
-    if (t_term == nil)
+    
+	// Share the buffer and assign flags & count
+	t_string -> flags |= self -> flags;
+    t_string -> flags &= ~kMCStringFlagIsMutable;
+	t_string -> char_count = self -> char_count;
+    
+    if (__MCStringIsNative(self))
+        t_string -> native_chars = self -> native_chars;
+    else
     {
-        free(t_sys_string);
-        return false;
+        t_string -> chars = self -> chars;
+        t_string -> flags |= kMCStringFlagIsNotNative;
+        // AL-2015-02-05: [[ Bug 14504 ]] Ensure 'CanBeNative' flag is preserved when making a string indirect
+        if (__MCStringCanBeNative(self))
+            t_string -> flags |= kMCStringFlagCanBeNative;
     }
-    t_sys_string = t_term;
-    t_sys_string[t_sys_len] = '\0';
 
-	r_system_string = t_sys_string;
-    r_byte_count = t_sys_len;
-    
+	// 'self' now becomes indirect with a reference to the new string.
+	self -> flags |= kMCStringFlagIsIndirect;
+	self -> string = t_string;
 	return true;
 }
-#elif defined(__WINDOWS__)
-bool MCStringConvertToSysString(MCStringRef p_string, char *& r_system_string, size_t& r_byte_count)
-{
-	__MCAssertIsString(p_string);
 
-    UINT t_codepage;
-    t_codepage = GetConsoleOutputCP();
+// Ensures the given mutable but indirect string is direct.
+static bool __MCStringResolveIndirect(__MCString *self)
+{
+    // Make sure we are indirect.
+	MCAssert(__MCStringIsIndirect(self));
     
-    int t_needed;
-    t_needed = WideCharToMultiByte(t_codepage,
-                                   WC_COMPOSITECHECK | WC_NO_BEST_FIT_CHARS,
-                                   MCStringGetCharPtr(p_string),
-                                   -1,
-                                   NULL,
-                                   0,
-                                   NULL,
-                                   NULL);
+	// Fetch the reference. An immutable rope is direct once flattened.
+	MCStringRef t_string;
+	t_string = self;
+	if (!__MCStringDereference(t_string))
+		return false;
+	if (t_string == self)
+		return true;
     
-    MCAutoArray<char> t_bytes;
-    if (!t_bytes . New(t_needed))
-        return false;
+	// If the string only has a single reference, then re-absorb; otherwise
+	// copy.
+	if (self -> string -> references == 1 &&
+        !__MCStringIsSlice(t_string) &&
+        !__MCStringIsInline(t_string))
+	{
+        self -> char_count = t_string -> char_count;
+        self -> capacity = t_string -> capacity;
+        self -> flags |= t_string -> flags;
+        
+        if (__MCStringIsNative(t_string))
+            self -> native_chars = t_string -> native_chars;
+        else
+        {
+            self -> chars = t_string -> chars;
+            self -> flags |= kMCStringFlagIsNotNative;
+            // AL-2015-02-05: [[ Bug 14504 ]] Ensure 'CanBeNative' flag is preserved when making resolving an indirect string.
+            if (__MCStringCanBeNative(t_string))
+                self -> flags |= kMCStringFlagCanBeNative;
+        }
+
+		t_string -> char_count = 0;
+		t_string -> chars = nil;
+        t_string -> native_chars = nil;
+        MCValueRelease(t_string);
+	}
+	else
+	{
+        // SN-2015-01-13: [[ Bug 14354 ]] We don't want to release the string we reference
+        // before being sure that we can clone its buffer.
+        unichar_t *t_chars;
+        uint32_t t_char_count;
+        
+        if (__MCStringIsNative(t_string))
+        {
+            char_t *t_native_chars;
+            if (!__MCStringCloneNativeBuffer(t_string, t_native_chars, t_char_count))
+                return false;
+            
+            t_chars = (unichar_t*)t_native_chars;
+        }
+        else
+        {
+            if (!__MCStringCloneBuffer(t_string, t_chars, t_char_count))
+                return false;
+            
+            self -> flags |= kMCStringFlagIsNotNative;
+            
+            // AL-2015-02-05: [[ Bug 14504 ]] Ensure 'CanBeNative' flag is preserved when making resolving an indirect string.
+            if (__MCStringCanBeNative(t_string))
+                self -> flags |= kMCStringFlagCanBeNative;
+        }
+        
+        // SN-2015-01-13: [[ Bug 14354 ]] We can release now release the string,
+        // and then change the value of the string attributes
+        MCValueRelease(self -> string);
+        
+        self -> chars = t_chars;
+        self -> char_count = t_char_count;
+
+        self -> capacity = t_string -> char_count;
+	}
     
-    if (WideCharToMultiByte(t_codepage,
-                            WC_COMPOSITECHECK | WC_NO_BEST_FIT_CHARS,
-                            MCStringGetCharPtr(p_string),
-                            -1,
-                            t_bytes . Ptr(),
-                            t_needed,
-                            NULL,
-                            NULL) == 0)
-        return false;
+	self -> flags &= ~kMCStringFlagIsIndirect;
     
-    uindex_t t_size;
-    char *t_ptr;
-    t_bytes . Take(t_ptr, t_size);
+	return true;
+}
+
+static bool __MCStringCopyMutable(__MCString *self, __MCString*& r_new_string)
+{
+    if (!__MCStringMakeImmutable(self))
+        return false;
     
-    r_system_string = t_ptr;
+    __MCString *t_string;
+	t_string = nil;
+	
+    if (self -> char_count == 0)
+    {
+        t_string = MCValueRetain(kMCEmptyString);
+        MCMemoryDeleteArray(self -> native_chars);
+    }
+    else
+    {
+        if (!__MCValueCreateExtended(kMCValueTypeCodeString, kMCStringInlineCapacity, t_string))
+            return false;
+        
+        t_string -> char_count = self -> char_count;
+        if (__MCStringIsNative(self) &&
+            self -> char_count < kMCStringInlineCapacity)
+        {
+            __MCStringNewNativeChars(t_string, self -> char_count);
+            MCMemoryCopy(t_string -> native_chars, self -> native_chars, self -> char_count);
+            MCMemoryDeleteArray(self -> native_chars);
+        }
+        else if (__MCStringIsNative(self))
+            t_string -> native_chars = self -> native_chars;
+        else
+        {
+            t_string -> chars = self -> chars;
+            t_string -> flags |= kMCStringFlagIsNotNative;
+            // AL-2015-02-05: [[ Bug 14504 ]] Ensure 'CanBeNative' flag is preserved when making a new direct string.
+            if (__MCStringCanBeNative(self))
+                t_string -> flags |= kMCStringFlagCanBeNative;
+        }
+        t_string -> capacity = 0;
+    }
     
-    // Account for the fact that array size includes the NUL byte.
-    r_byte_count = t_size - 1;
+    self -> char_count = 0;
+    self -> chars = nil;
+    self -> native_chars = nil;
+    self -> string = MCValueRetain(t_string);
+    self -> flags |= kMCStringFlagIsIndirect;
     
+    r_new_string = t_string;
     return true;
 }
-#else
-bool MCStringConvertToSysString(MCStringRef p_string, char *& r_system_string, size_t& r_byte_count)
-{
-	__MCAssertIsString(p_string);
 
-    uindex_t t_byte_count;
-    if (!MCStringConvertToUTF8(p_string, r_system_string, t_byte_count))
-        return false;
-    r_byte_count = t_byte_count;
-    return true;
-}
+////////////////////////////////////////////////////////////////////////////////
 
-bool
-MCStringCreateWithSysString(const char *p_sys_string,
-                            MCStringRef & r_string)
-{
-	/* Fast path for empty string */
-	if (nil == p_sys_string || 0 == *p_sys_string)
-	{
-		r_string = MCValueRetain(kMCEmptyString);
-		return true;
-	}
+// Substrings of immutable strings can be slices, referencing the chars of the
+// string they were taken from rather than copying them. The chars of a string
+// can be replaced when it is nativized or unnativized, so a slice never
+// references the string it was taken from directly. Instead, the first time a
+// string is sliced its chars are given to a new (hidden) owner string and the
+// original becomes a slice of all of them.
 
-	/* Count the number of chars */
-	size_t t_byte_count;
-	for (t_byte_count = 0; p_sys_string[t_byte_count] != '\0'; ++t_byte_count);
+// Slices of owners no longer than this are always used.
+static const uindex_t kMCStringSliceMaxPinnedLength = 64 * 1024;
 
-	return MCStringCreateWithBytes((const byte_t *) p_sys_string,
-	                               t_byte_count,
-	                               kMCStringEncodingUTF8,
-	                               false, /* is_external_rep */
-	                               r_string);
-}
-#endif
+// Otherwise, slices are only used if they contain at least this fraction of
+// the owner's chars.
+static const uindex_t kMCStringSliceMaxPinnedRatio = 16;
 
-bool
-MCStringCreateWithPascalString(const unsigned char* p_pascal_string, MCStringRef& r_string)
+static bool __MCStringIsSlice(__MCString *self)
 {
-    // The first byte of the string gives the length
-    return MCStringCreateWithBytes(p_pascal_string+1, *p_pascal_string, kMCStringEncodingMacRoman, false, r_string);
+    return (self -> flags & kMCStringFlagIsSlice) != 0;
 }
 
-static bool
-__MCStringCreateWithStrings(MCStringRef& r_string, bool p_has_separator, unichar_t p_separator, MCStringRef p_one, MCStringRef p_two)
+static bool __MCStringShouldSlice(__MCString *self, MCRange p_range, bool p_always)
 {
-    bool t_success;
-    t_success = true;
-    
-    // Create a new StringRef object
-    __MCString *self;
-    self = nil;
-    if (t_success)
-        t_success = __MCValueCreate(kMCValueTypeCodeString, self);
-    
-    // Resolve indirection
-    if (__MCStringIsIndirect(p_one))
-        p_one = p_one->string;
-    if (__MCStringIsIndirect(p_two))
-        p_two = p_two->string;
-    
-    // Calculate the required length and is-native status of the result string
-    uindex_t t_one_length, t_two_length;
-    t_one_length = __MCStringGetLength(p_one);
-    t_two_length = __MCStringGetLength(p_two);
-    bool t_native, t_can_be_native;
-    t_native = __MCStringIsNative(p_one) && __MCStringIsNative(p_two);
-    t_can_be_native = __MCStringCanBeNative(p_one) && __MCStringCanBeNative(p_two);
-    uindex_t t_length = t_one_length + t_two_length;
+    MCAssert(!__MCStringIsIndirect(self));
     
-    // Take the separator into account
-    char_t t_native_separator;
-    if (p_has_separator)
+    // Only immutable chars can be shared, and short substrings are cheaper to
+    // copy inline.
+    if (MCStringIsMutable(self) || p_range . length < kMCStringInlineCapacity)
+        return false;
+
+    // Slicing a string which isn't a slice gives its chars to a new owner,
+    // changing it, so substrings of one other threads can see are copied.
+    if (!__MCStringIsSlice(self) && __MCValueIsShared(self))
+        return false;
+
+    // A slice which doesn't end where its owner does gets its own copy of its
+    // chars when they must be NUL terminated, which is only safe before it is
+    // shared. So when threading is enabled, only such slices are used.
+    if (__MCValueIsThreadingEnabled())
     {
-        bool t_separator_native;
-        t_separator_native = MCUnicodeCharMapToNative(p_separator, t_native_separator);
-        t_native = t_native && t_separator_native;
-        t_can_be_native = t_can_be_native && t_separator_native;
-        t_length++;
+        size_t t_char_size;
+        t_char_size = __MCStringIsNative(self) ? sizeof(char_t) : sizeof(unichar_t);
+
+        const byte_t *t_end, *t_owner_end;
+        t_end = (const byte_t *)self -> chars + (p_range . offset + p_range . length) * t_char_size;
+        t_owner_end = __MCStringIsSlice(self) ?
+                        (const byte_t *)self -> owner -> chars + self -> owner -> char_count * t_char_size :
+                        (const byte_t *)self -> chars + self -> char_count * t_char_size;
+        if (t_end != t_owner_end)
+            return false;
     }
+
+    uindex_t t_owner_length;
+    t_owner_length = __MCStringIsSlice(self) ? self -> owner -> char_count : self -> char_count;
+    if (!p_always &&
+        t_owner_length > kMCStringSliceMaxPinnedLength &&
+        p_range . length < t_owner_length / kMCStringSliceMaxPinnedRatio)
+        return false;
     
-    // Increase the length so we always have a NUL terminator
-    t_length++;
+    if (__MCStringIsNative(self))
+        return true;
     
-    // Are we doing a native or a Unicode concatenation?
-    if (t_native)
+    // Substrings of unicode strings are native if they can be, so unicode
+    // slices are only used if they contain a char which doesn't map to native.
+    char_t t_char;
+    for(uindex_t i = 0; i < p_range . length; i++)
+        if (!MCUnicodeCharMapToNative(self -> chars[p_range . offset + i], t_char))
+            return true;
+    
+    return false;
+}
+
+static bool __MCStringCreateSlice(__MCString *self, MCRange p_range, __MCString*& r_slice)
+{
+    if (!__MCStringIsSlice(self))
     {
-        // Allocate the output buffer
-        if (t_success)
-            t_success = MCMemoryAllocate(t_length, self->native_chars);
+        // Give the chars of self to a new owner, and make self a slice of it.
+        MCStringRef t_owner;
+        if (!__MCValueCreateExtended(kMCValueTypeCodeString, kMCStringInlineCapacity, t_owner))
+            return false;
         
-        if (t_success)
-        {
-            // Both sides are already native so the copy is simple
-            MCMemoryCopy(self->native_chars, p_one->native_chars, t_one_length);
-            if (p_has_separator)
-            {
-                // Add the separator character
-                self->native_chars[t_one_length] = t_native_separator;
-                t_one_length++;
-            }
-            MCMemoryCopy(self->native_chars + t_one_length, p_two->native_chars, t_two_length);
-            
-            // Terminate the string
-            self->char_count = t_length-1;
-            self->native_chars[self->char_count] = '\0';
-        }
+        t_owner -> char_count = self -> char_count;
+        t_owner -> chars = self -> chars;
+        t_owner -> flags |= self -> flags & kMCStringFlagIsNotNative;
+        
+        self -> flags &= ~kMCStringFlagHasNumber;
+        self -> flags |= kMCStringFlagIsSlice;
+        self -> owner = t_owner;
     }
+    
+    MCStringRef t_slice;
+    if (!__MCValueCreateExtended(kMCValueTypeCodeString, kMCStringInlineCapacity, t_slice))
+        return false;
+    
+    t_slice -> char_count = p_range . length;
+    if (__MCStringIsNative(self))
+        t_slice -> native_chars = self -> native_chars + p_range . offset;
     else
     {
-        // Allocate the output buffer
-        if (t_success)
-            t_success = MCMemoryAllocate(t_length * sizeof(unichar_t), self->chars);
-        
-        if (t_success)
-        {
-            // Copy the first string
-            if (!__MCStringIsNative(p_one))
-                MCMemoryCopy(self->chars, p_one->chars, t_one_length*sizeof(unichar_t));
-            else
-            {
-                // Copy and map each character
-                const char_t* t_one_ptr = p_one->native_chars;
-                for (uindex_t i = 0; i < t_one_length; i++)
-                    self->chars[i] = MCUnicodeCharMapFromNative(t_one_ptr[i]);
-            }
-            
-            if (p_has_separator)
-            {
-                // Add the separator character
-                self->chars[t_one_length] = p_separator;
-                t_one_length++;
-            }
-            
-            // Copy the second string
-            if (!__MCStringIsNative(p_two))
-                MCMemoryCopy(self->chars + t_one_length, p_two->chars, t_two_length*sizeof(unichar_t));
-            else
-            {
-                // Copy and map each character
-                const char_t* t_two_ptr = p_two->native_chars;
-                for (uindex_t i = 0; i < t_two_length; i++)
-                    self->chars[t_one_length + i] = MCUnicodeCharMapFromNative(t_two_ptr[i]);
-            }
-            
-            // Terminate the string
-            self->char_count = t_length-1;
-            self->chars[self->char_count] = '\0';
-            
-            // Set the flags
-            self->flags |= kMCStringFlagIsNotNative;
-        }
+        t_slice -> chars = self -> chars + p_range . offset;
+        t_slice -> flags |= kMCStringFlagIsNotNative;
     }
+    t_slice -> flags |= kMCStringFlagIsSlice;
+    t_slice -> owner = MCValueRetain(self -> owner);
     
-    // If both sides and the separator can be native, set the flag
-    if (t_can_be_native)
-        self->flags |= kMCStringFlagCanBeNative;
+    r_slice = t_slice;
+    return true;
+}
+
+static bool __MCStringTerminateSlice(__MCString *self)
+{
+    if (!__MCStringIsSlice(self))
+        return true;
     
-    // Set the output value
-    if (t_success)
-        r_string = self;
+    // A slice which ends where its owner does is followed by the owner's NUL.
+    size_t t_char_size;
+    t_char_size = __MCStringIsNative(self) ? sizeof(char_t) : sizeof(unichar_t);
+    if ((const byte_t *)self -> chars + self -> char_count * t_char_size ==
+        (const byte_t *)self -> owner -> chars + self -> owner -> char_count * t_char_size)
+        return true;
     
-    return t_success;
+    return __MCStringDetachChars(self);
 }
 
-////////////////////////////////////////////////////////////////////////
+static bool __MCStringDetachChars(__MCString *self)
+{
+    MCAssert(__MCStringIsSlice(self) || __MCStringIsInline(self));
+    
+    size_t t_char_size;
+    t_char_size = __MCStringIsNative(self) ? sizeof(char_t) : sizeof(unichar_t);
+    
+    byte_t *t_chars;
+    if (!MCMemoryNewArray(self -> char_count + 1, t_char_size, (void*&)t_chars))
+        return false;
+    
+    MCMemoryCopy(t_chars, self -> chars, self -> char_count * t_char_size);
+    
+    __MCStringDeleteChars(self);
+    self -> chars = (unichar_t *)t_chars;
+    
+    return true;
+}
 
-#if defined(__WINDOWS__)
+static void __MCStringDeleteChars(__MCString *self)
+{
+    if (__MCStringIsSlice(self))
+    {
+        MCValueRelease(self -> owner);
+        self -> owner = nil;
+        self -> flags &= ~kMCStringFlagIsSlice;
+    }
+    else if (!__MCStringIsInline(self))
+        MCMemoryDeleteArray(self -> chars);
+    
+    self -> chars = nil;
+}
 
-MC_DLLEXPORT_DEF bool
-MCStringCreateWithBSTR(const BSTR p_bstr,
-                       MCStringRef& r_string)
+////////////////////////////////////////////////////////////////////////////////
+
+// Every string value is allocated with kMCStringInlineCapacity bytes after its
+// struct, so that short immutable native strings (the most common kind) need
+// no separate allocation for their chars. The chars of an inline string cannot
+// grow, so it is given an allocated buffer before it is made mutable.
+
+static char_t *__MCStringInlineChars(__MCString *self)
 {
-    return MCStringCreateWithChars(p_bstr,
-                                   SysStringLen(p_bstr),
-                                   r_string);
+    return reinterpret_cast<char_t *>(self + 1);
+}
+
+static bool __MCStringIsInline(__MCString *self)
+{
+    return !__MCStringIsIndirect(self) &&
+            self -> native_chars == __MCStringInlineChars(self);
+}
+
+static bool __MCStringNewNativeChars(__MCString *self, uindex_t p_char_count)
+{
+    if (p_char_count >= kMCStringInlineCapacity)
+        return MCMemoryNewArray(p_char_count + 1, self -> native_chars);
+    
+    self -> native_chars = __MCStringInlineChars(self);
+    self -> native_chars[p_char_count] = '\0';
+    return true;
 }
 
-#endif /*__WINDOWS__*/
+////////////////////////////////////////////////////////////////////////////////
+
+// Large mutable strings which are edited anywhere other than at their end are
+// held as ropes, rather than moving all the chars after each edit. A rope is a
+// sequence of pieces, each referencing chars of either the immutable string
+// the rope was made from, a 'front' buffer holding chars prepended to it or a
+// 'back' buffer holding any other chars inserted. A rope is a form of indirect
+// string, so anything needing the string's chars flattens it first (see
+// __MCStringDereference).
+//
+// Copying a rope shares it, so the copy is an immutable string which is still
+// a rope; it is flattened in place when its chars are first needed. A shared
+// rope is copied before it is edited. As flattening changes the immutable
+// string, ropes are not shared when threading is enabled.
 
-////////////////////////////////////////////////////////////////////////
+// Strings shorter than this are always edited directly.
+static const uindex_t kMCStringRopeMinLength = 64 * 1024;
 
-MC_DLLEXPORT_DEF
-bool
-MCStringCreateWithStrings(MCStringRef& r_string, MCStringRef p_one, MCStringRef p_two)
-{
-	__MCAssertIsString(p_one);
-	__MCAssertIsString(p_two);
+// Ropes with more pieces than this (or one per this many chars, if greater)
+// are flattened by the next edit. This keeps finding the pieces an edit
+// touches cheap, while flattening no more often than every few edits in
+// proportion to the cost of doing so.
+static const uindex_t kMCStringRopeMaxPieces = 1024;
+static const uindex_t kMCStringRopeCharsPerPiece = 4096;
 
-    return __MCStringCreateWithStrings(r_string, false, 0, p_one, p_two);
-}
+// The minimum capacity (in chars) of a rope's front and back buffers.
+static const uindex_t kMCStringRopeMinBufferCapacity = 4096;
 
-MC_DLLEXPORT_DEF
-bool
-MCStringCreateWithStringsAndSeparator(MCStringRef& r_string, unichar_t p_separator, MCStringRef p_one, MCStringRef p_two)
+enum __MCStringRopeSource
 {
-	__MCAssertIsString(p_one);
-	__MCAssertIsString(p_two);
+    kMCStringRopeSourceBase,
+    kMCStringRopeSourceFront,
+    kMCStringRopeSourceBack,
+};
 
-    return __MCStringCreateWithStrings(r_string, true, p_separator, p_one, p_two);
-}
+struct __MCStringRopePiece
+{
+    __MCStringRopeSource source;
+    // The offset of the piece's first char in its source. The front buffer
+    // grows towards its start, so offsets of its pieces are measured back from
+    // its end.
+    uindex_t offset;
+    uindex_t length;
+};
 
-MC_DLLEXPORT_DEF
-bool MCStringNormalizedCopyNFC(MCStringRef self, MCStringRef &r_string)
+struct __MCStringRopeBuffer
 {
-	__MCAssertIsString(self);
+    byte_t *chars;
+    uindex_t length;
+    uindex_t capacity;
+};
 
-    if (MCStringIsNative(self))
-        return MCStringCopy(self, r_string);
-    
-    // Normalise
-    unichar_t *t_norm = nil;
-    uindex_t t_norm_length;
-    if (MCUnicodeNormaliseNFC(self -> chars, self -> char_count, t_norm, t_norm_length)
-        && MCStringCreateWithCharsAndRelease(t_norm, t_norm_length, r_string))
-        return true;
-    MCMemoryDelete(t_norm);
-    return false;
+struct __MCStringRope
+{
+    // The number of strings sharing the rope.
+    uindex_t references;
+    // The immutable string the rope was made from.
+    MCStringRef base;
+    __MCStringRopeBuffer front;
+    __MCStringRopeBuffer back;
+    __MCStringRopePiece *pieces;
+    uindex_t piece_count;
+    uindex_t piece_capacity;
+    uindex_t char_count;
+    // If true, the base and both buffers hold native chars.
+    bool native;
+};
+
+static bool __MCStringIsRope(__MCString *self)
+{
+    return (self -> flags & kMCStringFlagIsRope) != 0;
 }
 
-MC_DLLEXPORT_DEF
-bool MCStringNormalizedCopyNFD(MCStringRef self, MCStringRef &r_string)
+static uindex_t __MCStringRopeGetLength(__MCString *self)
 {
-	__MCAssertIsString(self);
+    return self -> rope -> char_count;
+}
 
-    // AL-2014-06-24: [[ Bug 12656 ]] Native strings can be decomposed into non-native ones.
-    unichar_t *t_norm = nil;
-    uindex_t t_norm_length;
-    if (MCUnicodeNormaliseNFD(MCStringGetCharPtr(self), self -> char_count, t_norm, t_norm_length)
-        && MCStringCreateWithCharsAndRelease(t_norm, t_norm_length, r_string))
-        return true;
-    MCMemoryDelete(t_norm);
-    return false;
+static bool __MCStringRopeIsNative(__MCString *self)
+{
+    return self -> rope -> native;
 }
 
-MC_DLLEXPORT_DEF
-bool MCStringNormalizedCopyNFKC(MCStringRef self, MCStringRef &r_string)
+static size_t __MCStringRopeCharSize(__MCStringRope *self)
 {
-	__MCAssertIsString(self);
+    return self -> native ? sizeof(char_t) : sizeof(unichar_t);
+}
 
-    // Native strings are already normalized
-    if (MCStringIsNative(self))
-        return MCStringCopy(self, r_string);
+static const byte_t *__MCStringRopeGetPieceChars(__MCStringRope *self, const __MCStringRopePiece& p_piece)
+{
+    switch(p_piece . source)
+    {
+        case kMCStringRopeSourceBase:
+            if (self -> native)
+                return (const byte_t *)(self -> base -> native_chars + p_piece . offset);
+            return (const byte_t *)(self -> base -> chars + p_piece . offset);
+            
+        case kMCStringRopeSourceFront:
+            return self -> front . chars + (self -> front . capacity - p_piece . offset) * __MCStringRopeCharSize(self);
+            
+        case kMCStringRopeSourceBack:
+            return self -> back . chars + p_piece . offset * __MCStringRopeCharSize(self);
+    }
     
-    // Normalise
-    unichar_t *t_norm = nil;
-    uindex_t t_norm_length;
-    if (MCUnicodeNormaliseNFKC(self -> chars, self -> char_count, t_norm, t_norm_length)
-        && MCStringCreateWithCharsAndRelease(t_norm, t_norm_length, r_string))
-        return true;
-    MCMemoryDelete(t_norm);
-    return false;
+    MCUnreachableReturn(nil);
 }
 
-MC_DLLEXPORT_DEF
-bool MCStringNormalizedCopyNFKD(MCStringRef self, MCStringRef &r_string)
+// Copies chars into the rope's encoding. Any unicode chars copied into a native
+// rope must be known to map to native.
+static void __MCStringRopeCopyChars(__MCStringRope *self, byte_t *p_dst, const void *p_chars, uindex_t p_char_count, bool p_native)
 {
-	__MCAssertIsString(self);
-
-    // AL-2014-06-24: [[ Bug 12656 ]] Native strings can be decomposed into non-native ones.
-    // Normalise
-    unichar_t *t_norm = nil;
-    uindex_t t_norm_length;
-    if (MCUnicodeNormaliseNFKD(MCStringGetCharPtr(self), self -> char_count, t_norm, t_norm_length)
-        && MCStringCreateWithCharsAndRelease(t_norm, t_norm_length, r_string))
-        return true;
-    MCMemoryDelete(t_norm);
-    return false;
+    if (self -> native == p_native)
+        MCMemoryCopy(p_dst, p_chars, p_char_count * __MCStringRopeCharSize(self));
+    else if (self -> native)
+    {
+        for(uindex_t i = 0; i < p_char_count; i++)
+            MCUnicodeCharMapToNative(((const unichar_t *)p_chars)[i], ((char_t *)p_dst)[i]);
+    }
+    else
+    {
+        for(uindex_t i = 0; i < p_char_count; i++)
+            ((unichar_t *)p_dst)[i] = MCUnicodeCharMapFromNative(((const char_t *)p_chars)[i]);
+    }
 }
 
-/////////
-
-MC_DLLEXPORT_DEF
-bool MCStringSetNumericValue(MCStringRef self, double p_value)
+// Copies the chars of the rope in the given range (clamped to the rope) into
+// the given buffer, in the given encoding. Unlike flattening, this doesn't
+// need any memory, so it is used for reads when flattening fails.
+static uindex_t __MCStringRopeGetChars(__MCStringRope *self, MCRange p_range, void *p_chars, bool p_native)
 {
-	__MCAssertIsString(self);
+    uindex_t t_offset, t_count;
+    t_offset = MCMin(p_range . offset, self -> char_count);
+    t_count = MCMin(p_range . length, self -> char_count - t_offset);
+    
+    uindex_t t_copied;
+    t_copied = 0;
+    for(uindex_t i = 0; i < self -> piece_count && t_copied < t_count; i++)
+    {
+        const __MCStringRopePiece& t_piece = self -> pieces[i];
+        if (t_offset >= t_piece . length)
+        {
+            t_offset -= t_piece . length;
+            continue;
+        }
+        
+        uindex_t t_length;
+        t_length = MCMin(t_piece . length - t_offset, t_count - t_copied);
+        
+        const byte_t *t_src;
+        t_src = __MCStringRopeGetPieceChars(self, t_piece) + t_offset * __MCStringRopeCharSize(self);
+        if (p_native && self -> native)
+            MCMemoryCopy((char_t *)p_chars + t_copied, t_src, t_length);
+        else if (p_native)
+            MCUnicodeCharsMapToNative((const unichar_t *)t_src, t_length, (char_t *)p_chars + t_copied, t_length, '?');
+        else if (self -> native)
+            MCUnicodeCharsMapFromNative((const char_t *)t_src, t_length, (unichar_t *)p_chars + t_copied);
+        else
+            MCMemoryCopy((unichar_t *)p_chars + t_copied, t_src, t_length * sizeof(unichar_t));
+        
+        t_copied += t_length;
+        t_offset = 0;
+    }
+    
+    return t_copied;
+}
 
-    if (__MCStringIsIndirect(self))
-        self = self -> string;
+// Adds the given chars to the front or back buffer of the rope, returning the
+// offset a piece referencing them should have.
+static bool __MCStringRopeStoreChars(__MCStringRope *self, bool p_front, const void *p_chars, uindex_t p_char_count, bool p_native, uindex_t& r_offset)
+{
+    __MCStringRopeBuffer& t_buffer = p_front ? self -> front : self -> back;
     
-    if (MCStringIsMutable(self))
-        return false;
+    size_t t_char_size;
+    t_char_size = __MCStringRopeCharSize(self);
     
-    self -> numeric_value = p_value;
-    self -> flags |= kMCStringFlagHasNumber;
+    if (p_char_count > t_buffer . capacity - t_buffer . length)
+    {
+        // Grow the buffer geometrically, so that repeated edits take amortized
+        // constant time per char.
+        uindex_t t_capacity;
+        t_capacity = MCMax(t_buffer . length + p_char_count, kMCStringRopeMinBufferCapacity);
+        if (t_buffer . capacity <= UINDEX_MAX / 2)
+            t_capacity = MCMax(t_capacity, t_buffer . capacity * 2);
+        
+        byte_t *t_chars;
+        if (!MCMemoryReallocate(t_buffer . chars, size_t(t_capacity) * t_char_size, t_chars))
+            return false;
+        
+        // The chars of the front buffer are kept at its end.
+        if (p_front)
+            MCMemoryMove(t_chars + (t_capacity - t_buffer . length) * t_char_size,
+                         t_chars + (t_buffer . capacity - t_buffer . length) * t_char_size,
+                         t_buffer . length * t_char_size);
+        
+        t_buffer . chars = t_chars;
+        t_buffer . capacity = t_capacity;
+    }
+    
+    byte_t *t_dst;
+    if (p_front)
+    {
+        t_buffer . length += p_char_count;
+        t_dst = t_buffer . chars + (t_buffer . capacity - t_buffer . length) * t_char_size;
+        r_offset = t_buffer . length;
+    }
+    else
+    {
+        t_dst = t_buffer . chars + t_buffer . length * t_char_size;
+        r_offset = t_buffer . length;
+        t_buffer . length += p_char_count;
+    }
+    
+    __MCStringRopeCopyChars(self, t_dst, p_chars, p_char_count, p_native);
     
     return true;
 }
 
-MC_DLLEXPORT_DEF
-bool MCStringGetNumericValue(MCStringRef self, double &r_value)
+static bool __MCStringRopeInsertPiece(__MCStringRope *self, uindex_t p_index, const __MCStringRopePiece& p_piece)
 {
-	__MCAssertIsString(self);
+    if (self -> piece_count == self -> piece_capacity)
+    {
+        uindex_t t_capacity;
+        t_capacity = MCMax(self -> piece_capacity * 2, 8U);
+        
+        __MCStringRopePiece *t_pieces;
+        if (!MCMemoryReallocate(self -> pieces, t_capacity * sizeof(__MCStringRopePiece), t_pieces))
+            return false;
+        
+        self -> pieces = t_pieces;
+        self -> piece_capacity = t_capacity;
+    }
+    
+    MCMemoryMove(self -> pieces + p_index + 1, self -> pieces + p_index, (self -> piece_count - p_index) * sizeof(__MCStringRopePiece));
+    self -> pieces[p_index] = p_piece;
+    self -> piece_count += 1;
+    
+    return true;
+}
 
-    if (__MCStringIsIndirect(self))
-        self = self -> string;
+// Ensures a piece of the rope starts at the given char offset, returning its
+// index (or the piece count if the offset is the end of the rope).
+static bool __MCStringRopeSplit(__MCStringRope *self, uindex_t p_offset, uindex_t& r_index)
+{
+    uindex_t t_start;
+    t_start = 0;
     
-    if ((self -> flags & kMCStringFlagHasNumber) != 0)
+    uindex_t t_index;
+    for(t_index = 0; t_index < self -> piece_count; t_index++)
     {
-        r_value = self -> numeric_value;
-        return true;
+        if (t_start == p_offset)
+            break;
+        
+        __MCStringRopePiece& t_piece = self -> pieces[t_index];
+        if (p_offset < t_start + t_piece . length)
+        {
+            uindex_t t_head_length;
+            t_head_length = p_offset - t_start;
+            
+            __MCStringRopePiece t_tail;
+            t_tail . source = t_piece . source;
+            t_tail . length = t_piece . length - t_head_length;
+            if (t_piece . source == kMCStringRopeSourceFront)
+                t_tail . offset = t_piece . offset - t_head_length;
+            else
+                t_tail . offset = t_piece . offset + t_head_length;
+            
+            if (!__MCStringRopeInsertPiece(self, t_index + 1, t_tail))
+                return false;
+            
+            // Inserting the tail may have moved the pieces.
+            self -> pieces[t_index] . length = t_head_length;
+            
+            t_index += 1;
+            break;
+        }
+        
+        t_start += t_piece . length;
     }
-    else
-        return false;
+    
+    r_index = t_index;
+    return true;
 }
 
-MC_DLLEXPORT bool
-MCStringNormalizeLineEndings(MCStringRef p_input, 
-                             MCStringLineEndingStyle p_to_style, 
-                             MCStringLineEndingOptions p_options,
-                             MCStringRef& r_output, 
-                             MCStringLineEndingStyle* r_original_style)
+// Replaces the (clamped) range of the rope with the given chars. The rope is
+// left unchanged if this fails.
+static bool __MCStringRopeReplace(__MCStringRope *self, MCRange p_range, const void *p_chars, uindex_t p_char_count, bool p_native)
 {
-    MCStringLineEndingStyle t_original_style = kMCStringLineEndingStyleLF;
-    uindex_t t_first_lf = 0;
-    uindex_t t_first_cr = 0;
+    uindex_t t_first, t_last;
+    if (!__MCStringRopeSplit(self, p_range . offset, t_first) ||
+        !__MCStringRopeSplit(self, p_range . offset + p_range . length, t_last))
+        return false;
     
-    if (MCStringFirstIndexOfChar(p_input, '\r', 0, kMCStringOptionCompareExact, t_first_cr))
+    if (p_char_count != 0)
     {
-        if (MCStringFirstIndexOfChar(p_input, '\n', 0, kMCStringOptionCompareExact, t_first_lf))
+        // Chars inserted at the start go in the front buffer (so repeated
+        // prepends make a single piece), anything else in the back buffer.
+        bool t_front;
+        t_front = p_range . offset == 0;
+        
+        uindex_t t_old_length;
+        t_old_length = t_front ? self -> front . length : self -> back . length;
+        
+        uindex_t t_offset;
+        if (!__MCStringRopeStoreChars(self, t_front, p_chars, p_char_count, p_native, t_offset))
+            return false;
+        
+        // If the new chars are adjacent in their buffer to those of the piece
+        // they are next to in the rope, extend that piece rather than adding
+        // a new one.
+        if (t_front &&
+            t_last < self -> piece_count &&
+            self -> pieces[t_last] . source == kMCStringRopeSourceFront &&
+            self -> pieces[t_last] . offset == t_old_length)
         {
-            if (t_first_cr + 1 == t_first_lf)
-            {
-                t_original_style = kMCStringLineEndingStyleCRLF;
-            }
-            else if (t_first_cr < t_first_lf)
-            {
-                t_original_style = kMCStringLineEndingStyleCR;
-            }
+            self -> pieces[t_last] . offset = t_offset;
+            self -> pieces[t_last] . length += p_char_count;
+        }
+        else if (!t_front &&
+                 self -> pieces[t_first - 1] . source == kMCStringRopeSourceBack &&
+                 self -> pieces[t_first - 1] . offset + self -> pieces[t_first - 1] . length == t_old_length)
+        {
+            self -> pieces[t_first - 1] . length += p_char_count;
         }
         else
         {
-            t_original_style = kMCStringLineEndingStyleCR;
+            __MCStringRopePiece t_piece;
+            t_piece . source = t_front ? kMCStringRopeSourceFront : kMCStringRopeSourceBack;
+            t_piece . offset = t_offset;
+            t_piece . length = p_char_count;
+            if (!__MCStringRopeInsertPiece(self, t_last, t_piece))
+                return false;
         }
     }
     
-    // normalize input to LF line endings first
-    MCAutoStringRef t_mutable_input;
-    if (!MCStringMutableCopy(p_input, &t_mutable_input))
+    // Remove the pieces which were in the range.
+    if (t_last > t_first)
     {
-        return false;
-    }
-    if (!MCStringFindAndReplace(*t_mutable_input, 
-                                MCSTR("\r\n"), 
-                                MCSTR("\n"), 
-                                kMCStringOptionCompareExact))
-    {
-        return false;
-    }
-    if (!MCStringFindAndReplace(*t_mutable_input, 
-                                MCSTR("\r"), 
-                                MCSTR("\n"), 
-                                kMCStringOptionCompareExact))
-    {
-        return false;
+        MCMemoryMove(self -> pieces + t_first, self -> pieces + t_last, (self -> piece_count - t_last) * sizeof(__MCStringRopePiece));
+        self -> piece_count -= t_last - t_first;
     }
     
-    // AL-2014-07-21: [[ Bug 12162 ]] Convert PS to LF, and LS to VT on text import.
-    if (((p_options & kMCStringLineEndingOptionNormalizeLSToVT) != 0) &&
-        !MCStringFindAndReplaceChar(*t_mutable_input, 
-                                   (const codepoint_t)0x2028, 
-                                   (const codepoint_t)0x0B, 
-                                    kMCStringOptionCompareExact))
-    {
+    self -> char_count = self -> char_count - p_range . length + p_char_count;
+    
+    return true;
+}
+
+// Allocates a NUL-terminated buffer holding the chars of the rope, noting
+// whether the chars of a unicode rope could be native.
+static bool __MCStringRopeFlattenChars(__MCStringRope *self, byte_t*& r_chars, bool& r_can_be_native)
+{
+    size_t t_char_size;
+    t_char_size = __MCStringRopeCharSize(self);
+    
+    byte_t *t_chars;
+    if (!MCMemoryAllocate((self -> char_count + 1) * t_char_size, t_chars))
         return false;
-    }
-    if (((p_options & kMCStringLineEndingOptionNormalizePSToLineEnding) != 0) &&
-        !MCStringFindAndReplaceChar(*t_mutable_input, 
-                                   (const codepoint_t)0x2029, 
-                                   (const codepoint_t)0x0A, 
-                                    kMCStringOptionCompareExact))
+    
+    bool t_can_be_native;
+    t_can_be_native = true;
+    
+    byte_t *t_dst;
+    t_dst = t_chars;
+    for(uindex_t i = 0; i < self -> piece_count; i++)
     {
-        return false;
+        const byte_t *t_src;
+        t_src = __MCStringRopeGetPieceChars(self, self -> pieces[i]);
+        
+        if (self -> native)
+            MCMemoryCopy(t_dst, t_src, self -> pieces[i] . length);
+        else
+            t_can_be_native = __MCStringCopyChars((unichar_t *)t_dst, (const unichar_t *)t_src, self -> pieces[i] . length, t_can_be_native);
+        
+        t_dst += self -> pieces[i] . length * t_char_size;
     }
+    MCMemoryClear(t_dst, t_char_size);
     
-    // now convert the line endings to the proper version
-    if ((p_to_style == kMCStringLineEndingStyleCR) &&
-        !MCStringFindAndReplace(*t_mutable_input, 
-                                MCSTR("\n"), 
-                                MCSTR("\r"), 
-                                kMCStringOptionCompareExact))
+    r_chars = t_chars;
+    r_can_be_native = t_can_be_native;
+    return true;
+}
+
+// Makes the (direct) string hold the flattened chars of a rope.
+static void __MCStringAssignRopeChars(__MCString *p_string, uindex_t p_char_count, bool p_native, byte_t *p_chars, bool p_can_be_native)
+{
+    p_string -> char_count = p_char_count;
+    if (p_native)
+        p_string -> native_chars = (char_t *)p_chars;
+    else
     {
-        return false;
+        p_string -> chars = (unichar_t *)p_chars;
+        p_string -> flags |= kMCStringFlagIsNotNative;
+        if (p_can_be_native)
+            p_string -> flags |= kMCStringFlagCanBeNative;
     }
-    else if ((p_to_style == kMCStringLineEndingStyleCRLF) &&
-             !MCStringFindAndReplace(*t_mutable_input, 
-                                     MCSTR("\n"), 
-                                     MCSTR("\r\n"), 
-                                     kMCStringOptionCompareExact))
+}
+
+// Creates an immutable string with the chars of the rope.
+static bool __MCStringRopeFlatten(__MCStringRope *self, MCStringRef& r_string)
+{
+    // If the rope is just its base, there is nothing to do.
+    if (self -> piece_count == 1 &&
+        self -> pieces[0] . source == kMCStringRopeSourceBase &&
+        self -> pieces[0] . length == self -> base -> char_count)
     {
-        return false;
+        r_string = MCValueRetain(self -> base);
+        return true;
     }
     
-    if (!t_mutable_input.MakeImmutable())
+    if (self -> char_count == 0)
     {
-        return false;
+        r_string = MCValueRetain(kMCEmptyString);
+        return true;
     }
     
-    r_output = t_mutable_input.Take();
-
-    if (r_original_style != nullptr)
+    byte_t *t_chars;
+    bool t_can_be_native;
+    if (!__MCStringRopeFlattenChars(self, t_chars, t_can_be_native))
+        return false;
+    
+    MCStringRef t_string;
+    if (!__MCValueCreateExtended(kMCValueTypeCodeString, kMCStringInlineCapacity, t_string))
     {
-        *r_original_style = t_original_style;
+        MCMemoryDeallocate(t_chars);
+        return false;
     }
     
+    __MCStringAssignRopeChars(t_string, self -> char_count, self -> native, t_chars, t_can_be_native);
+    
+    r_string = t_string;
     return true;
 }
 
-static void __MCStringCheck(MCStringRef self)
+// Makes self (a mutable string) a rope with the same chars.
+static bool __MCStringMakeRope(__MCString *self)
 {
-    __MCAssertIsString(self);
-    
-    if (__MCStringIsIndirect(self))
-        self = self -> string;
-    
-    if (__MCStringIsChecked(self))
-        return;
+    if (!__MCStringMakeIndirect(self))
+        return false;
     
-    if (__MCStringCanBeNative(self))
-        return;
+    __MCStringRope *t_rope;
+    if (!MCMemoryNew(t_rope))
+        return false;
     
-    bool t_can_be_native;
-    t_can_be_native = true;
+    t_rope -> references = 1;
+    t_rope -> base = self -> string;
+    t_rope -> char_count = t_rope -> base -> char_count;
+    t_rope -> native = __MCStringIsNative(t_rope -> base);
     
-    for (uindex_t i = 0; i < self -> char_count; i++)
+    if (t_rope -> char_count != 0)
     {
-        if (MCStringIsValidSurrogatePair(self, i))
-        {
-            __MCStringSetFlags(self, false, false, false);
-            t_can_be_native = false;
-            break;
-        }
-        
-        if (!MCUnicodeIsGraphemeClusterBoundary(self -> chars[i], self -> chars[i + 1]))
-        {
-            __MCStringSetFlags(self, kMCStringFlagNoChange, false, false);
-            t_can_be_native = false;
-            break;
-        }
-        
-        char_t t_native;
-        if (!MCUnicodeCharMapToNative(self -> chars[i], t_native))
+        __MCStringRopePiece t_piece;
+        t_piece . source = kMCStringRopeSourceBase;
+        t_piece . offset = 0;
+        t_piece . length = t_rope -> char_count;
+        if (!__MCStringRopeInsertPiece(t_rope, 0, t_piece))
         {
-            t_can_be_native = false;
-            break;
+            MCMemoryDelete(t_rope);
+            return false;
         }
     }
     
-    if (t_can_be_native)
-    {
-        __MCStringSetFlags(self, true, true, true);
-    }
+    // The rope takes over the reference to the base string.
+    self -> rope = t_rope;
+    self -> flags |= kMCStringFlagIsRope;
     
-    self -> flags |= kMCStringFlagIsChecked;
+    return true;
 }
 
-////////////////////////////////////////////////////////////////////////////////
-
-static bool __MCStringCreateIndirect(__MCString *string, __MCString*& r_string)
+// Creates a string sharing the rope of self.
+static bool __MCStringShareRope(__MCString *self, bool p_mutable, __MCString*& r_string)
 {
-    MCStringRef self;
-    if (!__MCValueCreate(kMCValueTypeCodeString, self))
+    MCAssert(__MCStringIsRope(self));
+    
+    MCStringRef t_string;
+    if (!__MCValueCreateExtended(kMCValueTypeCodeString, kMCStringInlineCapacity, t_string))
         return false;
     
-    self -> string = MCValueRetain(string);
-    self -> flags |= kMCStringFlagIsIndirect | kMCStringFlagIsMutable;
+    t_string -> rope = self -> rope;
+    t_string -> rope -> references += 1;
+    t_string -> flags |= kMCStringFlagIsIndirect | kMCStringFlagIsRope;
+    if (p_mutable)
+        t_string -> flags |= kMCStringFlagIsMutable;
     
-    r_string = self;
+    r_string = t_string;
     return true;
 }
 
-// Returns true if the string is indirect.
-static bool __MCStringIsIndirect(__MCString *self)
-{
-    return (self -> flags & kMCStringFlagIsIndirect) != 0;
-}
-
-static bool __MCStringMakeImmutable(__MCString *self)
+static bool __MCStringRopeCloneBuffer(__MCStringRope *self, const __MCStringRopeBuffer& p_buffer, bool p_front, __MCStringRopeBuffer& r_buffer)
 {
-    // Shrink the char buffer to be just long enough for the characters plus
-    // an implicit NUL.
-    if (MCStringIsNative(self))
-    {
-        if (!MCMemoryResizeArray(self -> char_count + 1, self -> native_chars, self -> char_count))
-            return false;
-    }
-    else
-    {
-        if (!MCMemoryResizeArray(self -> char_count + 1, self -> chars, self -> char_count))
-            return false;
-    }
+    size_t t_char_size;
+    t_char_size = __MCStringRopeCharSize(self);
     
-    self -> char_count -= 1;
+    if (p_buffer . length != 0 &&
+        !MCMemoryAllocate(p_buffer . length * t_char_size, r_buffer . chars))
+        return false;
+    
+    // Only the used chars are copied. The front buffer's piece offsets are
+    // measured back from its end, so they stay valid.
+    const byte_t *t_src;
+    t_src = p_buffer . chars;
+    if (p_front)
+        t_src += (p_buffer . capacity - p_buffer . length) * t_char_size;
+    MCMemoryCopy(r_buffer . chars, t_src, p_buffer . length * t_char_size);
+    
+    r_buffer . length = p_buffer . length;
+    r_buffer . capacity = p_buffer . length;
     return true;
 }
 
-// Creates an immutable string from this one, changing 'self' to indirect.
-static bool __MCStringMakeIndirect(__MCString *self)
+// Gives self its own copy of its rope, if the rope is shared. This costs time
+// in proportion to the edits made, rather than the length of the string.
+static bool __MCStringUnshareRope(__MCString *self)
 {
-    // If we are already indirect, there's nothing to do.
-	if (__MCStringIsIndirect(self))
-		return true;
+    MCAssert(__MCStringIsRope(self));
     
-    if (!__MCStringMakeImmutable(self))
+    __MCStringRope *t_rope;
+    t_rope = self -> rope;
+    if (t_rope -> references == 1)
+        return true;
+    
+    __MCStringRope *t_new_rope;
+    if (!MCMemoryNew(t_new_rope))
         return false;
     
-	// Create a new direct string for self to reference
-	MCStringRef t_string;
-	if (!__MCValueCreate(kMCValueTypeCodeString, t_string))
-		return false;
+    *t_new_rope = *t_rope;
+    t_new_rope -> references = 1;
+    t_new_rope -> front . chars = nil;
+    t_new_rope -> back . chars = nil;
+    t_new_rope -> pieces = nil;
+    t_new_rope -> piece_capacity = t_rope -> piece_count;
+    
+    if (!__MCStringRopeCloneBuffer(t_rope, t_rope -> front, true, t_new_rope -> front) ||
+        !__MCStringRopeCloneBuffer(t_rope, t_rope -> back, false, t_new_rope -> back) ||
+        (t_rope -> piece_count != 0 &&
+         !MCMemoryAllocateCopy(t_rope -> pieces, t_rope -> piece_count * sizeof(__MCStringRopePiece), t_new_rope -> pieces)))
+    {
+        MCMemoryDeallocate(t_new_rope -> front . chars);
+        MCMemoryDeallocate(t_new_rope -> back . chars);
+        MCMemoryDelete(t_new_rope);
+        return false;
+    }
     
-	// Share the buffer and assign flags & count
-	t_string -> flags |= self -> flags;
-    t_string -> flags &= ~kMCStringFlagIsMutable;
-	t_string -> char_count = self -> char_count;
+    MCValueRetain(t_new_rope -> base);
+    t_rope -> references -= 1;
+    self -> rope = t_new_rope;
     
-    if (__MCStringIsNative(self))
-        t_string -> native_chars = self -> native_chars;
-    else
-    {
-        t_string -> chars = self -> chars;
-        t_string -> flags |= kMCStringFlagIsNotNative;
-        // AL-2015-02-05: [[ Bug 14504 ]] Ensure 'CanBeNative' flag is preserved when making a string indirect
-        if (__MCStringCanBeNative(self))
-            t_string -> flags |= kMCStringFlagCanBeNative;
-    }
-
-	// 'self' now becomes indirect with a reference to the new string.
-	self -> flags |= kMCStringFlagIsIndirect;
-	self -> string = t_string;
-	return true;
+    return true;
 }
 
-// Ensures the given mutable but indirect string is direct.
-static bool __MCStringResolveIndirect(__MCString *self)
+static void __MCStringDestroyRope(__MCString *self)
 {
-    // Make sure we are indirect.
-	MCAssert(__MCStringIsIndirect(self));
+    __MCStringRope *t_rope;
+    t_rope = self -> rope;
     
-	// Fetch the reference.
-	MCStringRef t_string;
-	t_string = self -> string;
+    t_rope -> references -= 1;
+    if (t_rope -> references != 0)
+        return;
     
-	// If the string only has a single reference, then re-absorb; otherwise
-	// copy.
-	if (self -> string -> references == 1)
-	{
-        self -> char_count = t_string -> char_count;
-        self -> capacity = t_string -> capacity;
-        self -> flags |= t_string -> flags;
-        
-        if (__MCStringIsNative(t_string))
-            self -> native_chars = t_string -> native_chars;
-        else
-        {
-            self -> chars = t_string -> chars;
-            self -> flags |= kMCStringFlagIsNotNative;
-            // AL-2015-02-05: [[ Bug 14504 ]] Ensure 'CanBeNative' flag is preserved when making resolving an indirect string.
-            if (__MCStringCanBeNative(t_string))
-                self -> flags |= kMCStringFlagCanBeNative;
-        }
+    MCValueRelease(t_rope -> base);
+    MCMemoryDeallocate(t_rope -> front . chars);
+    MCMemoryDeallocate(t_rope -> back . chars);
+    MCMemoryDeallocate(t_rope -> pieces);
+    MCMemoryDelete(t_rope);
+}
 
-		t_string -> char_count = 0;
-		t_string -> chars = nil;
-        t_string -> native_chars = nil;
-        MCValueRelease(t_string);
-	}
-	else
-	{
-        // SN-2015-01-13: [[ Bug 14354 ]] We don't want to release the string we reference
-        // before being sure that we can clone its buffer.
-        unichar_t *t_chars;
-        uint32_t t_char_count;
+static bool __MCStringFlattenRope(__MCString *self)
+{
+    MCAssert(__MCStringIsRope(self));
+    
+    // An immutable rope becomes a direct string with the chars.
+    if (!MCStringIsMutable(self))
+    {
+        uindex_t t_char_count;
+        bool t_native;
+        t_char_count = self -> rope -> char_count;
+        t_native = self -> rope -> native;
         
-        if (__MCStringIsNative(t_string))
-        {
-            char_t *t_native_chars;
-            if (!__MCStringCloneNativeBuffer(t_string, t_native_chars, t_char_count))
-                return false;
-            
-            t_chars = (unichar_t*)t_native_chars;
-        }
-        else
-        {
-            if (!__MCStringCloneBuffer(t_string, t_chars, t_char_count))
-                return false;
-            
-            self -> flags |= kMCStringFlagIsNotNative;
-            
-            // AL-2015-02-05: [[ Bug 14504 ]] Ensure 'CanBeNative' flag is preserved when making resolving an indirect string.
-            if (__MCStringCanBeNative(t_string))
-                self -> flags |= kMCStringFlagCanBeNative;
-        }
+        byte_t *t_chars;
+        bool t_can_be_native;
+        if (!__MCStringRopeFlattenChars(self -> rope, t_chars, t_can_be_native))
+            return false;
         
-        // SN-2015-01-13: [[ Bug 14354 ]] We can release now release the string,
-        // and then change the value of the string attributes
-        MCValueRelease(self -> string);
+        __MCStringDestroyRope(self);
+        self -> flags &= ~(kMCStringFlagIsRope | kMCStringFlagIsIndirect);
+        self -> capacity = 0;
+        __MCStringAssignRopeChars(self, t_char_count, t_native, t_chars, t_can_be_native);
         
-        self -> chars = t_chars;
-        self -> char_count = t_char_count;
-
-        self -> capacity = t_string -> char_count;
-	}
+        return true;
+    }
     
-	self -> flags &= ~kMCStringFlagIsIndirect;
+    MCStringRef t_string;
+    if (!__MCStringRopeFlatten(self -> rope, t_string))
+        return false;
     
-	return true;
+    __MCStringDestroyRope(self);
+    
+    self -> string = t_string;
+    self -> flags &= ~kMCStringFlagIsRope;
+    
+    return true;
 }
 
-static bool __MCStringCopyMutable(__MCString *self, __MCString*& r_new_string)
+static bool __MCStringDereference(__MCString*& x_self)
 {
-    if (!__MCStringMakeImmutable(self))
+    MCAssert(__MCStringIsIndirect(x_self));
+    
+    if (__MCStringIsRope(x_self) &&
+        !__MCStringFlattenRope(x_self))
         return false;
     
-    __MCString *t_string;
-	t_string = nil;
-	
-    if (self -> char_count == 0)
+    // A flattened immutable rope is now direct.
+    if (__MCStringIsIndirect(x_self))
+        x_self = x_self -> string;
+    
+    return true;
+}
+
+static bool __MCStringEditAsRope(__MCString *self, MCRange p_range, const void *p_chars, uindex_t p_char_count, bool p_native, bool& r_edited)
+{
+    r_edited = false;
+    
+    uindex_t t_length;
+    bool t_native;
+    if (__MCStringIsRope(self))
     {
-        t_string = MCValueRetain(kMCEmptyString);
-        MCMemoryDeleteArray(self -> native_chars);
+        t_length = self -> rope -> char_count;
+        t_native = self -> rope -> native;
     }
     else
     {
-        if (!__MCValueCreate(kMCValueTypeCodeString, t_string))
-            return false;
+        MCStringRef t_string;
+        t_string = __MCStringIsIndirect(self) ? self -> string : self;
+        t_length = t_string -> char_count;
+        t_native = __MCStringIsNative(t_string);
+    }
+    
+    // Clamp the range in the same way as the direct edit.
+    uindex_t t_left, t_right;
+    t_left = MCMin(p_range . offset, t_length);
+    t_right = MCMin(p_range . offset + MCMin(p_range . length, UINDEX_MAX - p_range . offset), t_length);
+    p_range = MCRangeMake(t_left, t_right - t_left);
+    
+    // Let the direct edit deal with a result which would be too long.
+    if (p_char_count > UINDEX_MAX - t_length)
+        return true;
+    
+    if (!__MCStringIsRope(self))
+    {
+        if (t_length < kMCStringRopeMinLength)
+            return true;
         
-        t_string -> char_count = self -> char_count;
-        if (__MCStringIsNative(self))
-            t_string -> native_chars = self -> native_chars;
-        else
-        {
-            t_string -> chars = self -> chars;
-            t_string -> flags |= kMCStringFlagIsNotNative;
-            // AL-2015-02-05: [[ Bug 14504 ]] Ensure 'CanBeNative' flag is preserved when making a new direct string.
-            if (__MCStringCanBeNative(self))
-                t_string -> flags |= kMCStringFlagCanBeNative;
-        }
-        t_string -> capacity = 0;
+        // Editing the string directly only costs more than the size of the
+        // edit if it moves the chars after the range, or if the chars are
+        // shared with another string and so must be copied.
+        bool t_moves_chars, t_copies_chars;
+        t_moves_chars = p_range . offset + p_range . length < t_length && p_range . length != p_char_count;
+        t_copies_chars = __MCStringIsIndirect(self) && self -> string -> references > 1;
+        if (!t_moves_chars && !t_copies_chars)
+            return true;
+    }
+    else if (self -> rope -> piece_count + 2 > MCMax(kMCStringRopeMaxPieces, t_length / kMCStringRopeCharsPerPiece))
+        return true;
+    
+    // Native strings can only hold unicode chars which map to native, anything
+    // else requires unnativizing which only the direct edit does.
+    if (t_native && !p_native)
+    {
+        char_t t_char;
+        for(uindex_t i = 0; i < p_char_count; i++)
+            if (!MCUnicodeCharMapToNative(((const unichar_t *)p_chars)[i], t_char))
+                return true;
     }
     
-    self -> char_count = 0;
-    self -> chars = nil;
-    self -> native_chars = nil;
-    self -> string = MCValueRetain(t_string);
-    self -> flags |= kMCStringFlagIsIndirect;
+    if (!__MCStringIsRope(self) &&
+        !__MCStringMakeRope(self))
+        return false;
     
-    r_new_string = t_string;
+    if (!__MCStringUnshareRope(self))
+        return false;
+    
+    if (!__MCStringRopeReplace(self -> rope, p_range, p_chars, p_char_count, p_native))
+        return false;
+    
+    r_edited = true;
     return true;
 }
@@ -18,8 +18,328 @@
 #include "foundation-private.h"
 #include "foundation-auto.h"
 
+#include <float.h>
+#include <stdio.h>
+#include <stdlib.h>
+
 #define R8L 384
 
+////////////////////////////////////////////////////////////////////////////////
+
+/* The exactly representable powers of ten. */
+static const real64_t kMCTypeConvertRealPowersOfTen[] =
+{
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+};
+
+static const uint64_t kMCTypeConvertIntegerPowersOfTen[] =
+{
+    1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL, 1000000ULL,
+    10000000ULL, 100000000ULL, 1000000000ULL, 10000000000ULL,
+    100000000000ULL, 1000000000000ULL, 10000000000000ULL,
+    100000000000000ULL, 1000000000000000ULL, 10000000000000000ULL,
+    100000000000000000ULL, 1000000000000000000ULL,
+    10000000000000000000ULL,
+};
+
+/* Compute the full 128-bit product of two 64-bit values. */
+static inline void
+__MCTypeConvertMultiply(uint64_t p_left, uint64_t p_right,
+                        uint64_t& r_high, uint64_t& r_low)
+{
+    uint64_t t_left_low = uint32_t(p_left), t_left_high = p_left >> 32;
+    uint64_t t_right_low = uint32_t(p_right), t_right_high = p_right >> 32;
+
+    uint64_t t_low_low = t_left_low * t_right_low;
+    uint64_t t_low_high = t_left_low * t_right_high;
+    uint64_t t_high_low = t_left_high * t_right_low;
+    uint64_t t_high_high = t_left_high * t_right_high;
+
+    uint64_t t_middle = (t_low_low >> 32) + uint32_t(t_low_high) + uint32_t(t_high_low);
+
+    r_low = (t_middle << 32) | uint32_t(t_low_low);
+    r_high = t_high_high + (t_low_high >> 32) + (t_high_low >> 32) + (t_middle >> 32);
+}
+
+/* Compute |p_real| * 10^p_precision rounded to the nearest integer (ties to
+ * even), exactly as the C library does when printing with '%.*f'. The real is
+ * decomposed as m * 2^e and the scaling done in 128-bit integer arithmetic,
+ * so the result is exact. Returns false if the result does not fit in 64
+ * bits, in which case the caller must fall back to the C library. */
+static bool
+__MCTypeConvertRealToScaledInteger(real64_t p_real, uindex_t p_precision,
+                                   uint64_t& r_scaled)
+{
+    if (p_precision >= sizeof(kMCTypeConvertIntegerPowersOfTen) / sizeof(uint64_t))
+        return false;
+
+    uint64_t t_bits;
+    MCMemoryCopy(&t_bits, &p_real, sizeof(t_bits));
+
+    uint32_t t_biased_exponent = uint32_t(t_bits >> 52) & 0x7ff;
+    uint64_t t_mantissa = t_bits & ((uint64_t(1) << 52) - 1);
+    if (t_biased_exponent == 0x7ff)
+        return false;
+
+    int32_t t_exponent;
+    if (t_biased_exponent == 0)
+        t_exponent = -1074;
+    else
+    {
+        t_mantissa |= uint64_t(1) << 52;
+        t_exponent = int32_t(t_biased_exponent) - 1075;
+    }
+
+    if (t_mantissa == 0)
+    {
+        r_scaled = 0;
+        return true;
+    }
+
+    uint64_t t_high, t_low;
+    __MCTypeConvertMultiply(t_mantissa, kMCTypeConvertIntegerPowersOfTen[p_precision],
+                            t_high, t_low);
+
+    /* An integral value - the result is the product shifted up, providing
+     * it fits. */
+    if (t_exponent >= 0)
+    {
+        if (t_high != 0 || t_exponent >= 64 ||
+            (t_exponent > 0 && (t_low >> (64 - t_exponent)) != 0))
+            return false;
+        r_scaled = t_low << t_exponent;
+        return true;
+    }
+
+    /* The product is less than 2^128, so if the shift is more than 128 bits
+     * it is less than half and rounds to zero. */
+    uint32_t t_shift = uint32_t(-t_exponent);
+    if (t_shift > 128)
+    {
+        r_scaled = 0;
+        return true;
+    }
+
+    uint64_t t_quotient;
+    if (t_shift < 64)
+    {
+        if ((t_high >> t_shift) != 0)
+            return false;
+        t_quotient = (t_low >> t_shift) | (t_high << (64 - t_shift));
+    }
+    else if (t_shift < 128)
+        t_quotient = t_high >> (t_shift - 64);
+    else
+        t_quotient = 0;
+
+    /* Round half to even based on the bit below the quotient and the bits
+     * below that. */
+    uint32_t t_round_index = t_shift - 1;
+    bool t_round_bit, t_sticky;
+    if (t_round_index < 64)
+    {
+        t_round_bit = ((t_low >> t_round_index) & 1) != 0;
+        t_sticky = (t_low & ((uint64_t(1) << t_round_index) - 1)) != 0;
+    }
+    else
+    {
+        t_round_bit = ((t_high >> (t_round_index - 64)) & 1) != 0;
+        t_sticky = t_low != 0 ||
+            (t_high & ((uint64_t(1) << (t_round_index - 64)) - 1)) != 0;
+    }
+
+    if (t_round_bit && (t_sticky || (t_quotient & 1) != 0))
+    {
+        if (t_quotient == UINT64_MAX)
+            return false;
+        t_quotient += 1;
+    }
+
+    r_scaled = t_quotient;
+    return true;
+}
+
+MC_DLLEXPORT_DEF
+size_t MCTypeConvertRealToFixedCString(real64_t p_real,
+                                       uindex_t p_width,
+                                       uindex_t p_precision,
+                                       char *r_buffer,
+                                       size_t p_buffer_size)
+{
+    uint64_t t_scaled;
+    if (!__MCTypeConvertRealToScaledInteger(p_real, p_precision, t_scaled))
+        return snprintf(r_buffer, p_buffer_size, "%0*.*f", int(p_width), int(p_precision), p_real);
+
+    uint64_t t_integer = t_scaled / kMCTypeConvertIntegerPowersOfTen[p_precision];
+    uint64_t t_fraction = t_scaled % kMCTypeConvertIntegerPowersOfTen[p_precision];
+
+    /* Generate the integer digits in reverse. */
+    char t_integer_digits[20];
+    size_t t_integer_length = 0;
+    do
+    {
+        t_integer_digits[t_integer_length++] = char('0' + t_integer % 10);
+        t_integer /= 10;
+    }
+    while (t_integer != 0);
+
+    bool t_negative = signbit(p_real) != 0;
+    size_t t_length = (t_negative ? 1 : 0) + t_integer_length +
+        (p_precision != 0 ? 1 + p_precision : 0);
+    size_t t_padding = p_width > t_length ? p_width - t_length : 0;
+    t_length += t_padding;
+
+    if (t_length >= p_buffer_size)
+        return snprintf(r_buffer, p_buffer_size, "%0*.*f", int(p_width), int(p_precision), p_real);
+
+    char *t_chars = r_buffer;
+    if (t_negative)
+        *t_chars++ = '-';
+    for (size_t i = 0; i < t_padding; i++)
+        *t_chars++ = '0';
+    while (t_integer_length != 0)
+        *t_chars++ = t_integer_digits[--t_integer_length];
+    if (p_precision != 0)
+    {
+        *t_chars++ = '.';
+        for (uindex_t i = p_precision; i != 0; i--)
+        {
+            t_chars[i - 1] = char('0' + t_fraction % 10);
+            t_fraction /= 10;
+        }
+        t_chars += p_precision;
+    }
+    *t_chars = '\0';
+
+    return t_length;
+}
+
+/* Parse a decimal number of at most 19 significant digits whose value can be
+ * computed with a single correctly rounded multiplication or division (the
+ * Clinger fast path). Returns false if the string is in any other form, in
+ * which case the caller must fall back to strtod(). */
+static bool
+__MCTypeConvertCStringToRealFast(const char *p_cstring,
+                                 real64_t& r_real,
+                                 const char*& r_end)
+{
+#if defined(FLT_EVAL_METHOD) && FLT_EVAL_METHOD == 0
+    const char *t_chars = p_cstring;
+    while (isspace(uint8_t(*t_chars)))
+        t_chars++;
+
+    bool t_negative = false;
+    if (*t_chars == '-' || *t_chars == '+')
+        t_negative = *t_chars++ == '-';
+
+    /* Hexadecimal forms are left to the C library. */
+    if (t_chars[0] == '0' && (t_chars[1] == 'x' || t_chars[1] == 'X'))
+        return false;
+
+    uint64_t t_mantissa = 0;
+    uindex_t t_digit_count = 0;
+    uindex_t t_significant_count = 0;
+    int32_t t_exponent = 0;
+
+    for (; isdigit(uint8_t(*t_chars)); t_chars++, t_digit_count++)
+    {
+        if (t_significant_count == 0 && *t_chars == '0')
+            continue;
+        if (++t_significant_count > 19)
+            return false;
+        t_mantissa = t_mantissa * 10 + (*t_chars - '0');
+    }
+
+    if (*t_chars == '.')
+    {
+        for (t_chars++; isdigit(uint8_t(*t_chars)); t_chars++, t_digit_count++)
+        {
+            t_exponent -= 1;
+            if (t_significant_count == 0 && *t_chars == '0')
+                continue;
+            if (++t_significant_count > 19)
+                return false;
+            t_mantissa = t_mantissa * 10 + (*t_chars - '0');
+        }
+    }
+
+    /* No digits means 'inf', 'nan' or not a number at all. */
+    if (t_digit_count == 0)
+        return false;
+
+    /* An exponent is only consumed if it has at least one digit. */
+    if (*t_chars == 'e' || *t_chars == 'E')
+    {
+        const char *t_exponent_chars = t_chars + 1;
+        bool t_exponent_negative = false;
+        if (*t_exponent_chars == '-' || *t_exponent_chars == '+')
+            t_exponent_negative = *t_exponent_chars++ == '-';
+
+        if (isdigit(uint8_t(*t_exponent_chars)))
+        {
+            int32_t t_explicit_exponent = 0;
+            for (; isdigit(uint8_t(*t_exponent_chars)); t_exponent_chars++)
+                if (t_explicit_exponent < 100000)
+                    t_explicit_exponent = t_explicit_exponent * 10 + (*t_exponent_chars - '0');
+            t_exponent += t_exponent_negative ? -t_explicit_exponent : t_explicit_exponent;
+            t_chars = t_exponent_chars;
+        }
+    }
+
+    real64_t t_real;
+    if (t_mantissa == 0)
+        t_real = 0.0;
+    else
+    {
+        const uint64_t kMaxExactMantissa = uint64_t(1) << 53;
+        if (t_mantissa > kMaxExactMantissa)
+            return false;
+
+        /* Large exponents can be used if the excess can be folded into the
+         * mantissa without losing exactness. */
+        if (t_exponent > 22 && t_exponent <= 22 + 15)
+        {
+            uint64_t t_power = kMCTypeConvertIntegerPowersOfTen[t_exponent - 22];
+            if (t_mantissa > kMaxExactMantissa / t_power)
+                return false;
+            t_mantissa *= t_power;
+            t_exponent = 22;
+        }
+
+        if (t_exponent < -22 || t_exponent > 22)
+            return false;
+
+        t_real = real64_t(t_mantissa);
+        if (t_exponent < 0)
+            t_real /= kMCTypeConvertRealPowersOfTen[-t_exponent];
+        else
+            t_real *= kMCTypeConvertRealPowersOfTen[t_exponent];
+    }
+
+    r_real = t_negative ? -t_real : t_real;
+    r_end = t_chars;
+    return true;
+#else
+    return false;
+#endif
+}
+
+MC_DLLEXPORT_DEF
+real64_t MCTypeConvertCStringToReal(const char *p_cstring, const char*& r_end)
+{
+    real64_t t_real;
+    if (__MCTypeConvertCStringToRealFast(p_cstring, t_real, r_end))
+        return t_real;
+
+    char *t_end = nil;
+    t_real = strtod(p_cstring, &t_end);
+    r_end = t_end;
+    return t_real;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 static MCSpan<const char>::const_iterator
 skip_spaces(MCSpan<const char>::const_iterator p_start,
             MCSpan<const char>::const_iterator p_end)
@@ -202,8 +522,8 @@ static real64_t MCU_strtor8(MCSpan<const char> p_chars,
 	memcpy(t_buff, p_chars.data(), p_chars.size());
 	t_buff[p_chars.size()] = '\0';
 
-	char *t_end = nil;
-	real64_t t_value = strtod(t_buff, &t_end);
+	const char *t_end = nil;
+	real64_t t_value = MCTypeConvertCStringToReal(t_buff, t_end);
 	if (t_end == t_buff)
 		return 0;
 
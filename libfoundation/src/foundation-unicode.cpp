@@ -30,6 +30,8 @@
 #include "foundation-string-hash.h"
 
 #include <limits>
+#include <atomic>
+#include <mutex>
 
 
 // This array converts from the MCUnicodeProperty enumeration to the corresponding
@@ -164,9 +166,11 @@ bool __MCUnicodeInitialize()
     return t_success;
 }
 
+static void __MCUnicodeFastFindFinalize(void);
+
 void __MCUnicodeFinalize()
 {
-    ;
+    __MCUnicodeFastFindFinalize();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -955,6 +959,496 @@ bool MCUnicodeEndsWith(const void *p_first, uindex_t p_first_length, bool p_firs
     return true;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+
+// The searches below are defined in terms of the text filter chains, which
+// decode, fold and normalize one codepoint at a time. That is general but
+// slow, so searches of a UTF-16 string first try a fast tier which works
+// directly on code units, and which applies when the filters cannot affect
+// the outcome:
+//
+//   - exact: the needle does not begin or end with half of a surrogate pair,
+//     so code unit equality is codepoint equality.
+//   - folded: the needle has no surrogates, so each code unit can be folded
+//     on its own (no supplementary char folds into the BMP).
+//   - normalized and caseless: also, every code unit of the needle and of the
+//     compared range of the string (including the unit after it) is 'simple'
+//     - it starts a normalization run on its own and NFC leaves it (and its
+//     folding) unchanged.
+//
+// Positions of the string whose compared range contains a unit which is not
+// simple are either checked with the filters, or the whole search falls
+// back to them.
+
+// Needles longer than this are always searched for with the filters.
+#define __MCUNICODE_FASTFIND_MAX_NEEDLE 256
+
+#if defined(__X86_64__) && (defined(__GNUC__) || defined(_MSC_VER))
+#define __MCUNICODE_FASTFIND_SIMD 1
+#include <emmintrin.h>
+#endif
+
+// The simple case folding of each BMP code unit is stored as a difference,
+// in a page for each 256 units. Pages with no folding share the zero page.
+static int16_t s_fastfind_zero_page[256];
+static int16_t *s_fastfind_fold_pages[256];
+
+// A bit for each BMP code unit which is simple.
+static uint8_t s_fastfind_simple[65536 / 8];
+
+// The tables are built on first use, which may be on any thread when
+// threading is enabled, so they are built under the lock and are only read
+// once the flag is seen to be set.
+static std::atomic<bool> s_fastfind_initialized(false);
+static std::mutex s_fastfind_lock;
+
+static bool __MCUnicodeFastFindInitialize(void)
+{
+    if (s_fastfind_initialized . load(std::memory_order_acquire))
+        return true;
+    
+    std::lock_guard<std::mutex> t_guard(s_fastfind_lock);
+    if (s_fastfind_initialized . load(std::memory_order_relaxed))
+        return true;
+    
+    for(uindex_t t_page = 0; t_page < 256; t_page++)
+    {
+        int16_t t_deltas[256];
+        bool t_folds;
+        t_folds = false;
+        for(uindex_t i = 0; i < 256; i++)
+        {
+            codepoint_t t_unit, t_folded;
+            t_unit = (t_page << 8) | i;
+            t_folded = MCUnicodeGetCharacterProperty(t_unit, kMCUnicodePropertySimpleCaseFolding);
+            
+            // Surrogates and supplementary chars never fold to one another.
+            if (t_folded > 0xffff)
+                t_folded = t_unit;
+            
+            t_deltas[i] = int16_t(t_folded - t_unit);
+            if (t_deltas[i] != 0)
+                t_folds = true;
+        }
+        
+        s_fastfind_fold_pages[t_page] = s_fastfind_zero_page;
+        if (t_folds &&
+            MCMemoryNewArray(256, s_fastfind_fold_pages[t_page]))
+            MCMemoryCopy(s_fastfind_fold_pages[t_page], t_deltas, sizeof(t_deltas));
+        else if (t_folds)
+        {
+            __MCUnicodeFastFindFinalize();
+            return false;
+        }
+    }
+    
+    for(codepoint_t t_unit = 0; t_unit < 0x10000; t_unit++)
+    {
+        codepoint_t t_folded;
+        t_folded = t_unit + s_fastfind_fold_pages[t_unit >> 8][t_unit & 0xff];
+        
+        bool t_simple;
+        t_simple = true;
+        for(int i = 0; i < 2 && t_simple; i++)
+        {
+            codepoint_t t_cp;
+            t_cp = i == 0 ? t_unit : t_folded;
+            t_simple = (MCUnicodeGetBinaryProperty(t_cp, kMCUnicodePropertyGraphemeBase) ||
+                        MCUnicodeGetBinaryProperty(t_cp, kMCUnicodePropertyWhiteSpace)) &&
+                        u_getIntPropertyValue(t_cp, UCHAR_NFC_QUICK_CHECK) == UNORM_YES &&
+                        u_getCombiningClass(t_cp) == 0;
+        }
+        
+        if (t_simple)
+            s_fastfind_simple[t_unit >> 3] |= 1 << (t_unit & 7);
+    }
+    
+    s_fastfind_initialized . store(true, std::memory_order_release);
+    return true;
+}
+
+static void __MCUnicodeFastFindFinalize(void)
+{
+    for(uindex_t t_page = 0; t_page < 256; t_page++)
+    {
+        if (s_fastfind_fold_pages[t_page] != s_fastfind_zero_page)
+            MCMemoryDeleteArray(s_fastfind_fold_pages[t_page]);
+        s_fastfind_fold_pages[t_page] = nil;
+    }
+    
+    MCMemoryClear(s_fastfind_simple, sizeof(s_fastfind_simple));
+    s_fastfind_initialized . store(false, std::memory_order_relaxed);
+}
+
+static inline unichar_t __MCUnicodeFastFindFold(unichar_t p_unit)
+{
+    return unichar_t(p_unit + s_fastfind_fold_pages[p_unit >> 8][p_unit & 0xff]);
+}
+
+static inline bool __MCUnicodeFastFindIsSimple(unichar_t p_unit)
+{
+    return (s_fastfind_simple[p_unit >> 3] & (1 << (p_unit & 7))) != 0;
+}
+
+struct __MCUnicodeFastFindNeedle
+{
+    // The needle as given, for checking positions with the filters.
+    const void *needle;
+    uindex_t needle_length;
+    bool needle_native;
+    MCUnicodeCompareOption option;
+    
+    // Whether code units are folded and/or must be simple to be compared.
+    bool fold;
+    bool normalize;
+    
+    // The needle's code units, folded if required.
+    unichar_t chars[__MCUNICODE_FASTFIND_MAX_NEEDLE];
+    uindex_t length;
+};
+
+// Prepare the needle for the fast tier, returning false if it can only be
+// searched for with the filters.
+static bool __MCUnicodeFastFindPrepare(const void *p_needle, uindex_t p_needle_length, bool p_needle_native, MCUnicodeCompareOption p_option, __MCUnicodeFastFindNeedle& r_needle)
+{
+    if (p_needle_length == 0 ||
+        p_needle_length > __MCUNICODE_FASTFIND_MAX_NEEDLE)
+        return false;
+    
+    r_needle . needle = p_needle;
+    r_needle . needle_length = p_needle_length;
+    r_needle . needle_native = p_needle_native;
+    r_needle . option = p_option;
+    r_needle . fold = p_option == kMCUnicodeCompareOptionFolded || p_option == kMCUnicodeCompareOptionCaseless;
+    r_needle . normalize = p_option == kMCUnicodeCompareOptionNormalised || p_option == kMCUnicodeCompareOptionCaseless;
+    r_needle . length = p_needle_length;
+    
+    if ((r_needle . fold || r_needle . normalize) &&
+        !__MCUnicodeFastFindInitialize())
+        return false;
+    
+    for(uindex_t i = 0; i < p_needle_length; i++)
+    {
+        unichar_t t_unit;
+        if (p_needle_native)
+            t_unit = MCUnicodeMapFromNative(static_cast<const char_t *>(p_needle)[i]);
+        else
+            t_unit = static_cast<const unichar_t *>(p_needle)[i];
+        
+        if (r_needle . normalize && !__MCUnicodeFastFindIsSimple(t_unit))
+            return false;
+        
+        if (r_needle . fold &&
+            (MCUnicodeCodepointIsHighSurrogate(t_unit) || MCUnicodeCodepointIsLowSurrogate(t_unit)))
+            return false;
+        
+        r_needle . chars[i] = r_needle . fold ? __MCUnicodeFastFindFold(t_unit) : t_unit;
+    }
+    
+    if (MCUnicodeCodepointIsLowSurrogate(r_needle . chars[0]) ||
+        MCUnicodeCodepointIsHighSurrogate(r_needle . chars[p_needle_length - 1]))
+        return false;
+    
+    return true;
+}
+
+#if defined(__MCUNICODE_FASTFIND_SIMD)
+
+// Returns a vector with 0xffff in each unit of 'p_units' which is in
+// [p_low, p_low + p_count).
+static inline __m128i __MCUnicodeFastFindInRange(__m128i p_units, uint16_t p_low, uint16_t p_count)
+{
+    // There are no unsigned 16-bit comparisons, so bias into signed range.
+    __m128i t_bias;
+    t_bias = _mm_set1_epi16(int16_t(0x8000));
+    return _mm_cmplt_epi16(_mm_xor_si128(_mm_sub_epi16(p_units, _mm_set1_epi16(int16_t(p_low))), t_bias),
+                           _mm_set1_epi16(int16_t(p_count ^ 0x8000)));
+}
+
+// Printable ASCII chars and the ASCII whitespace controls are simple.
+static inline __m128i __MCUnicodeFastFindIsPlain(__m128i p_units)
+{
+    return _mm_or_si128(__MCUnicodeFastFindInRange(p_units, 0x20, 0x5f),
+                        __MCUnicodeFastFindInRange(p_units, 0x09, 0x05));
+}
+
+// Returns a vector with 0xffff in each unit of 'p_units' which could match
+// 'p_needle_unit'.
+static inline __m128i __MCUnicodeFastFindMatch(__m128i p_units, unichar_t p_needle_unit, bool p_fold)
+{
+    if (!p_fold)
+        return _mm_cmpeq_epi16(p_units, _mm_set1_epi16(int16_t(p_needle_unit)));
+    
+    // Only the ASCII upper-case letters fold to other ASCII chars, anything
+    // else which is not plain is a candidate to be folded individually.
+    __m128i t_folded;
+    t_folded = _mm_add_epi16(p_units, _mm_and_si128(__MCUnicodeFastFindInRange(p_units, 'A', 26),
+                                                    _mm_set1_epi16(0x20)));
+    return _mm_or_si128(_mm_cmpeq_epi16(t_folded, _mm_set1_epi16(int16_t(p_needle_unit))),
+                        _mm_andnot_si128(__MCUnicodeFastFindIsPlain(p_units), _mm_set1_epi16(-1)));
+}
+
+// Returns a mask with bit 2 * i set if the needle could start at 'p_chars + i',
+// based on its first and last code units.
+static inline uint32_t __MCUnicodeFastFindCandidates(const __MCUnicodeFastFindNeedle& p_needle, const unichar_t *p_chars)
+{
+    __m128i t_first, t_last;
+    t_first = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p_chars));
+    t_last = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p_chars + p_needle . length - 1));
+    return _mm_movemask_epi8(_mm_and_si128(__MCUnicodeFastFindMatch(t_first, p_needle . chars[0], p_needle . fold),
+                                           __MCUnicodeFastFindMatch(t_last, p_needle . chars[p_needle . length - 1], p_needle . fold))) & 0x5555;
+}
+
+static inline uindex_t __MCUnicodeFastFindLowestBit(uint32_t p_mask)
+{
+#if defined(_MSC_VER)
+    unsigned long t_index;
+    _BitScanForward(&t_index, p_mask);
+    return t_index;
+#else
+    return __builtin_ctz(p_mask);
+#endif
+}
+
+static inline uindex_t __MCUnicodeFastFindHighestBit(uint32_t p_mask)
+{
+#if defined(_MSC_VER)
+    unsigned long t_index;
+    _BitScanReverse(&t_index, p_mask);
+    return t_index;
+#else
+    return 31 - __builtin_clz(p_mask);
+#endif
+}
+
+#endif
+
+// Returns the index of the first unit in [p_from, p_to) which is not simple,
+// or UINDEX_MAX if there is none.
+static uindex_t __MCUnicodeFastFindNextIrregular(const unichar_t *p_chars, uindex_t p_from, uindex_t p_to)
+{
+    uindex_t t_index;
+    t_index = p_from;
+#if defined(__MCUNICODE_FASTFIND_SIMD)
+    for(; t_index + 8 <= p_to; t_index += 8)
+    {
+        __m128i t_units;
+        t_units = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p_chars + t_index));
+        if (_mm_movemask_epi8(__MCUnicodeFastFindIsPlain(t_units)) == 0xffff)
+            continue;
+        
+        for(uindex_t i = 0; i < 8; i++)
+            if (!__MCUnicodeFastFindIsSimple(p_chars[t_index + i]))
+                return t_index + i;
+    }
+#endif
+    for(; t_index < p_to; t_index++)
+        if (!__MCUnicodeFastFindIsSimple(p_chars[t_index]))
+            return t_index;
+    
+    return UINDEX_MAX;
+}
+
+// Returns the index of the last unit in [0, p_to) which is not simple, or
+// UINDEX_MAX if there is none.
+static uindex_t __MCUnicodeFastFindPreviousIrregular(const unichar_t *p_chars, uindex_t p_to)
+{
+    uindex_t t_index;
+    t_index = p_to;
+#if defined(__MCUNICODE_FASTFIND_SIMD)
+    for(; t_index >= 8; t_index -= 8)
+    {
+        __m128i t_units;
+        t_units = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p_chars + t_index - 8));
+        if (_mm_movemask_epi8(__MCUnicodeFastFindIsPlain(t_units)) == 0xffff)
+            continue;
+        
+        for(uindex_t i = 1; i <= 8; i++)
+            if (!__MCUnicodeFastFindIsSimple(p_chars[t_index - i]))
+                return t_index - i;
+    }
+#endif
+    for(; t_index > 0; t_index--)
+        if (!__MCUnicodeFastFindIsSimple(p_chars[t_index - 1]))
+            return t_index - 1;
+    
+    return UINDEX_MAX;
+}
+
+// Returns true if the needle's code units are at 'p_chars'.
+static inline bool __MCUnicodeFastFindEqual(const __MCUnicodeFastFindNeedle& p_needle, const unichar_t *p_chars)
+{
+    if (!p_needle . fold)
+        return MCMemoryCompare(p_chars, p_needle . chars, p_needle . length * sizeof(unichar_t)) == 0;
+    
+    for(uindex_t i = 0; i < p_needle . length; i++)
+        if (__MCUnicodeFastFindFold(p_chars[i]) != p_needle . chars[i])
+            return false;
+    
+    return true;
+}
+
+// Search for the first position in [p_from, p_to) at which the needle's
+// code units are found.
+static bool __MCUnicodeFastFindScanForward(const __MCUnicodeFastFindNeedle& p_needle, const unichar_t *p_chars, uindex_t p_from, uindex_t p_to, uindex_t& r_index)
+{
+    uindex_t t_index;
+    t_index = p_from;
+#if defined(__MCUNICODE_FASTFIND_SIMD)
+    for(; t_index + 8 <= p_to; t_index += 8)
+    {
+        for(uint32_t t_candidates = __MCUnicodeFastFindCandidates(p_needle, p_chars + t_index); t_candidates != 0; t_candidates &= t_candidates - 1)
+        {
+            uindex_t t_candidate;
+            t_candidate = t_index + __MCUnicodeFastFindLowestBit(t_candidates) / 2;
+            if (__MCUnicodeFastFindEqual(p_needle, p_chars + t_candidate))
+            {
+                r_index = t_candidate;
+                return true;
+            }
+        }
+    }
+#endif
+    for(; t_index < p_to; t_index++)
+        if (__MCUnicodeFastFindEqual(p_needle, p_chars + t_index))
+        {
+            r_index = t_index;
+            return true;
+        }
+    
+    return false;
+}
+
+// Search for the last position in [p_from, p_to) at which the needle's
+// code units are found.
+static bool __MCUnicodeFastFindScanReverse(const __MCUnicodeFastFindNeedle& p_needle, const unichar_t *p_chars, uindex_t p_from, uindex_t p_to, uindex_t& r_index)
+{
+    uindex_t t_index;
+    t_index = p_to;
+#if defined(__MCUNICODE_FASTFIND_SIMD)
+    for(; t_index >= p_from + 8; t_index -= 8)
+    {
+        for(uint32_t t_candidates = __MCUnicodeFastFindCandidates(p_needle, p_chars + t_index - 8); t_candidates != 0; t_candidates &= ~(1U << __MCUnicodeFastFindHighestBit(t_candidates)))
+        {
+            uindex_t t_candidate;
+            t_candidate = t_index - 8 + __MCUnicodeFastFindHighestBit(t_candidates) / 2;
+            if (__MCUnicodeFastFindEqual(p_needle, p_chars + t_candidate))
+            {
+                r_index = t_candidate;
+                return true;
+            }
+        }
+    }
+#endif
+    for(; t_index > p_from; t_index--)
+        if (__MCUnicodeFastFindEqual(p_needle, p_chars + t_index - 1))
+        {
+            r_index = t_index - 1;
+            return true;
+        }
+    
+    return false;
+}
+
+// Search forward for the needle in the UTF-16 string. If 'p_check_irregular'
+// is true, positions the fast tier cannot decide are checked with the
+// filters, otherwise false is returned so the whole search can be done with
+// them. On success, r_found indicates whether there was a match.
+static bool __MCUnicodeFastFindForward(const __MCUnicodeFastFindNeedle& p_needle, const unichar_t *p_chars, uindex_t p_length, bool p_check_irregular, bool& r_found, MCRange& r_range)
+{
+    r_found = false;
+    if (p_needle . length > p_length)
+        return true;
+    
+    // The number of positions at which the needle could start.
+    uindex_t t_limit;
+    t_limit = p_length - p_needle . length + 1;
+    
+    uindex_t t_irregular;
+    t_irregular = UINDEX_MAX;
+    if (p_needle . normalize)
+        t_irregular = __MCUnicodeFastFindNextIrregular(p_chars, 0, p_length);
+    
+    uindex_t t_index;
+    t_index = 0;
+    while(t_index < t_limit)
+    {
+        // Positions whose compared range includes the irregular unit.
+        if (t_irregular != UINDEX_MAX &&
+            t_index + p_needle . length >= t_irregular)
+        {
+            if (!p_check_irregular)
+                return false;
+            
+            uindex_t t_string_length, t_needle_length;
+            MCUnicodeSharedPrefix(p_chars + t_index, p_length - t_index, false, p_needle . needle, p_needle . needle_length, p_needle . needle_native, p_needle . option, t_string_length, t_needle_length);
+            if (t_needle_length == p_needle . needle_length)
+            {
+                r_found = true;
+                r_range = MCRangeMake(t_index, t_string_length);
+                return true;
+            }
+            
+            if (t_index == t_irregular)
+                t_irregular = __MCUnicodeFastFindNextIrregular(p_chars, t_index + 1, p_length);
+            
+            t_index++;
+            continue;
+        }
+        
+        uindex_t t_to;
+        t_to = t_limit;
+        if (t_irregular != UINDEX_MAX)
+            t_to = MCMin(t_to, t_irregular - p_needle . length);
+        
+        uindex_t t_found;
+        if (__MCUnicodeFastFindScanForward(p_needle, p_chars, t_index, t_to, t_found))
+        {
+            r_found = true;
+            r_range = MCRangeMake(t_found, p_needle . length);
+            return true;
+        }
+        
+        t_index = t_to;
+    }
+    
+    return true;
+}
+
+// Search backward for the needle in the UTF-16 string. Returns false if the
+// search must be done with the filters, otherwise r_found indicates whether
+// there was a match.
+static bool __MCUnicodeFastFindReverse(const __MCUnicodeFastFindNeedle& p_needle, const unichar_t *p_chars, uindex_t p_length, bool& r_found, uindex_t& r_index)
+{
+    r_found = false;
+    if (p_needle . length > p_length)
+        return true;
+    
+    uindex_t t_limit;
+    t_limit = p_length - p_needle . length + 1;
+    
+    // Only the positions after the last irregular unit can be searched.
+    uindex_t t_from;
+    t_from = 0;
+    if (p_needle . normalize)
+    {
+        uindex_t t_irregular;
+        t_irregular = __MCUnicodeFastFindPreviousIrregular(p_chars, p_length);
+        if (t_irregular != UINDEX_MAX)
+            t_from = MCMin(t_limit, t_irregular + 1);
+    }
+    
+    if (__MCUnicodeFastFindScanReverse(p_needle, p_chars, t_from, t_limit, r_index))
+    {
+        r_found = true;
+        return true;
+    }
+    
+    return t_from == 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 bool MCUnicodeContains(const void *p_string, uindex_t p_string_length, bool p_string_native,
                        const void *p_needle, uindex_t p_needle_length, bool p_needle_native,
                        MCUnicodeCompareOption p_option)
@@ -995,6 +1489,21 @@ bool MCUnicodeFirstIndexOf(const void *p_string, uindex_t p_string_length, bool
 		}
 	}
     
+    // Try the fast tier, which only applies to UTF-16 strings
+    __MCUnicodeFastFindNeedle t_fast_needle;
+    if (!p_string_native &&
+        __MCUnicodeFastFindPrepare(p_needle, p_needle_length, p_needle_native, p_option, t_fast_needle))
+    {
+        bool t_found;
+        MCRange t_range;
+        if (__MCUnicodeFastFindForward(t_fast_needle, (const unichar_t *)p_string, p_string_length, false, t_found, t_range))
+        {
+            if (t_found)
+                r_index = t_range . offset;
+            return t_found;
+        }
+    }
+    
     // Create filter chains for the strings being searched
 	MCAutoPointer<MCTextFilter> t_string_filter =
 			MCTextFilterCreate(p_string, p_string_length, p_string_native ? kMCStringEncodingNative : kMCStringEncodingUTF16, p_option);
@@ -1046,6 +1555,16 @@ bool MCUnicodeLastIndexOf(const void *p_string, uindex_t p_string_length, bool p
         return MCUnicodeLastIndexOfChar((const unichar_t *)p_string, p_string_length, *(codepoint_t *)p_needle, p_option, r_index);
     }
     
+    // Try the fast tier, which only applies to UTF-16 strings
+    __MCUnicodeFastFindNeedle t_fast_needle;
+    if (!p_string_native &&
+        __MCUnicodeFastFindPrepare(p_needle, p_needle_length, p_needle_native, p_option, t_fast_needle))
+    {
+        bool t_found;
+        if (__MCUnicodeFastFindReverse(t_fast_needle, (const unichar_t *)p_string, p_string_length, t_found, r_index))
+            return t_found;
+    }
+    
     // Create filter chains for the strings being searched
 	MCAutoPointer<MCTextFilter> t_string_filter =
 			MCTextFilterCreate(p_string, p_string_length, p_string_native ? kMCStringEncodingNative : kMCStringEncodingUTF16, p_option, true);
@@ -1248,6 +1767,16 @@ bool MCUnicodeFind(const void *p_string, uindex_t p_string_length, bool p_string
     if (p_string_length == 0 || p_needle_length == 0)
         return false;
     
+    // Try the fast tier, which only applies to UTF-16 strings
+    __MCUnicodeFastFindNeedle t_fast_needle;
+    if (!p_string_native &&
+        __MCUnicodeFastFindPrepare(p_needle, p_needle_length, p_needle_native, p_option, t_fast_needle))
+    {
+        bool t_found;
+        if (__MCUnicodeFastFindForward(t_fast_needle, (const unichar_t *)p_string, p_string_length, true, t_found, r_matched_range))
+            return t_found;
+    }
+    
     // Attempt a match at each position within the string
     uindex_t t_offset = 0;
     while (t_offset < p_string_length)
@@ -1269,8 +1798,65 @@ bool MCUnicodeFind(const void *p_string, uindex_t p_string_length, bool p_string
     return false;
 }
 
+// Hash the code units of the string directly, a word at a time, lowering
+// ASCII letters if 'fold' is true. Unless 'exact' is true this fails if any
+// unit is not ASCII, as folding and normalization can change other units.
+static bool __MCUnicodeHashUnits(const unichar_t *p_string, uindex_t p_string_length, bool p_exact, bool p_fold, hash_t& r_hash)
+{
+    static const uint64_t kNonAscii = 0xFF80FF80FF80FF80ULL;
+
+    MCHashCharsContext t_context;
+    while (p_string_length > 0)
+    {
+        uint64_t t_units;
+        uindex_t t_unit_count;
+        if (p_string_length >= 4)
+        {
+            t_units = MCHashCharsContext::load(p_string);
+            t_unit_count = 4;
+        }
+        else
+        {
+            t_units = 0;
+            for(uindex_t i = 0; i < p_string_length; i++)
+                t_units |= uint64_t(p_string[i]) << (i * 16);
+            t_unit_count = p_string_length;
+        }
+
+        if (!p_exact && (t_units & kNonAscii) != 0)
+            return false;
+
+        // As for native chars, the upper-case letters are those where adding
+        // 0x80 - 'A' sets the top bit of the low byte, but adding 0x80 - 'Z' - 1
+        // does not.
+        if (p_fold)
+            t_units |= (((t_units + 0x003F003F003F003FULL) ^
+                         (t_units + 0x0025002500250025ULL)) & 0x0080008000800080ULL) >> 2;
+
+        t_context.consume_word(t_units, t_unit_count);
+
+        p_string += t_unit_count;
+        p_string_length -= t_unit_count;
+    }
+
+    r_hash = t_context;
+    return true;
+}
+
 hash_t MCUnicodeHash(const unichar_t *p_string, uindex_t p_string_length, MCUnicodeCompareOption p_option)
 {
+    // Exact hashing decodes and re-encodes each codepoint, which leaves the
+    // code units unchanged. Folding and normalization leave ASCII unchanged
+    // (other than lowering letters), so if all the units are ASCII the filters
+    // can be skipped too.
+    hash_t t_hash;
+    if (__MCUnicodeHashUnits(p_string,
+                             p_string_length,
+                             p_option == kMCUnicodeCompareOptionExact,
+                             p_option == kMCUnicodeCompareOptionCaseless || p_option == kMCUnicodeCompareOptionFolded,
+                             t_hash))
+        return t_hash;
+
     // Create a filter for the string
     MCAutoPointer<MCTextFilter> t_filter =
 			MCTextFilterCreate(p_string, p_string_length, kMCStringEncodingUTF16, p_option);
@@ -1430,6 +2016,18 @@ bool MCUnicodeCreateSortKeyWithCollator(MCUnicodeCollatorRef p_collator,
     return true;
 }
 
+uindex_t MCUnicodeGetSortKeyWithCollator(MCUnicodeCollatorRef p_collator,
+                                         const unichar_t *p_string, uindex_t p_string_length,
+                                         byte_t *p_key, uindex_t p_key_capacity)
+{
+    icu::Collator* t_collator;
+    t_collator = (icu::Collator *)p_collator;
+    
+    // ICU returns the length of the full key, filling as much of the buffer as
+    // it can.
+    return (unsigned)t_collator->getSortKey(p_string, (signed)p_string_length, p_key, (signed)p_key_capacity);
+}
+
 int32_t MCUnicodeCollateWithCollator(MCUnicodeCollatorRef p_collator,
                                   const unichar_t *p_first, uindex_t p_first_length,
                                   const unichar_t *p_second, uindex_t p_second_length)
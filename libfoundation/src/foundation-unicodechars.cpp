@@ -171,6 +171,111 @@ void MCUnicodeCharsUppercase(unichar_t *p_chars, uindex_t p_char_count)
 */
 ////////////////////////////////////////////////////////////////////////////////
 
+// ASCII chars are the same in every native charset and in UTF-8 and UTF-16,
+// so the transcoders below copy runs of them with these helpers. On x86-64
+// they work sixteen bytes (or eight UTF-16 code units) at a time using SSE2,
+// which is always available there; elsewhere they test a word at a time.
+
+#if defined(__X86_64__) && (defined(__GNUC__) || defined(_MSC_VER))
+#define __UNICODECHARS_SSE2 1
+#include <emmintrin.h>
+#endif
+
+size_t __MCUnicodeAsciiLength(const byte_t *p_bytes, size_t p_count)
+{
+    size_t t_offset;
+    t_offset = 0;
+    
+#if defined(__UNICODECHARS_SSE2)
+    for(; t_offset + 16 <= p_count; t_offset += 16)
+        if (_mm_movemask_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(p_bytes + t_offset))) != 0)
+            break;
+#else
+    for(; t_offset + sizeof(uint64_t) <= p_count; t_offset += sizeof(uint64_t))
+    {
+        uint64_t t_word;
+        MCMemoryCopy(&t_word, p_bytes + t_offset, sizeof(t_word));
+        if ((t_word & UINT64_C(0x8080808080808080)) != 0)
+            break;
+    }
+#endif
+    
+    while (t_offset < p_count && p_bytes[t_offset] < 0x80)
+        t_offset++;
+    
+    return t_offset;
+}
+
+size_t __MCUnicodeAsciiLengthOfChars(const unichar_t *p_chars, size_t p_count)
+{
+    size_t t_offset;
+    t_offset = 0;
+    
+#if defined(__UNICODECHARS_SSE2)
+    const __m128i t_non_ascii = _mm_set1_epi16(short(0xff80));
+    for(; t_offset + 8 <= p_count; t_offset += 8)
+    {
+        __m128i t_chars;
+        t_chars = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p_chars + t_offset));
+        if (_mm_movemask_epi8(_mm_cmpeq_epi16(_mm_and_si128(t_chars, t_non_ascii), _mm_setzero_si128())) != 0xffff)
+            break;
+    }
+#else
+    for(; t_offset + 4 <= p_count; t_offset += 4)
+    {
+        uint64_t t_word;
+        MCMemoryCopy(&t_word, p_chars + t_offset, sizeof(t_word));
+        if ((t_word & UINT64_C(0xff80ff80ff80ff80)) != 0)
+            break;
+    }
+#endif
+    
+    while (t_offset < p_count && p_chars[t_offset] < 0x80)
+        t_offset++;
+    
+    return t_offset;
+}
+
+void __MCUnicodeWidenBytes(const byte_t *p_bytes, size_t p_count, unichar_t *r_chars)
+{
+    size_t t_offset;
+    t_offset = 0;
+    
+#if defined(__UNICODECHARS_SSE2)
+    for(; t_offset + 16 <= p_count; t_offset += 16)
+    {
+        __m128i t_bytes;
+        t_bytes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p_bytes + t_offset));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(r_chars + t_offset), _mm_unpacklo_epi8(t_bytes, _mm_setzero_si128()));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(r_chars + t_offset + 8), _mm_unpackhi_epi8(t_bytes, _mm_setzero_si128()));
+    }
+#endif
+    
+    for(; t_offset < p_count; t_offset++)
+        r_chars[t_offset] = p_bytes[t_offset];
+}
+
+void __MCUnicodeNarrowChars(const unichar_t *p_chars, size_t p_count, byte_t *r_bytes)
+{
+    size_t t_offset;
+    t_offset = 0;
+    
+#if defined(__UNICODECHARS_SSE2)
+    for(; t_offset + 16 <= p_count; t_offset += 16)
+    {
+        __m128i t_low, t_high;
+        t_low = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p_chars + t_offset));
+        t_high = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p_chars + t_offset + 8));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(r_bytes + t_offset), _mm_packus_epi16(t_low, t_high));
+    }
+#endif
+    
+    for(; t_offset < p_count; t_offset++)
+        r_bytes[t_offset] = byte_t(p_chars[t_offset]);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 bool MCUnicodeCharsMapToNative(const unichar_t *p_uchars, uindex_t p_uchar_count, char_t *p_nchars, uindex_t& r_nchar_count, char_t p_invalid)
 {
 	bool t_lossy;
@@ -180,6 +285,14 @@ bool MCUnicodeCharsMapToNative(const unichar_t *p_uchars, uindex_t p_uchar_count
 
 	for(uindex_t i = 0; i < p_uchar_count; i++)
 	{
+		size_t t_ascii_length;
+		t_ascii_length = __MCUnicodeAsciiLengthOfChars(p_uchars + i, p_uchar_count - i);
+		__MCUnicodeNarrowChars(p_uchars + i, t_ascii_length, p_nchars + r_nchar_count);
+		r_nchar_count += t_ascii_length;
+		i += t_ascii_length;
+		if (i == p_uchar_count)
+			break;
+		
 		uint8_t t_native_char;
 		if (!MCUnicodeCharMapToNative(p_uchars[i], t_native_char))
 		{
@@ -194,8 +307,19 @@ bool MCUnicodeCharsMapToNative(const unichar_t *p_uchars, uindex_t p_uchar_count
 
 void MCUnicodeCharsMapFromNative(const char_t *p_chars, uindex_t p_char_count, unichar_t *p_uchars)
 {
+#if defined(__ISO_8859_1__)
+	__MCUnicodeWidenBytes(p_chars, p_char_count, p_uchars);
+#else
 	for(uindex_t i = 0; i < p_char_count; i++)
-		p_uchars[i] = MCUnicodeCharMapFromNative(p_chars[i]);
+	{
+		size_t t_ascii_length;
+		t_ascii_length = __MCUnicodeAsciiLength(p_chars + i, p_char_count - i);
+		__MCUnicodeWidenBytes(p_chars + i, t_ascii_length, p_uchars + i);
+		i += t_ascii_length;
+		if (i < p_char_count)
+			p_uchars[i] = MCUnicodeCharMapFromNative(p_chars[i]);
+	}
+#endif
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -218,80 +342,115 @@ unichar_t MCUnicodeCharUppercase(unichar_t p_char)
 */
 ////////////////////////////////////////////////////////////////////////////////
 
-// Convert the given UTF-8 string to Unicode. Both counts are in bytes.
-// Returns the number of bytes used.
-static int32_t UTF8ToUnicode(const byte_t *p_src, int32_t p_src_count, unichar_t *p_dst, int32_t p_dst_count)
+// Decode the UTF-8 sequence at the start of the given bytes, returning the
+// number of bytes it occupies or 0 if it is malformed (in which case the
+// first byte is skipped).
+static inline uint32_t UTF8DecodeChar(const byte_t *p_src, int32_t p_src_count, uint32_t& r_codepoint)
 {
-	int32_t t_made;
-	t_made = 0;
+	uint32_t t_consumed;
+	t_consumed = 0;
 	
-	for(;;)
+	uint32_t t_codepoint;
+	t_codepoint = 0;
+	if ((p_src[0] & 0x80) == 0)
 	{
-		if (p_src_count == 0)
-			break;
-		
-		uint32_t t_consumed;
-		t_consumed = 0;
-		
-		uint32_t t_codepoint;
-		if ((p_src[0] & 0x80) == 0)
-		{
-			t_codepoint = p_src[0];
-			t_consumed = 1;
-		}
-		else if ((p_src[0] & 0x40) == 0)
+		t_codepoint = p_src[0];
+		t_consumed = 1;
+	}
+	else if ((p_src[0] & 0x40) == 0)
+	{
+		// This is an error
+	}
+	else if ((p_src[0] & 0x20) == 0)
+	{
+		if (p_src_count >= 2)
 		{
-			// This is an error
+			t_codepoint = (p_src[0] & 0x1f) << 6;
+			if ((p_src[1] & 0xc0) == 0x80)
+			{
+				t_codepoint |= (p_src[1] & 0x3f);
+				t_consumed = 2;
+			}
 		}
-		else if ((p_src[0] & 0x20) == 0)
+	}
+	else if ((p_src[0] & 0x10) == 0)
+	{
+		if (p_src_count >= 3)
 		{
-			if (p_src_count >= 2)
+			t_codepoint = (p_src[0] & 0x0f) << 12;
+			if ((p_src[1] & 0xc0) == 0x80)
 			{
-				t_codepoint = (p_src[0] & 0x1f) << 6;
-				if ((p_src[1] & 0xc0) == 0x80)
+				t_codepoint |= (p_src[1] & 0x3f) << 6;
+				if ((p_src[2] & 0xc0) == 0x80)
 				{
-					t_codepoint |= (p_src[1] & 0x3f);
-					t_consumed = 2;
+					t_codepoint |= (p_src[2] & 0x3f);
+					t_consumed = 3;
 				}
 			}
 		}
-		else if ((p_src[0] & 0x10) == 0)
+	}
+	else if ((p_src[0] & 0x08) == 0)
+	{
+		if (p_src_count >= 4)
 		{
-			if (p_src_count >= 3)
+			t_codepoint = (p_src[0] & 0x07) << 18;
+			if ((p_src[1] & 0xc0) == 0x80)
 			{
-				t_codepoint = (p_src[0] & 0x0f) << 12;
-				if ((p_src[1] & 0xc0) == 0x80)
+				t_codepoint |= (p_src[1] & 0x3f) << 12;
+				if ((p_src[2] & 0xc0) == 0x80)
 				{
-					t_codepoint |= (p_src[1] & 0x3f) << 6;
-					if ((p_src[2] & 0xc0) == 0x80)
+					t_codepoint |= (p_src[2] & 0x3f) << 6;
+					if ((p_src[3] & 0xc0) == 0x80)
 					{
-						t_codepoint |= (p_src[2] & 0x3f);
-						t_consumed = 3;
+						t_codepoint |= p_src[3] & 0x3f;
+						t_consumed = 4;
 					}
 				}
 			}
 		}
-		else if ((p_src[0] & 0x08) == 0)
+	}
+	
+	
+	r_codepoint = t_codepoint;
+	return t_consumed;
+}
+
+// Convert the given UTF-8 string to Unicode. Both counts are in bytes.
+// Returns the number of bytes used.
+static int32_t UTF8ToUnicode(const byte_t *p_src, int32_t p_src_count, unichar_t *p_dst, int32_t p_dst_count)
+{
+	int32_t t_made;
+	t_made = 0;
+	
+	for(;;)
+	{
+		if (p_src_count == 0)
+			break;
+		
+		// Runs of ASCII chars are copied (or counted) together.
+		if (p_src[0] < 0x80)
 		{
-			if (p_src_count >= 4)
+			int32_t t_ascii_length;
+			t_ascii_length = int32_t(__MCUnicodeAsciiLength(p_src, p_src_count));
+			if (p_dst_count != 0)
 			{
-				t_codepoint = (p_src[0] & 0x07) << 18;
-				if ((p_src[1] & 0xc0) == 0x80)
-				{
-					t_codepoint |= (p_src[1] & 0x3f) << 12;
-					if ((p_src[2] & 0xc0) == 0x80)
-					{
-						t_codepoint |= (p_src[2] & 0x3f) << 6;
-						if ((p_src[3] & 0xc0) == 0x80)
-						{
-							t_codepoint |= p_src[3] & 0x3f;
-							t_consumed = 4;
-						}
-					}
-				}
+				t_ascii_length = MCMin(t_ascii_length, p_dst_count / 2 - t_made);
+				if (t_ascii_length == 0)
+					break;
+				
+				__MCUnicodeWidenBytes(p_src, t_ascii_length, p_dst + t_made);
 			}
+			
+			t_made += t_ascii_length;
+			p_src += t_ascii_length;
+			p_src_count -= t_ascii_length;
+			continue;
 		}
 		
+		uint32_t t_codepoint;
+		uint32_t t_consumed;
+		t_consumed = UTF8DecodeChar(p_src, p_src_count, t_codepoint);
+		
 		if (t_consumed != 0)
 		{
 			if (t_codepoint < 65536)
@@ -344,6 +503,26 @@ static int32_t UnicodeToUTF8(const unichar_t *p_src, int32_t p_src_count, byte_t
 		if (p_src_count < 2)
 			break;
 		
+		// Runs of ASCII chars are copied (or counted) together.
+		if (p_src[0] < 0x80)
+		{
+			int32_t t_ascii_length;
+			t_ascii_length = int32_t(__MCUnicodeAsciiLengthOfChars(p_src, p_src_count / 2));
+			if (p_dst_count != 0)
+			{
+				t_ascii_length = MCMin(t_ascii_length, p_dst_count - t_made);
+				if (t_ascii_length == 0)
+					break;
+				
+				__MCUnicodeNarrowChars(p_src, t_ascii_length, p_dst + t_made);
+			}
+			
+			t_made += t_ascii_length;
+			p_src += t_ascii_length;
+			p_src_count -= t_ascii_length * 2;
+			continue;
+		}
+		
 		uint32_t t_codepoint;
 		t_codepoint = p_src[0];
 		if (t_codepoint < 0xD800 ||
@@ -435,6 +614,102 @@ uindex_t MCUnicodeCharsMapFromUTF8(const byte_t *utf8bytes, uindex_t utf8byte_co
     return UTF8ToUnicode(utf8bytes, utf8byte_count, wchars, wchar_count * 2) / 2;
 }
 
+// Decodes UTF-8 straight to native chars, which needs a buffer of (at most)
+// one char per byte. Returns false if any char has no native equivalent.
+bool MCUnicodeCharsMapFromUTF8ToNative(const byte_t *p_utf8bytes, uindex_t p_utf8byte_count, char_t *p_nchars, uindex_t& r_nchar_count)
+{
+    uindex_t t_made;
+    t_made = 0;
+    
+    while (p_utf8byte_count != 0)
+    {
+        if (p_utf8bytes[0] < 0x80)
+        {
+            size_t t_ascii_length;
+            t_ascii_length = __MCUnicodeAsciiLength(p_utf8bytes, p_utf8byte_count);
+            MCMemoryCopy(p_nchars + t_made, p_utf8bytes, t_ascii_length);
+            t_made += t_ascii_length;
+            p_utf8bytes += t_ascii_length;
+            p_utf8byte_count -= t_ascii_length;
+            continue;
+        }
+        
+        // This must decode exactly as UTF8ToUnicode does, so that the result
+        // is the same as mapping its output to native.
+        uint32_t t_codepoint;
+        uint32_t t_consumed;
+        t_consumed = UTF8DecodeChar(p_utf8bytes, p_utf8byte_count, t_codepoint);
+        if (t_consumed != 0)
+        {
+            if (t_codepoint >= 65536 ||
+                !MCUnicodeCharMapToNative(unichar_t(t_codepoint), p_nchars[t_made]))
+                return false;
+            t_made += 1;
+        }
+        else
+            t_consumed = 1;
+        
+        p_utf8bytes += t_consumed;
+        p_utf8byte_count -= t_consumed;
+    }
+    
+    r_nchar_count = t_made;
+    return true;
+}
+
+// If utf8bytes is nil, returns the number of bytes needed to convert the chars
+// If utf8bytes is not nil, does the conversion
+uindex_t MCNativeCharsMapToUTF8(const char_t *p_nchars, uindex_t p_nchar_count, byte_t *p_utf8bytes, uindex_t p_utf8byte_count)
+{
+    uindex_t t_made;
+    t_made = 0;
+    
+    for(uindex_t i = 0; i < p_nchar_count; i++)
+    {
+        size_t t_ascii_length;
+        t_ascii_length = __MCUnicodeAsciiLength(p_nchars + i, p_nchar_count - i);
+        if (p_utf8bytes != nil)
+        {
+            if (t_ascii_length > p_utf8byte_count - t_made)
+                break;
+            MCMemoryCopy(p_utf8bytes + t_made, p_nchars + i, t_ascii_length);
+        }
+        t_made += t_ascii_length;
+        i += t_ascii_length;
+        if (i == p_nchar_count)
+            break;
+        
+        // Native chars are all in the BMP, so need two or three bytes.
+        unichar_t t_char;
+        t_char = MCUnicodeCharMapFromNative(p_nchars[i]);
+        if (t_char < 0x0800)
+        {
+            if (p_utf8bytes != nil)
+            {
+                if (t_made + 2 > p_utf8byte_count)
+                    break;
+                p_utf8bytes[t_made + 0] = 0xc0 | (t_char >> 6);
+                p_utf8bytes[t_made + 1] = 0x80 | (t_char & 0x3f);
+            }
+            t_made += 2;
+        }
+        else
+        {
+            if (p_utf8bytes != nil)
+            {
+                if (t_made + 3 > p_utf8byte_count)
+                    break;
+                p_utf8bytes[t_made + 0] = 0xe0 | (t_char >> 12);
+                p_utf8bytes[t_made + 1] = 0x80 | ((t_char >> 6) & 0x3f);
+                p_utf8bytes[t_made + 2] = 0x80 | (t_char & 0x3f);
+            }
+            t_made += 3;
+        }
+    }
+    
+    return t_made;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 
 char_t MCUnicodeCharMapToNativeLossy(unichar_t p_uchar)
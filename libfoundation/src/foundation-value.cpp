@@ -21,6 +21,12 @@ along with LiveCode.  If not see <http://www.gnu.org/licenses/>.  */
 #  include <valgrind/memcheck.h>
 #endif /* HAVE_VALGRIND */
 
+#if defined(_MSC_VER)
+#  include <intrin.h>
+#endif
+
+#include <mutex>
+
 #include "foundation-private.h"
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -28,6 +34,17 @@ along with LiveCode.  If not see <http://www.gnu.org/licenses/>.  */
 static bool __MCValueInter(__MCValue *value, bool release, MCValueRef& r_unique_value);
 static void __MCValueUninter(__MCValue *value);
 
+// Adds delta to the reference count of the shared value, returning the new
+// count.
+static uint32_t __MCValueAtomicAddReferences(__MCValue *value, int32_t delta);
+
+// Updates the reference word of the shared value to 'new_references', if it
+// is currently 'old_references'.
+static bool __MCValueAtomicUpdateReferences(__MCValue *value, uint32_t old_references, uint32_t new_references);
+
+// Releases a reference to the shared value.
+static void __MCValueReleaseShared(__MCValue *value);
+
 ////////////////////////////////////////////////////////////////////////////////
 
 MCTypeInfoRef __MCCustomValueResolveTypeInfo(__MCValue *p_value)
@@ -119,7 +136,7 @@ uindex_t MCValueGetRetainCount(MCValueRef p_value)
 	MCAssert(self != nil);
     __MCAssertIsValue(self);
     
-    return self -> references;
+    return __MCValueGetReferencesWord(self) & kMCValueReferencesCountMask;
 }
 
 MC_DLLEXPORT_DEF
@@ -130,8 +147,12 @@ MCValueRef MCValueRetain(MCValueRef p_value)
 	MCAssert(self != nil);
     __MCAssertIsValue(self);
     
-	MCAssert(self -> references != UINT32_MAX);
-	self -> references += 1;
+	MCAssert((__MCValueGetReferencesWord(self) & kMCValueReferencesCountMask) != kMCValueReferencesCountMask);
+    
+    if (!__MCValueIsShared(self))
+        self -> references += 1;
+    else
+        __MCValueAtomicAddReferences(self, 1);
 
 	return self;
 }
@@ -145,6 +166,12 @@ void MCValueRelease(MCValueRef p_value)
         return;
     
     __MCAssertIsValue(self);
+    
+    if (__MCValueIsShared(self))
+    {
+        __MCValueReleaseShared(self);
+        return;
+    }
         
     uint32_t t_new_references;
     t_new_references = self -> references - 1;
@@ -530,10 +557,43 @@ struct MCValuePool
     __MCFreedValue *values;
     uindex_t count;
 };
-static MCValuePool *s_value_pools;
 
 // Stores the number of pools that we have.
-uindex_t kMCValuePoolCount = kMCValueTypeCodeList + 1;
+static const uindex_t kMCValuePoolCount = kMCValueTypeCodeList + 1;
+
+// Each thread has its own pools, so they need no synchronization. The pools of
+// a thread are emptied when it exits, or by MCFinalize for the thread calling
+// it.
+struct MCValuePools
+{
+    MCValuePool pools[kMCValuePoolCount];
+    
+    ~MCValuePools(void);
+    void Drain(void);
+};
+static thread_local MCValuePools s_value_pools;
+
+// If true, values may be used by more than one thread.
+static bool s_value_threading = false;
+
+// If true, values are shared as they are created.
+static bool s_value_create_shared = false;
+
+// The lock protecting the unique value table.
+static std::recursive_mutex s_value_tables_lock;
+
+// If true, the values of each type are counted.
+static bool s_value_accounting = false;
+
+// The counters kept for each type while accounting is enabled.
+struct MCValueTypeCounters
+{
+    std::atomic<uint64_t> created;
+    std::atomic<uint64_t> destroyed;
+    __MCAccountingCounter live;
+    __MCAccountingCounter live_bytes;
+};
+static MCValueTypeCounters s_value_type_counters[kMCValueTypeCodeForeignValue + 1];
 
 bool __MCValueCreate(MCValueTypeCode p_type_code, size_t p_size, __MCValue*& r_value)
 {
@@ -541,9 +601,9 @@ bool __MCValueCreate(MCValueTypeCode p_type_code, size_t p_size, __MCValue*& r_v
 	
     // MW-2014-03-21: [[ Faster ]] If we are pooling this typecode, and the
     //   pool isn't empty grab the ptr from there.
-    if (p_type_code <= kMCValueTypeCodeList && s_value_pools[p_type_code] . count > 0)
+    if (p_type_code <= kMCValueTypeCodeList && s_value_pools . pools[p_type_code] . count > 0)
     {
-        t_value = s_value_pools[p_type_code] . values;
+        t_value = s_value_pools . pools[p_type_code] . values;
 
 #ifdef HAVE_VALGRIND
 		/* Valgrind support */
@@ -560,8 +620,8 @@ bool __MCValueCreate(MCValueTypeCode p_type_code, size_t p_size, __MCValue*& r_v
         MCAssert(((__MCFreedValue *)t_value) -> references == 0 &&
                  ((__MCFreedValue *)t_value) -> flags == UINT32_MAX);
         
-        s_value_pools[p_type_code] . count -= 1;
-        s_value_pools[p_type_code] . values = ((__MCFreedValue *)t_value) -> next;
+        s_value_pools . pools[p_type_code] . count -= 1;
+        s_value_pools . pools[p_type_code] . values = ((__MCFreedValue *)t_value) -> next;
         MCMemoryClear(t_value, p_size);
 	}
     else
@@ -581,6 +641,17 @@ bool __MCValueCreate(MCValueTypeCode p_type_code, size_t p_size, __MCValue*& r_v
 	self -> references = 1;
 	self -> flags = (p_type_code << 28);
     
+    if (s_value_accounting)
+    {
+        MCValueTypeCounters& t_counters = s_value_type_counters[p_type_code];
+        __MCAccountingAdd<uint64_t>(t_counters . created, 1, s_value_threading);
+        t_counters . live . Add(1, s_value_threading);
+        t_counters . live_bytes . Add(int64_t(__MCMemoryGetBlockSize(self)), s_value_threading);
+    }
+    
+    if (s_value_create_shared)
+        self -> references |= kMCValueReferencesIsShared;
+    
 	r_value = self;
 
 	return true;
@@ -658,6 +729,14 @@ void __MCValueDestroy(__MCValue *self)
         MCUnreachableReturn();
 	}
 	
+    if (s_value_accounting)
+    {
+        MCValueTypeCounters& t_counters = s_value_type_counters[t_code];
+        __MCAccountingAdd<uint64_t>(t_counters . destroyed, 1, s_value_threading);
+        t_counters . live . Add(-1, s_value_threading);
+        t_counters . live_bytes . Add(-int64_t(__MCMemoryGetBlockSize(self)), s_value_threading);
+    }
+    
 	// Ensure that an immediate abort will be caused in Debug mode if a destroyed MCValueRef pointer is passed to
 	// a libfoundation function
 #ifdef _DEBUG
@@ -667,11 +746,11 @@ void __MCValueDestroy(__MCValue *self)
 
     // MW-2014-03-21: [[ Faster ]] If we are pooling this typecode, and the
     //   pool isn't full, add it to the pool.
-    if (t_code <= kMCValueTypeCodeList && s_value_pools[t_code] . count < 32)
+    if (t_code <= kMCValueTypeCodeList && s_value_pools . pools[t_code] . count < 32)
     {
-        s_value_pools[t_code] . count += 1;
-        ((__MCFreedValue *)self) -> next = s_value_pools[t_code] . values;
-        s_value_pools[t_code] . values = (__MCFreedValue *)self;
+        s_value_pools . pools[t_code] . count += 1;
+        ((__MCFreedValue *)self) -> next = s_value_pools . pools[t_code] . values;
+        s_value_pools . pools[t_code] . values = (__MCFreedValue *)self;
 
 #ifdef HAVE_VALGRIND
 		/* Valgrind support */
@@ -684,7 +763,7 @@ void __MCValueDestroy(__MCValue *self)
 		case kMCValueTypeCodeBoolean: t_size = sizeof(__MCBoolean); break;
 		case kMCValueTypeCodeNumber:  t_size = sizeof(__MCNumber);  break;
 		case kMCValueTypeCodeName:    t_size = sizeof(__MCName);    break;
-		case kMCValueTypeCodeString:  t_size = sizeof(__MCString);  break;
+		case kMCValueTypeCodeString:  t_size = sizeof(__MCString) + kMCStringInlineCapacity; break;
 		case kMCValueTypeCodeData:    t_size = sizeof(__MCData);    break;
 		case kMCValueTypeCodeArray:   t_size = sizeof(__MCArray);   break;
 		case kMCValueTypeCodeList:    t_size = sizeof(__MCList);    break;
@@ -980,6 +1059,8 @@ static bool __MCValueInter(__MCValue *self, bool p_release, MCValueRef& r_unique
 	hash_t t_hash;
 	t_hash = MCValueHash(self);
 
+    __MCValueTablesLocker t_locker;
+    
 	// See if the value is already in the table.
 	uindex_t t_target_slot;
 	t_target_slot = __MCValueFindUniqueValueBucket(self, t_hash);
@@ -1020,6 +1101,10 @@ static bool __MCValueInter(__MCValue *self, bool p_release, MCValueRef& r_unique
 	if (!__MCValueImmutableCopy(self, p_release, self))
 		return false;
 
+	// Any thread can find an interred value, so it must be shared.
+	if (s_value_threading)
+		__MCValueShare(self);
+    
 	self -> flags |= kMCValueFlagIsInterred;
 	s_unique_values[t_target_slot] . hash = t_hash;
 	s_unique_values[t_target_slot] . value = (uintptr_t)self;
@@ -1036,6 +1121,8 @@ static void __MCValueUninter(__MCValue *self)
 	hash_t t_hash;
 	t_hash = MCValueHash(self);
 
+    __MCValueTablesLocker t_locker;
+    
 	// Search for the value in the table.
 	uindex_t t_target_slot;
 	t_target_slot = __MCValueFindUniqueValueBucketForRemove(self, t_hash);
@@ -1155,9 +1242,6 @@ MC_DLLEXPORT_DEF MCBooleanRef kMCFalse;
 
 bool __MCValueInitialize(void)
 {
-    if (!MCMemoryNewArray(kMCValuePoolCount, s_value_pools))
-        return false;
-    
 	if (!__MCValueCreate(kMCValueTypeCodeNull, kMCNull))
 		return false;
 
@@ -1193,11 +1277,23 @@ void __MCValueFinalize(void)
     
     // Make sure to delete the value pools last, as they need to be around until
     // all other valuerefs have been deleted.
+    s_value_pools . Drain();
+    
+    s_value_create_shared = false;
+}
+
+MCValuePools::~MCValuePools(void)
+{
+    Drain();
+}
+
+void MCValuePools::Drain(void)
+{
     for(uindex_t i = 0; i < kMCValuePoolCount; i++)
-        while(s_value_pools[i] . count > 0)
+        while(pools[i] . count > 0)
         {
             __MCFreedValue *t_value;
-            t_value = s_value_pools[i] . values;
+            t_value = pools[i] . values;
             
 #ifdef HAVE_VALGRIND
 			/* Valgrind support */
@@ -1206,12 +1302,185 @@ void __MCValueFinalize(void)
 			VALGRIND_MAKE_MEM_DEFINED(t_value, sizeof (__MCFreedValue));
 #endif /* HAVE_VALGRIND */
             
-			s_value_pools[i] . values = t_value -> next;
-			s_value_pools[i] . count -= 1;
+			pools[i] . values = t_value -> next;
+			pools[i] . count -= 1;
             MCMemoryDelete(t_value);
         }
-	MCMemoryDeleteArray(s_value_pools);
-    s_value_pools = nil;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+MC_DLLEXPORT_DEF
+void MCValueEnableThreading(void)
+{
+    s_value_threading = true;
+}
+
+MC_DLLEXPORT_DEF
+void MCValueEnableAccounting(void)
+{
+    s_value_accounting = true;
+    __MCMemoryEnableAccounting();
+}
+
+MC_DLLEXPORT_DEF
+bool MCValueGetTypeStatistics(MCValueTypeCode p_type_code, MCValueTypeStatistics& r_statistics)
+{
+    if (!s_value_accounting ||
+        p_type_code > kMCValueTypeCodeForeignValue)
+        return false;
+    
+    const MCValueTypeCounters& t_counters = s_value_type_counters[p_type_code];
+    r_statistics . created = t_counters . created . load(std::memory_order_relaxed);
+    r_statistics . live = t_counters . live . GetCurrent();
+    r_statistics . destroyed = t_counters . destroyed . load(std::memory_order_relaxed);
+    r_statistics . peak_live = t_counters . live . GetPeak();
+    r_statistics . live_bytes = t_counters . live_bytes . GetCurrent();
+    r_statistics . peak_bytes = t_counters . live_bytes . GetPeak();
+    return true;
+}
+
+MC_DLLEXPORT_DEF
+void MCValueShare(MCValueRef p_value)
+{
+    __MCAssertIsValue(p_value);
+    
+    __MCValueShare((__MCValue *)p_value);
+}
+
+bool __MCValueIsThreadingEnabled(void)
+{
+    return s_value_threading;
+}
+
+void __MCValueSetCreateShared(bool p_shared)
+{
+    s_value_create_shared = s_value_threading && p_shared;
+}
+
+void __MCValueShare(__MCValue *self)
+{
+    if (__MCValueIsShared(self))
+        return;
+    
+    // The value must not yet be visible to other threads, so its references
+    // can be updated directly.
+    self -> references |= kMCValueReferencesIsShared;
+    
+    switch(__MCValueGetTypeCode(self))
+    {
+    case kMCValueTypeCodeName:
+        __MCValueShare(((__MCName *)self) -> string);
+        break;
+    case kMCValueTypeCodeString:
+        if ((self -> flags & kMCStringFlagIsSlice) != 0)
+            __MCValueShare(((__MCString *)self) -> owner);
+        break;
+    case kMCValueTypeCodeData:
+        if ((self -> flags & kMCDataFlagIsSlice) != 0)
+            __MCValueShare(((__MCData *)self) -> owner);
+        break;
+    case kMCValueTypeCodeArray:
+        {
+            uintptr_t t_iterator;
+            t_iterator = 0;
+            MCNameRef t_key;
+            MCValueRef t_value;
+            while(MCArrayIterate((MCArrayRef)self, t_iterator, t_key, t_value))
+            {
+                __MCValueShare(t_key);
+                __MCValueShare((__MCValue *)t_value);
+            }
+        }
+        break;
+    case kMCValueTypeCodeProperList:
+        for(uindex_t i = 0; i < MCProperListGetLength((MCProperListRef)self); i++)
+            __MCValueShare((__MCValue *)MCProperListFetchElementAtIndex((MCProperListRef)self, i));
+        break;
+    default:
+        break;
+    }
+}
+
+void __MCValueLockTables(void)
+{
+    if (s_value_threading)
+        s_value_tables_lock . lock();
+}
+
+void __MCValueUnlockTables(void)
+{
+    if (s_value_threading)
+        s_value_tables_lock . unlock();
+}
+
+static uint32_t __MCValueAtomicAddReferences(__MCValue *self, int32_t p_delta)
+{
+#if defined(_MSC_VER)
+    return (uint32_t(_InterlockedExchangeAdd(reinterpret_cast<volatile long *>(&self -> references), p_delta)) + p_delta) & kMCValueReferencesCountMask;
+#else
+    return __sync_add_and_fetch(&self -> references, uint32_t(p_delta)) & kMCValueReferencesCountMask;
+#endif
+}
+
+static bool __MCValueAtomicUpdateReferences(__MCValue *self, uint32_t p_old_references, uint32_t p_new_references)
+{
+#if defined(_MSC_VER)
+    return uint32_t(_InterlockedCompareExchange(reinterpret_cast<volatile long *>(&self -> references), long(p_new_references), long(p_old_references))) == p_old_references;
+#else
+    return __sync_bool_compare_and_swap(&self -> references, p_old_references, p_new_references);
+#endif
+}
+
+bool __MCValueTryRetain(__MCValue *self)
+{
+    if (!__MCValueIsShared(self))
+    {
+        self -> references += 1;
+        return true;
+    }
+    
+    for(;;)
+    {
+        uint32_t t_references;
+        t_references = __MCValueGetReferencesWord(self);
+        if ((t_references & kMCValueReferencesCountMask) == 0)
+            return false;
+        
+        if (__MCValueAtomicUpdateReferences(self, t_references, t_references + 1))
+            return true;
+    }
+}
+
+static void __MCValueReleaseShared(__MCValue *self)
+{
+    // Interred values can be found (and retained) by any thread through the
+    // unique value table, which doesn't hold references to them. So the last
+    // reference to one is released with the table locked, ensuring it cannot
+    // be found as it is destroyed. Names are found with __MCValueTryRetain, so
+    // can be released without a lock.
+    if (__MCValueGetTypeCode(self) == kMCValueTypeCodeName ||
+        (self -> flags & kMCValueFlagIsInterred) == 0)
+    {
+        if (__MCValueAtomicAddReferences(self, -1) == 0)
+            __MCValueDestroy(self);
+        return;
+    }
+    
+    for(;;)
+    {
+        uint32_t t_references;
+        t_references = __MCValueGetReferencesWord(self);
+        if ((t_references & kMCValueReferencesCountMask) == 1)
+            break;
+        
+        if (__MCValueAtomicUpdateReferences(self, t_references, t_references - 1))
+            return;
+    }
+    
+    __MCValueTablesLocker t_locker;
+    if (__MCValueAtomicAddReferences(self, -1) == 0)
+        __MCValueDestroy(self);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -24,6 +24,7 @@ along with LiveCode.  If not see <http://www.gnu.org/licenses/>.  */
 #include <sys/stat.h>
 #include <errno.h>
 #include <dirent.h>
+#include <sys/mman.h>
 
 /* ================================================================
  * POSIX whole-file IO
@@ -249,6 +250,70 @@ __MCSFileGetContents (MCStringRef p_native_path,
 	return t_success;
 }
 
+/* Files smaller than this are read rather than mapped, as mapping
+ * costs more than reading a small file. */
+static const size_t kMCSFileMinMappedSize = 1024 * 1024;
+
+static void
+__MCSFileUnmapContents (byte_t *p_bytes,
+                        uindex_t p_byte_count)
+{
+	/* UNCHECKED */ munmap (p_bytes, p_byte_count);
+}
+
+bool
+__MCSFileGetContentsMapped (MCStringRef p_native_path,
+                            MCDataRef & r_data)
+{
+	errno = 0;
+
+	/* Get a system path */
+	MCAutoStringRefAsSysString t_path_sys;
+	if (!t_path_sys.Lock(p_native_path))
+		return false;
+
+	int t_fd;
+	t_fd = open (*t_path_sys, O_RDONLY);
+	if (t_fd < 0)
+	{
+		int t_save_errno = errno;
+		return __MCSFileThrowOpenErrorWithErrno (p_native_path, t_save_errno);
+	}
+
+	/* Only regular files which fit in a data ref can be mapped; other
+	 * files are read as usual. */
+	struct stat t_stat_buf;
+	if (fstat (t_fd, &t_stat_buf) < 0 ||
+	    !S_ISREG (t_stat_buf.st_mode) ||
+	    size_t(t_stat_buf.st_size) < kMCSFileMinMappedSize ||
+	    uint64_t(t_stat_buf.st_size) > UINDEX_MAX)
+	{
+		close (t_fd);
+		return __MCSFileGetContents (p_native_path, r_data);
+	}
+
+	void *t_mapping;
+	t_mapping = mmap (NULL, t_stat_buf.st_size, PROT_READ, MAP_PRIVATE,
+	                  t_fd, 0);
+
+	/* The mapping remains valid after the descriptor is closed. */
+	/* UNCHECKED */ close (t_fd);
+
+	if (t_mapping == MAP_FAILED)
+		return __MCSFileGetContents (p_native_path, r_data);
+
+	if (!MCDataCreateWithExternalBytes (static_cast<byte_t *>(t_mapping),
+	                                    uindex_t(t_stat_buf.st_size),
+	                                    __MCSFileUnmapContents,
+	                                    r_data))
+	{
+		munmap (t_mapping, t_stat_buf.st_size);
+		return false;
+	}
+
+	return true;
+}
+
 bool
 __MCSFileSetContents (MCStringRef p_native_path,
                       MCDataRef p_data)
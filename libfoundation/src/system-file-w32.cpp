@@ -213,6 +213,81 @@ __MCSFileGetContents (MCStringRef p_native_path,
 	return false;
 }
 
+/* Files smaller than this are read rather than mapped, as mapping
+ * costs more than reading a small file. */
+static const size_t kMCSFileMinMappedSize = 1024 * 1024;
+
+static void
+__MCSFileUnmapContents (byte_t *p_bytes,
+                        uindex_t p_byte_count)
+{
+	/* UNCHECKED */ UnmapViewOfFile (p_bytes);
+}
+
+bool
+__MCSFileGetContentsMapped (MCStringRef p_native_path,
+                            MCDataRef & r_data)
+{
+	/* Get a system path */
+	MCAutoStringRefAsWString t_path_w32;
+	if (!t_path_w32.Lock(p_native_path))
+		return false;
+
+	HANDLE t_handle;
+	t_handle = CreateFileW (*t_path_w32,            /* filename */
+	                        GENERIC_READ,           /* desired access */
+	                        FILE_SHARE_READ,        /* share mode */
+	                        NULL,                   /* security attr. */
+	                        OPEN_EXISTING,          /* creation disp. */
+	                        FILE_ATTRIBUTE_NORMAL,  /* flags & attrs. */
+	                        NULL);                  /* template file */
+
+	if (t_handle == INVALID_HANDLE_VALUE)
+	{
+		return __MCSFileThrowOpenErrorWithErrorCode (p_native_path, GetLastError());
+	}
+
+	/* Only disk files which fit in a data ref can be mapped; other
+	 * files are read as usual. */
+	LARGE_INTEGER t_file_size_struct;
+	if (GetFileType (t_handle) != FILE_TYPE_DISK ||
+	    !GetFileSizeEx (t_handle, &t_file_size_struct) ||
+	    t_file_size_struct.QuadPart < LONGLONG(kMCSFileMinMappedSize) ||
+	    uint64_t(t_file_size_struct.QuadPart) > UINDEX_MAX)
+	{
+		/* UNCHECKED */ CloseHandle (t_handle);
+		return __MCSFileGetContents (p_native_path, r_data);
+	}
+
+	/* The view remains valid after the file and mapping handles are
+	 * closed. */
+	HANDLE t_mapping;
+	t_mapping = CreateFileMappingW (t_handle, NULL, PAGE_READONLY, 0, 0, NULL);
+
+	void *t_view = NULL;
+	if (t_mapping != NULL)
+	{
+		t_view = MapViewOfFile (t_mapping, FILE_MAP_READ, 0, 0, 0);
+		/* UNCHECKED */ CloseHandle (t_mapping);
+	}
+
+	/* UNCHECKED */ CloseHandle (t_handle);
+
+	if (t_view == NULL)
+		return __MCSFileGetContents (p_native_path, r_data);
+
+	if (!MCDataCreateWithExternalBytes (static_cast<byte_t *>(t_view),
+	                                    uindex_t(t_file_size_struct.QuadPart),
+	                                    __MCSFileUnmapContents,
+	                                    r_data))
+	{
+		UnmapViewOfFile (t_view);
+		return false;
+	}
+
+	return true;
+}
+
 /* Creates (or replaces) the file at p_native_path with a new file
  * containing p_data. */
 bool
@@ -140,6 +140,14 @@ MCSFileGetContents (MCStringRef p_path,
 	return __MCSFileGetContents (t_native_path, r_data);
 }
 
+MC_DLLEXPORT_DEF bool
+MCSFileGetContentsMapped (MCStringRef p_path,
+                          MCDataRef & r_data)
+{
+	MCS_FILE_CONVERT_PATH(p_path, t_native_path);
+	return __MCSFileGetContentsMapped (t_native_path, r_data);
+}
+
 MC_DLLEXPORT_DEF bool
 MCSFileSetContents (MCStringRef p_path,
                     MCDataRef p_data)
@@ -161,6 +169,19 @@ MCSFileCreateStream (MCStringRef p_path,
 	return __MCSFileCreateStream (t_native_path, p_mode, r_stream);
 }
 
+MC_DLLEXPORT_DEF bool
+MCSFileCreateMappedStream (MCStringRef p_path,
+                           MCStreamRef & r_stream)
+{
+	MCS_FILE_CONVERT_PATH(p_path, t_native_path);
+
+	MCAutoDataRef t_data;
+	if (!__MCSFileGetContentsMapped (t_native_path, &t_data))
+		return false;
+
+	return MCMemoryInputStreamCreateWithData (*t_data, r_stream);
+}
+
 /* ================================================================
  * File system operations
  * ================================================================ */
@@ -26,6 +26,7 @@ along with LiveCode.  If not see <http://www.gnu.org/licenses/>.  */
 #include <foundation-auto.h>
 
 #include <errno.h>
+#include <sys/stat.h>
 
 #ifdef __WINDOWS__
 #  if defined(_CRT_DISABLE_PERFCRIT_LOCKS) && !defined(_DLL)
@@ -197,7 +198,7 @@ __MCSStdioStreamGetCStream (MCStreamRef p_stream)
 static bool
 __MCSStdioStreamInterleave (MCStreamRef p_stream)
 {
-	/* UNCHECKED */ fseek (__MCSStdioStreamGetCStream (p_stream), 0, SEEK_END);
+	/* UNCHECKED */ fseek (__MCSStdioStreamGetCStream (p_stream), 0, SEEK_CUR);
 	return true;
 }
 
@@ -216,7 +217,7 @@ __MCSStdioStreamDestroy (MCStreamRef p_stream)
 
 /* Read p_amount bytes from p_stream into x_buffer.  If less than
  * p_amount bytes are available, fail, discarding any bytes that were
- * successfully read.
+ * successfully read (the contents of x_buffer are then undefined).
  *
  * FIXME see the "known issues" at the top of this file.
  */
@@ -231,12 +232,11 @@ __MCSStdioStreamRead (MCStreamRef p_stream,
 	if (!__MCSStdioStreamInterleave (p_stream))
 		return false;
 
-	byte_t *t_buffer = nullptr;
+	/* Read straight into place, rather than allocating a temporary
+	 * buffer for every read. */
+	byte_t *t_buffer = static_cast<byte_t *>(x_buffer);
 	size_t t_total_read = 0;
 
-	if (t_success)
-		t_success = MCMemoryNewArray (p_amount, t_buffer);
-
 	errno = 0;
 	while (t_success)
 	{
@@ -266,14 +266,43 @@ __MCSStdioStreamRead (MCStreamRef p_stream,
 		}
 	}
 
-	/* On success, copy the data that was read into place */
-	if (t_success)
-		MCMemoryCopy (x_buffer, t_buffer, p_amount);
-
-	MCMemoryDeleteArray (t_buffer);
 	return t_success;
 }
 
+/* The number of bytes that can be read without blocking is only known
+ * for regular files, where it is everything up to the end of the
+ * file.  For anything else, fail (without throwing) to indicate that
+ * it isn't known. */
+static bool
+__MCSStdioStreamGetAvailableForRead (MCStreamRef p_stream,
+                                     size_t & r_amount)
+{
+	FILE *t_stream = __MCSStdioStreamGetCStream (p_stream);
+
+#ifdef __WINDOWS__
+	struct _stati64 t_stat_buf;
+	if (_fstati64 (_fileno (t_stream), &t_stat_buf) != 0 ||
+	    (t_stat_buf.st_mode & _S_IFMT) != _S_IFREG)
+		return false;
+#else
+	struct stat t_stat_buf;
+	if (fstat (fileno (t_stream), &t_stat_buf) != 0 ||
+	    !S_ISREG (t_stat_buf.st_mode))
+		return false;
+#endif
+
+	filepos_t t_offset = ftello (t_stream);
+	if (t_offset < 0)
+		return false;
+
+	if (t_offset >= filepos_t (t_stat_buf.st_size))
+		r_amount = 0;
+	else if (!MCNarrow (filepos_t (t_stat_buf.st_size) - t_offset, r_amount))
+		return false;
+
+	return true;
+}
+
 /* Write p_amount bytes to p_stream from p_buffer.  If less than
  * p_amount bytes are successfully written, fail.
  *
@@ -364,7 +393,7 @@ __MCSStdioStreamTell (MCStreamRef p_stream,
 MCStreamCallbacks __kMCSStdioStreamCallbacks = {
     __MCSStdioStreamDestroy,
     __MCSStdioStreamIsFinished,
-    nil,
+    __MCSStdioStreamGetAvailableForRead,
     __MCSStdioStreamRead,
     nil,
     __MCSStdioStreamWrite,
@@ -373,6 +402,7 @@ MCStreamCallbacks __kMCSStdioStreamCallbacks = {
     nil,
     __MCSStdioStreamTell,
     __MCSStdioStreamSeek,
+    nil,
 };
 
 /* ================================================================
@@ -27,6 +27,8 @@ public:
 	virtual ~LibfoundationEnvironment() {}
 
 	virtual void SetUp() {
+        // Run the tests with accounting, so that it is exercised throughout.
+        MCValueEnableAccounting();
 		ASSERT_TRUE(MCInitialize());
         ASSERT_TRUE(MCSInitialize());
 	}
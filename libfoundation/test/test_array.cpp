@@ -0,0 +1,433 @@
+/* Copyright (C) 2003-2015 LiveCode Ltd.
+
+This file is part of LiveCode.
+
+LiveCode is free software; you can redistribute it and/or modify it under
+the terms of the GNU General Public License v3 as published by the Free
+Software Foundation.
+
+LiveCode is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or
+FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+for more details.
+
+You should have received a copy of the GNU General Public License
+along with LiveCode.  If not see <http://www.gnu.org/licenses/>.  */
+
+#include "gtest/gtest.h"
+
+#include "foundation.h"
+#include "foundation-auto.h"
+
+static void _array_store_sequence(MCArrayRef p_array, index_t p_count)
+{
+    for(index_t i = 1; i <= p_count; i++)
+    {
+        MCAutoNumberRef t_number;
+        ASSERT_TRUE(MCNumberCreateWithInteger(i * 10, &t_number));
+        ASSERT_TRUE(MCArrayStoreValueAtIndex(p_array, i, *t_number));
+    }
+}
+
+static void _array_check_sequence(MCArrayRef p_array, index_t p_count)
+{
+    ASSERT_EQ(MCArrayGetCount(p_array), uindex_t(p_count));
+    for(index_t i = 1; i <= p_count; i++)
+    {
+        MCValueRef t_value;
+        ASSERT_TRUE(MCArrayFetchValueAtIndex(p_array, i, t_value));
+        ASSERT_EQ(MCNumberFetchAsInteger((MCNumberRef)t_value), i * 10);
+    }
+}
+
+TEST(array, dense_sequence)
+{
+    MCAutoArrayRef t_array;
+    ASSERT_TRUE(MCArrayCreateMutable(&t_array));
+    ASSERT_FALSE(MCArrayIsDense(*t_array));
+
+    _array_store_sequence(*t_array, 1000);
+    ASSERT_TRUE(MCArrayIsDense(*t_array));
+    _array_check_sequence(*t_array, 1000);
+
+    MCValueRef t_value;
+    ASSERT_FALSE(MCArrayFetchValueAtIndex(*t_array, 0, t_value));
+    ASSERT_FALSE(MCArrayFetchValueAtIndex(*t_array, 1001, t_value));
+
+    // Keys with the same digits but in a different form are not indices.
+    ASSERT_TRUE(MCArrayFetchValue(*t_array, false, MCNAME("12"), t_value));
+    ASSERT_EQ(MCNumberFetchAsInteger((MCNumberRef)t_value), 120);
+    ASSERT_FALSE(MCArrayFetchValue(*t_array, false, MCNAME("012"), t_value));
+    ASSERT_FALSE(MCArrayFetchValue(*t_array, false, MCNAME("12 "), t_value));
+}
+
+TEST(array, dense_store_by_name)
+{
+    MCAutoArrayRef t_array;
+    ASSERT_TRUE(MCArrayCreateMutable(&t_array));
+
+    ASSERT_TRUE(MCArrayStoreValue(*t_array, false, MCNAME("1"), kMCTrue));
+    ASSERT_TRUE(MCArrayStoreValue(*t_array, false, MCNAME("2"), kMCFalse));
+    ASSERT_TRUE(MCArrayIsDense(*t_array));
+
+    MCValueRef t_value;
+    ASSERT_TRUE(MCArrayFetchValueAtIndex(*t_array, 2, t_value));
+    ASSERT_EQ(t_value, kMCFalse);
+}
+
+TEST(array, dense_to_hashed)
+{
+    MCAutoArrayRef t_array;
+    ASSERT_TRUE(MCArrayCreateMutable(&t_array));
+    _array_store_sequence(*t_array, 100);
+
+    // A key which isn't the next index makes the array hashed.
+    ASSERT_TRUE(MCArrayStoreValue(*t_array, false, MCNAME("foo"), kMCTrue));
+    ASSERT_FALSE(MCArrayIsDense(*t_array));
+
+    MCValueRef t_value;
+    ASSERT_TRUE(MCArrayFetchValue(*t_array, false, MCNAME("foo"), t_value));
+    ASSERT_EQ(t_value, kMCTrue);
+    ASSERT_TRUE(MCArrayRemoveValue(*t_array, false, MCNAME("foo")));
+    _array_check_sequence(*t_array, 100);
+
+    // So does leaving a gap.
+    MCAutoArrayRef t_gap_array;
+    ASSERT_TRUE(MCArrayCreateMutable(&t_gap_array));
+    _array_store_sequence(*t_gap_array, 10);
+    ASSERT_TRUE(MCArrayStoreValueAtIndex(*t_gap_array, 12, kMCTrue));
+    ASSERT_FALSE(MCArrayIsDense(*t_gap_array));
+    ASSERT_EQ(MCArrayGetCount(*t_gap_array), 11U);
+}
+
+TEST(array, dense_remove)
+{
+    MCAutoArrayRef t_array;
+    ASSERT_TRUE(MCArrayCreateMutable(&t_array));
+    _array_store_sequence(*t_array, 10);
+
+    // Removing from the end keeps the array dense.
+    ASSERT_TRUE(MCArrayRemoveValueAtIndex(*t_array, 10));
+    ASSERT_TRUE(MCArrayRemoveValueAtIndex(*t_array, 20));
+    ASSERT_TRUE(MCArrayIsDense(*t_array));
+    _array_check_sequence(*t_array, 9);
+
+    // Removing from the middle does not.
+    ASSERT_TRUE(MCArrayRemoveValueAtIndex(*t_array, 5));
+    ASSERT_FALSE(MCArrayIsDense(*t_array));
+    ASSERT_EQ(MCArrayGetCount(*t_array), 8U);
+
+    MCValueRef t_value;
+    ASSERT_FALSE(MCArrayFetchValueAtIndex(*t_array, 5, t_value));
+    ASSERT_TRUE(MCArrayFetchValueAtIndex(*t_array, 9, t_value));
+    ASSERT_EQ(MCNumberFetchAsInteger((MCNumberRef)t_value), 90);
+}
+
+TEST(array, dense_copy_on_write)
+{
+    MCAutoArrayRef t_array;
+    ASSERT_TRUE(MCArrayCreateMutable(&t_array));
+    _array_store_sequence(*t_array, 50);
+
+    MCAutoArrayRef t_copy;
+    ASSERT_TRUE(MCArrayCopy(*t_array, &t_copy));
+    ASSERT_TRUE(MCArrayIsDense(*t_copy));
+
+    MCAutoArrayRef t_mutable_copy;
+    ASSERT_TRUE(MCArrayMutableCopy(*t_copy, &t_mutable_copy));
+    ASSERT_TRUE(MCArrayStoreValueAtIndex(*t_mutable_copy, 1, kMCTrue));
+    ASSERT_TRUE(MCArrayStoreValueAtIndex(*t_array, 51, kMCTrue));
+
+    _array_check_sequence(*t_copy, 50);
+    ASSERT_EQ(MCArrayGetCount(*t_array), 51U);
+    ASSERT_EQ(MCArrayGetCount(*t_mutable_copy), 50U);
+
+    MCValueRef t_value;
+    ASSERT_TRUE(MCArrayFetchValueAtIndex(*t_mutable_copy, 1, t_value));
+    ASSERT_EQ(t_value, kMCTrue);
+}
+
+TEST(array, dense_nested_path)
+{
+    MCAutoArrayRef t_array;
+    ASSERT_TRUE(MCArrayCreateMutable(&t_array));
+
+    MCNameRef t_path[2] = { MCNAME("1"), MCNAME("name") };
+    ASSERT_TRUE(MCArrayStoreValueOnPath(*t_array, false, t_path, 2, kMCTrue));
+    ASSERT_TRUE(MCArrayIsDense(*t_array));
+
+    MCValueRef t_value;
+    ASSERT_TRUE(MCArrayFetchValueOnPath(*t_array, false, t_path, 2, t_value));
+    ASSERT_EQ(t_value, kMCTrue);
+
+    ASSERT_TRUE(MCArrayRemoveValueOnPath(*t_array, false, t_path, 2));
+    ASSERT_FALSE(MCArrayFetchValueOnPath(*t_array, false, t_path, 2, t_value));
+    ASSERT_EQ(MCArrayGetCount(*t_array), 1U);
+}
+
+TEST(array, dense_iterate)
+{
+    MCAutoArrayRef t_array;
+    ASSERT_TRUE(MCArrayCreateMutable(&t_array));
+    _array_store_sequence(*t_array, 20);
+
+    uintptr_t t_iterator = 0;
+    MCNameRef t_key;
+    MCValueRef t_value;
+    index_t t_count = 0;
+    while(MCArrayIterate(*t_array, t_iterator, t_key, t_value))
+    {
+        t_count += 1;
+        MCNewAutoNameRef t_index_key;
+        ASSERT_TRUE(MCNameCreateWithIndex(t_count, &t_index_key));
+        ASSERT_EQ(t_key, *t_index_key);
+        ASSERT_EQ(MCNumberFetchAsInteger((MCNumberRef)t_value), t_count * 10);
+    }
+    ASSERT_EQ(t_count, 20);
+
+    // The keys must still be correct after growing past the iterated ones.
+    _array_store_sequence(*t_array, 200);
+    t_iterator = 0;
+    t_count = 0;
+    while(MCArrayIterate(*t_array, t_iterator, t_key, t_value))
+    {
+        t_count += 1;
+        MCNewAutoNameRef t_index_key;
+        ASSERT_TRUE(MCNameCreateWithIndex(t_count, &t_index_key));
+        ASSERT_EQ(t_key, *t_index_key);
+    }
+    ASSERT_EQ(t_count, 200);
+}
+
+TEST(array, dense_equality)
+{
+    MCAutoArrayRef t_dense;
+    ASSERT_TRUE(MCArrayCreateMutable(&t_dense));
+    _array_store_sequence(*t_dense, 30);
+
+    // Build the same array in reverse, which can't be dense.
+    MCAutoArrayRef t_hashed;
+    ASSERT_TRUE(MCArrayCreateMutable(&t_hashed));
+    for(index_t i = 30; i >= 1; i--)
+    {
+        MCAutoNumberRef t_number;
+        ASSERT_TRUE(MCNumberCreateWithInteger(i * 10, &t_number));
+        ASSERT_TRUE(MCArrayStoreValueAtIndex(*t_hashed, i, *t_number));
+    }
+    ASSERT_FALSE(MCArrayIsDense(*t_hashed));
+
+    ASSERT_TRUE(MCValueIsEqualTo(*t_dense, *t_hashed));
+    ASSERT_TRUE(MCValueIsEqualTo(*t_hashed, *t_dense));
+
+    ASSERT_TRUE(MCArrayStoreValueAtIndex(*t_hashed, 3, kMCTrue));
+    ASSERT_FALSE(MCValueIsEqualTo(*t_dense, *t_hashed));
+    ASSERT_FALSE(MCValueIsEqualTo(*t_hashed, *t_dense));
+}
+
+static void _array_create_key(const char *p_format, index_t p_index, MCNameRef& r_key)
+{
+    char t_key[32];
+    sprintf(t_key, p_format, p_index);
+    ASSERT_TRUE(MCNameCreateWithNativeChars((const char_t *)t_key, strlen(t_key), r_key));
+}
+
+TEST(array, hashed_store_fetch_remove)
+{
+    MCAutoArrayRef t_array;
+    ASSERT_TRUE(MCArrayCreateMutable(&t_array));
+
+    const index_t kCount = 20000;
+    for(index_t i = 0; i < kCount; i++)
+    {
+        MCNewAutoNameRef t_key;
+        _array_create_key("key%d", i, &t_key);
+        MCAutoNumberRef t_number;
+        ASSERT_TRUE(MCNumberCreateWithInteger(i, &t_number));
+        ASSERT_TRUE(MCArrayStoreValue(*t_array, false, *t_key, *t_number));
+    }
+    ASSERT_EQ(MCArrayGetCount(*t_array), uindex_t(kCount));
+
+    // Remove every other key, which leaves plenty of deleted slots.
+    for(index_t i = 0; i < kCount; i += 2)
+    {
+        MCNewAutoNameRef t_key;
+        _array_create_key("key%d", i, &t_key);
+        ASSERT_TRUE(MCArrayRemoveValue(*t_array, false, *t_key));
+    }
+    ASSERT_EQ(MCArrayGetCount(*t_array), uindex_t(kCount / 2));
+
+    for(index_t i = 0; i < kCount; i++)
+    {
+        MCNewAutoNameRef t_key;
+        _array_create_key("KEY%d", i, &t_key);
+        MCValueRef t_value;
+        if (i % 2 == 0)
+            ASSERT_FALSE(MCArrayFetchValue(*t_array, false, *t_key, t_value));
+        else
+        {
+            ASSERT_TRUE(MCArrayFetchValue(*t_array, false, *t_key, t_value));
+            ASSERT_EQ(MCNumberFetchAsInteger((MCNumberRef)t_value), i);
+        }
+    }
+
+    uintptr_t t_iterator = 0;
+    MCNameRef t_key;
+    MCValueRef t_value;
+    uindex_t t_count = 0;
+    while(MCArrayIterate(*t_array, t_iterator, t_key, t_value))
+    {
+        ASSERT_EQ(MCNumberFetchAsInteger((MCNumberRef)t_value) % 2, 1);
+        t_count += 1;
+    }
+    ASSERT_EQ(t_count, uindex_t(kCount / 2));
+}
+
+TEST(array, hashed_churn)
+{
+    MCAutoArrayRef t_array;
+    ASSERT_TRUE(MCArrayCreateMutable(&t_array));
+
+    // Keep a sliding window of keys, so the table never grows but slots are
+    // constantly freed and reused.
+    const index_t kWindow = 100;
+    for(index_t i = 0; i < 50 * kWindow; i++)
+    {
+        MCNewAutoNameRef t_key;
+        _array_create_key("k%d", i, &t_key);
+        ASSERT_TRUE(MCArrayStoreValue(*t_array, true, *t_key, kMCTrue));
+
+        if (i >= kWindow)
+        {
+            MCNewAutoNameRef t_old_key;
+            _array_create_key("k%d", i - kWindow, &t_old_key);
+            ASSERT_TRUE(MCArrayRemoveValue(*t_array, true, *t_old_key));
+        }
+    }
+    ASSERT_EQ(MCArrayGetCount(*t_array), uindex_t(kWindow));
+
+    for(index_t i = 49 * kWindow; i < 50 * kWindow; i++)
+    {
+        MCNewAutoNameRef t_key;
+        _array_create_key("k%d", i, &t_key);
+        MCValueRef t_value;
+        ASSERT_TRUE(MCArrayFetchValue(*t_array, true, *t_key, t_value));
+    }
+}
+
+TEST(array, hashed_churn_misses)
+{
+    MCAutoArrayRef t_array;
+    ASSERT_TRUE(MCArrayCreateMutable(&t_array));
+
+    // Remove one key and add a new one each time round, so the deleted slots
+    // pile up and the table has to be rehashed in place to clear them.
+    const index_t kLive = 1000;
+    const index_t kRounds = 20 * kLive;
+    for(index_t i = 0; i < kLive; i++)
+    {
+        MCNewAutoNameRef t_key;
+        _array_create_key("k%d", i, &t_key);
+        ASSERT_TRUE(MCArrayStoreValue(*t_array, true, *t_key, kMCTrue));
+    }
+    for(index_t i = 0; i < kRounds; i++)
+    {
+        MCNewAutoNameRef t_old_key, t_new_key;
+        _array_create_key("k%d", i, &t_old_key);
+        _array_create_key("k%d", i + kLive, &t_new_key);
+        ASSERT_TRUE(MCArrayRemoveValue(*t_array, true, *t_old_key));
+        ASSERT_TRUE(MCArrayStoreValue(*t_array, true, *t_new_key, kMCTrue));
+    }
+    ASSERT_EQ(MCArrayGetCount(*t_array), uindex_t(kLive));
+
+    // Every removed key must miss, and every live key must be found.
+    for(index_t i = 0; i < kRounds + kLive; i++)
+    {
+        MCNewAutoNameRef t_key;
+        _array_create_key("k%d", i, &t_key);
+        MCValueRef t_value;
+        ASSERT_EQ(MCArrayFetchValue(*t_array, true, *t_key, t_value), i >= kRounds);
+    }
+
+    // Iteration must only see the live keys.
+    uintptr_t t_iterator = 0;
+    MCNameRef t_key;
+    MCValueRef t_value;
+    uindex_t t_count = 0;
+    while(MCArrayIterate(*t_array, t_iterator, t_key, t_value))
+        t_count += 1;
+    ASSERT_EQ(t_count, uindex_t(kLive));
+}
+
+TEST(array, hashed_case_sensitivity)
+{
+    MCAutoArrayRef t_array;
+    ASSERT_TRUE(MCArrayCreateMutable(&t_array));
+
+    // Caseless keys match regardless of case.
+    ASSERT_TRUE(MCArrayStoreValue(*t_array, false, MCNAME("Foo"), kMCTrue));
+    ASSERT_TRUE(MCArrayStoreValue(*t_array, false, MCNAME("fOO"), kMCFalse));
+    ASSERT_EQ(MCArrayGetCount(*t_array), 1U);
+
+    MCValueRef t_value;
+    ASSERT_TRUE(MCArrayFetchValue(*t_array, false, MCNAME("foo"), t_value));
+    ASSERT_EQ(t_value, kMCFalse);
+    ASSERT_FALSE(MCArrayFetchValue(*t_array, true, MCNAME("foo"), t_value));
+    ASSERT_TRUE(MCArrayFetchValue(*t_array, true, MCNAME("Foo"), t_value));
+
+    // Case-sensitive keys are distinct even though they hash the same.
+    ASSERT_TRUE(MCArrayStoreValue(*t_array, true, MCNAME("foo"), kMCTrue));
+    ASSERT_EQ(MCArrayGetCount(*t_array), 2U);
+    ASSERT_TRUE(MCArrayRemoveValue(*t_array, true, MCNAME("Foo")));
+    ASSERT_TRUE(MCArrayFetchValue(*t_array, true, MCNAME("foo"), t_value));
+    ASSERT_EQ(t_value, kMCTrue);
+}
+
+TEST(array, hashed_copy_on_write)
+{
+    MCAutoArrayRef t_array;
+    ASSERT_TRUE(MCArrayCreateMutable(&t_array));
+    for(index_t i = 0; i < 1000; i++)
+    {
+        MCNewAutoNameRef t_key;
+        _array_create_key("key%d", i, &t_key);
+        ASSERT_TRUE(MCArrayStoreValue(*t_array, false, *t_key, kMCTrue));
+    }
+
+    // The copy shares the table until one side changes it.
+    MCAutoArrayRef t_copy;
+    ASSERT_TRUE(MCArrayMutableCopy(*t_array, &t_copy));
+    ASSERT_TRUE(MCArrayRemoveValue(*t_copy, false, MCNAME("key10")));
+    ASSERT_TRUE(MCArrayStoreValue(*t_array, false, MCNAME("key10"), kMCFalse));
+
+    MCValueRef t_value;
+    ASSERT_FALSE(MCArrayFetchValue(*t_copy, false, MCNAME("key10"), t_value));
+    ASSERT_TRUE(MCArrayFetchValue(*t_copy, false, MCNAME("key11"), t_value));
+    ASSERT_TRUE(MCArrayFetchValue(*t_array, false, MCNAME("key10"), t_value));
+    ASSERT_EQ(t_value, kMCFalse);
+    ASSERT_EQ(MCArrayGetCount(*t_copy), 999U);
+    ASSERT_EQ(MCArrayGetCount(*t_array), 1000U);
+}
+
+TEST(array, empty_copy_on_write)
+{
+    // Mutable copies of an empty immutable array must not free its (empty)
+    // table when they are first stored into.
+    MCAutoArrayRef t_first, t_second;
+    ASSERT_TRUE(MCArrayMutableCopy(kMCEmptyArray, &t_first));
+    ASSERT_TRUE(MCArrayMutableCopy(kMCEmptyArray, &t_second));
+    ASSERT_TRUE(MCArrayStoreValue(*t_first, false, MCNAME("key"), kMCTrue));
+    ASSERT_TRUE(MCArrayStoreValue(*t_second, false, MCNAME("key"), kMCFalse));
+
+    MCValueRef t_value;
+    ASSERT_TRUE(MCArrayFetchValue(*t_first, false, MCNAME("key"), t_value));
+    ASSERT_EQ(t_value, kMCTrue);
+    ASSERT_TRUE(MCArrayFetchValue(*t_second, false, MCNAME("key"), t_value));
+    ASSERT_EQ(t_value, kMCFalse);
+    ASSERT_EQ(MCArrayGetCount(kMCEmptyArray), 0U);
+
+    MCAutoArrayRef t_dense;
+    ASSERT_TRUE(MCArrayMutableCopy(kMCEmptyArray, &t_dense));
+    _array_store_sequence(*t_dense, 10);
+    _array_check_sequence(*t_dense, 10);
+    ASSERT_EQ(MCArrayGetCount(kMCEmptyArray), 0U);
+}
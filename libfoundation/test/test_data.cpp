@@ -0,0 +1,148 @@
+/* Copyright (C) 2017 LiveCode Ltd.
+ 
+ This file is part of LiveCode.
+ 
+ LiveCode is free software; you can redistribute it and/or modify it under
+ the terms of the GNU General Public License v3 as published by the Free
+ Software Foundation.
+ 
+ LiveCode is distributed in the hope that it will be useful, but WITHOUT ANY
+ WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with LiveCode.  If not see <http://www.gnu.org/licenses/>.  */
+
+#include "gtest/gtest.h"
+
+#include "foundation.h"
+#include "foundation-auto.h"
+#include "foundation-system.h"
+
+TEST(data, copy_range)
+//
+// Checks that ranges of data (which may share the bytes of the data they are
+// taken from) are unaffected by releasing or changing that data.
+//
+{
+    byte_t t_bytes[1000];
+    for (int i = 0; i < 1000; i++)
+        t_bytes[i] = byte_t(i * 7);
+
+    MCDataRef t_data;
+    ASSERT_TRUE(MCDataCreateWithBytes(t_bytes, 1000, t_data));
+
+    MCAutoDataRef t_range, t_range_of_range;
+    ASSERT_TRUE(MCDataCopyRange(t_data, MCRangeMake(100, 500), &t_range));
+    ASSERT_TRUE(MCDataCopyRange(*t_range, MCRangeMake(10, 20), &t_range_of_range));
+
+    // Changing a mutable copy of the data must not change the ranges.
+    MCDataRef t_mutable;
+    ASSERT_TRUE(MCDataMutableCopyAndRelease(t_data, t_mutable));
+    ASSERT_TRUE(MCDataReplaceBytes(t_mutable, MCRangeMake(0, 1000), (const byte_t *)"x", 1));
+    MCValueRelease(t_mutable);
+
+    ASSERT_EQ(500U, MCDataGetLength(*t_range));
+    EXPECT_EQ(0, memcmp(MCDataGetBytePtr(*t_range), t_bytes + 100, 500));
+    ASSERT_EQ(20U, MCDataGetLength(*t_range_of_range));
+    EXPECT_EQ(0, memcmp(MCDataGetBytePtr(*t_range_of_range), t_bytes + 110, 20));
+
+    // A range which is the only reference can be made mutable and changed.
+    MCDataRef t_changed;
+    ASSERT_TRUE(MCDataMutableCopyAndRelease(t_range_of_range.Take(), t_changed));
+    ASSERT_TRUE(MCDataAppendBytes(t_changed, t_bytes, 1000));
+    ASSERT_EQ(1020U, MCDataGetLength(t_changed));
+    EXPECT_EQ(0, memcmp(MCDataGetBytePtr(t_changed), t_bytes + 110, 20));
+    EXPECT_EQ(0, memcmp(MCDataGetBytePtr(t_changed) + 20, t_bytes, 1000));
+    MCValueRelease(t_changed);
+
+    EXPECT_EQ(0, memcmp(MCDataGetBytePtr(*t_range), t_bytes + 100, 500));
+}
+
+static int s_released_count = 0;
+
+static void release_bytes(byte_t *p_bytes, uindex_t p_byte_count)
+{
+    s_released_count += 1;
+    MCMemoryDeleteArray(p_bytes);
+}
+
+TEST(data, external_bytes)
+//
+// Checks that data using external bytes shares them with its ranges, copies
+// them before any change, and releases them once no longer used.
+//
+{
+    const uindex_t kLength = 256 * 1024;
+    byte_t *t_bytes;
+    ASSERT_TRUE(MCMemoryNewArray(kLength, t_bytes));
+    for (uindex_t i = 0; i < kLength; i++)
+        t_bytes[i] = byte_t(i * 13);
+
+    s_released_count = 0;
+
+    MCDataRef t_data;
+    ASSERT_TRUE(MCDataCreateWithExternalBytes(t_bytes, kLength, release_bytes, t_data));
+    EXPECT_EQ(t_bytes, MCDataGetBytePtr(t_data));
+
+    // Even small ranges of external data share its bytes.
+    MCAutoDataRef t_range;
+    ASSERT_TRUE(MCDataCopyRange(t_data, MCRangeMake(1000, 16), &t_range));
+    EXPECT_EQ(t_bytes + 1000, MCDataGetBytePtr(*t_range));
+
+    // Changing a mutable copy must leave the external bytes alone.
+    MCDataRef t_mutable;
+    ASSERT_TRUE(MCDataMutableCopy(t_data, t_mutable));
+    ASSERT_TRUE(MCDataReplaceBytes(t_mutable, MCRangeMake(0, 10), (const byte_t *)"x", 1));
+    EXPECT_EQ(kLength - 9, MCDataGetLength(t_mutable));
+    EXPECT_EQ(byte_t(10 * 13), MCDataGetBytePtr(t_mutable)[1]);
+    EXPECT_EQ(byte_t(0), t_bytes[0]);
+    MCValueRelease(t_mutable);
+
+    // The bytes are released once the data and its ranges are gone.
+    MCValueRelease(t_data);
+    EXPECT_EQ(0, s_released_count);
+    EXPECT_EQ(0, memcmp(MCDataGetBytePtr(*t_range), t_bytes + 1000, 16));
+    t_range.Reset();
+    EXPECT_EQ(1, s_released_count);
+
+    // Making the only reference mutable copies and releases the bytes.
+    ASSERT_TRUE(MCMemoryNewArray(kLength, t_bytes));
+    ASSERT_TRUE(MCDataCreateWithExternalBytes(t_bytes, kLength, release_bytes, t_data));
+    ASSERT_TRUE(MCDataMutableCopyAndRelease(t_data, t_mutable));
+    EXPECT_EQ(2, s_released_count);
+    ASSERT_TRUE(MCDataAppendByte(t_mutable, 1));
+    EXPECT_EQ(kLength + 1, MCDataGetLength(t_mutable));
+    MCValueRelease(t_mutable);
+}
+
+TEST(data, file_contents_mapped)
+//
+// Checks that reading a file by mapping it gives the same data as reading it.
+//
+{
+    for (uindex_t t_length : {100U, 3U * 1024U * 1024U})
+    {
+        MCAutoDataRef t_mutable;
+        ASSERT_TRUE(MCDataCreateMutable(t_length, &t_mutable));
+        for (uindex_t i = 0; i < t_length; i++)
+            ASSERT_TRUE(MCDataAppendByte(*t_mutable, byte_t(i * 29)));
+
+        MCAutoDataRef t_written;
+        ASSERT_TRUE(MCDataCopy(*t_mutable, &t_written));
+        ASSERT_TRUE(MCSFileSetContents(MCSTR("test_data_mapped.bin"), *t_written));
+
+        MCAutoDataRef t_read, t_mapped;
+        ASSERT_TRUE(MCSFileGetContents(MCSTR("test_data_mapped.bin"), &t_read));
+        ASSERT_TRUE(MCSFileGetContentsMapped(MCSTR("test_data_mapped.bin"), &t_mapped));
+        EXPECT_TRUE(MCDataIsEqualTo(*t_written, *t_read));
+        EXPECT_TRUE(MCDataIsEqualTo(*t_written, *t_mapped));
+
+        ASSERT_TRUE(MCSFileDelete(MCSTR("test_data_mapped.bin")));
+    }
+
+    MCAutoDataRef t_missing;
+    EXPECT_FALSE(MCSFileGetContentsMapped(MCSTR("test_data_missing.bin"), &t_missing));
+    MCErrorReset();
+}
@@ -151,8 +151,8 @@ TEST(hash, native_string)
     MCAutoStringRef t_lower = string_create_native("livecode");
 
     /* Check a couple of specific values */
-    EXPECT_EQ(string_hash_exact(kMCEmptyString), {2166136261});
-    EXPECT_EQ(string_hash_exact(*t_mixed), {2613309534});
+    EXPECT_EQ(string_hash_exact(kMCEmptyString), {1373170073});
+    EXPECT_EQ(string_hash_exact(*t_mixed), {3655295994});
 
     /* Check folded vs non-folded */
     EXPECT_NE(string_hash_exact(*t_mixed), string_hash_exact(*t_lower));
@@ -177,7 +177,7 @@ TEST(hash, unicode_string)
         string_create_utf8(u8"\U0001F984 friendship is magic!");
 
     /* Check a specific value */
-    EXPECT_EQ(string_hash_exact(*t_lambda), {2244387611});
+    EXPECT_EQ(string_hash_exact(*t_lambda), {1934047813});
 
     /* Check that upper bytes of codepoints are included in hash */
     EXPECT_NE(string_hash_exact(*t_private_use), string_hash_exact(*t_unibyte));
@@ -193,3 +193,35 @@ TEST(hash, unicode_string)
     EXPECT_EQ(string_hash_caseless(*t_nonbmp_mixed),
               string_hash_caseless(*t_nonbmp_mixed));
 }
+
+TEST(hash, native_unicode_consistency)
+{
+    /* Strings of every length up to a few words, with upper-case and
+     * non-ASCII chars in varying positions relative to word boundaries */
+    const char_t k_chars[] = "The QUICK brown fox \xC9t\xE9 jumps OVER the lazy dog";
+    for (uindex_t t_length = 0; t_length < sizeof(k_chars); t_length++)
+    {
+        for (uindex_t t_offset = 0; t_offset + t_length < sizeof(k_chars); t_offset += 3)
+        {
+            MCAutoStringRef t_native, t_unicode;
+            ASSERT_TRUE(MCStringCreateWithNativeChars(k_chars + t_offset, t_length, &t_native));
+            ASSERT_TRUE(MCStringUnicodeCopy(*t_native, &t_unicode));
+            ASSERT_TRUE(t_length == 0 || !MCStringIsNative(*t_unicode));
+
+            EXPECT_EQ(string_hash_exact(*t_native), string_hash_exact(*t_unicode));
+            EXPECT_EQ(string_hash_caseless(*t_native), string_hash_caseless(*t_unicode));
+        }
+    }
+
+    /* Decomposed unicode strings hash caselessly as the composed native one */
+    MCAutoStringRef t_decomposed = string_create_utf8(u8"CAFE\u0301 Au Lait");
+    MCAutoStringRef t_composed = string_create_native("caf\xE9 au lait");
+    EXPECT_EQ(string_hash_caseless(*t_decomposed), string_hash_caseless(*t_composed));
+    EXPECT_NE(string_hash_exact(*t_decomposed), string_hash_exact(*t_composed));
+
+    /* Raw char hashes only depend on the code units */
+    const unichar_t k_units[] = {'k', 'e', 'y', '1', '2', '3', '4', '5', '6'};
+    const char_t k_native_units[] = {'k', 'e', 'y', '1', '2', '3', '4', '5', '6'};
+    EXPECT_EQ(MCHashChars(k_units, 9), MCHashNativeChars(k_native_units, 9));
+    EXPECT_NE(MCHashChars(k_units, 9), MCHashChars(k_units, 8));
+}
@@ -121,3 +121,50 @@ TEST(name, equiv_string)
         ASSERT_TRUE(MCNameIsEqualToCaseless(*t_names[i * 2], *t_names[i * 2 + 1]));
     }
 }
+
+TEST(name, table_statistics)
+{
+    MCNameTableStatistics t_before;
+    MCNameGetTableStatistics(t_before);
+    EXPECT_GE(t_before.chain_count, t_before.used_chain_count);
+    EXPECT_GE(t_before.name_count, t_before.class_count);
+
+    // Names are counted as they are created, and the table grows to keep
+    // its chains short.
+    const index_t kCount = 100000;
+    MCNameRef *t_names;
+    ASSERT_TRUE(MCMemoryNewArray(kCount, t_names));
+    for(index_t i = 0; i < kCount; i++)
+        ASSERT_TRUE(MCNameCreateWithIndex(1000000 + i, t_names[i]));
+
+    MCNewAutoNameRef t_variant;
+    ASSERT_TRUE(MCNameCreateWithNativeChars((const char_t *)"TableStatistics", 15, &t_variant));
+    MCNewAutoNameRef t_other_variant;
+    ASSERT_TRUE(MCNameCreateWithNativeChars((const char_t *)"tablestatistics", 15, &t_other_variant));
+
+    MCNameTableStatistics t_full;
+    MCNameGetTableStatistics(t_full);
+    EXPECT_EQ(t_full.name_count, t_before.name_count + kCount + 2);
+    EXPECT_EQ(t_full.class_count, t_before.class_count + kCount + 1);
+    EXPECT_GE(t_full.chain_count, t_full.class_count);
+    EXPECT_GT(t_full.used_chain_count, t_full.chain_count / 4);
+    EXPECT_GE(t_full.longest_chain_length, uindex_t(1));
+    EXPECT_GT(t_full.memory_size, t_before.memory_size);
+
+    // The table shrinks again as the names are released.
+    for(index_t i = 0; i < kCount; i++)
+        MCValueRelease(t_names[i]);
+    MCMemoryDeleteArray(t_names);
+
+    MCNameTableStatistics t_after;
+    MCNameGetTableStatistics(t_after);
+    EXPECT_EQ(t_after.name_count, t_before.name_count + 2);
+    EXPECT_LE(t_after.chain_count, t_before.chain_count);
+    EXPECT_LT(t_after.memory_size, t_full.memory_size);
+
+    // The names which remain can still be found.
+    MCNewAutoNameRef t_found;
+    ASSERT_TRUE(MCNameCreateWithNativeChars((const char_t *)"TABLESTATISTICS", 15, &t_found));
+    EXPECT_TRUE(MCNameIsEqualToCaseless(*t_found, *t_variant));
+    EXPECT_EQ(MCNameLookupCaseless(MCSTR("tableStatistics")), MCNameLookupCaseless(MCNameGetString(*t_variant)));
+}
@@ -0,0 +1,104 @@
+/* Copyright (C) 2017 LiveCode Ltd.
+ 
+ This file is part of LiveCode.
+ 
+ LiveCode is free software; you can redistribute it and/or modify it under
+ the terms of the GNU General Public License v3 as published by the Free
+ Software Foundation.
+ 
+ LiveCode is distributed in the hope that it will be useful, but WITHOUT ANY
+ WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with LiveCode.  If not see <http://www.gnu.org/licenses/>.  */
+
+#include "gtest/gtest.h"
+
+#include <cmath>
+
+#include "foundation.h"
+#include "foundation-auto.h"
+
+TEST(number, shared_integers)
+//
+// Checks that small integers are shared, and that numbers are the same
+// whether or not they are.
+//
+{
+    static integer_t s_test_integers[] =
+    {
+        INT32_MIN,
+        -1025,
+        -1024,
+        -1,
+        0,
+        1,
+        65535,
+        65536,
+        INT32_MAX,
+    };
+    for(size_t i = 0; i < sizeof(s_test_integers) / sizeof(s_test_integers[0]); i++)
+    {
+        MCAutoNumberRef t_number, t_other_number;
+        ASSERT_TRUE(MCNumberCreateWithInteger(s_test_integers[i], &t_number));
+        ASSERT_TRUE(MCNumberCreateWithInteger(s_test_integers[i], &t_other_number));
+        
+        EXPECT_TRUE(MCNumberIsInteger(*t_number));
+        EXPECT_EQ(s_test_integers[i], MCNumberFetchAsInteger(*t_number));
+        EXPECT_TRUE(MCValueIsEqualTo(*t_number, *t_other_number));
+        EXPECT_EQ(MCValueHash(*t_number), MCValueHash(*t_other_number));
+        
+        bool t_shared;
+        t_shared = s_test_integers[i] >= -1024 && s_test_integers[i] <= 65535;
+        EXPECT_EQ(t_shared, *t_number == *t_other_number);
+    }
+    
+    MCAutoNumberRef t_zero;
+    ASSERT_TRUE(MCNumberCreateWithInteger(0, &t_zero));
+    EXPECT_EQ(kMCZero, *t_zero);
+    
+    // Integral reals are never shared with integers.
+    MCAutoNumberRef t_real;
+    ASSERT_TRUE(MCNumberCreateWithReal(1.0, &t_real));
+    EXPECT_NE(kMCOne, *t_real);
+    EXPECT_TRUE(MCNumberIsReal(*t_real));
+}
+
+TEST(number, shared_reals)
+//
+// Checks that small integral reals are shared with each other, and stay reals.
+//
+{
+    static real64_t s_test_reals[] =
+    {
+        -1025.0,
+        -1024.0,
+        -0.5,
+        0.0,
+        -0.0,
+        2.0,
+        2.5,
+        65535.0,
+        65536.0,
+        1e300,
+    };
+    for(size_t i = 0; i < sizeof(s_test_reals) / sizeof(s_test_reals[0]); i++)
+    {
+        MCAutoNumberRef t_number, t_other_number;
+        ASSERT_TRUE(MCNumberCreateWithReal(s_test_reals[i], &t_number));
+        ASSERT_TRUE(MCNumberCreateWithReal(s_test_reals[i], &t_other_number));
+        
+        EXPECT_TRUE(MCNumberIsReal(*t_number));
+        EXPECT_EQ(s_test_reals[i], MCNumberFetchAsReal(*t_number));
+        EXPECT_EQ(signbit(s_test_reals[i]), signbit(MCNumberFetchAsReal(*t_number)));
+        EXPECT_TRUE(MCValueIsEqualTo(*t_number, *t_other_number));
+        
+        bool t_shared;
+        t_shared = s_test_reals[i] >= -1024.0 && s_test_reals[i] <= 65535.0 &&
+                    s_test_reals[i] == floor(s_test_reals[i]) &&
+                    !(s_test_reals[i] == 0.0 && signbit(s_test_reals[i]));
+        EXPECT_EQ(t_shared, *t_number == *t_other_number);
+    }
+}
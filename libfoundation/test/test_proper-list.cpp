@@ -20,6 +20,10 @@ along with LiveCode.  If not see <http://www.gnu.org/licenses/>.  */
 #include "foundation-span.h"
 #include "foundation-auto.h"
 
+#include <algorithm>
+#include <random>
+#include <vector>
+
 TEST(properlist, createwithforeignvalues_bridgable)
 {
     float t_floats[] = { 1.1, 2.1, 3.1, 5, 10 };
@@ -58,3 +62,119 @@ TEST(properlist, createwithforeignvalues_unbridgable)
         }
     }
 }
+
+static bool list_matches(MCProperListRef p_list, const std::vector<integer_t>& p_expected)
+{
+    if (MCProperListGetLength(p_list) != p_expected.size())
+        return false;
+    
+    uintptr_t t_iterator = 0;
+    MCValueRef t_element;
+    for (size_t i = 0; MCProperListIterate(p_list, t_iterator, t_element); i++)
+    {
+        if (MCNumberFetchAsInteger((MCNumberRef)t_element) != p_expected[i] ||
+            MCProperListFetchElementAtIndex(p_list, i) != t_element)
+            return false;
+    }
+    
+    return true;
+}
+
+TEST(properlist, shared_changes)
+//
+// Checks that changing copies of large shared lists (which are held as trees)
+// gives the same results as for flat lists, and never changes the originals.
+//
+{
+    std::mt19937 t_random(15);
+    
+    MCAutoProperListRef t_list;
+    t_list = kMCEmptyProperList;
+    std::vector<integer_t> t_expected;
+    
+    std::vector<std::pair<MCProperListRef, std::vector<integer_t>>> t_snapshots;
+    
+    for (int t_step = 0; t_step < 20000; t_step++)
+    {
+        // Each change is made as LCB does, to a mutable copy of the
+        // (shared) immutable list.
+        MCAutoProperListRef t_mutable;
+        ASSERT_TRUE(MCProperListMutableCopy(*t_list, &t_mutable));
+        
+        uindex_t t_length = t_expected.size();
+        unsigned t_operation = t_random() % 100;
+        if (t_operation < 70 || t_length < 4)
+        {
+            MCAutoNumberRef t_number;
+            ASSERT_TRUE(MCNumberCreateWithInteger(t_step, &t_number));
+            ASSERT_TRUE(MCProperListPushElementOntoBack(*t_mutable, *t_number));
+            t_expected.push_back(t_step);
+        }
+        else if (t_operation < 78)
+        {
+            MCAutoValueRef t_value;
+            ASSERT_TRUE(MCProperListPopFront(*t_mutable, &t_value));
+            EXPECT_EQ(t_expected.front(), MCNumberFetchAsInteger((MCNumberRef)*t_value));
+            t_expected.erase(t_expected.begin());
+        }
+        else if (t_operation < 86)
+        {
+            MCAutoValueRef t_value;
+            ASSERT_TRUE(MCProperListPopBack(*t_mutable, &t_value));
+            EXPECT_EQ(t_expected.back(), MCNumberFetchAsInteger((MCNumberRef)*t_value));
+            t_expected.pop_back();
+        }
+        else if (t_operation < 92)
+        {
+            uindex_t t_start = t_random() % (t_length / 2);
+            uindex_t t_count = t_random() % std::min(t_length - t_start, 600U);
+            MCAutoProperListRef t_sublist;
+            ASSERT_TRUE(MCProperListCopySublist(*t_list, MCRangeMake(t_start, t_count), &t_sublist));
+            ASSERT_TRUE(MCProperListAppendList(*t_mutable, *t_sublist));
+            t_expected.insert(t_expected.end(), t_expected.begin() + t_start, t_expected.begin() + t_start + t_count);
+        }
+        else if (t_operation < 96)
+        {
+            uindex_t t_start = t_random() % t_length;
+            ASSERT_TRUE(MCProperListRemoveElements(*t_mutable, t_start, 1));
+            t_expected.erase(t_expected.begin() + t_start);
+        }
+        else if (t_operation < 98)
+        {
+            uindex_t t_count = t_random() % (t_length / 4);
+            ASSERT_TRUE(MCProperListRemoveElements(*t_mutable, 0, t_count));
+            t_expected.erase(t_expected.begin(), t_expected.begin() + t_count);
+        }
+        else
+        {
+            ASSERT_TRUE(MCProperListReverse(*t_mutable));
+            std::reverse(t_expected.begin(), t_expected.end());
+        }
+        
+        MCAutoProperListRef t_immutable;
+        ASSERT_TRUE(MCProperListCopy(*t_mutable, &t_immutable));
+        t_list.Reset(*t_immutable);
+        
+        if (t_step % 1000 == 0)
+        {
+            ASSERT_TRUE(list_matches(*t_list, t_expected));
+            t_snapshots.push_back(std::make_pair(MCValueRetain(*t_list), t_expected));
+        }
+    }
+    
+    ASSERT_TRUE(list_matches(*t_list, t_expected));
+    
+    // Lists with the same elements are equal, however they are held.
+    MCAutoProperListRef t_flat;
+    ASSERT_TRUE(MCProperListCreateMutable(&t_flat));
+    for (uindex_t i = 0; i < MCProperListGetLength(*t_list); i++)
+        ASSERT_TRUE(MCProperListPushElementOntoBack(*t_flat, MCProperListFetchElementAtIndex(*t_list, i)));
+    EXPECT_TRUE(MCProperListIsEqualTo(*t_flat, *t_list));
+    EXPECT_TRUE(MCProperListBeginsWithList(*t_list, *t_flat));
+    
+    for (auto& t_snapshot : t_snapshots)
+    {
+        EXPECT_TRUE(list_matches(t_snapshot.first, t_snapshot.second));
+        MCValueRelease(t_snapshot.first);
+    }
+}
@@ -0,0 +1,135 @@
+/* Copyright (C) 2017 LiveCode Ltd.
+
+ This file is part of LiveCode.
+
+ LiveCode is free software; you can redistribute it and/or modify it under
+ the terms of the GNU General Public License v3 as published by the Free
+ Software Foundation.
+
+ LiveCode is distributed in the hope that it will be useful, but WITHOUT ANY
+ WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with LiveCode.  If not see <http://www.gnu.org/licenses/>.  */
+
+#include "gtest/gtest.h"
+
+#include "foundation.h"
+#include "foundation-auto.h"
+#include "foundation-system.h"
+
+TEST(stream, read_bytes)
+//
+// Checks that a stream over a data value hands out its bytes in place.
+//
+{
+    const byte_t t_bytes[] = { 1, 2, 3, 4, 5 };
+    MCAutoDataRef t_data;
+    ASSERT_TRUE(MCDataCreateWithBytes(t_bytes, sizeof(t_bytes), &t_data));
+
+    MCAutoValueRefBase<MCStreamRef> t_stream;
+    ASSERT_TRUE(MCMemoryInputStreamCreateWithData(*t_data, &t_stream));
+    ASSERT_TRUE(MCStreamIsMapped(*t_stream));
+
+    const void *t_view;
+    ASSERT_TRUE(MCStreamReadBytes(*t_stream, 2, t_view));
+    EXPECT_EQ(MCDataGetBytePtr(*t_data), t_view);
+
+    uint8_t t_byte;
+    ASSERT_TRUE(MCStreamReadUInt8(*t_stream, t_byte));
+    EXPECT_EQ(3, t_byte);
+
+    ASSERT_TRUE(MCStreamReadBytes(*t_stream, 2, t_view));
+    EXPECT_EQ(4, static_cast<const byte_t *>(t_view)[0]);
+    EXPECT_FALSE(MCStreamReadBytes(*t_stream, 1, t_view));
+
+    MCAutoValueRefBase<MCStreamRef> t_output;
+    ASSERT_TRUE(MCMemoryOutputStreamCreate(&t_output));
+    EXPECT_FALSE(MCStreamIsMapped(*t_output));
+}
+
+TEST(stream, buffered)
+//
+// Checks that reads and writes of assorted sizes through a buffered file
+// stream give the same bytes as the file holds.
+//
+{
+    const uindex_t kLength = 10000;
+    byte_t t_bytes[kLength];
+    for (uindex_t i = 0; i < kLength; i++)
+        t_bytes[i] = byte_t(i * 31);
+
+    {
+        MCAutoValueRefBase<MCStreamRef> t_file, t_stream;
+        ASSERT_TRUE(MCSFileCreateStream(MCSTR("test_stream_buffered.bin"), kMCSFileOpenModeWrite, &t_file));
+        ASSERT_TRUE(MCBufferedStreamCreate(*t_file, 64, &t_stream));
+        for (uindex_t i = 0, n = 1; i < kLength; i += n, n = n * 3 % 97 + 1)
+            ASSERT_TRUE(MCStreamWrite(*t_stream, t_bytes + i, MCMin(n, kLength - i)));
+        ASSERT_TRUE(MCBufferedStreamFlush(*t_stream));
+    }
+
+    MCAutoDataRef t_written;
+    ASSERT_TRUE(MCSFileGetContents(MCSTR("test_stream_buffered.bin"), &t_written));
+    ASSERT_EQ(kLength, MCDataGetLength(*t_written));
+    EXPECT_EQ(0, memcmp(t_bytes, MCDataGetBytePtr(*t_written), kLength));
+
+    {
+        MCAutoValueRefBase<MCStreamRef> t_file, t_stream;
+        ASSERT_TRUE(MCSFileCreateStream(MCSTR("test_stream_buffered.bin"), kMCSFileOpenModeRead, &t_file));
+        ASSERT_TRUE(MCBufferedStreamCreate(*t_file, 64, &t_stream));
+
+        byte_t t_read[kLength];
+        uindex_t i = 0;
+        for (uindex_t n = 1; i + n <= kLength; i += n, n = n * 5 % 101 + 1)
+        {
+            filepos_t t_position;
+            ASSERT_TRUE(MCStreamTell(*t_stream, t_position));
+            EXPECT_EQ(filepos_t(i), t_position);
+            ASSERT_TRUE(MCStreamRead(*t_stream, t_read + i, n));
+        }
+        ASSERT_TRUE(MCStreamRead(*t_stream, t_read + i, kLength - i));
+        EXPECT_EQ(0, memcmp(t_bytes, t_read, kLength));
+
+        ASSERT_TRUE(MCStreamSeek(*t_stream, 100));
+        ASSERT_TRUE(MCStreamSkip(*t_stream, 5));
+        uint8_t t_byte;
+        ASSERT_TRUE(MCStreamReadUInt8(*t_stream, t_byte));
+        EXPECT_EQ(t_bytes[105], t_byte);
+    }
+
+    ASSERT_TRUE(MCSFileDelete(MCSTR("test_stream_buffered.bin")));
+}
+
+TEST(stream, mapped_file)
+//
+// Checks that a mapped file stream reads the file's contents.
+//
+{
+    const uindex_t kLength = 2 * 1024 * 1024;
+    MCAutoDataRef t_mutable;
+    ASSERT_TRUE(MCDataCreateMutable(0, &t_mutable));
+    for (uindex_t i = 0; i < kLength; i++)
+        ASSERT_TRUE(MCDataAppendByte(*t_mutable, byte_t(i * 13)));
+
+    MCAutoDataRef t_data;
+    ASSERT_TRUE(MCDataCopy(*t_mutable, &t_data));
+    ASSERT_TRUE(MCSFileSetContents(MCSTR("test_stream_mapped.bin"), *t_data));
+
+    {
+        MCAutoValueRefBase<MCStreamRef> t_stream;
+        ASSERT_TRUE(MCSFileCreateMappedStream(MCSTR("test_stream_mapped.bin"), &t_stream));
+        ASSERT_TRUE(MCStreamIsMapped(*t_stream));
+
+        const void *t_view;
+        ASSERT_TRUE(MCStreamReadBytes(*t_stream, kLength, t_view));
+        EXPECT_EQ(0, memcmp(MCDataGetBytePtr(*t_data), t_view, kLength));
+
+        bool t_finished;
+        ASSERT_TRUE(MCStreamIsFinished(*t_stream, t_finished));
+        EXPECT_TRUE(t_finished);
+    }
+
+    ASSERT_TRUE(MCSFileDelete(MCSTR("test_stream_mapped.bin")));
+}
@@ -20,6 +20,10 @@ along with LiveCode.  If not see <http://www.gnu.org/licenses/>.  */
 #include "foundation-unicode.h"
 #include "foundation-auto.h"
 
+#include <algorithm>
+#include <string>
+#include <vector>
+
 
 TEST(string, creation)
 //
@@ -185,3 +189,895 @@ TEST(string, surrogate_unicode_props)
     const int kSPUA_B_Upper = 0x10FFFD + 1; // non-inclusive
     check_bidi_of_surrogate_range(kSPUA_B_Lower, kSPUA_B_Upper);
 }
+
+static void check_find_nth_matches_find(MCStringRef p_string, MCStringRef p_needle, MCStringOptions p_options)
+{
+    uindex_t t_length = MCStringGetLength(p_string);
+    MCAutoArray<MCRange> t_expected;
+    uindex_t t_offset = 0;
+    MCRange t_found;
+    while (MCStringFind(p_string, MCRangeMakeMinMax(t_offset, t_length), p_needle, p_options, &t_found))
+    {
+        ASSERT_TRUE(t_expected.Push(t_found));
+        t_offset = t_found.offset + t_found.length;
+    }
+
+    // Search several times, so that any index is built and used.
+    for (int t_pass = 0; t_pass < 3; t_pass++)
+    {
+        for (uindex_t i = 0; i < t_expected.Size(); i += 97)
+        {
+            uindex_t t_count;
+            ASSERT_TRUE(MCStringFindNth(p_string, MCRangeMake(0, t_length), p_needle, p_options, i, t_count, &t_found));
+            EXPECT_EQ(i + 1, t_count);
+            EXPECT_EQ(t_expected[i].offset, t_found.offset);
+            EXPECT_EQ(t_expected[i].length, t_found.length);
+        }
+
+        uindex_t t_count;
+        t_found = MCRangeMake(0, 0);
+        EXPECT_FALSE(MCStringFindNth(p_string, MCRangeMake(0, t_length), p_needle, p_options, t_expected.Size(), t_count, &t_found));
+        EXPECT_EQ(t_expected.Size(), t_count);
+        if (t_expected.Size() != 0)
+            EXPECT_EQ(t_expected[t_expected.Size() - 1].offset, t_found.offset);
+
+        EXPECT_EQ(t_expected.Size(), MCStringCount(p_string, MCRangeMake(0, t_length), p_needle, p_options));
+
+        // A range starting just after the first occurrence skips it.
+        if (t_expected.Size() > 1)
+        {
+            uindex_t t_start = t_expected[0].offset + 1;
+            ASSERT_TRUE(MCStringFindNth(p_string, MCRangeMake(t_start, t_length - t_start), p_needle, p_options, 0, t_count, &t_found));
+            EXPECT_EQ(t_expected[1].offset, t_found.offset);
+            EXPECT_EQ(t_expected.Size() - 1, MCStringCount(p_string, MCRangeMake(t_start, t_length - t_start), p_needle, p_options));
+        }
+    }
+}
+
+static void create_lines(uindex_t p_count, const char *p_format, MCStringRef& r_string, unichar_t p_prefix = 0)
+{
+    MCAutoStringRef t_mutable;
+    ASSERT_TRUE(MCStringCreateMutable(0, &t_mutable));
+    for (uindex_t i = 0; i < p_count; i++)
+    {
+        if (p_prefix != 0)
+            ASSERT_TRUE(MCStringAppendChar(*t_mutable, p_prefix));
+        ASSERT_TRUE(MCStringAppendFormat(*t_mutable, p_format, i));
+    }
+    ASSERT_TRUE(MCStringCopy(*t_mutable, r_string));
+}
+
+TEST(string, find_nth)
+//
+// Checks that MCStringFindNth agrees with repeated calls to MCStringFind, both
+// for short strings and for long ones where the delimiter offsets are indexed.
+//
+{
+    MCAutoStringRef t_short;
+    create_lines(10, "line %u\n", &t_short);
+    check_find_nth_matches_find(*t_short, kMCLineEndString, kMCStringOptionCompareCaseless);
+
+    MCAutoStringRef t_native;
+    create_lines(5000, "Line %u,A,a,\n", &t_native);
+    ASSERT_TRUE(MCStringIsNative(*t_native));
+    check_find_nth_matches_find(*t_native, kMCLineEndString, kMCStringOptionCompareCaseless);
+    check_find_nth_matches_find(*t_native, MCSTR(","), kMCStringOptionCompareCaseless);
+    check_find_nth_matches_find(*t_native, MCSTR("a"), kMCStringOptionCompareExact);
+    check_find_nth_matches_find(*t_native, MCSTR("a"), kMCStringOptionCompareCaseless);
+
+    MCAutoStringRef t_unicode;
+    create_lines(5000, "%u,\n", &t_unicode, 0x03B1);
+    ASSERT_FALSE(MCStringIsNative(*t_unicode));
+    check_find_nth_matches_find(*t_unicode, kMCLineEndString, kMCStringOptionCompareCaseless);
+    check_find_nth_matches_find(*t_unicode, MCSTR(","), kMCStringOptionCompareExact);
+
+    MCStringFlushDelimiterIndexCache();
+    check_find_nth_matches_find(*t_native, kMCLineEndString, kMCStringOptionCompareCaseless);
+}
+
+TEST(string, find_nth_after_mutation)
+//
+// Checks that the delimiter index of a string is discarded when it is mutated.
+//
+{
+    MCStringRef t_string;
+    create_lines(5000, "%u\n", t_string);
+
+    uindex_t t_count;
+    MCRange t_found;
+    for (int i = 0; i < 3; i++)
+        ASSERT_TRUE(MCStringFindNth(t_string, MCRangeMake(0, UINDEX_MAX), kMCLineEndString, kMCStringOptionCompareExact, 10, t_count, &t_found));
+    EXPECT_EQ(5000u, MCStringCount(t_string, MCRangeMake(0, UINDEX_MAX), kMCLineEndString, kMCStringOptionCompareExact));
+
+    MCStringRef t_mutable;
+    ASSERT_TRUE(MCStringMutableCopyAndRelease(t_string, t_mutable));
+    ASSERT_TRUE(MCStringPrepend(t_mutable, MCSTR("\n\n")));
+
+    MCStringRef t_copy;
+    ASSERT_TRUE(MCStringCopyAndRelease(t_mutable, t_copy));
+    for (int i = 0; i < 3; i++)
+    {
+        ASSERT_TRUE(MCStringFindNth(t_copy, MCRangeMake(0, UINDEX_MAX), kMCLineEndString, kMCStringOptionCompareExact, 1, t_count, &t_found));
+        EXPECT_EQ(1u, t_found.offset);
+    }
+    EXPECT_EQ(5002u, MCStringCount(t_copy, MCRangeMake(0, UINDEX_MAX), kMCLineEndString, kMCStringOptionCompareExact));
+
+    MCValueRelease(t_copy);
+}
+
+// Creates a native string from 'chars', and a non-native string with the same
+// chars followed by a bullet (which cannot be native) so that the unicode code
+// paths can be used to check the (vectorized) native ones.
+static void create_native_and_unicode(const char_t *p_chars, uindex_t p_length, MCStringRef& r_native, MCStringRef& r_unicode)
+{
+    ASSERT_TRUE(MCStringCreateWithNativeChars(p_chars, p_length, r_native));
+    ASSERT_TRUE(MCStringIsNative(r_native));
+
+    MCAutoArray<unichar_t> t_chars;
+    ASSERT_TRUE(t_chars.Resize(p_length + 1));
+    MCStringGetChars(r_native, MCRangeMake(0, p_length), t_chars.Ptr());
+    t_chars[p_length] = 0x2022;
+    ASSERT_TRUE(MCStringCreateWithChars(t_chars.Ptr(), p_length + 1, r_unicode));
+    ASSERT_FALSE(MCStringIsNative(r_unicode));
+}
+
+// Changes the case of the chars used by the native_scan test.
+static char_t native_scan_lower(char_t p_char)
+{
+    if ((p_char >= 'A' && p_char <= 'Z') || p_char == 0xc9)
+        return p_char + 0x20;
+    return p_char;
+}
+
+static char_t native_scan_upper(char_t p_char)
+{
+    if ((p_char >= 'a' && p_char <= 'z') || p_char == 0xe9)
+        return p_char - 0x20;
+    return p_char;
+}
+
+TEST(string, native_scan)
+//
+// Checks that searching, counting and comparing native strings agrees with
+// doing the same to unicode strings, for a variety of lengths so that both
+// the vector and scalar parts of the native operations are used.
+//
+{
+    static const char_t kAlphabet[] = { 'a', 'A', 'b', 'B', ',', '\n', 0xe9, 0xc9, 'x' };
+    const MCStringOptions kOptions[] = { kMCStringOptionCompareExact, kMCStringOptionCompareCaseless };
+
+    uint32_t t_seed = 12345;
+    for (int t_trial = 0; t_trial < 400; t_trial++)
+    {
+        char_t t_chars[300];
+        uindex_t t_length = t_trial % 150 + (t_trial % 7) * 20;
+        for (uindex_t i = 0; i < t_length; i++)
+        {
+            t_seed = t_seed * 1103515245 + 12345;
+            t_chars[i] = kAlphabet[(t_seed >> 16) % sizeof(kAlphabet)];
+        }
+
+        // Take the needle from the haystack, with its case flipped.
+        char_t t_needle_chars[8];
+        uindex_t t_needle_length = t_trial % 6 + 1;
+        if (t_needle_length > t_length)
+            continue;
+        uindex_t t_needle_offset = (t_seed >> 8) % (t_length - t_needle_length + 1);
+        for (uindex_t i = 0; i < t_needle_length; i++)
+        {
+            char_t t_char = t_chars[t_needle_offset + i];
+            t_needle_chars[i] = (t_trial & 1) ? native_scan_lower(t_char) : native_scan_upper(t_char);
+        }
+
+        MCAutoStringRef t_native, t_unicode, t_native_needle, t_unicode_needle;
+        create_native_and_unicode(t_chars, t_length, &t_native, &t_unicode);
+        create_native_and_unicode(t_needle_chars, t_needle_length, &t_native_needle, &t_unicode_needle);
+        MCAutoStringRef t_needle;
+        ASSERT_TRUE(MCStringCopySubstring(*t_unicode_needle, MCRangeMake(0, t_needle_length), &t_needle));
+
+        for (MCStringOptions t_options : kOptions)
+        {
+            MCRange t_range = MCRangeMake(0, t_length);
+
+            MCRange t_native_found, t_unicode_found;
+            bool t_found = MCStringFind(*t_unicode, t_range, *t_needle, t_options, &t_unicode_found);
+            ASSERT_EQ(t_found, MCStringFind(*t_native, t_range, *t_native_needle, t_options, &t_native_found));
+            if (t_found)
+                EXPECT_EQ(t_unicode_found.offset, t_native_found.offset);
+
+            EXPECT_EQ(MCStringCount(*t_unicode, t_range, *t_needle, t_options),
+                      MCStringCount(*t_native, t_range, *t_native_needle, t_options));
+
+            MCAutoStringRef t_delimiter;
+            ASSERT_TRUE(MCStringCreateWithNativeChars(t_chars + t_length / 2, 1, &t_delimiter));
+            uindex_t t_native_index, t_unicode_index;
+            MCRange t_native_before, t_unicode_before, t_native_after, t_unicode_after;
+            t_found = MCStringDelimitedOffset(*t_unicode, t_range, *t_needle, *t_delimiter, t_trial % 3, t_options, t_unicode_index, &t_unicode_found, &t_unicode_before, &t_unicode_after);
+            ASSERT_EQ(t_found, MCStringDelimitedOffset(*t_native, t_range, *t_native_needle, *t_delimiter, t_trial % 3, t_options, t_native_index, &t_native_found, &t_native_before, &t_native_after));
+            if (t_found)
+            {
+                EXPECT_EQ(t_unicode_index, t_native_index);
+                EXPECT_EQ(t_unicode_found.offset, t_native_found.offset);
+                // The paths differ as to the before range when no delimiter
+                // follows the skipped ones, so only check it when there is.
+                if (t_native_index > uindex_t(t_trial % 3))
+                    EXPECT_EQ(t_unicode_before.offset, t_native_before.offset);
+                EXPECT_EQ(t_unicode_after.offset, t_native_after.offset);
+            }
+        }
+
+        // Compare the haystack with a case-changed copy of itself.
+        char_t t_other_chars[300];
+        for (uindex_t i = 0; i < t_length; i++)
+            t_other_chars[i] = (i + t_trial) % 3 == 0 ? native_scan_upper(t_chars[i]) : t_chars[i];
+        if (t_length > 0 && t_trial % 5 == 0)
+            t_other_chars[t_trial % t_length] = 'z';
+
+        MCAutoStringRef t_other_native, t_other_unicode;
+        create_native_and_unicode(t_other_chars, t_length, &t_other_native, &t_other_unicode);
+        for (MCStringOptions t_options : kOptions)
+            EXPECT_EQ(MCStringSubstringIsEqualToSubstring(*t_unicode, MCRangeMake(0, t_length), *t_other_unicode, MCRangeMake(0, t_length), t_options),
+                      MCStringIsEqualTo(*t_native, *t_other_native, t_options));
+    }
+}
+
+// Finds the needle by comparing it with the filters at each offset, which is
+// what MCUnicodeFind does when its fast tier does not apply.
+static bool unicode_find_reference(const unichar_t *p_string, uindex_t p_length, const unichar_t *p_needle, uindex_t p_needle_length, MCUnicodeCompareOption p_option, MCRange& r_range, uindex_t& r_last)
+{
+    bool t_found = false;
+    for (uindex_t t_offset = 0; t_offset < p_length; t_offset++)
+    {
+        uindex_t t_string_length, t_needle_length;
+        MCUnicodeSharedPrefix(p_string + t_offset, p_length - t_offset, false, p_needle, p_needle_length, false, p_option, t_string_length, t_needle_length);
+        if (t_needle_length != p_needle_length)
+            continue;
+        if (!t_found)
+            r_range = MCRangeMake(t_offset, t_string_length);
+        r_last = t_offset;
+        t_found = true;
+    }
+    return t_found;
+}
+
+TEST(string, unicode_fast_find)
+//
+// Checks that searching UTF-16 strings agrees with comparing using the
+// filters, both for strings which the fast tier handles on its own and for
+// strings with chars (combining marks, surrogates, controls and chars which
+// change under normalization) which it must pass to the filters.
+//
+{
+    static const unichar_t kSimple[] = { 'a', 'A', 'k', 'K', 's', 0x17f, '\n', ' ', 0xe9, 0xc9, 0xdf, 0x1e9e, 0x4e2d };
+    static const unichar_t kIrregular[] = { 0x212a, 0x301, 0x1, 0xd83d, 0xde00 };
+    const MCUnicodeCompareOption kOptions[] = { kMCUnicodeCompareOptionExact, kMCUnicodeCompareOptionNormalised, kMCUnicodeCompareOptionFolded, kMCUnicodeCompareOptionCaseless };
+
+    uint32_t t_seed = 54321;
+    for (int t_trial = 0; t_trial < 600; t_trial++)
+    {
+        bool t_irregular = t_trial % 2 == 1;
+
+        unichar_t t_chars[200];
+        uindex_t t_length = t_trial % 97 + (t_trial % 3) * 30;
+        for (uindex_t i = 0; i < t_length; i++)
+        {
+            t_seed = t_seed * 1103515245 + 12345;
+            uint32_t t_pick = (t_seed >> 16) % 64;
+            if (t_irregular && t_pick < sizeof(kIrregular) / sizeof(kIrregular[0]))
+                t_chars[i] = kIrregular[t_pick];
+            else
+                t_chars[i] = kSimple[t_pick % (sizeof(kSimple) / sizeof(kSimple[0]))];
+        }
+
+        // Take the needle from the haystack, with the case of some chars
+        // flipped.
+        unichar_t t_needle[8];
+        uindex_t t_needle_length = t_trial % 5 + 1;
+        if (t_needle_length > t_length)
+            continue;
+        uindex_t t_needle_offset = (t_seed >> 8) % (t_length - t_needle_length + 1);
+        for (uindex_t i = 0; i < t_needle_length; i++)
+        {
+            unichar_t t_char = t_chars[t_needle_offset + i];
+            if ((t_trial + i) % 3 == 0)
+                t_char = MCUnicodeGetCharacterProperty(t_char, kMCUnicodePropertyUppercaseMapping);
+            t_needle[i] = t_char;
+        }
+
+        for (MCUnicodeCompareOption t_option : kOptions)
+        {
+            MCRange t_expected, t_range;
+            uindex_t t_expected_last;
+            bool t_found = unicode_find_reference(t_chars, t_length, t_needle, t_needle_length, t_option, t_expected, t_expected_last);
+            ASSERT_EQ(t_found, MCUnicodeFind(t_chars, t_length, false, t_needle, t_needle_length, false, t_option, t_range));
+            if (t_found)
+            {
+                EXPECT_EQ(t_expected.offset, t_range.offset);
+                EXPECT_EQ(t_expected.length, t_range.length);
+            }
+
+            // Without irregular chars, the first and last matches are the
+            // first and last offsets at which the needle matches.
+            if (t_irregular)
+                continue;
+
+            uindex_t t_index;
+            ASSERT_EQ(t_found, MCUnicodeFirstIndexOf(t_chars, t_length, false, t_needle, t_needle_length, false, t_option, t_index));
+            if (t_found)
+                EXPECT_EQ(t_expected.offset, t_index);
+            ASSERT_EQ(t_found, MCUnicodeLastIndexOf(t_chars, t_length, false, t_needle, t_needle_length, false, t_option, t_index));
+            if (t_found)
+                EXPECT_EQ(t_expected_last, t_index);
+        }
+    }
+
+    // A decomposed match is only found when normalizing.
+    static const unichar_t kCafe[] = { 'c', 'a', 'f', 'e', 0x301, ' ', 'c', 'a', 'f', 0xe9, ' ', 'x' };
+    static const unichar_t kNeedle[] = { 'C', 'A', 'F', 0xc9 };
+    uindex_t t_index;
+    MCRange t_range;
+    ASSERT_TRUE(MCUnicodeFind(kCafe, 12, false, kNeedle, 4, false, kMCUnicodeCompareOptionCaseless, t_range));
+    EXPECT_EQ(0U, t_range.offset);
+    EXPECT_EQ(5U, t_range.length);
+    ASSERT_TRUE(MCUnicodeFirstIndexOf(kCafe, 12, false, kNeedle, 4, false, kMCUnicodeCompareOptionCaseless, t_index));
+    EXPECT_EQ(0U, t_index);
+    ASSERT_TRUE(MCUnicodeLastIndexOf(kCafe, 12, false, kNeedle, 4, false, kMCUnicodeCompareOptionCaseless, t_index));
+    EXPECT_EQ(6U, t_index);
+    ASSERT_TRUE(MCUnicodeFind(kCafe, 12, false, kNeedle, 4, false, kMCUnicodeCompareOptionFolded, t_range));
+    EXPECT_EQ(6U, t_range.offset);
+
+    // A native needle is mapped to UTF-16.
+    static const char_t kNativeNeedle[] = { 'C', 'A', 'F', 0xc9, ' ' };
+    ASSERT_TRUE(MCUnicodeFind(kCafe, 12, false, kNativeNeedle, 5, true, kMCUnicodeCompareOptionCaseless, t_range));
+    EXPECT_EQ(0U, t_range.offset);
+    ASSERT_TRUE(MCUnicodeLastIndexOf(kCafe, 12, false, kNativeNeedle, 5, true, kMCUnicodeCompareOptionCaseless, t_index));
+    EXPECT_EQ(6U, t_index);
+}
+
+// Checks that the string has the chars of the reference.
+static void check_string_chars(MCStringRef p_string, const std::vector<unichar_t>& p_reference)
+{
+    ASSERT_EQ(p_reference.size(), MCStringGetLength(p_string));
+
+    std::vector<unichar_t> t_chars(p_reference.size() + 1);
+    MCStringGetChars(p_string, MCRangeMake(0, p_reference.size()), t_chars.data());
+    for (size_t i = 0; i < p_reference.size(); i++)
+        ASSERT_EQ(p_reference[i], t_chars[i]) << "at " << i;
+}
+
+TEST(string, rope_edits)
+//
+// Checks that editing large strings, which are held as ropes when edited
+// other than at their end, agrees with editing a flat buffer. Copies are
+// taken while editing to check that flattening a rope does not disturb them.
+//
+{
+    std::vector<unichar_t> t_reference;
+    MCStringRef t_string;
+    ASSERT_TRUE(MCStringCreateMutable(0, t_string));
+    for (uindex_t i = 0; i < 100000; i++)
+    {
+        char_t t_char = 'a' + i % 26;
+        t_reference.push_back(t_char);
+        ASSERT_TRUE(MCStringAppendNativeChar(t_string, t_char));
+    }
+
+    MCStringRef t_copy = nil;
+    std::vector<unichar_t> t_copy_reference;
+
+    uint32_t t_seed = 12345;
+    for (int t_op = 0; t_op < 3000; t_op++)
+    {
+        // Make some chars to edit with. Later on these include chars which
+        // are not native.
+        unichar_t t_chars[16];
+        char_t t_native_chars[16];
+        t_seed = t_seed * 1103515245 + 12345;
+        uindex_t t_count = (t_seed >> 16) % 16;
+        bool t_native = t_op < 1500 || t_op % 3 != 0;
+        for (uindex_t i = 0; i < t_count; i++)
+        {
+            t_native_chars[i] = 'A' + (t_op + i) % 26;
+            t_chars[i] = t_native_chars[i];
+        }
+        if (!t_native && t_count != 0)
+            t_chars[t_count - 1] = t_op < 2500 ? 0xe9 : 0x2022;
+
+        t_seed = t_seed * 1103515245 + 12345;
+        uindex_t t_offset = (t_seed >> 8) % (t_reference.size() + 1);
+        uindex_t t_length = MCMin<uindex_t>((t_seed >> 4) % 24, t_reference.size() - t_offset);
+
+        switch (t_op % 5)
+        {
+        case 0:
+            t_offset = 0;
+            t_length = 0;
+            ASSERT_TRUE(t_native ? MCStringPrependNativeChars(t_string, t_native_chars, t_count) : MCStringPrependChars(t_string, t_chars, t_count));
+            break;
+        case 1:
+            t_offset = t_reference.size();
+            t_length = 0;
+            ASSERT_TRUE(t_native ? MCStringAppendNativeChars(t_string, t_native_chars, t_count) : MCStringAppendChars(t_string, t_chars, t_count));
+            break;
+        case 2:
+            t_length = 0;
+            ASSERT_TRUE(t_native ? MCStringInsertNativeChars(t_string, t_offset, t_native_chars, t_count) : MCStringInsertChars(t_string, t_offset, t_chars, t_count));
+            break;
+        case 3:
+        {
+            MCAutoStringRef t_replacement;
+            ASSERT_TRUE(t_native ? MCStringCreateWithNativeChars(t_native_chars, t_count, &t_replacement) : MCStringCreateWithChars(t_chars, t_count, &t_replacement));
+            ASSERT_TRUE(MCStringReplace(t_string, MCRangeMake(t_offset, t_length), *t_replacement));
+            break;
+        }
+        case 4:
+            t_count = 0;
+            ASSERT_TRUE(MCStringRemove(t_string, MCRangeMake(t_offset, t_length)));
+            break;
+        }
+
+        t_reference.erase(t_reference.begin() + t_offset, t_reference.begin() + t_offset + t_length);
+        t_reference.insert(t_reference.begin() + t_offset, t_chars, t_chars + t_count);
+        ASSERT_EQ(t_reference.size(), MCStringGetLength(t_string));
+
+        if (t_op % 1000 == 0)
+        {
+            if (t_copy != nil)
+            {
+                check_string_chars(t_copy, t_copy_reference);
+                MCValueRelease(t_copy);
+            }
+            ASSERT_TRUE(MCStringCopy(t_string, t_copy));
+            t_copy_reference = t_reference;
+        }
+    }
+
+    check_string_chars(t_string, t_reference);
+    check_string_chars(t_copy, t_copy_reference);
+    EXPECT_FALSE(MCStringIsNative(t_string));
+
+    // Appending a string to itself must see its chars before the append.
+    ASSERT_TRUE(MCStringPrependNativeChars(t_string, (const char_t *)"xyz", 3));
+    ASSERT_TRUE(MCStringAppend(t_string, t_string));
+    t_reference.insert(t_reference.begin(), { 'x', 'y', 'z' });
+    std::vector<unichar_t> t_prefix(t_reference);
+    t_reference.insert(t_reference.end(), t_prefix.begin(), t_prefix.end());
+    check_string_chars(t_string, t_reference);
+
+    MCValueRelease(t_copy);
+    MCValueRelease(t_string);
+}
+
+TEST(string, rope_copies)
+//
+// Checks that copies of a rope, which share it, are unaffected by edits to
+// each other, and behave as ordinary strings when read.
+//
+{
+    std::vector<unichar_t> t_reference;
+    MCAutoStringRef t_string;
+    ASSERT_TRUE(MCStringCreateMutable(0, &t_string));
+    for (uindex_t i = 0; i < 100000; i++)
+    {
+        char_t t_char = 'a' + i % 26;
+        t_reference.push_back(t_char);
+        ASSERT_TRUE(MCStringAppendNativeChar(*t_string, t_char));
+    }
+    ASSERT_TRUE(MCStringPrependNativeChars(*t_string, (const char_t *)"xyz", 3));
+    t_reference.insert(t_reference.begin(), { 'x', 'y', 'z' });
+
+    MCAutoStringRef t_copy;
+    ASSERT_TRUE(MCStringCopy(*t_string, &t_copy));
+    EXPECT_FALSE(MCStringIsMutable(*t_copy));
+    std::vector<unichar_t> t_copy_reference(t_reference);
+
+    MCAutoStringRef t_mutable_copy;
+    ASSERT_TRUE(MCStringMutableCopy(*t_copy, &t_mutable_copy));
+    std::vector<unichar_t> t_mutable_copy_reference(t_reference);
+
+    // Edit the original and the mutable copy differently.
+    ASSERT_TRUE(MCStringInsertNativeChars(*t_string, 50000, (const char_t *)"123", 3));
+    t_reference.insert(t_reference.begin() + 50000, { '1', '2', '3' });
+    ASSERT_TRUE(MCStringRemove(*t_mutable_copy, MCRangeMake(10, 20)));
+    t_mutable_copy_reference.erase(t_mutable_copy_reference.begin() + 10, t_mutable_copy_reference.begin() + 30);
+    ASSERT_TRUE(MCStringPrependNativeChars(*t_mutable_copy, (const char_t *)"!", 1));
+    t_mutable_copy_reference.insert(t_mutable_copy_reference.begin(), '!');
+
+    check_string_chars(*t_copy, t_copy_reference);
+    check_string_chars(*t_string, t_reference);
+    check_string_chars(*t_mutable_copy, t_mutable_copy_reference);
+
+    // The immutable copy compares, hashes and finds like a flat string.
+    MCAutoStringRef t_flat;
+    ASSERT_TRUE(MCStringCreateWithChars(t_copy_reference.data(), t_copy_reference.size(), &t_flat));
+    EXPECT_TRUE(MCStringIsEqualTo(*t_copy, *t_flat, kMCStringOptionCompareExact));
+    EXPECT_EQ(MCStringHash(*t_copy, kMCStringOptionCompareExact), MCStringHash(*t_flat, kMCStringOptionCompareExact));
+    EXPECT_EQ('x', MCStringGetNativeCharAtIndex(*t_copy, 0));
+
+    // Copying and releasing the only reference to a rope keeps its chars.
+    MCStringRef t_released;
+    ASSERT_TRUE(MCStringMutableCopy(*t_string, t_released));
+    ASSERT_TRUE(MCStringInsertNativeChars(t_released, 1000, (const char_t *)"456", 3));
+    ASSERT_TRUE(MCStringCopyAndRelease(t_released, t_released));
+    EXPECT_FALSE(MCStringIsMutable(t_released));
+    std::vector<unichar_t> t_released_reference(t_reference);
+    t_released_reference.insert(t_released_reference.begin() + 1000, { '4', '5', '6' });
+    check_string_chars(t_released, t_released_reference);
+    MCValueRelease(t_released);
+
+    check_string_chars(*t_string, t_reference);
+}
+
+TEST(string, substring_slices)
+//
+// Checks that substrings (which may share the chars of the string they are
+// taken from) are unaffected by releasing that string, or by it changing
+// its representation.
+//
+{
+    char_t t_native[1000];
+    for (int i = 0; i < 1000; i++)
+        t_native[i] = 'a' + i % 26;
+
+    MCStringRef t_string;
+    ASSERT_TRUE(MCStringCreateWithNativeChars(t_native, 1000, t_string));
+
+    MCAutoStringRef t_substring, t_shared, t_tail;
+    ASSERT_TRUE(MCStringCopySubstring(t_string, MCRangeMake(100, 50), &t_substring));
+    ASSERT_TRUE(MCStringCopySubstringShared(*t_substring, MCRangeMake(10, 5), &t_shared));
+    ASSERT_TRUE(MCStringCopySubstring(t_string, MCRangeMake(990, 10), &t_tail));
+
+    // Unnativizing the string replaces its chars.
+    ASSERT_NE(nullptr, MCStringGetCharPtr(t_string));
+    EXPECT_FALSE(MCStringIsNative(t_string));
+    EXPECT_EQ('a' + 1 % 26, MCStringGetCharAtIndex(t_string, 1));
+    MCValueRelease(t_string);
+
+    // Substrings are NUL terminated when their chars are requested.
+    EXPECT_EQ(0, strncmp(MCStringGetCString(*t_substring), (const char *)t_native + 100, 50));
+    EXPECT_EQ(50U, strlen(MCStringGetCString(*t_substring)));
+    EXPECT_EQ(0, strcmp(MCStringGetCString(*t_shared), "ghijk"));
+    EXPECT_TRUE(MCStringIsEqualToCString(*t_tail, "cdefghijkl", kMCStringOptionCompareExact));
+    EXPECT_EQ(0, strcmp(MCStringGetCString(*t_tail), "cdefghijkl"));
+
+    // Unicode substrings are native if they can be.
+    unichar_t t_unicode[1000];
+    for (int i = 0; i < 1000; i++)
+        t_unicode[i] = i % 100 == 0 ? 0x2022 : t_native[i];
+    ASSERT_TRUE(MCStringCreateWithChars(t_unicode, 1000, t_string));
+
+    MCAutoStringRef t_with_bullet, t_without_bullet;
+    ASSERT_TRUE(MCStringCopySubstring(t_string, MCRangeMake(150, 100), &t_with_bullet));
+    ASSERT_TRUE(MCStringCopySubstring(t_string, MCRangeMake(101, 50), &t_without_bullet));
+    EXPECT_FALSE(MCStringIsNative(*t_with_bullet));
+    EXPECT_TRUE(MCStringIsNative(*t_without_bullet));
+
+    // Nativizing the string replaces its chars.
+    MCStringRef t_native_copy;
+    ASSERT_TRUE(MCStringNativeCopy(t_string, t_native_copy));
+    MCValueRelease(t_native_copy);
+    MCValueRelease(t_string);
+
+    ASSERT_EQ(100U, MCStringGetLength(*t_with_bullet));
+    EXPECT_EQ(0, memcmp(MCStringGetCharPtr(*t_with_bullet), t_unicode + 150, 100 * sizeof(unichar_t)));
+    EXPECT_EQ(0, MCStringGetCharPtr(*t_with_bullet)[100]);
+    EXPECT_TRUE(MCStringIsEqualToNativeChars(*t_without_bullet, t_native + 101, 50, kMCStringOptionCompareExact));
+
+    // A substring which is the only reference can be made mutable and changed.
+    MCStringRef t_mutable;
+    ASSERT_TRUE(MCStringMutableCopyAndRelease(t_with_bullet.Take(), t_mutable));
+    ASSERT_TRUE(MCStringAppendNativeChars(t_mutable, t_native, 1000));
+    ASSERT_EQ(1100U, MCStringGetLength(t_mutable));
+    EXPECT_EQ(0, memcmp(MCStringGetCharPtr(t_mutable), t_unicode + 150, 100 * sizeof(unichar_t)));
+    MCValueRelease(t_mutable);
+
+    // Substrings of a string other threads can see are copied, as slicing it
+    // would change it; otherwise they share its chars.
+    MCAutoStringRef t_unshared, t_visible;
+    ASSERT_TRUE(MCStringCreateWithNativeChars(t_native, 1000, &t_unshared));
+    ASSERT_TRUE(MCStringCreateWithNativeChars(t_native, 1000, &t_visible));
+    MCValueShare(*t_visible);
+
+    MCAutoStringRef t_unshared_tail, t_visible_tail;
+    ASSERT_TRUE(MCStringCopySubstring(*t_unshared, MCRangeMake(900, 100), &t_unshared_tail));
+    ASSERT_TRUE(MCStringCopySubstring(*t_visible, MCRangeMake(900, 100), &t_visible_tail));
+    EXPECT_EQ(MCStringGetNativeCharPtr(*t_unshared) + 900, MCStringGetNativeCharPtr(*t_unshared_tail));
+    EXPECT_NE(MCStringGetNativeCharPtr(*t_visible) + 900, MCStringGetNativeCharPtr(*t_visible_tail));
+    EXPECT_TRUE(MCStringIsEqualTo(*t_unshared_tail, *t_visible_tail, kMCStringOptionCompareExact));
+}
+
+TEST(string, inline_chars)
+//
+// Checks that short strings (whose chars are stored within the string) behave
+// like any other when they are changed or change representation.
+//
+{
+    MCAutoStringRef t_key, t_cell;
+    ASSERT_TRUE(MCStringCreateWithCString("key", &t_key));
+    ASSERT_TRUE(MCStringCreateWithCString("cell", &t_cell));
+
+    MCAutoStringRef t_joined;
+    ASSERT_TRUE(MCStringCreateWithStringsAndSeparator(&t_joined, ',', *t_key, *t_cell));
+    EXPECT_EQ(0, strcmp(MCStringGetCString(*t_joined), "key,cell"));
+
+    // Unnativizing replaces the chars.
+    MCStringRef t_string;
+    ASSERT_TRUE(MCStringCopy(*t_joined, t_string));
+    ASSERT_NE(nullptr, MCStringGetCharPtr(t_string));
+    EXPECT_FALSE(MCStringIsNative(t_string));
+    EXPECT_TRUE(MCStringIsEqualToCString(t_string, "key,cell", kMCStringOptionCompareExact));
+    MCValueRelease(t_string);
+
+    // A short string which is the only reference can be made mutable, and grow
+    // beyond the inline capacity.
+    ASSERT_TRUE(MCStringCreateWithCString("0123456789", t_string));
+    MCStringRef t_mutable;
+    ASSERT_TRUE(MCStringMutableCopyAndRelease(t_string, t_mutable));
+    for (int i = 0; i < 10; i++)
+        ASSERT_TRUE(MCStringAppendNativeChars(t_mutable, (const char_t *)"abcdefghij", 10));
+    EXPECT_EQ(110U, MCStringGetLength(t_mutable));
+    EXPECT_EQ(0, strncmp(MCStringGetCString(t_mutable), "0123456789abcdefghijabcdefghij", 30));
+
+    // Short immutable copies of mutable strings are inline, and can be made
+    // mutable again.
+    MCStringRef t_copy;
+    ASSERT_TRUE(MCStringCopySubstring(t_mutable, MCRangeMake(5, 10), t_copy));
+    MCValueRelease(t_mutable);
+    ASSERT_TRUE(MCStringMutableCopy(t_copy, t_mutable));
+    ASSERT_TRUE(MCStringPrependNativeChars(t_mutable, (const char_t *)"xyz", 3));
+    EXPECT_TRUE(MCStringIsEqualToCString(t_mutable, "xyz56789abcde", kMCStringOptionCompareExact));
+    EXPECT_TRUE(MCStringIsEqualToCString(t_copy, "56789abcde", kMCStringOptionCompareExact));
+    MCValueRelease(t_copy);
+
+    ASSERT_TRUE(MCStringCopyAndRelease(t_mutable, t_copy));
+    ASSERT_TRUE(MCStringMutableCopyAndRelease(t_copy, t_mutable));
+    ASSERT_TRUE(MCStringAppendNativeChars(t_mutable, (const char_t *)"fghijklmno", 10));
+    EXPECT_TRUE(MCStringIsEqualToCString(t_mutable, "xyz56789abcdefghijklmno", kMCStringOptionCompareExact));
+    MCValueRelease(t_mutable);
+}
+
+// Replaces the leftmost-longest occurrences of the patterns in the text, one
+// position at a time.
+static std::string replace_multiple_reference(const std::string& p_text, const std::vector<std::string>& p_patterns, const std::vector<std::string>& p_replacements)
+{
+    std::string t_result;
+    size_t t_offset = 0;
+    while (t_offset < p_text.size())
+    {
+        size_t t_best = SIZE_MAX;
+        for (size_t i = 0; i < p_patterns.size(); i++)
+            if (!p_patterns[i].empty() &&
+                p_text.compare(t_offset, p_patterns[i].size(), p_patterns[i]) == 0 &&
+                (t_best == SIZE_MAX || p_patterns[i].size() > p_patterns[t_best].size()))
+                t_best = i;
+
+        if (t_best == SIZE_MAX)
+            t_result += p_text[t_offset++];
+        else
+        {
+            t_result += p_replacements[t_best];
+            t_offset += p_patterns[t_best].size();
+        }
+    }
+    return t_result;
+}
+
+TEST(string, replace_multiple)
+//
+// Checks that multiple patterns are replaced in a single pass, preferring the
+// leftmost and then longest match, for native and unicode strings.
+//
+{
+    // Replacements are not themselves searched.
+    {
+        MCStringRef t_patterns[] = { MCSTR("<"), MCSTR(">"), MCSTR("&") };
+        MCStringRef t_replacements[] = { MCSTR("&lt;"), MCSTR("&gt;"), MCSTR("&amp;") };
+        MCAutoStringRef t_string;
+        ASSERT_TRUE(MCStringMutableCopy(MCSTR("<a href=\"x&y\">"), &t_string));
+        ASSERT_TRUE(MCStringFindAndReplaceMultiple(*t_string, t_patterns, t_replacements, 3, kMCStringOptionCompareExact));
+        EXPECT_TRUE(MCStringIsEqualToCString(*t_string, "&lt;a href=\"x&amp;y\"&gt;", kMCStringOptionCompareExact));
+    }
+
+    // Caseless comparison, of native and unicode strings, and unicode
+    // replacements.
+    {
+        MCStringRef t_patterns[] = { MCSTR("cat"), MCSTR("CATALOG"), MCSTR("dog") };
+        MCAutoStringRef t_euro;
+        ASSERT_TRUE(MCStringCreateWithChars((const unichar_t *)u"€", 1, &t_euro));
+        MCStringRef t_replacements[] = { MCSTR("x"), MCSTR("y"), *t_euro };
+        
+        MCAutoStringRef t_native, t_unicode;
+        ASSERT_TRUE(MCStringMutableCopy(MCSTR("Catalogue of cats and DOGS"), &t_native));
+        ASSERT_TRUE(MCStringCreateMutable(0, &t_unicode));
+        ASSERT_TRUE(MCStringAppend(*t_unicode, MCSTR("Catalogue of cats and DOGS")));
+        ASSERT_TRUE(MCStringAppend(*t_unicode, *t_euro));
+        ASSERT_FALSE(MCStringIsNative(*t_unicode));
+        
+        ASSERT_TRUE(MCStringFindAndReplaceMultiple(*t_native, t_patterns, t_replacements, 3, kMCStringOptionCompareCaseless));
+        ASSERT_TRUE(MCStringFindAndReplaceMultiple(*t_unicode, t_patterns, t_replacements, 3, kMCStringOptionCompareCaseless));
+        
+        MCAutoStringRef t_expected;
+        ASSERT_TRUE(MCStringFormat(&t_expected, "yue of xs and %@S", *t_euro));
+        EXPECT_TRUE(MCStringIsEqualTo(*t_native, *t_expected, kMCStringOptionCompareExact));
+        ASSERT_TRUE(MCStringAppend(*t_native, *t_euro));
+        EXPECT_TRUE(MCStringIsEqualTo(*t_unicode, *t_native, kMCStringOptionCompareExact));
+    }
+
+    // Random pattern sets, compared with the reference. Each text is also
+    // replaced as unicode, by appending a char none of the patterns contain.
+    srand(17);
+    for (int t_round = 0; t_round < 200; t_round++)
+    {
+        std::vector<std::string> t_patterns, t_replacements;
+        // Large rounds have too many states for a transition table.
+        int t_pattern_count = t_round % 50 == 49 ? 1500 : 1 + rand() % 8;
+        for (int i = 0; i < t_pattern_count; i++)
+        {
+            std::string t_pattern, t_replacement;
+            int t_length = t_round % 50 == 49 ? 8 + rand() % 4 : 1 + rand() % 4;
+            for (int j = 0; j < t_length; j++)
+                t_pattern += char('a' + rand() % 3);
+            for (int j = rand() % 3; j > 0; j--)
+                t_replacement += char('A' + rand() % 3);
+            // The first of any repeated pattern is used.
+            if (std::find(t_patterns.begin(), t_patterns.end(), t_pattern) != t_patterns.end())
+                continue;
+            t_patterns.push_back(t_pattern);
+            t_replacements.push_back(t_replacement);
+        }
+
+        std::string t_text;
+        for (int j = rand() % 200; j > 0; j--)
+            t_text += char('a' + rand() % 4);
+
+        std::vector<MCStringRef> t_pattern_refs(t_patterns.size()), t_replacement_refs(t_patterns.size());
+        for (size_t i = 0; i < t_patterns.size(); i++)
+        {
+            ASSERT_TRUE(MCStringCreateWithCString(t_patterns[i].c_str(), t_pattern_refs[i]));
+            ASSERT_TRUE(MCStringCreateWithCString(t_replacements[i].c_str(), t_replacement_refs[i]));
+        }
+
+        MCStringReplacerRef t_replacer;
+        ASSERT_TRUE(MCStringReplacerCreate(t_pattern_refs.data(), t_replacement_refs.data(), uindex_t(t_patterns.size()), kMCStringOptionCompareExact, t_replacer));
+        for (size_t i = 0; i < t_patterns.size(); i++)
+        {
+            MCValueRelease(t_pattern_refs[i]);
+            MCValueRelease(t_replacement_refs[i]);
+        }
+
+        MCAutoStringRef t_native, t_unicode;
+        ASSERT_TRUE(MCStringCreateMutable(0, &t_native));
+        ASSERT_TRUE(MCStringAppendNativeChars(*t_native, (const char_t *)t_text.data(), uindex_t(t_text.size())));
+        ASSERT_TRUE(MCStringMutableCopy(*t_native, &t_unicode));
+        ASSERT_TRUE(MCStringAppendChar(*t_unicode, 0x20AC));
+
+        ASSERT_TRUE(MCStringReplacerApply(t_replacer, *t_native));
+        ASSERT_TRUE(MCStringReplacerApply(t_replacer, *t_unicode));
+        MCStringReplacerDestroy(t_replacer);
+
+        std::string t_expected;
+        t_expected = replace_multiple_reference(t_text, t_patterns, t_replacements);
+        EXPECT_TRUE(MCStringIsEqualToCString(*t_native, t_expected.c_str(), kMCStringOptionCompareExact)) << t_text;
+
+        ASSERT_TRUE(MCStringAppendChar(*t_native, 0x20AC));
+        EXPECT_TRUE(MCStringIsEqualTo(*t_native, *t_unicode, kMCStringOptionCompareExact)) << t_text;
+    }
+}
+
+TEST(string, sort_key_buffer)
+//
+// Checks that sort keys written into a caller's buffer match allocated ones
+// and that a short buffer reports the full key length.
+//
+{
+    MCAutoStringRef t_locale_name;
+    ASSERT_TRUE(MCStringCreateWithCString("en_US", &t_locale_name));
+    MCLocaleRef t_locale;
+    ASSERT_TRUE(MCLocaleCreateWithName(*t_locale_name, t_locale));
+
+    MCUnicodeCollatorRef t_collator;
+    ASSERT_TRUE(MCUnicodeCreateCollator(t_locale, kMCUnicodeCollateOptionStrengthTertiary, t_collator));
+
+    const unichar_t t_string[] = { 'R', 0xE9, 's', 'u', 'm', 0xE9 };
+    const uindex_t t_length = sizeof(t_string) / sizeof(t_string[0]);
+
+    byte_t *t_key;
+    uindex_t t_key_length;
+    ASSERT_TRUE(MCUnicodeCreateSortKeyWithCollator(t_collator, t_string, t_length, t_key, t_key_length));
+
+    byte_t t_short[2];
+    EXPECT_EQ(t_key_length, MCUnicodeGetSortKeyWithCollator(t_collator, t_string, t_length, t_short, sizeof(t_short)));
+
+    std::vector<byte_t> t_buffer(t_key_length);
+    EXPECT_EQ(t_key_length, MCUnicodeGetSortKeyWithCollator(t_collator, t_string, t_length, t_buffer.data(), t_key_length));
+    EXPECT_EQ(0, memcmp(t_key, t_buffer.data(), t_key_length));
+
+    MCMemoryDeleteArray(t_key);
+    MCUnicodeDestroyCollator(t_collator);
+    MCLocaleRelease(t_locale);
+}
+
+TEST(string, utf8_runs)
+//
+// Checks that UTF-8 text decodes to native chars when it can, stays unicode
+// when it cannot, and round-trips around runs of ASCII of varying length.
+//
+{
+    for (uindex_t t_run = 0; t_run < 40; t_run++)
+    {
+        std::string t_ascii(t_run, 'a');
+
+        std::string t_latin = t_ascii + "\xC3\xA9" + t_ascii;
+        MCAutoStringRef t_native;
+        ASSERT_TRUE(MCStringCreateWithBytes((const byte_t *)t_latin.data(), t_latin.size(), kMCStringEncodingUTF8, false, &t_native));
+        EXPECT_TRUE(MCStringIsNative(*t_native));
+        EXPECT_EQ(2 * t_run + 1, MCStringGetLength(*t_native));
+        EXPECT_EQ(0xE9, MCStringGetCharAtIndex(*t_native, t_run));
+
+        std::string t_euro = t_ascii + "\xE2\x82\xAC" + t_ascii + "\xF0\x9F\x98\x80";
+        MCAutoStringRef t_unicode;
+        ASSERT_TRUE(MCStringCreateWithBytes((const byte_t *)t_euro.data(), t_euro.size(), kMCStringEncodingUTF8, false, &t_unicode));
+        EXPECT_FALSE(MCStringIsNative(*t_unicode));
+        EXPECT_EQ(2 * t_run + 3, MCStringGetLength(*t_unicode));
+        EXPECT_EQ(0x20AC, MCStringGetCharAtIndex(*t_unicode, t_run));
+
+        MCAutoStringRefAsUTF8String t_utf8;
+        ASSERT_TRUE(t_utf8.Lock(*t_unicode));
+        EXPECT_EQ(t_euro, std::string(*t_utf8, t_utf8.Size()));
+        t_utf8.Unlock();
+
+        ASSERT_TRUE(t_utf8.Lock(*t_native));
+        EXPECT_EQ(t_latin, std::string(*t_utf8, t_utf8.Size()));
+    }
+}
+
+TEST(string, break_index)
+//
+// Checks that chars, true words and sentences mapped through the cached
+// ranges of a large string match those found by breaking a mutable copy.
+//
+{
+    MCAutoStringRef t_string;
+    ASSERT_TRUE(MCStringCreateMutable(0, &t_string));
+    for (uindex_t i = 0; i < 300; i++)
+    {
+        const unichar_t t_chars[] = { 'W', 'o', 'r', 'd', 0x0301, ' ', '-', '-', ' ', 0xD83D, 0xDE00, ' ' };
+        ASSERT_TRUE(MCStringAppendFormat(*t_string, "%u", i));
+        ASSERT_TRUE(MCStringAppendChars(*t_string, t_chars, sizeof(t_chars) / sizeof(t_chars[0])));
+        if (i % 7 == 6)
+            ASSERT_TRUE(MCStringAppendFormat(*t_string, "Stop. "));
+    }
+
+    MCAutoStringRef t_immutable;
+    ASSERT_TRUE(MCStringCopy(*t_string, &t_immutable));
+
+    const uindex_t t_lengths[] = { 0, 1, 3, 1000 };
+    for (uindex_t t_pass = 0; t_pass < 2; t_pass++)
+    {
+        for (uindex_t i = 0; i < 2500; i += (i < 100 ? 1 : 37))
+            for (uindex_t t_length : t_lengths)
+            {
+                MCRange t_expected, t_actual;
+
+                ASSERT_TRUE(MCStringMapGraphemeIndices(*t_string, MCRangeMake(i, t_length), t_expected));
+                ASSERT_TRUE(MCStringMapGraphemeIndices(*t_immutable, MCRangeMake(i, t_length), t_actual));
+                EXPECT_EQ(t_expected . offset, t_actual . offset) << "char " << i;
+                EXPECT_EQ(t_expected . length, t_actual . length) << "char " << i;
+
+                if (i > 700)
+                    continue;
+
+                ASSERT_TRUE(MCStringMapTrueWordIndices(*t_string, kMCLocaleBasic, MCRangeMake(i, t_length), t_expected));
+                ASSERT_TRUE(MCStringMapTrueWordIndices(*t_immutable, kMCLocaleBasic, MCRangeMake(i, t_length), t_actual));
+                EXPECT_EQ(t_expected . offset, t_actual . offset) << "trueWord " << i;
+                EXPECT_EQ(t_expected . length, t_actual . length) << "trueWord " << i;
+
+                ASSERT_TRUE(MCStringMapSentenceIndices(*t_string, kMCLocaleBasic, MCRangeMake(i, t_length), t_expected));
+                ASSERT_TRUE(MCStringMapSentenceIndices(*t_immutable, kMCLocaleBasic, MCRangeMake(i, t_length), t_actual));
+                EXPECT_EQ(t_expected . offset, t_actual . offset) << "sentence " << i;
+                EXPECT_EQ(t_expected . length, t_actual . length) << "sentence " << i;
+            }
+
+        MCStringFlushBreakIndexCache();
+    }
+}
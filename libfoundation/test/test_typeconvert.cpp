@@ -22,6 +22,11 @@
 #include "foundation.h"
 #include "foundation-auto.h"
 
+#include <random>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
 TEST(typeconvert, narrowcast)
 {
     /* MCNarrowCast never does any checking */
@@ -125,3 +130,125 @@ TEST(typeconvert, string_real)
 	EXPECT_FALSE(MCTypeConvertStringToReal(MCSTR("0x"), t_value, false));
 	EXPECT_EQ(t_value, 0);
 }
+
+static real64_t
+random_real(std::mt19937_64& x_random)
+{
+    real64_t t_real;
+    uint64_t t_bits;
+    switch (x_random() % 4)
+    {
+        case 0:
+            /* Any bit pattern at all. */
+            t_bits = x_random();
+            MCMemoryCopy(&t_real, &t_bits, sizeof(t_real));
+            return t_real;
+        case 1:
+            /* Small integers and halves, which exercise the ties. */
+            return real64_t(int64_t(x_random() % 200001) - 100000) / 2;
+        case 2:
+            /* Decimals with a few places, like prices and measurements. */
+            return real64_t(int64_t(x_random() % 20000001) - 10000000) /
+                real64_t(uint64_t(1) << (x_random() % 8)) / 1000;
+        default:
+            /* Reals spread evenly over many magnitudes. */
+            return ldexp(real64_t(x_random() >> 11), int(x_random() % 160) - 120) *
+                ((x_random() & 1) ? -1 : 1);
+    }
+}
+
+TEST(typeconvert, real_fixed_cstring)
+//
+// Checks real-to-fixed formatting against the C library
+//
+{
+    char t_expected[400];
+    char t_actual[400];
+
+    EXPECT_EQ(MCTypeConvertRealToFixedCString(2.5, 0, 0, t_actual, sizeof(t_actual)), 1U);
+    EXPECT_STREQ(t_actual, "2");
+    EXPECT_EQ(MCTypeConvertRealToFixedCString(-1.5, 6, 2, t_actual, sizeof(t_actual)), 6U);
+    EXPECT_STREQ(t_actual, "-01.50");
+    EXPECT_EQ(MCTypeConvertRealToFixedCString(0.125, 0, 6, t_actual, sizeof(t_actual)), 8U);
+    EXPECT_STREQ(t_actual, "0.125000");
+
+    /* A short buffer truncates, as with snprintf. */
+    EXPECT_EQ(MCTypeConvertRealToFixedCString(1234.5, 0, 1, t_actual, 4), 6U);
+    EXPECT_STREQ(t_actual, "123");
+
+    std::mt19937_64 t_random(13);
+    for (int i = 0; i < 500000; i++)
+    {
+        real64_t t_real = random_real(t_random);
+        if (!isfinite(t_real))
+            continue;
+        uindex_t t_width = (t_random() % 4) == 0 ? t_random() % 24 : 0;
+        uindex_t t_precision = t_random() % 22;
+
+        size_t t_expected_length = snprintf(t_expected, sizeof(t_expected), "%0*.*f", int(t_width), int(t_precision), t_real);
+        size_t t_actual_length = MCTypeConvertRealToFixedCString(t_real, t_width, t_precision, t_actual, sizeof(t_actual));
+        ASSERT_EQ(t_expected_length, t_actual_length) << t_expected;
+        ASSERT_STREQ(t_expected, t_actual);
+    }
+}
+
+TEST(typeconvert, cstring_real)
+//
+// Checks C string-to-real parsing against the C library
+//
+{
+    static const char *kStrings[] =
+    {
+        "", " ", "-", "+", ".", "-.", "e5", ".e5", "0", "-0", "+0.0", "00012",
+        "1.", ".5", "1e", "1e+", "1e-x", "1E5", "1e-5", "  42 ", "4.2e22",
+        "123456789012345678", "1234567890123456789", "12345678901234567890",
+        "9007199254740993", "9007199254740992", "0.1", "0.3", "1e23", "7e37",
+        "9e37", "1e-22", "1e-23", "0x10", "0X1p3", "-0x", "inf", "-Infinity",
+        "nan", "1,5", "1.5.5", "0.000000000000000000000000000001",
+        "179769313486231570000000000000000000000000000000000000000000000000",
+        "1e99999999999", "1e-99999999999",
+    };
+
+    for (const char *t_string : kStrings)
+    {
+        char *t_expected_end;
+        real64_t t_expected = strtod(t_string, &t_expected_end);
+        const char *t_actual_end;
+        real64_t t_actual = MCTypeConvertCStringToReal(t_string, t_actual_end);
+        EXPECT_EQ(t_expected_end, t_actual_end) << t_string;
+        if (!isnan(t_expected))
+            EXPECT_EQ(0, memcmp(&t_expected, &t_actual, sizeof(real64_t))) << t_string;
+        else
+            EXPECT_TRUE(isnan(t_actual)) << t_string;
+    }
+
+    std::mt19937_64 t_random(13);
+    char t_string[400];
+    for (int i = 0; i < 500000; i++)
+    {
+        real64_t t_real = random_real(t_random);
+        switch (t_random() % 3)
+        {
+            case 0:
+                snprintf(t_string, sizeof(t_string), "%.*g", int(t_random() % 20) + 1, t_real);
+                break;
+            case 1:
+                snprintf(t_string, sizeof(t_string), "%.*f", int(t_random() % 12), t_real);
+                break;
+            default:
+                snprintf(t_string, sizeof(t_string), "%llu.%llue%d",
+                         (unsigned long long)(t_random() % 1000000000),
+                         (unsigned long long)(t_random() % 10000000000ULL),
+                         int(t_random() % 80) - 40);
+                break;
+        }
+
+        char *t_expected_end;
+        real64_t t_expected = strtod(t_string, &t_expected_end);
+        const char *t_actual_end;
+        real64_t t_actual = MCTypeConvertCStringToReal(t_string, t_actual_end);
+        ASSERT_EQ(t_expected_end, t_actual_end) << t_string;
+        if (!isnan(t_expected))
+            ASSERT_EQ(0, memcmp(&t_expected, &t_actual, sizeof(real64_t))) << t_string;
+    }
+}
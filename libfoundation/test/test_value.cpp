@@ -0,0 +1,126 @@
+/* Copyright (C) 2017 LiveCode Ltd.
+ 
+ This file is part of LiveCode.
+ 
+ LiveCode is free software; you can redistribute it and/or modify it under
+ the terms of the GNU General Public License v3 as published by the Free
+ Software Foundation.
+ 
+ LiveCode is distributed in the hope that it will be useful, but WITHOUT ANY
+ WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with LiveCode.  If not see <http://www.gnu.org/licenses/>.  */
+
+#include "gtest/gtest.h"
+
+#include "foundation.h"
+#include "foundation-auto.h"
+
+#include <thread>
+#include <vector>
+
+TEST(value, shared_references)
+//
+// Checks that the reference counts of shared values (and the values they
+// contain) are updated consistently by several threads at once.
+//
+{
+    MCAutoStringRef t_string;
+    ASSERT_TRUE(MCStringCreateWithCString("a string which is not short", &t_string));
+    
+    MCAutoNumberRef t_number;
+    ASSERT_TRUE(MCNumberCreateWithInteger(1000000, &t_number));
+    
+    MCAutoArrayRef t_mutable_array;
+    ASSERT_TRUE(MCArrayCreateMutable(&t_mutable_array));
+    ASSERT_TRUE(MCArrayStoreValue(*t_mutable_array, true, MCNAME("string"), *t_string));
+    ASSERT_TRUE(MCArrayStoreValue(*t_mutable_array, true, MCNAME("number"), *t_number));
+    
+    MCAutoArrayRef t_array;
+    ASSERT_TRUE(MCArrayCopy(*t_mutable_array, &t_array));
+    
+    MCValueShare(*t_array);
+    
+    MCNewAutoNameRef t_key;
+    ASSERT_TRUE(MCNameCreateWithNativeChars((const char_t *)"string", 6, &t_key));
+    
+    uindex_t t_string_references, t_array_references;
+    t_string_references = MCValueGetRetainCount(*t_string);
+    t_array_references = MCValueGetRetainCount(*t_array);
+    
+    std::vector<std::thread> t_threads;
+    for(int i = 0; i < 4; i++)
+        t_threads.push_back(std::thread([&]() {
+            for(int j = 0; j < 100000; j++)
+            {
+                MCValueRef t_value;
+                /* UNCHECKED */ MCArrayFetchValue(*t_array, true, *t_key, t_value);
+                MCValueRetain(*t_array);
+                MCValueRetain(t_value);
+                MCValueRelease(t_value);
+                MCValueRelease(*t_array);
+            }
+        }));
+    for(auto& t_thread : t_threads)
+        t_thread . join();
+    
+    EXPECT_EQ(t_string_references, MCValueGetRetainCount(*t_string));
+    EXPECT_EQ(t_array_references, MCValueGetRetainCount(*t_array));
+    
+    // A shared value is copied rather than changed when made mutable.
+    MCArrayRef t_copy;
+    ASSERT_TRUE(MCArrayMutableCopyAndRelease(MCValueRetain(*t_array), t_copy));
+    EXPECT_NE(*t_array, t_copy);
+    MCValueRelease(t_copy);
+    EXPECT_EQ(t_array_references, MCValueGetRetainCount(*t_array));
+}
+
+TEST(value, type_statistics)
+//
+// Checks that values and memory blocks are counted as they are created and
+// destroyed, when accounting is enabled by the test environment.
+//
+{
+    MCValueTypeStatistics t_before;
+    ASSERT_TRUE(MCValueGetTypeStatistics(kMCValueTypeCodeArray, t_before));
+    EXPECT_EQ(t_before . created - t_before . destroyed, t_before . live);
+    
+    MCMemoryStatistics t_memory_before;
+    MCMemoryGetStatistics(t_memory_before);
+    
+    const uindex_t kCount = 100;
+    MCArrayRef t_arrays[kCount];
+    for(uindex_t i = 0; i < kCount; i++)
+        ASSERT_TRUE(MCArrayCreateMutable(t_arrays[i]));
+    
+    MCValueTypeStatistics t_during;
+    ASSERT_TRUE(MCValueGetTypeStatistics(kMCValueTypeCodeArray, t_during));
+    EXPECT_EQ(t_before . created + kCount, t_during . created);
+    EXPECT_EQ(t_before . live + kCount, t_during . live);
+    EXPECT_GE(t_during . peak_live, t_during . live);
+    EXPECT_GE(t_during . peak_bytes, t_during . live_bytes);
+    
+    for(uindex_t i = 0; i < kCount; i++)
+        MCValueRelease(t_arrays[i]);
+    
+    MCValueTypeStatistics t_after;
+    ASSERT_TRUE(MCValueGetTypeStatistics(kMCValueTypeCodeArray, t_after));
+    EXPECT_EQ(t_before . destroyed + kCount, t_after . destroyed);
+    EXPECT_EQ(t_before . live, t_after . live);
+    EXPECT_EQ(t_before . live_bytes, t_after . live_bytes);
+    EXPECT_GE(t_after . peak_live, t_before . live + kCount);
+    
+    MCMemoryStatistics t_memory_after;
+    MCMemoryGetStatistics(t_memory_after);
+    // Some records are reused, or kept for reuse, rather than being allocated
+    // and deallocated.
+    EXPECT_GT(t_memory_after . allocations, t_memory_before . allocations);
+    EXPECT_GT(t_memory_after . deallocations, t_memory_before . deallocations);
+    EXPECT_GE(t_memory_after . peak_bytes, t_memory_after . live_bytes);
+    
+    MCValueTypeStatistics t_invalid;
+    EXPECT_FALSE(MCValueGetTypeStatistics(MCValueTypeCode(kMCValueTypeCodeForeignValue + 1), t_invalid));
+}
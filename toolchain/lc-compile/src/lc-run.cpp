@@ -389,7 +389,7 @@ MCRunLoadModulesFromFile (MCStringRef p_filename,
 	MCAutoDataRef t_module_data;
 	MCAutoValueRefBase<MCStreamRef> t_stream;
 
-	if (!MCSFileGetContents (p_filename, &t_module_data))
+	if (!MCSFileGetContentsMapped (p_filename, &t_module_data))
 		return false;
 
 	return MCScriptCreateModulesFromData(*t_module_data, x_modules);